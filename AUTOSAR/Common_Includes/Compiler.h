@@ -69,4 +69,7 @@
 
 /* This is used to define the abstraction of compiler keyword asm */
 #define ASM				  asm
+
+/* Section placement (RAM_FUNC, CCM_DATA, CCM_BSS, NO_INIT) shared with the drivers */
+#include "MEM_SECTIONS.h"
 #endif
@@ -24,6 +24,11 @@
 
 #include "Det.h"
 
+/* Check if Trace Points are enabled or not */
+#if (DET_TRACE_ENABLE == STD_ON)
+#include "TRACE_Init.h"
+#endif
+
 /* Variables to store last DET error */
 uint16 Det_ModuleId = 0;       /*DET module ID*/
 uint8 Det_InstanceId = 0;      /*DET instance ID*/
@@ -39,6 +44,10 @@ Std_ReturnType Det_ReportError( uint16 ModuleId,
     Det_InstanceId = InstanceId;
     Det_ApiId = ApiId; 
     Det_ErrorId = ErrorId;
+
+#if (DET_TRACE_ENABLE == STD_ON)
+    TRACE3("Det: module %u api %u error %u", ModuleId, ApiId, ErrorId);
+#endif
     return E_OK;
 }
 
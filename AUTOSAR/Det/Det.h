@@ -37,6 +37,9 @@
 /* Instance Id */
 #define DET_INSTANCE_ID               (0U)
 
+/* Pre-compile option for Trace Points (Drivers/TRACE) */
+#define DET_TRACE_ENABLE              (STD_ON)
+
 /*
  * Det Software Module Version 1.0.0
  */
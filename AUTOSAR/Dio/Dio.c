@@ -46,6 +46,11 @@
 
 #endif
 
+/* Check if Trace Points are enabled or not through configuration tool */
+#if(DIO_TRACE_ENABLE == STD_ON)
+#include "TRACE_Init.h"
+#endif
+
 STATIC const Dio_ConfigChannel * Dio_PortChannels = Dio_Configuration.Channels;
 
 /*** Note: Dio_Init API is no longer available on AUTOSAR DIO Version 4.3.1 ***/
@@ -72,7 +77,7 @@ STATIC const Dio_ConfigChannel * Dio_PortChannels = Dio_Configuration.Channels;
  * @note  	Return Value: 	 Dio_LevelType
  * @param   (in): ChannelId - ID of DIO channel.
  ***********************************************************************************/
-Dio_LevelType Dio_ReadChannel(Dio_ChannelType ChannelId)
+RAM_FUNC Dio_LevelType Dio_ReadChannel(Dio_ChannelType ChannelId)
 {
 	volatile uint32 * Port_Ptr = NULL_PTR;
 	boolean error = FALSE;
@@ -208,7 +213,7 @@ Dio_LevelType Dio_ReadChannel(Dio_ChannelType ChannelId)
  * @param	 (in): ChannelId - ID of DIO channel.
  * @param	 (in): Level - Value to be written.
  ***********************************************************************************/
-void Dio_WriteChannel(Dio_ChannelType ChannelId, Dio_LevelType Level)
+RAM_FUNC void Dio_WriteChannel(Dio_ChannelType ChannelId, Dio_LevelType Level)
 {
 	volatile uint32 * Port_Ptr = NULL_PTR;
 	boolean error = FALSE;
@@ -255,6 +260,10 @@ void Dio_WriteChannel(Dio_ChannelType ChannelId, Dio_LevelType Level)
 	/* In-case there are no errors */
 	if(FALSE == error)
 	{
+#if (DIO_TRACE_ENABLE == STD_ON)
+		TRACE2("Dio: write ch %u level %u", ChannelId, Level);
+#endif
+
 		/* Point to the correct PORT register according to the Port Id stored in the Port_Num member */
 		switch(Dio_PortChannels[ChannelId].Port_Num)
 		{
@@ -493,6 +502,10 @@ Dio_LevelType Dio_FlipChannel(Dio_ChannelType ChannelId)
 		/* No Action Required */
 	}
 
+#if (DIO_TRACE_ENABLE == STD_ON)
+	TRACE2("Dio: flip ch %u -> %u", ChannelId, output);
+#endif
+
 	/* Return Bit value */
 	return output;
 }
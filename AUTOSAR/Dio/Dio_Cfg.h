@@ -50,6 +50,9 @@
 /* Pre-compile option for presence of Dio_FlipChannel API */
 #define DIO_FLIP_CHANNEL_API                (STD_ON)
 
+/* Pre-compile option for Trace Points (Drivers/TRACE) */
+#define DIO_TRACE_ENABLE                    (STD_OFF)
+
 /* Number of the configured Dio Channels */
 #define DIO_CONFIGURED_CHANNLES             (7U)
 
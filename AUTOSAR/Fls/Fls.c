@@ -0,0 +1,1174 @@
+/******************************************************************************
+ *
+ * Module: 		Fls
+ *
+ * File Name: 	Fls.c
+ *
+ * Description: Source file for STM32F429 Microcontroller - Fls Driver
+ *
+ * Author: 		Islam Ehab
+ *
+ * Date:		19/10/2026
+ *
+ * Note:	- Jobs are only accepted by the APIs, the work is done by
+ * 			  Fls_MainFunction, a bounded amount of it per call
+ * 	    	- Sector erases run in the background, Fls_MainFunction only
+ * 	    	  polls them (Flash area in Bank 2, program running from Bank 1)
+ * 			- The Flash Data Cache is off while a Write/Erase job is pending
+ ******************************************************************************/
+
+/*******************************************************************************
+ * @file:	Fls.c
+ *
+ * @brief:	Source file for STM32F429 Microcontroller - Fls Driver
+ *
+ * @author:	Islam Ehab
+ *
+ * @date:	19/10/2026
+ *
+ * @note: 	Jobs are only accepted by the APIs, the work is done by
+ * 			Fls_MainFunction, a bounded amount of it per call
+ *
+ * @note:   Sector erases run in the background, Fls_MainFunction only
+ * 			polls them (Flash area in Bank 2, program running from Bank 1)
+ *
+ * @note:   The Flash Data Cache is off while a Write/Erase job is pending
+ ******************************************************************************/
+
+#include "Fls_Reg.h"
+#include "Fls.h"
+
+#if (FLS_DEV_ERROR_DETECT == STD_ON)
+
+#include "Det.h"
+/* AUTOSAR Version checking between Det and Fls Modules */
+#if ((DET_AR_MAJOR_VERSION != FLS_AR_RELEASE_MAJOR_VERSION)\
+		|| (DET_AR_MINOR_VERSION != FLS_AR_RELEASE_MINOR_VERSION)\
+		|| (DET_AR_PATCH_VERSION != FLS_AR_RELEASE_PATCH_VERSION))
+#error "The AR version of Det.h does not match the expected version"
+#endif
+
+#endif
+
+/* Non AUTOSAR Drivers use the old types */
+#if ((FLS_TRACE_ENABLE == STD_ON) || (FLS_STATISTICS_API == STD_ON))
+#include "STD_TYPES_OLD.h"
+#endif
+
+/* Check if Trace Points are enabled or not through configuration tool */
+#if (FLS_TRACE_ENABLE == STD_ON)
+#include "TRACE_Init.h"
+#endif
+
+/* Fls_GetStatistics is measured with the DWT Cycle Counter */
+#if (FLS_STATISTICS_API == STD_ON)
+#include "DWT_Init.h"
+#endif
+
+/**************************************************************************
+ * 					Static Global Types Definition				 	  	  *
+***************************************************************************/
+
+/* Job requested by the last accepted API call */
+typedef enum{
+	FLS_JOB_NONE,
+	FLS_JOB_READ,
+	FLS_JOB_WRITE,
+	FLS_JOB_ERASE,
+	FLS_JOB_COMPARE
+}Fls_JobKindType;
+
+/* Steps of an Erase job, repeated for every sector */
+typedef enum{
+	FLS_ERASE_START,			/* Start the sector erase						*/
+	FLS_ERASE_WAIT,				/* Sector erase running in the background		*/
+	FLS_ERASE_VERIFY			/* Blank check of the erased sector				*/
+}Fls_EraseStepType;
+
+/* Programmed unit, FLS_PAGE_SIZE bytes */
+#if   (FLS_VOLTAGE_RANGE == FLS_VOLTAGE_RANGE_4)
+typedef uint64 Fls_UnitType;
+#elif (FLS_VOLTAGE_RANGE == FLS_VOLTAGE_RANGE_3)
+typedef uint32 Fls_UnitType;
+#elif (FLS_VOLTAGE_RANGE == FLS_VOLTAGE_RANGE_2)
+typedef uint16 Fls_UnitType;
+#else
+typedef uint8  Fls_UnitType;
+#endif
+
+/* Pending job */
+typedef struct{
+	Fls_JobKindType		kind;
+	uint32				address;		/* Absolute address of the next byte			*/
+	Fls_LengthType		remaining;		/* Bytes left								*/
+	Fls_LengthType		length;			/* Bytes requested							*/
+	uint8*				readPtr;		/* Fls_Read destination						*/
+	const uint8*		dataPtr;		/* Fls_Write source / Fls_Compare reference	*/
+	Fls_EraseStepType	eraseStep;
+	uint32				sectorEnd;		/* Absolute end of the sector being erased	*/
+	uint32				timeout;		/* Fls_MainFunction calls (periods) of the running erase */
+}Fls_JobInfoType;
+/**************************************************************************/
+
+/**************************************************************************
+ * 					Static Global Functions Prototype				 	  *
+***************************************************************************/
+
+STATIC uint8 Fls_GetSector(uint32 Address, uint32* SectorStart, uint32* SectorSize);
+STATIC boolean Fls_IsSectorBoundary(uint32 Address);
+STATIC boolean Fls_CheckState(uint8 ServiceId);
+STATIC void Fls_StartJob(Fls_JobKindType Kind, Fls_AddressType Address, Fls_LengthType Length);
+STATIC void Fls_EndJob(MemIf_JobResultType Result);
+STATIC void Fls_ReleaseFlash(void);
+STATIC Fls_LengthType Fls_GetMaxRead(void);
+STATIC Fls_LengthType Fls_GetMaxWrite(void);
+STATIC Std_ReturnType Fls_ProgramUnit(uint32 Address, const uint8* Data);
+STATIC void Fls_ProcessRead(void);
+STATIC void Fls_ProcessCompare(void);
+STATIC void Fls_ProcessWrite(void);
+STATIC void Fls_ProcessErase(void);
+
+/**************************************************************************/
+
+
+/**************************************************************************
+ * 					Static Global Variable Definition				 	  *
+***************************************************************************/
+
+/* Fls Module Status */
+STATIC volatile MemIf_StatusType Fls_Status = MEMIF_UNINIT;
+
+/* Result of the last job, MEMIF_JOB_PENDING while Fls_MainFunction works on it */
+STATIC volatile MemIf_JobResultType Fls_JobResult = MEMIF_JOB_OK;
+
+/* Post Build configuration given to Fls_Init */
+STATIC const Fls_ConfigType * Fls_ConfigPtr = NULL_PTR;
+
+/* Slow or Fast Mode */
+STATIC MemIf_ModeType Fls_Mode = MEMIF_MODE_SLOW;
+
+/* Pending job */
+STATIC Fls_JobInfoType Fls_Job;
+
+/*
+ * Flash still busy with a canceled operation, FLASH_CR can not be written
+ * so locking the Flash is left to Fls_MainFunction
+ */
+STATIC boolean Fls_ReleasePending = FALSE;
+
+/* Flash Data Cache was enabled before the Write/Erase job */
+STATIC boolean Fls_DataCacheEnabled = FALSE;
+
+#if (FLS_STATISTICS_API == STD_ON)
+/* Job measurements */
+STATIC Fls_StatisticsType Fls_Statistics;
+
+/* DWT cycles when the pending job was accepted */
+STATIC uint32 Fls_JobStartCycles = 0;
+#endif
+/**************************************************************************/
+
+/************************************************************************************
+ * Service Name: Fls_Init
+ * Service ID[hex]: 0x00
+ * Sync/Async: Synchronous
+ * Reentrancy: Non Reentrant
+ * Parameters (in): ConfigPtr - Pointer to configuration set
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Function to initialize the Fls Module.
+ ************************************************************************************/
+void Fls_Init(const Fls_ConfigType* ConfigPtr)
+{
+	boolean error = FALSE;
+
+#if (FLS_DEV_ERROR_DETECT == STD_ON)
+
+	/* Check if the input configuration pointer is Not a Null Pointer */
+	if(NULL_PTR == ConfigPtr)
+	{
+		Det_ReportError(FLS_MODULE_ID, FLS_INSTANCE_ID, FLS_INIT_SID, FLS_E_PARAM_CONFIG);
+		error = TRUE;
+	}
+	else
+	{
+		/* No Action Required */
+	}
+
+	/* Fls_Init shall not be called while a job is pending */
+	if(MEMIF_BUSY == Fls_Status)
+	{
+		Det_ReportError(FLS_MODULE_ID, FLS_INSTANCE_ID, FLS_INIT_SID, FLS_E_BUSY);
+		error = TRUE;
+	}
+	else
+	{
+		/* No Action Required */
+	}
+
+#endif
+
+	if(FALSE == error)
+	{
+		Fls_ConfigPtr = ConfigPtr;
+		Fls_Mode = ConfigPtr->DefaultMode;
+		Fls_Job.kind = FLS_JOB_NONE;
+
+		/* Clear the error flags left by a previous operation */
+		FLASH_INTERFACE_BASE_ADDRESS->SR = FLASH_SR_ERRORS_MASK | FLASH_SR_EOP_MASK;
+
+		Fls_JobResult = MEMIF_JOB_OK;
+		Fls_Status = MEMIF_IDLE;
+	}
+}
+
+/************************************************************************************
+ * Service Name: Fls_Erase
+ * Service ID[hex]: 0x01
+ * Sync/Async: Asynchronous
+ * Reentrancy: Non Reentrant
+ * Parameters (in): TargetAddress - Offset of the first sector to erase
+ * 					Length - Number of bytes to erase, whole sectors
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: Std_ReturnType - E_OK if the job is accepted
+ * Description: Function to request the erase of whole Flash sectors.
+ ************************************************************************************/
+Std_ReturnType Fls_Erase(Fls_AddressType TargetAddress, Fls_LengthType Length)
+{
+	boolean error = Fls_CheckState(FLS_ERASE_SID);
+
+	/* Erase starts & ends on sector boundaries inside the Fls area */
+	if((FLS_TOTAL_SIZE <= TargetAddress)
+			|| (FALSE == Fls_IsSectorBoundary(FLS_BASE_ADDRESS + TargetAddress)))
+	{
+#if (FLS_DEV_ERROR_DETECT == STD_ON)
+		Det_ReportError(FLS_MODULE_ID, FLS_INSTANCE_ID, FLS_ERASE_SID, FLS_E_PARAM_ADDRESS);
+#endif
+		error = TRUE;
+	}
+	else if((0U == Length) || ((FLS_TOTAL_SIZE - TargetAddress) < Length)
+			|| (FALSE == Fls_IsSectorBoundary(FLS_BASE_ADDRESS + TargetAddress + Length)))
+	{
+#if (FLS_DEV_ERROR_DETECT == STD_ON)
+		Det_ReportError(FLS_MODULE_ID, FLS_INSTANCE_ID, FLS_ERASE_SID, FLS_E_PARAM_LENGTH);
+#endif
+		error = TRUE;
+	}
+	else
+	{
+		/* No Action Required */
+	}
+
+	if(FALSE == error)
+	{
+		Fls_Job.eraseStep = FLS_ERASE_START;
+		Fls_StartJob(FLS_JOB_ERASE, TargetAddress, Length);
+	}
+
+	return (FALSE == error) ? E_OK : E_NOT_OK;
+}
+
+/************************************************************************************
+ * Service Name: Fls_Write
+ * Service ID[hex]: 0x02
+ * Sync/Async: Asynchronous
+ * Reentrancy: Non Reentrant
+ * Parameters (in): TargetAddress - Offset to program, multiple of FLS_PAGE_SIZE
+ * 					SourceAddressPtr - Data to program
+ * 					Length - Number of bytes, multiple of FLS_PAGE_SIZE
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: Std_ReturnType - E_OK if the job is accepted
+ * Description: Function to request programming of erased Flash.
+ * 				The source buffer shall be kept until the job ends.
+ ************************************************************************************/
+Std_ReturnType Fls_Write(Fls_AddressType TargetAddress, const uint8* SourceAddressPtr, Fls_LengthType Length)
+{
+	boolean error = Fls_CheckState(FLS_WRITE_SID);
+
+	if((FLS_TOTAL_SIZE <= TargetAddress) || (0U != (TargetAddress % FLS_PAGE_SIZE)))
+	{
+#if (FLS_DEV_ERROR_DETECT == STD_ON)
+		Det_ReportError(FLS_MODULE_ID, FLS_INSTANCE_ID, FLS_WRITE_SID, FLS_E_PARAM_ADDRESS);
+#endif
+		error = TRUE;
+	}
+	else if((0U == Length) || (0U != (Length % FLS_PAGE_SIZE))
+			|| ((FLS_TOTAL_SIZE - TargetAddress) < Length))
+	{
+#if (FLS_DEV_ERROR_DETECT == STD_ON)
+		Det_ReportError(FLS_MODULE_ID, FLS_INSTANCE_ID, FLS_WRITE_SID, FLS_E_PARAM_LENGTH);
+#endif
+		error = TRUE;
+	}
+	else if(NULL_PTR == SourceAddressPtr)
+	{
+#if (FLS_DEV_ERROR_DETECT == STD_ON)
+		Det_ReportError(FLS_MODULE_ID, FLS_INSTANCE_ID, FLS_WRITE_SID, FLS_E_PARAM_DATA);
+#endif
+		error = TRUE;
+	}
+	else
+	{
+		/* No Action Required */
+	}
+
+	if(FALSE == error)
+	{
+		Fls_Job.dataPtr = SourceAddressPtr;
+		Fls_StartJob(FLS_JOB_WRITE, TargetAddress, Length);
+	}
+
+	return (FALSE == error) ? E_OK : E_NOT_OK;
+}
+
+#if (FLS_CANCEL_API == STD_ON)
+/************************************************************************************
+ * Service Name: Fls_Cancel
+ * Service ID[hex]: 0x03
+ * Sync/Async: Synchronous
+ * Reentrancy: Non Reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Function to cancel the pending job.
+ * 				A sector erase already started can not be stopped, the next
+ * 				Write/Erase job waits for it.
+ ************************************************************************************/
+void Fls_Cancel(void)
+{
+#if (FLS_DEV_ERROR_DETECT == STD_ON)
+	if(MEMIF_UNINIT == Fls_Status)
+	{
+		Det_ReportError(FLS_MODULE_ID, FLS_INSTANCE_ID, FLS_CANCEL_SID, FLS_E_UNINIT);
+	}
+	else
+#endif
+	{
+		if(MEMIF_JOB_PENDING == Fls_JobResult)
+		{
+			Fls_EndJob(MEMIF_JOB_CANCELED);
+		}
+	}
+}
+#endif
+
+#if (FLS_GET_STATUS_API == STD_ON)
+/************************************************************************************
+ * Service Name: Fls_GetStatus
+ * Service ID[hex]: 0x04
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: MemIf_StatusType
+ * Description: Function to return the Fls Module status.
+ * 				MEMIF_BUSY as well while the erase of a canceled job still holds
+ * 				the Flash: Fls_MainFunction calls are needed to lock it.
+ ************************************************************************************/
+MemIf_StatusType Fls_GetStatus(void)
+{
+	if((MEMIF_IDLE == Fls_Status) && (TRUE == Fls_ReleasePending))
+	{
+		return MEMIF_BUSY;
+	}
+
+	return Fls_Status;
+}
+#endif
+
+#if (FLS_GET_JOB_RESULT_API == STD_ON)
+/************************************************************************************
+ * Service Name: Fls_GetJobResult
+ * Service ID[hex]: 0x05
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: MemIf_JobResultType
+ * Description: Function to return the result of the last job.
+ ************************************************************************************/
+MemIf_JobResultType Fls_GetJobResult(void)
+{
+#if (FLS_DEV_ERROR_DETECT == STD_ON)
+	if(MEMIF_UNINIT == Fls_Status)
+	{
+		Det_ReportError(FLS_MODULE_ID, FLS_INSTANCE_ID, FLS_GET_JOB_RESULT_SID, FLS_E_UNINIT);
+		return MEMIF_JOB_FAILED;
+	}
+#endif
+
+	return Fls_JobResult;
+}
+#endif
+
+/************************************************************************************
+ * Service Name: Fls_Read
+ * Service ID[hex]: 0x07
+ * Sync/Async: Asynchronous
+ * Reentrancy: Non Reentrant
+ * Parameters (in): SourceAddress - Offset to read from
+ * 					Length - Number of bytes to read
+ * Parameters (inout): None
+ * Parameters (out): TargetAddressPtr - Destination buffer
+ * Return value: Std_ReturnType - E_OK if the job is accepted
+ * Description: Function to request a read of the Flash.
+ ************************************************************************************/
+Std_ReturnType Fls_Read(Fls_AddressType SourceAddress, uint8* TargetAddressPtr, Fls_LengthType Length)
+{
+	boolean error = Fls_CheckState(FLS_READ_SID);
+
+	if(FLS_TOTAL_SIZE <= SourceAddress)
+	{
+#if (FLS_DEV_ERROR_DETECT == STD_ON)
+		Det_ReportError(FLS_MODULE_ID, FLS_INSTANCE_ID, FLS_READ_SID, FLS_E_PARAM_ADDRESS);
+#endif
+		error = TRUE;
+	}
+	else if((0U == Length) || ((FLS_TOTAL_SIZE - SourceAddress) < Length))
+	{
+#if (FLS_DEV_ERROR_DETECT == STD_ON)
+		Det_ReportError(FLS_MODULE_ID, FLS_INSTANCE_ID, FLS_READ_SID, FLS_E_PARAM_LENGTH);
+#endif
+		error = TRUE;
+	}
+	else if(NULL_PTR == TargetAddressPtr)
+	{
+#if (FLS_DEV_ERROR_DETECT == STD_ON)
+		Det_ReportError(FLS_MODULE_ID, FLS_INSTANCE_ID, FLS_READ_SID, FLS_E_PARAM_DATA);
+#endif
+		error = TRUE;
+	}
+	else
+	{
+		/* No Action Required */
+	}
+
+	if(FALSE == error)
+	{
+		Fls_Job.readPtr = TargetAddressPtr;
+		Fls_StartJob(FLS_JOB_READ, SourceAddress, Length);
+	}
+
+	return (FALSE == error) ? E_OK : E_NOT_OK;
+}
+
+#if (FLS_COMPARE_API == STD_ON)
+/************************************************************************************
+ * Service Name: Fls_Compare
+ * Service ID[hex]: 0x08
+ * Sync/Async: Asynchronous
+ * Reentrancy: Non Reentrant
+ * Parameters (in): SourceAddress - Offset to compare from
+ * 					TargetAddressPtr - Data to compare with
+ * 					Length - Number of bytes to compare
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: Std_ReturnType - E_OK if the job is accepted
+ * Description: Function to request a compare of the Flash with a buffer,
+ * 				the job ends with MEMIF_BLOCK_INCONSISTENT on a difference.
+ ************************************************************************************/
+Std_ReturnType Fls_Compare(Fls_AddressType SourceAddress, const uint8* TargetAddressPtr, Fls_LengthType Length)
+{
+	boolean error = Fls_CheckState(FLS_COMPARE_SID);
+
+	if(FLS_TOTAL_SIZE <= SourceAddress)
+	{
+#if (FLS_DEV_ERROR_DETECT == STD_ON)
+		Det_ReportError(FLS_MODULE_ID, FLS_INSTANCE_ID, FLS_COMPARE_SID, FLS_E_PARAM_ADDRESS);
+#endif
+		error = TRUE;
+	}
+	else if((0U == Length) || ((FLS_TOTAL_SIZE - SourceAddress) < Length))
+	{
+#if (FLS_DEV_ERROR_DETECT == STD_ON)
+		Det_ReportError(FLS_MODULE_ID, FLS_INSTANCE_ID, FLS_COMPARE_SID, FLS_E_PARAM_LENGTH);
+#endif
+		error = TRUE;
+	}
+	else if(NULL_PTR == TargetAddressPtr)
+	{
+#if (FLS_DEV_ERROR_DETECT == STD_ON)
+		Det_ReportError(FLS_MODULE_ID, FLS_INSTANCE_ID, FLS_COMPARE_SID, FLS_E_PARAM_DATA);
+#endif
+		error = TRUE;
+	}
+	else
+	{
+		/* No Action Required */
+	}
+
+	if(FALSE == error)
+	{
+		Fls_Job.dataPtr = TargetAddressPtr;
+		Fls_StartJob(FLS_JOB_COMPARE, SourceAddress, Length);
+	}
+
+	return (FALSE == error) ? E_OK : E_NOT_OK;
+}
+#endif
+
+#if (FLS_SET_MODE_API == STD_ON)
+/************************************************************************************
+ * Service Name: Fls_SetMode
+ * Service ID[hex]: 0x09
+ * Sync/Async: Synchronous
+ * Reentrancy: Non Reentrant
+ * Parameters (in): Mode - MEMIF_MODE_SLOW or MEMIF_MODE_FAST
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Function to select the bytes processed per Fls_MainFunction call.
+ ************************************************************************************/
+void Fls_SetMode(MemIf_ModeType Mode)
+{
+	if(FALSE == Fls_CheckState(FLS_SET_MODE_SID))
+	{
+		Fls_Mode = Mode;
+	}
+}
+#endif
+
+#if (FLS_VERSION_INFO_API == STD_ON)
+/************************************************************************************
+ * Service Name: Fls_GetVersionInfo
+ * Service ID[hex]: 0x10
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): versioninfo - Pointer to where to store the version information
+ * Return value: None
+ * Description: Function to return the version information of this module.
+ ************************************************************************************/
+void Fls_GetVersionInfo(Std_VersionInfoType* versioninfo)
+{
+#if (FLS_DEV_ERROR_DETECT == STD_ON)
+	/* Check if input pointer is not Null pointer */
+	if(NULL_PTR == versioninfo)
+	{
+		Det_ReportError(FLS_MODULE_ID, FLS_INSTANCE_ID,
+				FLS_GET_VERSION_INFO_SID, FLS_E_PARAM_POINTER);
+	}
+	else
+#endif /* (FLS_DEV_ERROR_DETECT == STD_ON) */
+	{
+		versioninfo->vendorID = (uint16)FLS_VENDOR_ID;
+		versioninfo->moduleID = (uint16)FLS_MODULE_ID;
+		versioninfo->sw_major_version = (uint8)FLS_SW_MAJOR_VERSION;
+		versioninfo->sw_minor_version = (uint8)FLS_SW_MINOR_VERSION;
+		versioninfo->sw_patch_version = (uint8)FLS_SW_PATCH_VERSION;
+	}
+}
+#endif
+
+/************************************************************************************
+ * Service Name: Fls_MainFunction
+ * Service ID[hex]: 0x06
+ * Description: Function to process the pending job, called every
+ * 				FLS_MAIN_FUNCTION_PERIOD_MS (erase timeout is counted in calls).
+ * 				Every call is bounded: Max Read/Write bytes of the current Mode,
+ * 				or one poll of the running sector erase.
+ ************************************************************************************/
+void Fls_MainFunction(void)
+{
+#if (FLS_STATISTICS_API == STD_ON)
+	uint32 cycles = u32DWT_GetCycles();
+#endif
+
+#if (FLS_DEV_ERROR_DETECT == STD_ON)
+	if(MEMIF_UNINIT == Fls_Status)
+	{
+		Det_ReportError(FLS_MODULE_ID, FLS_INSTANCE_ID, FLS_MAIN_FUNCTION_SID, FLS_E_UNINIT);
+		return;
+	}
+#endif
+
+	if(MEMIF_JOB_PENDING != Fls_JobResult)
+	{
+		/* Lock the Flash once the operation of a canceled job ends */
+		if((TRUE == Fls_ReleasePending)
+				&& (0U == (FLASH_INTERFACE_BASE_ADDRESS->SR & FLASH_SR_BSY_MASK)))
+		{
+			Fls_ReleaseFlash();
+		}
+		return;
+	}
+
+	switch(Fls_Job.kind)
+	{
+	case FLS_JOB_READ:		Fls_ProcessRead();
+	break;
+	case FLS_JOB_COMPARE:	Fls_ProcessCompare();
+	break;
+	case FLS_JOB_WRITE:		Fls_ProcessWrite();
+	break;
+	case FLS_JOB_ERASE:		Fls_ProcessErase();
+	break;
+	default:
+	break;
+	}
+
+#if (FLS_STATISTICS_API == STD_ON)
+	cycles = u32DWT_GetCycles() - cycles;
+	Fls_Statistics.MainFunctionCalls++;
+	if(cycles > Fls_Statistics.MaxMainFunctionCycles)
+	{
+		Fls_Statistics.MaxMainFunctionCycles = cycles;
+	}
+#endif
+}
+
+#if (FLS_STATISTICS_API == STD_ON)
+/***********************************************************************************
+ * @fn 	  	void Fls_GetStatistics(Fls_StatisticsType* statistics)
+ * @brief 	Function to copy the job measurements (not AUTOSAR)
+ * @param   (out): statistics - Destination
+ ***********************************************************************************/
+void Fls_GetStatistics(Fls_StatisticsType* statistics)
+{
+#if (FLS_DEV_ERROR_DETECT == STD_ON)
+	if(NULL_PTR == statistics)
+	{
+		Det_ReportError(FLS_MODULE_ID, FLS_INSTANCE_ID, FLS_MAIN_FUNCTION_SID, FLS_E_PARAM_POINTER);
+	}
+	else
+#endif
+	{
+		*statistics = Fls_Statistics;
+	}
+}
+#endif
+
+/**************************************************************************
+ * 					Static Global Functions Definition				 	  *
+***************************************************************************/
+
+/***********************************************************************************
+ * @fn 	  	STATIC uint8 Fls_GetSector(uint32 Address, uint32* SectorStart, uint32* SectorSize)
+ * @brief 	Function to find the sector holding an absolute address
+ * @note  	Each Bank: 4 x 16 KB, 1 x 64 KB, then 128 KB sectors
+ * @return	Sector number, 12..23 for Bank 2
+ ***********************************************************************************/
+STATIC uint8 Fls_GetSector(uint32 Address, uint32* SectorStart, uint32* SectorSize)
+{
+	uint32 offset = Address - FLASH_MEMORY_BASE_ADDRESS;
+	uint32 bankOffset = offset & (FLASH_BANK_SIZE - 1U);
+	uint8 sector;
+
+	if(bankOffset < 0x00010000UL)
+	{
+		sector = (uint8)(bankOffset >> 14);
+		*SectorSize = 0x00004000UL;
+	}
+	else if(bankOffset < 0x00020000UL)
+	{
+		sector = 4U;
+		*SectorSize = 0x00010000UL;
+	}
+	else
+	{
+		sector = (uint8)(5U + ((bankOffset - 0x00020000UL) >> 17));
+		*SectorSize = 0x00020000UL;
+	}
+
+	if(FLASH_BANK_SIZE <= offset)
+	{
+		sector += 12U;
+	}
+
+	*SectorStart = Address & ~(*SectorSize - 1U);
+
+	return sector;
+}
+
+/***********************************************************************************
+ * @fn 	  	STATIC boolean Fls_IsSectorBoundary(uint32 Address)
+ * @brief 	Function to check that an absolute address starts a sector
+ ***********************************************************************************/
+STATIC boolean Fls_IsSectorBoundary(uint32 Address)
+{
+	uint32 start, size;
+
+	(void)Fls_GetSector(Address, &start, &size);
+
+	return (start == Address) ? TRUE : FALSE;
+}
+
+/***********************************************************************************
+ * @fn 	  	STATIC boolean Fls_CheckState(uint8 ServiceId)
+ * @brief 	Function to check that the Module is initialized and idle
+ * @note	Busy is checked even without DET, a pending job is never replaced
+ * @return	TRUE if the service shall be rejected
+ ***********************************************************************************/
+STATIC boolean Fls_CheckState(uint8 ServiceId)
+{
+	boolean error = FALSE;
+
+	if(MEMIF_UNINIT == Fls_Status)
+	{
+#if (FLS_DEV_ERROR_DETECT == STD_ON)
+		Det_ReportError(FLS_MODULE_ID, FLS_INSTANCE_ID, ServiceId, FLS_E_UNINIT);
+#endif
+		error = TRUE;
+	}
+	else if(MEMIF_BUSY == Fls_Status)
+	{
+#if (FLS_DEV_ERROR_DETECT == STD_ON)
+		Det_ReportError(FLS_MODULE_ID, FLS_INSTANCE_ID, ServiceId, FLS_E_BUSY);
+#endif
+		error = TRUE;
+	}
+	else
+	{
+		/* No Action Required */
+	}
+
+	(void)ServiceId;
+
+	return error;
+}
+
+/***********************************************************************************
+ * @fn 	  	STATIC void Fls_StartJob(Fls_JobKindType Kind, Fls_AddressType Address, Fls_LengthType Length)
+ * @brief 	Function to hand a checked job to Fls_MainFunction
+ * @note	Write/Erase: Flash unlocked & Data Cache disabled till the job ends
+ ***********************************************************************************/
+STATIC void Fls_StartJob(Fls_JobKindType Kind, Fls_AddressType Address, Fls_LengthType Length)
+{
+	volatile FLASH_REG* Flash_Ptr = FLASH_INTERFACE_BASE_ADDRESS;
+
+	Fls_Job.kind = Kind;
+	Fls_Job.address = FLS_BASE_ADDRESS + Address;
+	Fls_Job.remaining = Length;
+	Fls_Job.length = Length;
+
+	if((FLS_JOB_WRITE == Kind) || (FLS_JOB_ERASE == Kind))
+	{
+		/* Flash still held by a canceled job keeps its saved Data Cache state */
+		if(FALSE == Fls_ReleasePending)
+		{
+			/*
+			 * Data Cache lines are not updated by programming/erase,
+			 * keep it off so the verification reads the Flash itself
+			 */
+			Fls_DataCacheEnabled = (0U != (Flash_Ptr->ACR & FLASH_ACR_DCEN_MASK)) ? TRUE : FALSE;
+			Flash_Ptr->ACR &= ~FLASH_ACR_DCEN_MASK;
+		}
+		Fls_ReleasePending = FALSE;
+
+		if(0U != (Flash_Ptr->CR & FLASH_CR_LOCK_MASK))
+		{
+			Flash_Ptr->KEYR = FLASH_KEY1;
+			Flash_Ptr->KEYR = FLASH_KEY2;
+		}
+	}
+
+#if (FLS_STATISTICS_API == STD_ON)
+	Fls_JobStartCycles = u32DWT_GetCycles();
+#endif
+
+	Fls_Status = MEMIF_BUSY;
+	Fls_JobResult = MEMIF_JOB_PENDING;
+
+	if(NULL_PTR != Fls_ConfigPtr->JobStartNotification)
+	{
+		Fls_ConfigPtr->JobStartNotification();
+	}
+}
+
+/***********************************************************************************
+ * @fn 	  	STATIC void Fls_EndJob(MemIf_JobResultType Result)
+ * @brief 	Function to end the pending job and call its notification
+ ***********************************************************************************/
+STATIC void Fls_EndJob(MemIf_JobResultType Result)
+{
+	if((FLS_JOB_WRITE == Fls_Job.kind) || (FLS_JOB_ERASE == Fls_Job.kind))
+	{
+		/* FLASH_CR is read only while an operation runs */
+		if(0U == (FLASH_INTERFACE_BASE_ADDRESS->SR & FLASH_SR_BSY_MASK))
+		{
+			Fls_ReleaseFlash();
+		}
+		else
+		{
+			Fls_ReleasePending = TRUE;
+		}
+	}
+
+#if (FLS_STATISTICS_API == STD_ON)
+	Fls_Statistics.LastJobLength = Fls_Job.length;
+	Fls_Statistics.LastJobCycles = u32DWT_GetCycles() - Fls_JobStartCycles;
+	if(MEMIF_JOB_FAILED == Result)
+	{
+		Fls_Statistics.FailedJobs++;
+	}
+#endif
+
+#if (FLS_TRACE_ENABLE == STD_ON)
+	TRACE2("Fls: job %u result %u", Fls_Job.kind, Result);
+#endif
+
+	Fls_Job.kind = FLS_JOB_NONE;
+	Fls_Status = MEMIF_IDLE;
+	Fls_JobResult = Result;
+
+	if(MEMIF_JOB_OK == Result)
+	{
+		if(NULL_PTR != Fls_ConfigPtr->JobEndNotification)
+		{
+			Fls_ConfigPtr->JobEndNotification();
+		}
+	}
+	else
+	{
+		if(NULL_PTR != Fls_ConfigPtr->JobErrorNotification)
+		{
+			Fls_ConfigPtr->JobErrorNotification();
+		}
+	}
+}
+
+/***********************************************************************************
+ * @fn 	  	STATIC void Fls_ReleaseFlash(void)
+ * @brief 	Function to leave programming/erase mode, lock the Flash and
+ * 			enable the Data Cache again (reset, it may hold old contents)
+ * @note	Flash shall not be busy
+ ***********************************************************************************/
+STATIC void Fls_ReleaseFlash(void)
+{
+	volatile FLASH_REG* Flash_Ptr = FLASH_INTERFACE_BASE_ADDRESS;
+
+	Flash_Ptr->CR &= ~(FLASH_CR_PG_MASK | FLASH_CR_SER_MASK | FLASH_CR_SNB_MASK);
+	Flash_Ptr->CR |= FLASH_CR_LOCK_MASK;
+
+	if(TRUE == Fls_DataCacheEnabled)
+	{
+		Flash_Ptr->ACR |= FLASH_ACR_DCRST_MASK;
+		Flash_Ptr->ACR &= ~FLASH_ACR_DCRST_MASK;
+		Flash_Ptr->ACR |= FLASH_ACR_DCEN_MASK;
+	}
+
+	Fls_ReleasePending = FALSE;
+}
+
+/***********************************************************************************
+ * @fn 	  	STATIC Fls_LengthType Fls_GetMaxRead(void)
+ * @brief 	Function to get the bytes read per Fls_MainFunction call
+ ***********************************************************************************/
+STATIC Fls_LengthType Fls_GetMaxRead(void)
+{
+	return (MEMIF_MODE_FAST == Fls_Mode) ? Fls_ConfigPtr->MaxReadFastMode : Fls_ConfigPtr->MaxReadNormalMode;
+}
+
+/***********************************************************************************
+ * @fn 	  	STATIC Fls_LengthType Fls_GetMaxWrite(void)
+ * @brief 	Function to get the bytes programmed per Fls_MainFunction call
+ ***********************************************************************************/
+STATIC Fls_LengthType Fls_GetMaxWrite(void)
+{
+	return (MEMIF_MODE_FAST == Fls_Mode) ? Fls_ConfigPtr->MaxWriteFastMode : Fls_ConfigPtr->MaxWriteNormalMode;
+}
+
+/***********************************************************************************
+ * @fn 	  	STATIC Std_ReturnType Fls_ProgramUnit(uint32 Address, const uint8* Data)
+ * @brief 	Function to program FLS_PAGE_SIZE bytes with the configured parallelism
+ * @note	FLASH_CR PG & PSIZE shall be set
+ * @note	Blocks for one unit programming time (16 us typical at x32)
+ ***********************************************************************************/
+STATIC Std_ReturnType Fls_ProgramUnit(uint32 Address, const uint8* Data)
+{
+	volatile FLASH_REG* Flash_Ptr = FLASH_INTERFACE_BASE_ADDRESS;
+	Fls_UnitType value = 0;
+	uint32 timeout = 0;
+	uint8 counter;
+
+	/* Source buffer may be unaligned, build the unit byte by byte (little endian) */
+	for(counter = 0; counter < FLS_PAGE_SIZE; counter++)
+	{
+		value |= (Fls_UnitType)((Fls_UnitType)Data[counter] << (counter * 8U));
+	}
+
+	*(volatile Fls_UnitType*)Address = value;
+
+	while(0U != (Flash_Ptr->SR & FLASH_SR_BSY_MASK))
+	{
+		if(FLS_WRITE_TIMEOUT <= ++timeout)
+		{
+#if (FLS_DEV_ERROR_DETECT == STD_ON)
+			Det_ReportError(FLS_MODULE_ID, FLS_INSTANCE_ID, FLS_MAIN_FUNCTION_SID, FLS_E_TIMEOUT);
+#endif
+			return E_NOT_OK;
+		}
+	}
+
+	if(0U != (Flash_Ptr->SR & FLASH_SR_ERRORS_MASK))
+	{
+		Flash_Ptr->SR = FLASH_SR_ERRORS_MASK;
+		return E_NOT_OK;
+	}
+
+#if (FLS_WRITE_VERIFICATION_ENABLED == STD_ON)
+	if(value != *(volatile const Fls_UnitType*)Address)
+	{
+#if (FLS_DEV_ERROR_DETECT == STD_ON)
+		Det_ReportError(FLS_MODULE_ID, FLS_INSTANCE_ID, FLS_MAIN_FUNCTION_SID, FLS_E_VERIFY_WRITE_FAILED);
+#endif
+		return E_NOT_OK;
+	}
+#endif
+
+	return E_OK;
+}
+
+/***********************************************************************************
+ * @fn 	  	STATIC void Fls_ProcessRead(void)
+ * @brief 	Function to copy up to Max Read bytes of the Read job
+ ***********************************************************************************/
+STATIC void Fls_ProcessRead(void)
+{
+	const volatile uint8* Flash_Ptr = (const volatile uint8*)Fls_Job.address;
+	Fls_LengthType count = Fls_GetMaxRead();
+	Fls_LengthType counter;
+
+	/* Reading a Bank being erased stalls the CPU, wait for the erase */
+	if(0U != (FLASH_INTERFACE_BASE_ADDRESS->SR & FLASH_SR_BSY_MASK))
+	{
+		return;
+	}
+
+	if(count > Fls_Job.remaining)
+	{
+		count = Fls_Job.remaining;
+	}
+
+	for(counter = 0; counter < count; counter++)
+	{
+		Fls_Job.readPtr[counter] = Flash_Ptr[counter];
+	}
+
+	Fls_Job.readPtr += count;
+	Fls_Job.address += count;
+	Fls_Job.remaining -= count;
+
+	if(0U == Fls_Job.remaining)
+	{
+		Fls_EndJob(MEMIF_JOB_OK);
+	}
+}
+
+/***********************************************************************************
+ * @fn 	  	STATIC void Fls_ProcessCompare(void)
+ * @brief 	Function to compare up to Max Read bytes of the Compare job
+ ***********************************************************************************/
+STATIC void Fls_ProcessCompare(void)
+{
+	const volatile uint8* Flash_Ptr = (const volatile uint8*)Fls_Job.address;
+	Fls_LengthType count = Fls_GetMaxRead();
+	Fls_LengthType counter;
+
+	/* Reading a Bank being erased stalls the CPU, wait for the erase */
+	if(0U != (FLASH_INTERFACE_BASE_ADDRESS->SR & FLASH_SR_BSY_MASK))
+	{
+		return;
+	}
+
+	if(count > Fls_Job.remaining)
+	{
+		count = Fls_Job.remaining;
+	}
+
+	for(counter = 0; counter < count; counter++)
+	{
+		if(Fls_Job.dataPtr[counter] != Flash_Ptr[counter])
+		{
+			Fls_EndJob(MEMIF_BLOCK_INCONSISTENT);
+			return;
+		}
+	}
+
+	Fls_Job.dataPtr += count;
+	Fls_Job.address += count;
+	Fls_Job.remaining -= count;
+
+	if(0U == Fls_Job.remaining)
+	{
+		Fls_EndJob(MEMIF_JOB_OK);
+	}
+}
+
+/***********************************************************************************
+ * @fn 	  	STATIC void Fls_ProcessWrite(void)
+ * @brief 	Function to program up to Max Write bytes of the Write job,
+ * 			at least one unit per call
+ ***********************************************************************************/
+STATIC void Fls_ProcessWrite(void)
+{
+	volatile FLASH_REG* Flash_Ptr = FLASH_INTERFACE_BASE_ADDRESS;
+	Fls_LengthType budget = Fls_GetMaxWrite();
+
+	/* Erase of a canceled job still running */
+	if(0U != (Flash_Ptr->SR & FLASH_SR_BSY_MASK))
+	{
+		return;
+	}
+
+	/* Clear the flags of older operations, select parallelism & programming */
+	Flash_Ptr->SR = FLASH_SR_ERRORS_MASK | FLASH_SR_EOP_MASK;
+	Flash_Ptr->CR = (Flash_Ptr->CR & ~(FLASH_CR_SER_MASK | FLASH_CR_SNB_MASK | FLASH_CR_PSIZE_MASK))
+			| ((uint32)FLS_VOLTAGE_RANGE << FLASH_CR_PSIZE_SHIFT) | FLASH_CR_PG_MASK;
+
+	do
+	{
+		if(E_OK != Fls_ProgramUnit(Fls_Job.address, Fls_Job.dataPtr))
+		{
+			Fls_EndJob(MEMIF_JOB_FAILED);
+			return;
+		}
+
+		Fls_Job.dataPtr += FLS_PAGE_SIZE;
+		Fls_Job.address += FLS_PAGE_SIZE;
+		Fls_Job.remaining -= FLS_PAGE_SIZE;
+		budget = (budget > FLS_PAGE_SIZE) ? (budget - FLS_PAGE_SIZE) : 0U;
+
+	}while((0U != Fls_Job.remaining) && (0U != budget));
+
+	if(0U == Fls_Job.remaining)
+	{
+		Fls_EndJob(MEMIF_JOB_OK);
+	}
+}
+
+/***********************************************************************************
+ * @fn 	  	STATIC void Fls_ProcessErase(void)
+ * @brief 	Function to run one step of the Erase job:
+ * 			- START:  start the sector erase and return at once
+ * 			- WAIT:   one poll of the running erase (no busy waiting)
+ * 			- VERIFY: blank check of up to Max Read bytes of the sector
+ ***********************************************************************************/
+STATIC void Fls_ProcessErase(void)
+{
+	volatile FLASH_REG* Flash_Ptr = FLASH_INTERFACE_BASE_ADDRESS;
+	uint32 sectorStart, sectorSize;
+	uint8 sector;
+
+	switch(Fls_Job.eraseStep)
+	{
+	case FLS_ERASE_START:
+		/* Erase of a canceled job still running */
+		if(0U != (Flash_Ptr->SR & FLASH_SR_BSY_MASK))
+		{
+			break;
+		}
+
+		sector = Fls_GetSector(Fls_Job.address, &sectorStart, &sectorSize);
+		Fls_Job.sectorEnd = sectorStart + sectorSize;
+
+		if(12U <= sector)
+		{
+			sector += FLASH_SNB_BANK2_OFFSET;
+		}
+
+		Flash_Ptr->SR = FLASH_SR_ERRORS_MASK | FLASH_SR_EOP_MASK;
+		Flash_Ptr->CR = (Flash_Ptr->CR & ~(FLASH_CR_PG_MASK | FLASH_CR_SNB_MASK | FLASH_CR_PSIZE_MASK))
+				| ((uint32)FLS_VOLTAGE_RANGE << FLASH_CR_PSIZE_SHIFT)
+				| ((uint32)sector << FLASH_CR_SNB_SHIFT) | FLASH_CR_SER_MASK;
+		Flash_Ptr->CR |= FLASH_CR_STRT_MASK;
+
+		Fls_Job.timeout = 0;
+		Fls_Job.eraseStep = FLS_ERASE_WAIT;
+		break;
+
+	case FLS_ERASE_WAIT:
+		if(0U != (Flash_Ptr->SR & FLASH_SR_BSY_MASK))
+		{
+			if(FLS_ERASE_TIMEOUT <= ++Fls_Job.timeout)
+			{
+#if (FLS_DEV_ERROR_DETECT == STD_ON)
+				Det_ReportError(FLS_MODULE_ID, FLS_INSTANCE_ID, FLS_MAIN_FUNCTION_SID, FLS_E_TIMEOUT);
+#endif
+				Fls_EndJob(MEMIF_JOB_FAILED);
+			}
+			break;
+		}
+
+		Flash_Ptr->CR &= ~(FLASH_CR_SER_MASK | FLASH_CR_SNB_MASK);
+
+		if(0U != (Flash_Ptr->SR & FLASH_SR_ERRORS_MASK))
+		{
+			Flash_Ptr->SR = FLASH_SR_ERRORS_MASK;
+			Fls_EndJob(MEMIF_JOB_FAILED);
+			break;
+		}
+
+#if (FLS_ERASE_VERIFICATION_ENABLED == STD_ON)
+		Fls_Job.eraseStep = FLS_ERASE_VERIFY;
+#else
+		Fls_Job.remaining -= Fls_Job.sectorEnd - Fls_Job.address;
+		Fls_Job.address = Fls_Job.sectorEnd;
+		Fls_Job.eraseStep = FLS_ERASE_START;
+
+		if(0U == Fls_Job.remaining)
+		{
+			Fls_EndJob(MEMIF_JOB_OK);
+		}
+#endif
+		break;
+
+#if (FLS_ERASE_VERIFICATION_ENABLED == STD_ON)
+	case FLS_ERASE_VERIFY:
+	{
+		const volatile uint32* Word_Ptr = (const volatile uint32*)Fls_Job.address;
+		Fls_LengthType count = Fls_GetMaxRead() / sizeof(uint32);
+		Fls_LengthType counter;
+
+		/* Sectors are word aligned, check whole words */
+		if(0U == count)
+		{
+			count = 1U;
+		}
+		if(count > ((Fls_Job.sectorEnd - Fls_Job.address) / sizeof(uint32)))
+		{
+			count = (Fls_Job.sectorEnd - Fls_Job.address) / sizeof(uint32);
+		}
+
+		for(counter = 0; counter < count; counter++)
+		{
+			if(0xFFFFFFFFUL != Word_Ptr[counter])
+			{
+#if (FLS_DEV_ERROR_DETECT == STD_ON)
+				Det_ReportError(FLS_MODULE_ID, FLS_INSTANCE_ID, FLS_MAIN_FUNCTION_SID, FLS_E_VERIFY_ERASE_FAILED);
+#endif
+				Fls_EndJob(MEMIF_JOB_FAILED);
+				return;
+			}
+		}
+
+		Fls_Job.address += count * sizeof(uint32);
+		Fls_Job.remaining -= count * sizeof(uint32);
+
+		if(0U == Fls_Job.remaining)
+		{
+			Fls_EndJob(MEMIF_JOB_OK);
+		}
+		else if(Fls_Job.address == Fls_Job.sectorEnd)
+		{
+			Fls_Job.eraseStep = FLS_ERASE_START;
+		}
+		else
+		{
+			/* No Action Required */
+		}
+		break;
+	}
+#endif
+
+	default:
+		break;
+	}
+}
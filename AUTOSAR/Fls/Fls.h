@@ -1,13 +1,309 @@
+ /******************************************************************************
+ *
+ * Module: 		Fls
+ *
+ * File Name: 	Fls.h
+ *
+ * Description: Header file for STM32F429 Microcontroller - Fls Driver
+ *
+ * Author: 		Islam Ehab
+ *
+ * Date:		19/10/2026
+ ******************************************************************************/
+/*******************************************************************************
+ * @file:	Fls.h
+ *
+ * @brief:	Header file for STM32F429 Microcontroller - Fls Driver
+ *
+ * @author:	Islam Ehab
+ *
+ * @date:	19/10/2026
+ ******************************************************************************/
+#ifndef FLS_H
+#define FLS_H
+
+/*
+ * ID of Company in AUTOSAR Website
+ * Islam Ehab's ID = 1024
+*/
+#define FLS_VENDOR_ID    (1024U)
+
+/* Fls Module Id */
+#define FLS_MODULE_ID    (92U)
+
+/* Fls Instance Id */
+#define FLS_INSTANCE_ID  (0U)
+
+/*
+ * Module Version 1.0.0
+ */
+#define FLS_SW_MAJOR_VERSION           (1U)
+#define FLS_SW_MINOR_VERSION           (0U)
+#define FLS_SW_PATCH_VERSION           (0U)
+
+/*
+ * AUTOSAR Version 4.3.1
+ */
+#define FLS_AR_RELEASE_MAJOR_VERSION   (4U)
+#define FLS_AR_RELEASE_MINOR_VERSION   (3U)
+#define FLS_AR_RELEASE_PATCH_VERSION   (1U)
+
+/* Standard AUTOSAR types */
+#include "Std_Types.h"
+
+/* AUTOSAR checking between Std Types and Fls Modules */
+#if ((STD_TYPES_AR_RELEASE_MAJOR_VERSION != FLS_AR_RELEASE_MAJOR_VERSION)\
+ ||  (STD_TYPES_AR_RELEASE_MINOR_VERSION != FLS_AR_RELEASE_MINOR_VERSION)\
+ ||  (STD_TYPES_AR_RELEASE_PATCH_VERSION != FLS_AR_RELEASE_PATCH_VERSION))
+  #error "The AR version of Std_Types.h does not match the expected version"
+#endif
+
+/* Fls Pre-Compile Configuration Header file */
+#include "Fls_Cfg.h"
+
+/* AUTOSAR Version checking between Fls_Cfg.h and Fls.h files */
+#if ((FLS_CFG_AR_RELEASE_MAJOR_VERSION != FLS_AR_RELEASE_MAJOR_VERSION)\
+ ||  (FLS_CFG_AR_RELEASE_MINOR_VERSION != FLS_AR_RELEASE_MINOR_VERSION)\
+ ||  (FLS_CFG_AR_RELEASE_PATCH_VERSION != FLS_AR_RELEASE_PATCH_VERSION))
+  #error "The AR version of Fls_Cfg.h does not match the expected version"
+#endif
+
+/* Software Version checking between Fls_Cfg.h and Fls.h files */
+#if ((FLS_CFG_SW_MAJOR_VERSION != FLS_SW_MAJOR_VERSION)\
+ ||  (FLS_CFG_SW_MINOR_VERSION != FLS_SW_MINOR_VERSION)\
+ ||  (FLS_CFG_SW_PATCH_VERSION != FLS_SW_PATCH_VERSION))
+  #error "The SW version of Fls_Cfg.h does not match the expected version"
+#endif
+
+/* Non AUTOSAR files */
+#include "Common_Macros.h"
+
+/******************************************************************************
+ *                      API Service Id Macros                                 *
+ ******************************************************************************/
+/* Service ID for Fls Init */
+#define FLS_INIT_SID                   (uint8)0x00
+
+/* Service ID for Fls Erase */
+#define FLS_ERASE_SID                  (uint8)0x01
+
+/* Service ID for Fls Write */
+#define FLS_WRITE_SID                  (uint8)0x02
+
+/* Service ID for Fls Cancel */
+#define FLS_CANCEL_SID                 (uint8)0x03
+
+/* Service ID for Fls GetStatus */
+#define FLS_GET_STATUS_SID             (uint8)0x04
+
+/* Service ID for Fls GetJobResult */
+#define FLS_GET_JOB_RESULT_SID         (uint8)0x05
+
+/* Service ID for Fls MainFunction */
+#define FLS_MAIN_FUNCTION_SID          (uint8)0x06
+
+/* Service ID for Fls Read */
+#define FLS_READ_SID                   (uint8)0x07
+
+/* Service ID for Fls Compare */
+#define FLS_COMPARE_SID                (uint8)0x08
+
+/* Service ID for Fls SetMode */
+#define FLS_SET_MODE_SID               (uint8)0x09
+
+/* Service ID for Fls GetVersionInfo */
+#define FLS_GET_VERSION_INFO_SID       (uint8)0x10
+
+/*******************************************************************************
+ *                      DET Error Codes                                        *
+ *******************************************************************************/
+/* API service called with wrong configuration pointer */
+#define FLS_E_PARAM_CONFIG             (uint8)0x01
+
+/* API service called with wrong address */
+#define FLS_E_PARAM_ADDRESS            (uint8)0x02
+
+/* API service called with wrong length */
+#define FLS_E_PARAM_LENGTH             (uint8)0x03
+
+/* API service called with NULL data buffer */
+#define FLS_E_PARAM_DATA               (uint8)0x04
+
+/* API service used without module initialization */
+#define FLS_E_UNINIT                   (uint8)0x05
+
+/* API service called while a job is pending */
+#define FLS_E_BUSY                     (uint8)0x06
+
+/* Erase verification (blank check) failed */
+#define FLS_E_VERIFY_ERASE_FAILED      (uint8)0x07
+
+/* Write verification (read back) failed */
+#define FLS_E_VERIFY_WRITE_FAILED      (uint8)0x08
+
+/* Flash operation did not end in time */
+#define FLS_E_TIMEOUT                  (uint8)0x09
+
+/* API service called with NULL pointer */
+#define FLS_E_PARAM_POINTER            (uint8)0x0A
+
+/*******************************************************************************
+ *                              Module Data Types                              *
+ *******************************************************************************/
+
 /*
- * Fls.h
+ * MemIf types used by the Fls APIs
+ * Note: There is no MemIf Module in this project, they are kept here
+ */
+#ifndef MEMIF_TYPES_H
+#define MEMIF_TYPES_H
+
+/**
+ * @enum	MemIf_StatusType
+ *
+ * @brief	Status of the Fls Module
+ */
+typedef enum{
+	MEMIF_UNINIT,				//!< Module not initialized
+	MEMIF_IDLE,					//!< No job pending
+	MEMIF_BUSY,					//!< A job is pending
+	MEMIF_BUSY_INTERNAL			//!< Not used by Fls
+}MemIf_StatusType;
+
+/**
+ * @enum	MemIf_JobResultType
+ *
+ * @brief	Result of the last job
+ */
+typedef enum{
+	MEMIF_JOB_OK,				//!< Last job ended successfully
+	MEMIF_JOB_FAILED,			//!< Last job failed
+	MEMIF_JOB_PENDING,			//!< Job is being processed by Fls_MainFunction
+	MEMIF_JOB_CANCELED,			//!< Last job canceled by Fls_Cancel
+	MEMIF_BLOCK_INCONSISTENT,	//!< Fls_Compare found a difference
+	MEMIF_BLOCK_INVALID			//!< Not used by Fls
+}MemIf_JobResultType;
+
+/**
+ * @enum	MemIf_ModeType
+ *
+ * @brief	Slow mode bounds each Fls_MainFunction call to the Normal Mode
+ * 			byte counts, Fast mode to the Fast Mode ones
+ */
+typedef enum{
+	MEMIF_MODE_SLOW,
+	MEMIF_MODE_FAST
+}MemIf_ModeType;
+
+#endif /* MEMIF_TYPES_H */
+
+/* Offset from FLS_BASE_ADDRESS */
+typedef uint32 Fls_AddressType;
+
+/* Number of bytes */
+typedef uint32 Fls_LengthType;
+
+/**
+ * @struct	Fls_ConfigType
+ *
+ * @brief	Fls post build configuration
  *
- *  Created on: Dec 21, 2020
- *      Author: islam
+ * @note	The Max* members bound the work of one Fls_MainFunction call
+ * 			Write counts shall be multiple of FLS_PAGE_SIZE
+ * 			JobStartNotification lets the caller of Fls_MainFunction run it
+ * 			only while Fls_GetStatus reports MEMIF_BUSY
  */
+typedef struct{
+
+	void 			(*JobEndNotification)(void);	/* Called when a job ends OK, NULL_PTR if not used 		*/
+	void 			(*JobErrorNotification)(void);	/* Called when a job fails or is canceled, NULL_PTR if not used */
+	MemIf_ModeType	DefaultMode;					/* Mode set by Fls_Init 								*/
+	Fls_LengthType	MaxReadFastMode;				/* Bytes read/compared/blank checked per call, Fast Mode	*/
+	Fls_LengthType	MaxReadNormalMode;				/* Bytes read/compared/blank checked per call, Slow Mode	*/
+	Fls_LengthType	MaxWriteFastMode;				/* Bytes programmed per call, Fast Mode					*/
+	Fls_LengthType	MaxWriteNormalMode;				/* Bytes programmed per call, Slow Mode					*/
+	void 			(*JobStartNotification)(void);	/* Called when a job is accepted (not AUTOSAR), NULL_PTR if not used */
+
+}Fls_ConfigType;
+
+#if (FLS_STATISTICS_API == STD_ON)
+/**
+ * @struct	Fls_StatisticsType
+ *
+ * @brief	Measurements of the Fls jobs in DWT cycles
+ *
+ * @note	Throughput of the last job = LastJobLength * SYSCLK / LastJobCycles
+ */
+typedef struct{
+
+	uint32			MainFunctionCalls;				/* Fls_MainFunction calls with a pending job			*/
+	uint32			MaxMainFunctionCycles;			/* Worst case Fls_MainFunction execution time			*/
+	uint32			LastJobLength;					/* Bytes of the last ended job							*/
+	uint32			LastJobCycles;					/* Time from job request to job end						*/
+	uint32			FailedJobs;						/* Jobs ended with MEMIF_JOB_FAILED						*/
+
+}Fls_StatisticsType;
+#endif
+
+/*******************************************************************************
+ *                      Function Prototypes                                    *
+ *******************************************************************************/
+
+/* Function used to initialize the Fls Module */
+void Fls_Init(const Fls_ConfigType* ConfigPtr);
+
+/* Function used to request an erase job (whole sectors) */
+Std_ReturnType Fls_Erase(Fls_AddressType TargetAddress, Fls_LengthType Length);
+
+/* Function used to request a write job */
+Std_ReturnType Fls_Write(Fls_AddressType TargetAddress, const uint8* SourceAddressPtr, Fls_LengthType Length);
+
+#if (FLS_CANCEL_API == STD_ON)
+/* Function used to cancel the pending job */
+void Fls_Cancel(void);
+#endif
+
+#if (FLS_GET_STATUS_API == STD_ON)
+/* Function used to get the Fls Module status */
+MemIf_StatusType Fls_GetStatus(void);
+#endif
+
+#if (FLS_GET_JOB_RESULT_API == STD_ON)
+/* Function used to get the result of the last job */
+MemIf_JobResultType Fls_GetJobResult(void);
+#endif
+
+/* Function used to request a read job */
+Std_ReturnType Fls_Read(Fls_AddressType SourceAddress, uint8* TargetAddressPtr, Fls_LengthType Length);
+
+#if (FLS_COMPARE_API == STD_ON)
+/* Function used to request a compare job */
+Std_ReturnType Fls_Compare(Fls_AddressType SourceAddress, const uint8* TargetAddressPtr, Fls_LengthType Length);
+#endif
+
+#if (FLS_SET_MODE_API == STD_ON)
+/* Function used to select the Slow or Fast Mode */
+void Fls_SetMode(MemIf_ModeType Mode);
+#endif
+
+#if (FLS_VERSION_INFO_API == STD_ON)
+/* Function used to get Fls Module Id, Vendor Id and Vendor specific version Number */
+void Fls_GetVersionInfo(Std_VersionInfoType* versioninfo);
+#endif
+
+/* Function used to process the pending job, called cyclically */
+void Fls_MainFunction(void);
 
-#ifndef FLS_FLS_H_
-#define FLS_FLS_H_
+#if (FLS_STATISTICS_API == STD_ON)
+/* Function used to get the job measurements (not AUTOSAR) */
+void Fls_GetStatistics(Fls_StatisticsType* statistics);
+#endif
 
+/*******************************************************************************
+ *                       External Variables                                    *
+ *******************************************************************************/
 
+/* Extern PB structures to be used by Fls_Init */
+extern const Fls_ConfigType Fls_Configuration;
 
-#endif /* FLS_FLS_H_ */
+#endif /* FLS_H */
@@ -1,13 +1,123 @@
-/*
- * Fls_Cfg.h
+ /******************************************************************************
+ *
+ * Module: 		Fls
+ *
+ * File Name: 	Fls_Cfg.h
+ *
+ * Description: Link Time (Pre-Compile) Configuration Header file
+ * 				for STM32F429 Microcontroller - Fls Driver
+ *
+ * Version      1.0.0
  *
- *  Created on: Dec 21, 2020
- *      Author: islam
+ * Author: 		Islam Ehab
+ *
+ * Date:		19/10/2026
+ ******************************************************************************/
+/*******************************************************************************
+ * @file:	Fls_Cfg.h
+ *
+ * @brief:	Link Time (Pre-Compile) Configuration Header file
+ * 			for STM32F429 Microcontroller - Fls Driver
+ *
+ * @author:	Islam Ehab
+ *
+ * @date:	19/10/2026
+ ******************************************************************************/
+
+#ifndef FLS_CFG_H
+#define FLS_CFG_H
+
+/*
+ * Module Version 1.0.0
+ */
+#define FLS_CFG_SW_MAJOR_VERSION              (1U)
+#define FLS_CFG_SW_MINOR_VERSION              (0U)
+#define FLS_CFG_SW_PATCH_VERSION              (0U)
+
+/*
+ * AUTOSAR Version 4.3.1
  */
+#define FLS_CFG_AR_RELEASE_MAJOR_VERSION     (4U)
+#define FLS_CFG_AR_RELEASE_MINOR_VERSION     (3U)
+#define FLS_CFG_AR_RELEASE_PATCH_VERSION     (1U)
+
+/* Pre-compile option for Development Error Detect */
+#define FLS_DEV_ERROR_DETECT                (STD_ON)
+
+/* Pre-compile option for Version Info API */
+#define FLS_VERSION_INFO_API                (STD_ON)
+
+/* Pre-compile options for presence of the optional APIs */
+#define FLS_CANCEL_API                      (STD_ON)
+#define FLS_COMPARE_API                     (STD_ON)
+#define FLS_GET_STATUS_API                  (STD_ON)
+#define FLS_GET_JOB_RESULT_API              (STD_ON)
+#define FLS_SET_MODE_API                    (STD_ON)
+
+/* Blank check every erased sector before the Erase job ends */
+#define FLS_ERASE_VERIFICATION_ENABLED      (STD_ON)
 
-#ifndef FLS_FLS_CFG_H_
-#define FLS_FLS_CFG_H_
+/* Read back every programmed unit before the Write job goes on */
+#define FLS_WRITE_VERIFICATION_ENABLED      (STD_ON)
+
+/*
+ * Pre-compile option for Fls_GetStatistics API (not AUTOSAR)
+ * Note: Uses the DWT Cycle Counter, vidDWT_Init() must be called first
+ */
+#define FLS_STATISTICS_API                  (STD_ON)
+
+/* Pre-compile option for Trace Points (Drivers/TRACE) */
+#define FLS_TRACE_ENABLE                    (STD_OFF)
+
+/*
+ * Supply voltage range of the board, selects the program parallelism:
+ * FLS_VOLTAGE_RANGE_1 (1.8V - 2.1V) : x8
+ * FLS_VOLTAGE_RANGE_2 (2.1V - 2.7V) : x16
+ * FLS_VOLTAGE_RANGE_3 (2.7V - 3.6V) : x32
+ * FLS_VOLTAGE_RANGE_4 (2.7V - 3.6V with External Vpp) : x64
+ */
+#define FLS_VOLTAGE_RANGE_1                 (0U)
+#define FLS_VOLTAGE_RANGE_2                 (1U)
+#define FLS_VOLTAGE_RANGE_3                 (2U)
+#define FLS_VOLTAGE_RANGE_4                 (3U)
+
+/* STM32F429I-Discovery runs at 3V without Vpp */
+#define FLS_VOLTAGE_RANGE                   FLS_VOLTAGE_RANGE_3
+
+/*
+ * Smallest programmable unit in bytes (FLASH_CR PSIZE)
+ * Write Address & Length shall be multiple of it
+ */
+#define FLS_PAGE_SIZE                       (1UL << FLS_VOLTAGE_RANGE)
+
+/*
+ * Flash area owned by the Fls Driver, Fls_AddressType is an offset from
+ * FLS_BASE_ADDRESS. It must start & end on sector boundaries and must be
+ * kept out of the FLASH region of the linker script.
+ */
+#ifdef STM32F429
+/* Sectors 22 & 23 (Bank 2), program keeps running from Bank 1 while they are erased */
+#define FLS_BASE_ADDRESS                    (0x081C0000UL)
+#else
+/* Sectors 10 & 11 */
+#define FLS_BASE_ADDRESS                    (0x080C0000UL)
+#endif
+#define FLS_TOTAL_SIZE                      (0x00040000UL)
+
+/* Period of the Fls_MainFunction calls (Fls Task, src/main.c) */
+#define FLS_MAIN_FUNCTION_PERIOD_MS         (1UL)
+
+/*
+ * Time a sector erase may take before the job fails
+ * 128 KB sector: 2 s max at x32, 4 s max at x8 (STM32F429 datasheet)
+ */
+#define FLS_ERASE_TIMEOUT_MS                (4000UL)
 
+/* Same timeout in Fls_MainFunction calls, counted while the erase runs */
+#define FLS_ERASE_TIMEOUT                   ((FLS_ERASE_TIMEOUT_MS + FLS_MAIN_FUNCTION_PERIOD_MS - 1UL)\
+												/ FLS_MAIN_FUNCTION_PERIOD_MS)
 
+/* Busy polls one programmed unit may take before the job fails */
+#define FLS_WRITE_TIMEOUT                   (0x00010000UL)
 
-#endif /* FLS_FLS_CFG_H_ */
+#endif /* FLS_CFG_H */
@@ -0,0 +1,71 @@
+ /******************************************************************************
+ *
+ * Module: 		Fls
+ *
+ * File Name: 	Fls_Lcfg.c
+ *
+ * Description: Link time (Post Build) Configuration Source file for
+ * 				STM32F429 Microcontroller - Fls Driver
+ *
+ * Author: 		Islam Ehab
+ *
+ * Date;		19/10/2026
+ ******************************************************************************/
+/*******************************************************************************
+ * @file:	Fls_Lcfg.c
+ *
+ * @brief:	Link time (Post Build) Configuration Source file for
+ * 			STM32F429 Microcontroller - Fls Driver
+ *
+ * @author:	Islam Ehab
+ *
+ * @date:	19/10/2026
+ ******************************************************************************/
+#include "Fls.h"
+
+/*
+ * Module Version 1.0.0
+ */
+#define FLS_PBCFG_SW_MAJOR_VERSION              (1U)
+#define FLS_PBCFG_SW_MINOR_VERSION              (0U)
+#define FLS_PBCFG_SW_PATCH_VERSION              (0U)
+
+/*
+ * AUTOSAR Version 4.3.1
+ */
+#define FLS_PBCFG_AR_RELEASE_MAJOR_VERSION     (4U)
+#define FLS_PBCFG_AR_RELEASE_MINOR_VERSION     (3U)
+#define FLS_PBCFG_AR_RELEASE_PATCH_VERSION     (1U)
+
+/* AUTOSAR Version checking between Fls_PBcfg.c and Fls.h files */
+#if ((FLS_PBCFG_AR_RELEASE_MAJOR_VERSION != FLS_AR_RELEASE_MAJOR_VERSION)\
+ ||  (FLS_PBCFG_AR_RELEASE_MINOR_VERSION != FLS_AR_RELEASE_MINOR_VERSION)\
+ ||  (FLS_PBCFG_AR_RELEASE_PATCH_VERSION != FLS_AR_RELEASE_PATCH_VERSION))
+  #error "The AR version of PBcfg.c does not match the expected version"
+#endif
+
+/* Software Version checking between Fls_PBcfg.c and Fls.h files */
+#if ((FLS_PBCFG_SW_MAJOR_VERSION != FLS_SW_MAJOR_VERSION)\
+ ||  (FLS_PBCFG_SW_MINOR_VERSION != FLS_SW_MINOR_VERSION)\
+ ||  (FLS_PBCFG_SW_PATCH_VERSION != FLS_SW_PATCH_VERSION))
+  #error "The SW version of PBcfg.c does not match the expected version"
+#endif
+
+/* Arms the Fls Task timer (src/main.c) */
+extern void Fls_TaskJobStart(void);
+
+/*
+ * PB structure used with Fls_Init API
+ * Slow Mode: 64 bytes programmed (~16 x32 units of 16us) per 1 ms call
+ * Fast Mode: 256 bytes programmed per call, for start-up or shut-down
+ */
+const Fls_ConfigType Fls_Configuration = {
+											NULL_PTR,				/* JobEndNotification	*/
+											NULL_PTR,				/* JobErrorNotification	*/
+											MEMIF_MODE_SLOW,		/* DefaultMode			*/
+											1024U,					/* MaxReadFastMode		*/
+											256U,					/* MaxReadNormalMode	*/
+											256U,					/* MaxWriteFastMode		*/
+											64U,					/* MaxWriteNormalMode	*/
+											Fls_TaskJobStart		/* JobStartNotification	*/
+				         };
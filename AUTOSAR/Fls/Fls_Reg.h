@@ -1,13 +1,93 @@
-/*
- * Fls_Reg.h
+ /******************************************************************************
  *
- *  Created on: Dec 21, 2020
- *      Author: islam
+ * Module: 		Fls
+ *
+ * File Name: 	Fls_Reg.h
+ *
+ * Description: Header file for STM32F429 Microcontroller - Fls Driver Registers
+ *
+ * Author: 		Islam Ehab
+ *
+ * Date:		19/10/2026
+ ******************************************************************************/
+/*******************************************************************************
+ * @file:	Fls_Reg.h
+ *
+ * @brief:	Header file for STM32F429 Microcontroller - Fls Driver Registers
+ *
+ * @author:	Islam Ehab
+ *
+ * @date:	19/10/2026
+ ******************************************************************************/
+
+#ifndef FLS_REG_H
+#define FLS_REG_H
+
+#include "Std_Types.h"
+
+/**
+ * @struct FLASH_REG
+ *
+ * @brief  Flash Interface registers with their order from data sheet
  */
+typedef struct{
+											/*Register Name													   Offset*/
+	volatile uint32 ACR;					/* Access Control Register											0x00 */
+	volatile uint32 KEYR;					/* Key Register														0x04 */
+	volatile uint32 OPTKEYR;				/* Option Key Register												0x08 */
+	volatile uint32 SR;						/* Status Register													0x0C */
+	volatile uint32 CR;						/* Control Register													0x10 */
+	volatile uint32 OPTCR;					/* Option Control Register											0x14 */
+	volatile uint32 OPTCR1;					/* Option Control Register 1 (Bank 2)								0x18 */
+
+}FLASH_REG;
+
+/***********************************************************************************
+ *                           Flash Interface Base Address                          *
+ **********************************************************************************/
+#define FLASH_INTERFACE_BASE_ADDRESS		((FLASH_REG*) 0x40023C00)	/* Pointer to Flash Interface Registers */
+
+/* First address of the Main Memory, Bank 2 starts 1 MByte later */
+#define FLASH_MEMORY_BASE_ADDRESS			(0x08000000UL)
+#define FLASH_BANK_SIZE						(0x00100000UL)
+/**********************************************************************************/
+
+/***********************************************************************************
+ *                              Flash Registers Bits                               *
+ **********************************************************************************/
+/* FLASH_ACR */
+#define FLASH_ACR_DCEN_MASK					(0x00000400UL)	/* Data Cache Enable		  */
+#define FLASH_ACR_DCRST_MASK				(0x00001000UL)	/* Data Cache Reset			  */
+
+/* FLASH_KEYR unlock sequence */
+#define FLASH_KEY1							(0x45670123UL)
+#define FLASH_KEY2							(0xCDEF89ABUL)
+
+/* FLASH_SR */
+#define FLASH_SR_EOP_MASK					(0x00000001UL)	/* End of Operation			  */
+#define FLASH_SR_OPERR_MASK					(0x00000002UL)	/* Operation Error			  */
+#define FLASH_SR_WRPERR_MASK				(0x00000010UL)	/* Write Protection Error	  */
+#define FLASH_SR_PGAERR_MASK				(0x00000020UL)	/* Programming Alignment Error */
+#define FLASH_SR_PGPERR_MASK				(0x00000040UL)	/* Programming Parallelism Error */
+#define FLASH_SR_PGSERR_MASK				(0x00000080UL)	/* Programming Sequence Error */
+#define FLASH_SR_RDERR_MASK					(0x00000100UL)	/* Read Protection Error	  */
+#define FLASH_SR_BSY_MASK					(0x00010000UL)	/* Operation in progress	  */
 
-#ifndef FLS_FLS_REG_H_
-#define FLS_FLS_REG_H_
+#define FLASH_SR_ERRORS_MASK				(FLASH_SR_OPERR_MASK | FLASH_SR_WRPERR_MASK | FLASH_SR_PGAERR_MASK |\
+											 FLASH_SR_PGPERR_MASK | FLASH_SR_PGSERR_MASK | FLASH_SR_RDERR_MASK)
 
+/* FLASH_CR */
+#define FLASH_CR_PG_MASK					(0x00000001UL)	/* Programming				  */
+#define FLASH_CR_SER_MASK					(0x00000002UL)	/* Sector Erase				  */
+#define FLASH_CR_SNB_MASK					(0x000000F8UL)	/* Sector Number			  */
+#define FLASH_CR_SNB_SHIFT					(3U)
+#define FLASH_CR_PSIZE_MASK					(0x00000300UL)	/* Program Size				  */
+#define FLASH_CR_PSIZE_SHIFT				(8U)
+#define FLASH_CR_STRT_MASK					(0x00010000UL)	/* Start Erase				  */
+#define FLASH_CR_LOCK_MASK					(0x80000000UL)	/* Lock						  */
 
+/* FLASH_CR SNB value of Bank 2 sectors (12..23) is the sector number + 4 */
+#define FLASH_SNB_BANK2_OFFSET				(4U)
+/**********************************************************************************/
 
-#endif /* FLS_FLS_REG_H_ */
+#endif /* FLS_REG_H */
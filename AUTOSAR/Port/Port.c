@@ -45,6 +45,11 @@
 
 #endif
 
+/* Check if Trace Points are enabled or not through configuration tool */
+#if(PORT_TRACE_ENABLE == STD_ON)
+#include "TRACE_Init.h"
+#endif
+
 /**************************************************************************
  * 					Static Global Functions Prototype				 	  *
 ***************************************************************************/
@@ -385,6 +390,10 @@ void Port_Init(const Port_ConfigType* ConfigPtr)
 		 * because all the pins are initialized now
 		 */
 		Port_Status = PORT_INITIALIZED;
+
+#if(PORT_TRACE_ENABLE == STD_ON)
+		TRACE1("Port: init %u channels", PORT_CONFIGURED_CHANNLES);
+#endif
 	}
 
 }
@@ -439,6 +448,10 @@ void Port_SetPinDirection(Port_PinType Pin, Port_PinDirectionType Direction)
 	/* Variable used to save the index of the array element needed  */
 	uint8 Id = 0;
 
+#if(PORT_TRACE_ENABLE == STD_ON)
+	TRACE2("Port: pin %u direction %u", Pin, Direction);
+#endif
+
 	/* Check if DET Error is enabled or not through configuration tool */
 #if(PORT_DEV_ERROR_DETECT == STD_ON)
 
@@ -833,6 +846,10 @@ void Port_SetPinMode(Port_PinType Pin, Port_PinModeType Mode)
 	 */
 	uint8 Id = 60;
 
+#if(PORT_TRACE_ENABLE == STD_ON)
+	TRACE2("Port: pin %u mode %u", Pin, Mode);
+#endif
+
 	/* Check if DET Error is enabled or not through configuration tool */
 #if(PORT_DEV_ERROR_DETECT == STD_ON)
 
@@ -57,6 +57,9 @@
 /* Pre-compile Option for Port_GetVersionInfo API 	*/
 #define PORT_VERSION_INFO_API                   (STD_ON)
 
+/* Pre-compile Option for Trace Points (Drivers/TRACE) */
+#define PORT_TRACE_ENABLE                       (STD_OFF)
+
 /* Number of the configured Dio Channels 			*/
 #define PORT_CONFIGURED_CHANNLES                (39U)
 
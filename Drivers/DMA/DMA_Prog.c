@@ -4,10 +4,12 @@
  *  Created on: Mar 18, 2020
  *      Author: Islam Ehab
  */
-#include "STD_TYPES.h"
+#include "STD_TYPES_OLD.h"
 
 #include "DMA_Reg.h"
 #include "DMA_Init.h"
+#include "MEM_SECTIONS.h"
+#include "RCC_Init.h"
 
 
 
@@ -242,3 +244,288 @@ void vidDMA_Transfer(DMA_Stream* DMA_SNUM, u32 u32Source, u32 u32Destination, u3
 	//Enable DMA
 	DMA_SNUM -> CR   |= EN;
 }
+
+/*
+ * Memory to Memory Service State
+ * Transfers bigger than 65535 items are split into chunks,
+ * every Transfer Complete interrupt starts the next chunk
+ */
+typedef struct{
+	volatile u8 		Busy;
+	u8					SrcInc;			//0 in memset (Source is the Pattern Word)
+	u8					Width;			//Item Size in bytes (1, 2 or 4)
+	u32					Dest;
+	u32					Src;
+	volatile u32 		Remaining;		//Remaining Items
+	DMA_MemCallback 	pfCallback;
+}DMA_MemState;
+
+//Memory Transfer in progress, one at a time
+CCM_BSS static DMA_MemState DMA_Mem;
+
+//Pattern Word used as DMA Source in memset
+static volatile u32 u32MemPattern;
+
+static u8 u8DMA_MemInCCM(u32 u32Address, u32 u32Size)
+{
+	return (u8)((u32Address < DMA_CCMRAM_END) && ((u32Address + u32Size) > DMA_CCMRAM_START));
+}
+
+static void vidDMA_MemStartChunk(void)
+{
+	u32 u32Items = DMA_Mem.Remaining;
+
+	if(u32Items > DMA_MEM_MAX_ITEMS)
+	{
+		u32Items = DMA_MEM_MAX_ITEMS;
+	}
+
+	//Clear All Stream0 Flags Before Enabling it again
+	DMA_MEM_DMA -> LIFCR = ((CTCIF | CHTIF | CTEIF | CDMEIF | CFEIF) << DMA_MEM_STREAM_NUM);
+
+	//In Memory to Memory PAR is the Source & M0AR is the Destination
+	DMA_MEM_STREAM -> PAR  = DMA_Mem.Src;
+	DMA_MEM_STREAM -> M0AR = DMA_Mem.Dest;
+	DMA_MEM_STREAM -> NDTR = u32Items;
+
+	//Move Pointers to the next chunk before starting this one
+	DMA_Mem.Dest 	  += u32Items * DMA_Mem.Width;
+	DMA_Mem.Src  	  += (DMA_Mem.SrcInc != 0) ? (u32Items * DMA_Mem.Width) : 0;
+	DMA_Mem.Remaining -= u32Items;
+
+	DMA_MEM_STREAM -> CR |= EN;
+}
+
+static void vidDMA_MemStart(u32 u32Dest, u32 u32Src, u32 u32Size, u8 u8SrcInc, DMA_MemCallback pfCallback)
+{
+	u32 u32CR  = 0;
+	u32 u32FCR = 0;
+
+	//Choose widest item size the addresses & size allow
+	if(((u32Dest | (u8SrcInc ? u32Src : 0) | u32Size) & 0x3) == 0)
+	{
+		DMA_Mem.Width = 4;
+		u32CR  = (u32)(P_WORD | M_WORD);
+		u32FCR = (u32)FULL;
+	}
+	else if(((u32Dest | (u8SrcInc ? u32Src : 0) | u32Size) & 0x1) == 0)
+	{
+		DMA_Mem.Width = 2;
+		u32CR  = (u32)(P_HWORD | M_HWORD);
+		u32FCR = (u32)HALF;
+	}
+	else
+	{
+		DMA_Mem.Width = 1;
+		u32CR  = (u32)(P_BYTE | M_BYTE);
+		u32FCR = (u32)QUARTER;
+	}
+
+	/*
+	 * 4 beats Bursts fill the FIFO threshold exactly,
+	 * A Burst must not cross 1KB boundary so use it only on 16 bytes aligned addresses,
+	 * NDTR must be a multiple of the burst so the item count too
+	 * (DMA_MEM_MAX_ITEMS keeps every chunk a multiple of 4)
+	 */
+	if((((u32Dest | (u8SrcInc ? u32Src : 0)) & 0xF) == 0)
+		&& (((u32Size / DMA_Mem.Width) & 0x3) == 0))
+	{
+		u32CR |= (u32)(P_INCR4 | M_INCR4);
+	}
+
+	DMA_Mem.Busy	   = 1;
+	DMA_Mem.SrcInc	   = u8SrcInc;
+	DMA_Mem.Dest	   = u32Dest;
+	DMA_Mem.Src 	   = u32Src;
+	DMA_Mem.Remaining  = u32Size / DMA_Mem.Width;
+	DMA_Mem.pfCallback = pfCallback;
+
+	//Service owns DMA2, don't rely on the application enabling its clock
+	xRCC_EnableClock(RCC_DMA2);
+
+	//Make Sure that DMA is Disabled
+	DMA_MEM_STREAM -> CR &= ~EN;
+	while(EN == (EN & DMA_MEM_STREAM -> CR));
+
+	//Memory to Memory Needs FIFO (Direct Mode isn't allowed)
+	DMA_MEM_STREAM -> FCR = ((u32)Direct_Mode_Disabled | u32FCR);
+
+	u32CR |= (u32)(Memory_To_Memory | MINC | P_HIGH | TCIE | TEIE);
+	u32CR |= (u8SrcInc != 0) ? PINC : 0;
+	DMA_MEM_STREAM -> CR = u32CR;
+
+	//Enable DMA2 Stream0 Interrupt on NVIC
+	DMA_NVIC_ISER1 = (1UL << (DMA_MEM_IRQ_NUM - 32));
+
+	vidDMA_MemStartChunk();
+}
+
+static void vidDMA_MemCPUCopy(u8* pu8Dest, const u8* pu8Src, u32 u32Size)
+{
+	//Copy Words when both addresses are aligned
+	if((((u32)pu8Dest | (u32)pu8Src) & 0x3) == 0)
+	{
+		while(u32Size >= 4)
+		{
+			*(u32*)pu8Dest = *(const u32*)pu8Src;
+			pu8Dest += 4;
+			pu8Src  += 4;
+			u32Size -= 4;
+		}
+	}
+
+	while(u32Size > 0)
+	{
+		*pu8Dest++ = *pu8Src++;
+		u32Size--;
+	}
+}
+
+static void vidDMA_MemCPUSet(u8* pu8Dest, u32 u32Pattern, u32 u32Size)
+{
+	//Fill till Destination is aligned then fill words
+	while((((u32)pu8Dest & 0x3) != 0) && (u32Size > 0))
+	{
+		*pu8Dest++ = (u8)u32Pattern;
+		u32Size--;
+	}
+
+	while(u32Size >= 4)
+	{
+		*(u32*)pu8Dest = u32Pattern;
+		pu8Dest += 4;
+		u32Size -= 4;
+	}
+
+	while(u32Size > 0)
+	{
+		*pu8Dest++ = (u8)u32Pattern;
+		u32Size--;
+	}
+}
+
+/*
+ * Asynchronous memcpy
+ * Returns NOK if a previous DMA transfer is still running
+ * Small transfers & CCM RAM buffers are done by CPU, callback is called before return
+ * Buffers must stay valid till callback is called (or u8DMA_MemBusy returns 0)
+ */
+Return_status xDMA_MemCopy(void* pDest, const void* pSrc, u32 u32Size, DMA_MemCallback pfCallback)
+{
+	if((0 == pDest) || (0 == pSrc))
+	{
+		return NULLPOINTER;
+	}
+
+	if(DMA_Mem.Busy != 0)
+	{
+		return NOK;
+	}
+
+	if((u32Size < DMA_MEM_CPU_THRESHOLD)
+		|| u8DMA_MemInCCM((u32)pDest, u32Size)
+		|| u8DMA_MemInCCM((u32)pSrc, u32Size))
+	{
+		vidDMA_MemCPUCopy((u8*)pDest, (const u8*)pSrc, u32Size);
+
+		if(0 != pfCallback)
+		{
+			pfCallback(OK);
+		}
+	}
+	else
+	{
+		vidDMA_MemStart((u32)pDest, (u32)pSrc, u32Size, 1, pfCallback);
+	}
+
+	return OK;
+}
+
+/*
+ * Asynchronous memset
+ * Same rules as xDMA_MemCopy
+ */
+Return_status xDMA_MemSet(void* pDest, u8 u8Value, u32 u32Size, DMA_MemCallback pfCallback)
+{
+	if(0 == pDest)
+	{
+		return NULLPOINTER;
+	}
+
+	if(DMA_Mem.Busy != 0)
+	{
+		return NOK;
+	}
+
+	//Replicate the byte on the whole word
+	u32MemPattern = (u32)u8Value * 0x01010101UL;
+
+	if((u32Size < DMA_MEM_CPU_THRESHOLD) || u8DMA_MemInCCM((u32)pDest, u32Size))
+	{
+		vidDMA_MemCPUSet((u8*)pDest, u32MemPattern, u32Size);
+
+		if(0 != pfCallback)
+		{
+			pfCallback(OK);
+		}
+	}
+	else
+	{
+		vidDMA_MemStart((u32)pDest, (u32)&u32MemPattern, u32Size, 0, pfCallback);
+	}
+
+	return OK;
+}
+
+u8 u8DMA_MemBusy(void)
+{
+	return DMA_Mem.Busy;
+}
+
+void vidDMA_MemWait(void)
+{
+	while(DMA_Mem.Busy != 0);
+}
+
+RAM_FUNC void DMA2_Stream0_IRQHandler(void)
+{
+	u32 u32Flags = (DMA_MEM_DMA -> LISR) >> DMA_MEM_STREAM_NUM;
+	DMA_MemCallback pfCallback = DMA_Mem.pfCallback;
+
+	if((u32Flags & TEIF) != 0)
+	{
+		//Transfer Error, Stop the stream & report it
+		DMA_MEM_STREAM -> CR &= ~EN;
+		DMA_MEM_DMA -> LIFCR = ((CTCIF | CHTIF | CTEIF | CDMEIF | CFEIF) << DMA_MEM_STREAM_NUM);
+		DMA_Mem.Busy = 0;
+
+		if(0 != pfCallback)
+		{
+			pfCallback(NOK);
+		}
+	}
+	else if((u32Flags & TCIF) != 0)
+	{
+		DMA_MEM_DMA -> LIFCR = ((CTCIF | CHTIF) << DMA_MEM_STREAM_NUM);
+
+		if(DMA_Mem.Remaining != 0)
+		{
+			//Chain next chunk
+			vidDMA_MemStartChunk();
+		}
+		else
+		{
+			DMA_Mem.Busy = 0;
+
+			if(0 != pfCallback)
+			{
+				pfCallback(OK);
+			}
+		}
+	}
+	else
+	{
+		//FIFO Error only, Transfer continues
+		DMA_MEM_DMA -> LIFCR = ((CFEIF | CDMEIF) << DMA_MEM_STREAM_NUM);
+	}
+}
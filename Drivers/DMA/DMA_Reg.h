@@ -14,21 +14,21 @@
 
 typedef struct{
 
-	u32 LISR;		//Low Interrupt Status Register 		(RO)
-	u32 HISR;		//High Interrupt Status Register 		(RO)
-	u32 LIFCR;		//Low Interrupt Flag Clear Register 	(W)
-	u32 HIFCR;		//High Interrupt Flag Clear Register 	(W)
+	volatile u32 LISR;		//Low Interrupt Status Register 		(RO)
+	volatile u32 HISR;		//High Interrupt Status Register 		(RO)
+	volatile u32 LIFCR;		//Low Interrupt Flag Clear Register 	(W)
+	volatile u32 HIFCR;		//High Interrupt Flag Clear Register 	(W)
 }DMA_Main;
 
 
 typedef struct{
 
-	u32 CR;			//Stream x Configurartion Register 		(RW)
-	u32 NDTR;		//Stream x Number of Data Register 		(RW)
-	u32 PAR;		//Stream x Peripheral Address Register	(RW)
-	u32 M0AR;		//Stream x Memory 0 Address Register	(RW)
-	u32 M1AR;		//Stream x Memory 1 Address Register	(RW)
-	u32 FCR;		//Stream x FIFO Control Register		(RW)
+	volatile u32 CR;			//Stream x Configurartion Register 		(RW)
+	volatile u32 NDTR;		//Stream x Number of Data Register 		(RW)
+	volatile u32 PAR;		//Stream x Peripheral Address Register	(RW)
+	volatile u32 M0AR;		//Stream x Memory 0 Address Register	(RW)
+	volatile u32 M1AR;		//Stream x Memory 1 Address Register	(RW)
+	volatile u32 FCR;		//Stream x FIFO Control Register		(RW)
 }DMA_Stream;
 
 
@@ -53,6 +53,11 @@ typedef struct{
 #define DMA2_STREAM6	((DMA_Stream*) 0x400264A0)
 #define DMA2_STREAM7	((DMA_Stream*) 0x400264B8)
 
+//NVIC Interrupt Set Enable Registers (Used to enable DMA Streams IRQs)
+#define DMA_NVIC_ISER0	*((volatile u32*) 0xE000E100)
+#define DMA_NVIC_ISER1	*((volatile u32*) 0xE000E104)
+#define DMA_NVIC_ISER2	*((volatile u32*) 0xE000E108)
+
 
 
 #endif /* DMA_REG_H_ */
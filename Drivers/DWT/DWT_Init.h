@@ -0,0 +1,28 @@
+/*
+ * DWT_Init.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ */
+
+#ifndef DWT_INIT_H_
+#define DWT_INIT_H_
+
+#include "DWT_Reg.h"
+
+//Number of Timestamps kept by vidDWT_Mark
+#define DWT_MAX_MARKS		(8U)
+
+void vidDWT_Init(void);
+
+//Inline so Trace Points & Latency Counters pay one Load, not a Call
+static inline u32 u32DWT_GetCycles(void)
+{
+	return DWT_CYCCNT;
+}
+
+//Save time since vidDWT_Init (in us) for Mark u8Mark
+void vidDWT_Mark(u8 u8Mark);
+u32  u32DWT_GetMark(u8 u8Mark);
+
+#endif /* DWT_INIT_H_ */
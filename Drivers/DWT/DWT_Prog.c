@@ -0,0 +1,86 @@
+/*
+ * DWT_Prog.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ */
+
+#include "STD_TYPES_OLD.h"
+
+#include "DWT_Init.h"
+#include "DWT_Reg.h"
+
+//Include RCC Files to convert Cycles to us with the current HCLK
+#include "RCC_Init.h"
+
+//Time of every Mark in us since vidDWT_Init
+static u32 DWT_Marks[DWT_MAX_MARKS];
+
+//Cycle Count, HCLK and elapsed us at the last Mark or HCLK change. Cycles are
+//converted up to every HCLK change (boot switches HSI -> PLL) with the clock
+//that counted them
+static u32 DWT_LastCycles;
+static u32 DWT_LastClockMHz;
+static u32 DWT_ElapsedUs;
+
+//Convert the Cycles counted since the last update with the clock that counted them
+static void vidDWT_Accumulate(u32 u32ClockMHz)
+{
+	u32 u32Cycles = DWT_CYCCNT;
+
+	if(DWT_LastClockMHz != 0)
+	{
+		DWT_ElapsedUs += (u32Cycles - DWT_LastCycles) / DWT_LastClockMHz;
+		//Keep the Cycles of the partial us for the next update
+		u32Cycles -= (u32Cycles - DWT_LastCycles) % DWT_LastClockMHz;
+	}
+
+	DWT_LastCycles   = u32Cycles;
+	DWT_LastClockMHz = u32ClockMHz;
+}
+
+//RCC Subscriber, called right after the SYSCLK switch
+static void vidDWT_ClockChanged(const RCC_clockValues* OldClocks, const RCC_clockValues* NewClocks)
+{
+	(void)OldClocks;
+
+	vidDWT_Accumulate(NewClocks -> HCLKFrequency / 1000000U);
+}
+
+void vidDWT_Init(void)
+{
+	u8 i;
+
+	DWT_DEMCR |= DWT_DEMCR_TRCENA;
+	DWT_LAR    = DWT_LAR_UNLOCK;
+	DWT_CYCCNT = 0;
+	DWT_CTRL  |= DWT_CTRL_CYCCNTENA;
+
+	for(i = 0; i < DWT_MAX_MARKS; i++)
+	{
+		DWT_Marks[i] = 0;
+	}
+
+	DWT_LastCycles   = 0;
+	DWT_LastClockMHz = u32RCC_getHCLK() / 1000000U;
+	DWT_ElapsedUs    = 0;
+
+	xRCC_subscribe(vidDWT_ClockChanged);
+}
+
+void vidDWT_Mark(u8 u8Mark)
+{
+	if(u8Mark >= DWT_MAX_MARKS)
+	{
+		return;
+	}
+
+	vidDWT_Accumulate(DWT_LastClockMHz);
+
+	DWT_Marks[u8Mark] = DWT_ElapsedUs;
+}
+
+u32 u32DWT_GetMark(u8 u8Mark)
+{
+	return (u8Mark < DWT_MAX_MARKS) ? DWT_Marks[u8Mark] : 0;
+}
@@ -0,0 +1,19 @@
+/*
+ * DWT_Reg.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ */
+
+#ifndef DWT_REG_H_
+#define DWT_REG_H_
+
+#define DWT_DEMCR		*((volatile u32*) 0xE000EDFC)		//Debug Exception & Monitor Control Register
+#define DWT_CTRL		*((volatile u32*) 0xE0001000)		//Control Register
+#define DWT_CYCCNT		*((volatile u32*) 0xE0001004)		//Cycle Count Register
+#define DWT_LAR			*((volatile u32*) 0xE0001FB0)		//Lock Access Register
+
+#define DWT_DEMCR_TRCENA	(0x01000000U)					//Enable DWT & ITM
+#define DWT_CTRL_CYCCNTENA	(0x00000001U)					//Enable Cycle Counter
+#define DWT_LAR_UNLOCK		(0xC5ACCE55U)
+#endif /* DWT_REG_H_ */
@@ -0,0 +1,33 @@
+/*
+ * EXTI_Init.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ *
+ *  GPIO External Interrupts, the Callback runs in ISR context and is meant
+ *  to post a Scheduler Event (xSCHED_PostEvent), not to do the work itself.
+ *  Lines 2 & 10..15 aren't handled here, their IRQ Handlers belong to the
+ *  Discovery Utilities (L3GD20 INT2 on EXTI2, IO Expander on EXTI15_10).
+ */
+
+#ifndef EXTI_INIT_H_
+#define EXTI_INIT_H_
+
+typedef enum{
+	EXTI_PORTA, EXTI_PORTB, EXTI_PORTC, EXTI_PORTD, EXTI_PORTE, EXTI_PORTF,
+	EXTI_PORTG, EXTI_PORTH, EXTI_PORTI, EXTI_PORTJ, EXTI_PORTK
+}EXTI_Port;
+
+typedef enum{
+	EXTI_RISING		= 1,
+	EXTI_FALLING	= 2,
+	EXTI_BOTH		= 3
+}EXTI_Edge;
+
+//Called from EXTI ISR context with the Line that fired
+typedef void (*EXTI_Callback)(u8 u8Line);
+
+Return_status xEXTI_Enable(u8 u8Line, EXTI_Port Port, EXTI_Edge Edge, EXTI_Callback pfCallback);
+void vidEXTI_Disable(u8 u8Line);
+
+#endif /* EXTI_INIT_H_ */
@@ -0,0 +1,119 @@
+/*
+ * EXTI_Prog.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ */
+
+#include "STD_TYPES_OLD.h"
+#include "MEM_SECTIONS.h"
+
+#include "EXTI_Reg.h"
+#include "EXTI_Init.h"
+
+//Include RCC Files to enable SYSCFG Clock
+#include "RCC_Init.h"
+
+//Lines 0..9 (Bit set if the Line is handled by this driver)
+#define EXTI_LINES_NUM		(10U)
+#define EXTI_OWNED_LINES	(0x03FBU)
+
+static EXTI_Callback EXTI_Callbacks[EXTI_LINES_NUM];
+
+//NVIC Position of every Line (Lines 5..9 share EXTI9_5)
+static const u8 EXTI_IRQNum[EXTI_LINES_NUM] = {6, 7, 8, 9, 10, 23, 23, 23, 23, 23};
+
+Return_status xEXTI_Enable(u8 u8Line, EXTI_Port Port, EXTI_Edge Edge, EXTI_Callback pfCallback)
+{
+	u8 u8Shift;
+
+	if(pfCallback == 0)
+	{
+		return NULLPOINTER;
+	}
+
+	if((u8Line >= EXTI_LINES_NUM) || ((EXTI_OWNED_LINES & (1U << u8Line)) == 0) || (Port > EXTI_PORTK))
+	{
+		return OUTOFRANGE;
+	}
+
+	xRCC_EnableClock(RCC_SYSCFG);
+
+	EXTI -> IMR &= ~(1UL << u8Line);
+
+	//Route the Port Pin to the Line
+	u8Shift = (u8)((u8Line & 0x3U) * 4U);
+	SYSCFG_EXTICR[u8Line >> 2] = (SYSCFG_EXTICR[u8Line >> 2] & ~(0xFUL << u8Shift)) | ((u32)Port << u8Shift);
+
+	if((Edge & EXTI_RISING) != 0)	{ EXTI -> RTSR |= (1UL << u8Line); }
+	else							{ EXTI -> RTSR &= ~(1UL << u8Line); }
+
+	if((Edge & EXTI_FALLING) != 0)	{ EXTI -> FTSR |= (1UL << u8Line); }
+	else							{ EXTI -> FTSR &= ~(1UL << u8Line); }
+
+	EXTI_Callbacks[u8Line] = pfCallback;
+
+	EXTI -> PR   = (1UL << u8Line);
+	EXTI -> IMR |= (1UL << u8Line);
+
+	EXTI_NVIC_ISER[EXTI_IRQNum[u8Line] >> 5] = (1UL << (EXTI_IRQNum[u8Line] & 0x1F));
+
+	return OK;
+}
+
+void vidEXTI_Disable(u8 u8Line)
+{
+	if((u8Line >= EXTI_LINES_NUM) || ((EXTI_OWNED_LINES & (1U << u8Line)) == 0))
+	{
+		return;
+	}
+
+	EXTI -> IMR &= ~(1UL << u8Line);
+	EXTI -> PR   = (1UL << u8Line);
+	EXTI_Callbacks[u8Line] = 0;
+}
+
+//Clear & dispatch every pending Line of lines u8First..u8Last
+RAM_FUNC static void vidEXTI_IRQHandler(u8 u8First, u8 u8Last)
+{
+	u32 u32Pending = EXTI -> PR & EXTI -> IMR;
+	u8 u8Line;
+
+	for(u8Line = u8First; u8Line <= u8Last; u8Line++)
+	{
+		if((u32Pending & (1UL << u8Line)) != 0)
+		{
+			EXTI -> PR = (1UL << u8Line);
+
+			if(EXTI_Callbacks[u8Line] != 0)
+			{
+				EXTI_Callbacks[u8Line](u8Line);
+			}
+		}
+	}
+}
+
+RAM_FUNC void EXTI0_IRQHandler(void)
+{
+	vidEXTI_IRQHandler(0, 0);
+}
+
+RAM_FUNC void EXTI1_IRQHandler(void)
+{
+	vidEXTI_IRQHandler(1, 1);
+}
+
+RAM_FUNC void EXTI3_IRQHandler(void)
+{
+	vidEXTI_IRQHandler(3, 3);
+}
+
+RAM_FUNC void EXTI4_IRQHandler(void)
+{
+	vidEXTI_IRQHandler(4, 4);
+}
+
+RAM_FUNC void EXTI9_5_IRQHandler(void)
+{
+	vidEXTI_IRQHandler(5, 9);
+}
@@ -0,0 +1,27 @@
+/*
+ * EXTI_Reg.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ */
+
+#ifndef EXTI_REG_H_
+#define EXTI_REG_H_
+
+typedef struct{
+	volatile u32 IMR;				//Interrupt Mask Register									0x00
+	volatile u32 EMR;				//Event Mask Register										0x04
+	volatile u32 RTSR;				//Rising Trigger Selection Register							0x08
+	volatile u32 FTSR;				//Falling Trigger Selection Register						0x0C
+	volatile u32 SWIER;				//Software Interrupt Event Register							0x10
+	volatile u32 PR;				//Pending Register (Write 1 to Clear)						0x14
+}EXTI_REG;
+
+#define EXTI				((EXTI_REG*) 0x40013C00)
+
+//SYSCFG External Interrupt Configuration Registers (4 Lines per Register, 4 bits per Line)
+#define SYSCFG_EXTICR		((volatile u32*) 0x40013808)
+
+#define EXTI_NVIC_ISER		((volatile u32*) 0xE000E100)
+
+#endif /* EXTI_REG_H_ */
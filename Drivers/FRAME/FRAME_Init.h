@@ -0,0 +1,70 @@
+/*
+ * FRAME_Init.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ *
+ *  Framing layer for binary telemetry/command link over USART
+ *  Frame on wire = COBS( Payload | CRC16 (MSB first) ) | 0x00
+ *  - COBS removes all zeros from the frame so 0x00 is only the delimiter
+ *  - CRC16 is CCITT-FALSE (Poly 0x1021, Init 0xFFFF), table driven
+ *    (HW CRC unit of STM32F4 is CRC32 on words only so it doesn't fit byte streams)
+ */
+
+#ifndef FRAME_INIT_H_
+#define FRAME_INIT_H_
+
+#include "STD_TYPES_OLD.h"
+#include "USART_Reg.h"
+#include "DMA_Reg.h"
+#include "DMA_Init.h"
+#include "USART_Init.h"
+
+#define FRAME_DELIMITER			(0x00U)
+#define FRAME_CRC_SIZE			(2U)
+#define FRAME_CRC_INIT			(0xFFFFU)
+
+/*
+ * Max encoded size of a Payload of n bytes
+ * (1 overhead byte every 254 bytes + code byte + CRC + delimiter)
+ */
+#define FRAME_ENCODED_SIZE(n)	((n) + FRAME_CRC_SIZE + (((n) + FRAME_CRC_SIZE) / 254U) + 2U)
+
+//Called when a Frame with a valid CRC is decoded (Payload without CRC)
+typedef void (*FRAME_Callback)(const u8* pPayload, u16 u16Size);
+
+//Incremental COBS Encoder State
+typedef struct{
+	u8*		pOut;
+	u16		OutSize;
+	u16		OutLen;			//Bytes written till now
+	u16		CodeIndex;		//Position of the current block code byte
+	u8		Code;			//Current block code (1 + non zero bytes in block)
+	u8		Error;			//1 if Output buffer overflowed
+	u16		Crc;
+}FRAME_Encoder;
+
+//Incremental COBS Decoder State (O(1) per byte)
+typedef struct{
+	u8*		pFrame;			//Decoded Payload + CRC
+	u16		Size;
+	u16		Len;
+	u8		Code;			//Code of current block
+	u8		Remaining;		//Data bytes left in current block
+	u8		Error;			//1 if frame is dropped (Overflow), cleared by delimiter
+	u32		Frames;			//Valid Frames
+	u32		CrcErrors;
+	u32		Dropped;		//Overflowed or malformed frames
+}FRAME_Decoder;
+
+u16 u16FRAME_Crc16(u16 u16Crc, const u8* pData, u32 u32Size);
+
+void vidFRAME_EncodeStart(FRAME_Encoder* Encoder, u8* pOut, u16 u16OutSize);
+Return_status xFRAME_EncodeAppend(FRAME_Encoder* Encoder, const u8* pData, u16 u16Size);
+u16 u16FRAME_EncodeFinish(FRAME_Encoder* Encoder);
+
+void vidFRAME_DecoderInit(FRAME_Decoder* Decoder, u8* pFrame, u16 u16Size);
+void vidFRAME_Decode(FRAME_Decoder* Decoder, const u8* pData, u16 u16Size, FRAME_Callback pfCallback);
+void vidFRAME_PollUSART(FRAME_Decoder* Decoder, USART_REG* USARTx, FRAME_Callback pfCallback);
+
+#endif /* FRAME_INIT_H_ */
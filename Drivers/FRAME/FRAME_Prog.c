@@ -0,0 +1,262 @@
+/*
+ * FRAME_Prog.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ */
+
+#include "STD_TYPES_OLD.h"
+#include "FRAME_Init.h"
+
+//CRC16 CCITT-FALSE Table (Poly 0x1021), One lookup per byte
+static const u16 FRAME_CrcTable[256] =
+{
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+	0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+	0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+	0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+	0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+	0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+	0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+	0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+	0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+	0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+	0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+	0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+	0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+	0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+	0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+	0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+	0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+	0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+	0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+	0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+	0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+	0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+	0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+	0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+	0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+	0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+	0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+	0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+	0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+	0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+	0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+	0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+
+u16 u16FRAME_Crc16(u16 u16Crc, const u8* pData, u32 u32Size)
+{
+	while(u32Size > 0)
+	{
+		u16Crc = (u16)((u16Crc << 8) ^ FRAME_CrcTable[((u16Crc >> 8) ^ *pData++) & 0xFF]);
+		u32Size--;
+	}
+
+	return u16Crc;
+}
+
+static void vidFRAME_EncodeByte(FRAME_Encoder* Encoder, u8 u8Byte)
+{
+	if(Encoder -> Error != 0)
+	{
+		return;
+	}
+
+	if(u8Byte != 0)
+	{
+		if(Encoder -> OutLen >= Encoder -> OutSize)
+		{
+			Encoder -> Error = 1;
+			return;
+		}
+
+		Encoder -> pOut[Encoder -> OutLen++] = u8Byte;
+		Encoder -> Code++;
+	}
+
+	//Zero byte or full block (254 data bytes) closes the current block
+	if((0 == u8Byte) || (0xFF == Encoder -> Code))
+	{
+		if(Encoder -> OutLen >= Encoder -> OutSize)
+		{
+			Encoder -> Error = 1;
+			return;
+		}
+
+		Encoder -> pOut[Encoder -> CodeIndex] = Encoder -> Code;
+		Encoder -> CodeIndex = Encoder -> OutLen++;
+		Encoder -> Code = 1;
+	}
+}
+
+//Start new Frame, pOut should be at least FRAME_ENCODED_SIZE(Payload Size)
+void vidFRAME_EncodeStart(FRAME_Encoder* Encoder, u8* pOut, u16 u16OutSize)
+{
+	Encoder -> pOut		 = pOut;
+	Encoder -> OutSize	 = u16OutSize;
+	Encoder -> OutLen	 = 1;				//Reserve first code byte
+	Encoder -> CodeIndex = 0;
+	Encoder -> Code		 = 1;
+	Encoder -> Crc		 = FRAME_CRC_INIT;
+	Encoder -> Error	 = ((0 == pOut) || (0 == u16OutSize)) ? 1 : 0;
+}
+
+//Encode part of the Payload (Can be called many times per Frame)
+Return_status xFRAME_EncodeAppend(FRAME_Encoder* Encoder, const u8* pData, u16 u16Size)
+{
+	u16 i = 0;
+
+	if(0 == pData)
+	{
+		return NULLPOINTER;
+	}
+
+	Encoder -> Crc = u16FRAME_Crc16(Encoder -> Crc, pData, u16Size);
+
+	for(i = 0; i < u16Size; i++)
+	{
+		vidFRAME_EncodeByte(Encoder, pData[i]);
+	}
+
+	return (Encoder -> Error != 0) ? OUTOFRANGE : OK;
+}
+
+//Append CRC & Delimiter, Returns Frame length on wire (0 if buffer overflowed)
+u16 u16FRAME_EncodeFinish(FRAME_Encoder* Encoder)
+{
+	u16 u16Crc = Encoder -> Crc;
+
+	vidFRAME_EncodeByte(Encoder, (u8)(u16Crc >> 8));
+	vidFRAME_EncodeByte(Encoder, (u8)(u16Crc & 0xFF));
+
+	if((Encoder -> Error != 0) || (Encoder -> OutLen >= Encoder -> OutSize))
+	{
+		return 0;
+	}
+
+	Encoder -> pOut[Encoder -> CodeIndex] = Encoder -> Code;
+	Encoder -> pOut[Encoder -> OutLen++]  = FRAME_DELIMITER;
+
+	return Encoder -> OutLen;
+}
+
+static void vidFRAME_DecoderReset(FRAME_Decoder* Decoder)
+{
+	Decoder -> Len		 = 0;
+	Decoder -> Code		 = 0xFF;		//No zero before first block
+	Decoder -> Remaining = 0;
+	Decoder -> Error	 = 0;
+}
+
+void vidFRAME_DecoderInit(FRAME_Decoder* Decoder, u8* pFrame, u16 u16Size)
+{
+	Decoder -> pFrame	 = pFrame;
+	Decoder -> Size		 = u16Size;
+	Decoder -> Frames	 = 0;
+	Decoder -> CrcErrors = 0;
+	Decoder -> Dropped	 = 0;
+
+	vidFRAME_DecoderReset(Decoder);
+}
+
+static void vidFRAME_EndOfFrame(FRAME_Decoder* Decoder, FRAME_Callback pfCallback)
+{
+	if((Decoder -> Error != 0) || (Decoder -> Remaining != 0))
+	{
+		Decoder -> Dropped++;
+	}
+	else if(Decoder -> Len < FRAME_CRC_SIZE)
+	{
+		//Empty frames (back to back delimiters) are used to resync, ignore them
+		if(Decoder -> Len != 0)
+		{
+			Decoder -> Dropped++;
+		}
+	}
+	//CRC over Payload + its CRC (MSB first) is zero for a valid frame
+	else if(0 == u16FRAME_Crc16(FRAME_CRC_INIT, Decoder -> pFrame, Decoder -> Len))
+	{
+		Decoder -> Frames++;
+
+		if(0 != pfCallback)
+		{
+			pfCallback(Decoder -> pFrame, (u16)(Decoder -> Len - FRAME_CRC_SIZE));
+		}
+	}
+	else
+	{
+		Decoder -> CrcErrors++;
+	}
+
+	vidFRAME_DecoderReset(Decoder);
+}
+
+/*
+ * Decode received bytes, Calls pfCallback for every valid Frame
+ * Every byte costs constant work, CRC is checked once per frame
+ */
+void vidFRAME_Decode(FRAME_Decoder* Decoder, const u8* pData, u16 u16Size, FRAME_Callback pfCallback)
+{
+	u8 u8Byte = 0;
+
+	while(u16Size > 0)
+	{
+		u8Byte = *pData++;
+		u16Size--;
+
+		if(FRAME_DELIMITER == u8Byte)
+		{
+			vidFRAME_EndOfFrame(Decoder, pfCallback);
+		}
+		else if(Decoder -> Error != 0)
+		{
+			//Skip till next delimiter
+		}
+		else if(0 == Decoder -> Remaining)
+		{
+			//Code Byte, Block before it ends with a zero unless it was a full block
+			if(Decoder -> Code != 0xFF)
+			{
+				if(Decoder -> Len >= Decoder -> Size)
+				{
+					Decoder -> Error = 1;
+					continue;
+				}
+
+				Decoder -> pFrame[Decoder -> Len++] = 0;
+			}
+
+			Decoder -> Code		 = u8Byte;
+			Decoder -> Remaining = (u8)(u8Byte - 1);
+		}
+		else
+		{
+			if(Decoder -> Len >= Decoder -> Size)
+			{
+				Decoder -> Error = 1;
+				continue;
+			}
+
+			Decoder -> pFrame[Decoder -> Len++] = u8Byte;
+			Decoder -> Remaining--;
+		}
+	}
+}
+
+/*
+ * Decode Frames straight from USART DMA Rx Ring (see xUSART_StartRxRing_DMA)
+ * Ring bytes are decoded in place into the Frame buffer, no intermediate copy
+ */
+void vidFRAME_PollUSART(FRAME_Decoder* Decoder, USART_REG* USARTx, FRAME_Callback pfCallback)
+{
+	const u8* pData = 0;
+	u16 u16Count = 0;
+
+	//Twice at most: till end of ring buffer then the wrapped part
+	while((u16Count = u16USART_RxRingGet(USARTx, &pData)) != 0)
+	{
+		vidFRAME_Decode(Decoder, pData, u16Count, pfCallback);
+		vidUSART_RxRingConsume(USARTx, u16Count);
+	}
+}
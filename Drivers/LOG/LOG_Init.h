@@ -0,0 +1,37 @@
+/*
+ * LOG_Init.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ */
+
+#ifndef LOG_INIT_H_
+#define LOG_INIT_H_
+
+//Logging Counters, Cycles are DWT Cycles spent inside u16LOG_Write (Enqueue Latency)
+typedef struct{
+	u32		Writes;
+	u32		Bytes;					//Bytes accepted into the Ring
+	u32		Dropped;				//Bytes lost because the Ring was full
+	u16		HighWater;				//Highest Ring Fill Level
+	u32		MaxWriteCycles;			//Worst Case Enqueue Latency
+	u32		TotalWriteCycles;		//Divide by Bytes for Cycles per Byte
+}LOG_Stats;
+
+/*
+ * Ring Buffer is read by DMA, it must not be placed in CCM RAM
+ * One byte of the Ring is kept empty to distinguish full from empty
+ * Takes the USART Tx Idle Callback (NOK if another producer has it)
+ */
+Return_status xLOG_Init(USART_REG* USARTx, u8* pBuffer, u16 u16Size);
+
+//Never blocks, returns the number of bytes queued (the rest is dropped)
+//Safe from Thread & ISR, Interrupts are masked only to reserve & commit, not while the bytes are copied
+//Bytes written by an ISR that interrupted a Write are sent after the interrupted Write commits
+u16  u16LOG_Write(const u8* pData, u16 u16Size);
+u16  u16LOG_Pending(void);
+
+Return_status xLOG_GetStats(LOG_Stats* Stats);
+void vidLOG_ResetStats(void);
+
+#endif /* LOG_INIT_H_ */
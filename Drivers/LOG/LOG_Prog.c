@@ -0,0 +1,217 @@
+/*
+ * LOG_Prog.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ */
+
+#include "STD_TYPES_OLD.h"
+
+#include "DMA_Init.h"
+#include "USART_Init.h"
+#include "SYSTICK_Init.h"
+#include "DWT_Init.h"
+#include "LOG_Init.h"
+
+/*
+ * Ring with one Consumer:
+ * Writers (Thread or ISR through printf/_write) reserve up to Reserve & copy with Interrupts
+ * enabled, the last one to commit moves Head. DMA Complete Callback only moves Tail,
+ * so writers never wait for the USART, they copy bytes & return
+ */
+static USART_REG*		LOG_USART;
+static u8*				LOG_Buffer;
+static u16				LOG_Size;
+static volatile u16		LOG_Head;
+static volatile u16		LOG_Tail;
+
+//End of the reserved bytes & number of Writers copying into them (nested by ISRs)
+static volatile u16		LOG_Reserve;
+static volatile u8		LOG_Writers;
+
+//Bytes handed to DMA, Tail moves by this count when the transfer completes
+static volatile u16		LOG_InFlight;
+static USART_TxSegment	LOG_Segment;
+
+static LOG_Stats		LOG_Statistics;
+
+static void vidLOG_Kick(void);
+
+//Called from USART ISR Context when another DMA user of the USART is done
+static void vidLOG_TxIdle(USART_REG* USARTx)
+{
+	(void)USARTx;
+
+	vidLOG_Kick();
+}
+
+//Called from DMA ISR Context, release the sent span & start the next one
+static void vidLOG_TxDone(USART_REG* USARTx)
+{
+	u16 u16Tail = (u16)(LOG_Tail + LOG_InFlight);
+
+	(void)USARTx;
+
+	if(u16Tail >= LOG_Size)
+	{
+		u16Tail = (u16)(u16Tail - LOG_Size);
+	}
+
+	LOG_Tail	 = u16Tail;
+	LOG_InFlight = 0;
+
+	vidLOG_Kick();
+}
+
+//Start DMA on the contiguous span after Tail if it is idle, Wrapped data goes on the next Kick
+static void vidLOG_Kick(void)
+{
+	u32 u32State = u32SYSTICK_EnterCritical();
+	u16 u16Head  = LOG_Head;
+	u16 u16Tail  = LOG_Tail;
+
+	if((0 == LOG_InFlight) && (u16Head != u16Tail))
+	{
+		LOG_Segment.pData = &LOG_Buffer[u16Tail];
+		LOG_Segment.Size  = (u16Head > u16Tail) ? (u16)(u16Head - u16Tail) : (u16)(LOG_Size - u16Tail);
+		LOG_InFlight	  = LOG_Segment.Size;
+
+		//USART is busy with another DMA user, its Tx Complete (Idle Callback) or the next Write retries
+		if(xUSART_SendSegments_DMA(LOG_USART, &LOG_Segment, 1, vidLOG_TxDone) != OK)
+		{
+			LOG_InFlight = 0;
+		}
+	}
+
+	vidSYSTICK_ExitCritical(u32State);
+}
+
+Return_status xLOG_Init(USART_REG* USARTx, u8* pBuffer, u16 u16Size)
+{
+	if((0 == USARTx) || (0 == pBuffer))
+	{
+		return NULLPOINTER;
+	}
+
+	if(u16Size < 2)
+	{
+		return OUTOFRANGE;
+	}
+
+	LOG_USART	 = USARTx;
+	LOG_Buffer	 = pBuffer;
+	LOG_Size	 = u16Size;
+	LOG_Head	 = 0;
+	LOG_Tail	 = 0;
+	LOG_Reserve	 = 0;
+	LOG_Writers	 = 0;
+	LOG_InFlight = 0;
+
+	vidLOG_ResetStats();
+
+	//Retry from Tx Complete of the other DMA users of this USART
+	return xUSART_SetTxIdleCallback(USARTx, vidLOG_TxIdle);
+}
+
+u16 u16LOG_Write(const u8* pData, u16 u16Size)
+{
+	u32 u32Start = u32DWT_GetCycles();
+	u32 u32Cycles = 0;
+	u32 u32State = 0;
+	u16 u16Head  = 0;
+	u16 u16Used  = 0;
+	u16 u16Count = 0;
+	u16 u16Index = 0;
+
+	if((0 == pData) || (0 == LOG_Size))
+	{
+		return 0;
+	}
+
+	//Reserve the span after the last Reservation, a Writer interrupting this one reserves after it
+	u32State = u32SYSTICK_EnterCritical();
+	u16Head  = LOG_Reserve;
+
+	u16Used  = (u16)((u16Head >= LOG_Tail) ? (u16Head - LOG_Tail) : (LOG_Size - LOG_Tail + u16Head));
+	u16Count = ((LOG_Size - 1U - u16Used) > u16Size) ? u16Size : (u16)(LOG_Size - 1U - u16Used);
+
+	LOG_Reserve = (u16)(((u16Head + u16Count) >= LOG_Size) ? (u16Head + u16Count - LOG_Size) : (u16Head + u16Count));
+	LOG_Writers++;
+
+	LOG_Statistics.Writes++;
+	LOG_Statistics.Bytes   += u16Count;
+	LOG_Statistics.Dropped += (u32)(u16Size - u16Count);
+
+	if((u16)(u16Used + u16Count) > LOG_Statistics.HighWater)
+	{
+		LOG_Statistics.HighWater = (u16)(u16Used + u16Count);
+	}
+
+	vidSYSTICK_ExitCritical(u32State);
+
+	//Copy with Interrupts enabled, DMA stops at the published Head so it never reads the Reservation
+	for(u16Index = 0; u16Index < u16Count; u16Index++)
+	{
+		LOG_Buffer[u16Head++] = pData[u16Index];
+
+		if(u16Head >= LOG_Size)
+		{
+			u16Head = 0;
+		}
+	}
+
+	//Commit: the last Writer out publishes every Reservation, the interrupting ones ended first
+	u32State = u32SYSTICK_EnterCritical();
+
+	//Data must be in the Ring before the Consumer can see the new Head
+	__asm volatile ("" ::: "memory");
+	LOG_Writers--;
+
+	if(0 == LOG_Writers)
+	{
+		LOG_Head = LOG_Reserve;
+		vidLOG_Kick();
+	}
+
+	u32Cycles = u32DWT_GetCycles() - u32Start;
+	LOG_Statistics.TotalWriteCycles += u32Cycles;
+
+	if(u32Cycles > LOG_Statistics.MaxWriteCycles)
+	{
+		LOG_Statistics.MaxWriteCycles = u32Cycles;
+	}
+
+	vidSYSTICK_ExitCritical(u32State);
+
+	return u16Count;
+}
+
+u16 u16LOG_Pending(void)
+{
+	u16 u16Head = LOG_Head;
+	u16 u16Tail = LOG_Tail;
+
+	return (u16Head >= u16Tail) ? (u16)(u16Head - u16Tail) : (u16)(LOG_Size - u16Tail + u16Head);
+}
+
+Return_status xLOG_GetStats(LOG_Stats* Stats)
+{
+	if(0 == Stats)
+	{
+		return NULLPOINTER;
+	}
+
+	*Stats = LOG_Statistics;
+
+	return OK;
+}
+
+void vidLOG_ResetStats(void)
+{
+	LOG_Statistics.Writes			= 0;
+	LOG_Statistics.Bytes			= 0;
+	LOG_Statistics.Dropped			= 0;
+	LOG_Statistics.HighWater		= 0;
+	LOG_Statistics.MaxWriteCycles	= 0;
+	LOG_Statistics.TotalWriteCycles = 0;
+}
@@ -161,6 +161,51 @@
 #define PLLP_VALUE_6				(2U)
 #define PLLP_VALUE_8				(3U)
 
+#define RCC_MAX_SUBSCRIBERS			(8U)
+
+/* Max loop iterations while waiting a ready flag in xRCC_setPerfLevel */
+#define RCC_READY_TIMEOUT			(100000U)
+
+#define HSE_ENABLE_BIT				(16U)
+#define SYSCLK_STATUS_MASKING		(0x0C)
+#define SYSCLK_STATUS_FIRST_BIT		(2U)
+#define PWR_CLOCK_ENABLE_BIT		(28U)
+
+#define FLASH_LATENCY_MASKING		(0x0F)
+#define FLASH_PREFETCH_ENABLE		(0x100)
+#define FLASH_ICACHE_ENABLE			(0x200)
+#define FLASH_DCACHE_ENABLE			(0x400)
+
+/* Max HCLK for every wait state (VDD 2.7V -> 3.6V) */
+#define FLASH_WS_STEP_FREQUENCY		(30000000U)
+#define FLASH_MAX_LATENCY			(5U)
+
+#define PWR_VOS_MASKING				(0xC000)
+#define PWR_VOS_FIRST_BIT			(14U)
+#define PWR_VOS_SCALE3				(1U)		/* HCLK <= 120 MHz */
+#define PWR_VOS_SCALE2				(2U)		/* HCLK <= 144 MHz */
+#define PWR_VOS_SCALE1				(3U)		/* HCLK <= 168 MHz, 180 MHz with Over-drive */
+#define PWR_ODEN_BIT				(16U)
+#define PWR_ODSWEN_BIT				(17U)
+#define PWR_VOSRDY_BIT				(14U)
+#define PWR_ODRDY_BIT				(16U)
+#define PWR_ODSWRDY_BIT				(17U)
+
+/* Staged init (xRCC_initStart / u8RCC_initPoll) stages */
+#define RCC_BOOT_IDLE				(0U)
+#define RCC_BOOT_WAIT_OSC			(1U)
+#define RCC_BOOT_WAIT_PLL_OFF		(2U)
+#define RCC_BOOT_WAIT_PLL			(3U)
+#define RCC_BOOT_DONE				(4U)
+#define RCC_BOOT_FAILED				(5U)		/* SYSCLK switch timed out, SYSCLK is HSI */
+
+#define PLL_VCO_INPUT_MIN			(1000000U)
+#define PLL_VCO_INPUT_MAX			(2000000U)
+#define PLL_VCO_OUTPUT_MIN			(100000000U)
+#define PLL_VCO_OUTPUT_MAX			(432000000U)
+#define PCLK1_MAX_FREQUENCY			(45000000U)
+#define PCLK2_MAX_FREQUENCY			(90000000U)
+
 /********************************************************************************
 
  [Enumuration Name]:		RCC_AHBDivisor
@@ -201,6 +246,26 @@ typedef enum{
 }RCC_APBDivisor;
 
 
+/********************************************************************************
+
+ [Enumuration Name]:		RCC_PerfLevel
+
+ [Enumuration Description]:	Predefined clock profiles used by xRCC_setPerfLevel
+ 	 	 	 	 	 	 	- LOW:		HSI 16 MHz, no PLL
+ 	 	 	 	 	 	 	- MEDIUM:	HSE + PLL 84 MHz
+ 	 	 	 	 	 	 	- HIGH:		HSE + PLL 180 MHz with Over-drive
+
+*********************************************************************************/
+typedef enum{
+
+	RCC_PERF_LOW,
+	RCC_PERF_MEDIUM,
+	RCC_PERF_HIGH,
+	RCC_PERF_LEVELS_NUM
+
+}RCC_PerfLevel;
+
+
 /********************************************************************************
 
  [Enumuration Name]:		RCC_EnableClkPeripherals
@@ -573,15 +638,47 @@ typedef struct{
 
 }RCC_clockValues;
 
+
+/********************************************************************************
+
+ [Type Name]:				RCC_clockChangeCallback
+
+ [Type Description]:		Called after SYSCLK, HCLK, PCLK1 or PCLK2 changed
+ 	 	 	 	 	 	 	(by xRCC_init or a prescaler setter) with the old
+ 	 	 	 	 	 	 	and the new clock values
+
+*********************************************************************************/
+typedef void (*RCC_clockChangeCallback)(const RCC_clockValues * oldClocks, const RCC_clockValues * newClocks);
+
 /*********************************************************************************
 							Function Prototypes
 *********************************************************************************/
 Return_status xRCC_regInit(void);
 Return_status xRCC_init(const RCC_config * config_Ptr);
 Return_status xRCC_getClocks(RCC_clockValues * rcc_Clocks);
+Return_status xRCC_initStart(const RCC_config * config_Ptr);
+u8 u8RCC_initPoll(void);
+Return_status xRCC_initComplete(void);
 Return_status xRCC_EnableClock(u8 u8Peripheral);
 Return_status xRCC_DisableClock(u8 u8Peripheral);
 
+Return_status xRCC_refreshClocks(void);
+u32 u32RCC_getSYSCLK(void);
+u32 u32RCC_getHCLK(void);
+u32 u32RCC_getPCLK1(void);
+u32 u32RCC_getPCLK2(void);
+
+Return_status xRCC_setAHBDivisor(RCC_AHBDivisor divisor);
+Return_status xRCC_setAPB1Divisor(RCC_APBDivisor divisor);
+Return_status xRCC_setAPB2Divisor(RCC_APBDivisor divisor);
+
+Return_status xRCC_setPerfLevel(RCC_PerfLevel level);
+RCC_PerfLevel xRCC_getPerfLevel(void);
+Return_status xRCC_checkPerfTable(void);
+
+Return_status xRCC_subscribe(RCC_clockChangeCallback callback);
+Return_status xRCC_unsubscribe(RCC_clockChangeCallback callback);
+
 
 
 #endif /* RCC_INIT_H_ */
@@ -29,6 +29,7 @@
 
 
 #include "RCC_Init.h"
+#include "SYSTICK_Init.h"
 
 /********************************************************************************
 								PLL Clock Calculations
@@ -75,6 +76,70 @@
 /* Used to hold AHB Presalers */
 static volatile u8 g_busesPreScaler[16] = {0, 0, 0, 0, 1, 2, 3, 4, 1, 2, 3, 4, 6, 7, 8, 9};
 
+/* Last decoded clock values, updated only when RCC clock configuration changes */
+static RCC_clockValues g_clockCache = {0};
+
+/* Used to know if g_clockCache holds valid values (decoded at least once) */
+static u8 g_clockCacheValid = 0;
+
+/* Drivers to be notified when clocks change (USART BRR, SysTick reload, ...) */
+static RCC_clockChangeCallback g_clockSubscribers[RCC_MAX_SUBSCRIBERS] = {0};
+
+/********************************************************************************
+
+ [Structure Name]:			RCC_perfProfile
+
+ [Structure Description]:	Used to hold one predefined clock profile with the
+ 	 	 	 	 	 	 	flash wait states & voltage scale it needs
+
+*********************************************************************************/
+typedef struct{
+
+	u32				SYSCLKFrequency;		/* Expected SYSCLK, checked by xRCC_checkPerfTable */
+	u8				SYSCLKSource;			/* SYSCLK_SOURCE_HSI or SYSCLK_SOURCE_PLL (HSE input) */
+	u8				PLLM;
+	u16				PLLN;
+	u8				PLLP;					/* You can find this parameter @PLLP_VALUE */
+	u8				PLLQ;
+	RCC_AHBDivisor	AHBDivisor;
+	RCC_APBDivisor	APB1Divisor;
+	RCC_APBDivisor	APB2Divisor;
+	u8				VoltageScale;			/* You can find this parameter @PWR_VOS_SCALE */
+	u8				OverDrive;				/* 1 if Over-drive is needed (HCLK > 168 MHz) */
+	u8				FlashLatency;			/* Flash wait states */
+
+}RCC_perfProfile;
+
+/* Clock profiles, index is RCC_PerfLevel */
+static const RCC_perfProfile g_perfProfiles[RCC_PERF_LEVELS_NUM] = {
+
+	/* LOW: 		HSI = 16 MHz, 0 WS, Scale 3 */
+	{ 16000000U,  SYSCLK_SOURCE_HSI, 0, 0,   0,            0, AHB_NOT_DIVIDED, APB_NOT_DIVIDED,  APB_NOT_DIVIDED,  PWR_VOS_SCALE3, 0, 0 },
+
+	/* MEDIUM:		8 MHz / 4 * 168 / 4 = 84 MHz (USB 336 / 7 = 48 MHz), APB1 = 42, APB2 = 84, 2 WS, Scale 3 */
+	{ 84000000U,  SYSCLK_SOURCE_PLL, 4, 168, PLLP_VALUE_4, 7, AHB_NOT_DIVIDED, APB_DIVIDED_BY_2, APB_NOT_DIVIDED,  PWR_VOS_SCALE3, 0, 2 },
+
+	/* HIGH:		8 MHz / 4 * 180 / 2 = 180 MHz, APB1 = 45, APB2 = 90, 5 WS, Scale 1 + Over-drive */
+	{ 180000000U, SYSCLK_SOURCE_PLL, 4, 180, PLLP_VALUE_2, 8, AHB_NOT_DIVIDED, APB_DIVIDED_BY_4, APB_DIVIDED_BY_2, PWR_VOS_SCALE1, 1, 5 }
+};
+
+/* Current profile, RCC_PERF_LEVELS_NUM means clocks are set by xRCC_init */
+static RCC_PerfLevel g_perfLevel = RCC_PERF_LEVELS_NUM;
+
+/* Configuration given to xRCC_initStart, used by u8RCC_initPoll */
+static const RCC_config * g_bootConfig = 0;
+
+/* Current stage of staged init, You can find this parameter @RCC_BOOT */
+static u8 g_bootStage = RCC_BOOT_IDLE;
+
+/*********************************************************************************
+							Private Function Prototypes
+*********************************************************************************/
+static void vidRCC_decodeClocks(RCC_clockValues * rcc_Clocks);
+static Return_status xRCC_waitFlag(volatile u32 * reg, u32 mask, u32 value);
+static u8 u8RCC_getFlashLatency(u32 hclk);
+static void vidRCC_bootSwitch(void);
+
 /*********************************************************************************
 
 
@@ -119,7 +184,8 @@ Return_status xRCC_regInit(void){
 	RCC -> PLLSAICFGR	= 0x24003000;
 	RCC -> DCKCFGR		= 0x00000000;
 
-	return OK;
+	/* SYSCLK is HSI now, update clock cache */
+	return xRCC_refreshClocks();
 }
 
 /********************************************************************************
@@ -458,9 +524,265 @@ Return_status xRCC_init(const RCC_config * config_Ptr){
 	/* Clear PCLK2 Divisor Bits ( APB2 Prescaler bits ) then Set it */
 	RCC -> CFGR = ( ( (RCC -> CFGR) & (~(PCLK2_CLEAR)) ) | ( ( (config_Ptr -> APB2Divisor) << PCLK2_FIRST_BIT) & PCLK2_CLEAR) );
 
+	/* Clocks aren't one of the predefined profiles anymore */
+	g_perfLevel = RCC_PERF_LEVELS_NUM;
+
+	/* Update clock cache & notify subscribers if clocks changed */
+	return xRCC_refreshClocks();
+}
+
+/********************************************************************************
+ [Function Name]:	xRCC_initStart
+
+ [Description]:		First stage of staged RCC init, used instead of xRCC_init
+ 	 	 	 	 	to let CPU do other work while oscillators & PLL stabilise
+ 	 	 	 	 	- HSI (and HSE if chosen) are enabled without waiting
+ 	 	 	 	 	- SYSCLK stays HSI till u8RCC_initPoll finishes
+ 	 	 	 	 	Note: I2S & SAI PLLs aren't handled here, use xRCC_init
+ 	 	 	 	 	for configurations which need them
+
+ [Args]:			config_Ptr
+
+ [in]				config_Ptr: Pointer to RCC_config const structure, must
+ 	 	 	 	 	stay valid till u8RCC_initPoll returns 1
+
+ [Returns]:			Retrun Status (OK if everything is okay,
+ 	 	 	 	 	NOK if I2S or SAI PLL is requested)
+**********************************************************************************/
+Return_status xRCC_initStart(const RCC_config * config_Ptr){
+
+	if(config_Ptr == 0){
+		return NULLPOINTER;
+	}
+
+	/* PLL I2S & SAI are only configured by xRCC_init */
+	if( (config_Ptr -> PLL.PLLStateI2S == PLL_STATE_I2S_ON)
+#ifdef STM32F429
+		|| (config_Ptr -> PLL.PLLStateSAI == PLL_STATE_SAI_ON)
+#endif
+	){
+		return NOK;
+	}
+
+	g_bootConfig = config_Ptr;
+
+	/* Enable HSI, it stays SYSCLK till the new clock is ready */
+	RCC -> CR |= (HSI_ENABLE_VALUE << HSI_FIRST_BIT);
+
+	/* Enable HSE without waiting for it */
+	if(config_Ptr -> OscillatorType == OSCILLATOR_TYPE_HSE){
+		RCC -> CR |= (HSE_ENABLE_VALUE << HSE_ENABLE_BIT);
+	}
+
+	g_bootStage = RCC_BOOT_WAIT_OSC;
+
 	return OK;
 }
 
+/********************************************************************************
+ [Function Name]:	u8RCC_initPoll
+
+ [Description]:		Used to advance staged init without blocking
+ 	 	 	 	 	- Oscillators ready	-> configure & enable main PLL
+ 	 	 	 	 	- PLL locked		-> set wait states & divisors then
+ 	 	 	 	 	 	 	 	 	 	   switch SYSCLK
+ 	 	 	 	 	Should be called between other init work till it returns 1
+
+ [Args]:			None
+
+ [Returns]:			1 if clocks are ready (or the SYSCLK switch failed, see
+ 	 	 	 	 	xRCC_initComplete), 0 if still waiting
+**********************************************************************************/
+u8 u8RCC_initPoll(void){
+
+	const RCC_config * config_Ptr = g_bootConfig;
+
+	switch(g_bootStage){
+
+		case RCC_BOOT_WAIT_OSC:
+
+			if( BIT_IS_CLEAR( (RCC -> CR), HSI_READY_BIT) ){
+				return 0;
+			}
+
+			if( (config_Ptr -> OscillatorType == OSCILLATOR_TYPE_HSE) && BIT_IS_CLEAR( (RCC -> CR), HSE_READY_BIT) ){
+				return 0;
+			}
+
+			if(config_Ptr -> PLL.PLLStateMain != PLL_STATE_MAIN_ON){
+				vidRCC_bootSwitch();
+				return 1;
+			}
+
+			/* PLL can't be configured while running, so run from HSI then turn it off */
+			RCC -> CFGR = ( ( (RCC -> CFGR) & (~(SYSCLK_CLEAR_CLOCK_SOURCE)) ) | SYSCLK_SOURCE_HSI );
+			RCC -> CR &= (~(PLL_ENABLE_VALUE << PLL_ENABLE_BIT));
+			g_bootStage = RCC_BOOT_WAIT_PLL_OFF;
+			return 0;
+
+		case RCC_BOOT_WAIT_PLL_OFF:
+
+			if( BIT_IS_SET( (RCC -> CR), PLL_READY_BIT) ){
+				return 0;
+			}
+
+			/* Same margins as xRCC_init: PLLM, PLLQ >= 2 and PLLN <= 432 */
+			RCC -> PLLCFGR = ( ( (RCC -> PLLCFGR) & (~(PLLM_MASKING | PLLN_MASKING | PLLP_MASKING | PLLQ_MASKING | (PLL_SOURCE_HSE << PLL_SOURCE_BIT))) ) |
+								( ((config_Ptr -> PLL.PLLM) < 2) ? PLLM_DEFAULT_VALUE : ((config_Ptr -> PLL.PLLM) & PLLM_MASKING) ) |
+								( ( ((config_Ptr -> PLL.PLLN) > PLLN_MAX_VALUE) ? PLLN_MAX_VALUE :
+									(((config_Ptr -> PLL.PLLN) < PLLN_MIN_VALUE) ? PLLN_DEFAULT_VALUE : (config_Ptr -> PLL.PLLN)) ) << PLLN_FIRST_BIT ) |
+								( ((u32)((config_Ptr -> PLL.PLLP) & PLLP_VALUE_MASKING)) << PLLP_FIRST_BIT ) |
+								( ( ((config_Ptr -> PLL.PLLQ) < 2) ? PLLQ_DEFAULT_VALUE : ((config_Ptr -> PLL.PLLQ) & PLLQ_VALUE_MASKING) ) << PLLQ_FIRST_BIT ) );
+
+			/* Choose Main PLL entry clock source */
+			if( (config_Ptr -> OscillatorType == OSCILLATOR_TYPE_HSE) && ( (config_Ptr -> PLL.PLLSource) == PLL_SOURCE_HSE) ){
+				RCC -> PLLCFGR |= (PLL_SOURCE_HSE << PLL_SOURCE_BIT);
+			}
+
+			/* Enable the Main PLL Engine without waiting for lock */
+			RCC -> CR |= (PLL_STATE_MAIN_ON << PLL_ENABLE_BIT);
+			g_bootStage = RCC_BOOT_WAIT_PLL;
+			return 0;
+
+		case RCC_BOOT_WAIT_PLL:
+
+			if( BIT_IS_CLEAR( (RCC -> CR), PLL_READY_BIT) ){
+				return 0;
+			}
+
+			vidRCC_bootSwitch();
+			return 1;
+
+		case RCC_BOOT_DONE:
+		case RCC_BOOT_FAILED:
+			return 1;
+
+		default:
+			/* xRCC_initStart isn't called */
+			return 0;
+	}
+}
+
+/********************************************************************************
+ [Function Name]:	xRCC_initComplete
+
+ [Description]:		Last stage of staged init, waits (bounded) till
+ 	 	 	 	 	u8RCC_initPoll finishes
+
+ [Args]:			None
+
+ [Returns]:			Retrun Status (OK if clocks are ready,
+ 	 	 	 	 	NOK if timeout, SYSCLK switch failed (SYSCLK is HSI)
+ 	 	 	 	 	or xRCC_initStart isn't called)
+**********************************************************************************/
+Return_status xRCC_initComplete(void){
+
+	u32 counter = 0;
+
+	if(g_bootStage == RCC_BOOT_IDLE){
+		return NOK;
+	}
+
+	while(u8RCC_initPoll() == 0){
+
+		if(++counter >= RCC_READY_TIMEOUT){
+			return NOK;
+		}
+	}
+
+	return (g_bootStage == RCC_BOOT_DONE) ? OK : NOK;
+}
+
+/********************************************************************************
+ [Function Name]:	vidRCC_bootSwitch
+
+ [Description]:		Used by staged init to switch SYSCLK to the configured
+ 	 	 	 	 	source once it is ready
+ 	 	 	 	 	- Wait states are raised before switching and lowered
+ 	 	 	 	 	  after it, so flash is never too fast for HCLK
+ 	 	 	 	 	- If SYSCLK status doesn't follow within RCC_READY_TIMEOUT,
+ 	 	 	 	 	  SYSCLK is set back to HSI and staged init fails
+
+ [Args]:			None
+
+ [Returns]:			None
+**********************************************************************************/
+static void vidRCC_bootSwitch(void){
+
+	const RCC_config * config_Ptr = g_bootConfig;
+	u32 sysclk = HSI_CLOCK_VALUE, input = HSI_CLOCK_VALUE, pllm = 0, pllp = 0;
+	u8 latency = 0;
+
+	/* Calculate the new SYSCLK to know wait states needed */
+	if(config_Ptr -> SYSCLKSource == SYSCLK_SOURCE_HSE){
+		sysclk = HSE_CLOCK_VALUE;
+	}
+	else if(config_Ptr -> SYSCLKSource == SYSCLK_SOURCE_PLL){
+		if( ((RCC -> PLLCFGR) & (PLL_SOURCE_HSE << PLL_SOURCE_BIT)) != 0 ){
+			input = HSE_CLOCK_VALUE;
+		}
+		pllm   = ( (RCC -> PLLCFGR) & PLLM_MASKING );
+		pllp   = ( ( ( (RCC -> PLLCFGR) & PLLP_MASKING ) >> PLLP_FIRST_BIT ) + 1 ) * 2;
+		sysclk = ( (input / pllm) * ( ( (RCC -> PLLCFGR) & PLLN_MASKING ) >> PLLN_FIRST_BIT ) ) / pllp;
+	}
+
+	latency = u8RCC_getFlashLatency( sysclk >> g_busesPreScaler[(config_Ptr -> AHBDivisor) & 0x0F] );
+
+	if( latency > (RCC_FLASH_ACR & FLASH_LATENCY_MASKING) ){
+		RCC_FLASH_ACR = ( (RCC_FLASH_ACR & (~(FLASH_LATENCY_MASKING))) | latency );
+	}
+
+	/* Set bus divisors before the new SYSCLK */
+	RCC -> CFGR = ( ( (RCC -> CFGR) & (~(HCLK_CLEAR | PCLK1_CLEAR | PCLK2_CLEAR)) ) |
+					( ((u32)(config_Ptr -> AHBDivisor)  << HCLK_FIRST_BIT)  & HCLK_CLEAR )  |
+					( ((u32)(config_Ptr -> APB1Divisor) << PCLK1_FIRST_BIT) & PCLK1_CLEAR ) |
+					( ((u32)(config_Ptr -> APB2Divisor) << PCLK2_FIRST_BIT) & PCLK2_CLEAR ) );
+
+	/* Clear SYSCLK Bits then choose SYSCLK clock source */
+	RCC -> CFGR = ( ( (RCC -> CFGR) & (~(SYSCLK_CLEAR_CLOCK_SOURCE)) ) | ( (config_Ptr -> SYSCLKSource) & SYSCLK_CLEAR_CLOCK_SOURCE) );
+
+	if(xRCC_waitFlag(&(RCC -> CFGR), SYSCLK_STATUS_MASKING, ( ((config_Ptr -> SYSCLKSource) & SYSCLK_CLEAR_CLOCK_SOURCE) << SYSCLK_STATUS_FIRST_BIT )) == OK){
+
+		if( latency < (RCC_FLASH_ACR & FLASH_LATENCY_MASKING) ){
+			RCC_FLASH_ACR = ( (RCC_FLASH_ACR & (~(FLASH_LATENCY_MASKING))) | latency );
+		}
+
+		g_bootStage = RCC_BOOT_DONE;
+	}
+	else{
+		/* Switch never happened, stay on HSI (ready since RCC_BOOT_WAIT_OSC),
+		   raised wait states are kept as they are safe for HSI */
+		RCC -> CFGR = ( ( (RCC -> CFGR) & (~(SYSCLK_CLEAR_CLOCK_SOURCE)) ) | SYSCLK_SOURCE_HSI );
+		xRCC_waitFlag(&(RCC -> CFGR), SYSCLK_STATUS_MASKING, (SYSCLK_SOURCE_HSI << SYSCLK_STATUS_FIRST_BIT));
+
+		g_bootStage = RCC_BOOT_FAILED;
+	}
+
+	g_perfLevel = RCC_PERF_LEVELS_NUM;
+
+	/* Update clock cache & notify subscribers */
+	xRCC_refreshClocks();
+}
+
+/********************************************************************************
+ [Function Name]:	u8RCC_getFlashLatency
+
+ [Description]:		Used to get flash wait states needed for HCLK
+ 	 	 	 	 	(one wait state for every 30 MHz, VDD 2.7V -> 3.6V)
+
+ [Args]:			hclk
+
+ [Returns]:			Number of wait states
+**********************************************************************************/
+static u8 u8RCC_getFlashLatency(u32 hclk){
+
+	if(hclk == 0){
+		return 0;
+	}
+
+	return (u8)( (hclk - 1) / FLASH_WS_STEP_FREQUENCY );
+}
+
 /********************************************************************************
  [Function Name]:	xRCC_getClocks
 
@@ -469,6 +791,8 @@ Return_status xRCC_init(const RCC_config * config_Ptr){
  	 	 	 	 	-HCLK
  	 	 	 	 	-PCLK1
  	 	 	 	 	-PCLK2
+ 	 	 	 	 	Values are copied from clock cache, registers are decoded
+ 	 	 	 	 	only at the first call or when clocks are changed
 
  [Args]:			rcc_Clocks
 
@@ -481,9 +805,46 @@ Return_status xRCC_init(const RCC_config * config_Ptr){
 
  [Returns]:			Retrun Status (OK if everything is okay)
 **********************************************************************************/
-
 Return_status xRCC_getClocks(RCC_clockValues * rcc_Clocks){
 
+	/* Check if pointer is valid */
+	if(rcc_Clocks == 0){
+		return NULLPOINTER;
+	}
+
+	/* Decode registers once if cache is not filled yet */
+	if(g_clockCacheValid == 0){
+		xRCC_refreshClocks();
+	}
+
+	*rcc_Clocks = g_clockCache;
+
+	return OK;
+}
+
+/********************************************************************************
+ [Function Name]:	vidRCC_decodeClocks
+
+ [Description]:		Used to decode clock values from CFGR & PLLCFGR registers
+ 	 	 	 	 	-SYSCLK
+ 	 	 	 	 	-HCLK
+ 	 	 	 	 	-PCLK1
+ 	 	 	 	 	-PCLK2
+
+ [Args]:			rcc_Clocks
+
+ [in]				None
+
+ [out]				rcc_Clocks: Pointer to RCC_clockValues structure
+ 	 	 	 	 	Which clock values will be saved on it
+
+ [in/out]			None
+
+ [Returns]:			None
+**********************************************************************************/
+
+static void vidRCC_decodeClocks(RCC_clockValues * rcc_Clocks){
+
 	u32 temp = 0, fvco = 0, prescaler = 0;
 	u32 pllSource = 0, pllp = 0, pllm = 0, plln = 0;
 
@@ -607,8 +968,490 @@ Return_status xRCC_getClocks(RCC_clockValues * rcc_Clocks){
 		 *  with APB1 Prescaler (Right Shifting it)
 		 */
 		rcc_Clocks -> PCLK2Frequency = ( (rcc_Clocks -> HCLKFrequency) >> prescaler );
+}
+
+/********************************************************************************
+ [Function Name]:	xRCC_refreshClocks
+
+ [Description]:		Used to decode clock registers again and update clock cache
+ 	 	 	 	 	If any clock value changed, all subscribers are called
+ 	 	 	 	 	with old and new values
+ 	 	 	 	 	Note: Should be called after changing RCC registers directly
+
+ [Args]:			None
+
+ [in]				None
 
+ [out]				None
+
+ [in/out]			None
+
+ [Returns]:			Retrun Status (OK if everything is okay)
+**********************************************************************************/
+Return_status xRCC_refreshClocks(void){
+
+	RCC_clockValues oldClocks = g_clockCache;
+	RCC_clockValues newClocks = {0};
+	u8 i = 0;
+
+	vidRCC_decodeClocks(&newClocks);
+
+	g_clockCache = newClocks;
+
+	/* First decoding has no previous values to compare with */
+	if(g_clockCacheValid == 0){
+		g_clockCacheValid = 1;
 		return OK;
+	}
+
+	/* Notify subscribers only if one of the clocks is changed */
+	if( (oldClocks.SYSCLKFrequency != newClocks.SYSCLKFrequency) ||
+		(oldClocks.HCLKFrequency   != newClocks.HCLKFrequency)   ||
+		(oldClocks.PCLK1Frequency  != newClocks.PCLK1Frequency)  ||
+		(oldClocks.PCLK2Frequency  != newClocks.PCLK2Frequency) ){
+
+		for(i = 0; i < RCC_MAX_SUBSCRIBERS; i++){
+			if(g_clockSubscribers[i] != 0){
+				g_clockSubscribers[i](&oldClocks, &newClocks);
+			}
+		}
+	}
+
+	return OK;
+}
+
+/********************************************************************************
+ [Function Name]:	u32RCC_getSYSCLK, u32RCC_getHCLK, u32RCC_getPCLK1, u32RCC_getPCLK2
+
+ [Description]:		Used to get one clock value from clock cache
+
+ [Args]:			None
+
+ [Returns]:			Clock frequency in Hz
+**********************************************************************************/
+u32 u32RCC_getSYSCLK(void){
+
+	if(g_clockCacheValid == 0){
+		xRCC_refreshClocks();
+	}
+
+	return g_clockCache.SYSCLKFrequency;
+}
+
+u32 u32RCC_getHCLK(void){
+
+	if(g_clockCacheValid == 0){
+		xRCC_refreshClocks();
+	}
+
+	return g_clockCache.HCLKFrequency;
+}
+
+u32 u32RCC_getPCLK1(void){
+
+	if(g_clockCacheValid == 0){
+		xRCC_refreshClocks();
+	}
+
+	return g_clockCache.PCLK1Frequency;
+}
+
+u32 u32RCC_getPCLK2(void){
+
+	if(g_clockCacheValid == 0){
+		xRCC_refreshClocks();
+	}
+
+	return g_clockCache.PCLK2Frequency;
+}
+
+/********************************************************************************
+ [Function Name]:	xRCC_setAHBDivisor
+
+ [Description]:		Used to change AHB Prescaler then update clock cache
+
+ [Args]:			divisor
+
+ [in]				divisor: You can find this parameter @RCC_AHBDivisor
+
+ [Returns]:			Retrun Status (OK if everything is okay)
+**********************************************************************************/
+Return_status xRCC_setAHBDivisor(RCC_AHBDivisor divisor){
+
+	/* Check if divisor is a valid value */
+	if( (divisor != AHB_NOT_DIVIDED) && ((divisor < AHB_DIVIDED_BY_2) || (divisor > AHB_DIVIDED_BY_512)) ){
+		return OUTOFRANGE;
+	}
+
+	/* Clear HCLK Divisor Bits ( AHB Prescaler bits ) then Set it */
+	RCC -> CFGR = ( ( (RCC -> CFGR) & (~(HCLK_CLEAR)) ) | ( (divisor << HCLK_FIRST_BIT) & HCLK_CLEAR) );
+
+	return xRCC_refreshClocks();
+}
+
+/********************************************************************************
+ [Function Name]:	xRCC_setAPB1Divisor
+
+ [Description]:		Used to change APB1 Prescaler then update clock cache
+
+ [Args]:			divisor
+
+ [in]				divisor: You can find this parameter @RCC_APBDivisor
+
+ [Returns]:			Retrun Status (OK if everything is okay)
+**********************************************************************************/
+Return_status xRCC_setAPB1Divisor(RCC_APBDivisor divisor){
+
+	/* Check if divisor is a valid value */
+	if( (divisor != APB_NOT_DIVIDED) && ((divisor < APB_DIVIDED_BY_2) || (divisor > APB_DIVIDED_BY_16)) ){
+		return OUTOFRANGE;
+	}
+
+	/* Clear PCLK1 Divisor Bits ( APB1 Prescaler bits ) then Set it */
+	RCC -> CFGR = ( ( (RCC -> CFGR) & (~(PCLK1_CLEAR)) ) | ( (divisor << PCLK1_FIRST_BIT) & PCLK1_CLEAR) );
+
+	return xRCC_refreshClocks();
+}
+
+/********************************************************************************
+ [Function Name]:	xRCC_setAPB2Divisor
+
+ [Description]:		Used to change APB2 Prescaler then update clock cache
+
+ [Args]:			divisor
+
+ [in]				divisor: You can find this parameter @RCC_APBDivisor
+
+ [Returns]:			Retrun Status (OK if everything is okay)
+**********************************************************************************/
+Return_status xRCC_setAPB2Divisor(RCC_APBDivisor divisor){
+
+	/* Check if divisor is a valid value */
+	if( (divisor != APB_NOT_DIVIDED) && ((divisor < APB_DIVIDED_BY_2) || (divisor > APB_DIVIDED_BY_16)) ){
+		return OUTOFRANGE;
+	}
+
+	/* Clear PCLK2 Divisor Bits ( APB2 Prescaler bits ) then Set it */
+	RCC -> CFGR = ( ( (RCC -> CFGR) & (~(PCLK2_CLEAR)) ) | ( (divisor << PCLK2_FIRST_BIT) & PCLK2_CLEAR) );
+
+	return xRCC_refreshClocks();
+}
+
+/********************************************************************************
+ [Function Name]:	xRCC_waitFlag
+
+ [Description]:		Used to wait till masked register bits equal a value
+ 	 	 	 	 	with a bounded number of loops
+
+ [Args]:			reg, mask, value
+
+ [Returns]:			Retrun Status (OK if bits reached the value, NOK if timeout)
+**********************************************************************************/
+static Return_status xRCC_waitFlag(volatile u32 * reg, u32 mask, u32 value){
+
+	u32 counter = 0;
+
+	while( ((*reg) & mask) != value ){
+
+		if(++counter >= RCC_READY_TIMEOUT){
+			return NOK;
+		}
+	}
+
+	return OK;
+}
+
+/********************************************************************************
+ [Function Name]:	xRCC_setPerfLevel
+
+ [Description]:		Used to switch SYSCLK to one of the predefined profiles
+ 	 	 	 	 	- SYSCLK is moved to HSI first, so PLL is never changed
+ 	 	 	 	 	  while it drives the core (SYSCLK switch is glitch-free)
+ 	 	 	 	 	- Over-drive, voltage scale & flash wait states are changed
+ 	 	 	 	 	  while running from HSI (16 MHz is safe with any of them)
+ 	 	 	 	 	- PLL is locked & Over-drive is ready before switching to PLL
+ 	 	 	 	 	- Every wait is bounded by RCC_READY_TIMEOUT, on timeout
+ 	 	 	 	 	  SYSCLK stays on HSI
+ 	 	 	 	 	- Interrupts are masked during the switch, an ISR must not
+ 	 	 	 	 	  run from flash with the wait states of another frequency
+ 	 	 	 	 	  or see a half configured PLL
+ 	 	 	 	 	- Subscribers (USART BRR, SysTick reload) are notified
+ 	 	 	 	 	  after interrupts are restored
+
+ [Args]:			level
+
+ [in]				level: You can find this parameter @RCC_PerfLevel
+
+ [Returns]:			Retrun Status (OK if everything is okay, NOK on timeout)
+**********************************************************************************/
+Return_status xRCC_setPerfLevel(RCC_PerfLevel level){
+
+	const RCC_perfProfile * profile = 0;
+	Return_status status = OK;
+	u32 irqState = 0;
+
+	if(level >= RCC_PERF_LEVELS_NUM){
+		return OUTOFRANGE;
+	}
+
+	profile = &g_perfProfiles[level];
+
+	irqState = u32SYSTICK_EnterCritical();
+
+	/* Enable HSI then use it as SYSCLK while changing PLL, voltage & wait states */
+	RCC -> CR |= (HSI_ENABLE_VALUE << HSI_FIRST_BIT);
+	status = xRCC_waitFlag(&(RCC -> CR), (1U << HSI_READY_BIT), (1U << HSI_READY_BIT));
+
+	if(status == OK){
+		/* Flash wait states of the old frequency are still valid for HSI */
+		RCC -> CFGR = ( ( (RCC -> CFGR) & (~(SYSCLK_CLEAR_CLOCK_SOURCE)) ) | SYSCLK_SOURCE_HSI );
+		status = xRCC_waitFlag(&(RCC -> CFGR), SYSCLK_STATUS_MASKING, (SYSCLK_SOURCE_HSI << SYSCLK_STATUS_FIRST_BIT));
+	}
+
+	if(status == OK){
+		/* PLL can only be configured while it is off */
+		RCC -> CR &= (~(PLL_ENABLE_VALUE << PLL_ENABLE_BIT));
+		status = xRCC_waitFlag(&(RCC -> CR), (1U << PLL_READY_BIT), 0);
+	}
+
+	if(status == OK){
+		/* Power interface clock is needed to access PWR registers */
+		SET_BIT(RCC -> APB1ENR, PWR_CLOCK_ENABLE_BIT);
+
+		/* Leave Over-drive mode if new profile doesn't need it */
+		if( (profile -> OverDrive == 0) && BIT_IS_SET(RCC_PWR_CR, PWR_ODEN_BIT) ){
+			RCC_PWR_CR &= (~( (1U << PWR_ODSWEN_BIT) | (1U << PWR_ODEN_BIT) ));
+			status = xRCC_waitFlag(&RCC_PWR_CSR, (1U << PWR_ODSWRDY_BIT), 0);
+		}
+	}
+
+	if(status == OK){
+		/* Voltage scale is applied when PLL is enabled */
+		RCC_PWR_CR = ( (RCC_PWR_CR & (~(PWR_VOS_MASKING))) | ((u32)(profile -> VoltageScale) << PWR_VOS_FIRST_BIT) );
+
+		/* Wait states of the new frequency, then make sure flash took them */
+		RCC_FLASH_ACR = ( (RCC_FLASH_ACR & (~(FLASH_LATENCY_MASKING))) | (profile -> FlashLatency) |
+						  FLASH_PREFETCH_ENABLE | FLASH_ICACHE_ENABLE | FLASH_DCACHE_ENABLE );
+
+		if( (RCC_FLASH_ACR & FLASH_LATENCY_MASKING) != (profile -> FlashLatency) ){
+			status = NOK;
+		}
+	}
+
+	if( (status == OK) && (profile -> SYSCLKSource == SYSCLK_SOURCE_PLL) ){
+		/* HSE is the PLL input of all PLL profiles */
+		RCC -> CR |= (HSE_ENABLE_VALUE << HSE_ENABLE_BIT);
+		status = xRCC_waitFlag(&(RCC -> CR), (1U << HSE_READY_BIT), (1U << HSE_READY_BIT));
+
+		if(status == OK){
+			RCC -> PLLCFGR = ( ( (RCC -> PLLCFGR) & (~(PLLM_MASKING | PLLN_MASKING | PLLP_MASKING | PLLQ_MASKING | (PLL_SOURCE_HSE << PLL_SOURCE_BIT))) ) |
+								( (profile -> PLLM) & PLLM_MASKING ) |
+								( ((u32)(profile -> PLLN) << PLLN_FIRST_BIT) & PLLN_MASKING ) |
+								( ((u32)(profile -> PLLP) << PLLP_FIRST_BIT) & PLLP_MASKING ) |
+								( ((u32)(profile -> PLLQ) << PLLQ_FIRST_BIT) & PLLQ_MASKING ) |
+								( PLL_SOURCE_HSE << PLL_SOURCE_BIT ) );
+
+			RCC -> CR |= (PLL_ENABLE_VALUE << PLL_ENABLE_BIT);
+			status = xRCC_waitFlag(&(RCC -> CR), (1U << PLL_READY_BIT), (1U << PLL_READY_BIT));
+		}
+
+		if(status == OK){
+			status = xRCC_waitFlag(&RCC_PWR_CSR, (1U << PWR_VOSRDY_BIT), (1U << PWR_VOSRDY_BIT));
+		}
+
+		/* Over-drive is enabled after PLL lock and before switching to PLL */
+		if( (status == OK) && (profile -> OverDrive != 0) ){
+			RCC_PWR_CR |= (1U << PWR_ODEN_BIT);
+			status = xRCC_waitFlag(&RCC_PWR_CSR, (1U << PWR_ODRDY_BIT), (1U << PWR_ODRDY_BIT));
+
+			if(status == OK){
+				RCC_PWR_CR |= (1U << PWR_ODSWEN_BIT);
+				status = xRCC_waitFlag(&RCC_PWR_CSR, (1U << PWR_ODSWRDY_BIT), (1U << PWR_ODSWRDY_BIT));
+			}
+		}
+	}
+
+	if(status == OK){
+		/* Bus divisors are set before SYSCLK goes up so APB never exceeds its max */
+		RCC -> CFGR = ( ( (RCC -> CFGR) & (~(HCLK_CLEAR | PCLK1_CLEAR | PCLK2_CLEAR)) ) |
+						( ((u32)(profile -> AHBDivisor)  << HCLK_FIRST_BIT)  & HCLK_CLEAR )  |
+						( ((u32)(profile -> APB1Divisor) << PCLK1_FIRST_BIT) & PCLK1_CLEAR ) |
+						( ((u32)(profile -> APB2Divisor) << PCLK2_FIRST_BIT) & PCLK2_CLEAR ) );
+
+		if(profile -> SYSCLKSource == SYSCLK_SOURCE_PLL){
+			RCC -> CFGR = ( ( (RCC -> CFGR) & (~(SYSCLK_CLEAR_CLOCK_SOURCE)) ) | SYSCLK_SOURCE_PLL );
+			status = xRCC_waitFlag(&(RCC -> CFGR), SYSCLK_STATUS_MASKING, (SYSCLK_SOURCE_PLL << SYSCLK_STATUS_FIRST_BIT));
+		}
+	}
+
+	/* On timeout SYSCLK is HSI (or the old clock if HSI never got ready) */
+	g_perfLevel = (status == OK) ? level : RCC_PERF_LEVELS_NUM;
+
+	vidSYSTICK_ExitCritical(irqState);
+
+	/* Update clock cache & notify subscribers */
+	xRCC_refreshClocks();
+
+	return status;
+}
+
+/********************************************************************************
+ [Function Name]:	xRCC_getPerfLevel
+
+ [Description]:		Used to get current clock profile
+
+ [Args]:			None
+
+ [Returns]:			Current RCC_PerfLevel, RCC_PERF_LEVELS_NUM if clocks are
+ 	 	 	 	 	configured by xRCC_init or last switch failed
+**********************************************************************************/
+RCC_PerfLevel xRCC_getPerfLevel(void){
+
+	return g_perfLevel;
+}
+
+/********************************************************************************
+ [Function Name]:	xRCC_checkPerfTable
+
+ [Description]:		Used to check profiles table is consistent:
+ 	 	 	 	 	- PLL VCO input & output are within their margins
+ 	 	 	 	 	- PLL output equals the expected SYSCLK
+ 	 	 	 	 	- PCLK1 & PCLK2 don't exceed their max values
+ 	 	 	 	 	- Flash wait states are enough for HCLK
+ 	 	 	 	 	- Voltage scale (and Over-drive) allows HCLK
+ 	 	 	 	 	- Profiles are sorted by frequency
+
+ [Args]:			None
+
+ [Returns]:			Retrun Status (OK if table is consistent, NOK if not)
+**********************************************************************************/
+Return_status xRCC_checkPerfTable(void){
+
+	const RCC_perfProfile * profile = 0;
+	u32 vcoInput = 0, vcoOutput = 0, sysclk = 0, hclk = 0, maxHclk = 0;
+	u32 previousSysclk = 0;
+	u8 i = 0;
+
+	for(i = 0; i < RCC_PERF_LEVELS_NUM; i++){
+
+		profile = &g_perfProfiles[i];
+
+		if(profile -> SYSCLKSource == SYSCLK_SOURCE_PLL){
+
+			if( (profile -> PLLM < 2) || (profile -> PLLQ < 2) ){
+				return NOK;
+			}
+
+			vcoInput  = HSE_CLOCK_VALUE / profile -> PLLM;
+			vcoOutput = vcoInput * profile -> PLLN;
+			sysclk    = vcoOutput / ( ((u32)(profile -> PLLP) + 1) * 2 );
+
+			if( (vcoInput < PLL_VCO_INPUT_MIN) || (vcoInput > PLL_VCO_INPUT_MAX) ||
+				(vcoOutput < PLL_VCO_OUTPUT_MIN) || (vcoOutput > PLL_VCO_OUTPUT_MAX) ){
+				return NOK;
+			}
+		}
+		else{
+			sysclk = HSI_CLOCK_VALUE;
+		}
+
+		if( (sysclk != profile -> SYSCLKFrequency) || (sysclk <= previousSysclk) ){
+			return NOK;
+		}
+
+		hclk = sysclk >> g_busesPreScaler[profile -> AHBDivisor];
+
+		if( ((hclk >> g_busesPreScaler[profile -> APB1Divisor]) > PCLK1_MAX_FREQUENCY) ||
+			((hclk >> g_busesPreScaler[profile -> APB2Divisor]) > PCLK2_MAX_FREQUENCY) ){
+			return NOK;
+		}
+
+		/* Every wait state covers FLASH_WS_STEP_FREQUENCY of HCLK */
+		if( (profile -> FlashLatency > FLASH_MAX_LATENCY) ||
+			(profile -> FlashLatency < u8RCC_getFlashLatency(hclk)) ){
+			return NOK;
+		}
+
+		switch(profile -> VoltageScale){
+			case PWR_VOS_SCALE3:	maxHclk = 120000000U; break;
+			case PWR_VOS_SCALE2:	maxHclk = 144000000U; break;
+			case PWR_VOS_SCALE1:	maxHclk = (profile -> OverDrive != 0) ? 180000000U : 168000000U; break;
+			default:				return NOK;
+		}
+
+		/* Over-drive is only available with Scale 1 */
+		if( (hclk > maxHclk) || ((profile -> OverDrive != 0) && (profile -> VoltageScale != PWR_VOS_SCALE1)) ){
+			return NOK;
+		}
+
+		previousSysclk = sysclk;
+	}
+
+	return OK;
+}
+
+/********************************************************************************
+ [Function Name]:	xRCC_subscribe
+
+ [Description]:		Used to register a callback called when clocks change
+
+ [Args]:			callback
+
+ [in]				callback: Function to be called with old & new clocks
+
+ [Returns]:			Retrun Status (OK if everything is okay,
+ 	 	 	 	 	NOK if subscribers list is full)
+**********************************************************************************/
+Return_status xRCC_subscribe(RCC_clockChangeCallback callback){
+
+	u8 i = 0;
+
+	if(callback == 0){
+		return NULLPOINTER;
+	}
+
+	/* Already subscribed */
+	for(i = 0; i < RCC_MAX_SUBSCRIBERS; i++){
+		if(g_clockSubscribers[i] == callback){
+			return OK;
+		}
+	}
+
+	/* Put it in the first empty place */
+	for(i = 0; i < RCC_MAX_SUBSCRIBERS; i++){
+		if(g_clockSubscribers[i] == 0){
+			g_clockSubscribers[i] = callback;
+			return OK;
+		}
+	}
+
+	return NOK;
+}
+
+/********************************************************************************
+ [Function Name]:	xRCC_unsubscribe
+
+ [Description]:		Used to remove a callback from subscribers list
+
+ [Args]:			callback
+
+ [in]				callback: Function previously given to xRCC_subscribe
+
+ [Returns]:			Retrun Status (OK if everything is okay,
+ 	 	 	 	 	NOK if callback isn't subscribed)
+**********************************************************************************/
+Return_status xRCC_unsubscribe(RCC_clockChangeCallback callback){
+
+	u8 i = 0;
+
+	for(i = 0; i < RCC_MAX_SUBSCRIBERS; i++){
+		if((callback != 0) && (g_clockSubscribers[i] == callback)){
+			g_clockSubscribers[i] = 0;
+			return OK;
+		}
+	}
+
+	return NOK;
 }
 
 /********************************************************************************
@@ -93,4 +93,12 @@ typedef struct{
 */
 #define RCC ((RCC_REG*) 0x40023800)
 
+/*
+ * Flash & Power registers needed when changing SYSCLK frequency
+ * (Flash wait states, Voltage scaling and Over-drive)
+*/
+#define RCC_FLASH_ACR	*((volatile u32*) 0x40023C00)		//Flash Access Control Register
+#define RCC_PWR_CR		*((volatile u32*) 0x40007000)		//Power Control Register
+#define RCC_PWR_CSR		*((volatile u32*) 0x40007004)		//Power Control & Status Register
+
 #endif /* RCC_REG_H_ */
@@ -0,0 +1,25 @@
+/*
+ * SCHED_Init.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ */
+
+#ifndef SCHED_INIT_H_
+#define SCHED_INIT_H_
+
+//One Task per Priority, Priority 0 is the highest
+#define SCHED_MAX_TASKS		(32U)
+
+//Run to Completion Task, receives the Events posted since its last Run
+typedef void (*SCHED_TaskFunc)(u32 u32Events);
+
+Return_status xSCHED_CreateTask(u8 u8Priority, SCHED_TaskFunc pfTask);
+
+//Can be called from Tasks & ISRs
+Return_status xSCHED_PostEvent(u8 u8Priority, u32 u32Events);
+
+//Dispatch Loop, never returns. Sleeps in vidSYSTICK_Idle while no Task is Ready
+void vidSCHED_Run(void);
+
+#endif /* SCHED_INIT_H_ */
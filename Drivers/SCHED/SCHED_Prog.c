@@ -0,0 +1,98 @@
+/*
+ * SCHED_Prog.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ */
+
+#include "STD_TYPES_OLD.h"
+
+#include "SYSTICK_Init.h"
+#include "SCHED_Init.h"
+
+typedef struct{
+	SCHED_TaskFunc	pfTask;
+	volatile u32	Events;			//Pending Events, cleared when the Task runs
+}SCHED_Task;
+
+static SCHED_Task SCHED_Tasks[SCHED_MAX_TASKS];
+
+//Bit (31 - Priority) is set while the Task has pending Events, so CLZ gives the highest Priority
+static volatile u32 SCHED_ReadyMask;
+
+#define SCHED_PRIO_BIT(PRIO)	(0x80000000UL >> (PRIO))
+
+Return_status xSCHED_CreateTask(u8 u8Priority, SCHED_TaskFunc pfTask)
+{
+	if(pfTask == 0)
+	{
+		return NULLPOINTER;
+	}
+
+	if(u8Priority >= SCHED_MAX_TASKS)
+	{
+		return OUTOFRANGE;
+	}
+
+	if(SCHED_Tasks[u8Priority].pfTask != 0)
+	{
+		return NOK;
+	}
+
+	SCHED_Tasks[u8Priority].Events = 0;
+	SCHED_Tasks[u8Priority].pfTask = pfTask;
+
+	return OK;
+}
+
+Return_status xSCHED_PostEvent(u8 u8Priority, u32 u32Events)
+{
+	u32 u32State;
+
+	if((u8Priority >= SCHED_MAX_TASKS) || (SCHED_Tasks[u8Priority].pfTask == 0))
+	{
+		return OUTOFRANGE;
+	}
+
+	if(u32Events == 0)
+	{
+		return OK;
+	}
+
+	u32State = u32SYSTICK_EnterCritical();
+	SCHED_Tasks[u8Priority].Events |= u32Events;
+	SCHED_ReadyMask |= SCHED_PRIO_BIT(u8Priority);
+	vidSYSTICK_ExitCritical(u32State);
+
+	return OK;
+}
+
+void vidSCHED_Run(void)
+{
+	u32 u32State;
+	u32 u32Events;
+	u8  u8Priority;
+
+	while(1)
+	{
+		u32State = u32SYSTICK_EnterCritical();
+
+		if(SCHED_ReadyMask == 0)
+		{
+			//Interrupts stay masked so an Event posted now still wakes WFI,
+			//its ISR runs once the Critical Section is left
+			vidSYSTICK_Idle();
+			vidSYSTICK_ExitCritical(u32State);
+			continue;
+		}
+
+		u8Priority = (u8)__builtin_clz(SCHED_ReadyMask);
+		u32Events  = SCHED_Tasks[u8Priority].Events;
+		SCHED_Tasks[u8Priority].Events = 0;
+		SCHED_ReadyMask &= ~SCHED_PRIO_BIT(u8Priority);
+
+		vidSYSTICK_ExitCritical(u32State);
+
+		SCHED_Tasks[u8Priority].pfTask(u32Events);
+	}
+}
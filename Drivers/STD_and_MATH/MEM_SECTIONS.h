@@ -0,0 +1,34 @@
+/*
+ * MEM_SECTIONS.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ */
+
+#ifndef MEM_SECTIONS_H_
+#define MEM_SECTIONS_H_
+
+//Sections are defined in stm32f4_flash.ld and initialized by the startup copy/zero tables
+
+//Function executed from SRAM (no Flash wait states), CCM RAM can't execute code
+#ifndef RAM_FUNC
+#define RAM_FUNC		__attribute__((section(".ramfunc")))
+#endif
+
+//Initialized variable in CCM RAM (zero wait state), not reachable by DMA
+#ifndef CCM_DATA
+#define CCM_DATA		__attribute__((section(".ccmram")))
+#endif
+
+//Zero initialized variable in CCM RAM, not reachable by DMA
+#ifndef CCM_BSS
+#define CCM_BSS			__attribute__((section(".ccmbss")))
+#endif
+
+//Variable in SRAM not cleared by the startup, can be used by DMA.
+//Buffers that must start zeroed can be cleared on first use (xDMA_MemSet)
+#ifndef NO_INIT
+#define NO_INIT			__attribute__((section(".noinit")))
+#endif
+
+#endif /* MEM_SECTIONS_H_ */
@@ -0,0 +1,45 @@
+/*
+ * SWTIMER_Init.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ */
+
+#ifndef SWTIMER_INIT_H_
+#define SWTIMER_INIT_H_
+
+//Hierarchical Timing Wheel: 4 Levels of 64 Slots, each Level covers 64x the previous one
+#define SWTIMER_LEVEL_BITS		(6U)
+#define SWTIMER_SLOTS			(1U << SWTIMER_LEVEL_BITS)
+#define SWTIMER_SLOT_MASK		(SWTIMER_SLOTS - 1U)
+#define SWTIMER_LEVELS			(4U)
+
+//Level 0 occupancy Bit of a Slot (Bitmap scanned with CLZ)
+#define SWTIMER_SLOT_BIT(u32Slot)	(0x8000000000000000ULL >> (u32Slot))
+
+//Longest Delay in Ticks, longer Delays are clamped
+//(2^24 - 1 less one Level 0 turn, the Wheel may lag SysTick by up to 64 Ticks between Driver wakeups)
+#define SWTIMER_MAX_DELAY		((1UL << (SWTIMER_LEVEL_BITS * SWTIMER_LEVELS)) - 1UL - SWTIMER_SLOTS)
+
+//Timer Callback, called from SysTick_Handler context
+typedef void (*SWTIMER_Callback)(void* pArg);
+
+//Timer allocated by the caller, linked into one Wheel Slot while Active
+typedef struct SWTIMER_Timer{
+	struct SWTIMER_Timer*	pNext;
+	struct SWTIMER_Timer**	ppPrev;			//Address of the Pointer that points to this Timer
+	u32						Expiry;			//Absolute Wheel Tick
+	u32						Period;			//0 -> One Shot, else Reload in Ticks
+	SWTIMER_Callback		pfCallback;
+	void*					pArg;
+	volatile u8				Active;
+}SWTIMER_Timer;
+
+void vidSWTIMER_Init(void);
+
+Return_status xSWTIMER_Start(SWTIMER_Timer* pTimer, u32 u32Delay, u32 u32Period, SWTIMER_Callback pfCallback, void* pArg);
+void vidSWTIMER_Stop(SWTIMER_Timer* pTimer);
+u8   u8SWTIMER_IsActive(const SWTIMER_Timer* pTimer);
+u32  u32SWTIMER_GetCount(void);
+
+#endif /* SWTIMER_INIT_H_ */
@@ -0,0 +1,319 @@
+/*
+ * SWTIMER_Prog.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ */
+
+#include "STD_TYPES_OLD.h"
+
+#include "SYSTICK_Init.h"
+#include "SWTIMER_Init.h"
+#include "MEM_SECTIONS.h"
+
+//Slot Lists, Level 0 holds Timers expiring in the next 64 Ticks
+CCM_BSS static SWTIMER_Timer* SWTIMER_Wheel[SWTIMER_LEVELS][SWTIMER_SLOTS];
+
+//Bit (63 - Slot) is set while the Level 0 Slot isn't empty, so CLZ gives the nearest Slot
+CCM_BSS static u64 SWTIMER_Level0;
+
+//Next Wheel Tick to be processed, Wheel Tick T is processed when the SysTick Tick Count reaches T
+static u32 SWTIMER_Now;
+
+//Timers of the Slot being processed, moved out of the Wheel before their Callbacks run
+static SWTIMER_Timer* SWTIMER_Expired;
+
+//Number of Active Timers, SysTick drives the Wheel only while it isn't 0
+static u32 SWTIMER_Count;
+
+//One Shot SysTick Timer armed at the next Wheel Tick that has work (Expiry or Cascade)
+static SYSTICK_Timer SWTIMER_Driver;
+
+static void vidSWTIMER_Tick(void* pArg);
+
+static void vidSWTIMER_Link(SWTIMER_Timer** ppHead, SWTIMER_Timer* pTimer)
+{
+	pTimer->pNext  = *ppHead;
+	pTimer->ppPrev = ppHead;
+
+	if(*ppHead != 0)
+	{
+		(*ppHead)->ppPrev = &(pTimer->pNext);
+	}
+
+	*ppHead = pTimer;
+}
+
+static void vidSWTIMER_Unlink(SWTIMER_Timer* pTimer)
+{
+	u32 u32Slot = pTimer->Expiry & SWTIMER_SLOT_MASK;
+
+	*(pTimer->ppPrev) = pTimer->pNext;
+
+	if(pTimer->pNext != 0)
+	{
+		pTimer->pNext->ppPrev = pTimer->ppPrev;
+	}
+	//Only Timer of its Level 0 Slot
+	else if(pTimer->ppPrev == &SWTIMER_Wheel[0][u32Slot])
+	{
+		SWTIMER_Level0 &= ~SWTIMER_SLOT_BIT(u32Slot);
+	}
+
+	pTimer->pNext  = 0;
+	pTimer->ppPrev = 0;
+}
+
+//Select the Level from the distance to Expiry, the Slot from the Expiry bits of that Level
+static void vidSWTIMER_Place(SWTIMER_Timer* pTimer)
+{
+	u32 u32Delta = pTimer->Expiry - SWTIMER_Now;
+	u32 u32Slot;
+	u8  u8Level  = 0;
+
+	//Already due (Expiry in the past), process on the next Tick
+	if((s32)u32Delta < 0)
+	{
+		pTimer->Expiry = SWTIMER_Now;
+		u32Delta = 0;
+	}
+
+	while((u8Level < (SWTIMER_LEVELS - 1U)) && (u32Delta >= (1UL << (SWTIMER_LEVEL_BITS * (u8Level + 1U)))))
+	{
+		u8Level++;
+	}
+
+	u32Slot = (pTimer->Expiry >> (SWTIMER_LEVEL_BITS * u8Level)) & SWTIMER_SLOT_MASK;
+	vidSWTIMER_Link(&SWTIMER_Wheel[u8Level][u32Slot], pTimer);
+
+	if(u8Level == 0)
+	{
+		SWTIMER_Level0 |= SWTIMER_SLOT_BIT(u32Slot);
+	}
+}
+
+//Move every Timer in one Slot of an upper Level down to the lower Levels
+static void vidSWTIMER_Cascade(u8 u8Level, u32 u32Slot)
+{
+	SWTIMER_Timer* pTimer = SWTIMER_Wheel[u8Level][u32Slot];
+	SWTIMER_Timer* pNext;
+
+	SWTIMER_Wheel[u8Level][u32Slot] = 0;
+
+	while(pTimer != 0)
+	{
+		pNext = pTimer->pNext;
+		vidSWTIMER_Place(pTimer);
+		pTimer = pNext;
+	}
+}
+
+/*
+ * Arm the Driver at the nearest non empty Level 0 Slot, or at the next Level 0 wrap
+ * (Cascade) if there is none, so SysTick isn't needed on every Tick while Timers are Active
+ */
+static void vidSWTIMER_Arm(void)
+{
+	u64 u64Pending;
+	u32 u32Next;
+	s32 s32Delay;
+
+	if(SWTIMER_Count == 0)
+	{
+		vidSYSTICK_TimerStop(&SWTIMER_Driver);
+		return;
+	}
+
+	//Cascade of Slot 0 is processed with the Tick itself
+	u32Next = ((SWTIMER_Now & SWTIMER_SLOT_MASK) == 0) ? SWTIMER_Now : ((SWTIMER_Now | SWTIMER_SLOT_MASK) + 1U);
+
+	//Non empty Slots from the current one to the end of Level 0
+	u64Pending = SWTIMER_Level0 & (~0ULL >> (SWTIMER_Now & SWTIMER_SLOT_MASK));
+
+	if((u32Next != SWTIMER_Now) && (u64Pending != 0))
+	{
+		u32Next = (SWTIMER_Now & ~SWTIMER_SLOT_MASK) + (u32)__builtin_clzll(u64Pending);
+	}
+
+	s32Delay = (s32)(u32Next - (u32)u64SYSTICK_GetTicks());
+
+	xSYSTICK_TimerStart(&SWTIMER_Driver, (s32Delay > 0) ? (u32)s32Delay : 1U, 0, vidSWTIMER_Tick, 0);
+}
+
+//Process Wheel Tick SWTIMER_Now
+RAM_FUNC static void vidSWTIMER_Process(void)
+{
+	SWTIMER_Timer* pTimer;
+	u32 u32Slot = SWTIMER_Now & SWTIMER_SLOT_MASK;
+	u8  u8Level;
+
+	//Level 0 wrapped, refill it from the upper Levels
+	for(u8Level = 1; (u8Level < SWTIMER_LEVELS) && (u32Slot == 0); u8Level++)
+	{
+		u32Slot = (SWTIMER_Now >> (SWTIMER_LEVEL_BITS * u8Level)) & SWTIMER_SLOT_MASK;
+		vidSWTIMER_Cascade(u8Level, u32Slot);
+	}
+
+	u32Slot = SWTIMER_Now & SWTIMER_SLOT_MASK;
+
+	//Every Timer in the current Level 0 Slot expires now
+	SWTIMER_Expired = SWTIMER_Wheel[0][u32Slot];
+	SWTIMER_Wheel[0][u32Slot] = 0;
+	SWTIMER_Level0 &= ~SWTIMER_SLOT_BIT(u32Slot);
+
+	if(SWTIMER_Expired != 0)
+	{
+		SWTIMER_Expired->ppPrev = &SWTIMER_Expired;
+	}
+
+	//Timers restarted or re-armed from here on land in later Ticks
+	SWTIMER_Now++;
+
+	while((pTimer = SWTIMER_Expired) != 0)
+	{
+		vidSWTIMER_Unlink(pTimer);
+
+		if(pTimer->Period != 0)
+		{
+			pTimer->Expiry += pTimer->Period;
+			vidSWTIMER_Place(pTimer);
+		}
+		else
+		{
+			pTimer->Active = 0;
+			SWTIMER_Count--;
+		}
+
+		if(pTimer->pfCallback != 0)
+		{
+			pTimer->pfCallback(pTimer->pArg);
+		}
+	}
+}
+
+//Driver Callback, catch up with every Wheel Tick up to the current SysTick Tick
+RAM_FUNC static void vidSWTIMER_Tick(void* pArg)
+{
+	u32 u32Current = (u32)u64SYSTICK_GetTicks();
+
+	(void)pArg;
+
+	while((SWTIMER_Count != 0) && ((s32)(u32Current - SWTIMER_Now) >= 0))
+	{
+		vidSWTIMER_Process();
+	}
+
+	vidSWTIMER_Arm();
+}
+
+void vidSWTIMER_Init(void)
+{
+	u8  u8Level;
+	u32 u32Slot;
+
+	vidSYSTICK_TimerStop(&SWTIMER_Driver);
+
+	for(u8Level = 0; u8Level < SWTIMER_LEVELS; u8Level++)
+	{
+		for(u32Slot = 0; u32Slot < SWTIMER_SLOTS; u32Slot++)
+		{
+			SWTIMER_Wheel[u8Level][u32Slot] = 0;
+		}
+	}
+
+	SWTIMER_Level0  = 0;
+	SWTIMER_Now     = (u32)u64SYSTICK_GetTicks() + 1U;
+	SWTIMER_Expired = 0;
+	SWTIMER_Count   = 0;
+}
+
+Return_status xSWTIMER_Start(SWTIMER_Timer* pTimer, u32 u32Delay, u32 u32Period, SWTIMER_Callback pfCallback, void* pArg)
+{
+	u32 u32State;
+	u32 u32Current;
+
+	if(pTimer == 0)
+	{
+		return NULLPOINTER;
+	}
+
+	if(u32Delay == 0)
+	{
+		u32Delay = 1;
+	}
+
+	if(u32Delay > SWTIMER_MAX_DELAY)
+	{
+		u32Delay = SWTIMER_MAX_DELAY;
+	}
+
+	if(u32Period > SWTIMER_MAX_DELAY)
+	{
+		return OUTOFRANGE;
+	}
+
+	u32State = u32SYSTICK_EnterCritical();
+
+	if(pTimer->Active != 0)
+	{
+		vidSWTIMER_Unlink(pTimer);
+		SWTIMER_Count--;
+	}
+
+	u32Current = (u32)u64SYSTICK_GetTicks();
+
+	//Empty Wheel doesn't follow SysTick, restart it from the current Tick
+	if(SWTIMER_Count == 0)
+	{
+		SWTIMER_Now = u32Current + 1U;
+	}
+
+	pTimer->Expiry     = u32Current + u32Delay;
+	pTimer->Period     = u32Period;
+	pTimer->pfCallback = pfCallback;
+	pTimer->pArg       = pArg;
+	pTimer->Active     = 1;
+	vidSWTIMER_Place(pTimer);
+	SWTIMER_Count++;
+
+	vidSWTIMER_Arm();
+
+	vidSYSTICK_ExitCritical(u32State);
+
+	return OK;
+}
+
+void vidSWTIMER_Stop(SWTIMER_Timer* pTimer)
+{
+	u32 u32State;
+
+	if(pTimer == 0)
+	{
+		return;
+	}
+
+	u32State = u32SYSTICK_EnterCritical();
+
+	if(pTimer->Active != 0)
+	{
+		vidSWTIMER_Unlink(pTimer);
+		pTimer->Active = 0;
+
+		if(--SWTIMER_Count == 0)
+		{
+			vidSYSTICK_TimerStop(&SWTIMER_Driver);
+		}
+	}
+
+	vidSYSTICK_ExitCritical(u32State);
+}
+
+u8 u8SWTIMER_IsActive(const SWTIMER_Timer* pTimer)
+{
+	return ((pTimer != 0) && (pTimer->Active != 0)) ? 1 : 0;
+}
+
+u32 u32SWTIMER_GetCount(void)
+{
+	return SWTIMER_Count;
+}
@@ -8,9 +8,41 @@
 #ifndef SYSTICK_INIT_H_
 #define SYSTICK_INIT_H_
 
+//Software Timer Callback, called from SysTick_Handler context
+typedef void (*SYSTICK_TimerCallback)(void* pArg);
+
+//Software Timer, allocated by the caller and linked in a list sorted by Deadline
+//Start is O(n) in the number of Active Timers, use SWTIMER for many Timers
+typedef struct SYSTICK_Timer{
+	struct SYSTICK_Timer*	pNext;
+	u64						Deadline;		//Absolute Tick of next expiry
+	u32						Period;			//0 -> One Shot, else Reload in Ticks
+	SYSTICK_TimerCallback	pfCallback;
+	void*					pArg;
+	volatile u8				Active;
+}SYSTICK_Timer;
+
+//Idle Statistics collected by vidSYSTICK_Idle
+typedef struct{
+	u32		Wakeups;		//Number of times the core left WFI
+	u64		IdleTicks;		//Ticks spent inside WFI
+	u64		TotalTicks;		//Ticks since vidSYSTICK_Init
+}SYSTICK_IdleStats;
+
 //void SysTick_Handler1(void);
 void vidSysTick_Reset(void);
 void _delay_ms(u32 u32Delay);
 void vidSYSTICK_Init(u32 u32Load);
 
+u64 u64SYSTICK_GetTicks(void);
+
+Return_status xSYSTICK_TimerStart(SYSTICK_Timer* pTimer, u32 u32Delay, u32 u32Period, SYSTICK_TimerCallback pfCallback, void* pArg);
+void vidSYSTICK_TimerStop(SYSTICK_Timer* pTimer);
+
+void vidSYSTICK_Idle(void);
+void vidSYSTICK_GetIdleStats(SYSTICK_IdleStats* pStats);
+
+u32  u32SYSTICK_EnterCritical(void);
+void vidSYSTICK_ExitCritical(u32 u32State);
+
 #endif /* SYSTICK_INIT_H_ */
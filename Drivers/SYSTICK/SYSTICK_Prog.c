@@ -9,8 +9,98 @@
 
 #include "SYSTICK_Init.h"
 #include "SYSTICK_Reg.h"
+#include "MEM_SECTIONS.h"
 
-volatile u32 DELAY_X;
+//Include RCC Files to follow HCLK changes
+#include "RCC_Init.h"
+
+//Monotonic Tick Counter, one Tick = (SYSTICK_Reload + 1) Core Cycles
+CCM_BSS static volatile u64 SYSTICK_Ticks;
+
+//STK_LOAD Value of one Tick as given to vidSYSTICK_Init
+static u32 SYSTICK_Reload;
+
+/*
+ * Active Timers sorted by Deadline, Head expires first
+ * Insert & Remove walk the List (O(n)), it is meant for a few Timers only:
+ * the SWTIMER Wheel Driver and _delay_ms. Large numbers of Timers go to
+ * the SWTIMER Wheel (O(1) Start/Stop) that keeps one Timer here.
+ */
+CCM_BSS static SYSTICK_Timer* SYSTICK_TimerList;
+
+CCM_BSS static SYSTICK_IdleStats SYSTICK_Stats;
+
+u32 u32SYSTICK_EnterCritical(void)
+{
+	u32 u32State;
+
+	STK_DISABLE_IRQ(u32State);
+
+	return u32State;
+}
+
+void vidSYSTICK_ExitCritical(u32 u32State)
+{
+	STK_RESTORE_IRQ(u32State);
+}
+
+//Insert Timer after all Timers with the same or earlier Deadline (keeps FIFO order)
+RAM_FUNC static void vidSYSTICK_TimerInsert(SYSTICK_Timer* pTimer)
+{
+	SYSTICK_Timer** ppNode = &SYSTICK_TimerList;
+
+	while((*ppNode != 0) && ((*ppNode)->Deadline <= pTimer->Deadline))
+	{
+		ppNode = &((*ppNode)->pNext);
+	}
+
+	pTimer->pNext = *ppNode;
+	*ppNode       = pTimer;
+	pTimer->Active = 1;
+}
+
+static void vidSYSTICK_TimerRemove(SYSTICK_Timer* pTimer)
+{
+	SYSTICK_Timer** ppNode = &SYSTICK_TimerList;
+
+	while(*ppNode != 0)
+	{
+		if(*ppNode == pTimer)
+		{
+			*ppNode = pTimer->pNext;
+			break;
+		}
+		ppNode = &((*ppNode)->pNext);
+	}
+
+	pTimer->pNext  = 0;
+	pTimer->Active = 0;
+}
+
+//RCC Subscriber, SysTick runs from HCLK so the Reload is scaled to keep the Tick Period
+static void vidSYSTICK_ClockChanged(const RCC_clockValues* OldClocks, const RCC_clockValues* NewClocks)
+{
+	u64 u64Period;
+	u32 u32State;
+
+	if((OldClocks -> HCLKFrequency == NewClocks -> HCLKFrequency) || (OldClocks -> HCLKFrequency == 0) || (SYSTICK_Reload == 0))
+	{
+		return;
+	}
+
+	u64Period = (((u64)SYSTICK_Reload + 1) * NewClocks -> HCLKFrequency) / OldClocks -> HCLKFrequency;
+
+	if((u64Period < 2) || ((u64Period - 1) > STK_MAX_LOAD))
+	{
+		return;
+	}
+
+	//New Reload is used from the next Tick
+	u32State = u32SYSTICK_EnterCritical();
+	SYSTICK_Reload = (u32)(u64Period - 1);
+	STK_LOAD = SYSTICK_Reload;
+	vidSYSTICK_ExitCritical(u32State);
+}
 
 void vidSysTick_Reset(void)
 {
@@ -19,28 +109,265 @@ void vidSysTick_Reset(void)
 	STK_VAL = 0;
 }
 
-void SysTick_Handler (void)
+RAM_FUNC void SysTick_Handler (void)
 {
-	if(DELAY_X != 0)
+	SYSTICK_Timer* pTimer;
+
+	SYSTICK_Ticks++;
+
+	while((SYSTICK_TimerList != 0) && (SYSTICK_TimerList->Deadline <= SYSTICK_Ticks))
 	{
-		DELAY_X--;
+		pTimer            = SYSTICK_TimerList;
+		SYSTICK_TimerList = pTimer->pNext;
+		pTimer->pNext     = 0;
+
+		//Re-arm Periodic Timer before Callback so it can stop itself
+		if(pTimer->Period != 0)
+		{
+			pTimer->Deadline += pTimer->Period;
+			vidSYSTICK_TimerInsert(pTimer);
+		}
+		else
+		{
+			pTimer->Active = 0;
+		}
+
+		if(pTimer->pfCallback != 0)
+		{
+			pTimer->pfCallback(pTimer->pArg);
+		}
 	}
 }
 
 void _delay_ms(u32 u32Delay)
 {
-	DELAY_X = u32Delay;
-	while(DELAY_X !=0);
+	SYSTICK_Timer Delay;
+
+	if(u32Delay == 0)
+	{
+		return;
+	}
+
+	//Timer without Callback, only used to bound the Tickless Sleep
+	Delay.Active = 0;
+	xSYSTICK_TimerStart(&Delay, u32Delay, 0, 0, 0);
+
+	while(Delay.Active != 0)
+	{
+		vidSYSTICK_Idle();
+	}
 }
 
 void vidSYSTICK_Init(u32 u32Load)
 {
-	if(u32Load <=0 || u32Load > 0x00FFFFFF)
+	if(u32Load <=0 || u32Load > STK_MAX_LOAD)
 	{
 		//Do Nothing
+		return;
 	}
 
+	SYSTICK_Reload = u32Load;
+
 	STK_LOAD = u32Load;
 	STK_VAL  = 0x00;
-	STK_CTRL = 0x00000007;
+	STK_CTRL = STK_CTRL_CLKSOURCE | STK_CTRL_TICKINT | STK_CTRL_ENABLE;
+
+	xRCC_subscribe(vidSYSTICK_ClockChanged);
+}
+
+u64 u64SYSTICK_GetTicks(void)
+{
+	u64 u64Ticks;
+	u32 u32State;
+
+	//64 bit Read isn't atomic on Cortex-M4
+	u32State = u32SYSTICK_EnterCritical();
+	u64Ticks = SYSTICK_Ticks;
+	vidSYSTICK_ExitCritical(u32State);
+
+	return u64Ticks;
+}
+
+Return_status xSYSTICK_TimerStart(SYSTICK_Timer* pTimer, u32 u32Delay, u32 u32Period, SYSTICK_TimerCallback pfCallback, void* pArg)
+{
+	u32 u32State;
+
+	if(pTimer == 0)
+	{
+		return NULLPOINTER;
+	}
+
+	u32State = u32SYSTICK_EnterCritical();
+
+	if(pTimer->Active != 0)
+	{
+		vidSYSTICK_TimerRemove(pTimer);
+	}
+
+	pTimer->Deadline   = SYSTICK_Ticks + u32Delay;
+	pTimer->Period     = u32Period;
+	pTimer->pfCallback = pfCallback;
+	pTimer->pArg       = pArg;
+	vidSYSTICK_TimerInsert(pTimer);
+
+	vidSYSTICK_ExitCritical(u32State);
+
+	return OK;
+}
+
+void vidSYSTICK_TimerStop(SYSTICK_Timer* pTimer)
+{
+	u32 u32State;
+
+	if(pTimer == 0)
+	{
+		return;
+	}
+
+	u32State = u32SYSTICK_EnterCritical();
+
+	if(pTimer->Active != 0)
+	{
+		vidSYSTICK_TimerRemove(pTimer);
+	}
+
+	vidSYSTICK_ExitCritical(u32State);
+}
+
+//Sleep until the next Timer Deadline (or any other Interrupt).
+//When the Deadline is more than one Tick away the Counter is left running: the current Tick
+//ends as usual, then the next Reload counts all the Ticks up to the Deadline at once.
+//The Counter is never stopped so the Tick phase isn't lost, only a wakeup in the middle
+//of the long Reload restarts it (STK_RESYNC_CYCLES compensates the restart).
+void vidSYSTICK_Idle(void)
+{
+	u32 u32State;
+	u32 u32Period;
+	u32 u32Sleep;
+	u32 u32Val;
+	u32 u32Elapsed;
+	u32 u32Next;
+	u32 u32Done;
+	u8  u8Early;
+
+	u32State  = u32SYSTICK_EnterCritical();
+
+	u32Period = SYSTICK_Reload + 1;
+	u32Sleep  = STK_MAX_LOAD / u32Period;
+
+	if(SYSTICK_TimerList != 0)
+	{
+		if(SYSTICK_TimerList->Deadline <= (SYSTICK_Ticks + 1))
+		{
+			u32Sleep = 1;
+		}
+		else if((SYSTICK_TimerList->Deadline - SYSTICK_Ticks) < u32Sleep)
+		{
+			u32Sleep = (u32)(SYSTICK_TimerList->Deadline - SYSTICK_Ticks);
+		}
+	}
+
+	//Current Tick ended or about to end, the new LOAD could miss its Reload
+	if((u32Sleep > 1) && (((SCB_ICSR & SCB_ICSR_PENDSTSET) != 0) || (STK_VAL < STK_GUARD_CYCLES)))
+	{
+		u32Sleep = 1;
+	}
+
+	if(u32Sleep > 1)
+	{
+		//Loaded at the end of the current Tick
+		STK_LOAD = ((u32Sleep - 1) * u32Period) - 1;
+
+		STK_WFI();
+
+		u8Early = 0;
+		if((SCB_ICSR & SCB_ICSR_PENDSTSET) == 0)
+		{
+			//Woken early by another Interrupt, still in the current Tick
+			if(STK_VAL >= STK_GUARD_CYCLES)
+			{
+				STK_LOAD = SYSTICK_Reload;
+				u32Sleep = 0;
+			}
+			else
+			{
+				//Too late to undo the LOAD, let the Tick end first
+				while((SCB_ICSR & SCB_ICSR_PENDSTSET) == 0)
+				{
+				}
+				u8Early = 1;
+			}
+		}
+
+		if(u32Sleep != 0)
+		{
+			//Current Tick ended, count it here & use the normal Period again after the Deadline
+			SCB_ICSR = SCB_ICSR_PENDSTCLR;
+			STK_LOAD = SYSTICK_Reload;
+			SYSTICK_Ticks++;
+			SYSTICK_Stats.IdleTicks++;
+
+			if(u8Early == 0)
+			{
+				STK_WFI();
+				SYSTICK_Stats.Wakeups++;
+			}
+
+			if((SCB_ICSR & SCB_ICSR_PENDSTSET) != 0)
+			{
+				//Slept until the Deadline, pending SysTick counts the last Tick
+				u32Done = u32Sleep - 2;
+			}
+			else
+			{
+				//Woken early by another Interrupt during the long Reload
+				u32Val     = STK_VAL;
+				u32Elapsed = ((u32Sleep - 1) * u32Period) - u32Val;
+				u32Done    = u32Elapsed / u32Period;
+
+				//Restart the Counter to end at the next Tick, unless that Tick is the Deadline
+				if(u32Val > u32Period)
+				{
+					u32Next = u32Period - (u32Elapsed % u32Period);
+					if(u32Next < STK_GUARD_CYCLES)
+					{
+						u32Done++;
+						u32Next += u32Period;
+					}
+
+					//Cycles spent since u32Val was read are taken from the second Read
+					STK_LOAD = u32Next - (u32Val - STK_VAL) - (STK_RESYNC_CYCLES + 1);
+					STK_VAL  = 0;
+					STK_LOAD = SYSTICK_Reload;
+				}
+			}
+
+			SYSTICK_Ticks += u32Done;
+			SYSTICK_Stats.IdleTicks += u32Done;
+		}
+	}
+	else
+	{
+		STK_WFI();
+	}
+
+	SYSTICK_Stats.Wakeups++;
+
+	//Pending Interrupts (SysTick included) run here
+	vidSYSTICK_ExitCritical(u32State);
+}
+
+void vidSYSTICK_GetIdleStats(SYSTICK_IdleStats* pStats)
+{
+	u32 u32State;
+
+	if(pStats == 0)
+	{
+		return;
+	}
+
+	u32State = u32SYSTICK_EnterCritical();
+	*pStats  = SYSTICK_Stats;
+	pStats->TotalTicks = SYSTICK_Ticks;
+	vidSYSTICK_ExitCritical(u32State);
 }
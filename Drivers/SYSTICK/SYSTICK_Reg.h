@@ -12,4 +12,27 @@
 #define STK_LOAD		*((volatile u32*) 0xE000E014)		//Reload Value Register
 #define STK_VAL			*((volatile u32*) 0xE000E018)		//Current Value Register
 #define STK_CALIB		*((volatile u32*) 0xE000E01C)		//Calibration Value Register
+
+//STK_CTRL Bits
+#define STK_CTRL_ENABLE		(0x00000001U)
+#define STK_CTRL_TICKINT	(0x00000002U)
+#define STK_CTRL_CLKSOURCE	(0x00000004U)
+#define STK_CTRL_COUNTFLAG	(0x00010000U)
+
+#define STK_MAX_LOAD		(0x00FFFFFFU)					//Counter is 24 bit
+
+#define SCB_ICSR		*((volatile u32*) 0xE000ED04)		//Interrupt Control & State Register
+#define SCB_ICSR_PENDSTSET	(0x04000000U)					//SysTick Exception is Pending
+#define SCB_ICSR_PENDSTCLR	(0x02000000U)					//Write 1 to clear a Pending SysTick
+
+//Tickless Idle timing, in Core Cycles
+#define STK_GUARD_CYCLES	(64U)							//Closest to a Reload a new LOAD is written
+#define STK_RESYNC_CYCLES	(4U)							//From the STK_VAL Read to the STK_VAL Write that restarts the Counter
+
+//Core Instructions used by the Driver, a host build (tools/host/systick_test.c) replaces them
+#ifndef STK_DISABLE_IRQ
+#define STK_DISABLE_IRQ(u32State)	__asm volatile ("MRS %0, PRIMASK\n\tCPSID I" : "=r" (u32State) :: "memory")
+#define STK_RESTORE_IRQ(u32State)	__asm volatile ("MSR PRIMASK, %0" :: "r" (u32State) : "memory")
+#define STK_WFI()					__asm volatile ("DSB\n\tWFI\n\tISB" ::: "memory")
+#endif
 #endif /* SYSTICK_REG_H_ */
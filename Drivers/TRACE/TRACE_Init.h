@@ -0,0 +1,88 @@
+/*
+ * TRACE_Init.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ *
+ *  Binary Trace Log, nothing is formatted on target:
+ *  - Format strings live in .trace_fmt (not loaded, kept in the ELF),
+ *    the address of the string is the ID of the log site
+ *  - A Trace Point stores ID, DWT Timestamp & raw 32 bit Args in a RAM ring
+ *  - vidTRACE_Drain sends records as FRAME frames, tools/trace_decode.py
+ *    reads the strings back from the ELF and prints the text
+ *  - Drain runs on demand: the first Record logged while the USART is idle and
+ *    the end of every Frame call the Drain Request Callback, no polling timer
+ *  Only %d %i %u %x %X %c are supported (Args are copied by value)
+ */
+
+#ifndef TRACE_INIT_H_
+#define TRACE_INIT_H_
+
+#include "STD_TYPES_OLD.h"
+#include "USART_Reg.h"
+#include "DMA_Reg.h"
+#include "DMA_Init.h"
+#include "USART_Init.h"
+
+//Set to 0 to compile every Trace Point out
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE			(1U)
+#endif
+
+//Ring Size in 32 bit words (Power of 2)
+#define TRACE_RING_WORDS		(512U)
+#define TRACE_RING_MASK			(TRACE_RING_WORDS - 1U)
+
+#define TRACE_MAX_ARGS			(3U)
+
+//Record = Header | Timestamp | Args, Header = (Format ID << 2) | Number of Args
+#define TRACE_HEADER(id, n)		(((id) << 2) | (n))
+#define TRACE_RECORD_WORDS(h)	(2U + ((h) & 0x3U))
+
+//Frame Payload = Dropped Records Count | Records (Little Endian words)
+#define TRACE_FRAME_PAYLOAD		(240U)
+
+#if (TRACE_ENABLE != 0)
+
+//One format string per call site, placed in .trace_fmt by the compiler
+#define TRACE_ID(fmt)			({ static const char TRACE_Fmt[] __attribute__((section(".trace_fmt"), used)) = (fmt); (u32)TRACE_Fmt; })
+
+#define TRACE0(fmt)				vidTRACE_Log0(TRACE_ID(fmt))
+#define TRACE1(fmt, a)			vidTRACE_Log1(TRACE_ID(fmt), (u32)(a))
+#define TRACE2(fmt, a, b)		vidTRACE_Log2(TRACE_ID(fmt), (u32)(a), (u32)(b))
+#define TRACE3(fmt, a, b, c)	vidTRACE_Log3(TRACE_ID(fmt), (u32)(a), (u32)(b), (u32)(c))
+
+#else
+
+#define TRACE0(fmt)				((void)0)
+#define TRACE1(fmt, a)			((void)0)
+#define TRACE2(fmt, a, b)		((void)0)
+#define TRACE3(fmt, a, b, c)	((void)0)
+
+#endif
+
+typedef struct{
+	u32		Records;
+	u32		Dropped;				//Records lost because the Ring was full
+	u32		Frames;					//Frames handed to the USART
+}TRACE_Stats;
+
+//Asks the application to call vidTRACE_Drain soon (e.g. posts a Scheduler Event)
+typedef void (*TRACE_DrainRequest)(void);
+
+//Safe from any context (Thread or ISR), Records are dropped when the Ring is full
+void vidTRACE_Log0(u32 u32Id);
+void vidTRACE_Log1(u32 u32Id, u32 u32Arg0);
+void vidTRACE_Log2(u32 u32Id, u32 u32Arg0, u32 u32Arg1);
+void vidTRACE_Log3(u32 u32Id, u32 u32Arg0, u32 u32Arg1, u32 u32Arg2);
+
+//USART must have a Tx DMA Stream, Null keeps Records in the Ring only
+//pfRequest is called from any context (Thread or ISR), it should wake the Task calling vidTRACE_Drain
+void vidTRACE_Init(USART_REG* USARTx, TRACE_DrainRequest pfRequest);
+
+//Thread context, sends one Frame if the USART is idle
+void vidTRACE_Drain(void);
+
+Return_status xTRACE_GetStats(TRACE_Stats* Stats);
+
+#endif /* TRACE_INIT_H_ */
@@ -0,0 +1,219 @@
+/*
+ * TRACE_Prog.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ */
+
+#include "STD_TYPES_OLD.h"
+
+#include "SYSTICK_Init.h"
+#include "DWT_Init.h"
+#include "FRAME_Init.h"
+#include "TRACE_Init.h"
+#include "MEM_SECTIONS.h"
+
+//Records as Words (Header, Cycle Count, Arguments), encoded into Frames by vidTRACE_Drain
+CCM_BSS static u32 TRACE_Ring[TRACE_RING_WORDS];
+
+//Free running word Indexes, Head - Tail is the Fill Level
+static volatile u32 TRACE_Head;
+static volatile u32 TRACE_Tail;
+
+static TRACE_Stats TRACE_Statistics;
+
+//Output Frame is read by DMA (not in CCM), always encoded before use so not cleared at boot
+static USART_REG*		TRACE_USART;
+NO_INIT static u8		TRACE_TxFrame[FRAME_ENCODED_SIZE(TRACE_FRAME_PAYLOAD)];
+static USART_TxSegment	TRACE_Segment;
+static volatile u8		TRACE_TxBusy;
+
+//Drain is requested once when Records wait and the USART is free, cleared by vidTRACE_Drain
+static TRACE_DrainRequest	TRACE_pfRequest;
+static volatile u8			TRACE_Requested;
+
+//Ask for a Drain if nothing is being sent and nobody asked yet
+static void vidTRACE_Request(void)
+{
+	u32 u32State = u32SYSTICK_EnterCritical();
+	u8  u8Call	 = (0 != TRACE_pfRequest) && (0 == TRACE_Requested) && (0 == TRACE_TxBusy) && (TRACE_Head != TRACE_Tail);
+
+	if(u8Call != 0)
+	{
+		TRACE_Requested = 1;
+	}
+
+	vidSYSTICK_ExitCritical(u32State);
+
+	if(u8Call != 0)
+	{
+		TRACE_pfRequest();
+	}
+}
+
+//Reserve, Fill & Publish one Record, Interrupts are masked for a few cycles only
+RAM_FUNC static inline void vidTRACE_Put(u32 u32Header, u32 u32Arg0, u32 u32Arg1, u32 u32Arg2)
+{
+	u32 u32State = u32SYSTICK_EnterCritical();
+	u32 u32Head  = TRACE_Head;
+	u8  u8Call	 = 0;
+
+	//Room for the longest Record is required as all Args words are always written
+	if((u32Head - TRACE_Tail + 2U + TRACE_MAX_ARGS) > TRACE_RING_WORDS)
+	{
+		TRACE_Statistics.Dropped++;
+	}
+	else
+	{
+		TRACE_Ring[u32Head & TRACE_RING_MASK]		  = u32Header;
+		TRACE_Ring[(u32Head + 1U) & TRACE_RING_MASK] = u32DWT_GetCycles();
+
+		//Unused Args are written past the Record, the next Record overwrites them
+		TRACE_Ring[(u32Head + 2U) & TRACE_RING_MASK] = u32Arg0;
+		TRACE_Ring[(u32Head + 3U) & TRACE_RING_MASK] = u32Arg1;
+		TRACE_Ring[(u32Head + 4U) & TRACE_RING_MASK] = u32Arg2;
+
+		TRACE_Head = u32Head + TRACE_RECORD_WORDS(u32Header);
+		TRACE_Statistics.Records++;
+
+		//First Record while idle asks for a Drain, the others ride on it
+		u8Call = (0 != TRACE_pfRequest) && (0 == TRACE_Requested) && (0 == TRACE_TxBusy);
+
+		if(u8Call != 0)
+		{
+			TRACE_Requested = 1;
+		}
+	}
+
+	vidSYSTICK_ExitCritical(u32State);
+
+	if(u8Call != 0)
+	{
+		TRACE_pfRequest();
+	}
+}
+
+RAM_FUNC void vidTRACE_Log0(u32 u32Id)
+{
+	vidTRACE_Put(TRACE_HEADER(u32Id, 0U), 0, 0, 0);
+}
+
+RAM_FUNC void vidTRACE_Log1(u32 u32Id, u32 u32Arg0)
+{
+	vidTRACE_Put(TRACE_HEADER(u32Id, 1U), u32Arg0, 0, 0);
+}
+
+RAM_FUNC void vidTRACE_Log2(u32 u32Id, u32 u32Arg0, u32 u32Arg1)
+{
+	vidTRACE_Put(TRACE_HEADER(u32Id, 2U), u32Arg0, u32Arg1, 0);
+}
+
+RAM_FUNC void vidTRACE_Log3(u32 u32Id, u32 u32Arg0, u32 u32Arg1, u32 u32Arg2)
+{
+	vidTRACE_Put(TRACE_HEADER(u32Id, 3U), u32Arg0, u32Arg1, u32Arg2);
+}
+
+//Called from USART ISR Context, Records logged meanwhile need the next Frame
+static void vidTRACE_TxDone(USART_REG* USARTx)
+{
+	(void)USARTx;
+
+	TRACE_TxBusy = 0;
+
+	vidTRACE_Request();
+}
+
+//Called from USART ISR Context when another DMA user of the USART is done
+static void vidTRACE_TxIdle(USART_REG* USARTx)
+{
+	(void)USARTx;
+
+	vidTRACE_Request();
+}
+
+//Ring isn't cleared, Records logged before the USART is ready are sent on the first Drain
+void vidTRACE_Init(USART_REG* USARTx, TRACE_DrainRequest pfRequest)
+{
+	TRACE_USART		= USARTx;
+	TRACE_TxBusy	= 0;
+	TRACE_Requested	= 0;
+	TRACE_pfRequest	= pfRequest;
+
+	if(0 != USARTx)
+	{
+		xUSART_SetTxIdleCallback(USARTx, vidTRACE_TxIdle);
+	}
+
+	vidTRACE_Request();
+}
+
+void vidTRACE_Drain(void)
+{
+	FRAME_Encoder Encoder;
+	u32 u32Tail  = TRACE_Tail;
+	u32 u32Head  = TRACE_Head;
+	u32 u32Size  = 0;
+	u32 u32Words = 0;
+	u32 u32Index = 0;
+	u32 u32Word	 = 0;
+
+	//Records logged from now on ask again
+	TRACE_Requested = 0;
+
+	if((0 == TRACE_USART) || (TRACE_TxBusy != 0) || (u32Head == u32Tail) || (u8USART_TxBusy(TRACE_USART) != 0))
+	{
+		return;
+	}
+
+	vidFRAME_EncodeStart(&Encoder, TRACE_TxFrame, sizeof(TRACE_TxFrame));
+
+	u32Word = TRACE_Statistics.Dropped;
+	xFRAME_EncodeAppend(&Encoder, (const u8*)&u32Word, 4);
+	u32Size = 4;
+
+	//Whole Records only, Ring can't be overwritten before Tail moves
+	while(u32Tail != u32Head)
+	{
+		u32Words = TRACE_RECORD_WORDS(TRACE_Ring[u32Tail & TRACE_RING_MASK]);
+
+		if((u32Size + (u32Words * 4U)) > TRACE_FRAME_PAYLOAD)
+		{
+			break;
+		}
+
+		for(u32Index = 0; u32Index < u32Words; u32Index++)
+		{
+			u32Word = TRACE_Ring[(u32Tail + u32Index) & TRACE_RING_MASK];
+			xFRAME_EncodeAppend(&Encoder, (const u8*)&u32Word, 4);
+		}
+
+		u32Tail += u32Words;
+		u32Size += u32Words * 4U;
+	}
+
+	TRACE_Segment.pData = TRACE_TxFrame;
+	TRACE_Segment.Size	= u16FRAME_EncodeFinish(&Encoder);
+	TRACE_TxBusy		= 1;
+
+	if(xUSART_SendSegments_DMA(TRACE_USART, &TRACE_Segment, 1, vidTRACE_TxDone) != OK)
+	{
+		//Records stay in the Ring for the next Drain
+		TRACE_TxBusy = 0;
+		return;
+	}
+
+	TRACE_Tail = u32Tail;
+	TRACE_Statistics.Frames++;
+}
+
+Return_status xTRACE_GetStats(TRACE_Stats* Stats)
+{
+	if(0 == Stats)
+	{
+		return NULLPOINTER;
+	}
+
+	*Stats = TRACE_Statistics;
+
+	return OK;
+}
@@ -13,13 +13,24 @@
 */
 
 
-//On 90MHz Clk
+//Bit Rates in bits/s, BRR is derived from APB clock by xUSART_SetBaudRate
 typedef enum{
-	 BR9600   = 0x249F,
-	 BR38400  = 0x928,
-	 BR115200 = 0x30D
+	 BR9600    = 9600,
+	 BR38400   = 38400,
+	 BR115200  = 115200,
+	 BR230400  = 230400,
+	 BR460800  = 460800,
+	 BR921600  = 921600,
+	 BR2000000 = 2000000,
+	 BR10500000= 10500000		//Max on APB2 = 84MHz with OVER8
 }BaudRate_Enum;
 
+//Number of USART/UART instances on STM32F429 (USART1 -> UART8)
+#define USART_INSTANCES_NUM		(8U)
+
+//Used to mark pointer that isn't a USART Base Address
+#define USART_INVALID_INDEX		(0xFFU)
+
 typedef enum{
 	Data_Bits_8,
 	Data_Bits_9 = 0x1000
@@ -62,10 +73,31 @@ enum USART_NUM{
 
 
 
+//One Segment of a Scatter-Gather Transmission (like iovec)
+typedef struct{
+	const u8*		pData;
+	u16				Size;
+}USART_TxSegment;
+
+//Diagnostics of every USART instance (Read by xUSART_GetStats)
+typedef struct{
+	u32				TxBytes;			//Bytes sent through Queue, DMA & String APIs
+	u32				RxBytes;			//Bytes received by Rx Interrupt
+	u32				RxDropped;			//Bytes lost because Rx Queue was full
+	u32				OverrunErrors;
+	u32				FramingErrors;
+	u32				ParityErrors;
+	u32				NoiseErrors;
+	u32				TxBytesPerSecond;	//Updated by vidUSART_StatsTick
+	u32				RxBytesPerSecond;
+	u16				TxHighWater;		//Max bytes waited in Tx Queue
+	u16				RxHighWater;		//Max bytes waited in Rx Queue
+}USART_Stats;
+
 typedef struct{
 	u16				Parity;
-	u16 			OverSampling;
-	u32 			BaudRate;
+	u16 			OverSampling;		//NO (16x) or OVER8 (8x), Bit Rate must be <= PCLK / 16 or PCLK / 8
+	u32 			BaudRate;			//In bits/s (BRR is calculated from PCLK1/PCLK2)
 	WordLength_Enum	WordLength;
 	StopBit_Enum	StopBit;
 	Mode_enum		Mode;
@@ -177,14 +209,39 @@ typedef struct{
 	volatile u32 GTPR;				//Guard Time and prescaler Register							0x18
 }USART_REG;
 
+//Called from USART ISR Context (TC) when the last Segment byte is sent, From DMA ISR on Transfer Error
+typedef void (*USART_TxCallback)(USART_REG* USARTx);
+
 
-void vidUSART_Init(USART_REG* USARTx, USART_Config* Config);
+Return_status xUSART_Init(USART_REG* USARTx, USART_Config* Config);
 
 void vidUSART_SendChar(USART_REG* USARTx, u8 u8Char);
 void vidUSART_SendString(USART_REG* USARTx, u8* u8Str, u8 u8Size);
 void vidUSART_Receive(USART_REG* USARTx, USART_Config* Config, u8 *pData, u16 Size);
 
 void vidUSART_InitReg(USART_REG* USARTx);
+Return_status xUSART_SetBaudRate(USART_REG* USARTx, u32 u32BaudRate);
+u32 u32USART_GetBaudRate(USART_REG* USARTx);
+void vidUSART_UpdateBaudRates(void);
+
+void vidUSART_SendSegments(USART_REG* USARTx, const USART_TxSegment* Segments, u8 u8Count);
+Return_status xUSART_SendSegments_DMA(USART_REG* USARTx, const USART_TxSegment* Segments, u8 u8Count, USART_TxCallback pfCallback);
+Return_status xUSART_SetTxIdleCallback(USART_REG* USARTx, USART_TxCallback pfCallback);
+u8 u8USART_TxBusy(USART_REG* USARTx);
+
+Return_status xUSART_AttachBuffers(USART_REG* USARTx, u8* pTxBuffer, u16 u16TxSize, u8* pRxBuffer, u16 u16RxSize);
+u16 u16USART_Write(USART_REG* USARTx, const u8* pData, u16 u16Size);
+u16 u16USART_Read(USART_REG* USARTx, u8* pData, u16 u16Size);
+u16 u16USART_RxAvailable(USART_REG* USARTx);
+u16 u16USART_TxFree(USART_REG* USARTx);
+
+Return_status xUSART_StartRxRing_DMA(USART_REG* USARTx, u8* pBuffer, u16 u16Size);
+u16 u16USART_RxRingGet(USART_REG* USARTx, const u8** ppData);
+void vidUSART_RxRingConsume(USART_REG* USARTx, u16 u16Count);
+
+Return_status xUSART_GetStats(USART_REG* USARTx, USART_Stats* Stats);
+void vidUSART_ResetStats(USART_REG* USARTx);
+void vidUSART_StatsTick(u32 u32ElapsedMs);
 u8 u8USART_Receive_DMA(USART_REG* USARTx,DMA_Stream* DMA_SNUM, u8* pData, u16 size);
 void vidUSART_Send_DMA(USART_REG* USARTx,DMA_Stream* DMA_SNUM, u8* pData, u16 size);
 
@@ -8,6 +8,7 @@
 
 #include <STD_TYPES_OLD.h>
 #include "BIT_MATH.h"
+#include "MEM_SECTIONS.h"
 #include "USART_Reg.h"
 
 //Include DMA Files to use it
@@ -17,6 +18,141 @@
 
 #include "USART_Init.h"
 
+//Include RCC Files to get PCLK1 & PCLK2 values
+#include "RCC_Init.h"
+
+/*
+ * Baud Rate cache for every USART instance
+ * Used to recalculate BRR when APB Clocks change
+ */
+typedef struct{
+	u32 BaudRate;			//Requested Bit Rate (0 means not configured)
+	u32 ClockFrequency;		//PCLK value used when BRR was calculated
+	u32 ActualBaudRate;		//Bit Rate achieved by BRR value
+	u16 OverSampling;		//Requested OverSampling (0 -> 16x, OVER8 -> 8x)
+}USART_BaudCache;
+
+/*
+ * Tx & Rx DMA Streams of every instance (From DMA Request Mapping Table in RM0090)
+ * UART7 & UART8 are not mapped (DMA Tx & Rx Ring aren't supported on them)
+ * Streams are shared with other requests on other Channels, a Stream enabled
+ * on another Channel isn't taken (UART4 Rx/Tx share DMA1 Stream2/4 with
+ * I2C3 Rx/Tx of stm32f429i_discovery_i2c.c, UART5 Rx shares DMA1 Stream0 with I2C1 Rx)
+ */
+typedef struct{
+	DMA_Main*		DMA_Num;
+	DMA_Stream*		DMA_SNUM;
+	Channel_Enum	Channel;
+	u8				FlagShift;		//Position of Stream Flags in LISR/HISR
+	u8				HighReg;		//1 if Stream Flags are in HISR/HIFCR (Stream4 -> Stream7)
+	u8				IRQNum;			//Stream Position in NVIC
+}USART_DMAMap;
+
+static const USART_DMAMap USART_TxDMA[USART_INSTANCES_NUM] =
+{
+	{DMA2, DMA2_STREAM7, Channel4, STREAM7, 1, 70},		//USART1
+	{DMA1, DMA1_STREAM6, Channel4, STREAM6, 1, 17},		//USART2
+	{DMA1, DMA1_STREAM3, Channel4, STREAM3, 0, 14},		//USART3
+	{DMA1, DMA1_STREAM4, Channel4, STREAM4, 1, 15},		//UART4
+	{DMA1, DMA1_STREAM7, Channel4, STREAM7, 1, 47},		//UART5
+	{DMA2, DMA2_STREAM6, Channel5, STREAM6, 1, 69},		//USART6
+	{0, 0, Channel0, 0, 0, 0},							//UART7
+	{0, 0, Channel0, 0, 0, 0}							//UART8
+};
+
+static const USART_DMAMap USART_RxDMA[USART_INSTANCES_NUM] =
+{
+	{DMA2, DMA2_STREAM5, Channel4, STREAM5, 1, 0},		//USART1
+	{DMA1, DMA1_STREAM5, Channel4, STREAM5, 1, 0},		//USART2
+	{DMA1, DMA1_STREAM1, Channel4, STREAM1, 0, 0},		//USART3
+	{DMA1, DMA1_STREAM2, Channel4, STREAM2, 0, 0},		//UART4
+	{DMA1, DMA1_STREAM0, Channel4, STREAM0, 0, 0},		//UART5
+	{DMA2, DMA2_STREAM1, Channel5, STREAM1, 0, 0},		//USART6
+	{0, 0, Channel0, 0, 0, 0},							//UART7
+	{0, 0, Channel0, 0, 0, 0}							//UART8
+};
+
+//Scatter-Gather Tx state, Segments are sent directly from caller memory (No Copy)
+typedef struct{
+	const USART_TxSegment*	Segments;
+	u8						Count;
+	u8						Index;		//Segment being sent now
+	volatile u8				Busy;
+	USART_TxCallback		pfCallback;
+	USART_TxCallback		pfIdle;		//Producer retrying a Transmission that found Tx busy
+}USART_TxState;
+
+//Single Producer / Single Consumer Byte Queue (One side is the USART ISR)
+typedef struct{
+	u8*				pBuffer;
+	u16				Size;
+	volatile u16	Head;		//Next Write Position
+	volatile u16	Tail;		//Next Read Position
+}USART_Queue;
+
+/*
+ * Driver Context of every USART instance
+ * Holds Tx/Rx Queues, Baud Rate Cache, DMA Tx State & Diagnostics
+ */
+typedef struct{
+	USART_REG*			USARTx;
+	USART_Queue			TxQueue;
+	USART_Queue			RxQueue;
+	USART_BaudCache		Baud;
+	USART_TxState		Tx;
+	USART_Stats			Stats;
+	u32					TxBytesLastTick;	//Used to calculate Bytes/s
+	u32					RxBytesLastTick;
+	u8					RxDMA;				//1 if Rx Queue is filled by circular DMA
+}USART_Context;
+
+//Context of every Instance, in u8USART_GetIndex order
+CCM_DATA static USART_Context USART_Ctx[USART_INSTANCES_NUM] =
+{
+	{USART1}, {USART2}, {USART3}, {UART4}, {UART5}, {USART6}, {UART7}, {UART8}
+};
+
+//USART Global Interrupt Position in NVIC (For USART1 -> UART8)
+static const u8 USART_IRQNum[USART_INSTANCES_NUM] = {37, 38, 39, 52, 53, 71, 82, 83};
+
+//Enable Interrupt Number on NVIC
+static void vidUSART_NVICEnable(u8 u8IRQNum)
+{
+	USART_NVIC_ISER[u8IRQNum >> 5] = (1UL << (u8IRQNum & 0x1F));
+}
+
+static u8 u8USART_GetIndex(USART_REG* USARTx)
+{
+	u8 u8Index = USART_INVALID_INDEX;
+
+	if(USARTx == USART1)		{ u8Index = 0; }
+	else if(USARTx == USART2)	{ u8Index = 1; }
+	else if(USARTx == USART3)	{ u8Index = 2; }
+	else if(USARTx == UART4)	{ u8Index = 3; }
+	else if(USARTx == UART5)	{ u8Index = 4; }
+	else if(USARTx == USART6)	{ u8Index = 5; }
+	else if(USARTx == UART7)	{ u8Index = 6; }
+	else if(USARTx == UART8)	{ u8Index = 7; }
+
+	return u8Index;
+}
+
+//USART1 & USART6 are on APB2, All Others are on APB1
+static u32 u32USART_GetClock(USART_REG* USARTx)
+{
+	return ((USARTx == USART1) || (USARTx == USART6)) ? u32RCC_getPCLK2() : u32RCC_getPCLK1();
+}
+
+//RCC Subscriber, BRR is recalculated only when an APB Clock really changed
+static void vidUSART_ClockChanged(const RCC_clockValues* OldClocks, const RCC_clockValues* NewClocks)
+{
+	if((OldClocks -> PCLK1Frequency != NewClocks -> PCLK1Frequency) ||
+	   (OldClocks -> PCLK2Frequency != NewClocks -> PCLK2Frequency))
+	{
+		vidUSART_UpdateBaudRates();
+	}
+}
+
 //void UART_SetCallback(USART_REG* USARTx, void (*ptr)(void) ){
 //
 //	/* Check for reception flag && reception interrupt enable */
@@ -37,18 +173,34 @@
 //	//if()
 //}
 
-void vidUSART_Init(USART_REG* USARTx, USART_Config* Config)
+/*
+ * Configure & enable USARTx
+ * Returns the BRR calculation status, the USART is left disabled (UE = 0)
+ * when the Bit Rate can't be reached from the APB Clock
+ */
+Return_status xUSART_Init(USART_REG* USARTx, USART_Config* Config)
 {
 	u32 Temp = 0;
+	u8 u8Index = u8USART_GetIndex(USARTx);
+	Return_status xStatus = OK;
 	vidUSART_InitReg(USARTx);
 
 	USARTx -> CR2 |= (u32)(Config -> StopBit);
 
-	Temp = (u32)(Config -> WordLength | Config -> Parity | Config -> Mode | Config -> OverSampling);
+	//OVER8 is written by xUSART_WriteBRR together with BRR
+	Temp = (u32)(Config -> WordLength | Config -> Parity | Config -> Mode);
 	USARTx -> CR1 |= Temp	;
 
+	if(USART_INVALID_INDEX != u8Index)
+	{
+		USART_Ctx[u8Index].Baud.OverSampling = (Config -> OverSampling & OVER8);
+	}
 
-	USARTx -> BRR 	= (u32)Config -> BaudRate;
+	//Calculate BRR from the current APB Clock
+	xStatus = xUSART_SetBaudRate(USARTx, Config -> BaudRate);
+
+	//Follow APB Clock changes (subscribing twice is ignored by RCC)
+	xRCC_subscribe(vidUSART_ClockChanged);
 /*//
 	//Enable one bit sample mode
 	USARTx -> CR3  |= ONEBIT;
@@ -77,8 +229,13 @@ void vidUSART_Init(USART_REG* USARTx, USART_Config* Config)
 	USARTx->CR3 &= ~(UART_CR3_SCEN | UART_CR3_HDSEL | UART_CR3_IREN);
 
 
-	//Enable USARTx Transmit/Recieve
-	USARTx -> CR1  |= UE;
+	//Enable USARTx Transmit/Recieve only with a valid BRR
+	if(OK == xStatus)
+	{
+		USARTx -> CR1  |= UE;
+	}
+
+	return xStatus;
 }
 
 void vidUSART_SendChar(USART_REG* USARTx, u8 u8Char)
@@ -91,12 +248,18 @@ void vidUSART_SendChar(USART_REG* USARTx, u8 u8Char)
 void vidUSART_SendString(USART_REG* USARTx, u8* u8Str, u8 u8Size)
 {
 	u8 i =0;
+	u8 u8Index = u8USART_GetIndex(USARTx);
 	if(0 != u8Str)
 	{
 		for(i=0; i<u8Size; i++)
 		{
 			vidUSART_SendChar(USARTx, u8Str[i]);
 		}
+
+		if(USART_INVALID_INDEX != u8Index)
+		{
+			USART_Ctx[u8Index].Stats.TxBytes += u8Size;
+		}
 	}
 }
 
@@ -258,3 +421,871 @@ void vidUSART_InitReg(USART_REG* USARTx)
 	USARTx->CR3		= 0x00000000;
 	USARTx->GTPR	= 0x00000000;
 }
+
+static Return_status xUSART_WriteBRR(USART_REG* USARTx, u8 u8Index, u32 u32BaudRate, u32 u32Clock)
+{
+	u32 u32Div = 0;
+	u32 u32BRR = 0;
+	u32 u32UE  = 0;
+	u16 u16Over8 = USART_Ctx[u8Index].Baud.OverSampling;
+
+	//Max Bit Rate is PCLK / 16 (OVER8 = 0) or PCLK / 8 (OVER8 = 1)
+	if((0 == u32BaudRate) || (0 == u32Clock) || (u32BaudRate > (u32Clock / ((OVER8 == u16Over8) ? 8 : 16))))
+	{
+		return OUTOFRANGE;
+	}
+
+	/*
+	 * USARTDIV = PCLK / (8 * (2 - OVER8) * BaudRate)
+	 * u32Div is USARTDIV in 1/16 (OVER8 = 0) or 1/8 (OVER8 = 1) steps (Rounded)
+	 */
+	u32Div = (u32Clock + (u32BaudRate / 2)) / u32BaudRate;
+
+	if(OVER8 == u16Over8)
+	{
+		//Fraction is 3 bits only, DIV_Fraction[3] must be kept cleared
+		u32BRR = ((u32Div & ~0x7UL) << 1) | (u32Div & 0x7UL);
+	}
+	else
+	{
+		u32BRR = u32Div;
+	}
+
+	//Mantissa is 12 bits, too low Bit Rates don't fit in BRR
+	if((0 == u32Div) || (u32BRR > 0xFFFF))
+	{
+		return OUTOFRANGE;
+	}
+
+	//OVER8 must only be changed while the USART is disabled
+	u32UE = USARTx -> CR1 & UE;
+	USARTx -> CR1 &= ~UE;
+
+	if(OVER8 == u16Over8)
+	{
+		USARTx -> CR1 |= OVER8;
+	}
+	else
+	{
+		USARTx -> CR1 &= ~OVER8;
+	}
+
+	USARTx -> BRR  = u32BRR;
+	USARTx -> CR1 |= u32UE;
+
+	USART_Ctx[u8Index].Baud.BaudRate	   = u32BaudRate;
+	USART_Ctx[u8Index].Baud.ClockFrequency = u32Clock;
+	USART_Ctx[u8Index].Baud.ActualBaudRate = u32Clock / u32Div;
+
+	return OK;
+}
+
+/*
+ * Set Bit Rate in bits/s
+ * BRR (Mantissa & Fraction) is calculated from PCLK1 or PCLK2
+ * and the value is cached so it can be recalculated when clocks change
+ */
+Return_status xUSART_SetBaudRate(USART_REG* USARTx, u32 u32BaudRate)
+{
+	u8 u8Index = u8USART_GetIndex(USARTx);
+
+	if(USART_INVALID_INDEX == u8Index)
+	{
+		return NOK;
+	}
+
+	return xUSART_WriteBRR(USARTx, u8Index, u32BaudRate, u32USART_GetClock(USARTx));
+}
+
+//Return Bit Rate achieved by BRR (0 if not configured)
+u32 u32USART_GetBaudRate(USART_REG* USARTx)
+{
+	u8 u8Index = u8USART_GetIndex(USARTx);
+
+	return (USART_INVALID_INDEX == u8Index) ? 0 : USART_Ctx[u8Index].Baud.ActualBaudRate;
+}
+
+/*
+ * Recalculate BRR of all configured instances whose APB Clock changed
+ * Called by RCC when clocks change (PLL or APB Prescalers)
+ */
+void vidUSART_UpdateBaudRates(void)
+{
+	u32 u32Clock = 0;
+	u8 i = 0;
+
+	for(i = 0; i < USART_INSTANCES_NUM; i++)
+	{
+		u32Clock = u32USART_GetClock(USART_Ctx[i].USARTx);
+
+		if((USART_Ctx[i].Baud.BaudRate != 0) && (USART_Ctx[i].Baud.ClockFrequency != u32Clock))
+		{
+			//Don't change Bit Rate in the middle of a frame
+			if((USART_Ctx[i].USARTx -> CR1 & TE) == TE)
+			{
+				while(!(USART_Ctx[i].USARTx -> SR & TC));
+			}
+
+			xUSART_WriteBRR(USART_Ctx[i].USARTx, i, USART_Ctx[i].Baud.BaudRate, u32Clock);
+		}
+	}
+}
+
+//Blocking Scatter-Gather Transmission (CPU sends every segment in place)
+void vidUSART_SendSegments(USART_REG* USARTx, const USART_TxSegment* Segments, u8 u8Count)
+{
+	u8 i = 0;
+	u16 j = 0;
+
+	if(0 != Segments)
+	{
+		for(i = 0; i < u8Count; i++)
+		{
+			for(j = 0; (0 != Segments[i].pData) && (j < Segments[i].Size); j++)
+			{
+				vidUSART_SendChar(USARTx, Segments[i].pData[j]);
+			}
+		}
+	}
+}
+
+//1 if the Stream is enabled for a request of another Channel
+static u8 u8USART_DMAStreamTaken(const USART_DMAMap* Map)
+{
+	u32 u32CR = Map -> DMA_SNUM -> CR;
+
+	return (u8)((EN == (EN & u32CR)) && ((u32)Map -> Channel != (CHSEL & u32CR)));
+}
+
+static void vidUSART_DMAClearFlags(const USART_DMAMap* Map)
+{
+	if(Map -> HighReg != 0)
+	{
+		Map -> DMA_Num -> HIFCR = ((CTCIF | CHTIF | CTEIF | CDMEIF | CFEIF) << Map -> FlagShift);
+	}
+	else
+	{
+		Map -> DMA_Num -> LIFCR = ((CTCIF | CHTIF | CTEIF | CDMEIF | CFEIF) << Map -> FlagShift);
+	}
+}
+
+//Start next non empty segment, Returns 0 if no segments left
+static u8 u8USART_TxNextSegment(u8 u8Index)
+{
+	USART_TxState* Tx = &USART_Ctx[u8Index].Tx;
+	const USART_DMAMap* Map = &USART_TxDMA[u8Index];
+
+	//Skip Empty Segments
+	while((Tx -> Index < Tx -> Count) && ((0 == Tx -> Segments[Tx -> Index].Size) || (0 == Tx -> Segments[Tx -> Index].pData)))
+	{
+		Tx -> Index++;
+	}
+
+	if(Tx -> Index >= Tx -> Count)
+	{
+		return 0;
+	}
+
+	vidUSART_DMAClearFlags(Map);
+
+	Map -> DMA_SNUM -> M0AR = (u32)Tx -> Segments[Tx -> Index].pData;
+	Map -> DMA_SNUM -> NDTR = Tx -> Segments[Tx -> Index].Size;
+	USART_Ctx[u8Index].Stats.TxBytes += Tx -> Segments[Tx -> Index].Size;
+	Tx -> Index++;
+
+	/*
+	 * TC is set in any gap between two segments (TC interrupt served late),
+	 * clear it so the TC that ends the chain is the one of this segment's last byte
+	 */
+	USART_Ctx[u8Index].USARTx -> SR = ~(u32)TC;
+
+	Map -> DMA_SNUM -> CR |= EN;
+
+	return 1;
+}
+
+/*
+ * Non-Blocking Scatter-Gather Transmission with DMA
+ * Every Segment is a separate DMA block, TC Interrupt chains the next one
+ * so Header, Payload & CRC are sent from where they are (No memcpy)
+ * Segments array & data must stay valid till callback is called
+ */
+Return_status xUSART_SendSegments_DMA(USART_REG* USARTx, const USART_TxSegment* Segments, u8 u8Count, USART_TxCallback pfCallback)
+{
+	u8 u8Index = u8USART_GetIndex(USARTx);
+	const USART_DMAMap* Map = 0;
+
+	if(0 == Segments)
+	{
+		return NULLPOINTER;
+	}
+
+	if((USART_INVALID_INDEX == u8Index) || (0 == USART_TxDMA[u8Index].DMA_SNUM))
+	{
+		return NOK;
+	}
+
+	if(USART_Ctx[u8Index].Tx.Busy != 0)
+	{
+		return NOK;
+	}
+
+	Map = &USART_TxDMA[u8Index];
+
+	if(0 != u8USART_DMAStreamTaken(Map))
+	{
+		return NOK;
+	}
+
+	//Make Sure that DMA is Disabled
+	Map -> DMA_SNUM -> CR &= ~EN;
+	while(EN == (EN & Map -> DMA_SNUM -> CR));
+
+	//Memory to USART DR, Byte by Byte, Direct Mode
+	Map -> DMA_SNUM -> CR  = ((u32)Map -> Channel | (u32)Memory_To_Peripheral | MINC | (u32)P_MEDIUM | (u32)TCIE | (u32)TEIE);
+	Map -> DMA_SNUM -> FCR = 0;
+	Map -> DMA_SNUM -> PAR = (u32)&USARTx -> DR;
+
+	USART_Ctx[u8Index].Tx.Segments	 = Segments;
+	USART_Ctx[u8Index].Tx.Count		 = u8Count;
+	USART_Ctx[u8Index].Tx.Index		 = 0;
+	USART_Ctx[u8Index].Tx.pfCallback = pfCallback;
+	USART_Ctx[u8Index].Tx.Busy		 = 1;
+
+	//TC is set again by the USART when the last stop bit of the chain is sent
+	USARTx -> CR1 &= ~UART_CR1_TCIE;
+	USARTx -> SR   = ~(u32)TC;
+
+	//Enable Transmit with DMA
+	USARTx -> CR3 |= DMAT;
+
+	//Enable Stream & USART (TC) Interrupts on NVIC
+	vidUSART_NVICEnable(Map -> IRQNum);
+	vidUSART_NVICEnable(USART_IRQNum[u8Index]);
+
+	if(0 == u8USART_TxNextSegment(u8Index))
+	{
+		//Nothing to send
+		USART_Ctx[u8Index].Tx.Busy = 0;
+
+		if(0 != pfCallback)
+		{
+			pfCallback(USARTx);
+		}
+	}
+
+	return OK;
+}
+
+/*
+ * Attach the Callback called from USART ISR Context every time a Scatter-Gather
+ * Transmission ends and nobody started the next one, so a producer that got NOK
+ * from xUSART_SendSegments_DMA can retry without polling (One per instance)
+ */
+Return_status xUSART_SetTxIdleCallback(USART_REG* USARTx, USART_TxCallback pfCallback)
+{
+	u8 u8Index = u8USART_GetIndex(USARTx);
+
+	if(USART_INVALID_INDEX == u8Index)
+	{
+		return NOK;
+	}
+
+	if((0 != pfCallback) && (0 != USART_Ctx[u8Index].Tx.pfIdle) && (pfCallback != USART_Ctx[u8Index].Tx.pfIdle))
+	{
+		return NOK;
+	}
+
+	USART_Ctx[u8Index].Tx.pfIdle = pfCallback;
+
+	return OK;
+}
+
+u8 u8USART_TxBusy(USART_REG* USARTx)
+{
+	u8 u8Index = u8USART_GetIndex(USARTx);
+
+	return (USART_INVALID_INDEX == u8Index) ? 0 : USART_Ctx[u8Index].Tx.Busy;
+}
+
+//End of Scatter-Gather Transmission (Last frame sent or DMA Error)
+RAM_FUNC static void vidUSART_TxDone(USART_REG* USARTx, u8 u8Index)
+{
+	USARTx -> CR1 &= ~UART_CR1_TCIE;
+	USART_Ctx[u8Index].Tx.Busy = 0;
+
+	if(0 != USART_Ctx[u8Index].Tx.pfCallback)
+	{
+		USART_Ctx[u8Index].Tx.pfCallback(USARTx);
+	}
+
+	//Callback didn't chain a new Transmission, let a waiting producer have the Tx DMA
+	if((0 == USART_Ctx[u8Index].Tx.Busy) && (0 != USART_Ctx[u8Index].Tx.pfIdle))
+	{
+		USART_Ctx[u8Index].Tx.pfIdle(USARTx);
+	}
+}
+
+//Common Tx DMA Stream ISR
+RAM_FUNC static void vidUSART_TxDMAHandler(USART_REG* USARTx, u8 u8Index)
+{
+	const USART_DMAMap* Map = &USART_TxDMA[u8Index];
+	u32 u32Flags = 0;
+
+	u32Flags = ((Map -> HighReg != 0) ? Map -> DMA_Num -> HISR : Map -> DMA_Num -> LISR) >> Map -> FlagShift;
+
+	if((u32Flags & (TCIF | TEIF)) != 0)
+	{
+		vidUSART_DMAClearFlags(Map);
+
+		//Stop on Transfer Error, Otherwise chain next segment
+		if((u32Flags & TEIF) != 0)
+		{
+			vidUSART_TxDone(USARTx, u8Index);
+		}
+		else if(0 == u8USART_TxNextSegment(u8Index))
+		{
+			/*
+			 * DMA TC only means the last byte is in DR, Segments can't be
+			 * reused till the USART shifts it out, Callback is called on USART TC
+			 */
+			USARTx -> CR1 |= UART_CR1_TCIE;
+		}
+	}
+	else
+	{
+		//FIFO & Direct Mode Error Flags only
+		vidUSART_DMAClearFlags(Map);
+	}
+}
+
+RAM_FUNC void DMA2_Stream7_IRQHandler(void)
+{
+	vidUSART_TxDMAHandler(USART1, 0);
+}
+
+RAM_FUNC void DMA1_Stream6_IRQHandler(void)
+{
+	vidUSART_TxDMAHandler(USART2, 1);
+}
+
+RAM_FUNC void DMA1_Stream3_IRQHandler(void)
+{
+	vidUSART_TxDMAHandler(USART3, 2);
+}
+
+RAM_FUNC void DMA1_Stream4_IRQHandler(void)
+{
+	vidUSART_TxDMAHandler(UART4, 3);
+}
+
+RAM_FUNC void DMA1_Stream7_IRQHandler(void)
+{
+	vidUSART_TxDMAHandler(UART5, 4);
+}
+
+RAM_FUNC void DMA2_Stream6_IRQHandler(void)
+{
+	vidUSART_TxDMAHandler(USART6, 5);
+}
+
+//Number of bytes waiting in Queue
+static u16 u16USART_QueueCount(const USART_Queue* Queue)
+{
+	u16 u16Head = Queue -> Head;
+	u16 u16Tail = Queue -> Tail;
+
+	return (u16Head >= u16Tail) ? (u16)(u16Head - u16Tail) : (u16)(Queue -> Size - u16Tail + u16Head);
+}
+
+/*
+ * Attach Tx & Rx Queues Buffers to USART instance and start Interrupt driven mode
+ * One byte of every buffer is kept empty to distinguish full from empty queue
+ * Rx Buffer can be Null if only Tx Queue is needed (and vice versa)
+ */
+Return_status xUSART_AttachBuffers(USART_REG* USARTx, u8* pTxBuffer, u16 u16TxSize, u8* pRxBuffer, u16 u16RxSize)
+{
+	u8 u8Index = u8USART_GetIndex(USARTx);
+	USART_Context* Ctx = 0;
+
+	if(USART_INVALID_INDEX == u8Index)
+	{
+		return NOK;
+	}
+
+	if(((0 == pTxBuffer) && (0 != u16TxSize)) || ((0 == pRxBuffer) && (0 != u16RxSize)))
+	{
+		return NULLPOINTER;
+	}
+
+	Ctx = &USART_Ctx[u8Index];
+
+	//Stop USART Interrupts while changing Queues
+	USARTx -> CR1 &= ~(UART_CR1_RXNEIE | UART_CR1_TXEIE | UART_CR1_PEIE);
+	USARTx -> CR3 &= ~UART_CR3_EIE;
+
+	Ctx -> TxQueue.pBuffer = pTxBuffer;
+	Ctx -> TxQueue.Size	   = u16TxSize;
+	Ctx -> TxQueue.Head	   = 0;
+	Ctx -> TxQueue.Tail	   = 0;
+
+	Ctx -> RxQueue.pBuffer = pRxBuffer;
+	Ctx -> RxQueue.Size	   = u16RxSize;
+	Ctx -> RxQueue.Head	   = 0;
+	Ctx -> RxQueue.Tail	   = 0;
+	Ctx -> RxDMA		   = 0;
+	USARTx -> CR3 &= ~DMAR;
+
+	if(0 != u16RxSize)
+	{
+		//Receive & Count Parity, Framing, Noise & Overrun Errors in ISR
+		USARTx -> CR1 |= (UART_CR1_RXNEIE | UART_CR1_PEIE);
+		USARTx -> CR3 |= UART_CR3_EIE;
+	}
+
+	vidUSART_NVICEnable(USART_IRQNum[u8Index]);
+
+	return OK;
+}
+
+//Non-Blocking Write to Tx Queue, Returns number of bytes queued
+u16 u16USART_Write(USART_REG* USARTx, const u8* pData, u16 u16Size)
+{
+	u8 u8Index = u8USART_GetIndex(USARTx);
+	USART_Queue* Queue = 0;
+	u16 u16Written = 0;
+	u16 u16Next = 0;
+	u16 u16Count = 0;
+
+	if((USART_INVALID_INDEX == u8Index) || (0 == pData) || (0 == USART_Ctx[u8Index].TxQueue.Size))
+	{
+		return 0;
+	}
+
+	Queue = &USART_Ctx[u8Index].TxQueue;
+
+	while(u16Written < u16Size)
+	{
+		u16Next = (u16)(Queue -> Head + 1);
+
+		if(u16Next >= Queue -> Size)
+		{
+			u16Next = 0;
+		}
+
+		//Queue is Full
+		if(u16Next == Queue -> Tail)
+		{
+			break;
+		}
+
+		Queue -> pBuffer[Queue -> Head] = pData[u16Written++];
+		Queue -> Head = u16Next;
+	}
+
+	u16Count = u16USART_QueueCount(Queue);
+
+	if(u16Count > USART_Ctx[u8Index].Stats.TxHighWater)
+	{
+		USART_Ctx[u8Index].Stats.TxHighWater = u16Count;
+	}
+
+	//TXE Interrupt drains the Queue
+	if(u16Written != 0)
+	{
+		USARTx -> CR1 |= UART_CR1_TXEIE;
+	}
+
+	return u16Written;
+}
+
+/*
+ * In DMA Rx Ring mode Queue Head is where DMA will write next byte
+ * Queue Size - NDTR (NDTR reloads to Size on wrap)
+ */
+static void vidUSART_RxSyncHead(USART_Context* Ctx, u8 u8Index)
+{
+	u16 u16Head = 0;
+	u16 u16Count = 0;
+	u16 u16OldCount = 0;
+
+	if(Ctx -> RxDMA != 0)
+	{
+		u16OldCount = u16USART_QueueCount(&Ctx -> RxQueue);
+		u16Head = (u16)(Ctx -> RxQueue.Size - USART_RxDMA[u8Index].DMA_SNUM -> NDTR);
+
+		Ctx -> RxQueue.Head = (u16Head >= Ctx -> RxQueue.Size) ? 0 : u16Head;
+
+		u16Count = u16USART_QueueCount(&Ctx -> RxQueue);
+		Ctx -> Stats.RxBytes += (u16)(u16Count - u16OldCount);
+
+		if(u16Count > Ctx -> Stats.RxHighWater)
+		{
+			Ctx -> Stats.RxHighWater = u16Count;
+		}
+
+		//Error Interrupt is disabled in ISR after counting error
+		Ctx -> USARTx -> CR3 |= UART_CR3_EIE;
+	}
+}
+
+//Non-Blocking Read from Rx Queue, Returns number of bytes read
+u16 u16USART_Read(USART_REG* USARTx, u8* pData, u16 u16Size)
+{
+	u8 u8Index = u8USART_GetIndex(USARTx);
+	USART_Queue* Queue = 0;
+	u16 u16Read = 0;
+	u16 u16Tail = 0;
+
+	if((USART_INVALID_INDEX == u8Index) || (0 == pData) || (0 == USART_Ctx[u8Index].RxQueue.Size))
+	{
+		return 0;
+	}
+
+	Queue = &USART_Ctx[u8Index].RxQueue;
+	vidUSART_RxSyncHead(&USART_Ctx[u8Index], u8Index);
+	u16Tail = Queue -> Tail;
+
+	while((u16Read < u16Size) && (u16Tail != Queue -> Head))
+	{
+		pData[u16Read++] = Queue -> pBuffer[u16Tail];
+
+		u16Tail++;
+		if(u16Tail >= Queue -> Size)
+		{
+			u16Tail = 0;
+		}
+	}
+
+	Queue -> Tail = u16Tail;
+
+	return u16Read;
+}
+
+u16 u16USART_RxAvailable(USART_REG* USARTx)
+{
+	u8 u8Index = u8USART_GetIndex(USARTx);
+
+	if((USART_INVALID_INDEX == u8Index) || (0 == USART_Ctx[u8Index].RxQueue.Size))
+	{
+		return 0;
+	}
+
+	vidUSART_RxSyncHead(&USART_Ctx[u8Index], u8Index);
+
+	return u16USART_QueueCount(&USART_Ctx[u8Index].RxQueue);
+}
+
+u16 u16USART_TxFree(USART_REG* USARTx)
+{
+	u8 u8Index = u8USART_GetIndex(USARTx);
+
+	if((USART_INVALID_INDEX == u8Index) || (0 == USART_Ctx[u8Index].TxQueue.Size))
+	{
+		return 0;
+	}
+
+	return (u16)(USART_Ctx[u8Index].TxQueue.Size - 1 - u16USART_QueueCount(&USART_Ctx[u8Index].TxQueue));
+}
+
+/*
+ * Start Rx Ring mode, DMA writes received bytes into pBuffer circularly
+ * without any interrupt per byte, Readers poll NDTR through
+ * u16USART_RxRingGet (Zero-Copy) or u16USART_Read
+ * Returns NOK if the Rx Stream is enabled on another Channel
+ * Note: UART4 Ring keeps DMA1 Stream2, I2C3 reads of 2 bytes or more then fail (I2CM_DMA_BUSY)
+ * Note: Ring overflow can't be detected, size it for the longest polling gap
+ * Note: Ring is written before it is read, so it can be NO_INIT (SRAM, not CCM)
+ */
+Return_status xUSART_StartRxRing_DMA(USART_REG* USARTx, u8* pBuffer, u16 u16Size)
+{
+	u8 u8Index = u8USART_GetIndex(USARTx);
+	const USART_DMAMap* Map = 0;
+	USART_Context* Ctx = 0;
+
+	if((0 == pBuffer) || (0 == u16Size))
+	{
+		return NULLPOINTER;
+	}
+
+	if((USART_INVALID_INDEX == u8Index) || (0 == USART_RxDMA[u8Index].DMA_SNUM))
+	{
+		return NOK;
+	}
+
+	Map = &USART_RxDMA[u8Index];
+	Ctx = &USART_Ctx[u8Index];
+
+	//UART4: an I2C3 read (stm32f429i_discovery_i2c.c) holds DMA1 Stream2
+	if(0 != u8USART_DMAStreamTaken(Map))
+	{
+		return NOK;
+	}
+
+	//DMA serves RXNE instead of the Rx Interrupt
+	USARTx -> CR1 &= ~UART_CR1_RXNEIE;
+
+	//Make Sure that DMA is Disabled
+	Map -> DMA_SNUM -> CR &= ~EN;
+	while(EN == (EN & Map -> DMA_SNUM -> CR));
+
+	vidUSART_DMAClearFlags(Map);
+
+	//USART DR to Memory, Byte by Byte, Circular, Direct Mode
+	Map -> DMA_SNUM -> CR	= ((u32)Map -> Channel | (u32)Peripheral_To_Memory | MINC | (u32)Circular | (u32)P_HIGH);
+	Map -> DMA_SNUM -> FCR	= 0;
+	Map -> DMA_SNUM -> PAR	= (u32)&USARTx -> DR;
+	Map -> DMA_SNUM -> M0AR = (u32)pBuffer;
+	Map -> DMA_SNUM -> NDTR = u16Size;
+
+	Ctx -> RxQueue.pBuffer = pBuffer;
+	Ctx -> RxQueue.Size	   = u16Size;
+	Ctx -> RxQueue.Head	   = 0;
+	Ctx -> RxQueue.Tail	   = 0;
+	Ctx -> RxDMA		   = 1;
+
+	USARTx -> CR3 |= (DMAR | UART_CR3_EIE);
+	vidUSART_NVICEnable(USART_IRQNum[u8Index]);
+
+	Map -> DMA_SNUM -> CR |= EN;
+
+	return OK;
+}
+
+/*
+ * Zero-Copy access to Rx Ring
+ * Returns number of contiguous received bytes starting at *ppData
+ * (Till the end of buffer, call again after consume to get wrapped part)
+ */
+u16 u16USART_RxRingGet(USART_REG* USARTx, const u8** ppData)
+{
+	u8 u8Index = u8USART_GetIndex(USARTx);
+	USART_Context* Ctx = 0;
+	u16 u16Head = 0;
+	u16 u16Tail = 0;
+
+	if((USART_INVALID_INDEX == u8Index) || (0 == ppData) || (0 == USART_Ctx[u8Index].RxQueue.Size))
+	{
+		return 0;
+	}
+
+	Ctx = &USART_Ctx[u8Index];
+	vidUSART_RxSyncHead(Ctx, u8Index);
+
+	u16Head = Ctx -> RxQueue.Head;
+	u16Tail = Ctx -> RxQueue.Tail;
+	*ppData = &Ctx -> RxQueue.pBuffer[u16Tail];
+
+	return (u16Head >= u16Tail) ? (u16)(u16Head - u16Tail) : (u16)(Ctx -> RxQueue.Size - u16Tail);
+}
+
+//Release bytes got by u16USART_RxRingGet
+void vidUSART_RxRingConsume(USART_REG* USARTx, u16 u16Count)
+{
+	u8 u8Index = u8USART_GetIndex(USARTx);
+	u16 u16Tail = 0;
+
+	if((USART_INVALID_INDEX != u8Index) && (0 != USART_Ctx[u8Index].RxQueue.Size))
+	{
+		u16Tail = (u16)(USART_Ctx[u8Index].RxQueue.Tail + u16Count);
+
+		while(u16Tail >= USART_Ctx[u8Index].RxQueue.Size)
+		{
+			u16Tail -= USART_Ctx[u8Index].RxQueue.Size;
+		}
+
+		USART_Ctx[u8Index].RxQueue.Tail = u16Tail;
+	}
+}
+
+//Copy Diagnostics of USART instance
+Return_status xUSART_GetStats(USART_REG* USARTx, USART_Stats* Stats)
+{
+	u8 u8Index = u8USART_GetIndex(USARTx);
+
+	if(0 == Stats)
+	{
+		return NULLPOINTER;
+	}
+
+	if(USART_INVALID_INDEX == u8Index)
+	{
+		return NOK;
+	}
+
+	*Stats = USART_Ctx[u8Index].Stats;
+
+	return OK;
+}
+
+void vidUSART_ResetStats(USART_REG* USARTx)
+{
+	u8 u8Index = u8USART_GetIndex(USARTx);
+	USART_Stats Empty = {0};
+
+	if(USART_INVALID_INDEX != u8Index)
+	{
+		USART_Ctx[u8Index].Stats		   = Empty;
+		USART_Ctx[u8Index].TxBytesLastTick = 0;
+		USART_Ctx[u8Index].RxBytesLastTick = 0;
+	}
+}
+
+/*
+ * Update Bytes/s meters of all instances
+ * Should be called periodically (e.g. every 1000ms) with the time since last call
+ */
+void vidUSART_StatsTick(u32 u32ElapsedMs)
+{
+	u8 i = 0;
+	u32 u32TxBytes = 0;
+	u32 u32RxBytes = 0;
+
+	if(0 == u32ElapsedMs)
+	{
+		return;
+	}
+
+	for(i = 0; i < USART_INSTANCES_NUM; i++)
+	{
+		u32TxBytes = USART_Ctx[i].Stats.TxBytes;
+		u32RxBytes = USART_Ctx[i].Stats.RxBytes;
+
+		USART_Ctx[i].Stats.TxBytesPerSecond = (u32)(((u64)(u32TxBytes - USART_Ctx[i].TxBytesLastTick) * 1000U) / u32ElapsedMs);
+		USART_Ctx[i].Stats.RxBytesPerSecond = (u32)(((u64)(u32RxBytes - USART_Ctx[i].RxBytesLastTick) * 1000U) / u32ElapsedMs);
+
+		USART_Ctx[i].TxBytesLastTick = u32TxBytes;
+		USART_Ctx[i].RxBytesLastTick = u32RxBytes;
+	}
+}
+
+//Common USART Global Interrupt Handler
+RAM_FUNC static void vidUSART_IRQHandler(u8 u8Index)
+{
+	USART_Context* Ctx = &USART_Ctx[u8Index];
+	USART_REG* USARTx = Ctx -> USARTx;
+	u32 u32Status = USARTx -> SR;
+	u8 u8Data = 0;
+	u16 u16Next = 0;
+	u16 u16Count = 0;
+
+	if(Ctx -> RxDMA != 0)
+	{
+		/*
+		 * DMA reads DR so it clears the error flags, Only count them here
+		 * Error Interrupt is enabled again when Rx Ring is polled
+		 * so errors on idle line don't storm the CPU
+		 */
+		if((u32Status & (ORE | FE | NF | PE)) != 0)
+		{
+			if((u32Status & ORE) != 0) { Ctx -> Stats.OverrunErrors++; }
+			if((u32Status & FE)  != 0) { Ctx -> Stats.FramingErrors++; }
+			if((u32Status & NF)  != 0) { Ctx -> Stats.NoiseErrors++;   }
+			if((u32Status & PE)  != 0) { Ctx -> Stats.ParityErrors++;  }
+
+			USARTx -> CR3 &= ~UART_CR3_EIE;
+		}
+	}
+	//Reading SR then DR clears RXNE, PE, FE, NF & ORE
+	else if((u32Status & (RXNE | ORE | FE | NF | PE)) != 0)
+	{
+		u8Data = (u8)(USARTx -> DR & 0xFF);
+
+		if((u32Status & ORE) != 0) { Ctx -> Stats.OverrunErrors++; }
+		if((u32Status & FE)  != 0) { Ctx -> Stats.FramingErrors++; }
+		if((u32Status & NF)  != 0) { Ctx -> Stats.NoiseErrors++;   }
+		if((u32Status & PE)  != 0) { Ctx -> Stats.ParityErrors++;  }
+
+		if(((u32Status & RXNE) != 0) && (0 != Ctx -> RxQueue.Size))
+		{
+			u16Next = (u16)(Ctx -> RxQueue.Head + 1);
+
+			if(u16Next >= Ctx -> RxQueue.Size)
+			{
+				u16Next = 0;
+			}
+
+			if(u16Next == Ctx -> RxQueue.Tail)
+			{
+				//Queue is Full, Drop the byte
+				Ctx -> Stats.RxDropped++;
+			}
+			else
+			{
+				Ctx -> RxQueue.pBuffer[Ctx -> RxQueue.Head] = u8Data;
+				Ctx -> RxQueue.Head = u16Next;
+				Ctx -> Stats.RxBytes++;
+
+				u16Count = u16USART_QueueCount(&Ctx -> RxQueue);
+
+				if(u16Count > Ctx -> Stats.RxHighWater)
+				{
+					Ctx -> Stats.RxHighWater = u16Count;
+				}
+			}
+		}
+	}
+
+	if(((u32Status & TXE) != 0) && ((USARTx -> CR1 & UART_CR1_TXEIE) != 0))
+	{
+		if(Ctx -> TxQueue.Tail != Ctx -> TxQueue.Head)
+		{
+			USARTx -> DR = Ctx -> TxQueue.pBuffer[Ctx -> TxQueue.Tail];
+			Ctx -> Stats.TxBytes++;
+
+			u16Next = (u16)(Ctx -> TxQueue.Tail + 1);
+			Ctx -> TxQueue.Tail = (u16Next >= Ctx -> TxQueue.Size) ? 0 : u16Next;
+		}
+		else
+		{
+			//Queue is Empty
+			USARTx -> CR1 &= ~UART_CR1_TXEIE;
+		}
+	}
+
+	//Last byte of the DMA Scatter-Gather chain left the shift register
+	if(((u32Status & TC) != 0) && ((USARTx -> CR1 & UART_CR1_TCIE) != 0))
+	{
+		vidUSART_TxDone(USARTx, u8Index);
+	}
+}
+
+RAM_FUNC void USART1_IRQHandler(void)
+{
+	vidUSART_IRQHandler(0);
+}
+
+RAM_FUNC void USART2_IRQHandler(void)
+{
+	vidUSART_IRQHandler(1);
+}
+
+RAM_FUNC void USART3_IRQHandler(void)
+{
+	vidUSART_IRQHandler(2);
+}
+
+RAM_FUNC void UART4_IRQHandler(void)
+{
+	vidUSART_IRQHandler(3);
+}
+
+RAM_FUNC void UART5_IRQHandler(void)
+{
+	vidUSART_IRQHandler(4);
+}
+
+RAM_FUNC void USART6_IRQHandler(void)
+{
+	vidUSART_IRQHandler(5);
+}
+
+RAM_FUNC void UART7_IRQHandler(void)
+{
+	vidUSART_IRQHandler(6);
+}
+
+RAM_FUNC void UART8_IRQHandler(void)
+{
+	vidUSART_IRQHandler(7);
+}
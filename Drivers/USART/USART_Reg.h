@@ -28,5 +28,8 @@
 #define UART7  ((USART_REG*) 0x40007800)
 #define UART8  ((USART_REG*) 0x40007C00)
 
+//NVIC Interrupt Set Enable Registers (ISER0 -> ISER2) to enable USART & DMA IRQs
+#define USART_NVIC_ISER ((volatile u32*) 0xE000E100)
+
 
 #endif /* USART_REG_H_ */
@@ -100,6 +100,10 @@ FunctionalState LCD_Lock;
 FunctionalState LCD_Scrolled;
 uint16_t LCD_ScrollBackStep;
 
+/* Text zone on screen is the previous window, so an append can scroll it */
+static FunctionalState LCD_WindowSynced = DISABLE;
+static sFONT *LCD_WindowFont = 0;
+
 /**
 * @}
 */ 
@@ -153,6 +157,7 @@ void LCD_LOG_DeInit(void)
   LCD_Lock = DISABLE;
   LCD_Scrolled = DISABLE;
   LCD_ScrollBackStep = 0;
+  LCD_WindowSynced = DISABLE;
 }
 
 /**
@@ -341,6 +346,18 @@ static void LCD_LOG_UpdateDisplay (void)
     LCD_SetTextColor(LCD_CacheBuffer[cnt + LCD_CacheBuffer_yptr_bottom].color);
     LCD_DisplayStringLine ((YWINDOW_MIN + LCD_CacheBuffer_yptr_bottom) * cFont->Height,
                            (uint8_t *)(LCD_CacheBuffer[cnt + LCD_CacheBuffer_yptr_bottom].line));
+    LCD_WindowSynced = DISABLE;
+  }
+  else if((LCD_ScrollActive == DISABLE) && (LCD_WindowSynced == ENABLE) &&
+          (LCD_WindowFont == cFont))
+  {
+    /* Window full and one line appended: move the text zone up by one line
+       with a single DMA2D blit and render only the new bottom line */
+    LCD_ScrollUp(YWINDOW_MIN * cFont->Height, YWINDOW_SIZE * cFont->Height, cFont->Height);
+    
+    LCD_SetTextColor(LCD_CacheBuffer[LCD_CacheBuffer_yptr_bottom].color);
+    LCD_DisplayStringLine ((YWINDOW_MIN + YWINDOW_SIZE - 1) * cFont->Height,
+                           (uint8_t *)(LCD_CacheBuffer[LCD_CacheBuffer_yptr_bottom].line));
   }
   else
   {
@@ -367,6 +384,10 @@ static void LCD_LOG_UpdateDisplay (void)
                              (uint8_t *)(LCD_CacheBuffer[index].line));
       
     }
+    
+    /* A scroll-back frame is not the tail of the cache, redraw after it */
+    LCD_WindowSynced = (LCD_ScrollActive == DISABLE) ? ENABLE : DISABLE;
+    LCD_WindowFont = cFont;
   }
   
 }
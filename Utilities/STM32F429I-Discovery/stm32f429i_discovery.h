@@ -153,8 +153,8 @@ typedef enum
    
 #define sEE_I2C_DMA_TX_IRQn              DMA1_Stream4_IRQn
 #define sEE_I2C_DMA_RX_IRQn              DMA1_Stream2_IRQn
-#define sEE_I2C_DMA_TX_IRQHandler        DMA1_Stream4_IRQHandler
-#define sEE_I2C_DMA_RX_IRQHandler        DMA1_Stream2_IRQHandler   
+/* No sEE DMA IRQ Handlers: DMA1_Stream4_IRQHandler is the UART4 Tx DMA
+   handler of USART_Prog.c (UART4_TX is only mapped on DMA1 Stream4) */
 #define sEE_I2C_DMA_PREPRIO              0
 #define sEE_I2C_DMA_SUBPRIO              0   
    
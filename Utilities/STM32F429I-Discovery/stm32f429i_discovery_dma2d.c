@@ -0,0 +1,367 @@
+/**
+  ******************************************************************************
+  * @file    stm32f429i_discovery_dma2d.c
+  * @author  Islam Ehab
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Asynchronous 2D fill/copy engine over DMA2D.
+  *          Transfers are queued and chained from the DMA2D transfer complete
+  *          interrupt, so the CPU only writes a command and returns.
+  *          Code writing the frame buffer with the CPU must call GFX_Wait()
+  *          first, otherwise a queued transfer may overwrite it later.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32f429i_discovery_dma2d.h"
+
+/** @addtogroup Utilities
+  * @{
+  */ 
+
+/** @addtogroup STM32F4_DISCOVERY
+  * @{
+  */ 
+
+/** @addtogroup STM32F429I_DISCOVERY
+  * @{
+  */
+    
+/** @defgroup STM32F429I_DISCOVERY_DMA2D 
+  * @brief This file includes the DMA2D transfer queue
+  * @{
+  */ 
+
+/** @defgroup STM32F429I_DISCOVERY_DMA2D_Private_Defines
+  * @{
+  */
+#define GFX_IT_MASK        (DMA2D_CR_TCIE | DMA2D_CR_TEIE | DMA2D_CR_CEIE)
+#define GFX_FLAG_MASK      (DMA2D_IFSR_CTCIF | DMA2D_IFSR_CTEIF | DMA2D_IFSR_CCEIF)
+/**
+  * @}
+  */ 
+
+/** @defgroup STM32F429I_DISCOVERY_DMA2D_Private_Variables
+  * @{
+  */ 
+static GFX_Command GFX_Queue[GFX_QUEUE_SIZE];
+/* Head is moved by GFX_Submit, Tail by the interrupt */
+static __IO uint32_t GFX_Head = 0;
+static __IO uint32_t GFX_Tail = 0;
+static __IO uint8_t  GFX_Running = 0;
+static __IO uint32_t GFX_Errors = 0;
+/**
+  * @}
+  */ 
+
+/** @defgroup STM32F429I_DISCOVERY_DMA2D_Private_Functions
+  * @{
+  */ 
+
+/**
+  * @brief  Loads the command at the queue tail and starts it.
+  * @param  None
+  * @retval None
+  */
+static void GFX_StartNext(void)
+{
+  const GFX_Command *cmd = &GFX_Queue[GFX_Tail % GFX_QUEUE_SIZE];
+
+  DMA2D->FGMAR   = cmd->FGMAR;
+  DMA2D->FGOR    = cmd->FGOR;
+  DMA2D->FGPFCCR = cmd->FGPFCCR;
+  DMA2D->FGCOLR  = cmd->FGCOLR;
+  DMA2D->BGMAR   = cmd->BGMAR;
+  DMA2D->BGOR    = cmd->BGOR;
+  DMA2D->BGPFCCR = cmd->BGPFCCR;
+  DMA2D->OPFCCR  = cmd->OPFCCR;
+  DMA2D->OCOLR   = cmd->OCOLR;
+  DMA2D->OMAR    = cmd->OMAR;
+  DMA2D->OOR     = cmd->OOR;
+  DMA2D->NLR     = cmd->NLR;
+
+  GFX_Running = 1;
+  DMA2D->CR = cmd->CR | GFX_IT_MASK | DMA2D_CR_START;
+}
+
+/**
+  * @brief  Enables the DMA2D clock and interrupt, empties the queue.
+  * @param  None
+  * @retval None
+  */
+void GFX_Init(void)
+{
+  NVIC_InitTypeDef NVIC_InitStructure;
+
+  RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA2D, ENABLE);
+
+  GFX_Head = 0;
+  GFX_Tail = 0;
+  GFX_Running = 0;
+  GFX_Errors = 0;
+
+  DMA2D->IFCR = GFX_FLAG_MASK;
+
+  NVIC_InitStructure.NVIC_IRQChannel = GFX_DMA2D_IRQn;
+  NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0x0F;
+  NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0x0F;
+  NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+  NVIC_Init(&NVIC_InitStructure);
+}
+
+/**
+  * @brief  Queues a transfer, starts it at once if DMA2D is idle.
+  *         Waits for a free slot when the queue is full, unless called
+  *         with interrupts masked or from an interrupt handler: the DMA2D
+  *         interrupt can't free a slot then, the transfer is refused.
+  *         The slot is filled with interrupts masked, so an interrupt may
+  *         queue too.
+  * @param  Command: transfer registers, copied into the queue.
+  * @retval SUCCESS if queued, ERROR if the queue is full and can't drain
+  */
+ErrorStatus GFX_Submit(const GFX_Command *Command)
+{
+  uint32_t primask;
+
+  primask = __get_PRIMASK();
+
+  for(;;)
+  {
+    __disable_irq();
+
+    if((GFX_Head - GFX_Tail) < GFX_QUEUE_SIZE)
+    {
+      break;
+    }
+
+    /* Full: only the DMA2D interrupt frees a slot */
+    __set_PRIMASK(primask);
+
+    if((primask != 0) || (__get_IPSR() != 0))
+    {
+      return ERROR;
+    }
+  }
+
+  GFX_Queue[GFX_Head % GFX_QUEUE_SIZE] = *Command;
+  GFX_Head++;
+
+  if(GFX_Running == 0)
+  {
+    GFX_StartNext();
+  }
+
+  __set_PRIMASK(primask);
+
+  return SUCCESS;
+}
+
+/**
+  * @brief  Fills a rectangle with a constant color (register to memory).
+  * @param  Address: address of the first pixel.
+  * @param  Pitch: width of the destination buffer in pixels.
+  * @param  Width, Height: rectangle size in pixels.
+  * @param  ColorMode: output format (DMA2D_RGB565, DMA2D_ARGB8888, ...).
+  * @param  Color: color already coded in ColorMode.
+  * @retval SUCCESS, ERROR if the queue is full (see GFX_Submit)
+  */
+ErrorStatus GFX_Fill(uint32_t Address, uint16_t Pitch, uint16_t Width, uint16_t Height, uint32_t ColorMode, uint32_t Color)
+{
+  GFX_Command cmd = {0};
+
+  if((Width == 0) || (Height == 0))
+  {
+    return SUCCESS;
+  }
+
+  cmd.CR     = DMA2D_R2M;
+  cmd.OPFCCR = ColorMode;
+  cmd.OCOLR  = Color;
+  cmd.OMAR   = Address;
+  cmd.OOR    = Pitch - Width;
+  cmd.NLR    = ((uint32_t)Width << 16) | Height;
+
+  return GFX_Submit(&cmd);
+}
+
+/**
+  * @brief  Copies a rectangle between buffers of the same format.
+  * @param  Src, SrcPitch: source first pixel and buffer width in pixels.
+  * @param  Dst, DstPitch: destination first pixel and buffer width in pixels.
+  * @param  Width, Height: rectangle size in pixels.
+  * @param  ColorMode: pixel format of both buffers (CM_RGB565, CM_ARGB8888, ...).
+  * @retval SUCCESS, ERROR if the queue is full (see GFX_Submit)
+  */
+ErrorStatus GFX_Copy(uint32_t Src, uint16_t SrcPitch, uint32_t Dst, uint16_t DstPitch, uint16_t Width, uint16_t Height, uint32_t ColorMode)
+{
+  GFX_Command cmd = {0};
+
+  if((Width == 0) || (Height == 0))
+  {
+    return SUCCESS;
+  }
+
+  cmd.CR      = DMA2D_M2M;
+  cmd.FGMAR   = Src;
+  cmd.FGOR    = SrcPitch - Width;
+  cmd.FGPFCCR = ColorMode;
+  cmd.OPFCCR  = ColorMode;
+  cmd.OMAR    = Dst;
+  cmd.OOR     = DstPitch - Width;
+  cmd.NLR     = ((uint32_t)Width << 16) | Height;
+
+  return GFX_Submit(&cmd);
+}
+
+/**
+  * @brief  Copies a rectangle and converts its pixel format.
+  * @param  Src, SrcPitch: source first pixel and buffer width in pixels.
+  * @param  SrcColorMode: input format (CM_ARGB8888 ... CM_A4).
+  * @param  Dst, DstPitch: destination first pixel and buffer width in pixels.
+  * @param  DstColorMode: output format (DMA2D_ARGB8888 ... DMA2D_ARGB4444).
+  * @param  Width, Height: rectangle size in pixels.
+  * @retval SUCCESS, ERROR if the queue is full (see GFX_Submit)
+  */
+ErrorStatus GFX_Convert(uint32_t Src, uint16_t SrcPitch, uint32_t SrcColorMode, uint32_t Dst, uint16_t DstPitch, uint32_t DstColorMode, uint16_t Width, uint16_t Height)
+{
+  GFX_Command cmd = {0};
+
+  if((Width == 0) || (Height == 0))
+  {
+    return SUCCESS;
+  }
+
+  cmd.CR      = DMA2D_M2M_PFC;
+  cmd.FGMAR   = Src;
+  cmd.FGOR    = SrcPitch - Width;
+  cmd.FGPFCCR = SrcColorMode;
+  cmd.OPFCCR  = DstColorMode;
+  cmd.OMAR    = Dst;
+  cmd.OOR     = DstPitch - Width;
+  cmd.NLR     = ((uint32_t)Width << 16) | Height;
+
+  return GFX_Submit(&cmd);
+}
+
+/**
+  * @brief  Draws a solid color through an alpha mask onto a buffer
+  *         (memory to memory with blending, destination is also background).
+  * @param  Mask, MaskPitch: first mask pixel and mask width in pixels.
+  * @param  MaskColorMode: CM_A8 or CM_A4.
+  * @param  Color: RGB888 color of the mask pixels.
+  * @param  Dst, DstPitch: destination first pixel and buffer width in pixels.
+  * @param  DstColorMode: destination format (DMA2D_RGB565, DMA2D_ARGB8888, ...).
+  * @param  Width, Height: rectangle size in pixels.
+  * @retval SUCCESS, ERROR if the queue is full (see GFX_Submit)
+  */
+ErrorStatus GFX_BlendMask(uint32_t Mask, uint16_t MaskPitch, uint32_t MaskColorMode, uint32_t Color, uint32_t Dst, uint16_t DstPitch, uint32_t DstColorMode, uint16_t Width, uint16_t Height)
+{
+  GFX_Command cmd = {0};
+
+  if((Width == 0) || (Height == 0))
+  {
+    return SUCCESS;
+  }
+
+  cmd.CR      = DMA2D_M2M_BLEND;
+  cmd.FGMAR   = Mask;
+  cmd.FGOR    = MaskPitch - Width;
+  cmd.FGPFCCR = MaskColorMode;
+  cmd.FGCOLR  = Color & 0x00FFFFFF;
+  cmd.BGMAR   = Dst;
+  cmd.BGOR    = DstPitch - Width;
+  cmd.BGPFCCR = DstColorMode;
+  cmd.OPFCCR  = DstColorMode;
+  cmd.OMAR    = Dst;
+  cmd.OOR     = DstPitch - Width;
+  cmd.NLR     = ((uint32_t)Width << 16) | Height;
+
+  return GFX_Submit(&cmd);
+}
+
+/**
+  * @brief  Checks if a transfer is running or queued.
+  * @param  None
+  * @retval 1 while DMA2D has work, 0 when idle
+  */
+uint8_t GFX_IsBusy(void)
+{
+  return GFX_Running;
+}
+
+/**
+  * @brief  Waits until every queued transfer is done.
+  *         Must be called with interrupts enabled.
+  * @param  None
+  * @retval None
+  */
+void GFX_Wait(void)
+{
+  while(GFX_Running != 0)
+  {
+  }
+}
+
+/**
+  * @brief  Returns the number of transfer and configuration errors.
+  * @param  None
+  * @retval Error count
+  */
+uint32_t GFX_GetErrors(void)
+{
+  return GFX_Errors;
+}
+
+/**
+  * @brief  Handles DMA2D interrupt: releases the finished transfer and
+  *         starts the next one from the queue.
+  * @param  None
+  * @retval None
+  */
+void GFX_DMA2D_IRQHandler(void)
+{
+  uint32_t flags = DMA2D->ISR;
+
+  DMA2D->IFCR = GFX_FLAG_MASK;
+
+  if((flags & (DMA2D_ISR_TCIF | DMA2D_ISR_TEIF | DMA2D_ISR_CEIF)) == 0)
+  {
+    return;
+  }
+
+  if((flags & (DMA2D_ISR_TEIF | DMA2D_ISR_CEIF)) != 0)
+  {
+    GFX_Errors++;
+  }
+
+  GFX_Tail++;
+
+  if(GFX_Tail != GFX_Head)
+  {
+    GFX_StartNext();
+  }
+  else
+  {
+    GFX_Running = 0;
+  }
+}
+
+/**
+  * @}
+  */ 
+
+/**
+  * @}
+  */ 
+  
+/**
+  * @}
+  */ 
+
+/**
+  * @}
+  */ 
+
+/**
+  * @}
+  */  
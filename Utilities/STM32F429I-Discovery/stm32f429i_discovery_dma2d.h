@@ -0,0 +1,117 @@
+/**
+  ******************************************************************************
+  * @file    stm32f429i_discovery_dma2d.h
+  * @author  Islam Ehab
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   This file contains all the functions prototypes for the 
+  *          stm32f429i_discovery_dma2d.c driver.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM32F429I_DISCOVERY_DMA2D_H
+#define __STM32F429I_DISCOVERY_DMA2D_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif 
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32f4xx.h"
+
+/** @addtogroup Utilities
+  * @{
+  */
+
+/** @addtogroup STM32F4_DISCOVERY
+  * @{
+  */ 
+
+/** @addtogroup STM32F429I_DISCOVERY
+  * @{
+  */
+    
+/** @addtogroup STM32F429I_DISCOVERY_DMA2D
+  * @{
+  */ 
+
+/** @defgroup STM32F429I_DISCOVERY_DMA2D_Exported_Types
+  * @{
+  */
+
+/** 
+  * @brief  One queued DMA2D transfer, fields are the register values to load
+  */
+typedef struct
+{
+  uint32_t CR;          /*!< Mode (DMA2D_R2M, DMA2D_M2M, DMA2D_M2M_PFC or DMA2D_M2M_BLEND) */
+  uint32_t FGMAR;
+  uint32_t FGOR;
+  uint32_t FGPFCCR;
+  uint32_t FGCOLR;
+  uint32_t BGMAR;
+  uint32_t BGOR;
+  uint32_t BGPFCCR;
+  uint32_t OPFCCR;
+  uint32_t OCOLR;
+  uint32_t OMAR;
+  uint32_t OOR;
+  uint32_t NLR;         /*!< (Pixels per line << 16) | Number of lines */
+} GFX_Command;
+/**
+  * @}
+  */ 
+
+/** @defgroup STM32F429I_DISCOVERY_DMA2D_Exported_Constants
+  * @{
+  */ 
+
+/* Number of transfers that can wait behind the running one */
+#define GFX_QUEUE_SIZE          16
+
+/* DMA2D interrupt */
+#define GFX_DMA2D_IRQn          DMA2D_IRQn
+#define GFX_DMA2D_IRQHandler    DMA2D_IRQHandler
+/**
+  * @}
+  */ 
+
+/** @defgroup STM32F429I_DISCOVERY_DMA2D_Exported_Functions
+  * @{
+  */
+void        GFX_Init(void);
+ErrorStatus GFX_Submit(const GFX_Command *Command);
+ErrorStatus GFX_Fill(uint32_t Address, uint16_t Pitch, uint16_t Width, uint16_t Height, uint32_t ColorMode, uint32_t Color);
+ErrorStatus GFX_Copy(uint32_t Src, uint16_t SrcPitch, uint32_t Dst, uint16_t DstPitch, uint16_t Width, uint16_t Height, uint32_t ColorMode);
+ErrorStatus GFX_Convert(uint32_t Src, uint16_t SrcPitch, uint32_t SrcColorMode, uint32_t Dst, uint16_t DstPitch, uint32_t DstColorMode, uint16_t Width, uint16_t Height);
+ErrorStatus GFX_BlendMask(uint32_t Mask, uint16_t MaskPitch, uint32_t MaskColorMode, uint32_t Color, uint32_t Dst, uint16_t DstPitch, uint32_t DstColorMode, uint16_t Width, uint16_t Height);
+uint8_t     GFX_IsBusy(void);
+void        GFX_Wait(void);
+uint32_t    GFX_GetErrors(void);
+void        GFX_DMA2D_IRQHandler(void);
+/**
+  * @}
+  */ 
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __STM32F429I_DISCOVERY_DMA2D_H */
+
+/**
+  * @}
+  */ 
+
+/**
+  * @}
+  */ 
+
+/**
+  * @}
+  */ 
+
+/**
+  * @}
+  */
@@ -0,0 +1,721 @@
+/**
+  ******************************************************************************
+  * @file    stm32f429i_discovery_i2c.c
+  * @author  Islam Ehab
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Interrupt driven I2C3 master with a transaction queue.
+  *          Each transaction is run by a state machine in the I2C event and
+  *          error interrupts and chained to the next one on completion, so
+  *          the EEPROM and IO expander drivers share the bus without polling.
+  *          Reads of two bytes or more are received by DMA.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32f429i_discovery_i2c.h"
+
+/** @addtogroup Utilities
+  * @{
+  */
+
+/** @addtogroup STM32F4_DISCOVERY
+  * @{
+  */
+
+/** @addtogroup STM32F429I_DISCOVERY
+  * @{
+  */
+
+/** @defgroup STM32F429I_DISCOVERY_I2C
+  * @brief This file includes the I2C3 transaction queue
+  * @{
+  */
+
+/** @defgroup STM32F429I_DISCOVERY_I2C_Private_Defines
+  * @{
+  */
+/* State of the running transaction */
+#define I2CM_STATE_IDLE         0
+#define I2CM_STATE_START        1     /* START sent, waiting for SB */
+#define I2CM_STATE_ADDR_TX      2     /* Write address sent, waiting for ADDR */
+#define I2CM_STATE_REG          3     /* Sending register bytes on TXE */
+#define I2CM_STATE_TX           4     /* Sending payload bytes on TXE */
+#define I2CM_STATE_BTF          5     /* Last byte written, waiting for BTF */
+#define I2CM_STATE_RESTART      6     /* Repeated START sent, waiting for SB */
+#define I2CM_STATE_ADDR_RX      7     /* Read address sent, waiting for ADDR */
+#define I2CM_STATE_RX           8     /* Single byte read, waiting for RXNE */
+#define I2CM_STATE_RX_DMA       9     /* DMA receiving, waiting for TC */
+
+#define I2CM_ERROR_FLAGS        (I2C_FLAG_AF | I2C_FLAG_BERR | I2C_FLAG_ARLO | I2C_FLAG_OVR)
+
+/* Bound on the wait for the previous STOP before a new START */
+#define I2CM_STOP_TIMEOUT       ((uint32_t)0x1000)
+/**
+  * @}
+  */
+
+/** @defgroup STM32F429I_DISCOVERY_I2C_Private_Variables
+  * @{
+  */
+static I2CM_Transfer I2CM_Queue[I2CM_QUEUE_SIZE];
+/* Head is moved by I2CM_Submit, Tail by the interrupts; Tail is the running
+   transaction while State is not idle */
+static __IO uint32_t I2CM_Head = 0;
+static __IO uint32_t I2CM_Tail = 0;
+static __IO uint8_t  I2CM_State = I2CM_STATE_IDLE;
+static __IO uint16_t I2CM_Index = 0;
+static __IO uint32_t I2CM_Errors = 0;
+static uint8_t       I2CM_Initialized = 0;
+/* RX stream enabled by the running read */
+static uint8_t       I2CM_DmaClaimed = 0;
+/**
+  * @}
+  */
+
+/** @defgroup STM32F429I_DISCOVERY_I2C_Private_FunctionPrototypes
+  * @{
+  */
+static void I2CM_Config(void);
+static uint8_t I2CM_UsesDma(const I2CM_Transfer *Transfer);
+static uint8_t I2CM_DmaTaken(void);
+static uint8_t I2CM_DmaClaim(const I2CM_Transfer *Transfer);
+static void I2CM_Release(void);
+static void I2CM_StartNext(void);
+static void I2CM_Finish(uint8_t Status);
+static void I2CM_RunDone(void *Context, uint8_t Status);
+/**
+  * @}
+  */
+
+/** @defgroup STM32F429I_DISCOVERY_I2C_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Configures and enables the I2C peripheral.
+  * @param  None
+  * @retval None
+  */
+static void I2CM_Config(void)
+{
+  I2C_InitTypeDef I2C_InitStructure;
+
+  I2C_InitStructure.I2C_Mode = I2C_Mode_I2C;
+  I2C_InitStructure.I2C_DutyCycle = I2C_DutyCycle_2;
+  I2C_InitStructure.I2C_OwnAddress1 = 0x00;
+  I2C_InitStructure.I2C_Ack = I2C_Ack_Enable;
+  I2C_InitStructure.I2C_AcknowledgedAddress = I2C_AcknowledgedAddress_7bit;
+  I2C_InitStructure.I2C_ClockSpeed = I2CM_I2C_SPEED;
+  I2C_Init(I2CM_I2C, &I2C_InitStructure);
+
+  I2C_Cmd(I2CM_I2C, ENABLE);
+}
+
+/**
+  * @brief  Tells whether a transaction is received through the RX stream.
+  * @param  Transfer: transaction.
+  * @retval 1 for reads of two bytes or more, 0 otherwise.
+  */
+static uint8_t I2CM_UsesDma(const I2CM_Transfer *Transfer)
+{
+  return (uint8_t)((Transfer->Direction == I2CM_DIR_READ) && (Transfer->Length >= 2));
+}
+
+/**
+  * @brief  Tells whether the RX stream is enabled for another request
+  *         (UART4 Rx ring on channel 4).
+  * @param  None
+  * @retval 1 if taken, 0 if free or ours.
+  */
+static uint8_t I2CM_DmaTaken(void)
+{
+  uint32_t cr = I2CM_DMA_RX_STREAM->CR;
+
+  return (uint8_t)(((cr & DMA_SxCR_EN) != 0) && ((cr & DMA_SxCR_CHSEL) != I2CM_DMA_CHANNEL));
+}
+
+/**
+  * @brief  Programs and enables the RX stream for a read. The I2C issues no
+  *         request before its DMA is enabled at ADDR, but the enabled stream
+  *         marks it ours for the whole transaction.
+  * @param  Transfer: read of two bytes or more.
+  * @retval 1 if claimed, 0 if the stream is taken.
+  */
+static uint8_t I2CM_DmaClaim(const I2CM_Transfer *Transfer)
+{
+  DMA_InitTypeDef DMA_InitStructure;
+
+  if(I2CM_DmaTaken() != 0)
+  {
+    return 0;
+  }
+
+  DMA_Cmd(I2CM_DMA_RX_STREAM, DISABLE);
+  DMA_DeInit(I2CM_DMA_RX_STREAM);
+  DMA_InitStructure.DMA_Channel = I2CM_DMA_CHANNEL;
+  DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&I2CM_I2C->DR;
+  DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)Transfer->Buffer;
+  DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralToMemory;
+  DMA_InitStructure.DMA_BufferSize = Transfer->Length;
+  DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+  DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+  DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+  DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+  DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+  DMA_InitStructure.DMA_Priority = DMA_Priority_VeryHigh;
+  DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Disable;
+  DMA_InitStructure.DMA_FIFOThreshold = DMA_FIFOThreshold_Full;
+  DMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+  DMA_InitStructure.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+  DMA_Init(I2CM_DMA_RX_STREAM, &DMA_InitStructure);
+  DMA_ClearFlag(I2CM_DMA_RX_STREAM, I2CM_DMA_RX_FLAGS);
+  DMA_ITConfig(I2CM_DMA_RX_STREAM, DMA_IT_TC | DMA_IT_TE, ENABLE);
+  DMA_Cmd(I2CM_DMA_RX_STREAM, ENABLE);
+
+  I2CM_DmaClaimed = 1;
+
+  return 1;
+}
+
+/**
+  * @brief  Stops interrupts and DMA of the running transaction and puts the
+  *         peripheral back in its idle configuration. The RX stream is only
+  *         touched if the transaction enabled it.
+  * @param  None
+  * @retval None
+  */
+static void I2CM_Release(void)
+{
+  I2C_ITConfig(I2CM_I2C, I2C_IT_EVT | I2C_IT_BUF | I2C_IT_ERR, DISABLE);
+
+  if(I2CM_DmaClaimed != 0)
+  {
+    DMA_Cmd(I2CM_DMA_RX_STREAM, DISABLE);
+    while(DMA_GetCmdStatus(I2CM_DMA_RX_STREAM) != DISABLE)
+    {
+    }
+    DMA_ClearFlag(I2CM_DMA_RX_STREAM, I2CM_DMA_RX_FLAGS);
+    I2CM_DmaClaimed = 0;
+  }
+
+  I2C_DMACmd(I2CM_I2C, DISABLE);
+  I2C_DMALastTransferCmd(I2CM_I2C, DISABLE);
+
+  I2C_AcknowledgeConfig(I2CM_I2C, ENABLE);
+}
+
+/**
+  * @brief  Starts the transaction at the queue tail.
+  * @param  None
+  * @retval None
+  */
+static void I2CM_StartNext(void)
+{
+  const I2CM_Transfer *xfer = &I2CM_Queue[I2CM_Tail % I2CM_QUEUE_SIZE];
+  uint32_t timeout = I2CM_STOP_TIMEOUT;
+
+  /* The STOP ending the previous transaction may still be on the bus */
+  while((I2CM_I2C->CR1 & I2C_CR1_STOP) && (timeout-- != 0))
+  {
+  }
+
+  I2CM_Index = 0;
+  I2CM_State = I2CM_STATE_START;
+
+  /* A read the stream can't serve ends before its START, the next one runs */
+  if((I2CM_UsesDma(xfer) != 0) && (I2CM_DmaClaim(xfer) == 0))
+  {
+    I2CM_Finish(I2CM_DMA_BUSY);
+    return;
+  }
+
+  I2C_ITConfig(I2CM_I2C, I2C_IT_EVT | I2C_IT_ERR, ENABLE);
+  I2C_GenerateSTART(I2CM_I2C, ENABLE);
+}
+
+/**
+  * @brief  Ends the running transaction, reports it and starts the next one.
+  * @param  Status: I2CM_OK or the error passed to the callback.
+  * @retval None
+  */
+static void I2CM_Finish(uint8_t Status)
+{
+  const I2CM_Transfer *xfer = &I2CM_Queue[I2CM_Tail % I2CM_QUEUE_SIZE];
+  I2CM_Callback callback = xfer->Callback;
+  void *context = xfer->Context;
+
+  I2CM_Release();
+
+  if(Status != I2CM_OK)
+  {
+    I2CM_Errors++;
+  }
+
+  /* The slot may be reused by a submit from the callback */
+  I2CM_State = I2CM_STATE_IDLE;
+  I2CM_Tail++;
+
+  if(callback != 0)
+  {
+    callback(context, Status);
+  }
+
+  if((I2CM_State == I2CM_STATE_IDLE) && (I2CM_Tail != I2CM_Head))
+  {
+    I2CM_StartNext();
+  }
+}
+
+/**
+  * @brief  Completion callback of I2CM_Run().
+  * @param  Context: status variable of the waiting caller.
+  * @param  Status: transaction status.
+  * @retval None
+  */
+static void I2CM_RunDone(void *Context, uint8_t Status)
+{
+  *(__IO uint8_t *)Context = Status;
+}
+
+/**
+  * @brief  Configures the I2C pins, peripheral and interrupts. The RX DMA
+  *         stream is programmed by each read, it is shared with UART4.
+  *         Does nothing if already done, so every driver on the bus can call it.
+  * @param  None
+  * @retval None
+  */
+void I2CM_Init(void)
+{
+  GPIO_InitTypeDef GPIO_InitStructure;
+  NVIC_InitTypeDef NVIC_InitStructure;
+
+  if(I2CM_Initialized != 0)
+  {
+    return;
+  }
+
+  RCC_APB1PeriphClockCmd(I2CM_I2C_CLK, ENABLE);
+  RCC_AHB1PeriphClockCmd(I2CM_SCL_GPIO_CLK | I2CM_SDA_GPIO_CLK | I2CM_DMA_CLK, ENABLE);
+
+  RCC_APB1PeriphResetCmd(I2CM_I2C_CLK, ENABLE);
+  RCC_APB1PeriphResetCmd(I2CM_I2C_CLK, DISABLE);
+
+  GPIO_PinAFConfig(I2CM_SCL_GPIO_PORT, I2CM_SCL_SOURCE, I2CM_SCL_AF);
+  GPIO_PinAFConfig(I2CM_SDA_GPIO_PORT, I2CM_SDA_SOURCE, I2CM_SDA_AF);
+
+  GPIO_InitStructure.GPIO_Pin = I2CM_SCL_PIN;
+  GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF;
+  GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+  GPIO_InitStructure.GPIO_OType = GPIO_OType_OD;
+  GPIO_InitStructure.GPIO_PuPd  = GPIO_PuPd_NOPULL;
+  GPIO_Init(I2CM_SCL_GPIO_PORT, &GPIO_InitStructure);
+
+  GPIO_InitStructure.GPIO_Pin = I2CM_SDA_PIN;
+  GPIO_Init(I2CM_SDA_GPIO_PORT, &GPIO_InitStructure);
+
+  I2CM_Config();
+
+  I2CM_DmaClaimed = 0;
+  I2CM_Head = 0;
+  I2CM_Tail = 0;
+  I2CM_State = I2CM_STATE_IDLE;
+  I2CM_Errors = 0;
+
+  NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = I2CM_IT_PREPRIO;
+  NVIC_InitStructure.NVIC_IRQChannelSubPriority = I2CM_IT_SUBPRIO;
+  NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+  NVIC_InitStructure.NVIC_IRQChannel = I2CM_EV_IRQn;
+  NVIC_Init(&NVIC_InitStructure);
+  NVIC_InitStructure.NVIC_IRQChannel = I2CM_ER_IRQn;
+  NVIC_Init(&NVIC_InitStructure);
+  NVIC_InitStructure.NVIC_IRQChannel = I2CM_DMA_RX_IRQn;
+  NVIC_Init(&NVIC_InitStructure);
+
+  I2CM_Initialized = 1;
+}
+
+/**
+  * @brief  Disables the I2C peripheral, its DMA stream and interrupts and
+  *         releases the pins. Queued transactions are dropped unreported.
+  * @param  None
+  * @retval None
+  */
+void I2CM_DeInit(void)
+{
+  GPIO_InitTypeDef GPIO_InitStructure;
+  NVIC_InitTypeDef NVIC_InitStructure;
+
+  NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = I2CM_IT_PREPRIO;
+  NVIC_InitStructure.NVIC_IRQChannelSubPriority = I2CM_IT_SUBPRIO;
+  NVIC_InitStructure.NVIC_IRQChannelCmd = DISABLE;
+  NVIC_InitStructure.NVIC_IRQChannel = I2CM_EV_IRQn;
+  NVIC_Init(&NVIC_InitStructure);
+  NVIC_InitStructure.NVIC_IRQChannel = I2CM_ER_IRQn;
+  NVIC_Init(&NVIC_InitStructure);
+  NVIC_InitStructure.NVIC_IRQChannel = I2CM_DMA_RX_IRQn;
+  NVIC_Init(&NVIC_InitStructure);
+
+  /* Leaves the RX stream alone unless a read of ours holds it */
+  I2CM_Release();
+
+  I2C_Cmd(I2CM_I2C, DISABLE);
+  I2C_DeInit(I2CM_I2C);
+  RCC_APB1PeriphClockCmd(I2CM_I2C_CLK, DISABLE);
+
+  GPIO_InitStructure.GPIO_Pin = I2CM_SCL_PIN;
+  GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IN;
+  GPIO_InitStructure.GPIO_PuPd = GPIO_PuPd_NOPULL;
+  GPIO_Init(I2CM_SCL_GPIO_PORT, &GPIO_InitStructure);
+
+  GPIO_InitStructure.GPIO_Pin = I2CM_SDA_PIN;
+  GPIO_Init(I2CM_SDA_GPIO_PORT, &GPIO_InitStructure);
+
+  I2CM_Head = 0;
+  I2CM_Tail = 0;
+  I2CM_State = I2CM_STATE_IDLE;
+  I2CM_Initialized = 0;
+}
+
+/**
+  * @brief  Software resets the I2C peripheral and ends the running
+  *         transaction with I2CM_TIMEOUT. Queued ones then continue.
+  * @param  None
+  * @retval None
+  */
+void I2CM_Reset(void)
+{
+  uint32_t primask;
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+
+  I2CM_Release();
+  I2C_SoftwareResetCmd(I2CM_I2C, ENABLE);
+  I2C_SoftwareResetCmd(I2CM_I2C, DISABLE);
+  I2CM_Config();
+
+  if(I2CM_State != I2CM_STATE_IDLE)
+  {
+    I2CM_Finish(I2CM_TIMEOUT);
+  }
+
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  Queues a transaction, starts it at once if the bus is idle.
+  *         Can be called from the completion callback.
+  * @param  Transfer: transaction, copied into the queue. The buffer it points
+  *         to must stay valid until the callback.
+  * @retval I2CM_OK, I2CM_QUEUE_FULL, I2CM_INVALID (read of zero bytes) or
+  *         I2CM_DMA_BUSY (read of two bytes or more, RX stream taken).
+  */
+uint8_t I2CM_Submit(const I2CM_Transfer *Transfer)
+{
+  uint32_t primask;
+
+  if(((Transfer->Direction == I2CM_DIR_READ) && (Transfer->Length == 0)) ||
+     (Transfer->RegSize > 2))
+  {
+    return I2CM_INVALID;
+  }
+
+  /* Stream ownership conflict: the UART4 Rx ring holds DMA1 Stream2 */
+  assert_param((I2CM_UsesDma(Transfer) == 0) || (I2CM_DmaTaken() == 0));
+  if((I2CM_UsesDma(Transfer) != 0) && (I2CM_DmaTaken() != 0))
+  {
+    return I2CM_DMA_BUSY;
+  }
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+
+  if((I2CM_Head - I2CM_Tail) >= I2CM_QUEUE_SIZE)
+  {
+    __set_PRIMASK(primask);
+    return I2CM_QUEUE_FULL;
+  }
+
+  I2CM_Queue[I2CM_Head % I2CM_QUEUE_SIZE] = *Transfer;
+  I2CM_Head++;
+
+  if(I2CM_State == I2CM_STATE_IDLE)
+  {
+    I2CM_StartNext();
+  }
+
+  __set_PRIMASK(primask);
+
+  return I2CM_OK;
+}
+
+/**
+  * @brief  Queues a transaction and waits for it to complete. The bus is
+  *         reset if it does not complete in time. The Callback and Context of
+  *         Transfer are not used. Must not be called from an interrupt.
+  * @param  Transfer: transaction to run.
+  * @retval Transaction status.
+  */
+uint8_t I2CM_Run(const I2CM_Transfer *Transfer)
+{
+  I2CM_Transfer xfer = *Transfer;
+  __IO uint8_t status = I2CM_PENDING;
+  uint32_t timeout;
+  uint8_t ret;
+
+  xfer.Callback = I2CM_RunDone;
+  xfer.Context = (void *)&status;
+
+  while((ret = I2CM_Submit(&xfer)) == I2CM_QUEUE_FULL)
+  {
+  }
+
+  if(ret != I2CM_OK)
+  {
+    return ret;
+  }
+
+  timeout = I2CM_RUN_TIMEOUT;
+  while(status == I2CM_PENDING)
+  {
+    if(timeout-- == 0)
+    {
+      /* Aborts whichever transaction holds the bus, ours may be behind it */
+      I2CM_Reset();
+      timeout = I2CM_RUN_TIMEOUT;
+    }
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Tells whether a transaction is running or queued.
+  * @param  None
+  * @retval 1 if busy, 0 otherwise.
+  */
+uint8_t I2CM_IsBusy(void)
+{
+  return (uint8_t)((I2CM_State != I2CM_STATE_IDLE) || (I2CM_Head != I2CM_Tail));
+}
+
+/**
+  * @brief  Returns the number of transactions that ended with an error.
+  * @param  None
+  * @retval Error count since I2CM_Init().
+  */
+uint32_t I2CM_GetErrors(void)
+{
+  return I2CM_Errors;
+}
+
+/**
+  * @brief  This function handles the I2C event interrupt: moves the running
+  *         transaction through START, address, register, payload and STOP.
+  * @param  None
+  * @retval None
+  */
+void I2CM_EV_IRQHandler(void)
+{
+  const I2CM_Transfer *xfer = &I2CM_Queue[I2CM_Tail % I2CM_QUEUE_SIZE];
+  uint16_t sr1 = I2CM_I2C->SR1;
+
+  switch(I2CM_State)
+  {
+  case I2CM_STATE_START:
+  case I2CM_STATE_RESTART:
+    if(sr1 & I2C_SR1_SB)
+    {
+      /* Reading SR1 then writing DR clears SB */
+      if((I2CM_State == I2CM_STATE_RESTART) ||
+         ((xfer->Direction == I2CM_DIR_READ) && (xfer->RegSize == 0)))
+      {
+        I2C_Send7bitAddress(I2CM_I2C, xfer->Address, I2C_Direction_Receiver);
+        I2CM_State = I2CM_STATE_ADDR_RX;
+      }
+      else
+      {
+        I2C_Send7bitAddress(I2CM_I2C, xfer->Address, I2C_Direction_Transmitter);
+        I2CM_State = I2CM_STATE_ADDR_TX;
+      }
+    }
+    break;
+
+  case I2CM_STATE_ADDR_TX:
+    if(sr1 & I2C_SR1_ADDR)
+    {
+      /* Reading SR1 then SR2 clears ADDR */
+      (void)I2CM_I2C->SR2;
+      I2CM_Index = 0;
+
+      if((xfer->RegSize == 0) && (xfer->Length == 0))
+      {
+        /* Address only, the slave acknowledged it */
+        I2C_GenerateSTOP(I2CM_I2C, ENABLE);
+        I2CM_Finish(I2CM_OK);
+      }
+      else
+      {
+        I2CM_State = (xfer->RegSize != 0) ? I2CM_STATE_REG : I2CM_STATE_TX;
+        I2C_ITConfig(I2CM_I2C, I2C_IT_BUF, ENABLE);
+      }
+    }
+    break;
+
+  case I2CM_STATE_REG:
+    if(sr1 & I2C_SR1_TXE)
+    {
+      /* Register address, MSB first */
+      I2C_SendData(I2CM_I2C, (uint8_t)(xfer->Register >> (8 * (xfer->RegSize - 1 - I2CM_Index))));
+
+      if(++I2CM_Index == xfer->RegSize)
+      {
+        I2CM_Index = 0;
+        if((xfer->Direction == I2CM_DIR_WRITE) && (xfer->Length != 0))
+        {
+          I2CM_State = I2CM_STATE_TX;
+        }
+        else
+        {
+          I2C_ITConfig(I2CM_I2C, I2C_IT_BUF, DISABLE);
+          I2CM_State = I2CM_STATE_BTF;
+        }
+      }
+    }
+    break;
+
+  case I2CM_STATE_TX:
+    if(sr1 & I2C_SR1_TXE)
+    {
+      I2C_SendData(I2CM_I2C, xfer->Buffer[I2CM_Index]);
+
+      if(++I2CM_Index == xfer->Length)
+      {
+        I2C_ITConfig(I2CM_I2C, I2C_IT_BUF, DISABLE);
+        I2CM_State = I2CM_STATE_BTF;
+      }
+    }
+    break;
+
+  case I2CM_STATE_BTF:
+    if(sr1 & I2C_SR1_BTF)
+    {
+      /* START or STOP clears BTF */
+      if(xfer->Direction == I2CM_DIR_READ)
+      {
+        I2CM_State = I2CM_STATE_RESTART;
+        I2C_GenerateSTART(I2CM_I2C, ENABLE);
+      }
+      else
+      {
+        I2C_GenerateSTOP(I2CM_I2C, ENABLE);
+        I2CM_Finish(I2CM_OK);
+      }
+    }
+    break;
+
+  case I2CM_STATE_ADDR_RX:
+    if(sr1 & I2C_SR1_ADDR)
+    {
+      if(xfer->Length == 1)
+      {
+        /* NACK and STOP must be set before ADDR is cleared */
+        I2C_AcknowledgeConfig(I2CM_I2C, DISABLE);
+        (void)I2CM_I2C->SR2;
+        I2C_GenerateSTOP(I2CM_I2C, ENABLE);
+        I2C_ITConfig(I2CM_I2C, I2C_IT_BUF, ENABLE);
+        I2CM_State = I2CM_STATE_RX;
+      }
+      else
+      {
+        /* The stream armed at START must request before ADDR is cleared;
+           LAST makes the I2C NACK the final byte, the DMA interrupt then
+           sends STOP */
+        I2C_DMALastTransferCmd(I2CM_I2C, ENABLE);
+        I2C_DMACmd(I2CM_I2C, ENABLE);
+        I2C_ITConfig(I2CM_I2C, I2C_IT_EVT, DISABLE);
+        I2CM_State = I2CM_STATE_RX_DMA;
+        (void)I2CM_I2C->SR2;
+      }
+    }
+    break;
+
+  case I2CM_STATE_RX:
+    if(sr1 & I2C_SR1_RXNE)
+    {
+      xfer->Buffer[0] = I2C_ReceiveData(I2CM_I2C);
+      I2CM_Finish(I2CM_OK);
+    }
+    break;
+
+  default:
+    /* No transaction owns the bus */
+    I2C_ITConfig(I2CM_I2C, I2C_IT_EVT | I2C_IT_BUF, DISABLE);
+    break;
+  }
+}
+
+/**
+  * @brief  This function handles the I2C error interrupt: ends the running
+  *         transaction with I2CM_NACK or I2CM_BUS_ERROR.
+  * @param  None
+  * @retval None
+  */
+void I2CM_ER_IRQHandler(void)
+{
+  uint16_t sr1 = I2CM_I2C->SR1;
+
+  I2C_ClearFlag(I2CM_I2C, I2CM_ERROR_FLAGS);
+
+  /* After a lost arbitration the peripheral is already back in slave mode */
+  if((sr1 & I2C_SR1_ARLO) == 0)
+  {
+    I2C_GenerateSTOP(I2CM_I2C, ENABLE);
+  }
+
+  if(I2CM_State != I2CM_STATE_IDLE)
+  {
+    I2CM_Finish((sr1 & I2C_SR1_AF) ? I2CM_NACK : I2CM_BUS_ERROR);
+  }
+}
+
+/**
+  * @brief  This function handles the RX DMA stream interrupt: ends a read
+  *         once the last byte is in memory.
+  * @param  None
+  * @retval None
+  */
+void I2CM_DMA_RX_IRQHandler(void)
+{
+  uint8_t status = (DMA_GetFlagStatus(I2CM_DMA_RX_STREAM, I2CM_DMA_RX_FLAG_TEIF) != RESET) ?
+                   I2CM_BUS_ERROR : I2CM_OK;
+
+  DMA_ClearFlag(I2CM_DMA_RX_STREAM, I2CM_DMA_RX_FLAGS);
+
+  if(I2CM_State == I2CM_STATE_RX_DMA)
+  {
+    I2C_GenerateSTOP(I2CM_I2C, ENABLE);
+    I2CM_Finish(status);
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
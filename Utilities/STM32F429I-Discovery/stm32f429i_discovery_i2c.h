@@ -0,0 +1,173 @@
+/**
+  ******************************************************************************
+  * @file    stm32f429i_discovery_i2c.h
+  * @author  Islam Ehab
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   This file contains all the functions prototypes for the
+  *          stm32f429i_discovery_i2c.c driver.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM32F429I_DISCOVERY_I2C_H
+#define __STM32F429I_DISCOVERY_I2C_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32f4xx.h"
+
+/** @addtogroup Utilities
+  * @{
+  */
+
+/** @addtogroup STM32F4_DISCOVERY
+  * @{
+  */
+
+/** @addtogroup STM32F429I_DISCOVERY
+  * @{
+  */
+
+/** @addtogroup STM32F429I_DISCOVERY_I2C
+  * @{
+  */
+
+/** @defgroup STM32F429I_DISCOVERY_I2C_Exported_Types
+  * @{
+  */
+
+/**
+  * @brief  Completion callback, called from the I2C/DMA interrupt
+  */
+typedef void (*I2CM_Callback)(void *Context, uint8_t Status);
+
+/**
+  * @brief  One queued I2C master transaction:
+  *         START, address, register bytes, then the payload written, or a
+  *         repeated START and the payload read.
+  */
+typedef struct
+{
+  uint8_t       Address;    /*!< Slave address, 8-bit form (R/W bit = 0) */
+  uint8_t       Direction;  /*!< I2CM_DIR_WRITE or I2CM_DIR_READ */
+  uint8_t       RegSize;    /*!< Register address bytes sent first (0..2, MSB first) */
+  uint16_t      Register;   /*!< Register or memory address */
+  uint8_t      *Buffer;     /*!< Payload, must stay valid until the callback */
+  uint16_t      Length;     /*!< Payload bytes, a read needs at least one */
+  I2CM_Callback Callback;   /*!< Called when done, may be 0 */
+  void         *Context;    /*!< Passed back to Callback */
+} I2CM_Transfer;
+/**
+  * @}
+  */
+
+/** @defgroup STM32F429I_DISCOVERY_I2C_Exported_Constants
+  * @{
+  */
+
+/* Transfer direction */
+#define I2CM_DIR_WRITE          0
+#define I2CM_DIR_READ           1
+
+/* Transfer status, passed to the callback */
+#define I2CM_OK                 0
+#define I2CM_NACK               1     /*!< Address or data not acknowledged */
+#define I2CM_BUS_ERROR          2     /*!< Bus error, arbitration lost or DMA error */
+#define I2CM_TIMEOUT            3     /*!< Aborted by I2CM_Reset() */
+#define I2CM_QUEUE_FULL         4     /*!< I2CM_Submit() only */
+#define I2CM_INVALID            5     /*!< I2CM_Submit() only */
+#define I2CM_DMA_BUSY           6     /*!< Read needs the RX stream, enabled for another request */
+#define I2CM_PENDING            0xFF
+
+/* Number of queued transactions, the running one included */
+#define I2CM_QUEUE_SIZE         8
+
+/* Spin count after which I2CM_Run() resets a stuck bus */
+#define I2CM_RUN_TIMEOUT        ((uint32_t)0x100000)
+
+/* Bus shared by the EEPROM and the IO expander */
+#define I2CM_I2C                I2C3
+#define I2CM_I2C_CLK            RCC_APB1Periph_I2C3
+#define I2CM_I2C_SPEED          100000
+#define I2CM_SCL_PIN            GPIO_Pin_8                  /* PA.08 */
+#define I2CM_SCL_GPIO_PORT      GPIOA
+#define I2CM_SCL_GPIO_CLK       RCC_AHB1Periph_GPIOA
+#define I2CM_SCL_SOURCE         GPIO_PinSource8
+#define I2CM_SCL_AF             GPIO_AF_I2C3
+#define I2CM_SDA_PIN            GPIO_Pin_9                  /* PC.09 */
+#define I2CM_SDA_GPIO_PORT      GPIOC
+#define I2CM_SDA_GPIO_CLK       RCC_AHB1Periph_GPIOC
+#define I2CM_SDA_SOURCE         GPIO_PinSource9
+#define I2CM_SDA_AF             GPIO_AF_I2C3
+#define I2CM_EV_IRQn            I2C3_EV_IRQn
+#define I2CM_ER_IRQn            I2C3_ER_IRQn
+#define I2CM_EV_IRQHandler      I2C3_EV_IRQHandler
+#define I2CM_ER_IRQHandler      I2C3_ER_IRQHandler
+
+/* I2C3 requests on DMA1 (RM0090 DMA1 request mapping), both streams are
+   shared with UART4:
+   - I2C3_RX: Stream2 channel 3 only, UART4_RX is Stream2 channel 4
+     (Rx ring of xUSART_StartRxRing_DMA)
+   - I2C3_TX: Stream4 channel 3 only, UART4_TX is Stream4 channel 4
+   Writes are short and use TXE interrupts, Stream4 is left to UART4.
+   Reads of two bytes or more take Stream2 from their START to their end:
+   while it is enabled on another channel they fail with I2CM_DMA_BUSY, and
+   the UART4 Rx ring does not start over a running read. Reads of one byte
+   use RXNE and work whatever owns the stream. */
+#define I2CM_DMA_CLK            RCC_AHB1Periph_DMA1
+#define I2CM_DMA_CHANNEL        DMA_Channel_3
+#define I2CM_DMA_RX_STREAM      DMA1_Stream2
+#define I2CM_DMA_RX_FLAG_TEIF   DMA_FLAG_TEIF2
+#define I2CM_DMA_RX_FLAGS       (DMA_FLAG_FEIF2 | DMA_FLAG_DMEIF2 | DMA_FLAG_TEIF2 | DMA_FLAG_HTIF2 | DMA_FLAG_TCIF2)
+#define I2CM_DMA_RX_IRQn        DMA1_Stream2_IRQn
+#define I2CM_DMA_RX_IRQHandler  DMA1_Stream2_IRQHandler
+
+/* Event, error and DMA interrupts share one level so they never nest */
+#define I2CM_IT_PREPRIO         1
+#define I2CM_IT_SUBPRIO         0
+/**
+  * @}
+  */
+
+/** @defgroup STM32F429I_DISCOVERY_I2C_Exported_Functions
+  * @{
+  */
+void     I2CM_Init(void);
+void     I2CM_DeInit(void);
+void     I2CM_Reset(void);
+uint8_t  I2CM_Submit(const I2CM_Transfer *Transfer);
+uint8_t  I2CM_Run(const I2CM_Transfer *Transfer);
+uint8_t  I2CM_IsBusy(void);
+uint32_t I2CM_GetErrors(void);
+void     I2CM_EV_IRQHandler(void);
+void     I2CM_ER_IRQHandler(void);
+void     I2CM_DMA_RX_IRQHandler(void);
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __STM32F429I_DISCOVERY_I2C_H */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
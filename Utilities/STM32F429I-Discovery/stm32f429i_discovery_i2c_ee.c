@@ -13,17 +13,13 @@
   *          ===================================================================
   *              
   *          It implements a high level communication layer for read and write 
-  *          from/to this memory. The needed STM32F4xx hardware resources (I2C and 
-  *          GPIO) are defined in stm32f429i_discovery.h file, and the initialization is 
-  *          performed in sEE_LowLevel_Init() function declared in stm32f429i_discovery_i2c_ee.c 
-  *          file.
-  *          You can easily tailor this driver to any other development board, 
-  *          by just adapting the defines for hardware resources and 
-  *          sEE_LowLevel_Init() function. 
+  *          from/to this memory. The bus is owned by the I2C transaction queue
+  *          (stm32f429i_discovery_i2c.c), which is shared with the IO expander
+  *          driver and initialized by sEE_Init().
   *        
   *          @note In this driver, basic read and write functions (sEE_ReadBuffer() 
-  *                and sEE_WritePage()) use Polling mode to perform the data transfer 
-  *                to/from EEPROM memory.
+  *                and sEE_WritePage()) queue one transaction and return; the
+  *                transfer runs from the I2C interrupts.
   *             
   *     +-----------------------------------------------------------------+
   *     |               Pin assignment for M24LR64 EEPROM                 |                 
@@ -109,8 +105,6 @@
   */
 __IO uint16_t  sEEAddress = 0;   
 __IO uint32_t  sEETimeout = sEE_LONG_TIMEOUT;   
-__IO uint16_t* sEEDataReadPointer;   
-__IO uint8_t*  sEEDataWritePointer;  
 __IO uint8_t   sEEDataNum;
 /**
   * @}
@@ -120,6 +114,8 @@ __IO uint8_t   sEEDataNum;
 /** @defgroup STM32F429I_DISCOVERY_I2C_EE_Private_Function_Prototypes
   * @{
   */ 
+static void sEE_ReadDone(void *Context, uint8_t Status);
+static void sEE_WriteDone(void *Context, uint8_t Status);
 /**
   * @}
   */ 
@@ -136,7 +132,7 @@ __IO uint8_t   sEEDataNum;
   */
 void sEE_DeInit(void)
 {
-  sEE_LowLevel_DeInit(); 
+  I2CM_DeInit(); 
 }
 
 /**
@@ -146,32 +142,41 @@ void sEE_DeInit(void)
   */
 void sEE_Init(void)
 { 
-  I2C_InitTypeDef  I2C_InitStructure;
-  
-  sEE_LowLevel_Init();
-  
-  /*!< I2C configuration */
-  /* sEE_I2C configuration */
-  I2C_InitStructure.I2C_Mode = I2C_Mode_I2C;
-  I2C_InitStructure.I2C_DutyCycle = I2C_DutyCycle_2;
-  I2C_InitStructure.I2C_OwnAddress1 = I2C_SLAVE_ADDRESS7;
-  I2C_InitStructure.I2C_Ack = I2C_Ack_Enable;
-  I2C_InitStructure.I2C_AcknowledgedAddress = I2C_AcknowledgedAddress_7bit;
-  I2C_InitStructure.I2C_ClockSpeed = I2C_SPEED;
-    
-  /* Apply sEE_I2C configuration after enabling it */
-  I2C_Init(sEE_I2C, &I2C_InitStructure);
-  
-  /* sEE_I2C Peripheral Enable */
-  I2C_Cmd(sEE_I2C, ENABLE);
-  
-  /* Enable the sEE_I2C peripheral DMA requests */
-  I2C_DMACmd(sEE_I2C, ENABLE);  
+  /*!< The I2C bus and its queue are shared with the IO expander */
+  I2CM_Init();
 
   /*!< Select the EEPROM address */
   sEEAddress = sEE_HW_ADDRESS;   
 }
 
+/**
+  * @brief  Completion of a sEE_ReadBuffer() transaction.
+  * @param  Context : pointer to the caller's count of bytes to read.
+  * @param  Status : transaction status.
+  * @retval None
+  */
+static void sEE_ReadDone(void *Context, uint8_t Status)
+{
+  if(Status == I2CM_OK)
+  {
+    *(__IO uint16_t*)Context = 0;
+  }
+}
+
+/**
+  * @brief  Completion of a sEE_WritePage() transaction.
+  * @param  Context : pointer to the caller's count of bytes to write.
+  * @param  Status : transaction status.
+  * @retval None
+  */
+static void sEE_WriteDone(void *Context, uint8_t Status)
+{
+  if(Status == I2CM_OK)
+  {
+    *(__IO uint8_t*)Context = 0;
+  }
+}
+
 /**
   * @brief  Reads a block of data from the EEPROM.
   * @param  pBuffer : pointer to the buffer that receives the data read from 
@@ -184,145 +189,32 @@ void sEE_Init(void)
   *              data are read from the EEPROM. Application should monitor this 
   *              variable in order know when the transfer is complete.
   * 
-  * @note When number of data to be read is higher than 1, this function just 
-  *       configures the communication and enable the DMA channel to transfer data.
-  *       Meanwhile, the user application may perform other tasks.
-  *       When number of data to be read is 1, then the DMA is not used. The byte
-  *       is read in polling mode.
+  * @note This function just queues the transaction on the I2C bus. Meanwhile,
+  *       the user application may perform other tasks. When number of data to
+  *       be read is higher than 1, the data is received by DMA.
   * 
-  * @retval sEE_OK (0) if operation is correctly performed, else return value 
-  *         different from sEE_OK (0) or the timeout user callback.
+  * @retval sEE_OK (0) if the transaction is queued, sEE_FAIL if the I2C 
+  *         queue is full.
   */
 uint32_t sEE_ReadBuffer(uint8_t* pBuffer, uint16_t ReadAddr, uint16_t* NumByteToRead)
 {  
-  /* Set the pointer to the Number of data to be read. This pointer will be used 
-      by the DMA Transfer Completer interrupt Handler in order to reset the 
-      variable to 0. User should check on this variable in order to know if the 
-      DMA transfer has been complete or not. */
-  sEEDataReadPointer = NumByteToRead;
-  
-  /*!< While the bus is busy */
-  sEETimeout = sEE_LONG_TIMEOUT;
-  while(I2C_GetFlagStatus(sEE_I2C, I2C_FLAG_BUSY))
-  {
-    if((sEETimeout--) == 0) return sEE_TIMEOUT_UserCallback();
-  }
-  
-  /*!< Send START condition */
-  I2C_GenerateSTART(sEE_I2C, ENABLE);
-  
-  /*!< Test on EV5 and clear it (cleared by reading SR1 then writing to DR) */
-  sEETimeout = sEE_FLAG_TIMEOUT;
-  while(!I2C_CheckEvent(sEE_I2C, I2C_EVENT_MASTER_MODE_SELECT))
-  {
-    if((sEETimeout--) == 0) return sEE_TIMEOUT_UserCallback();
-  }
-  
-  /*!< Send EEPROM address for write */
-  I2C_Send7bitAddress(sEE_I2C, sEEAddress, I2C_Direction_Transmitter);
-
-  /*!< Test on EV6 and clear it */
-  sEETimeout = sEE_FLAG_TIMEOUT;
-  while(!I2C_CheckEvent(sEE_I2C, I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED))
-  {
-    if((sEETimeout--) == 0) return sEE_TIMEOUT_UserCallback();
-  } 
-
-  /*!< Send the EEPROM's internal address to read from: MSB of the address first */
-  I2C_SendData(sEE_I2C, (uint8_t)((ReadAddr & 0xFF00) >> 8));    
-
-  /*!< Test on EV8 and clear it */
-  sEETimeout = sEE_FLAG_TIMEOUT;
-  while(!I2C_CheckEvent(sEE_I2C, I2C_EVENT_MASTER_BYTE_TRANSMITTING))
+  I2CM_Transfer xfer;
+
+  xfer.Address = (uint8_t)sEEAddress;
+  xfer.Direction = I2CM_DIR_READ;
+  xfer.RegSize = 2;
+  xfer.Register = ReadAddr;
+  xfer.Buffer = pBuffer;
+  xfer.Length = *NumByteToRead;
+  /* The callback resets *NumByteToRead to 0 once the data is in pBuffer */
+  xfer.Callback = sEE_ReadDone;
+  xfer.Context = NumByteToRead;
+
+  if(I2CM_Submit(&xfer) != I2CM_OK)
   {
-    if((sEETimeout--) == 0) return sEE_TIMEOUT_UserCallback();
+    return sEE_FAIL;
   }
 
-  /*!< Send the EEPROM's internal address to read from: LSB of the address */
-  I2C_SendData(sEE_I2C, (uint8_t)(ReadAddr & 0x00FF));    
-
-  /*!< Test on EV8 and clear it */
-  sEETimeout = sEE_FLAG_TIMEOUT;
-  while(I2C_GetFlagStatus(sEE_I2C, I2C_FLAG_BTF) == RESET)
-  {
-    if((sEETimeout--) == 0) return sEE_TIMEOUT_UserCallback();
-  }
-  
-  /*!< Send STRAT condition a second time */  
-  I2C_GenerateSTART(sEE_I2C, ENABLE);
-  
-  /*!< Test on EV5 and clear it (cleared by reading SR1 then writing to DR) */
-  sEETimeout = sEE_FLAG_TIMEOUT;
-  while(!I2C_CheckEvent(sEE_I2C, I2C_EVENT_MASTER_MODE_SELECT))
-  {
-    if((sEETimeout--) == 0) return sEE_TIMEOUT_UserCallback();
-  } 
-  
-  /*!< Send EEPROM address for read */
-  I2C_Send7bitAddress(sEE_I2C, sEEAddress, I2C_Direction_Receiver);  
-  
-  /* If number of data to be read is 1, then DMA couldn't be used */
-  /* One Byte Master Reception procedure (POLLING) ---------------------------*/
-  if ((uint16_t)(*NumByteToRead) < 2)
-  {
-    /* Wait on ADDR flag to be set (ADDR is still not cleared at this level */
-    sEETimeout = sEE_FLAG_TIMEOUT;
-    while(I2C_GetFlagStatus(sEE_I2C, I2C_FLAG_ADDR) == RESET)
-    {
-      if((sEETimeout--) == 0) return sEE_TIMEOUT_UserCallback();
-    }     
-    
-    /*!< Disable Acknowledgement */
-    I2C_AcknowledgeConfig(sEE_I2C, DISABLE);   
-    
-    /* Clear ADDR register by reading SR1 then SR2 register (SR1 has already been read) */
-    (void)sEE_I2C->SR2;
-    
-    /*!< Send STOP Condition */
-    I2C_GenerateSTOP(sEE_I2C, ENABLE);
-    
-    /* Wait for the byte to be received */
-    sEETimeout = sEE_FLAG_TIMEOUT;
-    while(I2C_GetFlagStatus(sEE_I2C, I2C_FLAG_RXNE) == RESET)
-    {
-      if((sEETimeout--) == 0) return sEE_TIMEOUT_UserCallback();
-    }
-    
-    /*!< Read the byte received from the EEPROM */
-    *pBuffer = I2C_ReceiveData(sEE_I2C);
-    
-    /*!< Decrement the read bytes counter */
-    (uint16_t)(*NumByteToRead)--;        
-    
-    /* Wait to make sure that STOP control bit has been cleared */
-    sEETimeout = sEE_FLAG_TIMEOUT;
-    while(sEE_I2C->CR1 & I2C_CR1_STOP)
-    {
-      if((sEETimeout--) == 0) return sEE_TIMEOUT_UserCallback();
-    }  
-    
-    /*!< Re-Enable Acknowledgement to be ready for another reception */
-    I2C_AcknowledgeConfig(sEE_I2C, ENABLE);    
-  }
-  else/* More than one Byte Master Reception procedure (DMA) -----------------*/
-  {
-    /*!< Test on EV6 and clear it */
-    sEETimeout = sEE_FLAG_TIMEOUT;
-    while(!I2C_CheckEvent(sEE_I2C, I2C_EVENT_MASTER_RECEIVER_MODE_SELECTED))
-    {
-      if((sEETimeout--) == 0) return sEE_TIMEOUT_UserCallback();
-    }  
-    
-    /* Configure the DMA Rx Channel with the buffer address and the buffer size */
-    sEE_LowLevel_DMAConfig((uint32_t)pBuffer, (uint16_t)(*NumByteToRead), sEE_DIRECTION_RX);
-    
-    /* Inform the DMA that the next End Of Transfer Signal will be the last one */
-    I2C_DMALastTransferCmd(sEE_I2C, ENABLE); 
-    
-    /* Enable the DMA Rx Stream */
-    DMA_Cmd(sEE_I2C_DMA_STREAM_RX, ENABLE);    
-  }
-  
   /* If all operations OK, return sEE_OK (0) */
   return sEE_OK;
 }
@@ -347,75 +239,31 @@ uint32_t sEE_ReadBuffer(uint8_t* pBuffer, uint16_t ReadAddr, uint16_t* NumByteTo
   *              data are written to the EEPROM. Application should monitor this 
   *              variable in order know when the transfer is complete.
   * 
-  * @note This function just configure the communication and enable the DMA 
-  *       channel to transfer data. Meanwhile, the user application may perform 
-  *       other tasks in parallel.
+  * @note This function just queues the transaction on the I2C bus. Meanwhile,
+  *       the user application may perform other tasks in parallel.
   * 
-  * @retval sEE_OK (0) if operation is correctly performed, else return value 
-  *         different from sEE_OK (0) or the timeout user callback.
+  * @retval sEE_OK (0) if the transaction is queued, sEE_FAIL if the I2C 
+  *         queue is full.
   */
 uint32_t sEE_WritePage(uint8_t* pBuffer, uint16_t WriteAddr, uint8_t* NumByteToWrite)
 { 
-  /* Set the pointer to the Number of data to be written. This pointer will be used 
-      by the DMA Transfer Completer interrupt Handler in order to reset the 
-      variable to 0. User should check on this variable in order to know if the 
-      DMA transfer has been complete or not. */
-  sEEDataWritePointer = NumByteToWrite;  
-  
-  /*!< While the bus is busy */
-  sEETimeout = sEE_LONG_TIMEOUT;
-  while(I2C_GetFlagStatus(sEE_I2C, I2C_FLAG_BUSY))
-  {
-    if((sEETimeout--) == 0) return sEE_TIMEOUT_UserCallback();
-  }
-  
-  /*!< Send START condition */
-  I2C_GenerateSTART(sEE_I2C, ENABLE);
-  
-  /*!< Test on EV5 and clear it */
-  sEETimeout = sEE_FLAG_TIMEOUT;
-  while(!I2C_CheckEvent(sEE_I2C, I2C_EVENT_MASTER_MODE_SELECT))
-  {
-    if((sEETimeout--) == 0) return sEE_TIMEOUT_UserCallback();
-  }
-  
-  /*!< Send EEPROM address for write */
-  sEETimeout = sEE_FLAG_TIMEOUT;
-  I2C_Send7bitAddress(sEE_I2C, sEEAddress, I2C_Direction_Transmitter);
-
-  /*!< Test on EV6 and clear it */
-  sEETimeout = sEE_FLAG_TIMEOUT;
-  while(!I2C_CheckEvent(sEE_I2C, I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED))
+  I2CM_Transfer xfer;
+
+  xfer.Address = (uint8_t)sEEAddress;
+  xfer.Direction = I2CM_DIR_WRITE;
+  xfer.RegSize = 2;
+  xfer.Register = WriteAddr;
+  xfer.Buffer = pBuffer;
+  xfer.Length = *NumByteToWrite;
+  /* The callback resets *NumByteToWrite to 0 once the page is sent */
+  xfer.Callback = sEE_WriteDone;
+  xfer.Context = NumByteToWrite;
+
+  if(I2CM_Submit(&xfer) != I2CM_OK)
   {
-    if((sEETimeout--) == 0) return sEE_TIMEOUT_UserCallback();
+    return sEE_FAIL;
   }
-  
-  /*!< Send the EEPROM's internal address to write to : MSB of the address first */
-  I2C_SendData(sEE_I2C, (uint8_t)((WriteAddr & 0xFF00) >> 8));
 
-  /*!< Test on EV8 and clear it */
-  sEETimeout = sEE_FLAG_TIMEOUT;  
-  while(!I2C_CheckEvent(sEE_I2C, I2C_EVENT_MASTER_BYTE_TRANSMITTING))
-  {
-    if((sEETimeout--) == 0) return sEE_TIMEOUT_UserCallback();
-  }  
-  
-  /*!< Send the EEPROM's internal address to write to : LSB of the address */
-  I2C_SendData(sEE_I2C, (uint8_t)(WriteAddr & 0x00FF));
-  
-  /*!< Test on EV8 and clear it */
-  sEETimeout = sEE_FLAG_TIMEOUT; 
-  while(!I2C_CheckEvent(sEE_I2C, I2C_EVENT_MASTER_BYTE_TRANSMITTING))
-  {
-    if((sEETimeout--) == 0) return sEE_TIMEOUT_UserCallback();
-  }  
-  
-  /* Configure the DMA Tx Channel with the buffer address and the buffer size */
-  sEE_LowLevel_DMAConfig((uint32_t)pBuffer, (uint8_t)(*NumByteToWrite), sEE_DIRECTION_TX);
-  
-  /* Enable the DMA Tx Stream */
-  DMA_Cmd(sEE_I2C_DMA_STREAM_TX, ENABLE);
-  
   /* If all operations OK, return sEE_OK (0) */
   return sEE_OK;
 }
@@ -448,7 +296,7 @@ void sEE_WriteBuffer(uint8_t* pBuffer, uint16_t WriteAddr, uint16_t NumByteToWri
       sEEDataNum = NumOfSingle;
       /* Start writing data */
       sEE_WritePage(pBuffer, WriteAddr, (uint8_t*)(&sEEDataNum));
-      /* Wait transfer through DMA to be complete */
+      /* Wait transfer to be complete */
       sEETimeout = sEE_LONG_TIMEOUT;
       while (sEEDataNum > 0)
       {
@@ -464,7 +312,7 @@ void sEE_WriteBuffer(uint8_t* pBuffer, uint16_t WriteAddr, uint16_t NumByteToWri
         /* Store the number of data to be written */
         sEEDataNum = sEE_PAGESIZE;        
         sEE_WritePage(pBuffer, WriteAddr, (uint8_t*)(&sEEDataNum)); 
-        /* Wait transfer through DMA to be complete */
+        /* Wait transfer to be complete */
         sEETimeout = sEE_LONG_TIMEOUT;
         while (sEEDataNum > 0)
         {
@@ -480,7 +328,7 @@ void sEE_WriteBuffer(uint8_t* pBuffer, uint16_t WriteAddr, uint16_t NumByteToWri
         /* Store the number of data to be written */
         sEEDataNum = NumOfSingle;          
         sEE_WritePage(pBuffer, WriteAddr, (uint8_t*)(&sEEDataNum));
-        /* Wait transfer through DMA to be complete */
+        /* Wait transfer to be complete */
         sEETimeout = sEE_LONG_TIMEOUT;
         while (sEEDataNum > 0)
         {
@@ -504,7 +352,7 @@ void sEE_WriteBuffer(uint8_t* pBuffer, uint16_t WriteAddr, uint16_t NumByteToWri
         sEEDataNum = count;        
         /*!< Write the data contained in same page */
         sEE_WritePage(pBuffer, WriteAddr, (uint8_t*)(&sEEDataNum));
-        /* Wait transfer through DMA to be complete */
+        /* Wait transfer to be complete */
         sEETimeout = sEE_LONG_TIMEOUT;
         while (sEEDataNum > 0)
         {
@@ -516,7 +364,7 @@ void sEE_WriteBuffer(uint8_t* pBuffer, uint16_t WriteAddr, uint16_t NumByteToWri
         sEEDataNum = (NumByteToWrite - count);          
         /*!< Write the remaining data in the following page */
         sEE_WritePage((uint8_t*)(pBuffer + count), (WriteAddr + count), (uint8_t*)(&sEEDataNum));
-        /* Wait transfer through DMA to be complete */
+        /* Wait transfer to be complete */
         sEETimeout = sEE_LONG_TIMEOUT;
         while (sEEDataNum > 0)
         {
@@ -529,7 +377,7 @@ void sEE_WriteBuffer(uint8_t* pBuffer, uint16_t WriteAddr, uint16_t NumByteToWri
         /* Store the number of data to be written */
         sEEDataNum = NumOfSingle;         
         sEE_WritePage(pBuffer, WriteAddr, (uint8_t*)(&sEEDataNum));
-        /* Wait transfer through DMA to be complete */
+        /* Wait transfer to be complete */
         sEETimeout = sEE_LONG_TIMEOUT;
         while (sEEDataNum > 0)
         {
@@ -550,7 +398,7 @@ void sEE_WriteBuffer(uint8_t* pBuffer, uint16_t WriteAddr, uint16_t NumByteToWri
         /* Store the number of data to be written */
         sEEDataNum = count;         
         sEE_WritePage(pBuffer, WriteAddr, (uint8_t*)(&sEEDataNum));
-        /* Wait transfer through DMA to be complete */
+        /* Wait transfer to be complete */
         sEETimeout = sEE_LONG_TIMEOUT;
         while (sEEDataNum > 0)
         {
@@ -566,7 +414,7 @@ void sEE_WriteBuffer(uint8_t* pBuffer, uint16_t WriteAddr, uint16_t NumByteToWri
         /* Store the number of data to be written */
         sEEDataNum = sEE_PAGESIZE;          
         sEE_WritePage(pBuffer, WriteAddr, (uint8_t*)(&sEEDataNum));
-        /* Wait transfer through DMA to be complete */
+        /* Wait transfer to be complete */
         sEETimeout = sEE_LONG_TIMEOUT;
         while (sEEDataNum > 0)
         {
@@ -581,7 +429,7 @@ void sEE_WriteBuffer(uint8_t* pBuffer, uint16_t WriteAddr, uint16_t NumByteToWri
         /* Store the number of data to be written */
         sEEDataNum = NumOfSingle;           
         sEE_WritePage(pBuffer, WriteAddr, (uint8_t*)(&sEEDataNum)); 
-        /* Wait transfer through DMA to be complete */
+        /* Wait transfer to be complete */
         sEETimeout = sEE_LONG_TIMEOUT;
         while (sEEDataNum > 0)
         {
@@ -609,125 +457,37 @@ void sEE_WriteBuffer(uint8_t* pBuffer, uint16_t WriteAddr, uint16_t NumByteToWri
   */
 uint32_t sEE_WaitEepromStandbyState(void)      
 {
-  __IO uint16_t tmpSR1 = 0;
-  __IO uint32_t sEETrials = 0;
-
-  /*!< While the bus is busy */
-  sEETimeout = sEE_LONG_TIMEOUT;
-  while(I2C_GetFlagStatus(sEE_I2C, I2C_FLAG_BUSY))
-  {
-    if((sEETimeout--) == 0) return sEE_TIMEOUT_UserCallback();
-  }
+  I2CM_Transfer xfer;
+  uint32_t sEETrials = 0;
+  uint8_t status;
+
+  /* Address only write: acknowledged once the internal write cycle is over */
+  xfer.Address = (uint8_t)sEEAddress;
+  xfer.Direction = I2CM_DIR_WRITE;
+  xfer.RegSize = 0;
+  xfer.Register = 0;
+  xfer.Buffer = 0;
+  xfer.Length = 0;
 
   /* Keep looping till the slave acknowledge his address or maximum number 
      of trials is reached (this number is defined by sEE_MAX_TRIALS_NUMBER define
      in stm32f429i_discovery_i2c_ee.h file) */
-  while (1)
+  while (sEETrials++ < sEE_MAX_TRIALS_NUMBER)
   {
-    /*!< Send START condition */
-    I2C_GenerateSTART(sEE_I2C, ENABLE);
-
-    /*!< Test on EV5 and clear it */
-    sEETimeout = sEE_FLAG_TIMEOUT;
-    while(!I2C_CheckEvent(sEE_I2C, I2C_EVENT_MASTER_MODE_SELECT))
-    {
-      if((sEETimeout--) == 0) return sEE_TIMEOUT_UserCallback();
-    }    
+    status = I2CM_Run(&xfer);
 
-    /*!< Send EEPROM address for write */
-    I2C_Send7bitAddress(sEE_I2C, sEEAddress, I2C_Direction_Transmitter);
-    
-    /* Wait for ADDR flag to be set (Slave acknowledged his address) */
-    sEETimeout = sEE_LONG_TIMEOUT;
-    do
-    {     
-      /* Get the current value of the SR1 register */
-      tmpSR1 = sEE_I2C->SR1;
-      
-      /* Update the timeout value and exit if it reach 0 */
-      if((sEETimeout--) == 0) return sEE_TIMEOUT_UserCallback();
-    }
-    /* Keep looping till the Address is acknowledged or the AF flag is 
-       set (address not acknowledged at time) */
-    while((tmpSR1 & (I2C_SR1_ADDR | I2C_SR1_AF)) == 0);
-     
-    /* Check if the ADDR flag has been set */
-    if (tmpSR1 & I2C_SR1_ADDR)
+    if (status == I2CM_OK)
     {
-      /* Clear ADDR Flag by reading SR1 then SR2 registers (SR1 have already 
-         been read) */
-      (void)sEE_I2C->SR2;
-      
-      /*!< STOP condition */    
-      I2C_GenerateSTOP(sEE_I2C, ENABLE);
-        
-      /* Exit the function */
       return sEE_OK;
     }
-    else
-    {
-      /*!< Clear AF flag */
-      I2C_ClearFlag(sEE_I2C, I2C_FLAG_AF);                  
-    }
-    
-    /* Check if the maximum allowed number of trials has bee reached */
-    if (sEETrials++ == sEE_MAX_TRIALS_NUMBER)
-    {
-      /* If the maximum number of trials has been reached, exit the function */
-      return sEE_TIMEOUT_UserCallback();
-    }
-  }
-}
 
-/**
-  * @brief  This function handles the DMA Tx Channel interrupt Handler.
-  * @param  None
-  * @retval None
-  */
-void sEE_I2C_DMA_TX_IRQHandler(void)
-{
-  /* Check if the DMA transfer is complete */
-  if(DMA_GetFlagStatus(sEE_I2C_DMA_STREAM_TX, sEE_TX_DMA_FLAG_TCIF) != RESET)
-  {  
-    /* Disable the DMA Tx Stream and Clear TC flag */  
-    DMA_Cmd(sEE_I2C_DMA_STREAM_TX, DISABLE);
-    DMA_ClearFlag(sEE_I2C_DMA_STREAM_TX, sEE_TX_DMA_FLAG_TCIF);
-
-    /*!< Wait till all data have been physically transferred on the bus */
-    sEETimeout = sEE_LONG_TIMEOUT;
-    while(!I2C_GetFlagStatus(sEE_I2C, I2C_FLAG_BTF))
+    if (status != I2CM_NACK)
     {
-//      if((sEETimeout--) == 0) sEE_TIMEOUT_UserCallback();
+      break;
     }
-    
-    /*!< Send STOP condition */
-    I2C_GenerateSTOP(sEE_I2C, ENABLE);
-    
-    /* Reset the variable holding the number of data to be written */
-    *sEEDataWritePointer = 0;  
   }
-}
 
-/**
-  * @brief  This function handles the DMA Rx Channel interrupt Handler.
-  * @param  None
-  * @retval None
-  */
-void sEE_I2C_DMA_RX_IRQHandler(void)
-{
-  /* Check if the DMA transfer is complete */
-  if(DMA_GetFlagStatus(sEE_I2C_DMA_STREAM_RX, sEE_RX_DMA_FLAG_TCIF) != RESET)
-  {      
-    /*!< Send STOP Condition */
-    I2C_GenerateSTOP(sEE_I2C, ENABLE);    
-    
-    /* Disable the DMA Rx Stream and Clear TC Flag */  
-    DMA_Cmd(sEE_I2C_DMA_STREAM_RX, DISABLE);
-    DMA_ClearFlag(sEE_I2C_DMA_STREAM_RX, sEE_RX_DMA_FLAG_TCIF);
-    
-    /* Reset the variable holding the number of data to be read */
-    *sEEDataReadPointer = 0;
-  }
+  return sEE_TIMEOUT_UserCallback();
 }
 
 #ifdef USE_DEFAULT_TIMEOUT_CALLBACK
@@ -36,6 +36,7 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "stm32f429i_discovery.h"
+#include "stm32f429i_discovery_i2c.h"
 
 /** @addtogroup Utilities
   * @{
@@ -121,8 +122,6 @@ uint32_t sEE_ReadBuffer(uint8_t* pBuffer, uint16_t ReadAddr, uint16_t* NumByteTo
 uint32_t sEE_WritePage(uint8_t* pBuffer, uint16_t WriteAddr, uint8_t* NumByteToWrite);
 void     sEE_WriteBuffer(uint8_t* pBuffer, uint16_t WriteAddr, uint16_t NumByteToWrite);
 uint32_t sEE_WaitEepromStandbyState(void);
-void     sEE_I2C_DMA_TX_IRQHandler(void);
-void     sEE_I2C_DMA_RX_IRQHandler(void);
 
 /* USER Callbacks: These are functions for which prototypes only are declared in
    EEPROM driver and that should be implemented into user applicaiton. */  
@@ -0,0 +1,616 @@
+/**
+  ******************************************************************************
+  * @file    stm32f429i_discovery_i2c_ee_cache.c
+  * @author  Islam Ehab
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Write-back page cache in front of the I2C EEPROM driver.
+  *          Writes land in page sized lines and return at once; dirty lines
+  *          are written back from the I2C interrupts, one page write cycle
+  *          per line, so writes made while the EEPROM is busy programming
+  *          are coalesced into the next cycle. Reads are served from the
+  *          cache when the page is present.
+  *          Do not mix with sEE_WriteBuffer()/sEE_ReadBuffer() on the same
+  *          addresses, and call sEE_CacheFlush() before power down.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32f429i_discovery_i2c_ee_cache.h"
+
+/** @addtogroup Utilities
+  * @{
+  */
+
+/** @addtogroup STM32F4_DISCOVERY
+  * @{
+  */
+
+/** @addtogroup STM32F429I_DISCOVERY
+  * @{
+  */
+
+/** @defgroup STM32F429I_DISCOVERY_I2C_EE_CACHE
+  * @brief This file includes the EEPROM write-back cache
+  * @{
+  */
+
+/** @defgroup STM32F429I_DISCOVERY_I2C_EE_CACHE_Private_Types
+  * @{
+  */
+typedef struct
+{
+  uint16_t      Page;                 /* EEPROM address of the page */
+  uint8_t       Valid;                /* Data holds the whole page */
+  __IO uint32_t Dirty;                /* One bit per byte not yet written back */
+  uint32_t      Age;                  /* Last use, for LRU replacement */
+  uint8_t       Data[sEE_PAGESIZE];
+} sEE_CacheLine;
+/**
+  * @}
+  */
+
+/** @defgroup STM32F429I_DISCOVERY_I2C_EE_CACHE_Private_Defines
+  * @{
+  */
+#if (sEE_PAGESIZE > 32)
+ #error "sEE_PAGESIZE must fit the 32-bit dirty mask"
+#endif
+
+/* Write-back phase */
+#define sEE_CACHE_IDLE            0
+#define sEE_CACHE_WRITE           1   /* Page write on the bus */
+#define sEE_CACHE_POLL            2   /* Waiting for the write cycle to end */
+
+#define sEE_CACHE_NO_LINE         0xFF
+/**
+  * @}
+  */
+
+/** @defgroup STM32F429I_DISCOVERY_I2C_EE_CACHE_Private_Variables
+  * @{
+  */
+extern __IO uint16_t sEEAddress;
+
+static sEE_CacheLine sEE_Cache[sEE_CACHE_LINES];
+static uint32_t      sEE_CacheClock = 0;
+static __IO sEE_CacheStatsTypeDef sEE_CacheStats;
+
+/* Write-back state, owned by the I2C interrupt once Phase is not idle */
+static __IO uint8_t  sEE_CachePhase = sEE_CACHE_IDLE;
+static uint8_t       sEE_CacheLineIdx = sEE_CACHE_NO_LINE;
+static uint32_t      sEE_CacheMask = 0;
+static uint32_t      sEE_CacheTrials = 0;
+static uint8_t       sEE_CacheNext = 0;
+static uint8_t       sEE_CacheBuffer[sEE_PAGESIZE];
+/**
+  * @}
+  */
+
+/** @defgroup STM32F429I_DISCOVERY_I2C_EE_CACHE_Private_FunctionPrototypes
+  * @{
+  */
+static void           sEE_CacheKick(void);
+static void           sEE_CacheDone(void *Context, uint8_t Status);
+static uint8_t        sEE_CacheSubmitPoll(void);
+static uint32_t       sEE_CacheWaitIdle(void);
+static uint32_t       sEE_CacheLoad(uint16_t ReadAddr, uint8_t* pBuffer, uint16_t NumByteToRead);
+static sEE_CacheLine* sEE_CacheLookup(uint16_t Page);
+static sEE_CacheLine* sEE_CacheAllocate(uint16_t Page);
+/**
+  * @}
+  */
+
+/** @defgroup STM32F429I_DISCOVERY_I2C_EE_CACHE_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Starts writing back the next dirty line if none is in progress.
+  *         Called with interrupts masked or from the I2C interrupt.
+  * @param  None
+  * @retval None
+  */
+static void sEE_CacheKick(void)
+{
+  sEE_CacheLine *line;
+  I2CM_Transfer xfer;
+  uint32_t dirty;
+  uint8_t first, last, i, n;
+
+  if(sEE_CachePhase != sEE_CACHE_IDLE)
+  {
+    return;
+  }
+
+  /* Round robin so a line written continuously cannot starve the others */
+  for(n = 0; n < sEE_CACHE_LINES; n++)
+  {
+    i = (uint8_t)((sEE_CacheNext + n) % sEE_CACHE_LINES);
+    if((sEE_Cache[i].Valid != 0) && (sEE_Cache[i].Dirty != 0))
+    {
+      break;
+    }
+  }
+
+  if(n == sEE_CACHE_LINES)
+  {
+    return;
+  }
+
+  line = &sEE_Cache[i];
+  sEE_CacheNext = (uint8_t)((i + 1) % sEE_CACHE_LINES);
+
+  /* One write cycle covers the span from the first to the last dirty byte,
+     the clean bytes in between are rewritten with the same value */
+  dirty = line->Dirty;
+  for(first = 0; (dirty & (1UL << first)) == 0; first++)
+  {
+  }
+  for(last = sEE_PAGESIZE - 1; (dirty & (1UL << last)) == 0; last--)
+  {
+  }
+  for(n = first; n <= last; n++)
+  {
+    sEE_CacheBuffer[n - first] = line->Data[n];
+  }
+
+  /* Writes arriving from now on mark the line dirty again */
+  line->Dirty = 0;
+  sEE_CacheMask = dirty;
+  sEE_CacheLineIdx = i;
+  sEE_CachePhase = sEE_CACHE_WRITE;
+
+  xfer.Address = (uint8_t)sEEAddress;
+  xfer.Direction = I2CM_DIR_WRITE;
+  xfer.RegSize = 2;
+  xfer.Register = (uint16_t)(line->Page + first);
+  xfer.Buffer = sEE_CacheBuffer;
+  xfer.Length = (uint16_t)(last - first + 1);
+  xfer.Callback = sEE_CacheDone;
+  xfer.Context = 0;
+
+  if(I2CM_Submit(&xfer) != I2CM_OK)
+  {
+    /* Queue full, retried on the next write or flush */
+    line->Dirty |= dirty;
+    sEE_CachePhase = sEE_CACHE_IDLE;
+  }
+}
+
+/**
+  * @brief  Queues an address only write: acknowledged once the EEPROM has
+  *         finished its internal write cycle.
+  * @param  None
+  * @retval I2CM_Submit() status.
+  */
+static uint8_t sEE_CacheSubmitPoll(void)
+{
+  I2CM_Transfer xfer;
+
+  xfer.Address = (uint8_t)sEEAddress;
+  xfer.Direction = I2CM_DIR_WRITE;
+  xfer.RegSize = 0;
+  xfer.Register = 0;
+  xfer.Buffer = 0;
+  xfer.Length = 0;
+  xfer.Callback = sEE_CacheDone;
+  xfer.Context = 0;
+
+  return I2CM_Submit(&xfer);
+}
+
+/**
+  * @brief  Completion of a write-back transaction, runs in the I2C interrupt.
+  * @param  Context: unused.
+  * @param  Status: transaction status.
+  * @retval None
+  */
+static void sEE_CacheDone(void *Context, uint8_t Status)
+{
+  (void)Context;
+
+  if(sEE_CachePhase == sEE_CACHE_WRITE)
+  {
+    if(Status != I2CM_OK)
+    {
+      sEE_Cache[sEE_CacheLineIdx].Dirty |= sEE_CacheMask;
+      sEE_CacheStats.Errors++;
+      sEE_CachePhase = sEE_CACHE_IDLE;
+      return;
+    }
+
+    sEE_CacheStats.PageWrites++;
+    sEE_CacheTrials = 0;
+    sEE_CachePhase = sEE_CACHE_POLL;
+  }
+  else if(Status == I2CM_OK)
+  {
+    /* Write cycle over, go on with the next dirty line */
+    sEE_CachePhase = sEE_CACHE_IDLE;
+    sEE_CacheKick();
+    return;
+  }
+  else if((Status != I2CM_NACK) || (++sEE_CacheTrials >= sEE_MAX_TRIALS_NUMBER))
+  {
+    sEE_CacheStats.Errors++;
+    sEE_CachePhase = sEE_CACHE_IDLE;
+    return;
+  }
+
+  if(sEE_CacheSubmitPoll() != I2CM_OK)
+  {
+    /* The next access will NACK until the cycle ends and is retried */
+    sEE_CachePhase = sEE_CACHE_IDLE;
+  }
+}
+
+/**
+  * @brief  Waits for the running write-back to end, resets the bus if it
+  *         does not end in time.
+  * @param  None
+  * @retval sEE_OK, or sEE_FAIL if the write-back failed.
+  */
+static uint32_t sEE_CacheWaitIdle(void)
+{
+  uint32_t errors = sEE_CacheStats.Errors;
+  uint32_t timeout = sEE_CACHE_TIMEOUT;
+
+  while(sEE_CachePhase != sEE_CACHE_IDLE)
+  {
+    if(timeout-- == 0)
+    {
+      I2CM_Reset();
+      timeout = sEE_CACHE_TIMEOUT;
+    }
+  }
+
+  return (sEE_CacheStats.Errors == errors) ? sEE_OK : sEE_FAIL;
+}
+
+/**
+  * @brief  Reads from the EEPROM, retrying while it is busy programming.
+  * @param  ReadAddr: EEPROM address.
+  * @param  pBuffer: destination.
+  * @param  NumByteToRead: number of bytes.
+  * @retval sEE_OK or sEE_FAIL.
+  */
+static uint32_t sEE_CacheLoad(uint16_t ReadAddr, uint8_t* pBuffer, uint16_t NumByteToRead)
+{
+  I2CM_Transfer xfer;
+  uint32_t trials;
+  uint8_t status = I2CM_NACK;
+
+  xfer.Address = (uint8_t)sEEAddress;
+  xfer.Direction = I2CM_DIR_READ;
+  xfer.RegSize = 2;
+  xfer.Register = ReadAddr;
+  xfer.Buffer = pBuffer;
+  xfer.Length = NumByteToRead;
+
+  sEE_CacheStats.Fills++;
+
+  for(trials = 0; (trials < sEE_MAX_TRIALS_NUMBER) && (status == I2CM_NACK); trials++)
+  {
+    status = I2CM_Run(&xfer);
+  }
+
+  if(status != I2CM_OK)
+  {
+    sEE_CacheStats.Errors++;
+    return sEE_FAIL;
+  }
+
+  return sEE_OK;
+}
+
+/**
+  * @brief  Finds the cache line holding a page.
+  * @param  Page: page address.
+  * @retval The line, or 0 if the page is not cached.
+  */
+static sEE_CacheLine* sEE_CacheLookup(uint16_t Page)
+{
+  uint8_t i;
+
+  for(i = 0; i < sEE_CACHE_LINES; i++)
+  {
+    if((sEE_Cache[i].Valid != 0) && (sEE_Cache[i].Page == Page))
+    {
+      sEE_Cache[i].Age = ++sEE_CacheClock;
+      return &sEE_Cache[i];
+    }
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  Replaces the least recently used clean line with a page read from
+  *         the EEPROM. Waits for a line to be written back when all are dirty.
+  * @param  Page: page address.
+  * @retval The line, or 0 on error.
+  */
+static sEE_CacheLine* sEE_CacheAllocate(uint16_t Page)
+{
+  sEE_CacheLine *line;
+  uint32_t errors = sEE_CacheStats.Errors;
+  uint32_t timeout = sEE_CACHE_TIMEOUT;
+  uint32_t primask;
+  uint8_t i;
+
+  while(1)
+  {
+    line = 0;
+    for(i = 0; i < sEE_CACHE_LINES; i++)
+    {
+      if(sEE_Cache[i].Valid == 0)
+      {
+        line = &sEE_Cache[i];
+        break;
+      }
+
+      /* The line being written back is in use until its cycle ends */
+      if((sEE_Cache[i].Dirty == 0) &&
+         ((sEE_CachePhase == sEE_CACHE_IDLE) || (sEE_CacheLineIdx != i)) &&
+         ((line == 0) || (sEE_Cache[i].Age < line->Age)))
+      {
+        line = &sEE_Cache[i];
+      }
+    }
+
+    if(line != 0)
+    {
+      break;
+    }
+
+    /* Every line is dirty: write one back and take it once its cycle ends */
+    primask = __get_PRIMASK();
+    __disable_irq();
+    sEE_CacheKick();
+    __set_PRIMASK(primask);
+
+    if(sEE_CacheStats.Errors != errors)
+    {
+      return 0;
+    }
+
+    if(timeout-- == 0)
+    {
+      I2CM_Reset();
+      timeout = sEE_CACHE_TIMEOUT;
+    }
+  }
+
+  /* Invisible to the write-back until filled */
+  line->Valid = 0;
+  line->Dirty = 0;
+
+  if(sEE_CacheLoad(Page, line->Data, sEE_PAGESIZE) != sEE_OK)
+  {
+    return 0;
+  }
+
+  line->Page = Page;
+  line->Age = ++sEE_CacheClock;
+  line->Valid = 1;
+
+  return line;
+}
+
+/**
+  * @brief  Initializes the EEPROM driver and empties the cache.
+  * @param  None
+  * @retval None
+  */
+void sEE_CacheInit(void)
+{
+  uint8_t i;
+
+  sEE_Init();
+
+  for(i = 0; i < sEE_CACHE_LINES; i++)
+  {
+    sEE_Cache[i].Valid = 0;
+    sEE_Cache[i].Dirty = 0;
+    sEE_Cache[i].Age = 0;
+  }
+
+  sEE_CacheClock = 0;
+  sEE_CachePhase = sEE_CACHE_IDLE;
+  sEE_CacheLineIdx = sEE_CACHE_NO_LINE;
+  sEE_CacheNext = 0;
+
+  sEE_CacheStats.Writes = 0;
+  sEE_CacheStats.PageWrites = 0;
+  sEE_CacheStats.Hits = 0;
+  sEE_CacheStats.Fills = 0;
+  sEE_CacheStats.Errors = 0;
+}
+
+/**
+  * @brief  Writes a buffer through the cache. Returns once the data is in the
+  *         cache; write-back to the EEPROM starts in the background.
+  * @param  pBuffer : data to write.
+  * @param  WriteAddr : EEPROM's internal address to write to.
+  * @param  NumByteToWrite : number of bytes to write.
+  * @retval sEE_OK, or sEE_FAIL if a page could not be read into the cache.
+  */
+uint32_t sEE_CacheWrite(const uint8_t* pBuffer, uint16_t WriteAddr, uint16_t NumByteToWrite)
+{
+  sEE_CacheLine *line;
+  uint32_t primask;
+  uint32_t mask;
+  uint16_t page, offset, count, n;
+
+  while(NumByteToWrite != 0)
+  {
+    offset = WriteAddr % sEE_PAGESIZE;
+    page = WriteAddr - offset;
+    count = sEE_PAGESIZE - offset;
+    if(count > NumByteToWrite)
+    {
+      count = NumByteToWrite;
+    }
+
+    line = sEE_CacheLookup(page);
+    if(line == 0)
+    {
+      line = sEE_CacheAllocate(page);
+      if(line == 0)
+      {
+        return sEE_FAIL;
+      }
+    }
+
+    mask = 0;
+    for(n = 0; n < count; n++)
+    {
+      mask |= 1UL << (offset + n);
+    }
+
+    /* The write-back copies Data and clears Dirty from the I2C interrupt */
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    for(n = 0; n < count; n++)
+    {
+      line->Data[offset + n] = pBuffer[n];
+    }
+    line->Dirty |= mask;
+    sEE_CacheStats.Writes++;
+
+    sEE_CacheKick();
+
+    __set_PRIMASK(primask);
+
+    pBuffer += count;
+    WriteAddr += count;
+    NumByteToWrite -= count;
+  }
+
+  return sEE_OK;
+}
+
+/**
+  * @brief  Reads a buffer, from the cache for cached pages and from the
+  *         EEPROM otherwise. Pages read from the EEPROM are not cached.
+  * @param  pBuffer : destination.
+  * @param  ReadAddr : EEPROM's internal address to read from.
+  * @param  NumByteToRead : number of bytes to read.
+  * @retval sEE_OK or sEE_FAIL.
+  */
+uint32_t sEE_CacheRead(uint8_t* pBuffer, uint16_t ReadAddr, uint16_t NumByteToRead)
+{
+  sEE_CacheLine *line;
+  uint16_t page, offset, count, n;
+
+  while(NumByteToRead != 0)
+  {
+    offset = ReadAddr % sEE_PAGESIZE;
+    page = ReadAddr - offset;
+    count = sEE_PAGESIZE - offset;
+    if(count > NumByteToRead)
+    {
+      count = NumByteToRead;
+    }
+
+    line = sEE_CacheLookup(page);
+    if(line != 0)
+    {
+      for(n = 0; n < count; n++)
+      {
+        pBuffer[n] = line->Data[offset + n];
+      }
+      sEE_CacheStats.Hits++;
+    }
+    else
+    {
+      /* Extend the read over the following uncached pages */
+      while((count < NumByteToRead) &&
+            (sEE_CacheLookup((uint16_t)(page + offset + count)) == 0))
+      {
+        count = (uint16_t)(count + ((NumByteToRead - count > sEE_PAGESIZE) ?
+                                    sEE_PAGESIZE : (NumByteToRead - count)));
+      }
+
+      if(sEE_CacheLoad(ReadAddr, pBuffer, count) != sEE_OK)
+      {
+        return sEE_FAIL;
+      }
+    }
+
+    pBuffer += count;
+    ReadAddr += count;
+    NumByteToRead -= count;
+  }
+
+  return sEE_OK;
+}
+
+/**
+  * @brief  Writes every dirty line back and waits for the EEPROM to finish.
+  * @param  None
+  * @retval sEE_OK, or sEE_FAIL if a write-back failed.
+  */
+uint32_t sEE_CacheFlush(void)
+{
+  uint32_t primask;
+  uint8_t i;
+
+  while(1)
+  {
+    primask = __get_PRIMASK();
+    __disable_irq();
+    sEE_CacheKick();
+    __set_PRIMASK(primask);
+
+    if(sEE_CacheWaitIdle() != sEE_OK)
+    {
+      return sEE_FAIL;
+    }
+
+    for(i = 0; i < sEE_CACHE_LINES; i++)
+    {
+      if((sEE_Cache[i].Valid != 0) && (sEE_Cache[i].Dirty != 0))
+      {
+        break;
+      }
+    }
+
+    if(i == sEE_CACHE_LINES)
+    {
+      return sEE_OK;
+    }
+  }
+}
+
+/**
+  * @brief  Returns the cache counters.
+  * @param  Stats: filled with the counters since sEE_CacheInit().
+  * @retval None
+  */
+void sEE_CacheGetStats(sEE_CacheStatsTypeDef *Stats)
+{
+  *Stats = sEE_CacheStats;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
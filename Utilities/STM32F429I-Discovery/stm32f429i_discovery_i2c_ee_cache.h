@@ -0,0 +1,104 @@
+/**
+  ******************************************************************************
+  * @file    stm32f429i_discovery_i2c_ee_cache.h
+  * @author  Islam Ehab
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   This file contains all the functions prototypes for the
+  *          stm32f429i_discovery_i2c_ee_cache.c driver.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM32F429I_DISCOVERY_I2C_EE_CACHE_H
+#define __STM32F429I_DISCOVERY_I2C_EE_CACHE_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32f429i_discovery_i2c_ee.h"
+
+/** @addtogroup Utilities
+  * @{
+  */
+
+/** @addtogroup STM32F4_DISCOVERY
+  * @{
+  */
+
+/** @addtogroup STM32F429I_DISCOVERY
+  * @{
+  */
+
+/** @addtogroup STM32F429I_DISCOVERY_I2C_EE_CACHE
+  * @{
+  */
+
+/** @defgroup STM32F429I_DISCOVERY_I2C_EE_CACHE_Exported_Types
+  * @{
+  */
+
+/**
+  * @brief  Cache counters. Writes against PageWrites shows how many EEPROM
+  *         write cycles coalescing saved.
+  */
+typedef struct
+{
+  uint32_t Writes;      /*!< Pages touched by sEE_CacheWrite() */
+  uint32_t PageWrites;  /*!< EEPROM page write cycles issued */
+  uint32_t Hits;        /*!< Pages served from the cache by sEE_CacheRead() */
+  uint32_t Fills;       /*!< Page reads from the EEPROM */
+  uint32_t Errors;      /*!< Failed page writes, fills or write cycles */
+} sEE_CacheStatsTypeDef;
+/**
+  * @}
+  */
+
+/** @defgroup STM32F429I_DISCOVERY_I2C_EE_CACHE_Exported_Constants
+  * @{
+  */
+
+/* Number of cached EEPROM pages */
+#define sEE_CACHE_LINES           4
+
+/* Spin count after which a stalled flush resets the I2C bus */
+#define sEE_CACHE_TIMEOUT         ((uint32_t)0x100000)
+/**
+  * @}
+  */
+
+/** @defgroup STM32F429I_DISCOVERY_I2C_EE_CACHE_Exported_Functions
+  * @{
+  */
+void     sEE_CacheInit(void);
+uint32_t sEE_CacheWrite(const uint8_t* pBuffer, uint16_t WriteAddr, uint16_t NumByteToWrite);
+uint32_t sEE_CacheRead(uint8_t* pBuffer, uint16_t ReadAddr, uint16_t NumByteToRead);
+uint32_t sEE_CacheFlush(void);
+void     sEE_CacheGetStats(sEE_CacheStatsTypeDef *Stats);
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __STM32F429I_DISCOVERY_I2C_EE_CACHE_H */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
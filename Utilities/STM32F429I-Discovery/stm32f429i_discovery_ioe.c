@@ -30,8 +30,9 @@
   
     Note:
     -----
-    - This driver uses the DMA method for sending and receiving data on I2C bus
-      which allow higher efficiency and reliability of the communication.  
+    - This driver sends and receives data through the I2C transaction queue
+      (stm32f429i_discovery_i2c.c) shared with the EEPROM driver; register
+      reads of two bytes are received by DMA.  
   
     SUPPORTED FEATURES:
       - Touch Panel Features: Single point mode (Polling/Interrupt)
@@ -108,7 +109,7 @@ static uint16_t IOE_TP_Read_Y(void);
 static uint16_t IOE_TP_Read_Z(void);
 static void     IOE_GPIO_Config(void);
 static void     IOE_I2C_Config(void);
-static void     IOE_DMA_Config(IOE_DMADirection_TypeDef Direction, uint8_t* buffer);
+static uint8_t  IOE_Transfer(uint8_t Direction, uint8_t RegisterAddr, uint8_t* Buffer, uint16_t Length);
 
 #ifndef USE_Delay
 static void delay(__IO uint32_t nCount);
@@ -519,301 +520,39 @@ uint8_t IOE_IOAFConfig(uint8_t IO_Pin, FunctionalState NewState)
 
 /**
   * @brief  Writes a value in a register of the device through I2C.
+  * @note   Kept for compatibility, I2C_WriteDeviceRegister() goes through the
+  *         I2C transaction queue.
   * @param  RegisterAddr: The target register address
   * @param  RegisterValue: The target register value to be written 
   * @retval IOE_OK: if all operations are OK. Other value if error.
   */
 uint8_t I2C_DMA_WriteDeviceRegister(uint8_t RegisterAddr, uint8_t RegisterValue)
 {
-  uint32_t read_verif = 0;  
-  uint8_t IOE_BufferTX = 0;
-  
-  /* Get Value to be written */
-  IOE_BufferTX = RegisterValue;
-  
-  /* Configure DMA Peripheral */
-  IOE_DMA_Config(IOE_DMA_TX, (uint8_t*)(&IOE_BufferTX));
-  
-  /* Enable the I2C peripheral */
-  I2C_GenerateSTART(IOE_I2C, ENABLE);
-  
-  /* Test on SB Flag */
-  IOE_TimeOut = TIMEOUT_MAX;
-  while (I2C_GetFlagStatus(IOE_I2C,I2C_FLAG_SB) == RESET) 
-  {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
-  }
-  
-  /* Transmit the slave address and enable writing operation */
-  I2C_Send7bitAddress(IOE_I2C, IOE_ADDR, I2C_Direction_Transmitter);
-  
-  /* Test on ADDR Flag */
-  IOE_TimeOut = TIMEOUT_MAX;
-  while (!I2C_CheckEvent(IOE_I2C, I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED))
-  {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
-  }
-  
-  /* Transmit the first address for r/w operations */
-  I2C_SendData(IOE_I2C, RegisterAddr);
-  
-  /* Test on TXE FLag (data dent) */
-  IOE_TimeOut = TIMEOUT_MAX;
-  while ((!I2C_GetFlagStatus(IOE_I2C,I2C_FLAG_TXE)) && (!I2C_GetFlagStatus(IOE_I2C,I2C_FLAG_BTF)))  
-  {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
-  }
-  
-  /* Enable I2C DMA request */
-  I2C_DMACmd(IOE_I2C,ENABLE);
-  
-  /* Enable DMA TX Channel */
-  DMA_Cmd(IOE_DMA_TX_STREAM, ENABLE);
-  
-  /* Wait until DMA Transfer Complete */
-  IOE_TimeOut = TIMEOUT_MAX;
-  while (!DMA_GetFlagStatus(IOE_DMA_TX_STREAM,IOE_DMA_TX_TCFLAG))
-  {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
-  }  
-  
-  /* Wait until BTF Flag is set before generating STOP */
-  IOE_TimeOut = 0xFF * TIMEOUT_MAX;
-  while ((!I2C_GetFlagStatus(IOE_I2C,I2C_FLAG_BTF)))  
-  {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
-  }
-  
-  /* Send STOP Condition */
-  I2C_GenerateSTOP(IOE_I2C, ENABLE);
-  
-  /* Disable DMA TX Channel */
-  DMA_Cmd(IOE_DMA_TX_STREAM, DISABLE);
-  
-  /* Disable I2C DMA request */  
-  I2C_DMACmd(IOE_I2C,DISABLE);
-  
-  /* Clear DMA TX Transfer Complete Flag */
-  DMA_ClearFlag(IOE_DMA_TX_STREAM,IOE_DMA_TX_TCFLAG);
-  
-#ifdef VERIFY_WRITTENDATA
-  /* Verify (if needed) that the loaded data is correct  */
-  
-  /* Read the just written register*/
-  read_verif = I2C_ReadDeviceRegister(RegisterAddr);
-  /* Load the register and verify its value  */
-  if (read_verif != RegisterValue)
-  {
-    /* Control data wrongly transferred */
-    read_verif = IOE_FAILURE;
-  }
-  else
-  {
-    /* Control data correctly transferred */
-    read_verif = 0;
-  }
-#endif
-  
-  /* Return the verifying value: 0 (Passed) or 1 (Failed) */
-  return read_verif;
+  return I2C_WriteDeviceRegister(RegisterAddr, RegisterValue);
 }
 
 /**
   * @brief  Reads a register of the device through I2C.
+  * @note   Kept for compatibility, see I2C_ReadDeviceRegister().
   * @param  RegisterAddr: The target register address (between 00x and 0x24)
-  * @retval The value of the read register (0xAA if Timeout occurred)   
+  * @retval The value of the read register (0 if Timeout occurred)   
   */
 uint8_t I2C_DMA_ReadDeviceRegister(uint8_t RegisterAddr)
 {
-  uint8_t IOE_BufferRX[2] = {0x00, 0x00};  
-  
-  /* Configure DMA Peripheral */
-  IOE_DMA_Config(IOE_DMA_RX, (uint8_t*)IOE_BufferRX);
-  
-  /* Enable DMA NACK automatic generation */
-  I2C_DMALastTransferCmd(IOE_I2C, ENABLE);
-  
-  /* Enable the I2C peripheral */
-  I2C_GenerateSTART(IOE_I2C, ENABLE);
-  
-  /* Test on SB Flag */
-  IOE_TimeOut = TIMEOUT_MAX;
-  while (!I2C_GetFlagStatus(IOE_I2C,I2C_FLAG_SB)) 
-  {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
-  }
-  
-  /* Send device address for write */
-  I2C_Send7bitAddress(IOE_I2C, IOE_ADDR, I2C_Direction_Transmitter);
-  
-  /* Test on ADDR Flag */
-  IOE_TimeOut = TIMEOUT_MAX;
-  while (!I2C_CheckEvent(IOE_I2C, I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED)) 
-  {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
-  }
-  
-  /* Send the device's internal address to write to */
-  I2C_SendData(IOE_I2C, RegisterAddr);  
-  
-  /* Test on TXE FLag (data dent) */
-  IOE_TimeOut = TIMEOUT_MAX;
-  while ((!I2C_GetFlagStatus(IOE_I2C,I2C_FLAG_TXE)) && (!I2C_GetFlagStatus(IOE_I2C,I2C_FLAG_BTF)))  
-  {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
-  }
-  
-  /* Send START condition a second time */  
-  I2C_GenerateSTART(IOE_I2C, ENABLE);
-  
-  /* Test on SB Flag */
-  IOE_TimeOut = TIMEOUT_MAX;
-  while (!I2C_GetFlagStatus(IOE_I2C,I2C_FLAG_SB)) 
-  {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
-  }
-  
-  /* Send IOExpander address for read */
-  I2C_Send7bitAddress(IOE_I2C, IOE_ADDR, I2C_Direction_Receiver);
-  
-  /* Test on ADDR Flag */
-  IOE_TimeOut = TIMEOUT_MAX;
-  while (!I2C_CheckEvent(IOE_I2C, I2C_EVENT_MASTER_RECEIVER_MODE_SELECTED))   
-  {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
-  }
-    
-  /* Enable I2C DMA request */
-  I2C_DMACmd(IOE_I2C,ENABLE);
-  
-  /* Enable DMA RX Channel */
-  DMA_Cmd(IOE_DMA_RX_STREAM, ENABLE);
-  
-  /* Wait until DMA Transfer Complete */
-  IOE_TimeOut = 2 * TIMEOUT_MAX;
-  while (!DMA_GetFlagStatus(IOE_DMA_RX_STREAM,IOE_DMA_RX_TCFLAG))
-  {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
-  }        
-  
-  /* Send STOP Condition */
-  I2C_GenerateSTOP(IOE_I2C, ENABLE);
-  
-  /* Disable DMA RX Channel */
-  DMA_Cmd(IOE_DMA_RX_STREAM, DISABLE);
-  
-  /* Disable I2C DMA request */  
-  I2C_DMACmd(IOE_I2C,DISABLE);
-  
-  /* Clear DMA RX Transfer Complete Flag */
- DMA_ClearFlag(IOE_DMA_RX_STREAM,IOE_DMA_RX_TCFLAG);
-  
-  /* return a pointer to the IOE_Buffer */
-  return (uint8_t)IOE_BufferRX[0];
+  return I2C_ReadDeviceRegister(RegisterAddr);
 }
 
-
 /**
   * @brief  Reads a buffer of 2 bytes from the device registers.
+  * @note   Kept for compatibility, see I2C_ReadDataBuffer().
   * @param  RegisterAddr: The target register address (between 00x and 0x24)
-  * @retval A pointer to the buffer containing the two returned bytes (in halfword).  
+  * @retval The data in the buffer containing the two returned bytes (in halfword).  
   */
 uint16_t I2C_DMA_ReadDataBuffer(uint32_t RegisterAddr)
-{ 
-  uint8_t tmp= 0;
-  uint8_t IOE_BufferRX[2] = {0x00, 0x00};  
-  
-  /* Configure DMA Peripheral */
-  IOE_DMA_Config(IOE_DMA_RX, (uint8_t*)IOE_BufferRX);
-  
-  /* Enable DMA NACK automatic generation */
-  I2C_DMALastTransferCmd(IOE_I2C, ENABLE);
-  
-  /* Enable the I2C peripheral */
-  I2C_GenerateSTART(IOE_I2C, ENABLE);
-  
-  /* Test on SB Flag */
-  IOE_TimeOut = TIMEOUT_MAX;
-  while (!I2C_GetFlagStatus(IOE_I2C,I2C_FLAG_SB)) 
-  {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
-  }
-  
-  /* Send device address for write */
-  I2C_Send7bitAddress(IOE_I2C, IOE_ADDR, I2C_Direction_Transmitter);
-  
-  /* Test on ADDR Flag */
-  IOE_TimeOut = TIMEOUT_MAX;
-  while (!I2C_CheckEvent(IOE_I2C, I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED))
-  {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
-  }
-  
-  /* Send the device's internal address to write to */
-  I2C_SendData(IOE_I2C, RegisterAddr);  
-  
-  /* Test on TXE FLag (data dent) */
-  IOE_TimeOut = TIMEOUT_MAX;
-  while ((!I2C_GetFlagStatus(IOE_I2C,I2C_FLAG_TXE)) && (!I2C_GetFlagStatus(IOE_I2C,I2C_FLAG_BTF)))  
-  {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
-  }
-  
-  /* Send START condition a second time */  
-  I2C_GenerateSTART(IOE_I2C, ENABLE);
-  
-  /* Test on SB Flag */
-  IOE_TimeOut = TIMEOUT_MAX;
-  while (!I2C_GetFlagStatus(IOE_I2C,I2C_FLAG_SB)) 
-  {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
-  }
-  
-  /* Send IO Expander address for read */
-  I2C_Send7bitAddress(IOE_I2C, IOE_ADDR, I2C_Direction_Receiver);
-  
-  /* Test on ADDR Flag */
-  IOE_TimeOut = TIMEOUT_MAX;
-  while (!I2C_CheckEvent(IOE_I2C, I2C_EVENT_MASTER_RECEIVER_MODE_SELECTED))   
-  {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
-  }
-  
-  /* Enable I2C DMA request */
-  I2C_DMACmd(IOE_I2C,ENABLE);
-  
-  /* Enable DMA RX Channel */
-  DMA_Cmd(IOE_DMA_RX_STREAM, ENABLE);
-  
-  /* Wait until DMA Transfer Complete */
-  IOE_TimeOut = 2 * TIMEOUT_MAX;
-  while (!DMA_GetFlagStatus(IOE_DMA_RX_STREAM, IOE_DMA_RX_TCFLAG))
-  {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
-  }        
-  
-  /* Send STOP Condition */
-  I2C_GenerateSTOP(IOE_I2C, ENABLE);
-  
-  /* Disable DMA RX Channel */
-  DMA_Cmd(IOE_DMA_RX_STREAM, DISABLE);
-  
-  /* Disable I2C DMA request */  
-  I2C_DMACmd(IOE_I2C,DISABLE);
-  
-  /* Clear DMA RX Transfer Complete Flag */
-  DMA_ClearFlag(IOE_DMA_RX_STREAM,IOE_DMA_RX_TCFLAG);
-  
-  /* Reorganize received data */  
-  tmp = IOE_BufferRX[0];
-  IOE_BufferRX[0] = IOE_BufferRX[1];
-  IOE_BufferRX[1] = tmp;
-  
-  /* return the data */
-  return (__IO uint16_t) (IOE_BufferRX[0] | (uint16_t)IOE_BufferRX[1]<< 8);
+{
+  return I2C_ReadDataBuffer(RegisterAddr);
 }
 
-
 /**
   * @brief  Return Touch Panel X position value
   * @param  None
@@ -821,10 +560,18 @@ uint16_t I2C_DMA_ReadDataBuffer(uint32_t RegisterAddr)
   */
 static uint16_t IOE_TP_Read_X(void)
 {
-  int32_t x, xr;
-  
   /* Read x value from DATA_X register */
-  x = I2C_ReadDataBuffer(IOE_REG_TP_DATA_X);
+  return IOE_TP_ScaleX(I2C_ReadDataBuffer(IOE_REG_TP_DATA_X));
+}
+
+/**
+  * @brief  Converts a raw Touch Panel X sample to a screen X position.
+  * @param  Raw: 12-bit X sample.
+  * @retval X position.
+  */
+uint16_t IOE_TP_ScaleX(uint16_t Raw)
+{
+  int32_t x = Raw, xr;
   
   /* x value first correction */
   if(x <= 3000)
@@ -860,10 +607,18 @@ static uint16_t IOE_TP_Read_X(void)
   */
 static uint16_t IOE_TP_Read_Y(void)
 {
-  int32_t y, yr;
-  
   /* Read y value from DATA_Y register */
-  y = I2C_ReadDataBuffer(IOE_REG_TP_DATA_Y);
+  return IOE_TP_ScaleY(I2C_ReadDataBuffer(IOE_REG_TP_DATA_Y));
+}
+
+/**
+  * @brief  Converts a raw Touch Panel Y sample to a screen Y position.
+  * @param  Raw: 12-bit Y sample.
+  * @retval Y position.
+  */
+uint16_t IOE_TP_ScaleY(uint16_t Raw)
+{
+  int32_t y = Raw, yr;
   
   /* y value first correction */
 
@@ -905,144 +660,54 @@ static uint16_t IOE_TP_Read_Z(void)
 }
 
 /**
-  * @brief  Initializes the GPIO pins used by the IO expander.
+  * @brief  Enables the clocks of the IO expander interrupt pin. The I2C pins
+  *         belong to the I2C transaction queue.
   * @param  None
   * @retval None
   */
 static void IOE_GPIO_Config(void)
 {
-  GPIO_InitTypeDef GPIO_InitStructure;
-  
-  /* Enable IOE_I2C and IOE_I2C_GPIO_PORT & Alternate Function clocks */
-  RCC_APB1PeriphClockCmd(IOE_I2C_CLK, ENABLE);
-  RCC_AHB1PeriphClockCmd(IOE_I2C_SCL_GPIO_CLK | IOE_I2C_SDA_GPIO_CLK |
-                         IOE_IT_GPIO_CLK, ENABLE);
+  RCC_AHB1PeriphClockCmd(IOE_IT_GPIO_CLK, ENABLE);
   RCC_APB2PeriphClockCmd(RCC_APB2Periph_SYSCFG, ENABLE);
-  
-  /* Reset IOE_I2C IP */
-  RCC_APB1PeriphResetCmd(IOE_I2C_CLK, ENABLE);
-  /* Release reset signal of IOE_I2C IP */
-  RCC_APB1PeriphResetCmd(IOE_I2C_CLK, DISABLE);
-
-  /* Connect PXx to I2C_SCL*/
-  GPIO_PinAFConfig(IOE_I2C_SCL_GPIO_PORT, IOE_I2C_SCL_SOURCE, IOE_I2C_SCL_AF);
-  /* Connect PXx to I2C_SDA*/
-  GPIO_PinAFConfig(IOE_I2C_SDA_GPIO_PORT, IOE_I2C_SDA_SOURCE, IOE_I2C_SDA_AF); 
-    
-  /* IOE_I2C SCL and SDA pins configuration */
-  GPIO_InitStructure.GPIO_Pin = IOE_I2C_SCL_PIN;
-  GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF;
-  GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
-  GPIO_InitStructure.GPIO_OType = GPIO_OType_OD;
-  GPIO_InitStructure.GPIO_PuPd  = GPIO_PuPd_NOPULL;
-  GPIO_Init(IOE_I2C_SCL_GPIO_PORT, &GPIO_InitStructure);
-
-  GPIO_InitStructure.GPIO_Pin = IOE_I2C_SDA_PIN;
-  GPIO_Init(IOE_I2C_SDA_GPIO_PORT, &GPIO_InitStructure);
-  
 }
 
 /**
   * @brief  Configure the I2C Peripheral used to communicate with IO_Expanders.
+  *         The bus is shared with the EEPROM through the I2C transaction queue.
   * @param  None
   * @retval None
   */
 static void IOE_I2C_Config(void)
 {
-  I2C_InitTypeDef I2C_InitStructure;
-  
-  /* IOE_I2C configuration */
-  I2C_InitStructure.I2C_Mode = I2C_Mode_I2C;
-  I2C_InitStructure.I2C_DutyCycle = I2C_DutyCycle_2;
-  I2C_InitStructure.I2C_OwnAddress1 = 0x00;
-  I2C_InitStructure.I2C_Ack = I2C_Ack_Enable;
-  I2C_InitStructure.I2C_AcknowledgedAddress = I2C_AcknowledgedAddress_7bit;
-  I2C_InitStructure.I2C_ClockSpeed = I2C_SPEED;
-  
-  /* Initialize the I2C peripheral */
-  I2C_Init(IOE_I2C, &I2C_InitStructure);
-  
-  /* Enable the I2C peripheral */
-  I2C_Cmd(IOE_I2C, ENABLE);
+  I2CM_Init();
 }
 
 /**
-  * @brief  Configure the DMA Peripheral used to handle communication via I2C.
-  * @param  None
-  * @retval None
+  * @brief  Runs one register transaction with the IO expander and waits for it.
+  * @param  Direction: I2CM_DIR_WRITE or I2CM_DIR_READ.
+  * @param  RegisterAddr: The target register address
+  * @param  Buffer: data to write or read.
+  * @param  Length: number of data bytes.
+  * @retval I2CM_OK or the transaction error.
   */
-
-static void IOE_DMA_Config(IOE_DMADirection_TypeDef Direction, uint8_t* buffer)
+static uint8_t IOE_Transfer(uint8_t Direction, uint8_t RegisterAddr, uint8_t* Buffer, uint16_t Length)
 {
-  DMA_InitTypeDef DMA_InitStructure;
-  
-  RCC_AHB1PeriphClockCmd(IOE_DMA_CLK, ENABLE);
-  
-  /* Initialize the DMA_Channel member */
-  DMA_InitStructure.DMA_Channel = IOE_DMA_CHANNEL;
-  
-  /* Initialize the DMA_PeripheralBaseAddr member */
-  DMA_InitStructure.DMA_PeripheralBaseAddr = IOE_I2C_DR;
-  
-  /* Initialize the DMA_Memory0BaseAddr member */
-  DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)buffer;
-  
-  /* Initialize the DMA_PeripheralInc member */
-  DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
-  
-  /* Initialize the DMA_MemoryInc member */
-  DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
-  
-  /* Initialize the DMA_PeripheralDataSize member */
-  DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
-  
-  /* Initialize the DMA_MemoryDataSize member */
-  DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
-  
-  /* Initialize the DMA_Mode member */
-  DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
-  
-  /* Initialize the DMA_Priority member */
-  DMA_InitStructure.DMA_Priority = DMA_Priority_Low;
-  
-  /* Initialize the DMA_FIFOMode member */
-  DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Enable;
-  
-  /* Initialize the DMA_FIFOThreshold member */
-  DMA_InitStructure.DMA_FIFOThreshold = DMA_FIFOThreshold_1QuarterFull;
-  
-  /* Initialize the DMA_MemoryBurst member */
-  DMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_Single;
-  
-  /* Initialize the DMA_PeripheralBurst member */
-  DMA_InitStructure.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
-  
-  /* If using DMA for Reception */
-  if (Direction == IOE_DMA_RX)
-  {    
-    /* Initialize the DMA_DIR member */
-    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralToMemory;
-    
-    /* Initialize the DMA_BufferSize member */
-    DMA_InitStructure.DMA_BufferSize = 2;
-    
-    DMA_DeInit(IOE_DMA_RX_STREAM);
-    
-    DMA_Init(IOE_DMA_RX_STREAM, &DMA_InitStructure);
-  }
-  /* If using DMA for Transmission */
-  else if (Direction == IOE_DMA_TX)
-  { 
-    /* Initialize the DMA_DIR member */
-    DMA_InitStructure.DMA_DIR = DMA_DIR_MemoryToPeripheral;
-    
-    /* Initialize the DMA_BufferSize member */
-    DMA_InitStructure.DMA_BufferSize = 1;
-    
-    DMA_DeInit(IOE_DMA_TX_STREAM);
-    
-    DMA_Init(IOE_DMA_TX_STREAM, &DMA_InitStructure);
-  }
+  I2CM_Transfer xfer;
+  uint8_t status;
+
+  xfer.Address = IOE_ADDR;
+  xfer.Direction = Direction;
+  xfer.RegSize = 1;
+  xfer.Register = RegisterAddr;
+  xfer.Buffer = Buffer;
+  xfer.Length = Length;
+
+  status = I2CM_Run(&xfer);
+
+  /* IOE_IsOperational() tells a timeout from a wrong ID with IOE_TimeOut */
+  IOE_TimeOut = (status == I2CM_OK) ? TIMEOUT_MAX : 0;
+
+  return status;
 }
 
 /**
@@ -1055,64 +720,16 @@ uint8_t I2C_WriteDeviceRegister(uint8_t RegisterAddr, uint8_t RegisterValue)
 {
   uint32_t read_verif = 0;
 
-  /* Begin the configuration sequence */
-  I2C_GenerateSTART(IOE_I2C, ENABLE);
-
-  /* Test on EV5 and clear it */
-  IOE_TimeOut = TIMEOUT_MAX;
-  while (!I2C_GetFlagStatus(IOE_I2C, I2C_FLAG_SB))
+  if (IOE_Transfer(I2CM_DIR_WRITE, RegisterAddr, &RegisterValue, 1) != I2CM_OK)
   {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
+    return(IOE_TimeoutUserCallback());
   }
-
-  /* Transmit the slave address and enable writing operation */
-  I2C_Send7bitAddress(IOE_I2C, IOE_ADDR, I2C_Direction_Transmitter);
-  
-  /* Test on EV6 and clear it */
-  IOE_TimeOut = TIMEOUT_MAX;  
-  while (!I2C_GetFlagStatus(IOE_I2C, I2C_FLAG_ADDR))
-  {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
-  }
-  
-  /* Read status register 2 to clear ADDR flag */
-  IOE_I2C->SR2;
-  
-  /* Test on EV8_1 and clear it */
-  IOE_TimeOut = TIMEOUT_MAX;
-  while (!I2C_GetFlagStatus(IOE_I2C, I2C_FLAG_TXE))
-  {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
-  }
-  
-  /* Transmit the first address for r/w operations */
-  I2C_SendData(IOE_I2C, RegisterAddr);
-  
-  /* Test on EV8 and clear it */
-  IOE_TimeOut = TIMEOUT_MAX;
-  while (!I2C_GetFlagStatus(IOE_I2C, I2C_FLAG_TXE))
-  {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
-  }
-  
-  /* Prepare the register value to be sent */
-  I2C_SendData(IOE_I2C, RegisterValue);
-  
-  /* Test on EV8_2 and clear it */
-  IOE_TimeOut = TIMEOUT_MAX;
-  while ((!I2C_GetFlagStatus(IOE_I2C, I2C_FLAG_TXE)) || (!I2C_GetFlagStatus(IOE_I2C, I2C_FLAG_BTF)))
-  {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
-  }
-  
-  /* End the configuration sequence */
-  I2C_GenerateSTOP(IOE_I2C, ENABLE);
   
 #ifdef VERIFY_WRITTENDATA
   /* Verify (if needed) that the loaded data is correct  */
   
   /* Read the just written register*/
-  read_verif = IOE_I2C_ReadDeviceRegister(RegisterAddr);
+  read_verif = I2C_ReadDeviceRegister(RegisterAddr);
 
   /* Load the register and verify its value  */
   if (read_verif != RegisterValue)
@@ -1129,109 +746,28 @@ uint8_t I2C_WriteDeviceRegister(uint8_t RegisterAddr, uint8_t RegisterValue)
   
   /* Return the verifying value: 0 (Passed) or 1 (Failed) */
   return read_verif;
-  
 }
 
-
 /**
-  * @brief  Reads a register of the device through I2C without DMA.
+  * @brief  Reads a register of the device through I2C.
   * @param  RegisterAddr: The target register address (between 00x and 0x24)
-  * @retval The value of the read register (0xAA if Timeout occurred)   
+  * @retval The value of the read register (0 if Timeout occurred)   
   */ 
 uint8_t I2C_ReadDeviceRegister(uint8_t RegisterAddr)
 {
   uint8_t tmp = 0;
   
-  /* Enable the I2C peripheral */
-  I2C_GenerateSTART(IOE_I2C, ENABLE);
-  
-    /* Test on EV5 and clear it */
-  IOE_TimeOut = TIMEOUT_MAX;
-  while (!I2C_GetFlagStatus(IOE_I2C, I2C_FLAG_SB))
-  {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
-  }
-  /* Disable Acknowledgement */
-  I2C_AcknowledgeConfig(IOE_I2C, DISABLE);
-  
-  /* Transmit the slave address and enable writing operation */
-  I2C_Send7bitAddress(IOE_I2C, IOE_ADDR, I2C_Direction_Transmitter);
-  
-  /* Test on EV6 and clear it */
-  IOE_TimeOut = TIMEOUT_MAX;  
-  while (!I2C_GetFlagStatus(IOE_I2C, I2C_FLAG_ADDR))
-  {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
-  }
-  
-  /* Read status register 2 to clear ADDR flag */
-  IOE_I2C->SR2;
-  
-  /* Test on EV8 and clear it */
-  IOE_TimeOut = TIMEOUT_MAX;
-  while (!I2C_GetFlagStatus(IOE_I2C, I2C_FLAG_TXE))
-  {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
-  }
-  
-  /* Transmit the first address for r/w operations */
-  I2C_SendData(IOE_I2C, RegisterAddr);
-  
-  /* Test on EV8 and clear it */
-  IOE_TimeOut = TIMEOUT_MAX;
-  while ((!I2C_GetFlagStatus(IOE_I2C, I2C_FLAG_TXE)) || (!I2C_GetFlagStatus(IOE_I2C, I2C_FLAG_BTF)))
+  if (IOE_Transfer(I2CM_DIR_READ, RegisterAddr, &tmp, 1) != I2CM_OK)
   {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
+    return(IOE_TimeoutUserCallback());
   }
   
-  /* Regenerate a start condition */
-  I2C_GenerateSTART(IOE_I2C, ENABLE);
-  
-  /* Test on EV5 and clear it */
-  IOE_TimeOut = TIMEOUT_MAX;
-  while (!I2C_GetFlagStatus(IOE_I2C, I2C_FLAG_SB))
-  {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
-  }
-  
-  /* Transmit the slave address and enable writing operation */
-  I2C_Send7bitAddress(IOE_I2C, IOE_ADDR, I2C_Direction_Receiver);
-  
-  /* Test on EV6 and clear it */
-  IOE_TimeOut = TIMEOUT_MAX;
-  while (!I2C_GetFlagStatus(IOE_I2C, I2C_FLAG_ADDR))
-  {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
-  }
-  
-    /* Read status register 2 to clear ADDR flag */
-  IOE_I2C->SR2;
-  
-  /* Test on EV7 and clear it */
-  IOE_TimeOut = TIMEOUT_MAX;
-  while (!I2C_GetFlagStatus(IOE_I2C, I2C_FLAG_RXNE))
-  {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
-  }
-  
-  /* End the configuration sequence */
-  I2C_GenerateSTOP(IOE_I2C, ENABLE);
-  
-  /* Load the register value */
-  tmp = I2C_ReceiveData(IOE_I2C);
-  
-  /* Enable Acknowledgement */
-  I2C_AcknowledgeConfig(IOE_I2C, ENABLE);
-  
   /* Return the read value */
   return tmp;
-  
 }
 
 /**
   * @brief  Reads a buffer of 2 bytes from the device registers.
-  * @param  DeviceAddr: The address of the device, could be : IOE_1_ADDR
-  *         or IOE_2_ADDR. 
   * @param  RegisterAddr: The target register adress (between 00x and 0x24)
   * @retval The data in the buffer containing the two returned bytes (in halfword).   
   */
@@ -1239,88 +775,13 @@ uint16_t I2C_ReadDataBuffer(uint32_t RegisterAddr)
 {
   uint8_t IOE_BufferRX[2] = {0x00, 0x00};  
   
-  /* Enable the I2C peripheral */
-  I2C_GenerateSTART(IOE_I2C, ENABLE);
- 
-  /* Test on EV5 and clear it */
-  IOE_TimeOut = TIMEOUT_MAX;
-  while (!I2C_GetFlagStatus(IOE_I2C, I2C_FLAG_SB))
+  if (IOE_Transfer(I2CM_DIR_READ, (uint8_t)RegisterAddr, IOE_BufferRX, 2) != I2CM_OK)
   {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
+    return(IOE_TimeoutUserCallback());
   }
    
-  /* Send device address for write */
-  I2C_Send7bitAddress(IOE_I2C, IOE_ADDR, I2C_Direction_Transmitter);
-  
-  /* Test on EV6 and clear it */
-  IOE_TimeOut = TIMEOUT_MAX;  
-  while (!I2C_GetFlagStatus(IOE_I2C, I2C_FLAG_ADDR))
-  {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
-  }
-  
-  /* Read status register 2 to clear ADDR flag */
-  IOE_I2C->SR2;
-  
-  /* Test on EV8 and clear it */
-  IOE_TimeOut = TIMEOUT_MAX;
-  while (!I2C_GetFlagStatus(IOE_I2C, I2C_FLAG_TXE))
-  {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
-  }
-  
-  /* Send the device's internal address to write to */
-  I2C_SendData(IOE_I2C, RegisterAddr);  
-    
-  /* Send START condition a second time */  
-  I2C_GenerateSTART(IOE_I2C, ENABLE);
-  
-  /* Test on EV5 and clear it */
-  IOE_TimeOut = TIMEOUT_MAX;
-  while (!I2C_GetFlagStatus(IOE_I2C, I2C_FLAG_SB))
-  {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
-  }
-  
-  /* Send IO Expander address for read */
-  I2C_Send7bitAddress(IOE_I2C, IOE_ADDR, I2C_Direction_Receiver);
-  
-  /* Test on EV6 and clear it */
-  IOE_TimeOut = TIMEOUT_MAX;
-  while (!I2C_GetFlagStatus(IOE_I2C, I2C_FLAG_ADDR))
-  {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
-  }
- 
-  /* Disable Acknowledgement and set Pos bit */
-  I2C_AcknowledgeConfig(IOE_I2C, DISABLE);       
-  I2C_NACKPositionConfig(IOE_I2C, I2C_NACKPosition_Next);
-  
-  /* Read status register 2 to clear ADDR flag */
-  IOE_I2C->SR2;
-
-  /* Test on EV7 and clear it */
-  IOE_TimeOut = TIMEOUT_MAX;
-  while (!I2C_GetFlagStatus(IOE_I2C, I2C_FLAG_BTF))
-  {
-    if (IOE_TimeOut-- == 0) return(IOE_TimeoutUserCallback());
-  }
- 
-  /* Send STOP Condition */
-  I2C_GenerateSTOP(IOE_I2C, ENABLE);
-   
-  /* Read the first byte from the IO Expander */
-  IOE_BufferRX[1] = I2C_ReceiveData(IOE_I2C);
-    
-  /* Read the second byte from the IO Expander */
-  IOE_BufferRX[0] = I2C_ReceiveData(IOE_I2C);
-                                         
-  /* Enable Acknowledgement and reset POS bit to be ready for another reception */
-  I2C_AcknowledgeConfig(IOE_I2C, ENABLE);
-  I2C_NACKPositionConfig(IOE_I2C, I2C_NACKPosition_Current);
-   
-  /* return the data */
-  return ((uint16_t) IOE_BufferRX[0] | ((uint16_t)IOE_BufferRX[1]<< 8));
+  /* The device sends the MSB first */
+  return ((uint16_t)IOE_BufferRX[0] << 8) | (uint16_t)IOE_BufferRX[1];
 }
 
 #ifndef USE_TIMEOUT_USER_CALLBACK 
@@ -1331,27 +792,7 @@ uint16_t I2C_ReadDataBuffer(uint32_t RegisterAddr)
   */
 uint8_t IOE_TimeoutUserCallback(void)
 {
-  I2C_InitTypeDef I2C_InitStructure;
-
-  I2C_GenerateSTOP(IOE_I2C, ENABLE);
-  I2C_SoftwareResetCmd(IOE_I2C, ENABLE);
-  I2C_SoftwareResetCmd(IOE_I2C, DISABLE);
-  
-  IOE_GPIO_Config();
-
-  /* CODEC_I2C peripheral configuration */
-  I2C_DeInit(IOE_I2C);
-  I2C_InitStructure.I2C_Mode = I2C_Mode_I2C;
-  I2C_InitStructure.I2C_DutyCycle = I2C_DutyCycle_2;
-  I2C_InitStructure.I2C_OwnAddress1 = 0x33;
-  I2C_InitStructure.I2C_Ack = I2C_Ack_Enable;
-  I2C_InitStructure.I2C_AcknowledgedAddress = I2C_AcknowledgedAddress_7bit;
-  I2C_InitStructure.I2C_ClockSpeed = I2C_SPEED;
-  
-  /* Enable the I2C peripheral */
-  I2C_Cmd(IOE_I2C, ENABLE);  
-  I2C_Init(IOE_I2C, &I2C_InitStructure);
-  
+  /* A stuck bus has already been reset by I2CM_Run() */
   return 0;
 }
 #endif /* !USE_TIMEOUT_USER_CALLBACK */
@@ -47,6 +47,7 @@
    
 /* Includes ------------------------------------------------------------------*/
 #include "stm32f429i_discovery.h"
+#include "stm32f429i_discovery_i2c.h"
    
 /** @addtogroup Utilities
   * @{
@@ -202,13 +203,15 @@ typedef enum
 /** 
   * @brief  IO Expander Interrupt line on EXTI  
   */ 
-#define IOE_IT_PIN                 GPIO_Pin_2
-#define IOE_IT_GPIO_PORT           GPIOI
-#define IOE_IT_GPIO_CLK            RCC_AHB1Periph_GPIOI
-#define IOE_IT_EXTI_PORT_SOURCE    EXTI_PortSourceGPIOI
-#define IOE_IT_EXTI_PIN_SOURCE     EXTI_PinSource2
-#define IOE_IT_EXTI_LINE           EXTI_Line2
-#define IOE_IT_EXTI_IRQn           EXTI2_IRQn   
+#define IOE_IT_PIN                 GPIO_Pin_15                 /* PA.15 */
+#define IOE_IT_GPIO_PORT           GPIOA
+#define IOE_IT_GPIO_CLK            RCC_AHB1Periph_GPIOA
+#define IOE_IT_EXTI_PORT_SOURCE    EXTI_PortSourceGPIOA
+#define IOE_IT_EXTI_PIN_SOURCE     EXTI_PinSource15
+#define IOE_IT_EXTI_LINE           EXTI_Line15
+#define IOE_IT_EXTI_LINE_NUMBER    15                          /* EXTI_Line15, for #if checks */
+#define IOE_IT_EXTI_IRQn           EXTI15_10_IRQn
+#define IOE_IT_EXTI_IRQHandler     EXTI15_10_IRQHandler
 
 /**
   * @brief Eval Board IO Exapander Pins definition 
@@ -325,6 +328,7 @@ typedef enum
 #define IOE_REG_TP_DATA_XYZ        0x52 
 #define IOE_REG_TP_FRACT_XYZ       0x56
 #define IOE_REG_TP_DATA            0x57
+#define IOE_REG_TP_DATA_NI         0xD7   /* TP_DATA, address not incremented in bursts */
 #define IOE_REG_TP_I_DRIVE         0x58
 #define IOE_REG_TP_SHIELD          0x59
 
@@ -432,6 +436,8 @@ uint8_t  IOE_IOAFConfig(uint8_t IO_Pin, FunctionalState NewState);
   */
 TP_STATE* IOE_TP_GetState(void);
 uint8_t   IOE_TP_Config(void);
+uint16_t  IOE_TP_ScaleX(uint16_t Raw);
+uint16_t  IOE_TP_ScaleY(uint16_t Raw);
 
 /** 
   * @brief Low Layer functions
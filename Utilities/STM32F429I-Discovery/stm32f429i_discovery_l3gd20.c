@@ -27,6 +27,13 @@
   */
 /* Includes ------------------------------------------------------------------*/
 #include "stm32f429i_discovery_l3gd20.h"
+#include "stm32f429i_discovery_ioe.h"
+
+/* INT2 & the touch controller interrupt each need their own EXTI line */
+#if L3GD20_SPI_INT2_EXTI_LINE_NUMBER == IOE_IT_EXTI_LINE_NUMBER
+#error "L3GD20 INT2 and IOE_IT on the same EXTI line"
+#endif
+
 /** @addtogroup Utilities
   * @{
   */ 
@@ -72,6 +79,18 @@
   * @{
   */ 
 __IO uint32_t  L3GD20Timeout = L3GD20_FLAG_TIMEOUT;  
+
+/* FIFO burst engine: command byte followed by 6 bytes per sample, both ways */
+static uint8_t L3GD20_TxBuffer[1 + 6 * L3GD20_FIFO_DEPTH];
+static uint8_t L3GD20_RxBuffer[1 + 6 * L3GD20_FIFO_DEPTH];
+/* Sample ring: Head moved by the DMA interrupt, Tail by L3GD20_FifoRead */
+static L3GD20_SampleTypeDef L3GD20_Ring[L3GD20_RING_SIZE];
+static __IO uint32_t L3GD20_RingHead = 0;
+static __IO uint32_t L3GD20_RingTail = 0;
+/* Samples per burst, 0 while the engine is off */
+static __IO uint8_t L3GD20_Watermark = 0;
+static __IO uint8_t L3GD20_DmaBusy = 0;
+static L3GD20_FifoStatsTypeDef L3GD20_Stats;
 /**
   * @}
   */
@@ -81,6 +100,10 @@ __IO uint32_t  L3GD20Timeout = L3GD20_FLAG_TIMEOUT;
   */
 static uint8_t L3GD20_SendByte(uint8_t byte);
 static void L3GD20_LowLevel_Init(void);
+static void L3GD20_FifoLock(void);
+static void L3GD20_FifoUnlock(void);
+static void L3GD20_FifoStart(void);
+static void L3GD20_FifoPublish(void);
 /**
   * @}
   */
@@ -290,6 +313,9 @@ void L3GD20_Write(uint8_t* pBuffer, uint8_t WriteAddr, uint16_t NumByteToWrite)
   {
     WriteAddr |= (uint8_t)MULTIPLEBYTE_CMD;
   }
+  /* Keep the FIFO burst engine off the bus */
+  L3GD20_FifoLock();
+  
   /* Set chip select Low at the start of the transmission */
   L3GD20_CS_LOW();
   
@@ -305,6 +331,8 @@ void L3GD20_Write(uint8_t* pBuffer, uint8_t WriteAddr, uint16_t NumByteToWrite)
   
   /* Set chip select High at the end of the transmission */ 
   L3GD20_CS_HIGH();
+  
+  L3GD20_FifoUnlock();
 }
 
 /**
@@ -324,6 +352,9 @@ void L3GD20_Read(uint8_t* pBuffer, uint8_t ReadAddr, uint16_t NumByteToRead)
   {
     ReadAddr |= (uint8_t)READWRITE_CMD;
   }
+  /* Keep the FIFO burst engine off the bus */
+  L3GD20_FifoLock();
+  
   /* Set chip select Low at the start of the transmission */
   L3GD20_CS_LOW();
   
@@ -341,7 +372,358 @@ void L3GD20_Read(uint8_t* pBuffer, uint8_t ReadAddr, uint16_t NumByteToRead)
   
   /* Set chip select High at the end of the transmission */ 
   L3GD20_CS_HIGH();
+  
+  L3GD20_FifoUnlock();
 }  
+
+/**
+  * @brief  Starts the FIFO burst engine: the L3GD20 FIFO runs in stream mode,
+  *         INT2 rises when Watermark samples are stored and each rising edge
+  *         reads them with one SPI DMA transfer into the sample ring.
+  *         Must be called after L3GD20_Init(), output data must be LSB first.
+  * @param  Watermark: samples per burst, 1..31.
+  * @retval None
+  */
+void L3GD20_FifoInit(uint8_t Watermark)
+{
+  DMA_InitTypeDef  DMA_InitStructure;
+  EXTI_InitTypeDef EXTI_InitStructure;
+  NVIC_InitTypeDef NVIC_InitStructure;
+  uint8_t tmpreg;
+  
+  if(Watermark == 0)
+  {
+    Watermark = 1;
+  }
+  if(Watermark >= L3GD20_FIFO_DEPTH)
+  {
+    Watermark = L3GD20_FIFO_DEPTH - 1;
+  }
+  
+  L3GD20_FifoDeInit();
+  
+  L3GD20_RingHead = 0;
+  L3GD20_RingTail = 0;
+  L3GD20_Stats.Bursts = 0;
+  L3GD20_Stats.Samples = 0;
+  L3GD20_Stats.Dropped = 0;
+  L3GD20_Stats.Errors = 0;
+  
+  /* Read from OUT_X_L with auto increment, the address wraps back to OUT_X_L
+     after OUT_Z_H while the FIFO is enabled; the other TX bytes stay dummy */
+  L3GD20_TxBuffer[0] = L3GD20_OUT_X_L_ADDR | READWRITE_CMD | MULTIPLEBYTE_CMD;
+  
+  /* SPI RX and TX DMA streams, byte wide, the length is set per burst */
+  RCC_AHB1PeriphClockCmd(L3GD20_DMA_CLK, ENABLE);
+  
+  DMA_Cmd(L3GD20_DMA_RX_STREAM, DISABLE);
+  DMA_Cmd(L3GD20_DMA_TX_STREAM, DISABLE);
+  DMA_DeInit(L3GD20_DMA_RX_STREAM);
+  DMA_DeInit(L3GD20_DMA_TX_STREAM);
+  
+  DMA_InitStructure.DMA_Channel = L3GD20_DMA_CHANNEL;
+  DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&L3GD20_SPI->DR;
+  DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)L3GD20_RxBuffer;
+  DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralToMemory;
+  DMA_InitStructure.DMA_BufferSize = sizeof(L3GD20_RxBuffer);
+  DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+  DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+  DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+  DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+  DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+  DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+  DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Disable;
+  DMA_InitStructure.DMA_FIFOThreshold = DMA_FIFOThreshold_Full;
+  DMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+  DMA_InitStructure.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+  DMA_Init(L3GD20_DMA_RX_STREAM, &DMA_InitStructure);
+  
+  DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)L3GD20_TxBuffer;
+  DMA_InitStructure.DMA_DIR = DMA_DIR_MemoryToPeripheral;
+  DMA_InitStructure.DMA_BufferSize = sizeof(L3GD20_TxBuffer);
+  DMA_Init(L3GD20_DMA_TX_STREAM, &DMA_InitStructure);
+  
+  /* Only RX completion is needed: the last byte is received after it is sent */
+  DMA_ITConfig(L3GD20_DMA_RX_STREAM, DMA_IT_TC | DMA_IT_TE, ENABLE);
+  
+  NVIC_InitStructure.NVIC_IRQChannel = L3GD20_DMA_RX_IRQn;
+  NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = L3GD20_DMA_PREPRIO;
+  NVIC_InitStructure.NVIC_IRQChannelSubPriority = L3GD20_DMA_SUBPRIO;
+  NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+  NVIC_Init(&NVIC_InitStructure);
+  
+  /* INT2 rising edge on EXTI, same priority as the DMA so they never nest */
+  RCC_APB2PeriphClockCmd(RCC_APB2Periph_SYSCFG, ENABLE);
+  SYSCFG_EXTILineConfig(L3GD20_SPI_INT2_EXTI_PORT_SOURCE, L3GD20_SPI_INT2_EXTI_PIN_SOURCE);
+  
+  EXTI_InitStructure.EXTI_Line = L3GD20_SPI_INT2_EXTI_LINE;
+  EXTI_InitStructure.EXTI_Mode = EXTI_Mode_Interrupt;
+  EXTI_InitStructure.EXTI_Trigger = EXTI_Trigger_Rising;
+  EXTI_InitStructure.EXTI_LineCmd = ENABLE;
+  EXTI_Init(&EXTI_InitStructure);
+  EXTI_ClearITPendingBit(L3GD20_SPI_INT2_EXTI_LINE);
+  
+  /* Sensor side: stream mode with watermark, FIFO on, watermark on INT2 */
+  tmpreg = L3GD20_FIFO_MODE_STREAM | (Watermark & L3GD20_FIFO_WTM_MASK);
+  L3GD20_Write(&tmpreg, L3GD20_FIFO_CTRL_REG_ADDR, 1);
+  
+  L3GD20_Read(&tmpreg, L3GD20_CTRL_REG5_ADDR, 1);
+  tmpreg |= L3GD20_FIFO_ENABLE;
+  L3GD20_Write(&tmpreg, L3GD20_CTRL_REG5_ADDR, 1);
+  
+  L3GD20_Read(&tmpreg, L3GD20_CTRL_REG3_ADDR, 1);
+  tmpreg |= L3GD20_INT2_WATERMARK;
+  L3GD20_Write(&tmpreg, L3GD20_CTRL_REG3_ADDR, 1);
+  
+  L3GD20_Watermark = Watermark;
+  
+  NVIC_InitStructure.NVIC_IRQChannel = L3GD20_SPI_INT2_EXTI_IRQn;
+  NVIC_Init(&NVIC_InitStructure);
+  
+  /* The watermark may already be reached, no edge would come then */
+  __disable_irq();
+  if((L3GD20_DmaBusy == 0) &&
+     (GPIO_ReadInputDataBit(L3GD20_SPI_INT2_GPIO_PORT, L3GD20_SPI_INT2_PIN) == Bit_SET))
+  {
+    L3GD20_FifoStart();
+  }
+  __enable_irq();
+}
+
+/**
+  * @brief  Stops the FIFO burst engine and puts the L3GD20 FIFO in bypass mode.
+  *         Samples already in the ring can still be read.
+  * @param  None
+  * @retval None
+  */
+void L3GD20_FifoDeInit(void)
+{
+  EXTI_InitTypeDef EXTI_InitStructure;
+  uint8_t tmpreg;
+  
+  if(L3GD20_Watermark == 0)
+  {
+    return;
+  }
+  
+  /* Let a running burst finish, then no new one can start */
+  L3GD20_FifoLock();
+  L3GD20_Watermark = 0;
+  NVIC_DisableIRQ(L3GD20_DMA_RX_IRQn);
+  
+  EXTI_InitStructure.EXTI_Line = L3GD20_SPI_INT2_EXTI_LINE;
+  EXTI_InitStructure.EXTI_Mode = EXTI_Mode_Interrupt;
+  EXTI_InitStructure.EXTI_Trigger = EXTI_Trigger_Rising;
+  EXTI_InitStructure.EXTI_LineCmd = DISABLE;
+  EXTI_Init(&EXTI_InitStructure);
+  EXTI_ClearITPendingBit(L3GD20_SPI_INT2_EXTI_LINE);
+  
+  L3GD20_Read(&tmpreg, L3GD20_CTRL_REG3_ADDR, 1);
+  tmpreg &= (uint8_t)~L3GD20_INT2_WATERMARK;
+  L3GD20_Write(&tmpreg, L3GD20_CTRL_REG3_ADDR, 1);
+  
+  tmpreg = L3GD20_FIFO_MODE_BYPASS;
+  L3GD20_Write(&tmpreg, L3GD20_FIFO_CTRL_REG_ADDR, 1);
+}
+
+/**
+  * @brief  Takes samples out of the ring filled by the FIFO burst engine.
+  * @param  pSamples: destination array.
+  * @param  MaxSamples: size of the destination array.
+  * @retval Number of samples copied, oldest first.
+  */
+uint16_t L3GD20_FifoRead(L3GD20_SampleTypeDef *pSamples, uint16_t MaxSamples)
+{
+  uint32_t tail = L3GD20_RingTail;
+  uint32_t count = L3GD20_RingHead - tail;
+  uint32_t index;
+  
+  if(count > MaxSamples)
+  {
+    count = MaxSamples;
+  }
+  
+  /* Samples are written before Head moves, read them before Tail moves */
+  __DMB();
+  for(index = 0; index < count; index++)
+  {
+    pSamples[index] = L3GD20_Ring[(tail + index) % L3GD20_RING_SIZE];
+  }
+  __DMB();
+  L3GD20_RingTail = tail + count;
+  
+  return (uint16_t)count;
+}
+
+/**
+  * @brief  Number of samples waiting in the ring.
+  * @param  None
+  * @retval Sample count.
+  */
+uint16_t L3GD20_FifoPending(void)
+{
+  return (uint16_t)(L3GD20_RingHead - L3GD20_RingTail);
+}
+
+/**
+  * @brief  Copies the FIFO burst engine counters.
+  * @param  pStats: pointer to the destination structure.
+  * @retval None
+  */
+void L3GD20_FifoGetStats(L3GD20_FifoStatsTypeDef *pStats)
+{
+  __disable_irq();
+  *pStats = L3GD20_Stats;
+  __enable_irq();
+}
+
+/**
+  * @brief  INT2 watermark interrupt: starts a burst unless one is running
+  *         (the running one restarts itself while INT2 stays high).
+  * @param  None
+  * @retval None
+  */
+void L3GD20_SPI_INT2_IRQHandler(void)
+{
+  if(EXTI_GetITStatus(L3GD20_SPI_INT2_EXTI_LINE) != RESET)
+  {
+    EXTI_ClearITPendingBit(L3GD20_SPI_INT2_EXTI_LINE);
+    
+    if((L3GD20_Watermark != 0) && (L3GD20_DmaBusy == 0))
+    {
+      L3GD20_FifoStart();
+    }
+  }
+}
+
+/**
+  * @brief  SPI RX DMA interrupt: ends the burst and publishes its samples.
+  * @param  None
+  * @retval None
+  */
+void L3GD20_DMA_RX_IRQHandler(void)
+{
+  uint8_t done = 0;
+  
+  if(DMA_GetITStatus(L3GD20_DMA_RX_STREAM, DMA_IT_TEIF3) != RESET)
+  {
+    DMA_ClearITPendingBit(L3GD20_DMA_RX_STREAM, DMA_IT_TEIF3);
+    L3GD20_Stats.Errors++;
+    done = 1;
+  }
+  if(DMA_GetITStatus(L3GD20_DMA_RX_STREAM, DMA_IT_TCIF3) != RESET)
+  {
+    DMA_ClearITPendingBit(L3GD20_DMA_RX_STREAM, DMA_IT_TCIF3);
+    L3GD20_FifoPublish();
+    L3GD20_Stats.Bursts++;
+    done = 1;
+  }
+  if(done == 0)
+  {
+    return;
+  }
+  
+  SPI_I2S_DMACmd(L3GD20_SPI, SPI_I2S_DMAReq_Rx | SPI_I2S_DMAReq_Tx, DISABLE);
+  DMA_Cmd(L3GD20_DMA_TX_STREAM, DISABLE);
+  DMA_Cmd(L3GD20_DMA_RX_STREAM, DISABLE);
+  L3GD20_CS_HIGH();
+  L3GD20_DmaBusy = 0;
+  
+  /* More than a watermark was stored meanwhile: INT2 stayed high, no new edge */
+  if((L3GD20_Watermark != 0) &&
+     (GPIO_ReadInputDataBit(L3GD20_SPI_INT2_GPIO_PORT, L3GD20_SPI_INT2_PIN) == Bit_SET))
+  {
+    L3GD20_FifoStart();
+  }
+}
+
+/**
+  * @brief  Starts one burst read of Watermark samples.
+  *         Called with the INT2 and DMA interrupts unable to preempt.
+  * @param  None
+  * @retval None
+  */
+static void L3GD20_FifoStart(void)
+{
+  uint16_t length = 1 + 6 * L3GD20_Watermark;
+  
+  L3GD20_DmaBusy = 1;
+  
+  DMA_ClearFlag(L3GD20_DMA_RX_STREAM, L3GD20_DMA_RX_FLAGS);
+  DMA_ClearFlag(L3GD20_DMA_TX_STREAM, L3GD20_DMA_TX_FLAGS);
+  DMA_SetCurrDataCounter(L3GD20_DMA_RX_STREAM, length);
+  DMA_SetCurrDataCounter(L3GD20_DMA_TX_STREAM, length);
+  
+  /* Drop a stale received byte so the RX stream stays aligned */
+  (void)SPI_I2S_ReceiveData(L3GD20_SPI);
+  
+  L3GD20_CS_LOW();
+  DMA_Cmd(L3GD20_DMA_RX_STREAM, ENABLE);
+  DMA_Cmd(L3GD20_DMA_TX_STREAM, ENABLE);
+  SPI_I2S_DMACmd(L3GD20_SPI, SPI_I2S_DMAReq_Rx | SPI_I2S_DMAReq_Tx, ENABLE);
+}
+
+/**
+  * @brief  Moves the samples of the finished burst into the ring.
+  * @param  None
+  * @retval None
+  */
+static void L3GD20_FifoPublish(void)
+{
+  const uint8_t *data = &L3GD20_RxBuffer[1];
+  uint32_t head = L3GD20_RingHead;
+  L3GD20_SampleTypeDef *sample;
+  uint8_t index;
+  
+  for(index = 0; index < L3GD20_Watermark; index++, data += 6)
+  {
+    if((head - L3GD20_RingTail) >= L3GD20_RING_SIZE)
+    {
+      L3GD20_Stats.Dropped++;
+      continue;
+    }
+    sample = &L3GD20_Ring[head % L3GD20_RING_SIZE];
+    sample->X = (int16_t)(data[0] | (data[1] << 8));
+    sample->Y = (int16_t)(data[2] | (data[3] << 8));
+    sample->Z = (int16_t)(data[4] | (data[5] << 8));
+    head++;
+    L3GD20_Stats.Samples++;
+  }
+  
+  /* Publish only once the samples are in memory */
+  __DMB();
+  L3GD20_RingHead = head;
+}
+
+/**
+  * @brief  Holds off the FIFO burst engine around a blocking transfer.
+  * @param  None
+  * @retval None
+  */
+static void L3GD20_FifoLock(void)
+{
+  if(L3GD20_Watermark != 0)
+  {
+    NVIC_DisableIRQ(L3GD20_SPI_INT2_EXTI_IRQn);
+    while(L3GD20_DmaBusy != 0)
+    {
+    }
+  }
+}
+
+/**
+  * @brief  Lets the FIFO burst engine run again, a watermark edge seen in
+  *         between is still pending on EXTI.
+  * @param  None
+  * @retval None
+  */
+static void L3GD20_FifoUnlock(void)
+{
+  if(L3GD20_Watermark != 0)
+  {
+    NVIC_EnableIRQ(L3GD20_SPI_INT2_EXTI_IRQn);
+  }
+}
 /**
   * @brief  Initializes the low level interface used to drive the L3GD20
   * @param  None
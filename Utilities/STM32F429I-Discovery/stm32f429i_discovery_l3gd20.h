@@ -87,6 +87,23 @@ typedef struct
   uint8_t Interrupt_ActiveEdge;               /*  Interrupt Active edge */
 }L3GD20_InterruptConfigTypeDef;  
 
+/* One angular rate sample as read from OUT_X_L..OUT_Z_H (raw, little endian) */
+typedef struct
+{
+  int16_t X;
+  int16_t Y;
+  int16_t Z;
+}L3GD20_SampleTypeDef;
+
+/* FIFO burst engine counters */
+typedef struct
+{
+  uint32_t Bursts;                            /* DMA burst reads completed */
+  uint32_t Samples;                           /* Samples published to the ring */
+  uint32_t Dropped;                           /* Samples lost, ring full */
+  uint32_t Errors;                            /* DMA transfer errors */
+}L3GD20_FifoStatsTypeDef;
+
 /**
   * @}
   */ 
@@ -161,9 +178,30 @@ typedef struct
 #define L3GD20_SPI_INT2_GPIO_PORT        GPIOA                       /* GPIOA */
 #define L3GD20_SPI_INT2_GPIO_CLK         RCC_AHB1Periph_GPIOA
 #define L3GD20_SPI_INT2_EXTI_LINE        EXTI_Line2
+#define L3GD20_SPI_INT2_EXTI_LINE_NUMBER 2                           /* EXTI_Line2, for #if checks */
 #define L3GD20_SPI_INT2_EXTI_PORT_SOURCE EXTI_PortSourceGPIOA
 #define L3GD20_SPI_INT2_EXTI_PIN_SOURCE  EXTI_PinSource2
 #define L3GD20_SPI_INT2_EXTI_IRQn        EXTI2_IRQn 
+#define L3GD20_SPI_INT2_IRQHandler       EXTI2_IRQHandler
+
+/**
+  * @brief  L3GD20 SPI DMA definitions (SPI5 on DMA2 channel 2)
+  */
+#define L3GD20_DMA_CLK                   RCC_AHB1Periph_DMA2
+#define L3GD20_DMA_CHANNEL               DMA_Channel_2
+#define L3GD20_DMA_RX_STREAM             DMA2_Stream3
+#define L3GD20_DMA_TX_STREAM             DMA2_Stream4
+#define L3GD20_DMA_RX_FLAGS              (DMA_FLAG_FEIF3 | DMA_FLAG_DMEIF3 | DMA_FLAG_TEIF3 | DMA_FLAG_HTIF3 | DMA_FLAG_TCIF3)
+#define L3GD20_DMA_TX_FLAGS              (DMA_FLAG_FEIF4 | DMA_FLAG_DMEIF4 | DMA_FLAG_TEIF4 | DMA_FLAG_HTIF4 | DMA_FLAG_TCIF4)
+#define L3GD20_DMA_RX_IRQn               DMA2_Stream3_IRQn
+#define L3GD20_DMA_RX_IRQHandler         DMA2_Stream3_IRQHandler
+#define L3GD20_DMA_PREPRIO               1
+#define L3GD20_DMA_SUBPRIO               0
+
+/* FIFO burst engine: samples held by the ring (power of two) */
+#define L3GD20_RING_SIZE                 128
+/* The L3GD20 FIFO holds 32 samples, the watermark can be 1..31 */
+#define L3GD20_FIFO_DEPTH                32
 
 /******************************************************************************/
 /*************************** START REGISTER MAPPING  **************************/
@@ -309,6 +347,18 @@ typedef struct
   * @}
   */
   
+/** @defgroup FIFO_Configuration
+  * @{
+  */
+#define L3GD20_FIFO_ENABLE                 ((uint8_t)0x40)  /* CTRL_REG5 FIFO_EN */
+#define L3GD20_FIFO_MODE_BYPASS            ((uint8_t)0x00)  /* FIFO_CTRL_REG FM[2:0] */
+#define L3GD20_FIFO_MODE_STREAM            ((uint8_t)0x40)
+#define L3GD20_FIFO_WTM_MASK               ((uint8_t)0x1F)
+#define L3GD20_INT2_WATERMARK              ((uint8_t)0x04)  /* CTRL_REG3 I2_WTM */
+/**
+  * @}
+  */
+
 /** @defgroup Boot_Mode_selection 
   * @{
   */
@@ -375,6 +425,13 @@ void L3GD20_FilterCmd(uint8_t HighPassFilterState);
 void L3GD20_Write(uint8_t* pBuffer, uint8_t WriteAddr, uint16_t NumByteToWrite);
 void L3GD20_Read(uint8_t* pBuffer, uint8_t ReadAddr, uint16_t NumByteToRead);
 
+/* FIFO burst read engine (SPI DMA, triggered by the INT2 watermark) */
+void L3GD20_FifoInit(uint8_t Watermark);
+void L3GD20_FifoDeInit(void);
+uint16_t L3GD20_FifoRead(L3GD20_SampleTypeDef *pSamples, uint16_t MaxSamples);
+uint16_t L3GD20_FifoPending(void);
+void L3GD20_FifoGetStats(L3GD20_FifoStatsTypeDef *pStats);
+
 /* USER Callbacks: This is function for which prototype only is declared in
    MEMS accelerometre driver and that should be implemented into user applicaiton. */  
 /* L3GD20_TIMEOUT_UserCallback() function is called whenever a timeout condition 
@@ -28,6 +28,7 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "stm32f429i_discovery_lcd.h"
+#include "stm32f429i_discovery_dma2d.h"
 #include "../Common/fonts.h"
 
 
@@ -51,6 +52,18 @@
 /** @defgroup STM32F429I_DISCOVERY_LCD_Private_TypesDefinitions
   * @{
   */ 
+typedef struct
+{
+  int32_t X1, Y1;         /* Top left pixel */
+  int32_t X2, Y2;         /* One past the bottom right pixel */
+} LCD_Rect;
+
+typedef struct
+{
+  int32_t YMin, YMax;     /* Rows crossed: YMin <= y < YMax */
+  int32_t X;              /* X on the current row, 16.16 fixed point */
+  int32_t DxDy;           /* X step per row, 16.16 fixed point */
+} LCD_Edge;
 /**
   * @}
   */ 
@@ -59,8 +72,16 @@
   * @{
   */
 
-#define POLY_Y(Z)          ((int32_t)((Points + Z)->X))
-#define POLY_X(Z)          ((int32_t)((Points + Z)->Y))   
+#define LCD_LAYERS         2
+/* Spans at least this wide are filled by DMA2D R2M, shorter ones by the CPU */
+#define LCD_SPAN_DMA2D_MIN 64
+/* Edge table size, longer polygons are drawn as an outline */
+#define LCD_POLY_MAX_EDGES 32
+
+/* The swap interrupt queues the dirty copies of both layers at once */
+#if (LCD_LAYERS * LCD_DIRTY_MAX) > GFX_QUEUE_SIZE
+#error "LCD_DIRTY_MAX too large for the DMA2D queue"
+#endif
 /**
   * @}
   */ 
@@ -83,6 +104,18 @@ static uint16_t CurrentBackColor   = 0xFFFF;
 /* Default LCD configuration with LCD Layer 1 */
 static uint32_t CurrentFrameBuffer = LCD_FRAME_BUFFER;
 static uint32_t CurrentLayer = LCD_BACKGROUND_LAYER;
+/* Font rasterized in the glyph cache, 0 when the cache is empty */
+static sFONT *GlyphCacheFont = 0;
+/* Layer buffers: LTDC scans Front, drawing goes to Back (0 = single buffered) */
+static uint32_t LayerFront[LCD_LAYERS] = {LCD_FRAME_BUFFER, LCD_FRAME_BUFFER + BUFFER_OFFSET};
+static uint32_t LayerBack[LCD_LAYERS] = {0, 0};
+/* Regions drawn in the back buffer since the last swap */
+static LCD_Rect DirtyRect[LCD_LAYERS][LCD_DIRTY_MAX];
+static uint8_t DirtyCount[LCD_LAYERS] = {0, 0};
+/* Bytes copied by DMA2D in the last swap */
+static uint32_t SwapBytes = 0;
+/* Swap requested by LCD_SwapBuffers, done by the LTDC line interrupt */
+static __IO uint8_t SwapPending[LCD_LAYERS] = {0, 0};
 /**
   * @}
   */ 
@@ -97,6 +130,11 @@ static void delay(__IO uint32_t nCount);
 static void PutPixel(int16_t x, int16_t y);
 static void LCD_PolyLineRelativeClosed(pPoint Points, uint16_t PointCount, uint16_t Closed);
 static void LCD_AF_GPIOConfig(void);
+static void LCD_GlyphCacheUpdate(void);
+static void LCD_DrawGlyph(uint16_t Line, uint16_t Column, uint8_t Ascii);
+static uint32_t LCD_RGB565ToRGB888(uint16_t Color);
+static void LCD_MarkDirty(int32_t Xpos, int32_t Ypos, int32_t Width, int32_t Height);
+static void LCD_FillSpan(int32_t X1, int32_t X2, int32_t Ypos);
 
 /**
   * @}
@@ -258,8 +296,8 @@ void LCD_Init(void)
   /* Enable the LTDC Clock */
   RCC_APB2PeriphClockCmd(RCC_APB2Periph_LTDC, ENABLE);
   
-  /* Enable the DMA2D Clock */
-  RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA2D, ENABLE); 
+  /* Enable the DMA2D Clock and the transfer queue */
+  GFX_Init();
   
   /* Configure the LCD Control pins */
   LCD_AF_GPIOConfig();  
@@ -427,16 +465,178 @@ void LCD_SetLayer(__IO uint32_t Layerx)
 {
   if (Layerx == LCD_BACKGROUND_LAYER)
   {
-    CurrentFrameBuffer = LCD_FRAME_BUFFER; 
     CurrentLayer = LCD_BACKGROUND_LAYER;
   }
   else
   {
-    CurrentFrameBuffer = LCD_FRAME_BUFFER + BUFFER_OFFSET;
     CurrentLayer = LCD_FOREGROUND_LAYER;
   }
+  
+  /* Double buffered layers are drawn in their back buffer */
+  CurrentFrameBuffer = (LayerBack[CurrentLayer] != 0) ? LayerBack[CurrentLayer] : LayerFront[CurrentLayer];
 }  
 
+/**
+  * @brief  Enables or disables double buffering of the current layer.
+  *         When enabled, drawing goes to a back buffer and is shown by
+  *         LCD_SwapBuffers, so LTDC never scans a half drawn frame.
+  *         A swap still pending on the layer is finished first.
+  * @param  NewState: new state of double buffering (ENABLE or DISABLE).
+  * @retval None
+  */
+void LCD_DoubleBufferCmd(FunctionalState NewState)
+{
+  NVIC_InitTypeDef NVIC_InitStructure;
+  uint32_t back = LCD_BACK_BUFFER + CurrentLayer * BUFFER_OFFSET;
+  
+  while (SwapPending[CurrentLayer] != 0)
+  {
+  }
+  
+  GFX_Wait();
+  
+  if (NewState != DISABLE)
+  {
+    if (LayerBack[CurrentLayer] == 0)
+    {
+      /* Swaps are done by the line interrupt, enabled by each swap */
+      LTDC_LIPConfig(LCD_SWAP_LINE);
+      NVIC_InitStructure.NVIC_IRQChannel = LCD_LTDC_IRQn;
+      NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0x0F;
+      NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0x0F;
+      NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+      NVIC_Init(&NVIC_InitStructure);
+      
+      /* Back buffer starts as a copy of what is on the screen */
+      if (LayerFront[CurrentLayer] == back)
+      {
+        back = LCD_FRAME_BUFFER + CurrentLayer * BUFFER_OFFSET;
+      }
+      GFX_Copy(LayerFront[CurrentLayer], LCD_PIXEL_WIDTH, back, LCD_PIXEL_WIDTH, LCD_PIXEL_WIDTH, LCD_PIXEL_HEIGHT, CM_RGB565);
+      LayerBack[CurrentLayer] = back;
+      DirtyCount[CurrentLayer] = 0;
+    }
+  }
+  else
+  {
+    /* Keep drawing on the buffer that is shown */
+    LayerBack[CurrentLayer] = 0;
+  }
+  
+  LCD_SetLayer(CurrentLayer);
+}
+
+/**
+  * @brief  Requests the back buffer of the current layer to be shown at the
+  *         next vertical blanking and returns at once. The LTDC line
+  *         interrupt latches the new address once DMA2D has finished the
+  *         frame, then brings the new back buffer up to date by copying
+  *         only the dirty regions with DMA2D. Nothing may be drawn on the
+  *         layer while LCD_IsSwapPending returns 1.
+  * @param  None
+  * @retval None
+  */
+void LCD_SwapBuffers(void)
+{
+  if (LayerBack[CurrentLayer] == 0)
+  {
+    return;
+  }
+  
+  SwapPending[CurrentLayer] = 1;
+  LTDC_ITConfig(LTDC_IT_LI, ENABLE);
+}
+
+/**
+  * @brief  Tells if the swap requested on the current layer is not done yet.
+  * @param  None
+  * @retval 1 while the back buffer is not ready to draw the next frame, else 0
+  */
+uint8_t LCD_IsSwapPending(void)
+{
+  return SwapPending[CurrentLayer];
+}
+
+/**
+  * @brief  LTDC line interrupt, at the start of the vertical front porch:
+  *         shows the back buffer of the layers with a pending swap and
+  *         queues the copy of their dirty regions to the new back buffer.
+  *         A frame DMA2D is still drawing is shown at a later blanking.
+  * @param  None
+  * @retval None
+  */
+void LCD_LTDC_IRQHandler(void)
+{
+  uint32_t layer = 0, front = 0, offset = 0;
+  uint8_t index = 0, swapped = 0;
+  LCD_Rect *rect;
+  
+  LTDC_ClearITPendingBit(LTDC_IT_LI);
+  
+  if (GFX_IsBusy() != 0)
+  {
+    return;
+  }
+  
+  for (layer = 0; layer < LCD_LAYERS; layer++)
+  {
+    if (SwapPending[layer] != 0)
+    {
+      LTDC_LayerAddress((layer == LCD_BACKGROUND_LAYER) ? LTDC_Layer1 : LTDC_Layer2, LayerBack[layer]);
+      swapped = 1;
+    }
+  }
+  
+  /* Reloaded during blanking: no tearing */
+  if (swapped != 0)
+  {
+    LTDC_ReloadConfig(LTDC_IMReload);
+  }
+  
+  for (layer = 0; layer < LCD_LAYERS; layer++)
+  {
+    if (SwapPending[layer] == 0)
+    {
+      continue;
+    }
+    
+    front = LayerBack[layer];
+    LayerBack[layer] = LayerFront[layer];
+    LayerFront[layer] = front;
+    
+    if (layer == CurrentLayer)
+    {
+      CurrentFrameBuffer = LayerBack[layer];
+    }
+    
+    /* Old front misses what was drawn in this frame, copy the dirty regions
+       only (DMA2D is idle, they fit in its queue) */
+    SwapBytes = 0;
+    for (index = 0; index < DirtyCount[layer]; index++)
+    {
+      rect = &DirtyRect[layer][index];
+      offset = 2*(rect->Y1*LCD_PIXEL_WIDTH + rect->X1);
+      GFX_Copy(front + offset, LCD_PIXEL_WIDTH, LayerBack[layer] + offset, LCD_PIXEL_WIDTH,
+               rect->X2 - rect->X1, rect->Y2 - rect->Y1, CM_RGB565);
+      SwapBytes += 2*(rect->X2 - rect->X1)*(rect->Y2 - rect->Y1);
+    }
+    DirtyCount[layer] = 0;
+    SwapPending[layer] = 0;
+  }
+  
+  LTDC_ITConfig(LTDC_IT_LI, DISABLE);
+}
+
+/**
+  * @brief  Gets the SDRAM bytes copied to sync the buffers by the last swap.
+  * @param  None
+  * @retval Bytes copied (a full frame is 2*240*320)
+  */
+uint32_t LCD_GetSwapBytes(void)
+{
+  return SwapBytes;
+}
+
 /**
   * @brief  Sets the LCD Text and Background colors.
   * @param  TextColor: specifies the Text Color.
@@ -533,15 +733,30 @@ sFONT *LCD_GetFont(void)
   */
 void LCD_ClearLine(uint16_t Line)
 {
-  uint16_t refcolumn = 0;
-  /* Send the string character by character on lCD */
-  while ((refcolumn < LCD_PIXEL_WIDTH) && (((refcolumn + LCD_Currentfonts->Width)& 0xFFFF) >= LCD_Currentfonts->Width))
+  /* One background fill for the whole line instead of a space per column */
+  GFX_Fill(LCD_SetCursor(0, Line), LCD_PIXEL_WIDTH, LCD_PIXEL_WIDTH, LCD_Currentfonts->Height, DMA2D_RGB565, CurrentBackColor);
+  LCD_MarkDirty(0, Line, LCD_PIXEL_WIDTH, LCD_Currentfonts->Height);
+}
+
+/**
+  * @brief  Scrolls a full-width band of the current layer up.
+  * @param  Ypos: first row of the band.
+  * @param  Height: height of the band in rows.
+  * @param  Step: number of rows to scroll by; the bottom Step rows of the
+  *         band keep their old content and are left to the caller.
+  * @retval None
+  */
+void LCD_ScrollUp(uint16_t Ypos, uint16_t Height, uint16_t Step)
+{
+  if (Step >= Height)
   {
-    /* Display one character on LCD */
-    LCD_DisplayChar(Line, refcolumn, ' ');
-    /* Decrement the column position by 16 */
-    refcolumn += LCD_Currentfonts->Width;
+    return;
   }
+  /* One DMA2D M2M blit; the destination is above the source and DMA2D walks
+     the lines in order, so every source line is read before it is overwritten */
+  GFX_Copy(LCD_SetCursor(0, Ypos + Step), LCD_PIXEL_WIDTH, LCD_SetCursor(0, Ypos), LCD_PIXEL_WIDTH,
+           LCD_PIXEL_WIDTH, Height - Step, CM_RGB565);
+  LCD_MarkDirty(0, Ypos, LCD_PIXEL_WIDTH, Height - Step);
 }
 
 /**
@@ -551,13 +766,9 @@ void LCD_ClearLine(uint16_t Line)
   */
 void LCD_Clear(uint16_t Color)
 {
-  uint32_t index = 0;
-  
-  /* erase memory */
-  for (index = 0x00; index < BUFFER_OFFSET; index++)
-  {
-    *(__IO uint16_t*)(CurrentFrameBuffer + (2*index)) = Color;
-  } 
+  /* erase memory, DMA2D fills the frame while the CPU goes on */
+  GFX_Fill(CurrentFrameBuffer, LCD_PIXEL_WIDTH, LCD_PIXEL_WIDTH, LCD_PIXEL_HEIGHT, DMA2D_RGB565, Color);
+  LCD_MarkDirty(0, 0, LCD_PIXEL_WIDTH, LCD_PIXEL_HEIGHT);
 }
 
 /**
@@ -633,9 +844,13 @@ void LCD_DrawChar(uint16_t Xpos, uint16_t Ypos, const uint16_t *c)
 {
   uint32_t index = 0, counter = 0, xpos =0;
   uint32_t  Xaddress = 0;
+
+  /* CPU writes the frame buffer, queued DMA2D transfers must be done first */
+  GFX_Wait();
   
   xpos = Xpos*LCD_PIXEL_WIDTH*2;
   Xaddress += Ypos;
+  LCD_MarkDirty(Ypos, Xpos, LCD_Currentfonts->Width, LCD_Currentfonts->Height);
   
   for(index = 0; index < LCD_Currentfonts->Height; index++)
   {
@@ -671,9 +886,12 @@ void LCD_DrawChar(uint16_t Xpos, uint16_t Ypos, const uint16_t *c)
   */
 void LCD_DisplayChar(uint16_t Line, uint16_t Column, uint8_t Ascii)
 {
-  Ascii -= 32;
+  LCD_GlyphCacheUpdate();
 
-  LCD_DrawChar(Line, Column, &LCD_Currentfonts->table[Ascii * LCD_Currentfonts->Height]);
+  /* Background then glyph, both queued on DMA2D */
+  GFX_Fill(LCD_SetCursor(Column, Line), LCD_PIXEL_WIDTH, LCD_Currentfonts->Width, LCD_Currentfonts->Height, DMA2D_RGB565, CurrentBackColor);
+  LCD_DrawGlyph(Line, Column, Ascii);
+  LCD_MarkDirty(Column, Line, LCD_Currentfonts->Width, LCD_Currentfonts->Height);
 }
 
 /**
@@ -686,14 +904,24 @@ void LCD_DisplayChar(uint16_t Line, uint16_t Column, uint8_t Ascii)
   */
 void LCD_DisplayStringLine(uint16_t Line, uint8_t *ptr)
 {  
-  uint16_t refcolumn = 0;
-  /* Send the string character by character on lCD */
-  while ((refcolumn < LCD_PIXEL_WIDTH) && ((*ptr != 0) & (((refcolumn + LCD_Currentfonts->Width) & 0xFFFF) >= LCD_Currentfonts->Width)))
-  {
-    /* Display one character on LCD */
-    LCD_DisplayChar(Line, refcolumn, *ptr);
-    /* Decrement the column position by width */
-    refcolumn += LCD_Currentfonts->Width;
+  uint16_t refcolumn = 0, length = 0;
+  
+  LCD_GlyphCacheUpdate();
+  
+  /* Width covered by the characters that fit on the line */
+  while ((length + LCD_Currentfonts->Width <= LCD_PIXEL_WIDTH) && (ptr[length / LCD_Currentfonts->Width] != 0))
+  {
+    length += LCD_Currentfonts->Width;
+  }
+  
+  /* One background fill for the whole string */
+  GFX_Fill(LCD_SetCursor(0, Line), LCD_PIXEL_WIDTH, length, LCD_Currentfonts->Height, DMA2D_RGB565, CurrentBackColor);
+  LCD_MarkDirty(0, Line, length, LCD_Currentfonts->Height);
+  
+  /* Then one DMA2D blend per character */
+  for (refcolumn = 0; refcolumn < length; refcolumn += LCD_Currentfonts->Width)
+  {
+    LCD_DrawGlyph(Line, refcolumn, *ptr);
     /* Point on the next character */
     ptr++;
   }
@@ -753,48 +981,20 @@ void LCD_WindowModeDisable(void)
   */
 void LCD_DrawLine(uint16_t Xpos, uint16_t Ypos, uint16_t Length, uint8_t Direction)
 {
-  DMA2D_InitTypeDef      DMA2D_InitStruct;
-  
   uint32_t  Xaddress = 0;
-  uint16_t Red_Value = 0, Green_Value = 0, Blue_Value = 0;
   
   Xaddress = CurrentFrameBuffer + 2*(LCD_PIXEL_WIDTH*Ypos + Xpos);
- 
-  Red_Value = (0xF800 & CurrentTextColor) >> 11;
-  Blue_Value = 0x001F & CurrentTextColor;
-  Green_Value = (0x07E0 & CurrentTextColor) >> 5;
-
-  /* Configure DMA2D */    
-  DMA2D_DeInit();  
-  DMA2D_InitStruct.DMA2D_Mode = DMA2D_R2M;       
-  DMA2D_InitStruct.DMA2D_CMode = DMA2D_RGB565;      
-  DMA2D_InitStruct.DMA2D_OutputGreen = Green_Value;      
-  DMA2D_InitStruct.DMA2D_OutputBlue = Blue_Value;     
-  DMA2D_InitStruct.DMA2D_OutputRed = Red_Value;                
-  DMA2D_InitStruct.DMA2D_OutputAlpha = 0x0F;                  
-  DMA2D_InitStruct.DMA2D_OutputMemoryAdd = Xaddress;                  
   
   if(Direction == LCD_DIR_HORIZONTAL)
-  {                                                      
-    DMA2D_InitStruct.DMA2D_OutputOffset = 0;                
-    DMA2D_InitStruct.DMA2D_NumberOfLine = 1;            
-    DMA2D_InitStruct.DMA2D_PixelPerLine = Length; 
+  {
+    GFX_Fill(Xaddress, LCD_PIXEL_WIDTH, Length, 1, DMA2D_RGB565, CurrentTextColor);
+    LCD_MarkDirty(Xpos, Ypos, Length, 1);
   }
   else
-  {                                                            
-    DMA2D_InitStruct.DMA2D_OutputOffset = LCD_PIXEL_WIDTH - 1;                
-    DMA2D_InitStruct.DMA2D_NumberOfLine = Length;            
-    DMA2D_InitStruct.DMA2D_PixelPerLine = 1;  
-  }
-  
-  DMA2D_Init(&DMA2D_InitStruct);  
-  /* Start Transfer */ 
-  DMA2D_StartTransfer();  
-  /* Wait for CTC Flag activation */
-  while(DMA2D_GetFlagStatus(DMA2D_FLAG_TC) == RESET)
   {
+    GFX_Fill(Xaddress, LCD_PIXEL_WIDTH, 1, Length, DMA2D_RGB565, CurrentTextColor);
+    LCD_MarkDirty(Xpos, Ypos, 1, Length);
   }
-  
 }
 
 /**
@@ -826,6 +1026,10 @@ void LCD_DrawRect(uint16_t Xpos, uint16_t Ypos, uint16_t Height, uint16_t Width)
 void LCD_DrawCircle(uint16_t Xpos, uint16_t Ypos, uint16_t Radius)
 {
     int x = -Radius, y = 0, err = 2-2*Radius, e2;
+
+    /* CPU writes the frame buffer, queued DMA2D transfers must be done first */
+    GFX_Wait();
+    LCD_MarkDirty(Xpos - Radius, Ypos - Radius, 2*Radius + 1, 2*Radius + 1);
     do {
         *(__IO uint16_t*) (CurrentFrameBuffer + (2*((Xpos-x) + LCD_PIXEL_WIDTH*(Ypos+y)))) = CurrentTextColor; 
         *(__IO uint16_t*) (CurrentFrameBuffer + (2*((Xpos+x) + LCD_PIXEL_WIDTH*(Ypos+y)))) = CurrentTextColor;
@@ -852,50 +1056,32 @@ void LCD_DrawCircle(uint16_t Xpos, uint16_t Ypos, uint16_t Radius)
   */
 void LCD_DrawFullEllipse(int Xpos, int Ypos, int Radius, int Radius2)
 {
-  int x = -Radius, y = 0, err = 2-2*Radius, e2;
-  float K = 0, rad1 = 0, rad2 = 0;
+  int64_t a2 = (int64_t)Radius * Radius, b2 = (int64_t)Radius2 * Radius2;
+  int64_t limit = a2 * b2;
+  int32_t x = Radius, y = 0;
   
-  rad1 = Radius;
-  rad2 = Radius2;
+  /* Same half pixel margin as the circle: x^2 + y^2 <= R^2 + R */
+  if ((Radius > 0) && (Radius2 > 0))
+  {
+    limit += limit / ((Radius > Radius2) ? Radius : Radius2);
+  }
   
-  if (Radius > Radius2)
-  { 
-    do 
+  /* CPU writes the short spans, queued DMA2D transfers must be done first */
+  GFX_Wait();
+  LCD_MarkDirty(Xpos - Radius, Ypos - Radius2, 2*Radius + 1, 2*Radius2 + 1);
+  
+  /* One span per row, the half width only shrinks going away from the center */
+  for (y = 0; y <= Radius2; y++)
+  {
+    while ((x > 0) && ((int64_t)x * x * b2 + (int64_t)y * y * a2 > limit))
     {
-      K = (float)(rad1/rad2);
-      LCD_DrawLine((Xpos+x), (Ypos-(uint16_t)(y/K)), (2*(uint16_t)(y/K) + 1), LCD_DIR_VERTICAL);
-      LCD_DrawLine((Xpos-x), (Ypos-(uint16_t)(y/K)), (2*(uint16_t)(y/K) + 1), LCD_DIR_VERTICAL);
-      
-      e2 = err;
-      if (e2 <= y) 
-      {
-        err += ++y*2+1;
-        if (-x == y && e2 <= x) e2 = 0;
-      }
-      if (e2 > x) err += ++x*2+1;
-      
+      x--;
     }
-    while (x <= 0);
-  }
-  else
-  {
-    y = -Radius2; 
-    x = 0;
-    do 
-    { 
-      K = (float)(rad2/rad1);       
-      LCD_DrawLine((Xpos-(uint16_t)(x/K)), (Ypos+y), (2*(uint16_t)(x/K) + 1), LCD_DIR_HORIZONTAL);
-      LCD_DrawLine((Xpos-(uint16_t)(x/K)), (Ypos-y), (2*(uint16_t)(x/K) + 1), LCD_DIR_HORIZONTAL);
-      
-      e2 = err;
-      if (e2 <= x) 
-      {
-        err += ++x*2+1;
-        if (-y == x && e2 <= y) e2 = 0;
-      }
-      if (e2 > y) err += ++y*2+1;
+    LCD_FillSpan(Xpos - x, Xpos + x, Ypos - y);
+    if (y != 0)
+    {
+      LCD_FillSpan(Xpos - x, Xpos + x, Ypos + y);
     }
-    while (y <= 0);
   }
 }
 
@@ -912,6 +1098,10 @@ void LCD_DrawEllipse(int Xpos, int Ypos, int Radius, int Radius2)
   int x = -Radius, y = 0, err = 2-2*Radius, e2;
   float K = 0, rad1 = 0, rad2 = 0;
    
+  /* CPU writes the frame buffer, queued DMA2D transfers must be done first */
+  GFX_Wait();
+  LCD_MarkDirty(Xpos - Radius, Ypos - Radius2, 2*Radius + 1, 2*Radius2 + 1);
+  
   rad1 = Radius;
   rad2 = Radius2;
   
@@ -963,6 +1153,10 @@ void LCD_DrawEllipse(int Xpos, int Ypos, int Radius, int Radius2)
 void LCD_DrawMonoPict(const uint32_t *Pict)
 {
   uint32_t index = 0, counter = 0;
+
+  /* CPU writes the frame buffer, queued DMA2D transfers must be done first */
+  GFX_Wait();
+  LCD_MarkDirty(0, 0, LCD_PIXEL_WIDTH, LCD_PIXEL_HEIGHT);
   
    
   for(index = 0; index < 2400; index++)
@@ -994,6 +1188,10 @@ void LCD_WriteBMP(uint32_t BmpAddress)
  
   Address = CurrentFrameBuffer;
 
+  /* CPU writes the frame buffer, queued DMA2D transfers must be done first */
+  GFX_Wait();
+  LCD_MarkDirty(0, 0, LCD_PIXEL_WIDTH, LCD_PIXEL_HEIGHT);
+
   /* Read bitmap size */
   size = *(__IO uint16_t *) (BmpAddress + 2);
   size |= (*(__IO uint16_t *) (BmpAddress + 4)) << 16;
@@ -1100,40 +1298,13 @@ void LCD_WriteBMP(uint32_t BmpAddress)
   */
 void LCD_DrawFullRect(uint16_t Xpos, uint16_t Ypos, uint16_t Width, uint16_t Height)
 {
-  DMA2D_InitTypeDef      DMA2D_InitStruct;
-  
   uint32_t  Xaddress = 0; 
-  uint16_t Red_Value = 0, Green_Value = 0, Blue_Value = 0;
- 
-  Red_Value = (0xF800 & CurrentTextColor) >> 11;
-  Blue_Value = 0x001F & CurrentTextColor;
-  Green_Value = (0x07E0 & CurrentTextColor) >> 5;
   
   Xaddress = CurrentFrameBuffer + 2*(LCD_PIXEL_WIDTH*Ypos + Xpos);
   
-  /* configure DMA2D */
-  DMA2D_DeInit();
-  DMA2D_InitStruct.DMA2D_Mode = DMA2D_R2M;       
-  DMA2D_InitStruct.DMA2D_CMode = DMA2D_RGB565;      
-  DMA2D_InitStruct.DMA2D_OutputGreen = Green_Value;      
-  DMA2D_InitStruct.DMA2D_OutputBlue = Blue_Value;     
-  DMA2D_InitStruct.DMA2D_OutputRed = Red_Value;                
-  DMA2D_InitStruct.DMA2D_OutputAlpha = 0x0F;                  
-  DMA2D_InitStruct.DMA2D_OutputMemoryAdd = Xaddress;                
-  DMA2D_InitStruct.DMA2D_OutputOffset = (LCD_PIXEL_WIDTH - Width);                
-  DMA2D_InitStruct.DMA2D_NumberOfLine = Height;            
-  DMA2D_InitStruct.DMA2D_PixelPerLine = Width;
-  DMA2D_Init(&DMA2D_InitStruct); 
-  
-  /* Start Transfer */ 
-  DMA2D_StartTransfer();
-  
-  /* Wait for CTC Flag activation */
-  while(DMA2D_GetFlagStatus(DMA2D_FLAG_TC) == RESET)
-  {
-  } 
-
-  LCD_SetTextColor(CurrentTextColor);
+  /* Queue the fill, no wait for DMA2D transfer complete */
+  GFX_Fill(Xaddress, LCD_PIXEL_WIDTH, Width, Height, DMA2D_RGB565, CurrentTextColor);
+  LCD_MarkDirty(Xpos, Ypos, Width, Height);
 }
 
 /**
@@ -1145,41 +1316,29 @@ void LCD_DrawFullRect(uint16_t Xpos, uint16_t Ypos, uint16_t Width, uint16_t Hei
   */
 void LCD_DrawFullCircle(uint16_t Xpos, uint16_t Ypos, uint16_t Radius)
 {
-  int32_t  D;    /* Decision Variable */ 
-  uint32_t  CurX;/* Current X Value */
-  uint32_t  CurY;/* Current Y Value */ 
-  
-  D = 3 - (Radius << 1);
+  int32_t x = Radius, y = 0;
+  int32_t limit = (int32_t)Radius * Radius + Radius;
   
-  CurX = 0;
-  CurY = Radius;
+  /* CPU writes the short spans, queued DMA2D transfers must be done first */
+  GFX_Wait();
+  LCD_MarkDirty(Xpos - Radius, Ypos - Radius, 2*Radius + 1, 2*Radius + 1);
   
-  while (CurX <= CurY)
+  /* One span per row, the half width only shrinks going away from the center */
+  for (y = 0; y <= Radius; y++)
   {
-    if(CurY > 0) 
+    while (x*x + y*y > limit)
     {
-      LCD_DrawLine(Xpos - CurX, Ypos - CurY, 2*CurY, LCD_DIR_VERTICAL);
-      LCD_DrawLine(Xpos + CurX, Ypos - CurY, 2*CurY, LCD_DIR_VERTICAL);
+      x--;
     }
-    
-    if(CurX > 0) 
+    LCD_FillSpan(Xpos - x, Xpos + x, Ypos - y);
+    if (y != 0)
     {
-      LCD_DrawLine(Xpos - CurY, Ypos - CurX, 2*CurX, LCD_DIR_VERTICAL);
-      LCD_DrawLine(Xpos + CurY, Ypos - CurX, 2*CurX, LCD_DIR_VERTICAL);
-    }
-    if (D < 0)
-    { 
-      D += (CurX << 2) + 6;
+      LCD_FillSpan(Xpos - x, Xpos + x, Ypos + y);
     }
-    else
-    {
-      D += ((CurX - CurY) << 2) + 10;
-      CurY--;
-    }
-    CurX++;
   }
   
-  LCD_DrawCircle(Xpos, Ypos, Radius);  
+  /* LCD_DrawCircle outline as before the spans, the edge matches a drawn circle */
+  LCD_DrawCircle(Xpos, Ypos, Radius);
 }
 
 /**
@@ -1290,73 +1449,16 @@ void LCD_Triangle(pPoint Points, uint16_t PointCount)
   */
 void LCD_FillTriangle(uint16_t x1, uint16_t x2, uint16_t x3, uint16_t y1, uint16_t y2, uint16_t y3)
 { 
+  Point corners[3];
   
-  int16_t deltax = 0, deltay = 0, x = 0, y = 0, xinc1 = 0, xinc2 = 0, 
-  yinc1 = 0, yinc2 = 0, den = 0, num = 0, numadd = 0, numpixels = 0, 
-  curpixel = 0;
-  
-  deltax = ABS(x2 - x1);        /* The difference between the x's */
-  deltay = ABS(y2 - y1);        /* The difference between the y's */
-  x = x1;                       /* Start x off at the first pixel */
-  y = y1;                       /* Start y off at the first pixel */
-  
-  if (x2 >= x1)                 /* The x-values are increasing */
-  {
-    xinc1 = 1;
-    xinc2 = 1;
-  }
-  else                          /* The x-values are decreasing */
-  {
-    xinc1 = -1;
-    xinc2 = -1;
-  }
-  
-  if (y2 >= y1)                 /* The y-values are increasing */
-  {
-    yinc1 = 1;
-    yinc2 = 1;
-  }
-  else                          /* The y-values are decreasing */
-  {
-    yinc1 = -1;
-    yinc2 = -1;
-  }
-  
-  if (deltax >= deltay)         /* There is at least one x-value for every y-value */
-  {
-    xinc1 = 0;                  /* Don't change the x when numerator >= denominator */
-    yinc2 = 0;                  /* Don't change the y for every iteration */
-    den = deltax;
-    num = deltax / 2;
-    numadd = deltay;
-    numpixels = deltax;         /* There are more x-values than y-values */
-  }
-  else                          /* There is at least one y-value for every x-value */
-  {
-    xinc2 = 0;                  /* Don't change the x for every iteration */
-    yinc1 = 0;                  /* Don't change the y when numerator >= denominator */
-    den = deltay;
-    num = deltay / 2;
-    numadd = deltax;
-    numpixels = deltay;         /* There are more y-values than x-values */
-  }
-  
-  for (curpixel = 0; curpixel <= numpixels; curpixel++)
-  {
-    LCD_DrawUniLine(x, y, x3, y3);
-    
-    num += numadd;              /* Increase the numerator by the top of the fraction */
-    if (num >= den)             /* Check if numerator >= denominator */
-    {
-      num -= den;               /* Calculate the new numerator value */
-      x += xinc1;               /* Change the x as appropriate */
-      y += yinc1;               /* Change the y as appropriate */
-    }
-    x += xinc2;                 /* Change the x as appropriate */
-    y += yinc2;                 /* Change the y as appropriate */
-  }  
-  
+  corners[0].X = x1;
+  corners[0].Y = y1;
+  corners[1].X = x2;
+  corners[1].Y = y2;
+  corners[2].X = x3;
+  corners[2].Y = y3;
   
+  LCD_FillPolyLine(corners, 3);
 }
 /**
   * @brief  Displays an poly-line (between many points).
@@ -1450,69 +1552,109 @@ void LCD_ClosedPolyLineRelative(pPoint Points, uint16_t PointCount)
 
 /**
   * @brief  Displays a  full poly-line (between many points).
+  * @note   Above LCD_POLY_MAX_EDGES points only the closed outline is drawn.
   * @param  Points: pointer to the points array.
   * @param  PointCount: Number of points.
   * @retval None
   */
 void LCD_FillPolyLine(pPoint Points, uint16_t PointCount)
 {
- 
-  int16_t X = 0, Y = 0, X2 = 0, Y2 = 0, X_center = 0, Y_center = 0, X_first = 0, Y_first = 0, pixelX = 0, pixelY = 0, counter = 0;
-  uint16_t  IMAGE_LEFT = 0, IMAGE_RIGHT = 0, IMAGE_TOP = 0, IMAGE_BOTTOM = 0;  
-
-  IMAGE_LEFT = IMAGE_RIGHT = Points->X;
-  IMAGE_TOP= IMAGE_BOTTOM = Points->Y;
-
-  for(counter = 1; counter < PointCount; counter++)
+  LCD_Edge edges[LCD_POLY_MAX_EDGES];
+  LCD_Edge *active[LCD_POLY_MAX_EDGES];
+  LCD_Edge edge;
+  int32_t cross[LCD_POLY_MAX_EDGES];
+  int32_t x = 0, y = 0, xmin, xmax, ymin, ymax;
+  uint16_t count = 0, next = 0, nactive = 0, ncross = 0, i = 0, j = 0;
+  pPoint p0, p1;
+  
+  if(PointCount < 3)
+  {
+    return;
+  }
+  if(PointCount > LCD_POLY_MAX_EDGES)
+  {
+    LCD_ClosedPolyLine(Points, PointCount);
+    return;
+  }
+  
+  xmin = xmax = Points->X;
+  ymin = ymax = Points->Y;
+  
+  /* Edge table, sorted by top row; horizontal edges add no crossing */
+  for(i = 0; i < PointCount; i++)
   {
-    pixelX = POLY_X(counter);
-    if(pixelX < IMAGE_LEFT)
+    p0 = &Points[i];
+    p1 = &Points[(i + 1) % PointCount];
+    
+    if(p0->X < xmin) xmin = p0->X;
+    if(p0->X > xmax) xmax = p0->X;
+    if(p0->Y < ymin) ymin = p0->Y;
+    if(p0->Y > ymax) ymax = p0->Y;
+    
+    if(p0->Y == p1->Y)
     {
-      IMAGE_LEFT = pixelX;
+      continue;
     }
-    if(pixelX > IMAGE_RIGHT)
+    if(p0->Y > p1->Y)
     {
-      IMAGE_RIGHT = pixelX;
+      p0 = p1;
+      p1 = &Points[i];
     }
+    edge.YMin = p0->Y;
+    edge.YMax = p1->Y;
+    edge.DxDy = ((int32_t)(p1->X - p0->X) * 65536) / (p1->Y - p0->Y);
+    edge.X = ((int32_t)p0->X * 65536) + 0x8000;
     
-    pixelY = POLY_Y(counter);
-    if(pixelY < IMAGE_TOP)
-    { 
-      IMAGE_TOP = pixelY;
-    }
-    if(pixelY > IMAGE_BOTTOM)
+    for(j = count++; (j > 0) && (edges[j - 1].YMin > edge.YMin); j--)
     {
-      IMAGE_BOTTOM = pixelY;
+      edges[j] = edges[j - 1];
     }
-  }  
+    edges[j] = edge;
+  }
   
-  if(PointCount < 2)
+  if(count == 0)
   {
     return;
   }
   
-  X_center = (IMAGE_LEFT + IMAGE_RIGHT)/2;
-  Y_center = (IMAGE_BOTTOM + IMAGE_TOP)/2;
- 
-  X_first = Points->X;
-  Y_first = Points->Y;
+  /* CPU writes the short spans, queued DMA2D transfers must be done first */
+  GFX_Wait();
+  LCD_MarkDirty(xmin, ymin, xmax - xmin + 1, ymax - ymin + 1);
   
-  while(--PointCount)
+  for(y = edges[0].YMin; (next < count) || (nactive > 0); y++)
   {
-    X = Points->X;
-    Y = Points->Y;
-    Points++;
-    X2 = Points->X;
-    Y2 = Points->Y;    
-  
-    LCD_FillTriangle(X, X2, X_center, Y, Y2, Y_center);
-    LCD_FillTriangle(X, X_center, X2, Y, Y_center, Y2);
-    LCD_FillTriangle(X_center, X2, X, Y_center, Y2, Y);   
+    /* Edges starting on this row join the active list */
+    while((next < count) && (edges[next].YMin == y))
+    {
+      active[nactive++] = &edges[next++];
+    }
+    
+    /* Finished edges leave, the others give their sorted crossing */
+    ncross = 0;
+    for(i = 0; i < nactive; )
+    {
+      if(active[i]->YMax <= y)
+      {
+        active[i] = active[--nactive];
+        continue;
+      }
+      x = active[i]->X >> 16;
+      active[i]->X += active[i]->DxDy;
+      
+      for(j = ncross++; (j > 0) && (cross[j - 1] > x); j--)
+      {
+        cross[j] = cross[j - 1];
+      }
+      cross[j] = x;
+      i++;
+    }
+    
+    /* Even-odd rule: inside between each pair of crossings */
+    for(i = 0; i + 1 < ncross; i += 2)
+    {
+      LCD_FillSpan(cross[i], cross[i + 1], y);
+    }
   }
-  
-  LCD_FillTriangle(X_first, X2, X_center, Y_first, Y2, Y_center);
-  LCD_FillTriangle(X_first, X_center, X2, Y_first, Y_center, Y2);
-  LCD_FillTriangle(X_center, X2, X_first, Y_center, Y2, Y_first); 
 }
 
 /**
@@ -1901,6 +2043,217 @@ static void LCD_AF_GPIOConfig(void)
  
 }
 
+/**
+  * @brief  Rasterizes the current font in the glyph cache (one byte of alpha
+  *         per pixel) if it holds another font.
+  * @param  None
+  * @retval None
+  */
+static void LCD_GlyphCacheUpdate(void)
+{
+  uint32_t glyph = 0, index = 0, counter = 0, set = 0;
+  const uint16_t *c;
+  uint8_t *alpha = (uint8_t *)LCD_GLYPH_CACHE;
+  
+  if (GlyphCacheFont == LCD_Currentfonts)
+  {
+    return;
+  }
+  
+  /* Queued blends may still read the old glyphs */
+  GFX_Wait();
+  
+  for (glyph = 0; glyph < LCD_GLYPH_COUNT; glyph++)
+  {
+    c = &LCD_Currentfonts->table[glyph * LCD_Currentfonts->Height];
+    
+    for (index = 0; index < LCD_Currentfonts->Height; index++)
+    {
+      for (counter = 0; counter < LCD_Currentfonts->Width; counter++)
+      {
+        /* Same bit order as LCD_DrawChar */
+        if (LCD_Currentfonts->Width <= 12)
+        {
+          set = c[index] & ((0x80 << ((LCD_Currentfonts->Width / 12 ) * 8 ) ) >> counter);
+        }
+        else
+        {
+          set = c[index] & (0x1 << counter);
+        }
+        *alpha++ = (set != 0) ? 0xFF : 0x00;
+      }
+    }
+  }
+  
+  GlyphCacheFont = LCD_Currentfonts;
+}
+
+/**
+  * @brief  Draws one cached glyph in text color over what is on the layer.
+  * @param  Line: the Line where to display the character shape.
+  * @param  Column: start column address.
+  * @param  Ascii: character ascii code, others than 0x20..0x7E draw nothing.
+  * @retval None
+  */
+static void LCD_DrawGlyph(uint16_t Line, uint16_t Column, uint8_t Ascii)
+{
+  uint32_t size = LCD_Currentfonts->Width * LCD_Currentfonts->Height;
+  
+  /* Space and unknown characters are background only */
+  if ((Ascii <= LCD_GLYPH_FIRST) || (Ascii >= (LCD_GLYPH_FIRST + LCD_GLYPH_COUNT)))
+  {
+    return;
+  }
+  
+  GFX_BlendMask(LCD_GLYPH_CACHE + (Ascii - LCD_GLYPH_FIRST) * size, LCD_Currentfonts->Width, CM_A8,
+                LCD_RGB565ToRGB888(CurrentTextColor), LCD_SetCursor(Column, Line), LCD_PIXEL_WIDTH,
+                DMA2D_RGB565, LCD_Currentfonts->Width, LCD_Currentfonts->Height);
+}
+
+/**
+  * @brief  Converts a RGB565 color to RGB888 (DMA2D foreground color).
+  * @param  Color: RGB565 color.
+  * @retval RGB888 color
+  */
+static uint32_t LCD_RGB565ToRGB888(uint16_t Color)
+{
+  uint32_t red = (Color >> 11) & 0x1F, green = (Color >> 5) & 0x3F, blue = Color & 0x1F;
+  
+  red   = (red << 3) | (red >> 2);
+  green = (green << 2) | (green >> 4);
+  blue  = (blue << 3) | (blue >> 2);
+  
+  return (red << 16) | (green << 8) | blue;
+}
+
+/**
+  * @brief  Fills one row from X1 to X2 (both included) with the text color,
+  *         clipped to the screen. Long spans are queued to DMA2D, short ones
+  *         are written by the CPU two pixels per store. The caller waits for
+  *         DMA2D and marks the shape dirty.
+  * @param  X1: first column.
+  * @param  X2: last column.
+  * @param  Ypos: row.
+  * @retval None
+  */
+static void LCD_FillSpan(int32_t X1, int32_t X2, int32_t Ypos)
+{
+  uint32_t address = 0, pair = 0;
+  int32_t width = 0;
+  
+  if((Ypos < 0) || (Ypos >= LCD_PIXEL_HEIGHT))
+  {
+    return;
+  }
+  if(X1 < 0)
+  {
+    X1 = 0;
+  }
+  if(X2 >= LCD_PIXEL_WIDTH)
+  {
+    X2 = LCD_PIXEL_WIDTH - 1;
+  }
+  width = X2 - X1 + 1;
+  if(width <= 0)
+  {
+    return;
+  }
+  
+  address = CurrentFrameBuffer + 2*(LCD_PIXEL_WIDTH*Ypos + X1);
+  
+  if(width >= LCD_SPAN_DMA2D_MIN)
+  {
+    GFX_Fill(address, LCD_PIXEL_WIDTH, width, 1, DMA2D_RGB565, CurrentTextColor);
+    return;
+  }
+  
+  /* One halfword to reach word alignment, then two pixels per store */
+  if(address & 2)
+  {
+    *(__IO uint16_t*) address = CurrentTextColor;
+    address += 2;
+    width--;
+  }
+  pair = CurrentTextColor | ((uint32_t)CurrentTextColor << 16);
+  for(; width >= 2; width -= 2)
+  {
+    *(__IO uint32_t*) address = pair;
+    address += 4;
+  }
+  if(width != 0)
+  {
+    *(__IO uint16_t*) address = CurrentTextColor;
+  }
+}
+
+/**
+  * @brief  Adds a drawn region to the dirty list of the current layer, it is
+  *         merged with a kept rectangle when that doesn't grow the copied area.
+  * @param  Xpos, Ypos: top left pixel.
+  * @param  Width, Height: region size.
+  * @retval None
+  */
+static void LCD_MarkDirty(int32_t Xpos, int32_t Ypos, int32_t Width, int32_t Height)
+{
+  LCD_Rect area, merged;
+  LCD_Rect *rect;
+  int32_t grow = 0, bestgrow = 0x7FFFFFFF;
+  uint8_t index = 0, best = 0;
+  
+  if (LayerBack[CurrentLayer] == 0)
+  {
+    return;
+  }
+  
+  /* Clip to the screen */
+  area.X1 = (Xpos < 0) ? 0 : Xpos;
+  area.Y1 = (Ypos < 0) ? 0 : Ypos;
+  area.X2 = ((Xpos + Width) > LCD_PIXEL_WIDTH) ? LCD_PIXEL_WIDTH : (Xpos + Width);
+  area.Y2 = ((Ypos + Height) > LCD_PIXEL_HEIGHT) ? LCD_PIXEL_HEIGHT : (Ypos + Height);
+  if ((area.X1 >= area.X2) || (area.Y1 >= area.Y2))
+  {
+    return;
+  }
+  
+  for (index = 0; index < DirtyCount[CurrentLayer]; index++)
+  {
+    rect = &DirtyRect[CurrentLayer][index];
+    merged.X1 = (rect->X1 < area.X1) ? rect->X1 : area.X1;
+    merged.Y1 = (rect->Y1 < area.Y1) ? rect->Y1 : area.Y1;
+    merged.X2 = (rect->X2 > area.X2) ? rect->X2 : area.X2;
+    merged.Y2 = (rect->Y2 > area.Y2) ? rect->Y2 : area.Y2;
+    
+    grow = (merged.X2 - merged.X1)*(merged.Y2 - merged.Y1)
+         - (rect->X2 - rect->X1)*(rect->Y2 - rect->Y1)
+         - (area.X2 - area.X1)*(area.Y2 - area.Y1);
+    
+    if (grow <= 0)
+    {
+      *rect = merged;
+      return;
+    }
+    if (grow < bestgrow)
+    {
+      bestgrow = grow;
+      best = index;
+    }
+  }
+  
+  if (DirtyCount[CurrentLayer] < LCD_DIRTY_MAX)
+  {
+    DirtyRect[CurrentLayer][DirtyCount[CurrentLayer]++] = area;
+  }
+  else
+  {
+    /* List is full, grow the rectangle that costs the least */
+    rect = &DirtyRect[CurrentLayer][best];
+    rect->X1 = (rect->X1 < area.X1) ? rect->X1 : area.X1;
+    rect->Y1 = (rect->Y1 < area.Y1) ? rect->Y1 : area.Y1;
+    rect->X2 = (rect->X2 > area.X2) ? rect->X2 : area.X2;
+    rect->Y2 = (rect->Y2 > area.Y2) ? rect->Y2 : area.Y2;
+  }
+}
+
 /**
   * @brief  Displays a pixel.
   * @param  x: pixel x.
@@ -79,6 +79,22 @@ typedef struct
 
 #define LCD_FRAME_BUFFER       ((uint32_t)0xD0000000)
 #define BUFFER_OFFSET          ((uint32_t)0x50000) 
+
+/* Glyph cache: A8 copy of the current font (ASCII 0x20..0x7E), in SDRAM after
+   the two layers, drawn with DMA2D blending by the LCD_Display* functions */
+#define LCD_GLYPH_CACHE        ((uint32_t)(LCD_FRAME_BUFFER + 2*BUFFER_OFFSET))
+#define LCD_GLYPH_FIRST        0x20
+#define LCD_GLYPH_COUNT        95
+
+/* Back buffers used by LCD_DoubleBufferCmd (one per layer), after the glyph cache */
+#define LCD_BACK_BUFFER        ((uint32_t)(LCD_FRAME_BUFFER + 3*BUFFER_OFFSET))
+/* Dirty rectangles kept per layer between two swaps, more are merged */
+#define LCD_DIRTY_MAX          8
+/* Swaps are done by the LTDC line interrupt on the first line of the
+   vertical front porch (line counter after AccumulatedActiveH = 323) */
+#define LCD_SWAP_LINE          324
+#define LCD_LTDC_IRQn          LTDC_IRQn
+#define LCD_LTDC_IRQHandler    LTDC_IRQHandler
 /**
  * @brief Uncomment the line below if you want to use user defined Delay function
  *        (for precise timing), otherwise default _delay_ function defined within
@@ -263,12 +279,18 @@ void     LCD_Init(void);
 void     LCD_LayerInit(void);
 void     LCD_ChipSelect(FunctionalState NewState);
 void     LCD_SetLayer(__IO uint32_t Layerx);
+void     LCD_DoubleBufferCmd(FunctionalState NewState);
+void     LCD_SwapBuffers(void);
+uint8_t  LCD_IsSwapPending(void);
+uint32_t LCD_GetSwapBytes(void);
+void     LCD_LTDC_IRQHandler(void);
 void     LCD_SetColors(__IO uint16_t _TextColor, __IO uint16_t _BackColor); 
 void     LCD_GetColors(__IO uint16_t *_TextColor, __IO uint16_t *_BackColor);
 void     LCD_SetTextColor(__IO uint16_t Color);
 void     LCD_SetBackColor(__IO uint16_t Color);
 void     LCD_SetTransparency(uint8_t transparency);
 void     LCD_ClearLine(uint16_t Line);
+void     LCD_ScrollUp(uint16_t Ypos, uint16_t Height, uint16_t Step);
 void     LCD_Clear(uint16_t Color);
 uint32_t LCD_SetCursor(uint16_t Xpos, uint16_t Ypos);
 void     LCD_SetColorKeying(uint32_t RGBValue);
@@ -0,0 +1,565 @@
+/**
+  ******************************************************************************
+  * @file    stm32f429i_discovery_ts.c
+  * @author  Islam Ehab
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   Interrupt driven touch panel pipeline on the STMPE811.
+  *          The STMPE811 collects samples in its FIFO and pulls its interrupt
+  *          line on the FIFO threshold and on touch/release. The interrupt
+  *          starts a chain of queued I2C transactions that reads the FIFO
+  *          in DMA bursts, filters the samples (3-tap median, then a
+  *          fixed point IIR) and queues DOWN/MOVE/UP events. Nothing runs
+  *          while the panel is not touched.
+  *          Do not mix with IOE_TP_GetState(), which reconfigures the FIFO.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32f429i_discovery_ts.h"
+
+/** @addtogroup Utilities
+  * @{
+  */
+
+/** @addtogroup STM32F4_DISCOVERY
+  * @{
+  */
+
+/** @addtogroup STM32F429I_DISCOVERY
+  * @{
+  */
+
+/** @defgroup STM32F429I_DISCOVERY_TS
+  * @brief This file includes the touch panel sampling pipeline
+  * @{
+  */
+
+/** @defgroup STM32F429I_DISCOVERY_TS_Private_Types
+  * @{
+  */
+typedef struct
+{
+  int32_t Acc;            /* IIR state, raw value << 4 */
+  int32_t Hist[2];        /* Previous two raw samples for the median */
+} TS_AxisFilter;
+/**
+  * @}
+  */
+
+/** @defgroup STM32F429I_DISCOVERY_TS_Private_Defines
+  * @{
+  */
+/* Steps of the read chain, each one I2C transaction */
+#define TS_STEP_STATUS          0     /* Read INT_STA */
+#define TS_STEP_CLEAR           1     /* Clear the INT_STA bits read */
+#define TS_STEP_SIZE            2     /* Read FIFO_SIZE */
+#define TS_STEP_DATA            3     /* Burst read of the FIFO */
+#define TS_STEP_MORE            4     /* Read FIFO_SIZE after a burst */
+#define TS_STEP_CTRL            5     /* Read TP_CTRL for the touch state */
+
+/* TP_CTRL: XYZ acquisition, tracking index 4, enabled */
+#define TS_TP_CTRL_CONFIG       0x11
+#define TS_TP_CTRL_TOUCH        0x80
+
+/* One FIFO sample in XYZ mode: X[11:0], Y[11:0], Z[7:0] */
+#define TS_SAMPLE_SIZE          4
+
+#define TS_IT_SOURCES           (IOE_GIT_TOUCH | IOE_GIT_FTH | IOE_GIT_FOV)
+/**
+  * @}
+  */
+
+/** @defgroup STM32F429I_DISCOVERY_TS_Private_Variables
+  * @{
+  */
+static TS_EventTypeDef TS_Queue[TS_QUEUE_SIZE];
+static __IO uint32_t   TS_QueueHead = 0;
+static __IO uint32_t   TS_QueueTail = 0;
+static TS_StatsTypeDef TS_Stats;
+
+/* Read chain state, owned by the I2C interrupt while Busy is set */
+static __IO uint8_t    TS_Busy = 0;
+static __IO uint8_t    TS_Pending = 0;
+static uint8_t         TS_Step = TS_STEP_STATUS;
+static uint8_t         TS_Retries = 0;
+static uint8_t         TS_IntStatus = 0;
+static uint16_t        TS_BurstSamples = 0;
+static uint8_t         TS_Buffer[TS_BURST_MAX * TS_SAMPLE_SIZE];
+
+/* Filter and last published position */
+static uint8_t         TS_Down = 0;
+static TS_AxisFilter   TS_FilterX, TS_FilterY, TS_FilterZ;
+static uint16_t        TS_LastX = 0, TS_LastY = 0;
+/**
+  * @}
+  */
+
+/** @defgroup STM32F429I_DISCOVERY_TS_Private_FunctionPrototypes
+  * @{
+  */
+static void    TS_Start(void);
+static void    TS_Next(uint8_t Step, uint8_t Direction, uint8_t Register, uint16_t Length);
+static void    TS_Done(void *Context, uint8_t Status);
+static void    TS_Filter(TS_AxisFilter *Filter, int32_t Sample);
+static void    TS_Process(void);
+static void    TS_Publish(uint8_t Type, uint16_t X, uint16_t Y, uint16_t Z);
+static uint8_t TS_LineActive(void);
+/**
+  * @}
+  */
+
+/** @defgroup STM32F429I_DISCOVERY_TS_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Tells whether the STMPE811 interrupt line is asserted (low).
+  * @param  None
+  * @retval 1 if asserted, 0 otherwise.
+  */
+static uint8_t TS_LineActive(void)
+{
+  return (uint8_t)(GPIO_ReadInputDataBit(IOE_IT_GPIO_PORT, IOE_IT_PIN) == Bit_RESET);
+}
+
+/**
+  * @brief  Starts the read chain. Called with TS_Busy clear.
+  * @param  None
+  * @retval None
+  */
+static void TS_Start(void)
+{
+  TS_Busy = 1;
+  TS_Pending = 0;
+  TS_Next(TS_STEP_STATUS, I2CM_DIR_READ, IOE_REG_INT_STA, 1);
+}
+
+/**
+  * @brief  Queues the next transaction of the read chain.
+  * @param  Step: chain step the transaction belongs to.
+  * @param  Direction: I2CM_DIR_READ or I2CM_DIR_WRITE.
+  * @param  Register: STMPE811 register.
+  * @param  Length: bytes in TS_Buffer to read or write.
+  * @retval None
+  */
+static void TS_Next(uint8_t Step, uint8_t Direction, uint8_t Register, uint16_t Length)
+{
+  I2CM_Transfer xfer;
+
+  xfer.Address = IOE_ADDR;
+  xfer.Direction = Direction;
+  xfer.RegSize = 1;
+  xfer.Register = Register;
+  xfer.Buffer = TS_Buffer;
+  xfer.Length = Length;
+  xfer.Callback = TS_Done;
+  xfer.Context = 0;
+
+  TS_Step = Step;
+
+  if(I2CM_Submit(&xfer) != I2CM_OK)
+  {
+    TS_Done(0, I2CM_QUEUE_FULL);
+  }
+}
+
+/**
+  * @brief  Completion of a chain transaction, runs in the I2C interrupt.
+  * @param  Context: unused.
+  * @param  Status: transaction status.
+  * @retval None
+  */
+static void TS_Done(void *Context, uint8_t Status)
+{
+  uint16_t count;
+
+  (void)Context;
+
+  if(Status != I2CM_OK)
+  {
+    TS_Stats.Errors++;
+    TS_Busy = 0;
+
+    /* A level interrupt left asserted would never raise another edge */
+    if((TS_Retries++ < TS_MAX_RETRIES) && TS_LineActive())
+    {
+      TS_Start();
+    }
+    return;
+  }
+
+  switch(TS_Step)
+  {
+  case TS_STEP_STATUS:
+    TS_IntStatus = TS_Buffer[0];
+    if(TS_IntStatus & IOE_GIT_FOV)
+    {
+      TS_Stats.Overruns++;
+    }
+    /* Cleared first: a threshold crossed from now on keeps the line low */
+    TS_Next(TS_STEP_CLEAR, I2CM_DIR_WRITE, IOE_REG_INT_STA, 1);
+    break;
+
+  case TS_STEP_CLEAR:
+    TS_Next(TS_STEP_SIZE, I2CM_DIR_READ, IOE_REG_FIFO_SIZE, 1);
+    break;
+
+  case TS_STEP_SIZE:
+  case TS_STEP_MORE:
+    count = TS_Buffer[0];
+    /* After a burst, samples below the threshold wait for the next FTH
+       interrupt instead of a burst each; a touch change or an overrun
+       empties the FIFO */
+    if((count != 0) &&
+       ((TS_Step == TS_STEP_SIZE) || (count >= TS_FIFO_THRESHOLD) ||
+        ((TS_IntStatus & (IOE_GIT_TOUCH | IOE_GIT_FOV)) != 0)))
+    {
+      if(count > TS_BURST_MAX)
+      {
+        count = TS_BURST_MAX;
+      }
+      /* Non incrementing data port: the whole burst pops the FIFO */
+      TS_BurstSamples = count;
+      TS_Next(TS_STEP_DATA, I2CM_DIR_READ, IOE_REG_TP_DATA_NI, count * TS_SAMPLE_SIZE);
+    }
+    else
+    {
+      TS_Next(TS_STEP_CTRL, I2CM_DIR_READ, IOE_REG_TP_CTRL, 1);
+    }
+    break;
+
+  case TS_STEP_DATA:
+    TS_Process();
+    break;
+
+  case TS_STEP_CTRL:
+    if(((TS_Buffer[0] & TS_TP_CTRL_TOUCH) == 0) && (TS_Down != 0))
+    {
+      TS_Down = 0;
+      TS_Publish(TS_EVENT_UP, TS_LastX, TS_LastY, 0);
+    }
+    /* Fall through: end of the chain */
+
+  default:
+    TS_Busy = 0;
+    TS_Retries = 0;
+
+    /* New samples or a release may have come in during the chain */
+    if(TS_Pending || TS_LineActive())
+    {
+      TS_Start();
+    }
+    break;
+  }
+}
+
+/**
+  * @brief  Feeds one raw sample through the median and IIR filters.
+  * @param  Filter: axis filter state.
+  * @param  Sample: raw sample.
+  * @retval None
+  */
+static void TS_Filter(TS_AxisFilter *Filter, int32_t Sample)
+{
+  int32_t a = Filter->Hist[0], b = Filter->Hist[1], median;
+
+  /* Median of the last three samples removes single sample spikes */
+  if(a > b)
+  {
+    median = a; a = b; b = median;
+  }
+  median = (Sample < a) ? a : ((Sample > b) ? b : Sample);
+
+  Filter->Hist[0] = Filter->Hist[1];
+  Filter->Hist[1] = Sample;
+
+  Filter->Acc += ((median << 4) - Filter->Acc) >> TS_IIR_SHIFT;
+}
+
+/**
+  * @brief  Filters the burst of TS_BurstSamples FIFO samples in TS_Buffer,
+  *         queues the resulting event and goes back for more samples.
+  * @param  None
+  * @retval None
+  */
+static void TS_Process(void)
+{
+  const uint8_t *sample = TS_Buffer;
+  uint16_t index, x, y, z, dx, dy;
+  int32_t rx, ry, rz;
+
+  for(index = 0; index < TS_BurstSamples; index++, sample += TS_SAMPLE_SIZE)
+  {
+    rx = ((int32_t)sample[0] << 4) | (sample[1] >> 4);
+    ry = ((int32_t)(sample[1] & 0x0F) << 8) | sample[2];
+    rz = sample[3];
+
+    if((TS_Down == 0) && (index == 0))
+    {
+      /* New touch: start the filters on the first sample */
+      TS_FilterX.Acc = rx << 4; TS_FilterX.Hist[0] = TS_FilterX.Hist[1] = rx;
+      TS_FilterY.Acc = ry << 4; TS_FilterY.Hist[0] = TS_FilterY.Hist[1] = ry;
+      TS_FilterZ.Acc = rz << 4; TS_FilterZ.Hist[0] = TS_FilterZ.Hist[1] = rz;
+    }
+
+    TS_Filter(&TS_FilterX, rx);
+    TS_Filter(&TS_FilterY, ry);
+    TS_Filter(&TS_FilterZ, rz);
+  }
+
+  TS_Stats.Bursts++;
+  TS_Stats.Samples += TS_BurstSamples;
+
+  x = IOE_TP_ScaleX((uint16_t)(TS_FilterX.Acc >> 4));
+  y = IOE_TP_ScaleY((uint16_t)(TS_FilterY.Acc >> 4));
+  z = (uint16_t)(TS_FilterZ.Acc >> 4);
+
+  if(TS_Down == 0)
+  {
+    TS_Down = 1;
+    TS_LastX = x;
+    TS_LastY = y;
+    TS_Publish(TS_EVENT_DOWN, x, y, z);
+  }
+  else
+  {
+    dx = (x > TS_LastX) ? (x - TS_LastX) : (TS_LastX - x);
+    dy = (y > TS_LastY) ? (y - TS_LastY) : (TS_LastY - y);
+    if((dx + dy) >= TS_MOVE_THRESHOLD)
+    {
+      TS_LastX = x;
+      TS_LastY = y;
+      TS_Publish(TS_EVENT_MOVE, x, y, z);
+    }
+  }
+
+  /* The FIFO may hold more than one burst */
+  TS_Next(TS_STEP_MORE, I2CM_DIR_READ, IOE_REG_FIFO_SIZE, 1);
+}
+
+/**
+  * @brief  Queues an event for TS_GetEvent(), dropped if the queue is full.
+  * @param  Type: event type.
+  * @param  X, Y, Z: position and pressure.
+  * @retval None
+  */
+static void TS_Publish(uint8_t Type, uint16_t X, uint16_t Y, uint16_t Z)
+{
+  TS_EventTypeDef *event;
+  uint32_t head = TS_QueueHead;
+
+  if((head - TS_QueueTail) >= TS_QUEUE_SIZE)
+  {
+    TS_Stats.Dropped++;
+    return;
+  }
+
+  event = &TS_Queue[head % TS_QUEUE_SIZE];
+  event->Type = Type;
+  event->X = X;
+  event->Y = Y;
+  event->Z = Z;
+
+  /* The event is complete before the consumer can see the new Head */
+  __DMB();
+  TS_QueueHead = head + 1;
+  TS_Stats.Events++;
+}
+
+/**
+  * @brief  Configures the STMPE811 touch controller for FIFO batching and
+  *         starts the interrupt driven pipeline.
+  * @param  None
+  * @retval IOE_OK, or the IOE_Config() error.
+  */
+uint8_t TS_Init(void)
+{
+  GPIO_InitTypeDef GPIO_InitStructure;
+  EXTI_InitTypeDef EXTI_InitStructure;
+  NVIC_InitTypeDef NVIC_InitStructure;
+  uint8_t status;
+
+  status = IOE_Config();
+  if(status != IOE_OK)
+  {
+    return status;
+  }
+
+  TS_QueueHead = 0;
+  TS_QueueTail = 0;
+  TS_Busy = 0;
+  TS_Pending = 0;
+  TS_Retries = 0;
+  TS_Down = 0;
+  TS_Stats.Bursts = 0;
+  TS_Stats.Samples = 0;
+  TS_Stats.Events = 0;
+  TS_Stats.Dropped = 0;
+  TS_Stats.Overruns = 0;
+  TS_Stats.Errors = 0;
+
+  /* Stop the controller while the FIFO threshold changes */
+  I2C_WriteDeviceRegister(IOE_REG_TP_CTRL, 0x00);
+  I2C_WriteDeviceRegister(IOE_REG_FIFO_TH, TS_FIFO_THRESHOLD);
+  I2C_WriteDeviceRegister(IOE_REG_FIFO_STA, 0x01);
+  I2C_WriteDeviceRegister(IOE_REG_FIFO_STA, 0x00);
+  I2C_WriteDeviceRegister(IOE_REG_TP_CTRL, TS_TP_CTRL_CONFIG);
+
+  /* Interrupt line: open drain, active low */
+  RCC_AHB1PeriphClockCmd(IOE_IT_GPIO_CLK, ENABLE);
+  RCC_APB2PeriphClockCmd(RCC_APB2Periph_SYSCFG, ENABLE);
+
+  GPIO_InitStructure.GPIO_Pin = IOE_IT_PIN;
+  GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IN;
+  GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+  GPIO_InitStructure.GPIO_PuPd = GPIO_PuPd_UP;
+  GPIO_Init(IOE_IT_GPIO_PORT, &GPIO_InitStructure);
+
+  SYSCFG_EXTILineConfig(IOE_IT_EXTI_PORT_SOURCE, IOE_IT_EXTI_PIN_SOURCE);
+
+  EXTI_InitStructure.EXTI_Line = IOE_IT_EXTI_LINE;
+  EXTI_InitStructure.EXTI_Mode = EXTI_Mode_Interrupt;
+  EXTI_InitStructure.EXTI_Trigger = EXTI_Trigger_Falling;
+  EXTI_InitStructure.EXTI_LineCmd = ENABLE;
+  EXTI_Init(&EXTI_InitStructure);
+  EXTI_ClearITPendingBit(IOE_IT_EXTI_LINE);
+
+  NVIC_InitStructure.NVIC_IRQChannel = IOE_IT_EXTI_IRQn;
+  NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = TS_IT_PREPRIO;
+  NVIC_InitStructure.NVIC_IRQChannelSubPriority = TS_IT_SUBPRIO;
+  NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+  NVIC_Init(&NVIC_InitStructure);
+
+  IOE_ClearGITPending(0xFF);
+  IOE_GITConfig(TS_IT_SOURCES, ENABLE);
+  IOE_GITCmd(ENABLE);
+
+  return IOE_OK;
+}
+
+/**
+  * @brief  Stops the pipeline and the touch interrupts.
+  * @param  None
+  * @retval None
+  */
+void TS_DeInit(void)
+{
+  EXTI_InitTypeDef EXTI_InitStructure;
+  NVIC_InitTypeDef NVIC_InitStructure;
+
+  NVIC_InitStructure.NVIC_IRQChannel = IOE_IT_EXTI_IRQn;
+  NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = TS_IT_PREPRIO;
+  NVIC_InitStructure.NVIC_IRQChannelSubPriority = TS_IT_SUBPRIO;
+  NVIC_InitStructure.NVIC_IRQChannelCmd = DISABLE;
+  NVIC_Init(&NVIC_InitStructure);
+
+  EXTI_InitStructure.EXTI_Line = IOE_IT_EXTI_LINE;
+  EXTI_InitStructure.EXTI_Mode = EXTI_Mode_Interrupt;
+  EXTI_InitStructure.EXTI_Trigger = EXTI_Trigger_Falling;
+  EXTI_InitStructure.EXTI_LineCmd = DISABLE;
+  EXTI_Init(&EXTI_InitStructure);
+
+  /* Let a running chain end before taking the bus */
+  while(TS_Busy != 0)
+  {
+  }
+
+  IOE_GITConfig(TS_IT_SOURCES, DISABLE);
+}
+
+/**
+  * @brief  Takes the oldest touch event out of the queue.
+  * @param  pEvent: destination.
+  * @retval 1 if an event was copied, 0 if the queue is empty.
+  */
+uint8_t TS_GetEvent(TS_EventTypeDef *pEvent)
+{
+  uint32_t tail = TS_QueueTail;
+
+  if(TS_QueueHead == tail)
+  {
+    return 0;
+  }
+
+  /* Read the event after seeing Head, free the slot after reading it */
+  __DMB();
+  *pEvent = TS_Queue[tail % TS_QUEUE_SIZE];
+  __DMB();
+  TS_QueueTail = tail + 1;
+
+  return 1;
+}
+
+/**
+  * @brief  Number of events waiting in the queue.
+  * @param  None
+  * @retval Event count.
+  */
+uint16_t TS_EventPending(void)
+{
+  return (uint16_t)(TS_QueueHead - TS_QueueTail);
+}
+
+/**
+  * @brief  Copies the pipeline counters.
+  * @param  pStats: pointer to the destination structure.
+  * @retval None
+  */
+void TS_GetStats(TS_StatsTypeDef *pStats)
+{
+  __disable_irq();
+  *pStats = TS_Stats;
+  __enable_irq();
+}
+
+/**
+  * @brief  STMPE811 interrupt: starts the read chain unless one is running
+  *         (the running one restarts itself while the line stays low).
+  * @param  None
+  * @retval None
+  */
+void TS_IRQHandler(void)
+{
+  uint32_t primask;
+
+  if(EXTI_GetITStatus(IOE_IT_EXTI_LINE) != RESET)
+  {
+    EXTI_ClearITPendingBit(IOE_IT_EXTI_LINE);
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    if(TS_Busy == 0)
+    {
+      TS_Retries = 0;
+      TS_Start();
+    }
+    else
+    {
+      TS_Pending = 1;
+    }
+
+    __set_PRIMASK(primask);
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
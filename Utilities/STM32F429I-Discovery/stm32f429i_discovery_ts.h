@@ -0,0 +1,137 @@
+/**
+  ******************************************************************************
+  * @file    stm32f429i_discovery_ts.h
+  * @author  Islam Ehab
+  * @version V1.0.0
+  * @date    19-Oct-2026
+  * @brief   This file contains all the functions prototypes for the
+  *          stm32f429i_discovery_ts.c driver.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM32F429I_DISCOVERY_TS_H
+#define __STM32F429I_DISCOVERY_TS_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32f429i_discovery_ioe.h"
+
+/** @addtogroup Utilities
+  * @{
+  */
+
+/** @addtogroup STM32F4_DISCOVERY
+  * @{
+  */
+
+/** @addtogroup STM32F429I_DISCOVERY
+  * @{
+  */
+
+/** @addtogroup STM32F429I_DISCOVERY_TS
+  * @{
+  */
+
+/** @defgroup STM32F429I_DISCOVERY_TS_Exported_Types
+  * @{
+  */
+
+/**
+  * @brief  Touch event, positions in screen pixels
+  */
+typedef struct
+{
+  uint8_t  Type;        /*!< TS_EVENT_DOWN, TS_EVENT_MOVE or TS_EVENT_UP */
+  uint16_t X;
+  uint16_t Y;
+  uint16_t Z;           /*!< Filtered pressure index */
+} TS_EventTypeDef;
+
+/**
+  * @brief  Touch pipeline counters
+  */
+typedef struct
+{
+  uint32_t Bursts;      /*!< FIFO bursts read */
+  uint32_t Samples;     /*!< Samples read out of the FIFO */
+  uint32_t Events;      /*!< Events queued */
+  uint32_t Dropped;     /*!< Events lost on a full queue */
+  uint32_t Overruns;    /*!< STMPE811 FIFO overruns */
+  uint32_t Errors;      /*!< Failed I2C transactions */
+} TS_StatsTypeDef;
+/**
+  * @}
+  */
+
+/** @defgroup STM32F429I_DISCOVERY_TS_Exported_Constants
+  * @{
+  */
+
+/* Event types */
+#define TS_EVENT_DOWN           1
+#define TS_EVENT_MOVE           2
+#define TS_EVENT_UP             3
+
+/* STMPE811 FIFO level raising the threshold interrupt, in samples */
+#define TS_FIFO_THRESHOLD       8
+
+/* Most samples read in one burst (the STMPE811 FIFO holds 128) */
+#define TS_BURST_MAX            32
+
+/* Events held until TS_GetEvent() (power of two) */
+#define TS_QUEUE_SIZE           16
+
+/* IIR weight of a new sample: 1 / 2^TS_IIR_SHIFT */
+#define TS_IIR_SHIFT            2
+
+/* Filtered movement, in pixels, below which no MOVE event is queued */
+#define TS_MOVE_THRESHOLD       2
+
+/* Failed transactions retried while the interrupt line stays low */
+#define TS_MAX_RETRIES          3
+
+#define TS_IT_PREPRIO           2
+#define TS_IT_SUBPRIO           0
+#define TS_IRQHandler           IOE_IT_EXTI_IRQHandler
+/**
+  * @}
+  */
+
+/** @defgroup STM32F429I_DISCOVERY_TS_Exported_Functions
+  * @{
+  */
+uint8_t  TS_Init(void);
+void     TS_DeInit(void);
+uint8_t  TS_GetEvent(TS_EventTypeDef *pEvent);
+uint16_t TS_EventPending(void);
+void     TS_GetStats(TS_StatsTypeDef *pStats);
+void     TS_IRQHandler(void);
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __STM32F429I_DISCOVERY_TS_H */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
@@ -31,86 +31,225 @@
  * 								Global Variable used						   *
  *******************************************************************************/
 RCC_clockValues				clock_values 		= {0};				/* RCC Clock Structure 							  */
+static RCC_config			rcc_configurations	= {0};				/* RCC Configuration, used till PLL is locked	  */
 USART_Config 				husart				= {0};				/* USART Configuration structure				  */
+static SWTIMER_Timer		button_timer		= {0};				/* Switch sampling timer						  */
+static SWTIMER_Timer		fls_timer			= {0};				/* Fls_MainFunction period						  */
+NO_INIT static uint8		log_buffer[LOG_BUFFER_SIZE];			/* printf Ring, read by DMA (not cleared at boot) */
 
 
 /********************************************************************************
  * 							Static Function Definition							*
  ********************************************************************************/
+static void Clock_Start(void);
 static void Hardware_Init(void);
 static void USART_Configuration(void);
+static void Button_TimerCallback(void* arg);
+static void Button_EdgeCallback(u8 line);
+static void Button_Task(uint32 events);
+static void Fls_TimerCallback(void* arg);
+static void Fls_Task(uint32 events);
+static void Trace_DrainRequest(void);
+static void Trace_Task(uint32 events);
 /********************************************************************************/
 /**
  * @fn	main function
  */
 int main (void)
 {
-	/* Variable used as Flag to check debouncing */
-	uint8 flag = 0;
+	/* Stage 1: Start Oscillators & PLL without waiting for them */
+	Clock_Start();
 
-	uint8 test;
-	/* Initialize HW (Clocks, Clocks for GPIO Ports & USART Used) */
-	Hardware_Init();
+	/* Boot Profile Timestamps (DWT Cycle Counter), counted from HSI */
+	vidDWT_Init();
+
+	/* Stage 2: Work that doesn't need PLL Clock runs while it locks */
+	xRCC_EnableClock(RCC_GPIOA);
+	xRCC_EnableClock(RCC_GPIOC);
+	xRCC_EnableClock(RCC_GPIOG);
+	u8RCC_initPoll();
 
 	/* Port Initialization */
 	Port_Init(&Port_Configuration);
+	u8RCC_initPoll();
+
+	/* Test Dio_WriteChannel With PG13 */
+	Dio_WriteChannel(DioConf_LED2_CHANNEL_ID_INDEX, STD_HIGH);
+	vidDWT_Mark(BOOT_MARK_FIRST_OUTPUT);
+
+	/* Stage 3: Wait for Clocks then Initialize HW depending on them (SysTick & USART) */
+	Hardware_Init();
+	vidDWT_Mark(BOOT_MARK_CLOCKS_READY);
+
+	/* Software Timers & Tasks, Trace Task must exist before TRACE asks for a Drain */
+	vidSWTIMER_Init();
+	xSCHED_CreateTask(TASK_BUTTON_PRIORITY, Button_Task);
+	xSCHED_CreateTask(TASK_FLS_PRIORITY, Fls_Task);
+	xSCHED_CreateTask(TASK_TRACE_PRIORITY, Trace_Task);
+
+	/* Fls Driver, its jobs are processed by the Fls Task every FLS_MAIN_FUNCTION_PERIOD_MS (Fls_TaskJobStart) */
+	Fls_Init(&Fls_Configuration);
 
 	/* USARTS Initialization */
 	USART_Configuration();
 
 	/* Testing USART1 */
 	vidUSART_SendString(USART1, (u8*)"Hello", 6);
+	vidDWT_Mark(BOOT_MARK_USART_READY);
 
-	/* Test Dio_WriteChannel With PG13 */
-	Dio_WriteChannel(DioConf_LED2_CHANNEL_ID_INDEX, STD_HIGH);
+	/* Switch press is an Event, it is only sampled while pressed */
+	xEXTI_Enable(BUTTON_EXTI_LINE, EXTI_PORTA, EXTI_RISING, Button_EdgeCallback);
 
+	/* Dispatch Tasks, CPU sleeps while no Task is Ready */
+	vidSCHED_Run();
+}
 
-	while(1)
-	{
-		/* Test Dio_ReadChannel With PA0  */
-		if(Dio_ReadChannel(DioConf_SW1_CHANNEL_ID_INDEX))
-		{
-			/* Denouncing Delay */
-			_delay_ms(50);
+/**
+ * @fn 		static void Button_TimerCallback(void* arg)
+ * @brief	SysTick context callback, wakes Button Task to take one Switch sample
+ */
+static void Button_TimerCallback(void* arg)
+{
+	(void)arg;
 
-			/* Check again for Button Pressing */
-			if(Dio_ReadChannel(DioConf_SW1_CHANNEL_ID_INDEX))
-			{
+	xSCHED_PostEvent(TASK_BUTTON_PRIORITY, EVENT_BUTTON_SAMPLE);
+}
 
-				/* Test Dio_WriteChannel With PG14 */
-				//Dio_WriteChannel(DioConf_LED2_CHANNEL_ID_INDEX, STD_HIGH);
+/**
+ * @fn 		static void Button_EdgeCallback(u8 line)
+ * @brief	EXTI0 ISR context callback, wakes Button Task on SW1 press
+ */
+static void Button_EdgeCallback(u8 line)
+{
+	(void)line;
 
-				/* Test Writing Low in Dio_WriteChannel with PG13 */
-				//Dio_WriteChannel(DioConf_LED1_CHANNEL_ID_INDEX, STD_LOW);
+	xSCHED_PostEvent(TASK_BUTTON_PRIORITY, EVENT_BUTTON_EDGE);
+}
+
+/**
+ * @fn 		static void Button_Task(uint32 events)
+ * @brief	Debounce SW1 (PA0) and flip LEDs once per press
+ *			- A press (EXTI0) starts the sampling timer, bounces don't restart it
+ *			- Switch must read high for BUTTON_DEBOUNCE_SAMPLES samples in a row
+ *			- Releasing the switch re-arms the flip and stops the sampling timer
+ */
+static void Button_Task(uint32 events)
+{
+	/* Number of consecutive pressed samples */
+	static uint8 samples = 0;
 
-				if(flag == 0)
-				{
-					/* Test Flip Channel API */
-					Dio_FlipChannel(DioConf_LED1_CHANNEL_ID_INDEX);
+	/* Variable used as Flag to check debouncing */
+	static uint8 flag = 0;
 
-					/* Test Flip Channel API */
-					Dio_FlipChannel(DioConf_LED2_CHANNEL_ID_INDEX);
+	if(((events & EVENT_BUTTON_EDGE) != 0) && (u8SWTIMER_IsActive(&button_timer) == 0))
+	{
+		samples = 0;
+		xSWTIMER_Start(&button_timer, BUTTON_SAMPLE_PERIOD_MS, BUTTON_SAMPLE_PERIOD_MS, Button_TimerCallback, NULL_PTR);
+	}
 
-					flag = 1;
-				}
+	if((events & EVENT_BUTTON_SAMPLE) == 0)
+	{
+		return;
+	}
 
-			}
+	/* Test Dio_ReadChannel With PA0  */
+	if(Dio_ReadChannel(DioConf_SW1_CHANNEL_ID_INDEX))
+	{
+		if(samples < BUTTON_DEBOUNCE_SAMPLES)
+		{
+			samples++;
 		}
-		else
+
+		if((samples == BUTTON_DEBOUNCE_SAMPLES) && (flag == 0))
 		{
-			flag = 0;
+			/* Test Flip Channel API */
+			Dio_FlipChannel(DioConf_LED1_CHANNEL_ID_INDEX);
+
+			/* Test Flip Channel API */
+			Dio_FlipChannel(DioConf_LED2_CHANNEL_ID_INDEX);
+
+			flag = 1;
+		}
+	}
+	else
+	{
+		samples = 0;
+		flag    = 0;
+
+		/* Released, nothing to sample till the next press */
+		vidSWTIMER_Stop(&button_timer);
+	}
+}
+
+/**
+ * @fn 		void Fls_TaskJobStart(void)
+ * @brief	Fls JobStartNotification, runs the Fls Task timer while a job is pending
+ *			so an idle Fls doesn't wake the CPU every FLS_MAIN_FUNCTION_PERIOD_MS
+ */
+void Fls_TaskJobStart(void)
+{
+	if(u8SWTIMER_IsActive(&fls_timer) == 0)
+	{
+		xSWTIMER_Start(&fls_timer, FLS_MAIN_FUNCTION_PERIOD_MS, FLS_MAIN_FUNCTION_PERIOD_MS, Fls_TimerCallback, NULL_PTR);
+	}
+}
+
+/**
+ * @fn 		static void Fls_TimerCallback(void* arg)
+ * @brief	SysTick context callback, wakes Fls Task for one Fls_MainFunction call
+ */
+static void Fls_TimerCallback(void* arg)
+{
+	(void)arg;
+
+	xSCHED_PostEvent(TASK_FLS_PRIORITY, EVENT_FLS_MAIN);
+}
+
+/**
+ * @fn 		static void Fls_Task(uint32 events)
+ * @brief	Runs Fls_MainFunction out of the SysTick ISR, a call may program/read
+ *			for most of a period; a missed period only makes the erase timeout longer
+ */
+static void Fls_Task(uint32 events)
+{
+	if((events & EVENT_FLS_MAIN) != 0)
+	{
+		Fls_MainFunction();
 
+		/* No job & Flash locked (a Notification may have started the next job) */
+		if(Fls_GetStatus() == MEMIF_IDLE)
+		{
+			vidSWTIMER_Stop(&fls_timer);
 		}
+	}
+}
+
+/**
+ * @fn 		static void Trace_DrainRequest(void)
+ * @brief	TRACE callback (Trace Point or UART4 Tx Complete), wakes Trace Task to send pending Records
+ */
+static void Trace_DrainRequest(void)
+{
+	xSCHED_PostEvent(TASK_TRACE_PRIORITY, EVENT_TRACE_DRAIN);
+}
 
+/**
+ * @fn 		static void Trace_Task(uint32 events)
+ * @brief	Lowest priority Task, sends one Trace Frame per wake up
+ */
+static void Trace_Task(uint32 events)
+{
+	if((events & EVENT_TRACE_DRAIN) != 0)
+	{
+		vidTRACE_Drain();
 	}
 }
 
 /*********************************************************************************************
- [Function Name]:	Hardware_Init
- [Description]:		Function to initiate Peripheral used:
- 	 	 	 	 	- RCC			- NVIC		- SYSTICK 		- GPIO
- 	 	 	 	 	- Enable Clock for GPIOA & GPIOB
- 	 	 	 	 	- Enable Clock for USART2 & 3
+ [Function Name]:	Clock_Start
+ [Description]:		Function to start RCC Clocks without waiting for them:
+ 	 	 	 	 	- HSE & Main PLL are enabled, SYSCLK stays HSI
+ 	 	 	 	 	- Switching to PLL is done by u8RCC_initPoll / xRCC_initComplete
  [Args]:			None
  [in]				None
  [out]				None
@@ -119,22 +258,16 @@ int main (void)
  **********************************************************************************************/
 
 /**
- * @fn 		static void Hardware_Init(void)
- * @brief	Function to initiate Peripheral used:
- *	 	 	- RCC			- GPIO
- *	 	 	- Enable Clock for GPIOA & GPIOC & GPIOG
- *	 	 	- Enable Clock for USART1, 2 & 4
+ * @fn 		static void Clock_Start(void)
+ * @brief	Function to start RCC Clocks (HSE & Main PLL) without waiting for them
  *
  */
-static void Hardware_Init(void)
+static void Clock_Start(void)
 {
-	/* RCC Configuration structure */
-	RCC_config rcc_configurations = {0};
-
 	/*------------------------ RCC Clock Configurations ------------------*/
 	/*********************************************************************
 	 * - HSE used as a main oscillator 	 								 *
-	 * - By using PLL, SYSCLK = 72 MHz									 *
+	 * - By using PLL, SYSCLK = 80 MHz									 *
 	 * - SYSCLK Source is PLL											 *
 	 * - AHB  Clock = SYSCLK											 *
 	 * - APB1 Clock = AHB Clock / 2									     *
@@ -157,8 +290,33 @@ static void Hardware_Init(void)
 	/* Initialize Registers */
 	xRCC_regInit();
 
-	/* Initialize RCC & Config PLLs */
-	xRCC_init(&rcc_configurations);
+	/* Start HSE & PLL, SYSCLK stays HSI till they are ready */
+	xRCC_initStart(&rcc_configurations);
+}
+
+/*********************************************************************************************
+ [Function Name]:	Hardware_Init
+ [Description]:		Function to initiate Peripheral used after clocks are ready:
+ 	 	 	 	 	- RCC (Wait for PLL)	- SYSTICK
+ 	 	 	 	 	- Enable Clock for USART1, 2, 3 & 4
+ [Args]:			None
+ [in]				None
+ [out]				None
+ [in/out]			None
+ [Returns]:			None
+ **********************************************************************************************/
+
+/**
+ * @fn 		static void Hardware_Init(void)
+ * @brief	Function to initiate Peripheral used after clocks are ready:
+ *	 	 	- RCC (Wait for PLL)	- SYSTICK
+ *	 	 	- Enable Clock for USART1, 2 & 4
+ *
+ */
+static void Hardware_Init(void)
+{
+	/* Wait for PLL then switch SYSCLK to it */
+	xRCC_initComplete();
 
 	/* Get Clock Values */
 	xRCC_getClocks(&clock_values);
@@ -166,15 +324,6 @@ static void Hardware_Init(void)
 	/* Initialize SYSTICK with Freq - 1 (Step) */
 	vidSYSTICK_Init(( (clock_values.SYSCLKFrequency) / 1000) );
 
-	/* Enable GPIOA Clock (For USART2) */
-	xRCC_EnableClock(RCC_GPIOA);
-
-	/* Enable GPIOC Clock (For UART4)*/
-	xRCC_EnableClock(RCC_GPIOC);
-
-	/* Enable GPIOG Clock for F429 on board Kits LEDs */
-	xRCC_EnableClock(RCC_GPIOG);
-
 	/* Enable USART1 Clock */
 	xRCC_EnableClock(RCC_USART1);
 
@@ -187,6 +336,12 @@ static void Hardware_Init(void)
 	/* Enable USART6 Clock */
 	xRCC_EnableClock(RCC_USART4);
 
+	/* Enable DMA2 Clock (USART1 Tx Stream) */
+	xRCC_EnableClock(RCC_DMA2);
+
+	/* Enable DMA1 Clock (UART4 Tx Stream) */
+	xRCC_EnableClock(RCC_DMA1);
+
 }
 
 /*********************************************************************************************
@@ -207,17 +362,19 @@ static void Hardware_Init(void)
 static void USART_Configuration(void)
 {
 
-	/* works on APB2 Clock = 72 MHz */
+	/* USART1 works on APB2 Clock */
 	husart.Parity   		= NO;
 	husart.OverSampling		= NO;
 	husart.WordLength 		= Data_Bits_8;
 	husart.StopBit			= One_Bit;
 	husart.Mode				= (Receiver | Transmitter);
-	//husart.BaudRate 		= 0x271;	/* Baud Rate Calculations with APB2 = 72 MHz */
-	husart.BaudRate 		= 0x2B7;	/* Baud Rate Calculations with APB2 = 80 MHz */
-
-	vidUSART_Init(USART1, &husart);
+	husart.BaudRate 		= BR115200;	/* BRR is calculated from APB2 Clock */
 
+	/* stdout & stderr go to USART1 through the Log Ring, only once it is running */
+	if(OK == xUSART_Init(USART1, &husart))
+	{
+		xLOG_Init(USART1, log_buffer, sizeof(log_buffer));
+	}
 
 	/* USART6 Configurations */
 	husart.Parity   		= NO;
@@ -225,9 +382,12 @@ static void USART_Configuration(void)
 	husart.WordLength 		= Data_Bits_8;
 	husart.StopBit			= One_Bit;
 	husart.Mode				= (Receiver | Transmitter);
-	//husart.BaudRate 		= 0x271;	/* Baud Rate Calculations with APB2 = 72 MHz */
-	husart.BaudRate 		= 0x15C;	/* Baud Rate Calculations with APB1 = 40 MHz */
+	husart.BaudRate 		= BR115200;	/* BRR is calculated from APB1 Clock */
 	/* Set USART6 with same Configurations */
-	vidUSART_Init(UART4, &husart);
+	/* Binary Trace Records go to UART4, only once it is running */
+	if(OK == xUSART_Init(UART4, &husart))
+	{
+		vidTRACE_Init(UART4, Trace_DrainRequest);
+	}
 
 }
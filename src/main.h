@@ -30,6 +30,7 @@
 /*----------------------------- AUTOSAR Includes -----------------------------*/
 #include "Port.h"
 #include "Dio.h"
+#include "Fls.h"
 
 /*--------------------------- Non-AUTOSAR Includes ---------------------------*/
 #include "RCC_Init.h"
@@ -37,6 +38,50 @@
 #include "DMA_Init.h"
 #include "USART_Init.h"
 #include "USART_Reg.h"
+#include "SWTIMER_Init.h"
+#include "SCHED_Init.h"
+#include "DWT_Init.h"
+#include "LOG_Init.h"
+#include "TRACE_Init.h"
+#include "EXTI_Init.h"
+#include "MEM_SECTIONS.h"
+
+/******************************************************************************
+ * 								Definitions
+ ******************************************************************************/
+/* Scheduler Task Priorities (0 is the highest) */
+#define TASK_BUTTON_PRIORITY		(1U)
+#define TASK_FLS_PRIORITY			(30U)		/* Flash jobs run when nothing else is Ready */
+#define TASK_TRACE_PRIORITY			(31U)
+
+/* Button Task Events */
+#define EVENT_BUTTON_SAMPLE			(0x00000001U)
+#define EVENT_BUTTON_EDGE			(0x00000002U)		/* SW1 pressed (EXTI0 ISR)	*/
+
+/* Fls Task Events */
+#define EVENT_FLS_MAIN				(0x00000001U)		/* FLS_MAIN_FUNCTION_PERIOD_MS elapsed */
+
+/* Fls JobStartNotification of Fls_Lcfg.c, the Fls Task runs only while a job is pending */
+void Fls_TaskJobStart(void);
+
+/* Trace Task Events */
+#define EVENT_TRACE_DRAIN			(0x00000001U)
+
+/* Binary Trace Records are sent on UART4 as they are logged (tools/trace_decode.py) */
+
+/* SW1 (PA0 -> EXTI0) press wakes the Button Task, then SW1 is sampled every 10 ms
+   till it is released, 5 equal samples give the 50 ms debounce */
+#define BUTTON_EXTI_LINE			(0U)
+#define BUTTON_SAMPLE_PERIOD_MS		(10U)
+#define BUTTON_DEBOUNCE_SAMPLES		(5U)
+
+/* Boot Profile Marks (us since reset, read with u32DWT_GetMark) */
+#define BOOT_MARK_FIRST_OUTPUT		(0U)		/* First GPIO output (LED2 on PG13) */
+#define BOOT_MARK_CLOCKS_READY		(1U)		/* PLL is SYSCLK, SysTick running	*/
+#define BOOT_MARK_USART_READY		(2U)		/* USART configured & first byte sent */
+
+/* printf Ring (USART1 + DMA), Holds the longest burst of messages between drains */
+#define LOG_BUFFER_SIZE				(1024U)
 
 
 #endif /* MAIN_H_ */
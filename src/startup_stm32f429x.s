@@ -72,33 +72,80 @@ defined in linker script */
 Reset_Handler:  
   ldr   sp, =_estack    /* Atollic update: set stack pointer */
   
-/* Copy the data segment initializers from flash to SRAM */  
+/* Copy every copy table entry {load, run, size} from flash:
+   .data & .ramfunc to SRAM, .ccmram to CCM-RAM
+   64 bytes per loop (two 8-register LDM/STM bursts), then one
+   32 bytes burst and the remaining words one by one */
+  ldr  r4, =__copy_table_start__
+  ldr  r5, =__copy_table_end__
+
+LoopCopyTable:
+  cmp  r4, r5
+  bcs  ZeroTableInit
+  ldmia  r4!, {r1, r2, r3}
+
+CopyBurst:
+  subs  r3, r3, #64
+  blt  CopyHalf
+  ldmia  r1!, {r0, r6, r7, r8, r9, r10, r11, r12}
+  stmia  r2!, {r0, r6, r7, r8, r9, r10, r11, r12}
+  ldmia  r1!, {r0, r6, r7, r8, r9, r10, r11, r12}
+  stmia  r2!, {r0, r6, r7, r8, r9, r10, r11, r12}
+  b  CopyBurst
+
+CopyHalf:
+  adds  r3, r3, #32
+  blt  CopyTail
+  ldmia  r1!, {r0, r6, r7, r8, r9, r10, r11, r12}
+  stmia  r2!, {r0, r6, r7, r8, r9, r10, r11, r12}
+  b  CopyWord
+
+CopyTail:
+  adds  r3, r3, #32
+
+CopyWord:
+  subs  r3, r3, #4
+  blt  LoopCopyTable
+  ldr  r0, [r1], #4
+  str  r0, [r2], #4
+  b  CopyWord
+
+/* Zero fill every zero table entry {run, size}: .bss & .ccmbss
+   .noinit isn't in the table, it keeps its content */
+ZeroTableInit:
+  ldr  r4, =__zero_table_start__
+  ldr  r5, =__zero_table_end__
+  movs  r0, #0
   movs  r1, #0
-  b  LoopCopyDataInit
+  movs  r6, #0
+  movs  r7, #0
+  mov  r8, r0
+  mov  r9, r0
+  mov  r10, r0
+  mov  r11, r0
 
-CopyDataInit:
-  ldr  r3, =_sidata
-  ldr  r3, [r3, r1]
-  str  r3, [r0, r1]
-  adds  r1, r1, #4
-    
-LoopCopyDataInit:
-  ldr  r0, =_sdata
-  ldr  r3, =_edata
-  adds  r2, r0, r1
-  cmp  r2, r3
-  bcc  CopyDataInit
-  ldr  r2, =_sbss
-  b  LoopFillZerobss
-/* Zero fill the bss segment. */  
-FillZerobss:
-  movs  r3, #0
-  str  r3, [r2], #4
-    
-LoopFillZerobss:
-  ldr  r3, = _ebss
-  cmp  r2, r3
-  bcc  FillZerobss
+LoopZeroTable:
+  cmp  r4, r5
+  bcs  ZeroTableDone
+  ldmia  r4!, {r2, r3}
+
+ZeroBurst:
+  subs  r3, r3, #64
+  blt  ZeroTail
+  stmia  r2!, {r0, r1, r6, r7, r8, r9, r10, r11}
+  stmia  r2!, {r0, r1, r6, r7, r8, r9, r10, r11}
+  b  ZeroBurst
+
+ZeroTail:
+  adds  r3, r3, #64
+
+ZeroWord:
+  subs  r3, r3, #4
+  blt  LoopZeroTable
+  str  r0, [r2], #4
+  b  ZeroWord
+
+ZeroTableDone:
 
 /* Call the clock system intitialization function.*/
   bl  SystemInit   
@@ -0,0 +1,55 @@
+/*
+******************************************************************************
+File:     syscalls.c
+
+Abstract: Minimal System calls used by tiny_printf.c
+
+          _write sends stdout & stderr to the LOG ring (USART1 + DMA),
+          so printf/puts only format on the stack & copy into the ring.
+          Output is dropped (not blocked on) when the ring is full,
+          puts/fputs then return EOF.
+
+******************************************************************************
+*/
+
+/* Includes */
+#include "STD_TYPES_OLD.h"
+#include "DMA_Init.h"
+#include "USART_Init.h"
+#include "LOG_Init.h"
+
+/* Function prototypes */
+int _write(int fd, char *str, int len);
+
+/**
+**===========================================================================
+**  Abstract: Write len bytes from str to file descriptor fd
+**            (only stdout = 1 & stderr = 2 are supported)
+**  Returns:  Number of bytes queued, -1 for unsupported descriptors
+**===========================================================================
+*/
+int _write(int fd, char *str, int len)
+{
+	int written = 0;
+	u16 chunk = 0;
+
+	if((fd != 1) && (fd != 2))
+	{
+		return -1;
+	}
+
+	while(written < len)
+	{
+		chunk = ((len - written) > 0xFFFF) ? 0xFFFF : (u16)(len - written);
+		chunk = u16LOG_Write((const u8*)&str[written], chunk);
+		written += chunk;
+
+		/* Ring is full */
+		if(0 == chunk)
+		{
+			break;
+		}
+	}
+
+	return written;
+}
@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+"""
+boot_cycles.py
+
+  Created on: Oct 19, 2026
+      Author: Islam Ehab
+
+Reset to main() estimate of the startup copy & zero tables (src/startup_stm32f429x.s).
+
+Reads the sizes of the sections in __copy_table__ (.data, .ramfunc, .ccmram) and
+__zero_table__ (.bss, .ccmbss) from the linker map, then counts the Cortex-M4 cycles
+of the loop that moves them, for a byte loop, a word loop, a 4 word LDM/STM burst
+and the 2 x 8 word burst shipped in the startup.
+
+Cycles per instruction (Cortex-M4 TRM): LDR 2, STR 1, LDM/STM 1 + N, data processing 1,
+branch 1 not taken & 3 taken. The startup runs from HSI (16 MHz) before any clock
+setup, Flash has no wait state then. SystemInit & __libc_init_array aren't counted.
+
+Usage:
+    boot_cycles.py [Debug/AUTOSAR_Port_Driver.map] [--hz 16000000]
+"""
+
+import argparse
+import re
+import sys
+
+COPY_SECTIONS = (".data", ".ramfunc", ".ccmram")
+ZERO_SECTIONS = (".bss", ".ccmbss")
+
+# Output section line of a GNU ld map: name, address, size (name may be alone on its line)
+SECTION = re.compile(r"^(\.[\w.]+)\s*(?:\n\s+)?0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)", re.MULTILINE)
+
+# Table entry: CMP / BCS / LDMIA of the entry ({load, run, size} or {run, size})
+COPY_ENTRY = 1 + 1 + 4
+ZERO_ENTRY = 1 + 1 + 3
+
+# End of a table: CMP / BCS taken, the zero table also clears 8 registers first
+COPY_TABLE = 1 + 3
+ZERO_TABLE = 1 + 3 + 8
+
+# Exit of a size loop: SUBS / BLT taken
+LOOP_EXIT = 1 + 3
+
+
+def read_sizes(path):
+    """Return {section: size} of the copy & zero table sections found in a map file"""
+    with open(path, "r", errors="replace") as map_file:
+        text = map_file.read()
+
+    sizes = {}
+    for name, _address, size in SECTION.findall(text):
+        if name in COPY_SECTIONS + ZERO_SECTIONS and name not in sizes:
+            sizes[name] = int(size, 16)
+    return sizes
+
+
+def copy_byte(size):
+    # LDRB r0,[r1],#1 / STRB r0,[r2],#1 / SUBS / BNE
+    return size * (2 + 1 + 1 + 3)
+
+
+def copy_word(size):
+    # SUBS / BLT / LDR r0,[r1],#4 / STR r0,[r2],#4 / B (startup CopyWord)
+    return (size // 4) * (1 + 1 + 2 + 1 + 3) + LOOP_EXIT
+
+
+def copy_burst4(size):
+    # SUBS / BLT / LDMIA {4} / STMIA {4} / B, then the word loop
+    return (size // 16) * (1 + 1 + 5 + 5 + 3) + LOOP_EXIT + copy_word(size % 16)
+
+
+def copy_shipped(size):
+    # CopyBurst: SUBS / BLT / 2 x (LDMIA {8} / STMIA {8}) / B
+    cycles = (size // 64) * (1 + 1 + 4 * 9 + 3) + LOOP_EXIT
+    rest = size % 64
+    # CopyHalf: ADDS / BLT / LDMIA {8} / STMIA {8} / B, or ADDS / BLT taken / CopyTail ADDS
+    if rest >= 32:
+        cycles += 1 + 1 + 9 + 9 + 3
+        rest -= 32
+    else:
+        cycles += 1 + 3 + 1
+    return cycles + copy_word(rest)
+
+
+def zero_byte(size):
+    # STRB r0,[r2],#1 / SUBS / BNE
+    return size * (1 + 1 + 3)
+
+
+def zero_word(size):
+    # SUBS / BLT / STR r0,[r2],#4 / B (startup ZeroWord)
+    return (size // 4) * (1 + 1 + 1 + 3) + LOOP_EXIT
+
+
+def zero_burst4(size):
+    # SUBS / BLT / STMIA {4} / B, then the word loop
+    return (size // 16) * (1 + 1 + 5 + 3) + LOOP_EXIT + zero_word(size % 16)
+
+
+def zero_shipped(size):
+    # ZeroBurst: SUBS / BLT / 2 x STMIA {8} / B, ZeroTail ADDS then the word loop
+    return (size // 64) * (1 + 1 + 2 * 9 + 3) + LOOP_EXIT + 1 + zero_word(size % 64)
+
+
+LOOPS = (
+    ("byte", copy_byte, zero_byte),
+    ("word", copy_word, zero_word),
+    ("4 word burst", copy_burst4, zero_burst4),
+    ("2 x 8 word (shipped)", copy_shipped, zero_shipped),
+)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Reset to main() cycles of the startup copy & zero tables")
+    parser.add_argument("map", nargs="?", default="Debug/AUTOSAR_Port_Driver.map", help="GNU ld map file")
+    parser.add_argument("--hz", type=int, default=16000000, help="core clock of the startup (HSI)")
+    options = parser.parse_args()
+
+    sizes = read_sizes(options.map)
+    missing = [name for name in COPY_SECTIONS + ZERO_SECTIONS if name not in sizes]
+    if len(missing) == len(COPY_SECTIONS + ZERO_SECTIONS):
+        print("%s: no copy or zero table section found" % options.map, file=sys.stderr)
+        return 1
+
+    print("%s" % options.map)
+    for name in COPY_SECTIONS + ZERO_SECTIONS:
+        kind = "copy" if name in COPY_SECTIONS else "zero"
+        if name in sizes:
+            print("  %-9s %s %7d bytes" % (name, kind, sizes[name]))
+        else:
+            print("  %-9s %s       - (not in this map, counted as 0)" % (name, kind))
+
+    print("\n%-22s %12s %12s %12s %10s" % ("loop", "copy cycles", "zero cycles", "total", "us"))
+    for label, copy, zero in LOOPS:
+        copy_cycles = sum(copy(sizes.get(name, 0)) + COPY_ENTRY for name in COPY_SECTIONS) + COPY_TABLE
+        zero_cycles = sum(zero(sizes.get(name, 0)) + ZERO_ENTRY for name in ZERO_SECTIONS) + ZERO_TABLE
+        total = copy_cycles + zero_cycles
+        print("%-22s %12d %12d %12d %10.1f" % (label, copy_cycles, zero_cycles, total, total * 1e6 / options.hz))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,509 @@
+/*
+ * cpu_sim.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ *
+ *  Host model of the Cortex-M4 time & interrupts for the register level harnesses
+ *  - While Sim_StepOn is in effect every instruction is single stepped (x86 Trap Flag)
+ *    and counted as SIM_CPI cycles in Sim_Cycles; the x86-64 -O2 instruction count of
+ *    the driver stands in for its Thumb-2 one (build with -fno-tree-vectorize
+ *    -fno-tree-loop-distribute-patterns so copy loops stay scalar loops as on the M4)
+ *  - Sim_MapBlock maps register blocks at their STM32 addresses (no access): every
+ *    access traps, runs single stepped with the blocks open and costs SIM_REG_WAIT
+ *    more cycles. Sim_RegRead(Address) runs before a load (refresh a counter, clear
+ *    on read), Sim_RegWrite(Address, Old) after a store (write 1 to clear, start a
+ *    transfer); Sim_Reg / Sim_SetReg access a register without a trap
+ *  - Sim_Tick runs once Sim_Cycles reaches Sim_NextEvent, it schedules the next one
+ *  - Sim_IrqSet pends an IRQ; it is taken between 2 instructions when enabled, PRIMASK
+ *    is clear & its priority is above the running one, with the NVIC entry & exit
+ *    cycles. The handler runs single stepped too, Sim_IrqCycles is the time in them
+ *  - Sim_Wfi: time jumps from event to event till an enabled interrupt is pending, with
+ *    PRIMASK set too as WFI does (counted in Sim_IdleCycles)
+ *  - Sim_FetchMode: code runs from SRAM (.ramfunc, no fetch cost, the default) or from
+ *    Flash through the ART: a 16 byte line missing from its 64 line cache costs
+ *    SIM_FLASH_WS cycles, less the cycles spent in the previous line when it is the
+ *    next one (prefetch); SIM_FETCH_FLASH_COLD empties the cache at every interrupt
+ *    entry (thread code evicted the handler)
+ *
+ *  Include after std_types_sim.h / the driver headers & before the driver .c files,
+ *  then define
+ *  static void Sim_RegRead(uint32_t Address);
+ *  static void Sim_RegWrite(uint32_t Address, uint32_t Old);
+ *  static void Sim_Tick(void);
+ *  x86-64 Linux only, build with -no-pie (the blocks & the drivers' u32 addresses
+ *  need the low 4 GB) & keep buffers static
+ */
+
+#ifndef CPU_SIM_H_
+#define CPU_SIM_H_
+
+#ifndef _GNU_SOURCE
+#error "Define _GNU_SOURCE before any include (ucontext register names)"
+#endif
+
+#include <signal.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+
+#if !defined(__x86_64__) || !defined(__linux__)
+#error "cpu_sim.h single steps with the x86 Trap Flag, x86-64 Linux only"
+#endif
+
+#define SIM_BLOCKS				(8U)
+#define SIM_PAGE				(0x1000U)
+#define SIM_EFLAGS_TF			(0x100UL)
+#define SIM_PF_WRITE			(0x2UL)
+#define SIM_IRQS				(128U)
+#define SIM_THREAD_LEVEL		(0x100U)
+#define SIM_NEVER				(~(uint64_t)0)
+
+/* Cortex-M4: one cycle per instruction (LDR 2, taken branch 2-4 are the exceptions),
+   peripheral access through the bus matrix & AHB/APB bridge, exception entry & return */
+#ifndef SIM_CPI
+#define SIM_CPI					(1U)
+#endif
+#ifndef SIM_REG_WAIT
+#define SIM_REG_WAIT			(2U)
+#endif
+#define SIM_IRQ_ENTRY			(12U)
+#define SIM_IRQ_EXIT			(10U)
+
+/* Flash at 180 MHz (2.7-3.6 V): 5 wait states, ART instruction cache 64 lines of 128 bits */
+#ifndef SIM_FLASH_WS
+#define SIM_FLASH_WS			(5U)
+#endif
+#define SIM_ART_LINES			(64U)
+
+#define SIM_FETCH_RAM			(0U)
+#define SIM_FETCH_FLASH			(1U)
+#define SIM_FETCH_FLASH_COLD	(2U)
+
+static void Sim_RegRead(uint32_t Address);
+static void Sim_RegWrite(uint32_t Address, uint32_t Old);
+static void Sim_Tick(void);
+
+/* Register blocks of the harness, page aligned */
+static uint32_t Sim_BlockBase[SIM_BLOCKS];
+static uint32_t Sim_BlockSize[SIM_BLOCKS];
+static uint32_t Sim_Blocks;
+
+static volatile uint64_t Sim_Cycles;
+static volatile uint64_t Sim_Instructions;
+static volatile uint64_t Sim_IrqCycles;
+static volatile uint64_t Sim_IdleCycles;
+static volatile uint64_t Sim_NextEvent = SIM_NEVER;
+static volatile uint32_t Sim_Stepping;
+
+static volatile uint32_t Sim_Primask;
+static volatile uint8_t Sim_IrqPending[SIM_IRQS];
+static volatile uint8_t Sim_IrqEnabled[SIM_IRQS];
+static uint8_t Sim_IrqPriority[SIM_IRQS];
+static void (*Sim_IrqVector[SIM_IRQS])(void);
+static volatile uint32_t Sim_IrqLevel = SIM_THREAD_LEVEL;
+static volatile uint32_t Sim_IrqDepth;
+static uint32_t Sim_IrqStack[8][2];			/* IRQ & the level it preempted */
+static volatile uint32_t Sim_IrqTaken[SIM_IRQS];
+
+/* Instruction fetch: ART cache lines (line + 1, 0 empty), last line & cycles spent in it */
+static volatile uint32_t Sim_FetchMode;
+static uint64_t Sim_ArtTag[SIM_ART_LINES];
+static uint64_t Sim_ArtLast;
+static uint32_t Sim_ArtLineCycles;
+
+/* Register access in progress: address, store, old word */
+static volatile uint32_t Sim_Access;
+static uint32_t Sim_AccessAddress;
+static uint32_t Sim_AccessWrite;
+static uint32_t Sim_AccessOld;
+static uint32_t Sim_ModelDepth;
+
+void Sim_IrqEntry(void);
+void Sim_IrqDispatch(void);
+
+/*
+ * Interrupt entry: all caller saved registers, flags & SSE state are kept, the red
+ * zone of the interrupted function is skipped (ret $128)
+ */
+__asm__(
+  ".text\n"
+  ".globl Sim_IrqEntry\n"
+  "Sim_IrqEntry:\n"
+  "  pushfq\n"
+  "  push %rax\n  push %rcx\n  push %rdx\n  push %rsi\n  push %rdi\n"
+  "  push %r8\n  push %r9\n  push %r10\n  push %r11\n  push %rbx\n"
+  "  mov %rsp, %rbx\n"
+  "  and $-16, %rsp\n"
+  "  sub $512, %rsp\n"
+  "  fxsave (%rsp)\n"
+  "  call Sim_IrqDispatch\n"
+  "  fxrstor (%rsp)\n"
+  "  mov %rbx, %rsp\n"
+  "  pop %rbx\n  pop %r11\n  pop %r10\n  pop %r9\n  pop %r8\n"
+  "  pop %rdi\n  pop %rsi\n  pop %rdx\n  pop %rcx\n  pop %rax\n"
+  "  popfq\n"
+  "  ret $128\n");
+
+/* Model code touches the registers, open them unless a trapped access already did */
+static void Sim_Protect(int Protection)
+{
+  uint32_t block = 0;
+
+  for(block = 0; block < Sim_Blocks; block++)
+  {
+    mprotect((void *)(uintptr_t)Sim_BlockBase[block], Sim_BlockSize[block], Protection);
+  }
+}
+
+static void Sim_Open(void)
+{
+  if(Sim_ModelDepth++ == 0)
+  {
+    Sim_Protect(PROT_READ | PROT_WRITE);
+  }
+}
+
+static void Sim_Close(void)
+{
+  if(--Sim_ModelDepth == 0)
+  {
+    Sim_Protect(PROT_NONE);
+  }
+}
+
+static __attribute__((unused)) uint32_t Sim_Reg(uint32_t Address)
+{
+  uint32_t value = 0;
+
+  Sim_Open();
+  value = *(volatile uint32_t *)(uintptr_t)Address;
+  Sim_Close();
+
+  return value;
+}
+
+static __attribute__((unused)) void Sim_SetReg(uint32_t Address, uint32_t Value)
+{
+  Sim_Open();
+  *(volatile uint32_t *)(uintptr_t)Address = Value;
+  Sim_Close();
+}
+
+static int Sim_InBlock(uintptr_t Address)
+{
+  uint32_t block = 0;
+
+  for(block = 0; block < Sim_Blocks; block++)
+  {
+    if((Address >= Sim_BlockBase[block]) && (Address < ((uintptr_t)Sim_BlockBase[block] + Sim_BlockSize[block])))
+    {
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+static inline void Sim_StepOn(void)
+{
+  Sim_Stepping = 1;
+  __asm__ volatile("pushfq\n orq $0x100, (%%rsp)\n popfq" ::: "memory", "cc");
+}
+
+static inline void Sim_StepOff(void)
+{
+  __asm__ volatile("pushfq\n andq $~0x100, (%%rsp)\n popfq" ::: "memory", "cc");
+  Sim_Stepping = 0;
+}
+
+static inline void Sim_IrqSet(uint32_t Irq)
+{
+  Sim_IrqPending[Irq] = 1;
+}
+
+static inline void Sim_IrqConnect(uint32_t Irq, void (*Handler)(void), uint8_t Priority)
+{
+  Sim_IrqVector[Irq] = Handler;
+  Sim_IrqPriority[Irq] = Priority;
+}
+
+/* PRIMASK: a pending IRQ is taken at the first instruction after it is cleared */
+static inline uint32_t Sim_GetPrimask(void)
+{
+  return Sim_Primask;
+}
+
+static inline void Sim_SetPrimask(uint32_t Mask)
+{
+  Sim_Primask = (Mask != 0) ? 1U : 0U;
+}
+
+static inline void Sim_DisableIrq(void)
+{
+  Sim_Primask = 1;
+}
+
+static inline void Sim_EnableIrq(void)
+{
+  Sim_Primask = 0;
+}
+
+/* Highest priority enabled IRQ pending above the running level, -1 if none */
+static int Sim_IrqHighest(void)
+{
+  uint32_t irq = 0, level = Sim_IrqLevel;
+  int next = -1;
+
+  for(irq = 0; irq < SIM_IRQS; irq++)
+  {
+    if((Sim_IrqPending[irq] != 0) && (Sim_IrqEnabled[irq] != 0) && (Sim_IrqPriority[irq] < level))
+    {
+      level = Sim_IrqPriority[irq];
+      next = (int)irq;
+    }
+  }
+
+  return next;
+}
+
+/* IRQ that may preempt now, -1 if none */
+static int Sim_IrqNext(void)
+{
+  return (Sim_Primask != 0) ? -1 : Sim_IrqHighest();
+}
+
+/* Sleep till the next interrupt, the time jumps to the next event of the model */
+static inline void Sim_Wfi(void)
+{
+  uint32_t stepping = Sim_Stepping;
+  uint64_t next = 0;
+
+  /* The model's own work isn't CPU time */
+  if(stepping != 0)
+  {
+    Sim_StepOff();
+  }
+
+  next = Sim_NextEvent;
+  /* Model events that don't raise an interrupt don't wake the CPU, PRIMASK doesn't matter */
+  while((Sim_IrqHighest() < 0) && (next != SIM_NEVER))
+  {
+    if(next > Sim_Cycles)
+    {
+      Sim_IdleCycles += next - Sim_Cycles;
+      Sim_Cycles = next;
+    }
+    Sim_Open();
+    Sim_Tick();
+    Sim_Close();
+    next = Sim_NextEvent;
+  }
+
+  if(stepping != 0)
+  {
+    Sim_StepOn();
+  }
+}
+
+static void Sim_ArtFlush(void)
+{
+  memset(Sim_ArtTag, 0, sizeof(Sim_ArtTag));
+  Sim_ArtLast = 0;
+  Sim_ArtLineCycles = 0;
+}
+
+/* Wait states to fetch the instruction at Pc */
+static uint32_t Sim_Fetch(uint64_t Pc)
+{
+  uint64_t line = Pc >> 4;
+  uint32_t slot = (uint32_t)(line % SIM_ART_LINES);
+  uint32_t wait = 0;
+
+  if(line == Sim_ArtLast)
+  {
+    Sim_ArtLineCycles += SIM_CPI;
+    return 0;
+  }
+
+  if(Sim_ArtTag[slot] != (line + 1U))
+  {
+    wait = SIM_FLASH_WS;
+    /* Prefetch reads the next line while the current one runs */
+    if(line == (Sim_ArtLast + 1U))
+    {
+      wait = (Sim_ArtLineCycles < SIM_FLASH_WS) ? (SIM_FLASH_WS - Sim_ArtLineCycles) : 0U;
+    }
+    Sim_ArtTag[slot] = line + 1U;
+  }
+
+  Sim_ArtLast = line;
+  Sim_ArtLineCycles = SIM_CPI;
+
+  return wait;
+}
+
+/* Runs single stepped on the interrupted stack (see Sim_IrqEntry): handler & return */
+void Sim_IrqDispatch(void)
+{
+  uint32_t irq = Sim_IrqStack[Sim_IrqDepth - 1U][0];
+
+  Sim_IrqVector[irq]();
+
+  Sim_IrqDepth--;
+  Sim_IrqLevel = Sim_IrqStack[Sim_IrqDepth][1];
+  Sim_Cycles += SIM_IRQ_EXIT;
+  Sim_IrqCycles += SIM_IRQ_EXIT;
+}
+
+static void Sim_Events(ucontext_t *Context)
+{
+  greg_t *regs = Context->uc_mcontext.gregs;
+  uint64_t sp = 0;
+  int irq = 0;
+
+  if(Sim_Cycles >= Sim_NextEvent)
+  {
+    Sim_Open();
+    Sim_Tick();
+    Sim_Close();
+  }
+
+  irq = Sim_IrqNext();
+  if((irq < 0) || (Sim_IrqDepth >= 8U))
+  {
+    return;
+  }
+
+  /* Exception entry: push the return address below the red zone, go to Sim_IrqEntry */
+  Sim_IrqPending[irq] = 0;
+  Sim_IrqTaken[irq]++;
+  Sim_IrqStack[Sim_IrqDepth][0] = (uint32_t)irq;
+  Sim_IrqStack[Sim_IrqDepth][1] = Sim_IrqLevel;
+  Sim_IrqDepth++;
+  Sim_IrqLevel = Sim_IrqPriority[irq];
+  Sim_Cycles += SIM_IRQ_ENTRY;
+  Sim_IrqCycles += SIM_IRQ_ENTRY;
+  if(Sim_FetchMode == SIM_FETCH_FLASH_COLD)
+  {
+    Sim_ArtFlush();
+  }
+
+  sp = (uint64_t)regs[REG_RSP] - 128U - 8U;
+  *(uint64_t *)sp = (uint64_t)regs[REG_RIP];
+  regs[REG_RSP] = (greg_t)sp;
+  regs[REG_RIP] = (greg_t)(uintptr_t)Sim_IrqEntry;
+}
+
+static void Sim_Trap(int Signal, siginfo_t *Info, void *Context)
+{
+  ucontext_t *uc = (ucontext_t *)Context;
+  uint32_t wait = 0;
+
+  (void)Signal;
+  (void)Info;
+
+  if(Sim_Access != 0)
+  {
+    if(Sim_AccessWrite != 0)
+    {
+      Sim_RegWrite(Sim_AccessAddress, Sim_AccessOld);
+    }
+    Sim_Access = 0;
+    Sim_Close();
+    Sim_Cycles += SIM_REG_WAIT;
+    if(Sim_IrqDepth != 0)
+    {
+      Sim_IrqCycles += SIM_REG_WAIT;
+    }
+
+    if(Sim_Stepping == 0)
+    {
+      uc->uc_mcontext.gregs[REG_EFL] &= ~(greg_t)SIM_EFLAGS_TF;
+      return;
+    }
+  }
+
+  if(Sim_Stepping == 0)
+  {
+    uc->uc_mcontext.gregs[REG_EFL] &= ~(greg_t)SIM_EFLAGS_TF;
+    return;
+  }
+
+  wait = (Sim_FetchMode != SIM_FETCH_RAM) ? Sim_Fetch((uint64_t)uc->uc_mcontext.gregs[REG_RIP]) : 0U;
+  Sim_Instructions++;
+  Sim_Cycles += SIM_CPI + wait;
+  if(Sim_IrqDepth != 0)
+  {
+    Sim_IrqCycles += SIM_CPI + wait;
+  }
+
+  Sim_Events(uc);
+}
+
+static void Sim_Fault(int Signal, siginfo_t *Info, void *Context)
+{
+  ucontext_t *uc = (ucontext_t *)Context;
+  uintptr_t address = (uintptr_t)Info->si_addr;
+
+  (void)Signal;
+
+  if((Sim_Access != 0) || (Sim_InBlock(address) == 0))
+  {
+    /* A real fault, crash on return */
+    signal(SIGSEGV, SIG_DFL);
+    return;
+  }
+
+  Sim_Access = 1;
+  Sim_AccessAddress = (uint32_t)address & ~3U;
+  Sim_AccessWrite = ((uc->uc_mcontext.gregs[REG_ERR] & SIM_PF_WRITE) != 0) ? 1U : 0U;
+
+  Sim_Open();
+  Sim_AccessOld = *(volatile uint32_t *)(uintptr_t)Sim_AccessAddress;
+  Sim_RegRead(Sim_AccessAddress);
+
+  uc->uc_mcontext.gregs[REG_EFL] |= (greg_t)SIM_EFLAGS_TF;
+}
+
+/* Register block at its STM32 address, zeroed; 0 or -1 if the range isn't free */
+static __attribute__((unused)) int Sim_MapBlock(uint32_t Base, uint32_t Size)
+{
+  uint32_t start = Base & ~(SIM_PAGE - 1U);
+  uint32_t size = ((Base + Size + SIM_PAGE - 1U) & ~(SIM_PAGE - 1U)) - start;
+  void *block = 0;
+
+  if(Sim_Blocks >= SIM_BLOCKS)
+  {
+    return -1;
+  }
+
+  block = mmap((void *)(uintptr_t)start, size, PROT_NONE,
+               MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+  if(block != (void *)(uintptr_t)start)
+  {
+    return -1;
+  }
+
+  Sim_BlockBase[Sim_Blocks] = start;
+  Sim_BlockSize[Sim_Blocks] = size;
+  Sim_Blocks++;
+
+  return 0;
+}
+
+static void Sim_CpuStart(void)
+{
+  struct sigaction action;
+
+  memset(&action, 0, sizeof(action));
+  action.sa_sigaction = Sim_Fault;
+  action.sa_flags = SA_SIGINFO | SA_NODEFER;
+  sigaction(SIGSEGV, &action, 0);
+  action.sa_sigaction = Sim_Trap;
+  action.sa_flags = SA_SIGINFO;
+  sigaction(SIGTRAP, &action, 0);
+}
+
+#endif /* CPU_SIM_H_ */
@@ -0,0 +1,415 @@
+/*
+ * dma2d_sim.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ *
+ *  Host model of the STM32F429 DMA2D & SDRAM for the LCD harnesses
+ *  - SDRAM is mapped at its target address (0xD0000000), build with -no-pie
+ *    so static buffers have 32 bit addresses too (GFX takes uint32_t addresses)
+ *  - DMA2D runs from a SIGALRM timer as an interrupt would: every tick it executes
+ *    the started transfer, sets TCIF (CEIF for formats it doesn't model) and
+ *    calls the DMA2D IRQ Handler
+ *  - A tick coming while PRIMASK is set is deferred until it is cleared
+ *  - Sim_CpuNow is the host time minus the time spent in the model, so a
+ *    benchmark only counts what the driver costs the CPU
+ *  - DMA2D time on target is modeled apart: every transfer adds its cycles at
+ *    SIM_DMA2D_HZ to Sim_Dma2dCycles (start + per line + per pixel of its mode,
+ *    RGB565 SDRAM frame buffer), Sim_Dma2dUs converts them
+ *  - The handler runs with Sim_Ipsr set (__get_IPSR), as in handler mode
+ *  - Sim_Dma2dFast set: the started transfer also ends when PRIMASK is cleared, so
+ *    a driver waiting on a full GFX queue doesn't spin for a tick of host time
+ *  Modes: R2M, M2M, M2M_PFC & M2M_BLEND, formats: ARGB8888 RGB888 RGB565 ARGB1555
+ *  ARGB4444 A8 A4 (no CLUT), Alpha Mode & Alpha of FGPFCCR/BGPFCCR are applied
+ *
+ *  Include after stm32f429i_discovery_dma2d.h & before the driver .c files
+ */
+
+#ifndef DMA2D_SIM_H_
+#define DMA2D_SIM_H_
+
+#include <signal.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <time.h>
+
+#define SIM_SDRAM_BASE			(0xD0000000UL)
+#define SIM_SDRAM_SIZE			(8UL * 1024UL * 1024UL)
+#define SIM_TICK_US				(20)
+
+/*
+ * DMA2D time model, AHB cycles: programming & start, then every line (SDRAM row &
+ * address of the next line) and every pixel. Per pixel by mode with an RGB565 output
+ * in SDRAM (16 bit bus at HCLK / 2): R2M writes 2 pixels a word, M2M reads & writes,
+ * PFC reads a 32 bit source, BLEND reads foreground & background then writes
+ */
+#define SIM_DMA2D_HZ			(180000000UL)
+#define SIM_DMA2D_START_CYCLES	(24U)
+#define SIM_DMA2D_LINE_CYCLES	(8U)
+#define SIM_DMA2D_R2M_CYCLES	(1U)
+#define SIM_DMA2D_M2M_CYCLES	(2U)
+#define SIM_DMA2D_PFC_CYCLES	(3U)
+#define SIM_DMA2D_BLEND_CYCLES	(4U)
+
+static DMA2D_TypeDef	Sim_Dma2d;
+static volatile uint32_t Sim_Transfers;
+static volatile uint32_t Sim_Primask;
+static volatile uint32_t Sim_Pending;
+static volatile uint32_t Sim_InTick;
+/* Set: the running transfer doesn't end (a long transfer) */
+static volatile uint32_t Sim_Dma2dHold;
+/* Set: the running transfer ends at the next PRIMASK clear too (benchmarks) */
+static volatile uint32_t Sim_Dma2dFast;
+static volatile double	Sim_ModelSeconds;
+static volatile uint64_t Sim_Dma2dCycles;
+static volatile uint32_t Sim_Ipsr;
+
+#undef DMA2D
+#define DMA2D					(&Sim_Dma2d)
+
+static void Sim_Dma2dTick(int Signal);
+
+/* PRIMASK: a tick coming while it is set runs when it is cleared, as a pended IRQ */
+static void Sim_SetPrimask(uint32_t Mask)
+{
+  Sim_Primask = (Mask != 0) ? 1 : 0;
+
+  if((Sim_Primask == 0) && ((Sim_Pending != 0) || (Sim_Dma2dFast != 0)))
+  {
+    Sim_Pending = 0;
+    Sim_Dma2dTick(0);
+  }
+}
+
+static uint32_t Sim_GetPrimask(void)
+{
+  return Sim_Primask;
+}
+
+static void Sim_DisableIrq(void)
+{
+  Sim_SetPrimask(1);
+}
+
+static uint32_t Sim_GetIpsr(void)
+{
+  return Sim_Ipsr;
+}
+
+#define __get_PRIMASK			Sim_GetPrimask
+#define __set_PRIMASK			Sim_SetPrimask
+#define __disable_irq			Sim_DisableIrq
+#define __get_IPSR				Sim_GetIpsr
+
+/* Only the Peripheral Library calls GFX_Init makes */
+void RCC_AHB1PeriphClockCmd(uint32_t RCC_AHB1Periph, FunctionalState NewState)
+{
+  (void)RCC_AHB1Periph;
+  (void)NewState;
+}
+
+void NVIC_Init(NVIC_InitTypeDef* NVIC_InitStruct)
+{
+  (void)NVIC_InitStruct;
+}
+
+/* Bits per pixel of a DMA2D format, 0 if it isn't modeled */
+static uint32_t Sim_Bpp(uint32_t ColorMode)
+{
+  switch(ColorMode & 0x0F)
+  {
+    case CM_ARGB8888: return 32;
+    case CM_RGB888:   return 24;
+    case CM_RGB565:
+    case CM_ARGB1555:
+    case CM_ARGB4444: return 16;
+    case CM_A8:       return 8;
+    case CM_A4:       return 4;
+    default:          return 0;
+  }
+}
+
+static uint32_t Sim_Expand(uint32_t Value, uint32_t Bits)
+{
+  return (Value << (8 - Bits)) | (Value >> ((2 * Bits) - 8));
+}
+
+/* Reads pixel Index of a buffer as ARGB8888, A8/A4 take their color from Color */
+static uint32_t Sim_Read(uint32_t Address, uint32_t Index, uint32_t ColorMode, uint32_t Color)
+{
+  const uint8_t *p = (const uint8_t *)(uintptr_t)Address;
+  uint32_t v = 0;
+
+  switch(ColorMode & 0x0F)
+  {
+    case CM_ARGB8888:
+      memcpy(&v, p + (4 * Index), 4);
+      return v;
+    case CM_RGB888:
+      p += 3 * Index;
+      return 0xFF000000 | ((uint32_t)p[2] << 16) | ((uint32_t)p[1] << 8) | p[0];
+    case CM_RGB565:
+      v = p[2 * Index] | ((uint32_t)p[(2 * Index) + 1] << 8);
+      return 0xFF000000 | (Sim_Expand(v >> 11, 5) << 16) | (Sim_Expand((v >> 5) & 0x3F, 6) << 8) | Sim_Expand(v & 0x1F, 5);
+    case CM_ARGB1555:
+      v = p[2 * Index] | ((uint32_t)p[(2 * Index) + 1] << 8);
+      return (((v & 0x8000) != 0) ? 0xFF000000 : 0) | (Sim_Expand((v >> 10) & 0x1F, 5) << 16) |
+             (Sim_Expand((v >> 5) & 0x1F, 5) << 8) | Sim_Expand(v & 0x1F, 5);
+    case CM_ARGB4444:
+      v = p[2 * Index] | ((uint32_t)p[(2 * Index) + 1] << 8);
+      return ((((v >> 12) & 0xF) * 0x11) << 24) | ((((v >> 8) & 0xF) * 0x11) << 16) |
+             ((((v >> 4) & 0xF) * 0x11) << 8) | ((v & 0xF) * 0x11);
+    case CM_A8:
+      return ((uint32_t)p[Index] << 24) | (Color & 0x00FFFFFF);
+    default:
+      /* A4: first pixel in the low nibble */
+      v = (p[Index / 2] >> (4 * (Index & 1))) & 0xF;
+      return ((v * 0x11) << 24) | (Color & 0x00FFFFFF);
+  }
+}
+
+static void Sim_Write(uint32_t Address, uint32_t Index, uint32_t ColorMode, uint32_t Argb)
+{
+  uint8_t *p = (uint8_t *)(uintptr_t)Address;
+  uint32_t a = Argb >> 24, r = (Argb >> 16) & 0xFF, g = (Argb >> 8) & 0xFF, b = Argb & 0xFF;
+  uint32_t v = 0;
+
+  switch(ColorMode & 0x07)
+  {
+    case DMA2D_ARGB8888:
+      memcpy(p + (4 * Index), &Argb, 4);
+      return;
+    case DMA2D_RGB888:
+      p[3 * Index] = (uint8_t)b; p[(3 * Index) + 1] = (uint8_t)g; p[(3 * Index) + 2] = (uint8_t)r;
+      return;
+    case DMA2D_RGB565:
+      v = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
+      break;
+    case DMA2D_ARGB1555:
+      v = ((a >> 7) << 15) | ((r >> 3) << 10) | ((g >> 3) << 5) | (b >> 3);
+      break;
+    default:
+      v = ((a >> 4) << 12) | ((r >> 4) << 8) | ((g >> 4) << 4) | (b >> 4);
+      break;
+  }
+
+  p[2 * Index] = (uint8_t)v;
+  p[(2 * Index) + 1] = (uint8_t)(v >> 8);
+}
+
+/* Alpha Mode (bits 17:16) & Alpha (bits 31:24) of a PFC Control Register */
+static uint32_t Sim_Alpha(uint32_t Argb, uint32_t Pfccr)
+{
+  uint32_t a = Argb >> 24, alpha = Pfccr >> 24;
+
+  switch((Pfccr >> 16) & 0x3)
+  {
+    case 1:  a = alpha; break;
+    case 2:  a = (a * alpha) / 255; break;
+    default: break;
+  }
+
+  return (a << 24) | (Argb & 0x00FFFFFF);
+}
+
+/* DMA2D blending formula (RM0090): Mult = Afg.Abg, Aout = Afg + Abg - Mult */
+static uint32_t Sim_Blend(uint32_t Fg, uint32_t Bg)
+{
+  uint32_t afg = Fg >> 24, abg = Bg >> 24, mult = (afg * abg) / 255, aout = afg + abg - mult;
+  uint32_t out = aout << 24, shift = 0, cfg = 0, cbg = 0;
+
+  if(aout == 0)
+  {
+    return 0;
+  }
+
+  for(shift = 0; shift < 24; shift += 8)
+  {
+    cfg = (Fg >> shift) & 0xFF;
+    cbg = (Bg >> shift) & 0xFF;
+    out |= (((cfg * afg) + (cbg * abg) - (cbg * mult)) / aout) << shift;
+  }
+
+  return out;
+}
+
+/* Executes the programmed transfer, returns the ISR flag it ends with */
+static uint32_t Sim_Dma2dRun(void)
+{
+  uint32_t mode = Sim_Dma2d.CR & 0x00030000;
+  uint32_t pl = (Sim_Dma2d.NLR >> 16) & 0x3FFF, nl = Sim_Dma2d.NLR & 0xFFFF;
+  uint32_t out = Sim_Dma2d.OPFCCR & 0x07, obytes = Sim_Bpp(out) / 8;
+  uint32_t fgcm = Sim_Dma2d.FGPFCCR & 0x0F, bgcm = Sim_Dma2d.BGPFCCR & 0x0F;
+  uint32_t x = 0, y = 0, o = 0, f = 0, b = 0, argb = 0;
+
+  if((out > DMA2D_ARGB4444) ||
+     ((mode != DMA2D_R2M) && (Sim_Bpp(fgcm) == 0)) ||
+     ((mode == DMA2D_M2M_BLEND) && (Sim_Bpp(bgcm) == 0)) ||
+     ((mode == DMA2D_M2M) && (fgcm != out)))
+  {
+    return DMA2D_ISR_CEIF;
+  }
+
+  for(y = 0; y < nl; y++)
+  {
+    for(x = 0; x < pl; x++)
+    {
+      o = (y * (pl + (Sim_Dma2d.OOR & 0x3FFF))) + x;
+      f = (y * (pl + (Sim_Dma2d.FGOR & 0x3FFF))) + x;
+      b = (y * (pl + (Sim_Dma2d.BGOR & 0x3FFF))) + x;
+
+      switch(mode)
+      {
+        case DMA2D_R2M:
+          /* OCOLR is already coded in the output format */
+          memcpy((uint8_t *)(uintptr_t)Sim_Dma2d.OMAR + (o * obytes), (const void *)&Sim_Dma2d.OCOLR, obytes);
+          break;
+        case DMA2D_M2M:
+          memcpy((uint8_t *)(uintptr_t)Sim_Dma2d.OMAR + (o * obytes), (const uint8_t *)(uintptr_t)Sim_Dma2d.FGMAR + (f * obytes), obytes);
+          break;
+        case DMA2D_M2M_PFC:
+          argb = Sim_Alpha(Sim_Read(Sim_Dma2d.FGMAR, f, fgcm, Sim_Dma2d.FGCOLR), Sim_Dma2d.FGPFCCR);
+          Sim_Write(Sim_Dma2d.OMAR, o, out, argb);
+          break;
+        default:
+          argb = Sim_Blend(Sim_Alpha(Sim_Read(Sim_Dma2d.FGMAR, f, fgcm, Sim_Dma2d.FGCOLR), Sim_Dma2d.FGPFCCR),
+                           Sim_Alpha(Sim_Read(Sim_Dma2d.BGMAR, b, bgcm, Sim_Dma2d.BGCOLR), Sim_Dma2d.BGPFCCR));
+          Sim_Write(Sim_Dma2d.OMAR, o, out, argb);
+          break;
+      }
+    }
+  }
+
+  return DMA2D_ISR_TCIF;
+}
+
+/* Target cycles of the programmed transfer (see SIM_DMA2D_START_CYCLES) */
+static uint32_t Sim_Dma2dTransferCycles(void)
+{
+  uint32_t pl = (Sim_Dma2d.NLR >> 16) & 0x3FFF, nl = Sim_Dma2d.NLR & 0xFFFF, pixel = 0;
+
+  switch(Sim_Dma2d.CR & 0x00030000)
+  {
+    case DMA2D_R2M:     pixel = SIM_DMA2D_R2M_CYCLES; break;
+    case DMA2D_M2M:     pixel = SIM_DMA2D_M2M_CYCLES; break;
+    case DMA2D_M2M_PFC: pixel = SIM_DMA2D_PFC_CYCLES; break;
+    default:            pixel = SIM_DMA2D_BLEND_CYCLES; break;
+  }
+
+  return SIM_DMA2D_START_CYCLES + (nl * SIM_DMA2D_LINE_CYCLES) + (pl * nl * pixel);
+}
+
+/* Modeled DMA2D time in us */
+static inline double Sim_Dma2dUs(uint64_t Cycles)
+{
+  return ((double)Cycles * 1e6) / (double)SIM_DMA2D_HZ;
+}
+
+static double Sim_HostNow(void)
+{
+  struct timespec Time;
+
+  clock_gettime(CLOCK_MONOTONIC, &Time);
+  return (double)Time.tv_sec + ((double)Time.tv_nsec * 1e-9);
+}
+
+/* Seconds of CPU time left to the code under test */
+static inline double Sim_CpuNow(void)
+{
+  double model = 0, now = 0;
+
+  /* Read again if a tick came in between */
+  do
+  {
+    model = Sim_ModelSeconds;
+    now = Sim_HostNow();
+  }
+  while(model != Sim_ModelSeconds);
+
+  return now - model;
+}
+
+/* Timer tick = DMA2D finishing the running transfer & raising its interrupt */
+static void Sim_Dma2dTick(int Signal)
+{
+  uint32_t flag = 0;
+  double start = 0;
+
+  (void)Signal;
+
+  if((Sim_Primask != 0) || (Sim_InTick != 0))
+  {
+    Sim_Pending = 1;
+    return;
+  }
+
+  /* Claimed before START is read: a signal coming in between runs a whole tick */
+  Sim_InTick = 1;
+
+  if(((Sim_Dma2d.CR & DMA2D_CR_START) == 0) || (Sim_Dma2dHold != 0))
+  {
+    Sim_InTick = 0;
+    return;
+  }
+
+  start = Sim_HostNow();
+  flag = Sim_Dma2dRun();
+  Sim_Transfers++;
+  if(flag == DMA2D_ISR_TCIF)
+  {
+    Sim_Dma2dCycles += Sim_Dma2dTransferCycles();
+  }
+  Sim_ModelSeconds += Sim_HostNow() - start;
+
+  Sim_Dma2d.CR &= ~DMA2D_CR_START;
+  Sim_Dma2d.ISR |= flag;
+  Sim_Dma2d.IFCR = 0;
+
+  if(((flag == DMA2D_ISR_TCIF) && ((Sim_Dma2d.CR & DMA2D_CR_TCIE) != 0)) ||
+     ((flag == DMA2D_ISR_CEIF) && ((Sim_Dma2d.CR & DMA2D_CR_CEIE) != 0)))
+  {
+    Sim_Ipsr = 16U + DMA2D_IRQn;
+    GFX_DMA2D_IRQHandler();
+    Sim_Ipsr = 0;
+  }
+
+  /* IFCR bits clear their ISR flags */
+  Sim_Dma2d.ISR &= ~Sim_Dma2d.IFCR;
+  Sim_InTick = 0;
+}
+
+/* Maps SDRAM & starts the DMA2D timer, returns 0 if SDRAM can't be mapped */
+static int Sim_Start(void)
+{
+  struct sigaction action;
+  struct itimerval timer;
+
+  if(mmap((void *)SIM_SDRAM_BASE, SIM_SDRAM_SIZE, PROT_READ | PROT_WRITE,
+          MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) != (void *)SIM_SDRAM_BASE)
+  {
+    return 0;
+  }
+
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = Sim_Dma2dTick;
+  action.sa_flags = SA_RESTART;
+  sigaction(SIGALRM, &action, 0);
+
+  timer.it_interval.tv_sec = 0;
+  timer.it_interval.tv_usec = SIM_TICK_US;
+  timer.it_value = timer.it_interval;
+  setitimer(ITIMER_REAL, &timer, 0);
+
+  return 1;
+}
+
+static void Sim_Stop(void)
+{
+  struct itimerval timer;
+
+  memset(&timer, 0, sizeof(timer));
+  setitimer(ITIMER_REAL, &timer, 0);
+}
+
+#endif /* DMA2D_SIM_H_ */
@@ -0,0 +1,467 @@
+/*
+ * dma_mem_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ *
+ *  Host test & benchmark of the DMA memory service (xDMA_MemCopy / xDMA_MemSet,
+ *  Drivers/DMA/DMA_Prog.c) over a register model of DMA2 Stream0 (cpu_sim.h)
+ *  - Memory to Memory transfers: copy (PINC) & pattern fill, 1/2/4 byte items,
+ *    INCR4 bursts; a burst on a NDTR that isn't whole bursts, a burst address not
+ *    16 bytes aligned or a CCM RAM address (not on the DMA bus) is a Transfer Error
+ *  - Sizes 1..400 (every one to 64) & alignments against memcpy/memset, nothing written outside
+ *  - Transfers over DMA_MEM_MAX_ITEMS items chain chunks from the TC interrupt
+ *  - CCM RAM buffers & small sizes are done by the CPU before return, no stream start
+ *  - Busy service refuses, NULL pointers, Transfer Error reports NOK
+ *  - Benchmark across sizes: CPU loop (the driver's own memcpy/memset) vs DMA,
+ *    time to complete & CPU cycles the DMA path takes (setup, TC interrupts);
+ *    the CPU/DMA crossover is DMA_MEM_CPU_THRESHOLD
+ *
+ *  Build & run from tools/host:
+ *  gcc -O2 -fno-tree-vectorize -fno-tree-loop-distribute-patterns -no-pie -Wall -Wno-pointer-to-int-cast -I../../Drivers/STD_and_MATH -I../../Drivers/DMA \
+ *      -I../../Drivers/RCC dma_mem_test.c -o dma_mem_test && ./dma_mem_test
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "std_types_sim.h"
+#include "cpu_sim.h"
+#include "DMA_Init.h"
+#include "RCC_Init.h"
+
+/*
+ * DMA2 Stream0 transfer cost at HCLK, DMA2 alone on the bus matrix (AN4031):
+ * single transfer = arbitration + AHB read + AHB write per item,
+ * INCR4 burst = arbitration once per 4 beats on each port
+ */
+#define SIM_DMA_START			(6U)
+#define SIM_DMA_ITEM			(4U)
+#define SIM_DMA_BURST4			(10U)
+
+#define SIM_LISR				((uint32_t)(uintptr_t)&DMA2->LISR)
+#define SIM_LIFCR				((uint32_t)(uintptr_t)&DMA2->LIFCR)
+#define SIM_S0CR				((uint32_t)(uintptr_t)&DMA2_STREAM0->CR)
+#define SIM_S0NDTR				((uint32_t)(uintptr_t)&DMA2_STREAM0->NDTR)
+#define SIM_S0PAR				((uint32_t)(uintptr_t)&DMA2_STREAM0->PAR)
+#define SIM_S0M0AR				((uint32_t)(uintptr_t)&DMA2_STREAM0->M0AR)
+#define SIM_ISER1				((uint32_t)(uintptr_t)&DMA_NVIC_ISER1)
+
+#define SIM_DMA2_STREAM0_IRQ	(56U)
+
+#define TEST_BUF_SIZE			(300000U)
+#define TEST_CCM_BASE			(0x10000000UL)
+#define TEST_CCM_SIZE			(0x10000UL)
+
+/* The service's header threshold, the harness moves it to reach both paths */
+static const u32 Test_HeaderThreshold = DMA_MEM_CPU_THRESHOLD;
+static u32 Sim_Threshold = DMA_MEM_CPU_THRESHOLD;
+
+#undef DMA_MEM_CPU_THRESHOLD
+#define DMA_MEM_CPU_THRESHOLD	Sim_Threshold
+
+#define RAM_FUNC
+#define CCM_BSS
+
+static uint32_t Sim_Starts;
+static uint32_t Sim_BurstStarts;
+static uint32_t Sim_Errors;
+static uint32_t Sim_ForceError;
+static uint32_t Sim_RccDma2;
+
+Return_status xRCC_EnableClock(u8 u8Peripheral)
+{
+  if(u8Peripheral == RCC_DMA2)
+  {
+    Sim_RccDma2 = 1;
+  }
+  return OK;
+}
+
+#include "../../Drivers/DMA/DMA_Prog.c"
+
+static int Sim_InCcm(uint32_t Address, uint32_t Size)
+{
+  return (Address < (TEST_CCM_BASE + TEST_CCM_SIZE)) && ((Address + Size) > TEST_CCM_BASE);
+}
+
+static void Sim_RegRead(uint32_t Address)
+{
+  (void)Address;
+}
+
+/* Stream0 enabled: check the setup & schedule the end of the transfer */
+static void Sim_DmaStart(void)
+{
+  uint32_t cr = Sim_Reg(SIM_S0CR), items = Sim_Reg(SIM_S0NDTR);
+  uint32_t width = 1U << ((cr >> 11) & 0x3U), burst = ((cr & (P_INCR4 | M_INCR4)) != 0) ? 1U : 0U;
+  uint32_t src = Sim_Reg(SIM_S0PAR), dest = Sim_Reg(SIM_S0M0AR);
+  uint32_t span = items * width, cost = 0;
+  int bad = (items == 0) || ((cr & Memory_To_Memory) == 0) || (width != (1U << ((cr >> 13) & 0x3U)))
+            || Sim_InCcm(dest, span) || Sim_InCcm(src, ((cr & PINC) != 0) ? span : width);
+
+  Sim_Starts++;
+  if(burst != 0)
+  {
+    Sim_BurstStarts++;
+    bad = bad || ((items & 0x3U) != 0) || (((dest | (((cr & PINC) != 0) ? src : 0U)) & 0xFU) != 0);
+  }
+
+  if(bad || (Sim_ForceError != 0))
+  {
+    Sim_Errors++;
+    Sim_SetReg(SIM_S0CR, cr & ~(uint32_t)EN);
+    Sim_SetReg(SIM_LISR, Sim_Reg(SIM_LISR) | (TEIF << DMA_MEM_STREAM_NUM));
+    Sim_IrqSet(SIM_DMA2_STREAM0_IRQ);
+    return;
+  }
+
+  cost = (burst != 0) ? (items / 4U) * SIM_DMA_BURST4 : items * SIM_DMA_ITEM;
+  Sim_NextEvent = Sim_Cycles + SIM_DMA_START + cost;
+}
+
+static void Sim_RegWrite(uint32_t Address, uint32_t Old)
+{
+  uint32_t value = Sim_Reg(Address), bit = 0;
+
+  if(Address == SIM_LIFCR)
+  {
+    Sim_SetReg(SIM_LISR, Sim_Reg(SIM_LISR) & ~value);
+    Sim_SetReg(SIM_LIFCR, 0);
+  }
+  else if(Address == SIM_S0CR)
+  {
+    if(((Old & EN) == 0) && ((value & EN) != 0))
+    {
+      Sim_DmaStart();
+    }
+    else if(((Old & EN) != 0) && ((value & EN) == 0))
+    {
+      Sim_NextEvent = SIM_NEVER;
+    }
+  }
+  else if(Address == SIM_ISER1)
+  {
+    for(bit = 0; bit < 32U; bit++)
+    {
+      if((value & (1UL << bit)) != 0)
+      {
+        Sim_IrqEnabled[32U + bit] = 1;
+      }
+    }
+    Sim_SetReg(SIM_ISER1, value | Old);
+  }
+}
+
+/* End of the transfer: move the data, TCIF & the interrupt */
+static void Sim_Tick(void)
+{
+  uint32_t cr = Sim_Reg(SIM_S0CR), items = Sim_Reg(SIM_S0NDTR);
+  uint32_t width = 1U << ((cr >> 11) & 0x3U);
+  uint8_t *src = (uint8_t *)(uintptr_t)Sim_Reg(SIM_S0PAR), *dest = (uint8_t *)(uintptr_t)Sim_Reg(SIM_S0M0AR);
+  uint32_t n = 0;
+
+  Sim_NextEvent = SIM_NEVER;
+
+  if((cr & PINC) != 0)
+  {
+    memmove(dest, src, (size_t)items * width);
+  }
+  else
+  {
+    for(n = 0; n < items; n++)
+    {
+      memcpy(dest + (n * width), src, width);
+    }
+  }
+
+  Sim_SetReg(SIM_S0NDTR, 0);
+  Sim_SetReg(SIM_S0CR, cr & ~(uint32_t)EN);
+  Sim_SetReg(SIM_LISR, Sim_Reg(SIM_LISR) | (TCIF << DMA_MEM_STREAM_NUM));
+  Sim_IrqSet(SIM_DMA2_STREAM0_IRQ);
+}
+
+#define CHECK(cond, ...)	do{ if(!(cond)){ u32Failures++; printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } }while(0)
+
+static uint32_t u32Failures;
+
+static uint8_t Test_Src[TEST_BUF_SIZE + 64U] __attribute__((aligned(16)));
+static uint8_t Test_Dest[TEST_BUF_SIZE + 64U] __attribute__((aligned(16)));
+static uint8_t Test_Ref[TEST_BUF_SIZE + 64U] __attribute__((aligned(16)));
+
+static volatile uint32_t Test_Callbacks;
+static volatile Return_status Test_Status;
+
+static void Test_Callback(Return_status xStatus)
+{
+  Test_Callbacks++;
+  Test_Status = xStatus;
+}
+
+/* Run till the service is idle, the CPU sleeps in between */
+static void Test_Wait(void)
+{
+  while(u8DMA_MemBusy() != 0)
+  {
+    Sim_Wfi();
+  }
+}
+
+static void Test_Fill(uint8_t *Buffer, uint32_t Size, uint32_t Seed)
+{
+  uint32_t n = 0;
+
+  for(n = 0; n < Size; n++)
+  {
+    Seed = (Seed * 1103515245U) + 12345U;
+    Buffer[n] = (uint8_t)(Seed >> 16);
+  }
+}
+
+static void Test_Copy(uint32_t Size, uint32_t DestOffset, uint32_t SrcOffset)
+{
+  uint32_t callbacks = Test_Callbacks;
+
+  Test_Fill(Test_Src, Size + 32U, Size + DestOffset);
+  memset(Test_Dest, 0xA5, Size + 32U);
+  memcpy(Test_Ref, Test_Dest, Size + 32U);
+  memcpy(Test_Ref + DestOffset, Test_Src + SrcOffset, Size);
+
+  Sim_StepOn();
+  CHECK(OK == xDMA_MemCopy(Test_Dest + DestOffset, Test_Src + SrcOffset, Size, Test_Callback),
+        "copy %lu bytes", (unsigned long)Size);
+  Test_Wait();
+  Sim_StepOff();
+
+  CHECK(0 == memcmp(Test_Dest, Test_Ref, Size + 32U), "copy of %lu bytes, offsets %lu/%lu differs",
+        (unsigned long)Size, (unsigned long)DestOffset, (unsigned long)SrcOffset);
+  CHECK((callbacks + 1U == Test_Callbacks) && (OK == Test_Status), "copy of %lu bytes: %lu callbacks, status %d",
+        (unsigned long)Size, (unsigned long)(Test_Callbacks - callbacks), (int)Test_Status);
+}
+
+static void Test_Set(uint32_t Size, uint32_t DestOffset, u8 Value)
+{
+  uint32_t callbacks = Test_Callbacks;
+
+  memset(Test_Dest, 0xA5, Size + 32U);
+  memcpy(Test_Ref, Test_Dest, Size + 32U);
+  memset(Test_Ref + DestOffset, Value, Size);
+
+  Sim_StepOn();
+  CHECK(OK == xDMA_MemSet(Test_Dest + DestOffset, Value, Size, Test_Callback), "set %lu bytes", (unsigned long)Size);
+  Test_Wait();
+  Sim_StepOff();
+
+  CHECK(0 == memcmp(Test_Dest, Test_Ref, Size + 32U), "set of %lu bytes at offset %lu differs",
+        (unsigned long)Size, (unsigned long)DestOffset);
+  CHECK((callbacks + 1U == Test_Callbacks) && (OK == Test_Status), "set of %lu bytes: %lu callbacks, status %d",
+        (unsigned long)Size, (unsigned long)(Test_Callbacks - callbacks), (int)Test_Status);
+}
+
+static void Test_Sizes(void)
+{
+  uint32_t size = 0, dest = 0, src = 0;
+
+  for(size = 1; size <= 400U; size += (size < 64U) ? 1U : 5U)
+  {
+    for(dest = 0; dest < 4U; dest++)
+    {
+      for(src = 0; src < 4U; src++)
+      {
+        Test_Copy(size, dest + ((size & 1U) << 4), src);
+      }
+      Test_Set(size, dest, (u8)size);
+    }
+  }
+
+  CHECK(Sim_Starts != 0, "no transfer reached the DMA");
+  CHECK(Sim_BurstStarts != 0, "no transfer used INCR4 bursts");
+  CHECK(Sim_Errors == 0, "%lu transfers had a bad setup", (unsigned long)Sim_Errors);
+  CHECK(Sim_RccDma2 != 0, "DMA2 clock never enabled");
+}
+
+static void Test_Chunks(void)
+{
+  uint32_t taken = Sim_IrqTaken[SIM_DMA2_STREAM0_IRQ];
+
+  /* 75000 words: 65532 + 9468 */
+  Test_Copy(300000U, 0, 0);
+  CHECK(Sim_IrqTaken[SIM_DMA2_STREAM0_IRQ] - taken == 2U, "300000 bytes in %lu chunks",
+        (unsigned long)(Sim_IrqTaken[SIM_DMA2_STREAM0_IRQ] - taken));
+
+  /* Bytes: 65532 + 65532 + 4436 */
+  taken = Sim_IrqTaken[SIM_DMA2_STREAM0_IRQ];
+  Test_Set(135501U, 1, 0x3C);
+  CHECK(Sim_IrqTaken[SIM_DMA2_STREAM0_IRQ] - taken == 3U, "135501 bytes in %lu chunks",
+        (unsigned long)(Sim_IrqTaken[SIM_DMA2_STREAM0_IRQ] - taken));
+  CHECK(Sim_Errors == 0, "%lu transfers had a bad setup", (unsigned long)Sim_Errors);
+}
+
+static void Test_Ccm(void)
+{
+  uint8_t *ccm = (uint8_t *)mmap((void *)TEST_CCM_BASE, TEST_CCM_SIZE, PROT_READ | PROT_WRITE,
+                                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+  uint32_t starts = Sim_Starts, callbacks = Test_Callbacks;
+
+  if(ccm != (uint8_t *)TEST_CCM_BASE)
+  {
+    printf("CCM RAM range not mappable, skipped\n");
+    return;
+  }
+
+  Test_Fill(Test_Src, 4096U, 7U);
+  CHECK(OK == xDMA_MemCopy(ccm + 64, Test_Src, 4096U, Test_Callback), "copy to CCM");
+  CHECK(0 == memcmp(ccm + 64, Test_Src, 4096U), "copy to CCM differs");
+  CHECK(OK == xDMA_MemCopy(Test_Dest, ccm + 64, 4096U, Test_Callback), "copy from CCM");
+  CHECK(0 == memcmp(Test_Dest, Test_Src, 4096U), "copy from CCM differs");
+  CHECK(OK == xDMA_MemSet(ccm, 0x11, 4096U, Test_Callback), "set in CCM");
+  CHECK((ccm[0] == 0x11) && (ccm[4095] == 0x11) && (ccm[4096] == Test_Src[4096U - 64U]), "set in CCM");
+  CHECK(Sim_Starts == starts, "CCM RAM buffer given to the DMA");
+  CHECK((Test_Callbacks == callbacks + 3U) && (u8DMA_MemBusy() == 0), "CPU path callbacks");
+
+  munmap(ccm, TEST_CCM_SIZE);
+}
+
+static void Test_Errors(void)
+{
+  uint32_t callbacks = Test_Callbacks;
+
+  CHECK(NULLPOINTER == xDMA_MemCopy(0, Test_Src, 256U, Test_Callback), "NULL destination");
+  CHECK(NULLPOINTER == xDMA_MemCopy(Test_Dest, 0, 256U, Test_Callback), "NULL source");
+  CHECK(NULLPOINTER == xDMA_MemSet(0, 0, 256U, Test_Callback), "NULL memset destination");
+
+  /* No stepping: the transfer stays pending */
+  CHECK(OK == xDMA_MemCopy(Test_Dest, Test_Src, 4096U, Test_Callback), "copy");
+  CHECK(u8DMA_MemBusy() != 0, "not busy after a DMA start");
+  CHECK(NOK == xDMA_MemCopy(Test_Dest, Test_Src, 4096U, Test_Callback), "second copy accepted while busy");
+  CHECK(NOK == xDMA_MemSet(Test_Dest, 0, 16U, Test_Callback), "memset accepted while busy");
+  Sim_StepOn();
+  Test_Wait();
+  Sim_StepOff();
+  CHECK((callbacks + 1U == Test_Callbacks) && (OK == Test_Status), "busy copy ended");
+
+  Sim_ForceError = 1;
+  Sim_StepOn();
+  CHECK(OK == xDMA_MemSet(Test_Dest, 0, 4096U, Test_Callback), "set");
+  Test_Wait();
+  Sim_StepOff();
+  Sim_ForceError = 0;
+  CHECK((callbacks + 2U == Test_Callbacks) && (NOK == Test_Status), "Transfer Error not reported");
+  CHECK(Sim_Reg(SIM_LISR) == 0, "LISR %08lX left after the error", (unsigned long)Sim_Reg(SIM_LISR));
+  Sim_Errors = 0;
+}
+
+/* Cycles of one call, CPU path or DMA path (time to the callback & CPU cycles in it) */
+static void Test_Measure(uint32_t Size, uint32_t Offset, int Set, uint64_t *Cpu, uint64_t *DmaTotal, uint64_t *DmaCpu)
+{
+  uint64_t start = 0, idle = 0;
+
+  Sim_Threshold = Size + 1U;
+  Sim_StepOn();
+  start = Sim_Cycles;
+  if(Set != 0)
+  {
+    (void)xDMA_MemSet(Test_Dest + Offset, 0x5A, Size, 0);
+  }
+  else
+  {
+    (void)xDMA_MemCopy(Test_Dest + Offset, Test_Src, Size, 0);
+  }
+  Sim_StepOff();
+  *Cpu = Sim_Cycles - start;
+
+  Sim_Threshold = 0;
+  Sim_StepOn();
+  start = Sim_Cycles;
+  idle = Sim_IdleCycles;
+  if(Set != 0)
+  {
+    (void)xDMA_MemSet(Test_Dest + Offset, 0x5A, Size, 0);
+  }
+  else
+  {
+    (void)xDMA_MemCopy(Test_Dest + Offset, Test_Src, Size, 0);
+  }
+  Test_Wait();
+  Sim_StepOff();
+  *DmaTotal = Sim_Cycles - start;
+  *DmaCpu = *DmaTotal - (Sim_IdleCycles - idle);
+
+  Sim_Threshold = Test_HeaderThreshold;
+}
+
+/* Smallest size (16 bytes steps) the DMA path completes before the CPU loop, CPU cycles saved there */
+static uint32_t Test_Crossover(uint32_t Offset, int Set, uint64_t *Saved)
+{
+  uint64_t cpu = 0, total = 0, busy = 0;
+  uint32_t size = 0;
+
+  for(size = 16; size <= 4096U; size += 16U)
+  {
+    Test_Measure(size, Offset, Set, &cpu, &total, &busy);
+    if(total < cpu)
+    {
+      *Saved = cpu - busy;
+      return size;
+    }
+  }
+
+  *Saved = 0;
+  return 0;
+}
+
+static void Test_Bench(void)
+{
+  static const uint32_t sizes[] = { 16, 32, 64, 128, 256, 384, 512, 1024, 4096, 16384, 65536 };
+  static const char *names[] = { "copy, aligned", "copy, dest +1", "set, aligned" };
+  uint64_t cpu = 0, total = 0, busy = 0, saved = 0;
+  uint32_t kind = 0, i = 0, cross = 0, aligned = 0;
+
+  printf("\nCycles, DMA2 alone on the bus, HCLK = CPU clock (CPU: the driver's word/byte loop)\n");
+  for(kind = 0; kind < 3U; kind++)
+  {
+    printf("%-14s %8s %10s %10s %10s %12s\n", names[kind], "bytes", "CPU", "DMA done", "DMA CPU", "B/cycle C/D");
+    for(i = 0; i < (sizeof(sizes) / sizeof(sizes[0])); i++)
+    {
+      Test_Measure(sizes[i], (kind == 1U) ? 1U : 0U, (kind == 2U) ? 1 : 0, &cpu, &total, &busy);
+      printf("%-14s %8lu %10lu %10lu %10lu %6.2f/%4.2f\n", "", (unsigned long)sizes[i], (unsigned long)cpu,
+             (unsigned long)total, (unsigned long)busy, (double)sizes[i] / (double)cpu, (double)sizes[i] / (double)total);
+    }
+
+    cross = Test_Crossover((kind == 1U) ? 1U : 0U, (kind == 2U) ? 1 : 0, &saved);
+    printf("%-14s DMA completes first from %lu bytes (%lu CPU cycles saved there)\n", "",
+           (unsigned long)cross, (unsigned long)saved);
+    if(kind == 0U)
+    {
+      aligned = cross;
+    }
+  }
+
+  /* The header threshold is the aligned copy crossover, within the model's spread */
+  printf("DMA_MEM_CPU_THRESHOLD %lu\n", (unsigned long)Test_HeaderThreshold);
+  CHECK((aligned != 0) && (Test_HeaderThreshold >= ((aligned * 3U) / 4U)) && (Test_HeaderThreshold <= ((aligned * 5U) / 4U)),
+        "DMA_MEM_CPU_THRESHOLD %lu, aligned copy crossover %lu", (unsigned long)Test_HeaderThreshold, (unsigned long)aligned);
+}
+
+int main(void)
+{
+  if((Sim_MapBlock((uint32_t)(uintptr_t)DMA2, sizeof(DMA_Main)) != 0)
+     || (Sim_MapBlock((uint32_t)(uintptr_t)&DMA_NVIC_ISER1, 4U) != 0))
+  {
+    printf("DMA2 / NVIC addresses not free, build with -no-pie\n");
+    return 1;
+  }
+  Sim_CpuStart();
+  Sim_IrqConnect(SIM_DMA2_STREAM0_IRQ, DMA2_Stream0_IRQHandler, 0);
+
+  Test_Sizes();
+  Test_Chunks();
+  Test_Ccm();
+  Test_Errors();
+  Test_Bench();
+
+  printf("%s (%lu failures)\n", (u32Failures == 0) ? "PASS" : "FAIL", (unsigned long)u32Failures);
+  return (u32Failures == 0) ? 0 : 1;
+}
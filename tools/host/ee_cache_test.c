@@ -0,0 +1,324 @@
+/*
+ * ee_cache_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ *
+ *  Host test & benchmark of the EEPROM page cache (stm32f429i_discovery_i2c_ee_cache.c)
+ *  over the I2C queue model of i2cm_sim.h & a 24xx64 EEPROM
+ *  - The EEPROM doesn't acknowledge its address for SIM_EE_WRITE_US after a page write
+ *  - Random writes, reads & idle time against a shadow copy: reads always return
+ *    the last data written, the EEPROM matches the shadow after sEE_CacheFlush
+ *  - Writes to a page being programmed are coalesced into one more write cycle
+ *  - Every line dirty: the next page waits for a line to be written back
+ *  - EEPROM not answering: write-back & flush fail, the data stays dirty and
+ *    lands with the next flush once the EEPROM answers
+ *  - Benchmark, a settings write every millisecond: EEPROM write cycles & bus
+ *    time the caller waits, sEE_CacheWrite vs sEE_WriteBuffer
+ *
+ *  Build & run from tools/host:
+ *  gcc -O2 -Wall -DSTM32F42_43xxx -DUSE_STDPERIPH_DRIVER -I../../Utilities/STM32F429I-Discovery \
+ *      -I../../Libraries/CMSIS/Include -I../../Libraries/Device/ST/STM32F4xx/Include \
+ *      -I../../Libraries/STM32F4xx_StdPeriph_Driver/inc -I../../src ee_cache_test.c \
+ *      -o ee_cache_test && ./ee_cache_test
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stm32f429i_discovery_i2c_ee_cache.h"
+#include "i2cm_sim.h"
+
+/* 24xx64: 8 KB, tWR 5 ms */
+#define SIM_EE_SIZE				(8192U)
+#define SIM_EE_WRITE_US			(5000U)
+
+#define TEST_OPS				(3000U)
+#define TEST_SPAN				(256U)
+#define TEST_BENCH_WRITES		(200U)
+#define TEST_BENCH_PERIOD_US	(1000U)
+
+static uint8_t Sim_Ee[SIM_EE_SIZE];
+static uint32_t Sim_EeBusyUntil;
+static volatile uint32_t Sim_EeCycles;
+/* Set: the EEPROM acknowledges nothing (unpowered, wrong address) */
+static volatile uint32_t Sim_EeStuck;
+static volatile uint32_t Sim_Timeouts;
+
+/* Spin counts are sized for the target; a modeled transaction takes a whole tick */
+#undef sEE_LONG_TIMEOUT
+#define sEE_LONG_TIMEOUT		((uint32_t)0x40000000)
+#undef sEE_CACHE_TIMEOUT
+#define sEE_CACHE_TIMEOUT		((uint32_t)0x40000000)
+
+uint32_t sEE_TIMEOUT_UserCallback(void)
+{
+  Sim_Timeouts++;
+  return sEE_FAIL;
+}
+
+/* The EEPROM side of one transaction, returns its status */
+static uint8_t Sim_I2cSlave(const I2CM_Transfer *Xfer)
+{
+  uint16_t address = Xfer->Register, page = 0, n = 0;
+
+  /* Device address, not acknowledged during a write cycle */
+  Sim_Now += SIM_BYTE_US;
+
+  if((Sim_EeStuck != 0) || (Xfer->Address != sEE_HW_ADDRESS) || (Sim_Now < Sim_EeBusyUntil))
+  {
+    return I2CM_NACK;
+  }
+
+  /* Memory address, a read adds the repeated start device address */
+  Sim_Now += SIM_BYTE_US * (Xfer->RegSize + Xfer->Length + ((Xfer->Direction == I2CM_DIR_READ) ? 1U : 0U));
+
+  if(Xfer->Direction == I2CM_DIR_READ)
+  {
+    for(n = 0; n < Xfer->Length; n++)
+    {
+      Xfer->Buffer[n] = Sim_Ee[(address + n) % SIM_EE_SIZE];
+    }
+  }
+  else if(Xfer->Length != 0)
+  {
+    /* The address counter rolls over within the page */
+    page = (uint16_t)((address % SIM_EE_SIZE) - (address % sEE_PAGESIZE));
+    for(n = 0; n < Xfer->Length; n++)
+    {
+      Sim_Ee[page + ((address + n) % sEE_PAGESIZE)] = Xfer->Buffer[n];
+    }
+
+    Sim_EeBusyUntil = Sim_Now + SIM_EE_WRITE_US;
+    Sim_EeCycles++;
+  }
+
+  return I2CM_OK;
+}
+
+/* Nothing else interrupts */
+static void Sim_TickHook(void)
+{
+}
+
+#include "../../Utilities/STM32F429I-Discovery/stm32f429i_discovery_i2c_ee.c"
+#include "../../Utilities/STM32F429I-Discovery/stm32f429i_discovery_i2c_ee_cache.c"
+
+static uint32_t u32Failures;
+
+#define CHECK(cond, ...)	do{ if(!(cond)){ u32Failures++; printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } }while(0)
+
+/* What the EEPROM holds once every write has landed */
+static uint8_t Shadow[SIM_EE_SIZE];
+
+static void vidFillEeprom(void)
+{
+  uint32_t i = 0;
+
+  for(i = 0; i < SIM_EE_SIZE; i++)
+  {
+    Sim_Ee[i] = (uint8_t)rand();
+  }
+  memcpy(Shadow, Sim_Ee, SIM_EE_SIZE);
+  Sim_EeBusyUntil = 0;
+}
+
+static void vidTestRandom(void)
+{
+  sEE_CacheStatsTypeDef stats;
+  uint8_t data[3 * sEE_PAGESIZE], read[3 * sEE_PAGESIZE];
+  uint32_t op = 0, i = 0, bad = 0;
+  uint16_t address = 0, length = 0;
+
+  vidFillEeprom();
+  sEE_CacheInit();
+
+  for(op = 0; op < TEST_OPS; op++)
+  {
+    /* Up to 3 pages, anywhere in a span of more pages than lines */
+    length = (uint16_t)(1U + (rand() % sizeof(data)));
+    address = (uint16_t)(rand() % (TEST_SPAN - length));
+
+    if((rand() % 2) == 0)
+    {
+      for(i = 0; i < length; i++)
+      {
+        data[i] = (uint8_t)rand();
+      }
+      memcpy(&Shadow[address], data, length);
+      CHECK(sEE_OK == sEE_CacheWrite(data, address, length), "write %u bytes at %u", length, address);
+    }
+    else
+    {
+      CHECK(sEE_OK == sEE_CacheRead(read, address, length), "read %u bytes at %u", length, address);
+      bad += (memcmp(read, &Shadow[address], length) != 0) ? 1U : 0U;
+    }
+
+    /* Back to back, or with the EEPROM left time to program */
+    if((rand() % 4) == 0)
+    {
+      Sim_Elapse((uint32_t)(rand() % (2U * SIM_EE_WRITE_US)));
+    }
+  }
+
+  CHECK(0 == bad, "%lu reads differ from the data written", (unsigned long)bad);
+  CHECK(sEE_OK == sEE_CacheFlush(), "flush");
+  CHECK(0 == memcmp(Sim_Ee, Shadow, SIM_EE_SIZE), "EEPROM differs from the data written after the flush");
+
+  sEE_CacheGetStats(&stats);
+  CHECK(0 == stats.Errors, "%lu errors", (unsigned long)stats.Errors);
+  CHECK((stats.Hits != 0) && (stats.Fills != 0), "%lu hits, %lu fills", (unsigned long)stats.Hits, (unsigned long)stats.Fills);
+  CHECK(stats.PageWrites == Sim_EeCycles, "%lu page writes counted, %lu made", (unsigned long)stats.PageWrites, (unsigned long)Sim_EeCycles);
+}
+
+static void vidTestCoalesce(void)
+{
+  sEE_CacheStatsTypeDef stats;
+  uint8_t data[sEE_PAGESIZE];
+  uint32_t i = 0;
+
+  vidFillEeprom();
+  sEE_CacheInit();
+  Sim_EeCycles = 0;
+
+  /* The first write starts a cycle, the others wait for it in the line */
+  for(i = 0; i < 50U; i++)
+  {
+    memset(data, (int)i, sizeof(data));
+    CHECK(sEE_OK == sEE_CacheWrite(data, 64, sizeof(data)), "write %lu", (unsigned long)i);
+  }
+  memcpy(&Shadow[64], data, sizeof(data));
+
+  CHECK(sEE_OK == sEE_CacheFlush(), "flush");
+  sEE_CacheGetStats(&stats);
+  CHECK(50U == stats.Writes, "%lu writes", (unsigned long)stats.Writes);
+  CHECK(stats.PageWrites <= 2U, "50 writes to a page took %lu write cycles", (unsigned long)stats.PageWrites);
+  CHECK(0 == memcmp(Sim_Ee, Shadow, SIM_EE_SIZE), "EEPROM misses the last write");
+}
+
+static void vidTestAllDirty(void)
+{
+  sEE_CacheStatsTypeDef stats;
+  uint8_t data = 0;
+  uint32_t i = 0;
+
+  vidFillEeprom();
+  sEE_CacheInit();
+
+  /* Twice as many pages as lines, no time left to write back */
+  for(i = 0; i < (2U * sEE_CACHE_LINES); i++)
+  {
+    data = (uint8_t)(0xA0U + i);
+    Shadow[(i * sEE_PAGESIZE) + 1U] = data;
+    CHECK(sEE_OK == sEE_CacheWrite(&data, (uint16_t)((i * sEE_PAGESIZE) + 1U), 1), "write to page %lu", (unsigned long)i);
+  }
+
+  CHECK(sEE_OK == sEE_CacheFlush(), "flush");
+  sEE_CacheGetStats(&stats);
+  CHECK(0 == stats.Errors, "%lu errors", (unsigned long)stats.Errors);
+  CHECK(0 == memcmp(Sim_Ee, Shadow, SIM_EE_SIZE), "EEPROM differs after the flush");
+}
+
+static void vidTestNoAnswer(void)
+{
+  sEE_CacheStatsTypeDef stats;
+  uint8_t data[2] = {0x5A, 0xA5}, read[2] = {0, 0};
+
+  vidFillEeprom();
+  sEE_CacheInit();
+
+  /* The page is cached by a write while the EEPROM answers, then it goes away */
+  memcpy(&Shadow[130], data, sizeof(data));
+  CHECK(sEE_OK == sEE_CacheWrite(data, 130, 2), "write");
+  CHECK(sEE_OK == sEE_CacheFlush(), "flush");
+  Sim_EeStuck = 1;
+
+  CHECK(sEE_OK == sEE_CacheWrite(data, 128, 2), "write to a cached page");
+  CHECK(sEE_FAIL == sEE_CacheFlush(), "flush with no EEPROM");
+  CHECK(sEE_FAIL == sEE_CacheRead(read, 1024, 2), "read of an uncached page with no EEPROM");
+  CHECK(sEE_OK == sEE_CacheRead(read, 128, 2), "read of the cached page");
+  CHECK((read[0] == data[0]) && (read[1] == data[1]), "cached page lost the write");
+
+  sEE_CacheGetStats(&stats);
+  CHECK(0 != stats.Errors, "no error counted");
+
+  Sim_EeStuck = 0;
+  memcpy(&Shadow[128], data, sizeof(data));
+  CHECK(sEE_OK == sEE_CacheFlush(), "flush once the EEPROM answers");
+  CHECK(0 == memcmp(Sim_Ee, Shadow, SIM_EE_SIZE), "write lost by the failed flush");
+}
+
+/* A settings block of 4 counters over 2 pages, one updated every millisecond */
+static void vidBenchmark(void)
+{
+  uint32_t i = 0, start = 0, cycles[2] = {0, 0}, waited[2] = {0, 0}, total[2] = {0, 0};
+  uint8_t data[2];
+  uint16_t address = 0;
+  uint8_t cached = 0;
+
+  for(cached = 0; cached < 2U; cached++)
+  {
+    vidFillEeprom();
+    sEE_CacheInit();
+    Sim_EeCycles = 0;
+    total[cached] = Sim_Now;
+
+    for(i = 0; i < TEST_BENCH_WRITES; i++)
+    {
+      address = (uint16_t)(512U + (2U * (i % 4U)));
+      data[0] = (uint8_t)i;
+      data[1] = (uint8_t)(i >> 8);
+      memcpy(&Shadow[address], data, sizeof(data));
+
+      start = Sim_Now;
+      if(cached != 0)
+      {
+        CHECK(sEE_OK == sEE_CacheWrite(data, address, sizeof(data)), "write %lu", (unsigned long)i);
+      }
+      else
+      {
+        sEE_WriteBuffer(data, address, sizeof(data));
+      }
+      waited[cached] += Sim_Now - start;
+
+      Sim_Elapse(TEST_BENCH_PERIOD_US);
+    }
+
+    if(cached != 0)
+    {
+      CHECK(sEE_OK == sEE_CacheFlush(), "flush");
+    }
+
+    cycles[cached] = Sim_EeCycles;
+    total[cached] = Sim_Now - total[cached];
+    CHECK(0 == memcmp(Sim_Ee, Shadow, SIM_EE_SIZE), "EEPROM differs after the %s run", (cached != 0) ? "cached" : "uncached");
+  }
+
+  CHECK(0 == Sim_Timeouts, "%lu sEE timeouts", (unsigned long)Sim_Timeouts);
+
+  printf("%u settings writes, one per %u us: sEE_WriteBuffer %lu write cycles & %lu us bus time waited per write (%lu ms total), "
+         "sEE_CacheWrite %lu write cycles & %lu us waited per write (%lu ms total with the flush)\n",
+         TEST_BENCH_WRITES, TEST_BENCH_PERIOD_US,
+         (unsigned long)cycles[0], (unsigned long)(waited[0] / TEST_BENCH_WRITES), (unsigned long)(total[0] / 1000U),
+         (unsigned long)cycles[1], (unsigned long)(waited[1] / TEST_BENCH_WRITES), (unsigned long)(total[1] / 1000U));
+}
+
+int main(void)
+{
+  Sim_Start();
+
+  vidTestRandom();
+  vidTestCoalesce();
+  vidTestAllDirty();
+  vidTestNoAnswer();
+  vidBenchmark();
+
+  Sim_Stop();
+
+  CHECK(0 == Sim_Resets, "%lu bus resets", (unsigned long)Sim_Resets);
+
+  printf("%s (%lu failures)\n", (0 == u32Failures) ? "PASS" : "FAIL", (unsigned long)u32Failures);
+
+  return (0 == u32Failures) ? 0 : 1;
+}
@@ -0,0 +1,484 @@
+/*
+ * fill_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ *
+ *  Host test & benchmark of the LCD span fills (stm32f429i_discovery_lcd.c)
+ *  over the DMA2D model of dma2d_sim.h
+ *  - LCD_FillPolyLine & LCD_FillTriangle fill pixel for pixel the rows of a
+ *    scanline reference (crossings of every edge computed per row, rounded
+ *    like the 16.16 steps): rectangle, triangle, self crossing star
+ *    (even-odd hole), polygon reaching out of the screen (negative X)
+ *  - Above LCD_POLY_MAX_EDGES points only the LCD_ClosedPolyLine outline is drawn
+ *  - LCD_DrawFullCircle is the disk x^2 + y^2 <= R^2 + R & the LCD_DrawCircle outline
+ *  - LCD_DrawFullEllipse is the ellipse x^2 R2^2 + y^2 R^2 <= (R R2)^2 (1 + 1 / max(R, R2))
+ *    (same half pixel margin as the circle), a regular 16-gon the scanline reference
+ *  - Cost of one shape: DMA2D transfers, spans vs the old line/pixel fills
+ *  - Fills per second of circle, ellipse & 16-gon: CPU span time measured on the
+ *    host (Sim_Dma2dFast, a full queue doesn't wait for the tick) plus the DMA2D
+ *    time of the fills (cost model of dma2d_sim.h), as if they never overlapped
+ *
+ *  Build & run from tools/host:
+ *  gcc -O2 -Wall -no-pie -DSTM32F42_43xxx -DUSE_STDPERIPH_DRIVER -I../../Utilities/STM32F429I-Discovery \
+ *      -I../../Libraries/CMSIS/Include -I../../Libraries/Device/ST/STM32F4xx/Include \
+ *      -I../../Libraries/STM32F4xx_StdPeriph_Driver/inc -I../../src fill_test.c ../../Utilities/Common/fonts.c \
+ *      -lm -o fill_test && ./fill_test
+ */
+
+#include <stdio.h>
+#include <math.h>
+
+#include "lcd_sim.h"
+#include "../../Utilities/STM32F429I-Discovery/stm32f429i_discovery_dma2d.c"
+#include "../../Utilities/STM32F429I-Discovery/stm32f429i_discovery_lcd.c"
+
+#define TEST_COLOR				((uint16_t)0xFFE0)
+#define TEST_BACK_COLOR			((uint16_t)0x0010)
+#define TEST_OUTLINE_POINTS		(40U)
+#define TEST_BENCH_SHAPES		(4U)
+#define TEST_BENCH_FILLS		(200U)
+
+static uint32_t u32Failures;
+
+#define CHECK(cond, ...)	do{ if(!(cond)){ u32Failures++; printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } }while(0)
+
+static uint16_t Expected[LCD_PIXEL_WIDTH * LCD_PIXEL_HEIGHT];
+
+static uint16_t *Frame(void)
+{
+  return (uint16_t *)(uintptr_t)LCD_FRAME_BUFFER;
+}
+
+static void vidClear(void)
+{
+  uint32_t i = 0;
+
+  LCD_Clear(TEST_BACK_COLOR);
+  GFX_Wait();
+
+  for(i = 0; i < (LCD_PIXEL_WIDTH * LCD_PIXEL_HEIGHT); i++)
+  {
+    Expected[i] = TEST_BACK_COLOR;
+  }
+}
+
+static uint32_t u32FrameDiffs(void)
+{
+  uint32_t i = 0, diffs = 0;
+
+  GFX_Wait();
+
+  for(i = 0; i < (LCD_PIXEL_WIDTH * LCD_PIXEL_HEIGHT); i++)
+  {
+    diffs += (Frame()[i] != Expected[i]) ? 1U : 0U;
+  }
+
+  return diffs;
+}
+
+static void vidRefPixel(int32_t X, int32_t Y)
+{
+  if((X >= 0) && (X < LCD_PIXEL_WIDTH) && (Y >= 0) && (Y < LCD_PIXEL_HEIGHT))
+  {
+    Expected[(Y * LCD_PIXEL_WIDTH) + X] = TEST_COLOR;
+  }
+}
+
+/* Even-odd scanline fill: each edge crosses row y (top row in, bottom row out) at its X rounded to the pixel,
+   X on row y is the top X plus y steps of the 16.16 slope (truncated, so a tie may round down) */
+static void vidRefPolygon(const Point *Points, uint32_t Count)
+{
+  int32_t y = 0, x = 0, cross[TEST_OUTLINE_POINTS], t = 0;
+  int64_t slope = 0;
+  uint32_t i = 0, j = 0, n = 0;
+  const Point *p0 = 0, *p1 = 0;
+
+  for(y = -LCD_PIXEL_HEIGHT; y < (2 * LCD_PIXEL_HEIGHT); y++)
+  {
+    n = 0;
+    for(i = 0; i < Count; i++)
+    {
+      p0 = &Points[i];
+      p1 = &Points[(i + 1) % Count];
+      if(p0->Y > p1->Y)
+      {
+        p0 = p1;
+        p1 = &Points[i];
+      }
+      if((p0->Y <= y) && (y < p1->Y))
+      {
+        slope = ((int64_t)(p1->X - p0->X) * 65536) / (p1->Y - p0->Y);
+        cross[n++] = (int32_t)floor((((double)p0->X * 65536) + 0x8000 + ((double)(y - p0->Y) * slope)) / 65536);
+      }
+    }
+
+    for(i = 1; i < n; i++)
+    {
+      for(j = i; (j > 0) && (cross[j - 1] > cross[j]); j--)
+      {
+        t = cross[j];
+        cross[j] = cross[j - 1];
+        cross[j - 1] = t;
+      }
+    }
+
+    for(i = 0; (i + 1) < n; i += 2)
+    {
+      for(x = cross[i]; x <= cross[i + 1]; x++)
+      {
+        vidRefPixel(x, y);
+      }
+    }
+  }
+}
+
+/* Regular polygon of Count corners, radius Radius around (120, 160) */
+static void vidRegularPolygon(Point *Points, uint32_t Count, int32_t Radius)
+{
+  uint32_t i = 0;
+
+  for(i = 0; i < Count; i++)
+  {
+    Points[i].X = (int16_t)(120 + (int32_t)lround(Radius * cos((2 * M_PI * i) / Count)));
+    Points[i].Y = (int16_t)(160 + (int32_t)lround(Radius * sin((2 * M_PI * i) / Count)));
+  }
+}
+
+static void vidTestPolygon(const char *Name, Point *Points, uint32_t Count)
+{
+  uint32_t diffs = 0;
+
+  vidClear();
+  LCD_FillPolyLine(Points, (uint16_t)Count);
+  vidRefPolygon(Points, Count);
+  diffs = u32FrameDiffs();
+
+  CHECK(0 == diffs, "%s: %lu pixels differ from the scanline reference", Name, (unsigned long)diffs);
+}
+
+static void vidTestPolygons(void)
+{
+  Point rectangle[] = {{20, 30}, {120, 30}, {120, 90}, {20, 90}};
+  Point triangle[] = {{10, 20}, {200, 80}, {60, 300}};
+  Point star[] = {{120, 20}, {180, 240}, {20, 100}, {220, 100}, {60, 240}};
+  Point outside[] = {{-40, 100}, {100, 50}, {300, 180}, {60, 360}};
+  Point outline[TEST_OUTLINE_POINTS];
+  uint32_t i = 0, diffs = 0;
+
+  LCD_SetTextColor(TEST_COLOR);
+
+  vidTestPolygon("rectangle", rectangle, 4);
+  vidTestPolygon("star", star, 5);
+  vidTestPolygon("polygon out of the screen", outside, 4);
+  vidRegularPolygon(outline, 16, 100);
+  vidTestPolygon("16-gon", outline, 16);
+
+  /* Triangle corners passed as x1, x2, x3, y1, y2, y3 */
+  vidClear();
+  LCD_FillTriangle(10, 200, 60, 20, 80, 300);
+  vidRefPolygon(triangle, 3);
+  diffs = u32FrameDiffs();
+  CHECK(0 == diffs, "triangle: %lu pixels differ from the scanline reference", (unsigned long)diffs);
+
+  /* Even-odd: the center of the star is a hole */
+  vidClear();
+  LCD_FillPolyLine(star, 5);
+  GFX_Wait();
+  CHECK(TEST_BACK_COLOR == Frame()[(140 * LCD_PIXEL_WIDTH) + 120], "star center filled");
+
+  /* Too many points for the edge table: the outline, not a part of the polygon */
+  vidRegularPolygon(outline, TEST_OUTLINE_POINTS, 80);
+
+  vidClear();
+  LCD_ClosedPolyLine(outline, TEST_OUTLINE_POINTS);
+  GFX_Wait();
+  memcpy(Expected, Frame(), sizeof(Expected));
+
+  LCD_Clear(TEST_BACK_COLOR);
+  LCD_FillPolyLine(outline, TEST_OUTLINE_POINTS);
+  GFX_Wait();
+  diffs = 0;
+  for(i = 0; i < (LCD_PIXEL_WIDTH * LCD_PIXEL_HEIGHT); i++)
+  {
+    diffs += (Frame()[i] != Expected[i]) ? 1U : 0U;
+  }
+  CHECK(0 == diffs, "%u points: %lu pixels differ from the outline", TEST_OUTLINE_POINTS, (unsigned long)diffs);
+  CHECK(TEST_BACK_COLOR == Frame()[(160 * LCD_PIXEL_WIDTH) + 120], "%u points: inside filled", TEST_OUTLINE_POINTS);
+}
+
+static void vidTestCircles(void)
+{
+  int32_t radius = 0, x = 0, y = 0;
+  uint32_t diffs = 0;
+
+  LCD_SetTextColor(TEST_COLOR);
+
+  for(radius = 1; radius <= 100; radius += 3)
+  {
+    /* Reference: LCD_DrawCircle outline, then the disk */
+    vidClear();
+    LCD_DrawCircle(120, 160, (uint16_t)radius);
+    GFX_Wait();
+    memcpy(Expected, Frame(), sizeof(Expected));
+
+    for(y = -radius; y <= radius; y++)
+    {
+      for(x = -radius; x <= radius; x++)
+      {
+        if(((x * x) + (y * y)) <= ((radius * radius) + radius))
+        {
+          vidRefPixel(120 + x, 160 + y);
+        }
+      }
+    }
+
+    LCD_Clear(TEST_BACK_COLOR);
+    LCD_DrawFullCircle(120, 160, (uint16_t)radius);
+    diffs += u32FrameDiffs();
+  }
+
+  CHECK(0 == diffs, "full circles: %lu pixels differ from disk & outline", (unsigned long)diffs);
+}
+
+static void vidTestEllipses(void)
+{
+  int32_t radius = 0, radius2 = 0, x = 0, y = 0;
+  int64_t a2 = 0, b2 = 0, limit = 0;
+  uint32_t diffs = 0;
+
+  LCD_SetTextColor(TEST_COLOR);
+
+  for(radius = 1; radius <= 110; radius += 7)
+  {
+    for(radius2 = 1; radius2 <= 150; radius2 += 11)
+    {
+      /* Reference: every pixel of the ellipse with the circle's half pixel margin */
+      vidClear();
+      a2 = (int64_t)radius * radius;
+      b2 = (int64_t)radius2 * radius2;
+      limit = (a2 * b2) + ((a2 * b2) / ((radius > radius2) ? radius : radius2));
+      for(y = -radius2; y <= radius2; y++)
+      {
+        for(x = -radius; x <= radius; x++)
+        {
+          if((((int64_t)x * x * b2) + ((int64_t)y * y * a2)) <= limit)
+          {
+            vidRefPixel(120 + x, 160 + y);
+          }
+        }
+      }
+
+      LCD_DrawFullEllipse(120, 160, radius, radius2);
+      diffs += u32FrameDiffs();
+    }
+  }
+
+  CHECK(0 == diffs, "full ellipses: %lu pixels differ from the reference", (unsigned long)diffs);
+}
+
+/* LCD_DrawFullCircle before the spans: vertical lines, then the outline */
+static void vidOldFullCircle(uint16_t Xpos, uint16_t Ypos, uint16_t Radius)
+{
+  int32_t  D;
+  uint32_t  CurX;
+  uint32_t  CurY;
+
+  D = 3 - (Radius << 1);
+
+  CurX = 0;
+  CurY = Radius;
+
+  while (CurX <= CurY)
+  {
+    if(CurY > 0)
+    {
+      LCD_DrawLine(Xpos - CurX, Ypos - CurY, 2*CurY, LCD_DIR_VERTICAL);
+      LCD_DrawLine(Xpos + CurX, Ypos - CurY, 2*CurY, LCD_DIR_VERTICAL);
+    }
+
+    if(CurX > 0)
+    {
+      LCD_DrawLine(Xpos - CurY, Ypos - CurX, 2*CurX, LCD_DIR_VERTICAL);
+      LCD_DrawLine(Xpos + CurY, Ypos - CurX, 2*CurX, LCD_DIR_VERTICAL);
+    }
+    if (D < 0)
+    {
+      D += (CurX << 2) + 6;
+    }
+    else
+    {
+      D += ((CurX - CurY) << 2) + 10;
+      CurY--;
+    }
+    CurX++;
+  }
+
+  LCD_DrawCircle(Xpos, Ypos, Radius);
+}
+
+/* LCD_FillTriangle before the spans: a line from every pixel of side 1-2 to corner 3 */
+static void vidOldFillTriangle(uint16_t x1, uint16_t x2, uint16_t x3, uint16_t y1, uint16_t y2, uint16_t y3)
+{
+  int16_t deltax = 0, deltay = 0, x = 0, y = 0, xinc1 = 0, xinc2 = 0,
+  yinc1 = 0, yinc2 = 0, den = 0, num = 0, numadd = 0, numpixels = 0,
+  curpixel = 0;
+
+  deltax = ABS(x2 - x1);
+  deltay = ABS(y2 - y1);
+  x = x1;
+  y = y1;
+
+  xinc1 = xinc2 = (x2 >= x1) ? 1 : -1;
+  yinc1 = yinc2 = (y2 >= y1) ? 1 : -1;
+
+  if (deltax >= deltay)
+  {
+    xinc1 = 0;
+    yinc2 = 0;
+    den = deltax;
+    num = deltax / 2;
+    numadd = deltay;
+    numpixels = deltax;
+  }
+  else
+  {
+    xinc2 = 0;
+    yinc1 = 0;
+    den = deltay;
+    num = deltay / 2;
+    numadd = deltax;
+    numpixels = deltay;
+  }
+
+  for (curpixel = 0; curpixel <= numpixels; curpixel++)
+  {
+    LCD_DrawUniLine(x, y, x3, y3);
+
+    num += numadd;
+    if (num >= den)
+    {
+      num -= den;
+      x += xinc1;
+      y += yinc1;
+    }
+    x += xinc2;
+    y += yinc2;
+  }
+}
+
+static void vidBenchmark(void)
+{
+  uint32_t i = 0, shape = 0, transfers[2][2] = {{0, 0}, {0, 0}};
+
+  LCD_SetTextColor(TEST_COLOR);
+
+  for(i = 0; i < TEST_BENCH_SHAPES; i++)
+  {
+    for(shape = 0; shape < 2; shape++)
+    {
+      GFX_Wait();
+      transfers[shape][0] -= Sim_Transfers;
+      (shape == 0) ? vidOldFullCircle(120, 160, 60) : vidOldFillTriangle(20, 220, 80, 40, 100, 300);
+      GFX_Wait();
+      transfers[shape][0] += Sim_Transfers;
+
+      transfers[shape][1] -= Sim_Transfers;
+      (shape == 0) ? LCD_DrawFullCircle(120, 160, 60) : LCD_FillTriangle(20, 220, 80, 40, 100, 300);
+      GFX_Wait();
+      transfers[shape][1] += Sim_Transfers;
+    }
+  }
+
+  for(shape = 0; shape < 2; shape++)
+  {
+    printf("%s: old fill %lu DMA2D transfers, spans %lu DMA2D transfers\n",
+           (shape == 0) ? "full circle R60" : "triangle 200x260",
+           (unsigned long)(transfers[shape][0] / TEST_BENCH_SHAPES), (unsigned long)(transfers[shape][1] / TEST_BENCH_SHAPES));
+  }
+}
+
+static Point Gon16[16];
+
+static void vidFillCircle(void)
+{
+  LCD_DrawFullCircle(120, 160, 60);
+}
+
+static void vidFillOldCircle(void)
+{
+  vidOldFullCircle(120, 160, 60);
+}
+
+static void vidFillEllipse(void)
+{
+  LCD_DrawFullEllipse(120, 160, 80, 50);
+}
+
+static void vidFill16Gon(void)
+{
+  LCD_FillPolyLine(Gon16, 16);
+}
+
+/* Fills per second of one shape: CPU time measured, DMA2D time modeled, one after the other */
+static void vidBenchFills(const char *Name, void (*Fill)(void))
+{
+  uint32_t i = 0;
+  uint64_t cycles = 0;
+  double start = 0, cpu = 0, dma = 0;
+
+  for(i = 0; i < TEST_BENCH_FILLS; i++)
+  {
+    GFX_Wait();
+    cycles = Sim_Dma2dCycles;
+    start = Sim_CpuNow();
+    Fill();
+    cpu += Sim_CpuNow() - start;
+    GFX_Wait();
+    dma += Sim_Dma2dUs(Sim_Dma2dCycles - cycles);
+  }
+  cpu = (cpu * 1e6) / TEST_BENCH_FILLS;
+  dma /= TEST_BENCH_FILLS;
+
+  printf("%s: %.1f us CPU spans (host) + %.1f us DMA2D = %.0f fills/s\n", Name, cpu, dma, 1e6 / (cpu + dma));
+
+  CHECK(0 == GFX_GetErrors(), "%s: %lu DMA2D errors", Name, (unsigned long)GFX_GetErrors());
+}
+
+static void vidBenchRates(void)
+{
+  LCD_SetTextColor(TEST_COLOR);
+  vidRegularPolygon(Gon16, 16, 100);
+
+  Sim_Dma2dFast = 1;
+  vidBenchFills("full circle R60, old fill", vidFillOldCircle);
+  vidBenchFills("full circle R60, spans", vidFillCircle);
+  vidBenchFills("full ellipse 80x50, spans", vidFillEllipse);
+  vidBenchFills("16-gon R100, spans", vidFill16Gon);
+  Sim_Dma2dFast = 0;
+}
+
+int main(void)
+{
+  if(Sim_Start() == 0)
+  {
+    printf("FAIL: SDRAM can't be mapped at 0x%08lX\n", (unsigned long)SIM_SDRAM_BASE);
+    return 1;
+  }
+
+  GFX_Init();
+  LCD_SetLayer(LCD_BACKGROUND_LAYER);
+
+  vidTestPolygons();
+  vidTestCircles();
+  vidTestEllipses();
+  CHECK(0 == GFX_GetErrors(), "%lu DMA2D errors", (unsigned long)GFX_GetErrors());
+  vidBenchmark();
+  vidBenchRates();
+
+  Sim_Stop();
+
+  printf("%s (%lu failures)\n", (0 == u32Failures) ? "PASS" : "FAIL", (unsigned long)u32Failures);
+
+  return (0 == u32Failures) ? 0 : 1;
+}
@@ -0,0 +1,666 @@
+/*
+ * fls_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ *
+ *  Host test of the AUTOSAR Fls Driver (AUTOSAR/Fls) over a model of the STM32F429
+ *  FLASH interface, one Fls_MainFunction call per FLS_MAIN_FUNCTION_PERIOD_MS as
+ *  the Fls Task of src/main.c makes them
+ *  - The Fls area & the FLASH registers are mapped at their target addresses read
+ *    only: every store of the driver traps, is single stepped & applied the way the
+ *    hardware does it: KEYR unlock sequence, SR errors write 1 to clear, CR ignored
+ *    while locked or busy, programming only clears bits & needs PG (else PGSERR),
+ *    STRT + SER erases the SNB sector for Sim_EraseMs with BSY set
+ *  - Requests with a wrong address/length are refused, a busy driver refuses jobs
+ *  - Erase of the whole area: only its sectors are erased, the Flash is locked and
+ *    the Data Cache back on when the job ends
+ *  - Write from an unaligned buffer across the sector boundary, read back, compare
+ *  - Programming not erased Flash & a bit that doesn't erase fail their verification
+ *  - Erase timeout is time: an erase of FLS_ERASE_TIMEOUT_MS passes, a longer one
+ *    fails FLS_ERASE_TIMEOUT_MS after it started; the Flash is locked once it ends
+ *  - Cancel during an erase: Fls_GetStatus stays busy till the Flash is locked,
+ *    the next Write waits for the erase, CR is never written while busy
+ *  - The job start notification is called once per accepted job
+ *
+ *  The store trap sets the x86 Trap Flag, x86-64 Linux only.
+ *
+ *  Build & run from tools/host:
+ *  gcc -O2 -Wall -Wno-int-to-pointer-cast -I../../AUTOSAR/Fls -I../../AUTOSAR/Common_Includes \
+ *      -I../../AUTOSAR/Det -I../../Drivers/DWT -I../../Drivers/STD_and_MATH fls_test.c \
+ *      -o fls_test && ./fls_test
+ */
+
+#define _GNU_SOURCE
+#include <signal.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+
+#if !defined(__x86_64__) || !defined(__linux__)
+#error "The FLASH model single steps the driver's stores, x86-64 Linux only"
+#endif
+
+/*
+ * Platform_Types.h takes uint32 as unsigned long, 64 bit on this host: FLASH_REG and
+ * the programmed unit need 32 bits, these types are used instead (same include guard)
+ */
+#define PLATFORM_TYPES_H
+#define STM32F429
+#define FALSE					(0u)
+#define TRUE					(1u)
+typedef unsigned char			boolean;
+typedef unsigned char			uint8;
+typedef signed char				sint8;
+typedef unsigned short			uint16;
+typedef signed short			sint16;
+typedef unsigned int			uint32;
+typedef signed int				sint32;
+typedef unsigned long long		uint64;
+typedef signed long long		sint64;
+typedef float					float32;
+typedef double					float64;
+
+#include "Fls.h"
+#include "Fls_Reg.h"
+#include "Det.h"
+#include "STD_TYPES_OLD.h"
+#include "DWT_Reg.h"
+
+/* u32DWT_GetCycles is inline: the Cycle Counter moves 100 cycles per read */
+static uint32_t Sim_Cycles;
+#undef DWT_CYCCNT
+#define DWT_CYCCNT				(Sim_Cycles += 100U)
+
+#include "DWT_Init.h"
+
+#define SIM_PAGE				(0x1000UL)
+#define SIM_REG_PAGE			((uintptr_t)FLASH_INTERFACE_BASE_ADDRESS & ~(SIM_PAGE - 1UL))
+#define SIM_EFLAGS_TF			(0x100UL)
+
+/* 128 KB sector at x32: 1 s typical, 2 s max */
+#define SIM_ERASE_TYP_MS		(1000U)
+#define SIM_ERASE_MAX_MS		(2000U)
+/* Longest job of the test */
+#define SIM_JOB_LIMIT_MS		(60000U)
+
+static volatile FLASH_REG * const Sim_Flash = FLASH_INTERFACE_BASE_ADDRESS;
+
+/* Time in ms, FLS_MAIN_FUNCTION_PERIOD_MS per Fls_MainFunction call */
+static uint32_t Sim_Ms;
+
+/* Trapped store: its address & what it overwrote */
+static volatile uintptr_t Sim_Store;
+static FLASH_REG Sim_Before;
+static uint8_t Sim_Word[8];
+
+static uint32_t Sim_KeyStep;
+static uint32_t Sim_EraseMs = SIM_ERASE_TYP_MS;
+static uint32_t Sim_EraseLeft;
+static uint32_t Sim_EraseStart;
+static uint32_t Sim_EraseSize;
+/* Set: this byte reads 0x00 after an erase (worn cell) */
+static uint32_t Sim_StuckAddress;
+
+static uint32_t Sim_Erases;
+static uint32_t Sim_Programs;
+static uint32_t Sim_ForeignErases;		/* Sectors outside the Fls area		*/
+static uint32_t Sim_BusyWrites;			/* CR written while BSY				*/
+static uint32_t Sim_BadPrograms;		/* Stores without PG, locked or busy	*/
+static uint32_t Sim_KeyErrors;
+
+static uint32_t Sim_Dets;
+static uint8_t Sim_DetApi;
+static uint8_t Sim_DetError;
+
+static uint32_t Sim_Ends;
+static uint32_t Sim_Errors;
+static uint32_t Sim_Starts;
+
+Std_ReturnType Det_ReportError(uint16 ModuleId, uint8 InstanceId, uint8 ApiId, uint8 ErrorId)
+{
+  (void)ModuleId;
+  (void)InstanceId;
+
+  Sim_Dets++;
+  Sim_DetApi = ApiId;
+  Sim_DetError = ErrorId;
+
+  return E_OK;
+}
+
+static void Sim_JobEnd(void)
+{
+  Sim_Ends++;
+}
+
+static void Sim_JobError(void)
+{
+  Sim_Errors++;
+}
+
+static void Sim_JobStart(void)
+{
+  Sim_Starts++;
+}
+
+/* Same numbers as Fls_Lcfg.c, with notifications */
+static const Fls_ConfigType Sim_Config = { Sim_JobEnd, Sim_JobError, MEMIF_MODE_SLOW, 1024U, 256U, 256U, 64U, Sim_JobStart };
+
+/* Registers & Fls area writable by the model, read only (trapping) for the driver */
+static void Sim_Open(void)
+{
+  mprotect((void *)SIM_REG_PAGE, SIM_PAGE, PROT_READ | PROT_WRITE);
+  mprotect((void *)FLS_BASE_ADDRESS, FLS_TOTAL_SIZE, PROT_READ | PROT_WRITE);
+}
+
+static void Sim_Close(void)
+{
+  mprotect((void *)SIM_REG_PAGE, SIM_PAGE, PROT_READ);
+  mprotect((void *)FLS_BASE_ADDRESS, FLS_TOTAL_SIZE, PROT_READ);
+}
+
+static int Sim_IsRegister(uintptr_t Address)
+{
+  return (Address >= (uintptr_t)FLASH_INTERFACE_BASE_ADDRESS)
+      && (Address < ((uintptr_t)FLASH_INTERFACE_BASE_ADDRESS + sizeof(FLASH_REG)));
+}
+
+static int Sim_IsFlash(uintptr_t Address)
+{
+  return (Address >= FLS_BASE_ADDRESS) && (Address < (FLS_BASE_ADDRESS + FLS_TOTAL_SIZE));
+}
+
+/* SNB to address range, SNB 16.. is Bank 2 */
+static void Sim_Sector(uint32_t Snb, uint32_t *Start, uint32_t *Size)
+{
+  uint32_t bank = FLASH_MEMORY_BASE_ADDRESS;
+
+  if(Snb >= 16U)
+  {
+    bank += FLASH_BANK_SIZE;
+    Snb -= 16U;
+  }
+
+  if(Snb < 4U)
+  {
+    *Start = bank + (Snb * 0x4000U);
+    *Size = 0x4000U;
+  }
+  else if(Snb == 4U)
+  {
+    *Start = bank + 0x10000U;
+    *Size = 0x10000U;
+  }
+  else
+  {
+    *Start = bank + 0x20000U + ((Snb - 5U) * 0x20000U);
+    *Size = 0x20000U;
+  }
+}
+
+static void Sim_StartErase(void)
+{
+  Sim_Sector((Sim_Flash->CR & FLASH_CR_SNB_MASK) >> FLASH_CR_SNB_SHIFT, &Sim_EraseStart, &Sim_EraseSize);
+
+  if((Sim_EraseStart < FLS_BASE_ADDRESS) || ((Sim_EraseStart + Sim_EraseSize) > (FLS_BASE_ADDRESS + FLS_TOTAL_SIZE)))
+  {
+    /* Not mapped, taken as write protected */
+    Sim_ForeignErases++;
+    Sim_Flash->SR |= FLASH_SR_WRPERR_MASK;
+    Sim_Flash->CR &= ~FLASH_CR_STRT_MASK;
+    return;
+  }
+
+  Sim_EraseLeft = Sim_EraseMs;
+  Sim_Flash->SR |= FLASH_SR_BSY_MASK;
+}
+
+static void Sim_EndErase(void)
+{
+  memset((void *)(uintptr_t)Sim_EraseStart, 0xFF, Sim_EraseSize);
+
+  if((Sim_StuckAddress >= Sim_EraseStart) && (Sim_StuckAddress < (Sim_EraseStart + Sim_EraseSize)))
+  {
+    *(uint8_t *)(uintptr_t)Sim_StuckAddress = 0x00;
+  }
+
+  /* STRT is cleared with BSY */
+  Sim_Flash->SR &= ~FLASH_SR_BSY_MASK;
+  Sim_Flash->CR &= ~FLASH_CR_STRT_MASK;
+  Sim_Erases++;
+}
+
+/* A register store, Sim_Before holds the registers before it */
+static void Sim_RegisterStored(void)
+{
+  uint32_t value = 0;
+
+  switch(Sim_Store - (uintptr_t)FLASH_INTERFACE_BASE_ADDRESS)
+  {
+  case offsetof(FLASH_REG, KEYR):
+    value = Sim_Flash->KEYR;
+    Sim_Flash->KEYR = 0;
+
+    if((Sim_KeyStep == 0) && (value == FLASH_KEY1))
+    {
+      Sim_KeyStep = 1;
+    }
+    else if((Sim_KeyStep == 1) && (value == FLASH_KEY2))
+    {
+      Sim_KeyStep = 0;
+      Sim_Flash->CR &= ~FLASH_CR_LOCK_MASK;
+    }
+    else
+    {
+      /* Locked till reset on the target */
+      Sim_KeyStep = 0;
+      Sim_KeyErrors++;
+    }
+    break;
+
+  case offsetof(FLASH_REG, SR):
+    /* EOP & errors: write 1 to clear, BSY read only */
+    value = Sim_Flash->SR;
+    Sim_Flash->SR = Sim_Before.SR & ~(value & (FLASH_SR_ERRORS_MASK | FLASH_SR_EOP_MASK));
+    break;
+
+  case offsetof(FLASH_REG, CR):
+    if((Sim_Before.SR & FLASH_SR_BSY_MASK) != 0)
+    {
+      Sim_BusyWrites++;
+      Sim_Flash->CR = Sim_Before.CR;
+    }
+    else if((Sim_Before.CR & FLASH_CR_LOCK_MASK) != 0)
+    {
+      Sim_Flash->CR = Sim_Before.CR;
+    }
+    else if(((Sim_Flash->CR & FLASH_CR_STRT_MASK) != 0) && ((Sim_Flash->CR & FLASH_CR_SER_MASK) != 0))
+    {
+      Sim_StartErase();
+    }
+    break;
+
+  default:
+    break;
+  }
+}
+
+/* A store to the Fls area, Sim_Word holds the 8 bytes it went to before it */
+static void Sim_FlashStored(void)
+{
+  uint8_t *word = (uint8_t *)(Sim_Store & ~7UL);
+  uint32_t i = 0;
+
+  if(((Sim_Before.CR & (FLASH_CR_LOCK_MASK | FLASH_CR_PG_MASK)) != FLASH_CR_PG_MASK)
+      || ((Sim_Before.SR & FLASH_SR_BSY_MASK) != 0))
+  {
+    memcpy(word, Sim_Word, sizeof(Sim_Word));
+    Sim_Flash->SR |= FLASH_SR_PGSERR_MASK;
+    Sim_BadPrograms++;
+    return;
+  }
+
+  /* Programming only takes bits from 1 to 0 */
+  for(i = 0; i < sizeof(Sim_Word); i++)
+  {
+    word[i] &= Sim_Word[i];
+  }
+  Sim_Programs++;
+}
+
+/* Store to the read only mapping: let it through & stop right after it */
+static void Sim_Fault(int Signal, siginfo_t *Info, void *Context)
+{
+  ucontext_t *uc = (ucontext_t *)Context;
+  uintptr_t address = (uintptr_t)Info->si_addr;
+
+  (void)Signal;
+
+  if((Sim_Store != 0) || (!Sim_IsRegister(address) && !Sim_IsFlash(address)))
+  {
+    /* A real fault, crash on return */
+    signal(SIGSEGV, SIG_DFL);
+    return;
+  }
+
+  Sim_Store = address;
+  memcpy(&Sim_Before, (const void *)Sim_Flash, sizeof(Sim_Before));
+  if(Sim_IsFlash(address))
+  {
+    memcpy(Sim_Word, (const void *)(address & ~7UL), sizeof(Sim_Word));
+  }
+
+  Sim_Open();
+  uc->uc_mcontext.gregs[REG_EFL] |= SIM_EFLAGS_TF;
+}
+
+static void Sim_Step(int Signal, siginfo_t *Info, void *Context)
+{
+  ucontext_t *uc = (ucontext_t *)Context;
+
+  (void)Signal;
+  (void)Info;
+
+  uc->uc_mcontext.gregs[REG_EFL] &= ~SIM_EFLAGS_TF;
+
+  if(Sim_Store == 0)
+  {
+    return;
+  }
+
+  if(Sim_IsRegister(Sim_Store))
+  {
+    Sim_RegisterStored();
+  }
+  else
+  {
+    Sim_FlashStored();
+  }
+
+  Sim_Store = 0;
+  Sim_Close();
+}
+
+/* One period of the running erase */
+static void Sim_Period(void)
+{
+  Sim_Ms += FLS_MAIN_FUNCTION_PERIOD_MS;
+
+  if(((Sim_Flash->SR & FLASH_SR_BSY_MASK) == 0) || (Sim_EraseLeft == 0))
+  {
+    return;
+  }
+
+  Sim_EraseLeft = (Sim_EraseLeft > FLS_MAIN_FUNCTION_PERIOD_MS) ? (Sim_EraseLeft - FLS_MAIN_FUNCTION_PERIOD_MS) : 0U;
+
+  if(Sim_EraseLeft == 0)
+  {
+    Sim_Open();
+    Sim_EndErase();
+    Sim_Close();
+  }
+}
+
+static int Sim_Start(void)
+{
+  struct sigaction action;
+
+  if((mmap((void *)FLS_BASE_ADDRESS, FLS_TOTAL_SIZE, PROT_READ | PROT_WRITE,
+           MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) == MAP_FAILED)
+      || (mmap((void *)SIM_REG_PAGE, SIM_PAGE, PROT_READ | PROT_WRITE,
+               MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) == MAP_FAILED))
+  {
+    return -1;
+  }
+
+  /* Reset values, Data Cache on as SystemInit leaves it */
+  Sim_Flash->ACR = FLASH_ACR_DCEN_MASK;
+  Sim_Flash->CR = FLASH_CR_LOCK_MASK;
+  memset((void *)FLS_BASE_ADDRESS, 0x5A, FLS_TOTAL_SIZE);
+
+  memset(&action, 0, sizeof(action));
+  action.sa_sigaction = Sim_Fault;
+  action.sa_flags = SA_SIGINFO;
+  sigaction(SIGSEGV, &action, 0);
+  action.sa_sigaction = Sim_Step;
+  sigaction(SIGTRAP, &action, 0);
+
+  Sim_Close();
+
+  return 0;
+}
+
+#include "../../AUTOSAR/Fls/Fls.c"
+
+static uint32_t u32Failures;
+
+#define CHECK(cond, ...)	do{ if(!(cond)){ u32Failures++; printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } }while(0)
+
+/* Fls Task: one Fls_MainFunction call per period till the job ends, returns the ms taken */
+static uint32_t u32RunJob(void)
+{
+  uint32_t start = Sim_Ms;
+
+  while((Fls_GetJobResult() == MEMIF_JOB_PENDING) && ((Sim_Ms - start) < SIM_JOB_LIMIT_MS))
+  {
+    Fls_MainFunction();
+    Sim_Period();
+  }
+
+  return Sim_Ms - start;
+}
+
+/* Idle periods, as the Fls Task keeps calling Fls_MainFunction */
+static void vidRunIdle(uint32_t Ms)
+{
+  uint32_t start = Sim_Ms;
+
+  while((Sim_Ms - start) < Ms)
+  {
+    Fls_MainFunction();
+    Sim_Period();
+  }
+}
+
+static int xIsFilled(uint32_t Offset, uint32_t Length, uint8_t Value)
+{
+  const uint8_t *flash = (const uint8_t *)(uintptr_t)(FLS_BASE_ADDRESS + Offset);
+  uint32_t i = 0;
+
+  for(i = 0; i < Length; i++)
+  {
+    if(flash[i] != Value)
+    {
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+static int xIsReleased(void)
+{
+  return ((Sim_Flash->CR & FLASH_CR_LOCK_MASK) != 0) && ((Sim_Flash->ACR & FLASH_ACR_DCEN_MASK) != 0)
+      && ((Sim_Flash->CR & (FLASH_CR_PG_MASK | FLASH_CR_SER_MASK)) == 0);
+}
+
+static void vidTestRequests(void)
+{
+  uint8_t data[8] = {0};
+
+  Sim_Dets = 0;
+
+  CHECK(Fls_Erase(0x100U, 0x20000U) == E_NOT_OK, "erase inside a sector accepted");
+  CHECK(Sim_DetError == FLS_E_PARAM_ADDRESS, "erase address: DET %u", Sim_DetError);
+  CHECK(Fls_Erase(0U, 0x1000U) == E_NOT_OK, "erase of part of a sector accepted");
+  CHECK(Sim_DetError == FLS_E_PARAM_LENGTH, "erase length: DET %u", Sim_DetError);
+  CHECK(Fls_Erase(0x20000U, 0x40000U) == E_NOT_OK, "erase past the area accepted");
+  CHECK(Fls_Write(2U, data, 4U) == E_NOT_OK, "unaligned write accepted");
+  CHECK(Sim_DetError == FLS_E_PARAM_ADDRESS, "write address: DET %u", Sim_DetError);
+  CHECK(Fls_Write(0U, data, 6U) == E_NOT_OK, "write of part of a unit accepted");
+  CHECK(Fls_Write(0U, NULL_PTR, 4U) == E_NOT_OK, "write without data accepted");
+  CHECK(Fls_Read(FLS_TOTAL_SIZE, data, 4U) == E_NOT_OK, "read past the area accepted");
+  CHECK(Sim_Dets == 7U, "%u DET reports for 7 refused requests", Sim_Dets);
+  CHECK(Fls_GetJobResult() == MEMIF_JOB_OK, "refused requests changed the job result");
+  CHECK(Sim_Flash->CR == FLASH_CR_LOCK_MASK, "refused requests unlocked the Flash: CR %08x", Sim_Flash->CR);
+}
+
+static void vidTestErase(void)
+{
+  uint32_t ms = 0;
+
+  Sim_Dets = 0;
+  Sim_EraseMs = SIM_ERASE_TYP_MS;
+
+  CHECK(Fls_Erase(0U, FLS_TOTAL_SIZE) == E_OK, "erase of the whole area refused");
+  CHECK(Fls_Write(0U, (const uint8 *)"abcd", 4U) == E_NOT_OK, "write accepted during an erase");
+  CHECK(Sim_DetError == FLS_E_BUSY, "busy: DET %u", Sim_DetError);
+
+  ms = u32RunJob();
+
+  CHECK(Fls_GetJobResult() == MEMIF_JOB_OK, "erase result %u", Fls_GetJobResult());
+  CHECK(Sim_Erases == 2U, "%u sectors erased, the area has 2", Sim_Erases);
+  CHECK(xIsFilled(0U, FLS_TOTAL_SIZE, 0xFF), "area not blank after the erase");
+  CHECK(xIsReleased(), "Flash not released: CR %08x ACR %08x", Sim_Flash->CR, Sim_Flash->ACR);
+  /* 2 erases & the blank check of 256 bytes per call */
+  CHECK(ms <= ((2U * SIM_ERASE_TYP_MS) + ((FLS_TOTAL_SIZE / 256U) + 4U) * FLS_MAIN_FUNCTION_PERIOD_MS),
+        "erase took %u ms", ms);
+  CHECK(Sim_Dets == 1U, "%u DET reports", Sim_Dets);
+  printf("Erase of %lu KB: %u ms\n", FLS_TOTAL_SIZE / 1024UL, ms);
+}
+
+static void vidTestWrite(void)
+{
+  static uint8_t data[1001];
+  static uint8_t back[1000];
+  uint32_t i = 0, ms = 0;
+
+  for(i = 0; i < sizeof(data); i++)
+  {
+    data[i] = (uint8_t)(i * 7U);
+  }
+
+  /* Unaligned source, across the sector boundary */
+  CHECK(Fls_Write(0x1FFF0U, data + 1, 1000U) == E_OK, "write refused");
+  ms = u32RunJob();
+  CHECK(Fls_GetJobResult() == MEMIF_JOB_OK, "write result %u", Fls_GetJobResult());
+  CHECK(ms == ((1000U + 63U) / 64U) * FLS_MAIN_FUNCTION_PERIOD_MS, "write took %u ms", ms);
+  CHECK(memcmp((const void *)(FLS_BASE_ADDRESS + 0x1FFF0U), data + 1, 1000U) == 0, "Flash doesn't hold the data");
+  CHECK(xIsFilled(0U, 0x1FFF0U, 0xFF) && xIsFilled(0x1FFF0U + 1000U, FLS_TOTAL_SIZE - 0x1FFF0U - 1000U, 0xFF),
+        "write programmed outside its range");
+  CHECK(xIsReleased(), "Flash not released: CR %08x ACR %08x", Sim_Flash->CR, Sim_Flash->ACR);
+
+  CHECK(Fls_Read(0x1FFF0U, back, 1000U) == E_OK, "read refused");
+  u32RunJob();
+  CHECK((Fls_GetJobResult() == MEMIF_JOB_OK) && (memcmp(back, data + 1, 1000U) == 0), "read back differs");
+
+  CHECK(Fls_Compare(0x1FFF0U, data + 1, 1000U) == E_OK, "compare refused");
+  u32RunJob();
+  CHECK(Fls_GetJobResult() == MEMIF_JOB_OK, "compare result %u", Fls_GetJobResult());
+
+  data[501] ^= 0x10U;
+  Fls_Compare(0x1FFF0U, data + 1, 1000U);
+  u32RunJob();
+  CHECK(Fls_GetJobResult() == MEMIF_BLOCK_INCONSISTENT, "compare of other data: result %u", Fls_GetJobResult());
+
+  CHECK(Sim_Programs == 250U, "%u units programmed for 1000 bytes", Sim_Programs);
+}
+
+static void vidTestVerify(void)
+{
+  uint8_t data[4] = { 0xA5, 0xA5, 0xA5, 0xA5 };
+
+  /* Programmed at 0x1FFF0 by vidTestWrite, bits can't go back to 1 */
+  Sim_Dets = 0;
+  Fls_Write(0x1FFF0U, data, 4U);
+  u32RunJob();
+  CHECK(Fls_GetJobResult() == MEMIF_JOB_FAILED, "write over programmed Flash: result %u", Fls_GetJobResult());
+  CHECK(Sim_DetError == FLS_E_VERIFY_WRITE_FAILED, "write verification: DET %u", Sim_DetError);
+  CHECK(xIsReleased(), "Flash not released after a failed write");
+
+  Sim_StuckAddress = FLS_BASE_ADDRESS + 0x30000U;
+  Fls_Erase(0x20000U, 0x20000U);
+  u32RunJob();
+  Sim_StuckAddress = 0;
+  CHECK(Fls_GetJobResult() == MEMIF_JOB_FAILED, "erase of a worn cell: result %u", Fls_GetJobResult());
+  CHECK(Sim_DetError == FLS_E_VERIFY_ERASE_FAILED, "erase verification: DET %u", Sim_DetError);
+  CHECK(xIsReleased(), "Flash not released after a failed erase");
+}
+
+static void vidTestTimeout(void)
+{
+  uint32_t ms = 0;
+
+  /* Longest erase the timeout allows */
+  Sim_Dets = 0;
+  Sim_EraseMs = FLS_ERASE_TIMEOUT_MS;
+  Fls_Erase(0U, 0x20000U);
+  u32RunJob();
+  CHECK(Fls_GetJobResult() == MEMIF_JOB_OK, "erase of FLS_ERASE_TIMEOUT_MS: result %u", Fls_GetJobResult());
+  CHECK(Sim_Dets == 0U, "erase of FLS_ERASE_TIMEOUT_MS: DET %u", Sim_DetError);
+
+  /* Flash not ending the erase in time */
+  Sim_EraseMs = FLS_ERASE_TIMEOUT_MS + 1000U;
+  Fls_Erase(0U, 0x20000U);
+  ms = u32RunJob();
+  CHECK(Fls_GetJobResult() == MEMIF_JOB_FAILED, "slow erase: result %u", Fls_GetJobResult());
+  CHECK(Sim_DetError == FLS_E_TIMEOUT, "slow erase: DET %u", Sim_DetError);
+  CHECK((ms >= FLS_ERASE_TIMEOUT_MS) && (ms <= (FLS_ERASE_TIMEOUT_MS + FLS_MAIN_FUNCTION_PERIOD_MS)),
+        "erase timed out after %u ms, FLS_ERASE_TIMEOUT_MS is %lu", ms, FLS_ERASE_TIMEOUT_MS);
+  CHECK((Sim_Flash->CR & FLASH_CR_LOCK_MASK) == 0, "Flash locked while still erasing");
+
+  /* Released by Fls_MainFunction once the erase ends */
+  vidRunIdle(1000U + FLS_MAIN_FUNCTION_PERIOD_MS);
+  CHECK(xIsReleased(), "Flash not released after the erase ended: CR %08x", Sim_Flash->CR);
+  printf("Erase timeout: failed %u ms after the start\n", ms);
+
+  Sim_EraseMs = SIM_ERASE_MAX_MS;
+}
+
+static void vidTestCancel(void)
+{
+  static const uint8_t data[16] = "Fls Cancel test";
+  uint32_t erases = Sim_Erases;
+
+  /* Sector 23 erased by vidTestVerify's failed job is blank but for the worn cell */
+  Fls_Erase(0U, 0x20000U);
+  Fls_MainFunction();
+  Sim_Period();
+  CHECK((Sim_Flash->SR & FLASH_SR_BSY_MASK) != 0, "erase not started");
+
+  Fls_Cancel();
+  CHECK(Fls_GetJobResult() == MEMIF_JOB_CANCELED, "cancel: result %u", Fls_GetJobResult());
+  CHECK(Fls_GetStatus() == MEMIF_BUSY, "idle while the canceled erase holds the Flash");
+
+  /* Next job waits for the erase, then programs the other sector */
+  CHECK(Fls_Write(0x20010U, data, sizeof(data)) == E_OK, "write refused after cancel");
+  u32RunJob();
+  CHECK(Fls_GetJobResult() == MEMIF_JOB_OK, "write after cancel: result %u", Fls_GetJobResult());
+  CHECK(Sim_Erases == (erases + 1U), "canceled erase didn't end");
+  CHECK(memcmp((const void *)(FLS_BASE_ADDRESS + 0x20010U), data, sizeof(data)) == 0, "write after cancel lost");
+  CHECK(xIsReleased(), "Flash not released: CR %08x ACR %08x", Sim_Flash->CR, Sim_Flash->ACR);
+  CHECK(Fls_GetStatus() == MEMIF_IDLE, "not idle after the write");
+}
+
+int main(void)
+{
+  Fls_StatisticsType stats;
+
+  if(Sim_Start() != 0)
+  {
+    printf("FAIL: Flash & registers can't be mapped at their target addresses\n");
+    return 1;
+  }
+
+  Fls_Init(&Sim_Config);
+  CHECK(Fls_GetStatus() == MEMIF_IDLE, "not idle after Fls_Init");
+
+  vidTestRequests();
+  vidTestErase();
+  vidTestWrite();
+  vidTestVerify();
+  vidTestTimeout();
+  vidTestCancel();
+
+  CHECK(Sim_ForeignErases == 0U, "%u sectors erased outside the Fls area", Sim_ForeignErases);
+  CHECK(Sim_BusyWrites == 0U, "FLASH_CR written %u times while busy", Sim_BusyWrites);
+  CHECK(Sim_BadPrograms == 0U, "%u stores without PG / while locked or busy", Sim_BadPrograms);
+  CHECK(Sim_KeyErrors == 0U, "%u wrong KEYR writes", Sim_KeyErrors);
+
+  /* Failed: write & erase verification, timeout; Canceled counts as an error notification */
+  Fls_GetStatistics(&stats);
+  CHECK(stats.FailedJobs == 3U, "%u failed jobs counted", stats.FailedJobs);
+  CHECK(Sim_Errors == 5U, "%u error notifications", Sim_Errors);
+  CHECK(Sim_Ends == 6U, "%u end notifications", Sim_Ends);
+  CHECK(Sim_Starts == (Sim_Ends + Sim_Errors), "%u start notifications", Sim_Starts);
+  printf("Fls_MainFunction calls %u, programmed units %u, sector erases %u\n",
+         stats.MainFunctionCalls, Sim_Programs, Sim_Erases);
+
+  printf("%s (%u failures)\n", (u32Failures == 0) ? "PASS" : "FAIL", u32Failures);
+
+  return (u32Failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,292 @@
+/*
+ * frame_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ *
+ *  Host test & benchmark of the FRAME layer (Drivers/FRAME)
+ *  - CRC16 CCITT-FALSE check value
+ *  - COBS round trip of random payloads (zero runs, 254 byte blocks, max size)
+ *  - Corrupted, truncated & overflowing frames are counted, not delivered
+ *  - vidFRAME_PollUSART over a wrapping Rx Ring
+ *  - Encoder / Decoder throughput in MB/s
+ *
+ *  Build & run from tools/host:
+ *  gcc -O2 -Wall -I../../Drivers/FRAME -I../../Drivers/USART -I../../Drivers/DMA -I../../Drivers/STD_and_MATH \
+ *      frame_test.c ../../Drivers/FRAME/FRAME_Prog.c -o frame_test && ./frame_test
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "FRAME_Init.h"
+
+#define TEST_MAX_PAYLOAD		(1024U)
+#define TEST_RING_SIZE			(97U)		//Odd size so frames wrap at every position
+#define TEST_BENCH_BYTES		(64UL * 1024UL * 1024UL)
+
+static u8  Payload[TEST_MAX_PAYLOAD];
+static u8  Wire[FRAME_ENCODED_SIZE(TEST_MAX_PAYLOAD)];
+static u8  Frame[TEST_MAX_PAYLOAD + FRAME_CRC_SIZE];
+
+static const u8* pExpected;
+static u16 u16ExpectedSize;
+static u32 u32Delivered;
+static u32 u32Mismatch;
+static u32 u32Failures;
+
+#define CHECK(cond, ...)	do{ if(!(cond)){ u32Failures++; printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } }while(0)
+
+static void vidOnFrame(const u8* pData, u16 u16Size)
+{
+	u32Delivered++;
+
+	if((u16Size != u16ExpectedSize) || (0 != memcmp(pData, pExpected, u16Size)))
+	{
+		u32Mismatch++;
+	}
+}
+
+static double f64Now(void)
+{
+	struct timespec Time;
+
+	clock_gettime(CLOCK_MONOTONIC, &Time);
+	return (double)Time.tv_sec + ((double)Time.tv_nsec * 1e-9);
+}
+
+//Encode Payload in 1..3 pieces (Header, Body, Tail) like the firmware does
+static u16 u16Encode(const u8* pData, u16 u16Size, u16 u16OutSize)
+{
+	FRAME_Encoder Encoder;
+	u16 u16Split1 = (u16)(u16Size / 3U);
+	u16 u16Split2 = (u16)((2U * u16Size) / 3U);
+
+	vidFRAME_EncodeStart(&Encoder, Wire, u16OutSize);
+	xFRAME_EncodeAppend(&Encoder, pData, u16Split1);
+	xFRAME_EncodeAppend(&Encoder, pData + u16Split1, (u16)(u16Split2 - u16Split1));
+	xFRAME_EncodeAppend(&Encoder, pData + u16Split2, (u16)(u16Size - u16Split2));
+
+	return u16FRAME_EncodeFinish(&Encoder);
+}
+
+static void vidFill(u8* pData, u16 u16Size, u32 u32Pattern)
+{
+	u16 i = 0;
+
+	for(i = 0; i < u16Size; i++)
+	{
+		switch(u32Pattern % 4U)
+		{
+			case 0:  pData[i] = (u8)rand();						break;	//Random
+			case 1:  pData[i] = 0;								break;	//Zero run
+			case 2:  pData[i] = (u8)(1U + (rand() % 255));		break;	//No zeros (Full blocks)
+			default: pData[i] = ((rand() % 8) == 0) ? 0 : (u8)rand();	break;
+		}
+	}
+}
+
+static void vidTestCrc(void)
+{
+	const u8 Check[] = "123456789";
+
+	CHECK(0x29B1 == u16FRAME_Crc16(FRAME_CRC_INIT, Check, 9), "CRC16 check value");
+}
+
+static void vidTestRoundTrip(void)
+{
+	static const u16 Sizes[] = {0, 1, 2, 252, 253, 254, 255, 256, 507, 508, 509, 1000, TEST_MAX_PAYLOAD};
+	FRAME_Decoder Decoder;
+	u32 i = 0;
+	u32 j = 0;
+	u16 k = 0;
+	u16 u16Len = 0;
+
+	vidFRAME_DecoderInit(&Decoder, Frame, sizeof(Frame));
+
+	for(i = 0; i < (sizeof(Sizes) / sizeof(Sizes[0])); i++)
+	{
+		for(j = 0; j < 4U; j++)
+		{
+			vidFill(Payload, Sizes[i], j);
+			u16Len = u16Encode(Payload, Sizes[i], sizeof(Wire));
+
+			CHECK(u16Len != 0, "encode size %u", Sizes[i]);
+			CHECK(u16Len <= FRAME_ENCODED_SIZE(Sizes[i]), "encoded %u > bound for size %u", u16Len, Sizes[i]);
+			CHECK((0 == u16Len) || (NULL == memchr(Wire, 0, (size_t)(u16Len - 1U))), "zero inside frame of size %u", Sizes[i]);
+
+			pExpected = Payload;
+			u16ExpectedSize = Sizes[i];
+			u32Delivered = 0;
+			u32Mismatch = 0;
+
+			//Byte by byte, as the Rx ISR would feed it
+			for(k = 0; k < u16Len; k++)
+			{
+				vidFRAME_Decode(&Decoder, &Wire[k], 1, vidOnFrame);
+			}
+
+			CHECK((1 == u32Delivered) && (0 == u32Mismatch), "round trip size %u pattern %lu", Sizes[i], (unsigned long)j);
+		}
+	}
+
+	CHECK(0 == Decoder.CrcErrors, "unexpected CRC errors");
+	CHECK(0 == Decoder.Dropped, "unexpected drops");
+}
+
+static void vidTestErrors(void)
+{
+	FRAME_Decoder Decoder;
+	u8 Small[16];
+	u16 u16Len = 0;
+
+	vidFill(Payload, 100, 0);
+	pExpected = Payload;
+	u16ExpectedSize = 100;
+
+	//Flipped bit -> CRC Error, never delivered
+	u16Len = u16Encode(Payload, 100, sizeof(Wire));
+	Wire[10] ^= 0x01;
+	if(0 == Wire[10]) { Wire[10] = 0x80; }
+	vidFRAME_DecoderInit(&Decoder, Frame, sizeof(Frame));
+	u32Delivered = 0;
+	vidFRAME_Decode(&Decoder, Wire, u16Len, vidOnFrame);
+	CHECK((0 == u32Delivered) && ((1 == Decoder.CrcErrors) || (1 == Decoder.Dropped)), "corrupted frame delivered");
+
+	//Truncated frame (delimiter in the middle) -> Dropped, next frame still OK
+	u16Len = u16Encode(Payload, 100, sizeof(Wire));
+	vidFRAME_DecoderInit(&Decoder, Frame, sizeof(Frame));
+	u32Delivered = 0;
+	vidFRAME_Decode(&Decoder, Wire, 40, vidOnFrame);
+	vidFRAME_Decode(&Decoder, (const u8*)"\0", 1, vidOnFrame);
+	vidFRAME_Decode(&Decoder, Wire, u16Len, vidOnFrame);
+	CHECK((1 == u32Delivered) && (1 == (Decoder.Dropped + Decoder.CrcErrors)), "resync after truncated frame");
+
+	//Frame bigger than decoder buffer -> Dropped
+	vidFRAME_DecoderInit(&Decoder, Small, sizeof(Small));
+	u32Delivered = 0;
+	vidFRAME_Decode(&Decoder, Wire, u16Len, vidOnFrame);
+	CHECK((0 == u32Delivered) && (1 == Decoder.Dropped), "overflowing frame");
+
+	//Encoder output buffer too small -> 0
+	CHECK(0 == u16Encode(Payload, 100, 50), "encoder overflow not reported");
+}
+
+/*
+ * Fake USART DMA Rx Ring used by vidFRAME_PollUSART
+ * Same contract as USART_Prog.c: contiguous part till ring end, then the wrapped part
+ */
+static u8  Ring[TEST_RING_SIZE];
+static u16 u16RingHead;		//Next DMA write position
+static u16 u16RingTail;		//Next read position
+
+u16 u16USART_RxRingGet(USART_REG* USARTx, const u8** ppData)
+{
+	(void)USARTx;
+
+	*ppData = &Ring[u16RingTail];
+
+	return (u16RingHead >= u16RingTail) ? (u16)(u16RingHead - u16RingTail) : (u16)(TEST_RING_SIZE - u16RingTail);
+}
+
+void vidUSART_RxRingConsume(USART_REG* USARTx, u16 u16Count)
+{
+	(void)USARTx;
+
+	u16RingTail = (u16)((u16RingTail + u16Count) % TEST_RING_SIZE);
+}
+
+static void vidTestPollUSART(void)
+{
+	FRAME_Decoder Decoder;
+	u32 i = 0;
+	u16 u16Len = 0;
+	u16 u16Sent = 0;
+	u16 u16Chunk = 0;
+	u16 k = 0;
+
+	vidFRAME_DecoderInit(&Decoder, Frame, sizeof(Frame));
+	u32Delivered = 0;
+	u32Mismatch = 0;
+
+	for(i = 0; i < 200U; i++)
+	{
+		vidFill(Payload, (u16)(i % 180U), i);
+		pExpected = Payload;
+		u16ExpectedSize = (u16)(i % 180U);
+		u16Len = u16Encode(Payload, u16ExpectedSize, sizeof(Wire));
+
+		//DMA writes random sized chunks, the main loop polls after each one
+		for(u16Sent = 0; u16Sent < u16Len; u16Sent = (u16)(u16Sent + u16Chunk))
+		{
+			u16Chunk = (u16)(1U + (rand() % (TEST_RING_SIZE - 1U)));
+			if(u16Chunk > (u16Len - u16Sent)) { u16Chunk = (u16)(u16Len - u16Sent); }
+
+			for(k = 0; k < u16Chunk; k++)
+			{
+				Ring[u16RingHead] = Wire[u16Sent + k];
+				u16RingHead = (u16)((u16RingHead + 1U) % TEST_RING_SIZE);
+			}
+
+			vidFRAME_PollUSART(&Decoder, 0, vidOnFrame);
+		}
+	}
+
+	CHECK((200U == u32Delivered) && (0 == u32Mismatch), "ring delivered %lu mismatch %lu", (unsigned long)u32Delivered, (unsigned long)u32Mismatch);
+}
+
+static void vidBenchmark(void)
+{
+	FRAME_Decoder Decoder;
+	u32 u32Frames = (u32)(TEST_BENCH_BYTES / 256U);
+	u32 u32WireBytes = 0;
+	u32 i = 0;
+	u16 u16Len = 0;
+	double f64Start = 0;
+	double f64Encode = 0;
+	double f64Decode = 0;
+
+	vidFill(Payload, 256, 0);
+	u16Len = u16Encode(Payload, 256, sizeof(Wire));
+
+	f64Start = f64Now();
+	for(i = 0; i < u32Frames; i++)
+	{
+		Payload[0] = (u8)i;
+		u32WireBytes += u16Encode(Payload, 256, sizeof(Wire));
+	}
+	f64Encode = f64Now() - f64Start;
+
+	vidFRAME_DecoderInit(&Decoder, Frame, sizeof(Frame));
+	u32Delivered = 0;
+	pExpected = 0;
+
+	f64Start = f64Now();
+	for(i = 0; i < u32Frames; i++)
+	{
+		vidFRAME_Decode(&Decoder, Wire, u16Len, 0);
+	}
+	f64Decode = f64Now() - f64Start;
+
+	CHECK(u32Frames == Decoder.Frames, "benchmark frames %lu", (unsigned long)Decoder.Frames);
+
+	printf("encode+crc: %.1f MB/s payload (%lu wire bytes)\n", (double)TEST_BENCH_BYTES / f64Encode / 1e6, (unsigned long)u32WireBytes);
+	printf("decode+crc: %.1f MB/s payload\n", (double)TEST_BENCH_BYTES / f64Decode / 1e6);
+}
+
+int main(void)
+{
+	srand(1);
+
+	vidTestCrc();
+	vidTestRoundTrip();
+	vidTestErrors();
+	vidTestPollUSART();
+	vidBenchmark();
+
+	printf("%s (%lu failures)\n", (0 == u32Failures) ? "PASS" : "FAIL", (unsigned long)u32Failures);
+
+	return (0 == u32Failures) ? 0 : 1;
+}
@@ -0,0 +1,335 @@
+/*
+ * gfx_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ *
+ *  Host test & benchmark of the DMA2D transfer queue (stm32f429i_discovery_dma2d.c)
+ *  over the DMA2D model of dma2d_sim.h
+ *  - Fill, Copy, Convert & Blend program the right registers (pitch, offsets, formats)
+ *  - Transfers submitted faster than DMA2D runs them are queued & run in order,
+ *    a full queue waits for a slot, a configuration error is counted & skipped
+ *  - Full queue with interrupts masked or from handler mode: refused (ERROR), no spin
+ *  - CPU time of one LCD clear: old CPU loop vs queuing the fill
+ *  - One frame (clear, 12 glyphs, 2 blits): time to frame complete with the DMA2D
+ *    cost model of dma2d_sim.h & CPU time left while DMA2D fills it
+ *
+ *  Build & run from tools/host:
+ *  gcc -O2 -Wall -no-pie -DSTM32F42_43xxx -DUSE_STDPERIPH_DRIVER -I../../Utilities/STM32F429I-Discovery \
+ *      -I../../Libraries/CMSIS/Include -I../../Libraries/Device/ST/STM32F4xx/Include \
+ *      -I../../Libraries/STM32F4xx_StdPeriph_Driver/inc -I../../src gfx_test.c -o gfx_test && ./gfx_test
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "stm32f429i_discovery_dma2d.h"
+#include "dma2d_sim.h"
+#include "../../Utilities/STM32F429I-Discovery/stm32f429i_discovery_dma2d.c"
+
+#define TEST_WIDTH				(240U)
+#define TEST_HEIGHT				(320U)
+#define TEST_FRAME				(SIM_SDRAM_BASE)
+#define TEST_QUEUED				(200U)
+#define TEST_BENCH_CLEARS		(200U)
+
+/* LCD_Clear before the DMA2D queue: BUFFER_OFFSET half words written by the CPU */
+#define TEST_OLD_CLEAR_WRITES	(0x50000U)
+
+static uint32_t u32Failures;
+
+#define CHECK(cond, ...)	do{ if(!(cond)){ u32Failures++; printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } }while(0)
+
+static uint16_t Src565[64 * 48];
+static uint32_t Src8888[40 * 30];
+static uint8_t  Mask[16 * 16];
+static uint16_t Expected[TEST_WIDTH * TEST_HEIGHT];
+
+static uint16_t *Frame(void)
+{
+  return (uint16_t *)(uintptr_t)TEST_FRAME;
+}
+
+static uint32_t u32FrameDiffs(const uint16_t *Reference)
+{
+  uint32_t i = 0, diffs = 0;
+
+  for(i = 0; i < (TEST_WIDTH * TEST_HEIGHT); i++)
+  {
+    diffs += (Frame()[i] != Reference[i]) ? 1U : 0U;
+  }
+
+  return diffs;
+}
+
+static void vidRefFill(uint16_t *Buffer, uint32_t X, uint32_t Y, uint32_t Width, uint32_t Height, uint16_t Color)
+{
+  uint32_t x = 0, y = 0;
+
+  for(y = Y; y < (Y + Height); y++)
+  {
+    for(x = X; x < (X + Width); x++)
+    {
+      Buffer[(y * TEST_WIDTH) + x] = Color;
+    }
+  }
+}
+
+static void vidTestFillCopy(void)
+{
+  uint32_t i = 0, x = 0, y = 0;
+
+  /* Whole frame, as LCD_Clear does */
+  GFX_Fill(TEST_FRAME, TEST_WIDTH, TEST_WIDTH, TEST_HEIGHT, DMA2D_RGB565, 0x1234);
+  GFX_Wait();
+  vidRefFill(Expected, 0, 0, TEST_WIDTH, TEST_HEIGHT, 0x1234);
+  CHECK(0 == u32FrameDiffs(Expected), "clear");
+
+  /* Rectangle inside the frame, pixels around it untouched */
+  GFX_Fill(TEST_FRAME + (2 * ((17 * TEST_WIDTH) + 5)), TEST_WIDTH, 100, 33, DMA2D_RGB565, 0xF800);
+  GFX_Wait();
+  vidRefFill(Expected, 5, 17, 100, 33, 0xF800);
+  CHECK(0 == u32FrameDiffs(Expected), "rectangle fill");
+
+  /* Blit of a 40x30 window of a 64 pixel wide source */
+  for(i = 0; i < (sizeof(Src565) / sizeof(Src565[0])); i++)
+  {
+    Src565[i] = (uint16_t)rand();
+  }
+
+  GFX_Copy((uint32_t)(uintptr_t)&Src565[(3 * 64) + 7], 64, TEST_FRAME + (2 * ((200 * TEST_WIDTH) + 150)), TEST_WIDTH, 40, 30, CM_RGB565);
+  GFX_Wait();
+
+  for(y = 0; y < 30; y++)
+  {
+    for(x = 0; x < 40; x++)
+    {
+      Expected[((200 + y) * TEST_WIDTH) + 150 + x] = Src565[((3 + y) * 64) + 7 + x];
+    }
+  }
+
+  CHECK(0 == u32FrameDiffs(Expected), "copy");
+}
+
+static void vidTestConvertBlend(void)
+{
+  uint32_t i = 0, x = 0, y = 0, argb = 0;
+  uint16_t pixel = 0;
+
+  /* ARGB8888 -> RGB565 keeps the top bits of every channel */
+  for(i = 0; i < (sizeof(Src8888) / sizeof(Src8888[0])); i++)
+  {
+    Src8888[i] = 0xFF000000 | ((uint32_t)rand() & 0x00FFFFFF);
+  }
+
+  GFX_Convert((uint32_t)(uintptr_t)Src8888, 40, CM_ARGB8888, TEST_FRAME, TEST_WIDTH, DMA2D_RGB565, 40, 30);
+  GFX_Wait();
+
+  for(y = 0; y < 30; y++)
+  {
+    for(x = 0; x < 40; x++)
+    {
+      argb = Src8888[(y * 40) + x];
+      Expected[(y * TEST_WIDTH) + x] = (uint16_t)((((argb >> 19) & 0x1F) << 11) | (((argb >> 10) & 0x3F) << 5) | ((argb >> 3) & 0x1F));
+    }
+  }
+
+  CHECK(0 == u32FrameDiffs(Expected), "convert");
+
+  /* A8 mask over black: 0 keeps the background, 255 is the color, 128 is half way */
+  vidRefFill(Expected, 0, 0, 16, 16, 0x0000);
+  GFX_Fill(TEST_FRAME, TEST_WIDTH, 16, 16, DMA2D_RGB565, 0x0000);
+
+  for(i = 0; i < sizeof(Mask); i++)
+  {
+    Mask[i] = (i % 3 == 0) ? 0 : ((i % 3 == 1) ? 255 : 128);
+  }
+
+  GFX_BlendMask((uint32_t)(uintptr_t)Mask, 16, CM_A8, 0xFFFFFF, TEST_FRAME, TEST_WIDTH, DMA2D_RGB565, 16, 16);
+  GFX_Wait();
+
+  for(i = 0; i < sizeof(Mask); i++)
+  {
+    pixel = Frame()[((i / 16) * TEST_WIDTH) + (i % 16)];
+
+    if(Mask[i] == 0)
+    {
+      CHECK(0x0000 == pixel, "mask 0 wrote %04X", pixel);
+    }
+    else if(Mask[i] == 255)
+    {
+      CHECK(0xFFFF == pixel, "mask 255 wrote %04X", pixel);
+    }
+    else
+    {
+      CHECK(((pixel >> 11) >= 15) && ((pixel >> 11) <= 16), "mask 128 wrote %04X", pixel);
+    }
+  }
+}
+
+/* Transfers submitted back to back: 200 overlapping fills must land in order */
+static void vidTestQueue(void)
+{
+  uint32_t i = 0, x = 0, y = 0, w = 0, h = 0, errors = GFX_GetErrors(), transfers = Sim_Transfers;
+  uint16_t color = 0;
+  GFX_Command bad = {0};
+
+  vidRefFill(Expected, 0, 0, TEST_WIDTH, TEST_HEIGHT, 0);
+  GFX_Fill(TEST_FRAME, TEST_WIDTH, TEST_WIDTH, TEST_HEIGHT, DMA2D_RGB565, 0);
+
+  for(i = 0; i < TEST_QUEUED; i++)
+  {
+    x = (uint32_t)rand() % 200U;
+    y = (uint32_t)rand() % 280U;
+    w = 1U + ((uint32_t)rand() % 40U);
+    h = 1U + ((uint32_t)rand() % 40U);
+    color = (uint16_t)rand();
+
+    GFX_Fill(TEST_FRAME + (2 * ((y * TEST_WIDTH) + x)), TEST_WIDTH, (uint16_t)w, (uint16_t)h, DMA2D_RGB565, color);
+    vidRefFill(Expected, x, y, w, h, color);
+
+    /* One transfer with a CLUT format in the middle of the queue */
+    if(i == (TEST_QUEUED / 2))
+    {
+      bad.CR = DMA2D_M2M_PFC;
+      bad.FGPFCCR = CM_L8;
+      bad.NLR = (1U << 16) | 1U;
+      GFX_Submit(&bad);
+    }
+  }
+
+  GFX_Wait();
+
+  CHECK(0 == u32FrameDiffs(Expected), "queued fills out of order or lost");
+  CHECK((TEST_QUEUED + 2U) == (Sim_Transfers - transfers), "%lu transfers run", (unsigned long)(Sim_Transfers - transfers));
+  CHECK((errors + 1U) == GFX_GetErrors(), "configuration error not counted");
+  CHECK(0 == GFX_IsBusy(), "busy after wait");
+}
+
+/* Queue full behind a transfer that doesn't end: masked & handler mode callers get ERROR */
+static void vidTestFullQueue(void)
+{
+  uint32_t i = 0, transfers = Sim_Transfers;
+  uint32_t primask = 0;
+  ErrorStatus masked = SUCCESS, handler = SUCCESS, thread = ERROR;
+
+  Sim_Dma2dHold = 1;
+  for(i = 0; i < GFX_QUEUE_SIZE; i++)
+  {
+    CHECK(SUCCESS == GFX_Fill(TEST_FRAME, TEST_WIDTH, 8, 8, DMA2D_RGB565, (uint16_t)i), "fill %lu", (unsigned long)i);
+  }
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  masked = GFX_Fill(TEST_FRAME, TEST_WIDTH, 8, 8, DMA2D_RGB565, 0xAAAA);
+  __set_PRIMASK(primask);
+
+  Sim_Ipsr = 16U + DMA2D_IRQn;
+  handler = GFX_Fill(TEST_FRAME, TEST_WIDTH, 8, 8, DMA2D_RGB565, 0xBBBB);
+  Sim_Ipsr = 0;
+
+  /* Thread mode waits for the slot the interrupt frees */
+  Sim_Dma2dHold = 0;
+  thread = GFX_Fill(TEST_FRAME, TEST_WIDTH, 8, 8, DMA2D_RGB565, 0xCCCC);
+  GFX_Wait();
+
+  CHECK(ERROR == masked, "full queue accepted a transfer with interrupts masked");
+  CHECK(ERROR == handler, "full queue accepted a transfer in handler mode");
+  CHECK(SUCCESS == thread, "thread mode transfer refused");
+  CHECK((GFX_QUEUE_SIZE + 1U) == (Sim_Transfers - transfers), "%lu transfers run", (unsigned long)(Sim_Transfers - transfers));
+  CHECK(0xCCCC == Frame()[0], "last fill %04X", Frame()[0]);
+}
+
+static void vidBenchmark(void)
+{
+  uint32_t i = 0, index = 0;
+  double start = 0, loop = 0, submit = 0;
+
+  /* Old LCD_Clear: one volatile half word store per pixel (BUFFER_OFFSET of them) */
+  start = Sim_CpuNow();
+  for(i = 0; i < TEST_BENCH_CLEARS; i++)
+  {
+    for(index = 0; index < TEST_OLD_CLEAR_WRITES; index++)
+    {
+      *(__IO uint16_t *)(TEST_FRAME + (2 * index)) = (uint16_t)i;
+    }
+  }
+  loop = (Sim_CpuNow() - start) / TEST_BENCH_CLEARS;
+
+  /* New LCD_Clear: one queued fill, the CPU returns before DMA2D starts writing */
+  for(i = 0; i < TEST_BENCH_CLEARS; i++)
+  {
+    GFX_Wait();
+    start = Sim_CpuNow();
+    GFX_Fill(TEST_FRAME, TEST_WIDTH, TEST_WIDTH, TEST_HEIGHT, DMA2D_RGB565, (uint16_t)i);
+    submit += Sim_CpuNow() - start;
+  }
+  GFX_Wait();
+  submit /= TEST_BENCH_CLEARS;
+
+  CHECK(Frame()[(TEST_WIDTH * TEST_HEIGHT) - 1] == (uint16_t)(TEST_BENCH_CLEARS - 1), "last clear");
+
+  printf("LCD clear, CPU busy: %.1f us CPU loop, %.3f us queuing the DMA2D fill\n", loop * 1e6, submit * 1e6);
+}
+
+/* One frame: clear, 12 glyphs of 11x16 through their A8 mask, 2 blits of 64x48 (15 transfers, queue not full) */
+static void vidBenchFrame(void)
+{
+  uint32_t i = 0, frame = 0;
+  uint64_t cycles = 0;
+  double start = 0, submit = 0, dma = 0;
+
+  for(frame = 0; frame < TEST_BENCH_CLEARS; frame++)
+  {
+    GFX_Wait();
+    cycles = Sim_Dma2dCycles;
+    start = Sim_CpuNow();
+
+    GFX_Fill(TEST_FRAME, TEST_WIDTH, TEST_WIDTH, TEST_HEIGHT, DMA2D_RGB565, 0xFFFF);
+    for(i = 0; i < 12U; i++)
+    {
+      GFX_BlendMask((uint32_t)(uintptr_t)Mask, 16, CM_A8, 0x000000, TEST_FRAME + (2 * ((20 * TEST_WIDTH) + (i * 12U))),
+                    TEST_WIDTH, DMA2D_RGB565, 11, 16);
+    }
+    GFX_Copy((uint32_t)(uintptr_t)Src565, 64, TEST_FRAME + (2 * (100 * TEST_WIDTH)), TEST_WIDTH, 64, 48, CM_RGB565);
+    GFX_Copy((uint32_t)(uintptr_t)Src565, 64, TEST_FRAME + (2 * ((100 * TEST_WIDTH) + 100)), TEST_WIDTH, 64, 48, CM_RGB565);
+
+    submit += Sim_CpuNow() - start;
+    GFX_Wait();
+    dma += Sim_Dma2dUs(Sim_Dma2dCycles - cycles);
+  }
+  submit = (submit * 1e6) / TEST_BENCH_CLEARS;
+  dma /= TEST_BENCH_CLEARS;
+
+  printf("Frame (clear, 12 glyphs, 2 blits): complete %.1f us after the first submit (DMA2D model), CPU %.2f us queuing,"
+         " %.1f us (%.1f%%) CPU time free during the fill\n", dma, submit, dma - submit, (100.0 * (dma - submit)) / dma);
+
+  CHECK(dma > (Sim_Dma2dUs(TEST_WIDTH * TEST_HEIGHT * SIM_DMA2D_R2M_CYCLES)), "frame faster than its clear");
+  CHECK(submit < dma, "CPU queuing slower than DMA2D");
+}
+
+int main(void)
+{
+  srand(1);
+
+  if(Sim_Start() == 0)
+  {
+    printf("FAIL: SDRAM can't be mapped at 0x%08lX\n", (unsigned long)SIM_SDRAM_BASE);
+    return 1;
+  }
+
+  GFX_Init();
+
+  vidTestFillCopy();
+  vidTestConvertBlend();
+  vidTestQueue();
+  vidTestFullQueue();
+  vidBenchmark();
+  vidBenchFrame();
+
+  Sim_Stop();
+
+  printf("%s (%lu failures)\n", (0 == u32Failures) ? "PASS" : "FAIL", (unsigned long)u32Failures);
+
+  return (0 == u32Failures) ? 0 : 1;
+}
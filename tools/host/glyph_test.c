@@ -0,0 +1,198 @@
+/*
+ * glyph_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ *
+ *  Host test & benchmark of the LCD glyph cache (stm32f429i_discovery_lcd.c)
+ *  over the DMA2D model of dma2d_sim.h
+ *  - Text drawn from the A8 glyph cache with DMA2D blends is pixel for pixel
+ *    the text LCD_DrawChar draws with the CPU, for every font & character
+ *  - The cache follows LCD_SetFont, characters out of 0x21..0x7E are background
+ *  - One text line end to end, in characters per second at 180 MHz: before, the
+ *    per pixel CPU loop of LCD_DrawChar (TEST_CPU_PIXEL_CYCLES); after, the queued
+ *    fill & blends, bound by the DMA2D time of the line (cost model of dma2d_sim.h)
+ *    or the CPU queuing time, whichever is longer (CPU times measured on the host)
+ *
+ *  Build & run from tools/host:
+ *  gcc -O2 -Wall -no-pie -DSTM32F42_43xxx -DUSE_STDPERIPH_DRIVER -I../../Utilities/STM32F429I-Discovery \
+ *      -I../../Libraries/CMSIS/Include -I../../Libraries/Device/ST/STM32F4xx/Include \
+ *      -I../../Libraries/STM32F4xx_StdPeriph_Driver/inc -I../../src glyph_test.c ../../Utilities/Common/fonts.c \
+ *      -o glyph_test && ./glyph_test
+ */
+
+#include <stdio.h>
+
+#include "lcd_sim.h"
+#include "../../Utilities/STM32F429I-Discovery/stm32f429i_discovery_dma2d.c"
+#include "../../Utilities/STM32F429I-Discovery/stm32f429i_discovery_lcd.c"
+
+#define TEST_TEXT_COLOR			((uint16_t)0xF81F)
+#define TEST_BACK_COLOR			((uint16_t)0x07E0)
+#define TEST_BENCH_LINES		(2000U)
+
+/*
+ * LCD_DrawChar on target, cycles per pixel: reload of the font & colors, the
+ * Width / 12 divide, bit test & branch (~18), then a halfword store to SDRAM that
+ * waits for the FMC write of the previous one (~8)
+ */
+#define TEST_CPU_PIXEL_CYCLES	(26U)
+
+static uint32_t u32Failures;
+
+#define CHECK(cond, ...)	do{ if(!(cond)){ u32Failures++; printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } }while(0)
+
+static sFONT *Fonts[] = {&Font16x24, &Font12x12, &Font8x12, &Font8x8};
+
+static uint16_t Expected[LCD_PIXEL_WIDTH * LCD_PIXEL_HEIGHT];
+
+static uint16_t *Frame(void)
+{
+  return (uint16_t *)(uintptr_t)LCD_FRAME_BUFFER;
+}
+
+/* Characters of one text line, from First on, with a 0 at the end */
+static void vidLineText(uint8_t *Text, uint32_t Columns, uint32_t First)
+{
+  uint32_t i = 0;
+
+  for(i = 0; i < Columns; i++)
+  {
+    Text[i] = (uint8_t)(First + i);
+  }
+
+  Text[Columns] = 0;
+}
+
+/* Every printable character of every font, drawn by LCD_DrawChar & by the cache */
+static void vidTestFonts(void)
+{
+  uint8_t text[32];
+  uint32_t font = 0, first = 0, line = 0, columns = 0, column = 0, diffs = 0;
+  sFONT *pFont = 0;
+
+  LCD_SetColors(TEST_TEXT_COLOR, TEST_BACK_COLOR);
+
+  for(font = 0; font < (sizeof(Fonts) / sizeof(Fonts[0])); font++)
+  {
+    pFont = Fonts[font];
+    LCD_SetFont(pFont);
+    columns = LCD_PIXEL_WIDTH / pFont->Width;
+
+    /* Reference: CPU loop, one line of characters after the other */
+    LCD_Clear(0);
+    for(first = LCD_GLYPH_FIRST, line = 0; first < (LCD_GLYPH_FIRST + LCD_GLYPH_COUNT); first += columns, line++)
+    {
+      for(column = 0; (column < columns) && ((first + column) < (LCD_GLYPH_FIRST + LCD_GLYPH_COUNT)); column++)
+      {
+        LCD_DrawChar(LINE(line), column * pFont->Width, &pFont->table[(first + column - LCD_GLYPH_FIRST) * pFont->Height]);
+      }
+    }
+    memcpy(Expected, Frame(), sizeof(Expected));
+
+    /* Glyph cache: the same lines as strings */
+    LCD_Clear(0);
+    for(first = LCD_GLYPH_FIRST, line = 0; first < (LCD_GLYPH_FIRST + LCD_GLYPH_COUNT); first += columns, line++)
+    {
+      vidLineText(text, ((first + columns) <= (LCD_GLYPH_FIRST + LCD_GLYPH_COUNT)) ? columns : (LCD_GLYPH_FIRST + LCD_GLYPH_COUNT - first), first);
+      LCD_DisplayStringLine(LINE(line), text);
+    }
+    GFX_Wait();
+
+    diffs = 0;
+    for(column = 0; column < (LCD_PIXEL_WIDTH * LCD_PIXEL_HEIGHT); column++)
+    {
+      diffs += (Frame()[column] != Expected[column]) ? 1U : 0U;
+    }
+
+    CHECK(0 == diffs, "font %ux%u: %lu pixels differ from LCD_DrawChar", pFont->Width, pFont->Height, (unsigned long)diffs);
+    CHECK(GlyphCacheFont == pFont, "font %ux%u not cached", pFont->Width, pFont->Height);
+  }
+
+  /* Back to the first font: the cache is rebuilt, LCD_DisplayChar matches LCD_DrawChar */
+  LCD_SetFont(&Font16x24);
+  LCD_Clear(0);
+  LCD_DrawChar(LINE(1), 32, &Font16x24.table[('A' - LCD_GLYPH_FIRST) * Font16x24.Height]);
+  memcpy(Expected, Frame(), sizeof(Expected));
+  LCD_Clear(0);
+  LCD_DisplayChar(LINE(1), 32, 'A');
+  GFX_Wait();
+  CHECK(0 == memcmp(Expected, Frame(), sizeof(Expected)), "cache not rebuilt after a font change");
+
+  /* Characters out of the font: background only */
+  LCD_Clear(0);
+  LCD_DisplayChar(LINE(0), 0, 0x7F);
+  LCD_DisplayChar(LINE(0), 16, 0x10);
+  GFX_Wait();
+  CHECK((TEST_BACK_COLOR == Frame()[0]) && (TEST_BACK_COLOR == Frame()[(23 * LCD_PIXEL_WIDTH) + 31]), "character out of the font not background");
+  CHECK(0 == GFX_GetErrors(), "%lu DMA2D errors", (unsigned long)GFX_GetErrors());
+}
+
+static void vidBenchmark(void)
+{
+  uint8_t text[] = "Glyph cache 123";
+  uint32_t i = 0, column = 0, chars = sizeof(text) - 1;
+  uint64_t cycles = 0;
+  double start = 0, loop = 0, cached = 0, dma = 0, line = 0, target = 0;
+
+  LCD_SetFont(&Font12x12);
+  LCD_SetColors(TEST_TEXT_COLOR, TEST_BACK_COLOR);
+
+  /* Before the cache: LCD_DisplayStringLine drew every character with LCD_DrawChar */
+  start = Sim_CpuNow();
+  for(i = 0; i < TEST_BENCH_LINES; i++)
+  {
+    for(column = 0; text[column] != 0; column++)
+    {
+      LCD_DrawChar(LINE(i % 26), column * 12, &Font12x12.table[(text[column] - LCD_GLYPH_FIRST) * 12]);
+    }
+  }
+  loop = (Sim_CpuNow() - start) / TEST_BENCH_LINES;
+
+  /* Glyph cache: one fill & one blend per character queued, the CPU doesn't wait */
+  for(i = 0; i < TEST_BENCH_LINES; i++)
+  {
+    GFX_Wait();
+    cycles = Sim_Dma2dCycles;
+    start = Sim_CpuNow();
+    LCD_DisplayStringLine(LINE(i % 26), text);
+    cached += Sim_CpuNow() - start;
+    GFX_Wait();
+    dma += Sim_Dma2dUs(Sim_Dma2dCycles - cycles) * 1e-6;
+  }
+  cached /= TEST_BENCH_LINES;
+  dma /= TEST_BENCH_LINES;
+
+  /* Target: the CPU loop draws every pixel; lines follow each other, the next one
+     queues while the DMA2D runs the last */
+  target = Sim_Dma2dUs((uint64_t)chars * Font12x12.Width * Font12x12.Height * TEST_CPU_PIXEL_CYCLES) * 1e-6;
+  line = (dma > cached) ? dma : cached;
+
+  printf("%u character line, CPU busy: %.1f us CPU loop, %.1f us queuing glyph blends (host)\n",
+         (unsigned)chars, loop * 1e6, cached * 1e6);
+  printf("%u character line end to end at %lu MHz: %.1f us CPU loop (%.0f chars/s), %.1f us DMA2D blends (%.0f chars/s, x%.1f)\n",
+         (unsigned)chars, SIM_DMA2D_HZ / 1000000UL, target * 1e6, chars / target, line * 1e6, chars / line, target / line);
+
+  CHECK(dma > Sim_Dma2dUs(chars * 12U * 12U * SIM_DMA2D_BLEND_CYCLES) * 1e-6, "line faster than its blends");
+  CHECK(line < target, "DMA2D line slower than the CPU loop");
+}
+
+int main(void)
+{
+  if(Sim_Start() == 0)
+  {
+    printf("FAIL: SDRAM can't be mapped at 0x%08lX\n", (unsigned long)SIM_SDRAM_BASE);
+    return 1;
+  }
+
+  GFX_Init();
+
+  vidTestFonts();
+  vidBenchmark();
+
+  Sim_Stop();
+
+  printf("%s (%lu failures)\n", (0 == u32Failures) ? "PASS" : "FAIL", (unsigned long)u32Failures);
+
+  return (0 == u32Failures) ? 0 : 1;
+}
@@ -0,0 +1,252 @@
+/*
+ * i2cm_sim.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ *
+ *  Host model of the I2C transaction queue (stm32f429i_discovery_i2c.c) for the I2C harnesses
+ *  - I2CM_Submit, I2CM_Run & I2CM_Reset with the driver's queue semantics; one queued
+ *    transaction runs per SIGALRM tick, as the I2C interrupts would, and its callback
+ *    is called from the tick
+ *  - A tick coming while PRIMASK is set is deferred until it is cleared
+ *  - Sim_Now is the bus time in us: the slave model adds 9 clocks per byte at
+ *    I2CM_I2C_SPEED (SIM_BYTE_US); with the queue empty a tick moves it SIM_IDLE_US,
+ *    up to the end of a Sim_Elapse
+ *  - Sim_TickHook runs at the end of every tick, for the other interrupts of a harness
+ *
+ *  Include after the driver headers & before the driver .c files, then define
+ *  static uint8_t Sim_I2cSlave(const I2CM_Transfer *Xfer);  the slave side, returns the status
+ *  static void Sim_TickHook(void);
+ */
+
+#ifndef I2CM_SIM_H_
+#define I2CM_SIM_H_
+
+#include <signal.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "stm32f429i_discovery_i2c.h"
+
+#define SIM_TICK_US				(20)
+#define SIM_BYTE_US				((9U * 1000000U) / I2CM_I2C_SPEED)
+#ifndef SIM_IDLE_US
+#define SIM_IDLE_US				(100U)
+#endif
+
+/* Bus time in us, moves with the transactions & Sim_Elapse */
+static volatile uint32_t Sim_Now;
+static volatile uint32_t Sim_IdleUntil;
+static I2CM_Transfer Sim_Queue[I2CM_QUEUE_SIZE];
+static volatile uint32_t Sim_Head;
+static volatile uint32_t Sim_Tail;
+static volatile uint32_t Sim_Transactions;
+static volatile uint32_t Sim_Resets;
+
+static volatile uint32_t Sim_Primask;
+static volatile uint32_t Sim_Pending;
+static volatile uint32_t Sim_InTick;
+
+static uint8_t Sim_I2cSlave(const I2CM_Transfer *Xfer);
+static void Sim_TickHook(void);
+static void Sim_I2cTick(int Signal);
+
+/* PRIMASK: a tick coming while it is set runs when it is cleared, as a pended IRQ */
+static void Sim_SetPrimask(uint32_t Mask)
+{
+  Sim_Primask = (Mask != 0) ? 1 : 0;
+
+  if((Sim_Primask == 0) && (Sim_Pending != 0))
+  {
+    Sim_Pending = 0;
+    Sim_I2cTick(0);
+  }
+}
+
+static uint32_t Sim_GetPrimask(void)
+{
+  return Sim_Primask;
+}
+
+static void Sim_DisableIrq(void)
+{
+  Sim_SetPrimask(1);
+}
+
+static inline void Sim_EnableIrq(void)
+{
+  Sim_SetPrimask(0);
+}
+
+#define __get_PRIMASK			Sim_GetPrimask
+#define __set_PRIMASK			Sim_SetPrimask
+#define __disable_irq			Sim_DisableIrq
+#define __enable_irq			Sim_EnableIrq
+/* Interrupts are signals of the same thread, keeping the compiler in order is enough */
+#define __DMB()					__asm__ volatile("" ::: "memory")
+
+void I2CM_Init(void)
+{
+}
+
+void I2CM_DeInit(void)
+{
+}
+
+uint8_t I2CM_Submit(const I2CM_Transfer *Transfer)
+{
+  uint32_t primask = Sim_GetPrimask();
+  uint8_t ret = I2CM_OK;
+
+  if(((Transfer->Direction == I2CM_DIR_READ) && (Transfer->Length == 0)) || (Transfer->RegSize > 2))
+  {
+    return I2CM_INVALID;
+  }
+
+  Sim_SetPrimask(1);
+
+  if((Sim_Head - Sim_Tail) >= I2CM_QUEUE_SIZE)
+  {
+    ret = I2CM_QUEUE_FULL;
+  }
+  else
+  {
+    Sim_Queue[Sim_Head % I2CM_QUEUE_SIZE] = *Transfer;
+    Sim_Head++;
+  }
+
+  Sim_SetPrimask(primask);
+
+  return ret;
+}
+
+/* Every queued transaction ends with I2CM_TIMEOUT */
+void I2CM_Reset(void)
+{
+  uint32_t primask = Sim_GetPrimask();
+  I2CM_Transfer xfer;
+
+  Sim_SetPrimask(1);
+  Sim_Resets++;
+
+  while(Sim_Head != Sim_Tail)
+  {
+    xfer = Sim_Queue[Sim_Tail % I2CM_QUEUE_SIZE];
+    Sim_Tail++;
+
+    if(xfer.Callback != 0)
+    {
+      xfer.Callback(xfer.Context, I2CM_TIMEOUT);
+    }
+  }
+
+  Sim_SetPrimask(primask);
+}
+
+static void Sim_RunDone(void *Context, uint8_t Status)
+{
+  *(volatile uint8_t *)Context = Status;
+}
+
+/* The model never stalls the bus, no timeout */
+uint8_t I2CM_Run(const I2CM_Transfer *Transfer)
+{
+  I2CM_Transfer xfer = *Transfer;
+  volatile uint8_t status = I2CM_PENDING;
+  uint8_t ret;
+
+  xfer.Callback = Sim_RunDone;
+  xfer.Context = (void *)&status;
+
+  while((ret = I2CM_Submit(&xfer)) == I2CM_QUEUE_FULL)
+  {
+  }
+
+  if(ret != I2CM_OK)
+  {
+    return ret;
+  }
+
+  while(status == I2CM_PENDING)
+  {
+  }
+
+  return status;
+}
+
+/* Timer tick = I2CM finishing the running transaction & calling its callback */
+static void Sim_I2cTick(int Signal)
+{
+  I2CM_Transfer xfer;
+  uint32_t idle = 0;
+  uint8_t status;
+
+  (void)Signal;
+
+  if((Sim_Primask != 0) || (Sim_InTick != 0))
+  {
+    Sim_Pending = 1;
+    return;
+  }
+
+  Sim_InTick = 1;
+
+  if(Sim_Head != Sim_Tail)
+  {
+    xfer = Sim_Queue[Sim_Tail % I2CM_QUEUE_SIZE];
+    status = Sim_I2cSlave(&xfer);
+    Sim_Transactions++;
+
+    /* Popped first: the callback may queue the next one */
+    Sim_Tail++;
+
+    if(xfer.Callback != 0)
+    {
+      xfer.Callback(xfer.Context, status);
+    }
+  }
+  else if((int32_t)(Sim_IdleUntil - Sim_Now) > 0)
+  {
+    idle = Sim_IdleUntil - Sim_Now;
+    Sim_Now += (idle < SIM_IDLE_US) ? idle : SIM_IDLE_US;
+  }
+
+  Sim_TickHook();
+  Sim_InTick = 0;
+}
+
+/* The application busy elsewhere for Us while the bus & the interrupts go on */
+static void Sim_Elapse(uint32_t Us)
+{
+  Sim_IdleUntil = Sim_Now + Us;
+
+  while((int32_t)(Sim_IdleUntil - Sim_Now) > 0)
+  {
+  }
+}
+
+static void Sim_Start(void)
+{
+  struct sigaction action;
+  struct itimerval timer;
+
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = Sim_I2cTick;
+  action.sa_flags = SA_RESTART;
+  sigaction(SIGALRM, &action, 0);
+
+  timer.it_interval.tv_sec = 0;
+  timer.it_interval.tv_usec = SIM_TICK_US;
+  timer.it_value = timer.it_interval;
+  setitimer(ITIMER_REAL, &timer, 0);
+}
+
+static void Sim_Stop(void)
+{
+  struct itimerval timer;
+
+  memset(&timer, 0, sizeof(timer));
+  setitimer(ITIMER_REAL, &timer, 0);
+}
+
+#endif /* I2CM_SIM_H_ */
@@ -0,0 +1,839 @@
+/*
+ * i2cm_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ *
+ *  Host test of the I2C3 transaction queue (stm32f429i_discovery_i2c.c) over a register
+ *  model of I2C3, DMA1 Stream2, GPIOA/C & NVIC (cpu_sim.h), the Standard Peripheral
+ *  Library running on the model registers; I2CM_EV_IRQHandler, I2CM_ER_IRQHandler &
+ *  I2CM_DMA_RX_IRQHandler are the real ones, taken from the I2C3 & stream flags
+ *  - I2C3 master at I2CM_I2C_SPEED: START / STOP after one bit time, address & data bytes
+ *    after 9; SB, ADDR (cleared by the SR2 read), TXE, BTF, RXNE, AF; the received byte
+ *    is acknowledged per CR1 ACK, or not when DMAEN & LAST are set & the stream has one
+ *    byte left; the next byte is clocked only after an ACK, STOP waits for the byte
+ *  - DMA1 Stream2 on channel 3 takes RXNE, TCIF2 & interrupt at NDTR 0
+ *  - Slave: an M24LR64 like EEPROM at 0xA0, 2 address bytes, data bytes NACKed from
+ *    SIM_SLAVE_WP; it counts the bytes it sends & any sent after the master's NACK
+ *  - NACK on the address, NACK on a data byte, 1 byte read on RXNE, N byte reads on
+ *    DMA with LAST: exactly N bytes leave the slave, the last one NACKed
+ *  - I2CM_DMA_BUSY while the stream is the UART4 Rx ring's (channel 4), left untouched;
+ *    a 1 byte read still runs
+ *  - Several queued reads failing: I2CM_Finish -> I2CM_StartNext ends each one in turn,
+ *    in order, from the interrupt of the transaction before them
+ *  - Figures: bus time & ISR cycles of a 1 byte & a 16 byte read
+ *
+ *  Build & run from tools/host:
+ *  gcc -O2 -fno-tree-vectorize -fno-tree-loop-distribute-patterns -no-pie -Wall -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast \
+ *      -DSTM32F42_43xxx -DUSE_STDPERIPH_DRIVER -I../../Utilities/STM32F429I-Discovery \
+ *      -I../../Libraries/CMSIS/Include -I../../Libraries/Device/ST/STM32F4xx/Include \
+ *      -I../../Libraries/STM32F4xx_StdPeriph_Driver/inc -I../../src i2cm_test.c \
+ *      -o i2cm_test && ./i2cm_test
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stm32f429i_discovery_i2c.h"
+#include "cpu_sim.h"
+
+/* CMSIS cpsid / cpsie are compiler barriers too */
+#define __get_PRIMASK			Sim_GetPrimask
+#define __set_PRIMASK(Mask)		do { __asm__ volatile("" ::: "memory"); Sim_SetPrimask(Mask); __asm__ volatile("" ::: "memory"); } while(0)
+#define __disable_irq()			do { __asm__ volatile("" ::: "memory"); Sim_DisableIrq(); __asm__ volatile("" ::: "memory"); } while(0)
+#define __enable_irq()			do { __asm__ volatile("" ::: "memory"); Sim_EnableIrq(); __asm__ volatile("" ::: "memory"); } while(0)
+
+#include "../../Libraries/STM32F4xx_StdPeriph_Driver/src/misc.c"
+#include "../../Libraries/STM32F4xx_StdPeriph_Driver/src/stm32f4xx_rcc.c"
+#include "../../Libraries/STM32F4xx_StdPeriph_Driver/src/stm32f4xx_gpio.c"
+/* stm32f4xx_rcc.c's private one */
+#undef FLAG_MASK
+#include "../../Libraries/STM32F4xx_StdPeriph_Driver/src/stm32f4xx_i2c.c"
+#include "../../Libraries/STM32F4xx_StdPeriph_Driver/src/stm32f4xx_dma.c"
+#include "../../Utilities/STM32F429I-Discovery/stm32f429i_discovery_i2c.c"
+
+#define SIM_HCLK				(180000000UL)
+#define SIM_BIT					((uint64_t)(SIM_HCLK / I2CM_I2C_SPEED))
+
+#define SIM_I2C_CR1				((uint32_t)(uintptr_t)&I2C3->CR1)
+#define SIM_I2C_CR2				((uint32_t)(uintptr_t)&I2C3->CR2)
+#define SIM_I2C_DR				((uint32_t)(uintptr_t)&I2C3->DR)
+#define SIM_I2C_SR1				((uint32_t)(uintptr_t)&I2C3->SR1)
+#define SIM_I2C_SR2				((uint32_t)(uintptr_t)&I2C3->SR2)
+#define SIM_LISR				((uint32_t)(uintptr_t)&DMA1->LISR)
+#define SIM_LIFCR				((uint32_t)(uintptr_t)&DMA1->LIFCR)
+#define SIM_S2CR				((uint32_t)(uintptr_t)&DMA1_Stream2->CR)
+#define SIM_S2NDTR				((uint32_t)(uintptr_t)&DMA1_Stream2->NDTR)
+#define SIM_S2M0AR				((uint32_t)(uintptr_t)&DMA1_Stream2->M0AR)
+#define SIM_ISER				((uint32_t)(uintptr_t)&NVIC->ISER[0])
+#define SIM_ICER				((uint32_t)(uintptr_t)&NVIC->ICER[0])
+#define SIM_IP					((uint32_t)(uintptr_t)&NVIC->IP[0])
+#define SIM_AIRCR				((uint32_t)(uintptr_t)&SCB->AIRCR)
+
+/* SR1 bits cleared by writing 0, the others are read only */
+#define SIM_SR1_W0				(I2C_SR1_SMBALERT | I2C_SR1_TIMEOUT | I2C_SR1_PECERR | I2C_SR1_OVR | I2C_SR1_AF | I2C_SR1_ARLO | I2C_SR1_BERR)
+
+/* Bus operation ending at Sim_BusEnd */
+#define SIM_OP_NONE				(0U)
+#define SIM_OP_START			(1U)
+#define SIM_OP_ADDR				(2U)
+#define SIM_OP_TX				(3U)
+#define SIM_OP_RX				(4U)
+#define SIM_OP_STOP				(5U)
+
+/* Master after the address: none, transmitter or receiver data phase */
+#define SIM_PHASE_NONE			(0U)
+#define SIM_PHASE_DATA			(1U)
+
+#define SIM_SLAVE_ADDR			(0xA0U)
+#define SIM_SLAVE_ABSENT		(0xB0U)
+#define SIM_SLAVE_SIZE			(0x2000U)
+#define SIM_SLAVE_WP			(0x1F00U)
+
+#define TEST_READ				(16U)
+#define TEST_WRITE				(4U)
+#define TEST_CHAIN				(I2CM_QUEUE_SIZE - 1U)
+#define TEST_RING				(64U)
+#define TEST_WAIT				(100000U)
+
+/* I2C3 */
+static uint32_t Sim_Sr1;
+static uint32_t Sim_Msl;
+static uint32_t Sim_Tra;
+static uint32_t Sim_Phase;
+static uint32_t Sim_BusOp;
+static uint64_t Sim_BusEnd;
+static uint8_t Sim_ShiftByte;
+static uint32_t Sim_DrFull;
+static uint8_t Sim_DrByte;
+static uint8_t Sim_RxByte;
+/* Receiver: the master NACKed, no more byte is clocked */
+static uint32_t Sim_RxDone;
+/* Byte written to DR with no transfer to take it */
+static uint32_t Sim_Stray;
+
+/* DMA1 Stream2: NDTR when enabled */
+static uint32_t Sim_DmaLength;
+
+/* Slave */
+static uint8_t Sim_SlaveMem[SIM_SLAVE_SIZE];
+static uint32_t Sim_SlaveSelected;
+static uint32_t Sim_SlaveRead;
+static uint32_t Sim_SlavePtrBytes;
+static uint32_t Sim_SlavePtr;
+static uint32_t Sim_SlaveNacked;
+static uint32_t Sim_SlaveSent;
+static uint32_t Sim_SlaveAfterNack;
+static uint32_t Sim_SlaveWritten;
+static uint32_t Sim_SlaveStops;
+
+typedef struct
+{
+  volatile uint8_t Status;
+  uint32_t Order;
+  uint32_t InIrq;
+  uint32_t EvTaken;
+} Test_Result;
+
+static uint32_t u32Failures;
+static uint32_t Test_Order;
+
+#define CHECK(cond, ...)	do{ if(!(cond)){ u32Failures++; printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } }while(0)
+
+/* Slave side of a START, the address byte, a written byte, a read byte & its acknowledge */
+static void Sim_SlaveStart(void)
+{
+  Sim_SlaveSelected = 0;
+  Sim_SlaveNacked = 0;
+}
+
+static uint32_t Sim_SlaveAddress(uint8_t Byte)
+{
+  if((Byte & 0xFEU) != SIM_SLAVE_ADDR)
+  {
+    return 0;
+  }
+  Sim_SlaveSelected = 1;
+  Sim_SlaveRead = Byte & 1U;
+  Sim_SlavePtrBytes = 0;
+  return 1;
+}
+
+static uint32_t Sim_SlaveWrite(uint8_t Byte)
+{
+  if(Sim_SlavePtrBytes < 2U)
+  {
+    Sim_SlavePtr = ((Sim_SlavePtr << 8) | Byte) & (SIM_SLAVE_SIZE - 1U);
+    Sim_SlavePtrBytes++;
+    return 1;
+  }
+  /* Write protected area */
+  if(Sim_SlavePtr >= SIM_SLAVE_WP)
+  {
+    return 0;
+  }
+  Sim_SlaveMem[Sim_SlavePtr] = Byte;
+  Sim_SlavePtr = (Sim_SlavePtr + 1U) & (SIM_SLAVE_SIZE - 1U);
+  Sim_SlaveWritten++;
+  return 1;
+}
+
+static uint8_t Sim_SlaveSend(void)
+{
+  uint8_t byte = Sim_SlaveMem[Sim_SlavePtr];
+
+  if(Sim_SlaveNacked != 0)
+  {
+    Sim_SlaveAfterNack++;
+  }
+  Sim_SlavePtr = (Sim_SlavePtr + 1U) & (SIM_SLAVE_SIZE - 1U);
+  Sim_SlaveSent++;
+  return byte;
+}
+
+/* Event, error & stream lines are levels: pending while high */
+static void Sim_Lines(void)
+{
+  uint32_t cr2 = Sim_Reg(SIM_I2C_CR2), ev = 0, er = 0, dma = 0, s2cr = Sim_Reg(SIM_S2CR), lisr = Sim_Reg(SIM_LISR);
+
+  ev = (((cr2 & I2C_CR2_ITEVTEN) != 0) && (((Sim_Sr1 & (I2C_SR1_SB | I2C_SR1_ADDR | I2C_SR1_BTF)) != 0)
+        || (((cr2 & I2C_CR2_ITBUFEN) != 0) && ((Sim_Sr1 & (I2C_SR1_TXE | I2C_SR1_RXNE)) != 0)))) ? 1U : 0U;
+  er = (((cr2 & I2C_CR2_ITERREN) != 0) && ((Sim_Sr1 & (I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_AF | I2C_SR1_OVR)) != 0)) ? 1U : 0U;
+  dma = ((((lisr & DMA_LISR_TCIF2) != 0) && ((s2cr & DMA_SxCR_TCIE) != 0))
+         || (((lisr & DMA_LISR_TEIF2) != 0) && ((s2cr & DMA_SxCR_TEIE) != 0))) ? 1U : 0U;
+
+  Sim_IrqPending[I2CM_EV_IRQn] = (uint8_t)ev;
+  Sim_IrqPending[I2CM_ER_IRQn] = (uint8_t)er;
+  Sim_IrqPending[I2CM_DMA_RX_IRQn] = (uint8_t)dma;
+}
+
+static void Sim_BusStart(uint32_t Op, uint64_t Bits)
+{
+  Sim_BusOp = Op;
+  Sim_BusEnd = Sim_Cycles + (Bits * SIM_BIT);
+}
+
+/* A byte ends on the bus */
+static void Sim_BusDone(void)
+{
+  uint32_t cr1 = Sim_Reg(SIM_I2C_CR1), cr2 = Sim_Reg(SIM_I2C_CR2), s2cr = Sim_Reg(SIM_S2CR), nack = 0;
+
+  switch(Sim_BusOp)
+  {
+  case SIM_OP_START:
+    Sim_Sr1 = (Sim_Sr1 & ~(uint32_t)(I2C_SR1_BTF | I2C_SR1_TXE | I2C_SR1_RXNE)) | I2C_SR1_SB;
+    Sim_Msl = 1;
+    Sim_Tra = 0;
+    Sim_Phase = SIM_PHASE_NONE;
+    Sim_DrFull = 0;
+    Sim_RxDone = 0;
+    Sim_SetReg(SIM_I2C_CR1, cr1 & ~(uint32_t)I2C_CR1_START);
+    Sim_SlaveStart();
+    break;
+
+  case SIM_OP_ADDR:
+    if(Sim_SlaveAddress(Sim_ShiftByte) != 0)
+    {
+      Sim_Sr1 |= I2C_SR1_ADDR;
+      Sim_Tra = ((Sim_ShiftByte & 1U) == 0) ? 1U : 0U;
+    }
+    else
+    {
+      Sim_Sr1 |= I2C_SR1_AF;
+    }
+    break;
+
+  case SIM_OP_TX:
+    if((Sim_SlaveSelected == 0) || (Sim_SlaveWrite(Sim_ShiftByte) == 0))
+    {
+      Sim_Sr1 |= I2C_SR1_AF;
+      Sim_DrFull = 0;
+    }
+    else if(Sim_DrFull == 0)
+    {
+      Sim_Sr1 |= I2C_SR1_BTF;
+    }
+    break;
+
+  case SIM_OP_RX:
+    /* LAST: the byte the stream takes last is not acknowledged */
+    nack = (((cr1 & I2C_CR1_ACK) == 0)
+            || (((cr2 & (I2C_CR2_DMAEN | I2C_CR2_LAST)) == (I2C_CR2_DMAEN | I2C_CR2_LAST))
+                && ((s2cr & DMA_SxCR_EN) != 0) && (Sim_Reg(SIM_S2NDTR) == 1U))) ? 1U : 0U;
+    Sim_SlaveNacked = nack;
+    Sim_RxDone = nack;
+    Sim_Sr1 |= I2C_SR1_RXNE;
+    break;
+
+  case SIM_OP_STOP:
+    Sim_Msl = 0;
+    Sim_Tra = 0;
+    Sim_Phase = SIM_PHASE_NONE;
+    Sim_DrFull = 0;
+    Sim_Sr1 &= ~(uint32_t)(I2C_SR1_SB | I2C_SR1_ADDR | I2C_SR1_BTF | I2C_SR1_TXE);
+    Sim_SetReg(SIM_I2C_CR1, cr1 & ~(uint32_t)I2C_CR1_STOP);
+    Sim_SlaveSelected = 0;
+    Sim_SlaveStops++;
+    break;
+
+  default:
+    break;
+  }
+
+  Sim_BusOp = SIM_OP_NONE;
+}
+
+/* Move the bus & the stream up to Sim_Cycles */
+static void Sim_Service(void)
+{
+  uint32_t cr1 = 0, cr2 = 0, s2cr = 0, n = 0;
+  int moved = 1;
+
+  while(moved != 0)
+  {
+    moved = 0;
+    cr1 = Sim_Reg(SIM_I2C_CR1);
+    cr2 = Sim_Reg(SIM_I2C_CR2);
+
+    if((Sim_BusOp != SIM_OP_NONE) && (Sim_BusEnd <= Sim_Cycles))
+    {
+      Sim_BusDone();
+      moved = 1;
+      continue;
+    }
+
+    /* DMA1 Stream2 takes the received byte on channel 3 */
+    s2cr = Sim_Reg(SIM_S2CR);
+    if(((Sim_Sr1 & I2C_SR1_RXNE) != 0) && ((cr2 & I2C_CR2_DMAEN) != 0) && ((s2cr & DMA_SxCR_EN) != 0)
+       && ((s2cr & DMA_SxCR_CHSEL) == I2CM_DMA_CHANNEL))
+    {
+      n = Sim_Reg(SIM_S2NDTR);
+      *(uint8_t *)(uintptr_t)(Sim_Reg(SIM_S2M0AR) + Sim_DmaLength - n) = Sim_RxByte;
+      Sim_Sr1 &= ~(uint32_t)I2C_SR1_RXNE;
+      Sim_SetReg(SIM_S2NDTR, --n);
+      if(n == 0)
+      {
+        Sim_SetReg(SIM_S2CR, s2cr & ~DMA_SxCR_EN);
+        Sim_SetReg(SIM_LISR, Sim_Reg(SIM_LISR) | DMA_LISR_TCIF2);
+      }
+      moved = 1;
+      continue;
+    }
+
+    if((Sim_BusOp != SIM_OP_NONE) || ((cr1 & I2C_CR1_PE) == 0))
+    {
+      continue;
+    }
+
+    if(((cr1 & I2C_CR1_STOP) != 0) && (Sim_Msl != 0))
+    {
+      /* A receiver still owes the byte of a single byte read */
+      if((Sim_Phase == SIM_PHASE_DATA) && (Sim_Tra == 0) && (Sim_RxDone == 0) && ((Sim_Sr1 & I2C_SR1_RXNE) == 0)
+         && ((cr1 & I2C_CR1_ACK) == 0))
+      {
+        Sim_RxByte = Sim_SlaveSend();
+        Sim_BusStart(SIM_OP_RX, 9U);
+      }
+      else
+      {
+        Sim_BusStart(SIM_OP_STOP, 1U);
+      }
+      moved = 1;
+    }
+    else if((cr1 & I2C_CR1_START) != 0)
+    {
+      Sim_Sr1 &= ~(uint32_t)I2C_SR1_BTF;
+      Sim_BusStart(SIM_OP_START, 1U);
+      moved = 1;
+    }
+    else if((Sim_Phase == SIM_PHASE_DATA) && (Sim_Tra != 0) && (Sim_DrFull != 0) && ((Sim_Sr1 & I2C_SR1_AF) == 0))
+    {
+      Sim_ShiftByte = Sim_DrByte;
+      Sim_DrFull = 0;
+      Sim_Sr1 &= ~(uint32_t)I2C_SR1_BTF;
+      Sim_BusStart(SIM_OP_TX, 9U);
+      moved = 1;
+    }
+    else if((Sim_Phase == SIM_PHASE_DATA) && (Sim_Tra == 0) && (Sim_RxDone == 0) && ((Sim_Sr1 & I2C_SR1_RXNE) == 0)
+            && (Sim_Msl != 0))
+    {
+      Sim_RxByte = Sim_SlaveSend();
+      Sim_BusStart(SIM_OP_RX, 9U);
+      moved = 1;
+    }
+  }
+
+  if((Sim_Phase == SIM_PHASE_DATA) && (Sim_Tra != 0) && (Sim_DrFull == 0))
+  {
+    Sim_Sr1 |= I2C_SR1_TXE;
+  }
+  else
+  {
+    Sim_Sr1 &= ~(uint32_t)I2C_SR1_TXE;
+  }
+  Sim_SetReg(SIM_I2C_SR1, Sim_Sr1);
+  Sim_SetReg(SIM_I2C_SR2, ((Sim_Msl != 0) ? (I2C_SR2_MSL | I2C_SR2_BUSY) : 0U) | ((Sim_Tra != 0) ? I2C_SR2_TRA : 0U));
+  Sim_Lines();
+
+  Sim_NextEvent = (Sim_BusOp != SIM_OP_NONE) ? Sim_BusEnd : SIM_NEVER;
+}
+
+static void Sim_I2cReset(void)
+{
+  Sim_Sr1 = 0;
+  Sim_Msl = 0;
+  Sim_Tra = 0;
+  Sim_Phase = SIM_PHASE_NONE;
+  Sim_BusOp = SIM_OP_NONE;
+  Sim_DrFull = 0;
+  Sim_RxDone = 0;
+}
+
+static void Sim_RegRead(uint32_t Address)
+{
+  Sim_Service();
+
+  if(Sim_AccessWrite != 0)
+  {
+    return;
+  }
+
+  /* Reading DR takes the received byte, reading SR2 clears ADDR: the next byte may start */
+  if(Address == SIM_I2C_DR)
+  {
+    Sim_SetReg(SIM_I2C_DR, Sim_RxByte);
+    Sim_Sr1 &= ~(uint32_t)(I2C_SR1_RXNE | I2C_SR1_BTF);
+    Sim_Service();
+  }
+  else if((Address == SIM_I2C_SR2) && ((Sim_Sr1 & I2C_SR1_ADDR) != 0))
+  {
+    Sim_Sr1 &= ~(uint32_t)I2C_SR1_ADDR;
+    Sim_Phase = SIM_PHASE_DATA;
+    Sim_Service();
+  }
+}
+
+static void Sim_RegWrite(uint32_t Address, uint32_t Old)
+{
+  uint32_t value = Sim_Reg(Address), i = 0;
+
+  if(Address == SIM_I2C_DR)
+  {
+    if((Sim_Sr1 & I2C_SR1_SB) != 0)
+    {
+      /* Address byte */
+      Sim_Sr1 &= ~(uint32_t)I2C_SR1_SB;
+      Sim_ShiftByte = (uint8_t)value;
+      Sim_BusStart(SIM_OP_ADDR, 9U);
+    }
+    else if((Sim_Phase == SIM_PHASE_DATA) && (Sim_Tra != 0) && (Sim_DrFull == 0))
+    {
+      Sim_DrByte = (uint8_t)value;
+      Sim_DrFull = 1;
+      Sim_Sr1 &= ~(uint32_t)I2C_SR1_BTF;
+    }
+    else
+    {
+      Sim_Stray++;
+    }
+  }
+  else if(Address == SIM_I2C_SR1)
+  {
+    Sim_Sr1 = (Sim_Sr1 & ~(uint32_t)SIM_SR1_W0) | (Sim_Sr1 & value & SIM_SR1_W0);
+  }
+  else if(Address == SIM_I2C_CR1)
+  {
+    if(((value & I2C_CR1_SWRST) != 0) || ((value & I2C_CR1_PE) == 0))
+    {
+      Sim_I2cReset();
+      Sim_SetReg(SIM_I2C_CR1, value & ~(uint32_t)(I2C_CR1_START | I2C_CR1_STOP));
+    }
+  }
+  else if(Address == SIM_LIFCR)
+  {
+    Sim_SetReg(SIM_LISR, Sim_Reg(SIM_LISR) & ~value);
+    Sim_SetReg(SIM_LIFCR, 0);
+  }
+  else if(Address == SIM_S2CR)
+  {
+    if(((Old & DMA_SxCR_EN) == 0) && ((value & DMA_SxCR_EN) != 0))
+    {
+      Sim_DmaLength = Sim_Reg(SIM_S2NDTR);
+    }
+  }
+  else if((Address >= SIM_ISER) && (Address < (SIM_ISER + 32U)))
+  {
+    for(i = 0; i < 32U; i++)
+    {
+      if((value & (1UL << i)) != 0)
+      {
+        Sim_IrqEnabled[((Address - SIM_ISER) * 8U) + i] = 1;
+      }
+    }
+    Sim_SetReg(Address, Old | value);
+    Sim_SetReg(Address + 0x80U, Old | value);
+  }
+  else if((Address >= SIM_ICER) && (Address < (SIM_ICER + 32U)))
+  {
+    for(i = 0; i < 32U; i++)
+    {
+      if((value & (1UL << i)) != 0)
+      {
+        Sim_IrqEnabled[((Address - SIM_ICER) * 8U) + i] = 0;
+      }
+    }
+    Sim_SetReg(Address, Old & ~value);
+    Sim_SetReg(Address - 0x80U, Old & ~value);
+  }
+  else if((Address >= SIM_IP) && (Address < (SIM_IP + 240U)))
+  {
+    /* 4 bits of priority per IRQ, as the NVIC implements them */
+    for(i = 0; i < 4U; i++)
+    {
+      Sim_IrqPriority[(Address - SIM_IP) + i] = (uint8_t)((value >> (8U * i)) >> 4);
+    }
+  }
+
+  Sim_Service();
+}
+
+static void Sim_Tick(void)
+{
+  Sim_Service();
+}
+
+static void Sim_Reset(void)
+{
+  uint32_t i = 0;
+
+  for(i = 0; i < SIM_SLAVE_SIZE; i++)
+  {
+    Sim_SlaveMem[i] = (uint8_t)((i * 13U) ^ (i >> 8));
+  }
+  Sim_I2cReset();
+
+  /* The application's NVIC_PriorityGroupConfig(NVIC_PriorityGroup_4) */
+  Sim_SetReg(SIM_AIRCR, 0xFA050300U);
+}
+
+static void Test_Done(void *Context, uint8_t Status)
+{
+  Test_Result *result = (Test_Result *)Context;
+
+  result->Order = Test_Order++;
+  result->InIrq = Sim_IrqDepth;
+  result->EvTaken = Sim_IrqTaken[I2CM_EV_IRQn];
+  result->Status = Status;
+}
+
+static void Test_Transfer(I2CM_Transfer *Xfer, uint8_t Address, uint8_t Direction, uint16_t Register,
+                          uint8_t *Buffer, uint16_t Length, Test_Result *Result)
+{
+  Xfer->Address = Address;
+  Xfer->Direction = Direction;
+  Xfer->RegSize = 2;
+  Xfer->Register = Register;
+  Xfer->Buffer = Buffer;
+  Xfer->Length = Length;
+  Xfer->Callback = Test_Done;
+  Xfer->Context = Result;
+  Result->Status = I2CM_PENDING;
+}
+
+/* Sleep till the transaction's callback */
+static void Test_Wait(Test_Result *Result)
+{
+  uint32_t guard = 0;
+
+  while((Result->Status == I2CM_PENDING) && (guard++ < TEST_WAIT))
+  {
+    Sim_Wfi();
+  }
+}
+
+/* Queue one transaction & wait for it: its status */
+static uint8_t Test_Run(uint8_t Address, uint8_t Direction, uint16_t Register, uint8_t *Buffer, uint16_t Length)
+{
+  I2CM_Transfer xfer;
+  Test_Result result;
+  uint8_t ret = 0;
+
+  Test_Transfer(&xfer, Address, Direction, Register, Buffer, Length, &result);
+  ret = I2CM_Submit(&xfer);
+  if(ret != I2CM_OK)
+  {
+    return ret;
+  }
+  Test_Wait(&result);
+  return result.Status;
+}
+
+/* Bus released once the STOP is out & peripheral back in its idle configuration */
+static uint32_t Test_Idle(void)
+{
+  uint32_t cr2 = Sim_Reg(SIM_I2C_CR2);
+
+  Sim_Wfi();
+
+  return ((Sim_Msl == 0) && (Sim_BusOp == SIM_OP_NONE) && (I2CM_IsBusy() == 0)
+          && ((cr2 & (I2C_CR2_ITEVTEN | I2C_CR2_ITBUFEN | I2C_CR2_ITERREN | I2C_CR2_DMAEN | I2C_CR2_LAST)) == 0)
+          && ((Sim_Reg(SIM_I2C_CR1) & I2C_CR1_ACK) != 0)) ? 1U : 0U;
+}
+
+/* UART4 Rx ring on DMA1 Stream2 channel 4, as xUSART_StartRxRing_DMA leaves it */
+static void Test_RingStart(uint8_t *Ring)
+{
+  DMA_InitTypeDef init;
+
+  DMA_DeInit(DMA1_Stream2);
+  DMA_StructInit(&init);
+  init.DMA_Channel = DMA_Channel_4;
+  init.DMA_PeripheralBaseAddr = (uint32_t)&UART4->DR;
+  init.DMA_Memory0BaseAddr = (uint32_t)(uintptr_t)Ring;
+  init.DMA_DIR = DMA_DIR_PeripheralToMemory;
+  init.DMA_BufferSize = TEST_RING;
+  init.DMA_MemoryInc = DMA_MemoryInc_Enable;
+  init.DMA_Mode = DMA_Mode_Circular;
+  DMA_Init(DMA1_Stream2, &init);
+  DMA_ITConfig(DMA1_Stream2, DMA_IT_HT | DMA_IT_TC, ENABLE);
+  DMA_Cmd(DMA1_Stream2, ENABLE);
+}
+
+static void Test_Init(void)
+{
+  Sim_StepOn();
+  I2CM_Init();
+  Sim_StepOff();
+
+  CHECK((Sim_Reg(SIM_I2C_CR1) & (I2C_CR1_PE | I2C_CR1_ACK)) == (I2C_CR1_PE | I2C_CR1_ACK), "CR1 0x%04lX",
+        (unsigned long)Sim_Reg(SIM_I2C_CR1));
+  CHECK((Sim_IrqEnabled[I2CM_EV_IRQn] != 0) && (Sim_IrqEnabled[I2CM_ER_IRQn] != 0) && (Sim_IrqEnabled[I2CM_DMA_RX_IRQn] != 0),
+        "I2C3 EV / ER / DMA1 Stream2 IRQs not enabled");
+  CHECK(I2CM_IT_PREPRIO == Sim_IrqPriority[I2CM_EV_IRQn], "I2C3 EV priority %u", Sim_IrqPriority[I2CM_EV_IRQn]);
+}
+
+/* Page write, then the data bytes NACKed by the write protected area */
+static void Test_Write(void)
+{
+  uint8_t data[TEST_WRITE] = {0x11, 0x22, 0x33, 0x44};
+  uint32_t written = Sim_SlaveWritten, errors = I2CM_GetErrors();
+  uint8_t status = 0;
+
+  Sim_StepOn();
+  status = Test_Run(SIM_SLAVE_ADDR, I2CM_DIR_WRITE, 0x0100, data, TEST_WRITE);
+  Sim_StepOff();
+
+  CHECK(I2CM_OK == status, "write: status %u", status);
+  CHECK(0 == memcmp(&Sim_SlaveMem[0x0100], data, TEST_WRITE), "write: slave memory differs");
+  CHECK((TEST_WRITE == (Sim_SlaveWritten - written)) && (errors == I2CM_GetErrors()), "write: %lu bytes written",
+        (unsigned long)(Sim_SlaveWritten - written));
+  CHECK(Test_Idle() != 0, "write: bus not released");
+
+  /* 2 bytes fit below SIM_SLAVE_WP, the third one is NACKed */
+  written = Sim_SlaveWritten;
+  Sim_StepOn();
+  status = Test_Run(SIM_SLAVE_ADDR, I2CM_DIR_WRITE, SIM_SLAVE_WP - 2U, data, TEST_WRITE);
+  Sim_StepOff();
+
+  CHECK(I2CM_NACK == status, "data NACK: status %u", status);
+  CHECK(2U == (Sim_SlaveWritten - written), "data NACK: %lu bytes written", (unsigned long)(Sim_SlaveWritten - written));
+  CHECK((errors + 1U) == I2CM_GetErrors(), "data NACK: %lu errors", (unsigned long)(I2CM_GetErrors() - errors));
+  CHECK(Test_Idle() != 0, "data NACK: bus not released");
+  CHECK(0 == Sim_Stray, "data NACK: %lu bytes written to DR out of a transfer", (unsigned long)Sim_Stray);
+}
+
+/* No slave at the address */
+static void Test_AddressNack(void)
+{
+  uint8_t data[2] = {0, 0};
+  uint32_t errors = I2CM_GetErrors(), stops = Sim_SlaveStops;
+  uint8_t status = 0;
+
+  Sim_StepOn();
+  status = Test_Run(SIM_SLAVE_ABSENT, I2CM_DIR_READ, 0x0100, data, 2);
+  Sim_StepOff();
+
+  CHECK(I2CM_NACK == status, "address NACK: status %u", status);
+  CHECK((errors + 1U) == I2CM_GetErrors(), "address NACK: %lu errors", (unsigned long)(I2CM_GetErrors() - errors));
+  CHECK(Test_Idle() != 0, "address NACK: bus not released");
+  CHECK((stops + 1U) == Sim_SlaveStops, "address NACK: %lu STOPs", (unsigned long)(Sim_SlaveStops - stops));
+  CHECK(0 == (Sim_Reg(SIM_S2CR) & DMA_SxCR_EN), "address NACK: RX stream left enabled");
+}
+
+/* A read of Length bytes: exactly Length leave the slave, the last one NACKed */
+static void Test_Read(uint16_t Length)
+{
+  static uint8_t data[TEST_READ + 1U];
+  uint64_t cycles = 0, irq = 0;
+  uint32_t sent = 0, after = Sim_SlaveAfterNack, ev = Sim_IrqTaken[I2CM_EV_IRQn], dma = Sim_IrqTaken[I2CM_DMA_RX_IRQn];
+  uint8_t status = 0;
+
+  memset(data, 0x5A, sizeof(data));
+  Sim_SlaveNacked = 0;
+  Sim_StepOn();
+  cycles = Sim_Cycles;
+  irq = Sim_IrqCycles;
+  status = Test_Run(SIM_SLAVE_ADDR, I2CM_DIR_READ, 0x0100, data, Length);
+  cycles = Sim_Cycles - cycles;
+  irq = Sim_IrqCycles - irq;
+  Sim_StepOff();
+  ev = Sim_IrqTaken[I2CM_EV_IRQn] - ev;
+  dma = Sim_IrqTaken[I2CM_DMA_RX_IRQn] - dma;
+  sent = (Sim_SlavePtr - 0x0100U) & (SIM_SLAVE_SIZE - 1U);
+
+  CHECK(I2CM_OK == status, "%u byte read: status %u", Length, status);
+  CHECK(0 == memcmp(data, &Sim_SlaveMem[0x0100], Length), "%u byte read: data differs", Length);
+  CHECK(0x5A == data[Length], "%u byte read: written past the buffer", Length);
+  CHECK((Length == sent) && (Sim_SlaveNacked != 0) && (after == Sim_SlaveAfterNack),
+        "%u byte read: %lu bytes sent, last %s, %lu after the NACK", Length, (unsigned long)sent,
+        (Sim_SlaveNacked != 0) ? "NACKed" : "ACKed", (unsigned long)(Sim_SlaveAfterNack - after));
+  CHECK(((Length == 1U) ? 0U : 1U) == dma, "%u byte read: %lu DMA interrupts", Length, (unsigned long)dma);
+  CHECK(Test_Idle() != 0, "%u byte read: bus not released", Length);
+  CHECK(0 == (Sim_Reg(SIM_S2CR) & DMA_SxCR_EN), "%u byte read: RX stream left enabled", Length);
+
+  printf("%2u byte read (%s): %6.1f us on the bus, %lu EV + %lu DMA interrupts, ISR %lu cycles (%.2f us)\n",
+         Length, (Length == 1U) ? "RXNE" : "DMA, LAST", ((double)cycles * 1e6) / SIM_HCLK, (unsigned long)ev,
+         (unsigned long)dma, (unsigned long)irq, ((double)irq * 1e6) / SIM_HCLK);
+}
+
+/* The UART4 Rx ring owns DMA1 Stream2 */
+static void Test_DmaBusy(void)
+{
+  static uint8_t ring[TEST_RING];
+  static uint8_t data[TEST_READ];
+  uint32_t cr = 0, ndtr = 0, m0ar = 0;
+  uint8_t status = 0;
+
+  Sim_StepOn();
+  Test_RingStart(ring);
+  cr = Sim_Reg(SIM_S2CR);
+  ndtr = Sim_Reg(SIM_S2NDTR);
+  m0ar = Sim_Reg(SIM_S2M0AR);
+  status = Test_Run(SIM_SLAVE_ADDR, I2CM_DIR_READ, 0x0100, data, TEST_READ);
+  Sim_StepOff();
+
+  CHECK(I2CM_DMA_BUSY == status, "ring running: DMA read status %u", status);
+
+  Sim_StepOn();
+  status = Test_Run(SIM_SLAVE_ADDR, I2CM_DIR_READ, 0x0102, data, 1);
+  Sim_StepOff();
+
+  CHECK((I2CM_OK == status) && (Sim_SlaveMem[0x0102] == data[0]), "ring running: 1 byte read status %u", status);
+  CHECK((cr == Sim_Reg(SIM_S2CR)) && (ndtr == Sim_Reg(SIM_S2NDTR)) && (m0ar == Sim_Reg(SIM_S2M0AR)),
+        "ring running: stream changed, CR 0x%08lX NDTR %lu", (unsigned long)Sim_Reg(SIM_S2CR), (unsigned long)Sim_Reg(SIM_S2NDTR));
+  CHECK(Test_Idle() != 0, "ring running: bus not released");
+
+  Sim_StepOn();
+  DMA_Cmd(DMA1_Stream2, DISABLE);
+  status = Test_Run(SIM_SLAVE_ADDR, I2CM_DIR_READ, 0x0100, data, TEST_READ);
+  Sim_StepOff();
+
+  CHECK(I2CM_OK == status, "ring stopped: DMA read status %u", status);
+}
+
+/* Reads queued behind a write fail one after the other: the ring starts under them, then no slave */
+static void Test_FailChain(void)
+{
+  static uint8_t ring[TEST_RING];
+  static uint8_t data[TEST_CHAIN][TEST_READ];
+  uint8_t page[TEST_WRITE] = {1, 2, 3, 4};
+  I2CM_Transfer xfer;
+  Test_Result write, reads[TEST_CHAIN], last;
+  uint32_t i = 0, order = 0, busy = 0, inorder = 0, inirq = 0, errors = I2CM_GetErrors(), cr = 0;
+
+  Sim_StepOn();
+  Test_Order = 0;
+  Test_Transfer(&xfer, SIM_SLAVE_ADDR, I2CM_DIR_WRITE, 0x0200, page, TEST_WRITE, &write);
+  CHECK(I2CM_OK == I2CM_Submit(&xfer), "chain: write not queued");
+  for(i = 0; i < TEST_CHAIN; i++)
+  {
+    Test_Transfer(&xfer, SIM_SLAVE_ADDR, I2CM_DIR_READ, 0x0100, data[i], TEST_READ, &reads[i]);
+    CHECK(I2CM_OK == I2CM_Submit(&xfer), "chain: read %lu not queued", (unsigned long)i);
+  }
+  /* The write holds the bus: the reads are queued, the ring takes the stream */
+  Test_RingStart(ring);
+  cr = Sim_Reg(SIM_S2CR);
+  Test_Wait(&reads[TEST_CHAIN - 1U]);
+  Sim_StepOff();
+
+  for(i = 0; i < TEST_CHAIN; i++)
+  {
+    busy += (I2CM_DMA_BUSY == reads[i].Status) ? 1U : 0U;
+    inorder += (reads[i].Order == (i + 1U)) ? 1U : 0U;
+    /* All in the interrupt ending the write */
+    inirq += ((reads[i].InIrq != 0) && (reads[i].EvTaken == write.EvTaken)) ? 1U : 0U;
+  }
+  CHECK((I2CM_OK == write.Status) && (0 == write.Order), "chain: write status %u", write.Status);
+  CHECK(TEST_CHAIN == busy, "chain: %lu of %u reads I2CM_DMA_BUSY", (unsigned long)busy, TEST_CHAIN);
+  CHECK(TEST_CHAIN == inorder, "chain: %lu of %u reads ended in order", (unsigned long)inorder, TEST_CHAIN);
+  CHECK(TEST_CHAIN == inirq, "chain: %lu of %u reads ended in the write's interrupt", (unsigned long)inirq, TEST_CHAIN);
+  CHECK((errors + TEST_CHAIN) == I2CM_GetErrors(), "chain: %lu errors", (unsigned long)(I2CM_GetErrors() - errors));
+  CHECK(cr == Sim_Reg(SIM_S2CR), "chain: ring stream changed, CR 0x%08lX", (unsigned long)Sim_Reg(SIM_S2CR));
+  CHECK(Test_Idle() != 0, "chain: bus not released");
+  order = Test_Order;
+
+  /* No slave: each NACK ends in the error interrupt, which starts the next read */
+  Sim_StepOn();
+  DMA_Cmd(DMA1_Stream2, DISABLE);
+  errors = I2CM_GetErrors();
+  for(i = 0; i < TEST_CHAIN; i++)
+  {
+    Test_Transfer(&xfer, SIM_SLAVE_ABSENT, I2CM_DIR_READ, 0x0100, data[i], TEST_READ, &reads[i]);
+    CHECK(I2CM_OK == I2CM_Submit(&xfer), "NACK chain: read %lu not queued", (unsigned long)i);
+  }
+  Test_Transfer(&xfer, SIM_SLAVE_ADDR, I2CM_DIR_READ, 0x0100, data[0], TEST_READ, &last);
+  CHECK(I2CM_QUEUE_FULL != I2CM_Submit(&xfer), "NACK chain: last read not queued");
+  Test_Wait(&last);
+  Sim_StepOff();
+
+  busy = 0;
+  inorder = 0;
+  for(i = 0; i < TEST_CHAIN; i++)
+  {
+    busy += (I2CM_NACK == reads[i].Status) ? 1U : 0U;
+    inorder += (reads[i].Order == (order + i)) ? 1U : 0U;
+  }
+  CHECK(TEST_CHAIN == busy, "NACK chain: %lu of %u reads I2CM_NACK", (unsigned long)busy, TEST_CHAIN);
+  CHECK(TEST_CHAIN == inorder, "NACK chain: %lu of %u reads ended in order", (unsigned long)inorder, TEST_CHAIN);
+  CHECK((I2CM_OK == last.Status) && (0 == memcmp(data[0], &Sim_SlaveMem[0x0100], TEST_READ)),
+        "NACK chain: next read status %u", last.Status);
+  CHECK((errors + TEST_CHAIN) == I2CM_GetErrors(), "NACK chain: %lu errors", (unsigned long)(I2CM_GetErrors() - errors));
+  CHECK(Test_Idle() != 0, "NACK chain: bus not released");
+
+  printf("%u queued reads failed in turn: I2CM_DMA_BUSY in the write's interrupt, I2CM_NACK one per error interrupt\n",
+         TEST_CHAIN);
+}
+
+int main(void)
+{
+  if((Sim_MapBlock((uint32_t)(uintptr_t)I2C3, sizeof(I2C_TypeDef)) != 0)
+     || (Sim_MapBlock((uint32_t)(uintptr_t)GPIOA, 0xC00U) != 0)
+     || (Sim_MapBlock((uint32_t)(uintptr_t)RCC, sizeof(RCC_TypeDef)) != 0)
+     || (Sim_MapBlock((uint32_t)(uintptr_t)DMA1, 0x100U) != 0)
+     || (Sim_MapBlock(SCS_BASE, 0x1000U) != 0))
+  {
+    printf("I2C3 / GPIO / RCC / DMA1 / SCS addresses not free, build with -no-pie\n");
+    return 1;
+  }
+
+  Sim_CpuStart();
+  Sim_IrqConnect(I2CM_EV_IRQn, I2CM_EV_IRQHandler, I2CM_IT_PREPRIO);
+  Sim_IrqConnect(I2CM_ER_IRQn, I2CM_ER_IRQHandler, I2CM_IT_PREPRIO);
+  Sim_IrqConnect(I2CM_DMA_RX_IRQn, I2CM_DMA_RX_IRQHandler, I2CM_IT_PREPRIO);
+  Sim_Reset();
+
+  Test_Init();
+  Test_Write();
+  Test_AddressNack();
+  Test_Read(1);
+  Test_Read(2);
+  Test_Read(TEST_READ);
+  Test_DmaBusy();
+  Test_FailChain();
+
+  printf("%s (%lu failures)\n", (0 == u32Failures) ? "PASS" : "FAIL", (unsigned long)u32Failures);
+
+  return (0 == u32Failures) ? 0 : 1;
+}
@@ -0,0 +1,724 @@
+/*
+ * l3gd20_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ *
+ *  Host test & benchmark of the L3GD20 FIFO burst engine (stm32f429i_discovery_l3gd20.c)
+ *  over a register model of SPI5, DMA2 Stream3/4, GPIOA/C, EXTI & NVIC (cpu_sim.h),
+ *  the Standard Peripheral Library running on the model registers
+ *  - SPI5 at PCLK2 / 8: DR & shift register, TXE, RXNE & BSY; DMA2 Stream3 takes every
+ *    received byte, Stream4 feeds DR on TXE, TCIF & interrupt at NDTR 0
+ *  - L3GD20: a sample every 1 / 760 s (CTRL_REG1) into its 32 sample FIFO in stream
+ *    mode, command byte then data bytes while CS (PC1) is low, OUT_Z_H wraps to OUT_X_L
+ *    & pops a sample with the FIFO on; INT2 (PA2) high while the level is at or above
+ *    the watermark (I2_WTM), its rising edge pends EXTI2
+ *  - Watermarks 1, 16 & 31: every sample reaches the ring in order, bursts of the watermark
+ *  - Burst ISR held off past 2 watermarks: INT2 is still high when the burst ends, the
+ *    DMA interrupt restarts without a new edge
+ *  - Ring full: new samples are dropped & counted in Dropped, the ring keeps the oldest
+ *  - L3GD20_Read / L3GD20_Write between bursts: L3GD20_FifoLock waits for the running
+ *    burst, no CPU byte ever goes out while the DMA owns the bus
+ *  - Figures per watermark: bursts/s, SPI bytes/s & ISR cycles per sample
+ *
+ *  Build & run from tools/host:
+ *  gcc -O2 -fno-tree-vectorize -fno-tree-loop-distribute-patterns -no-pie -Wall -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast \
+ *      -DSTM32F42_43xxx -DUSE_STDPERIPH_DRIVER -I../../Utilities/STM32F429I-Discovery \
+ *      -I../../Libraries/CMSIS/Include -I../../Libraries/Device/ST/STM32F4xx/Include \
+ *      -I../../Libraries/STM32F4xx_StdPeriph_Driver/inc -I../../src l3gd20_test.c \
+ *      -o l3gd20_test && ./l3gd20_test
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stm32f429i_discovery_l3gd20.h"
+#include "cpu_sim.h"
+
+/* CMSIS cpsid / cpsie are compiler barriers too: L3GD20_FifoGetStats copies ISR state */
+#define __disable_irq()			do { __asm__ volatile("" ::: "memory"); Sim_DisableIrq(); __asm__ volatile("" ::: "memory"); } while(0)
+#define __enable_irq()			do { __asm__ volatile("" ::: "memory"); Sim_EnableIrq(); __asm__ volatile("" ::: "memory"); } while(0)
+#define __DMB()					__asm__ volatile("" ::: "memory")
+
+#include "../../Libraries/STM32F4xx_StdPeriph_Driver/src/misc.c"
+#include "../../Libraries/STM32F4xx_StdPeriph_Driver/src/stm32f4xx_rcc.c"
+#include "../../Libraries/STM32F4xx_StdPeriph_Driver/src/stm32f4xx_gpio.c"
+#include "../../Libraries/STM32F4xx_StdPeriph_Driver/src/stm32f4xx_spi.c"
+#include "../../Libraries/STM32F4xx_StdPeriph_Driver/src/stm32f4xx_dma.c"
+#include "../../Libraries/STM32F4xx_StdPeriph_Driver/src/stm32f4xx_exti.c"
+#include "../../Libraries/STM32F4xx_StdPeriph_Driver/src/stm32f4xx_syscfg.c"
+#include "../../Utilities/STM32F429I-Discovery/stm32f429i_discovery_l3gd20.c"
+
+#define SIM_HCLK				(180000000UL)
+#define SIM_PCLK2				(90000000UL)
+
+#define SIM_SPI_CR1				((uint32_t)(uintptr_t)&SPI5->CR1)
+#define SIM_SPI_CR2				((uint32_t)(uintptr_t)&SPI5->CR2)
+#define SIM_SPI_SR				((uint32_t)(uintptr_t)&SPI5->SR)
+#define SIM_SPI_DR				((uint32_t)(uintptr_t)&SPI5->DR)
+#define SIM_GPIOA_IDR			((uint32_t)(uintptr_t)&GPIOA->IDR)
+#define SIM_GPIOC_ODR			((uint32_t)(uintptr_t)&GPIOC->ODR)
+#define SIM_GPIOC_BSRR			((uint32_t)(uintptr_t)&GPIOC->BSRRL)
+#define SIM_EXTI_IMR			((uint32_t)(uintptr_t)&EXTI->IMR)
+#define SIM_EXTI_RTSR			((uint32_t)(uintptr_t)&EXTI->RTSR)
+#define SIM_EXTI_PR				((uint32_t)(uintptr_t)&EXTI->PR)
+#define SIM_LISR				((uint32_t)(uintptr_t)&DMA2->LISR)
+#define SIM_HISR				((uint32_t)(uintptr_t)&DMA2->HISR)
+#define SIM_LIFCR				((uint32_t)(uintptr_t)&DMA2->LIFCR)
+#define SIM_HIFCR				((uint32_t)(uintptr_t)&DMA2->HIFCR)
+#define SIM_S3CR				((uint32_t)(uintptr_t)&DMA2_Stream3->CR)
+#define SIM_S3NDTR				((uint32_t)(uintptr_t)&DMA2_Stream3->NDTR)
+#define SIM_S3M0AR				((uint32_t)(uintptr_t)&DMA2_Stream3->M0AR)
+#define SIM_S4CR				((uint32_t)(uintptr_t)&DMA2_Stream4->CR)
+#define SIM_S4NDTR				((uint32_t)(uintptr_t)&DMA2_Stream4->NDTR)
+#define SIM_S4M0AR				((uint32_t)(uintptr_t)&DMA2_Stream4->M0AR)
+#define SIM_ISER				((uint32_t)(uintptr_t)&NVIC->ISER[0])
+#define SIM_ICER				((uint32_t)(uintptr_t)&NVIC->ICER[0])
+#define SIM_IP					((uint32_t)(uintptr_t)&NVIC->IP[0])
+#define SIM_AIRCR				((uint32_t)(uintptr_t)&SCB->AIRCR)
+
+#define SIM_INT2				((uint32_t)L3GD20_SPI_INT2_PIN)
+#define SIM_CS					((uint32_t)L3GD20_SPI_CS_PIN)
+#define SIM_GYRO_FIFO			(32U)
+#define SIM_GYRO_ID				(0xD4U)
+
+#define TEST_SAMPLES			(248U)
+#define TEST_READ				(64U)
+#define TEST_HOLD_WATERMARK		(10U)
+#define TEST_HOLD_SAMPLES		(25U)
+#define TEST_RING_WATERMARK		(16U)
+#define TEST_RING_BURSTS		(12U)
+#define TEST_LOCK_BURSTS		(12U)
+
+/* SPI5: DR to send, shift register, received byte */
+static uint32_t Sim_TxFull;
+static uint8_t Sim_TxByte;
+static uint32_t Sim_ShiftBusy;
+static uint8_t Sim_ShiftByte;
+static uint64_t Sim_ShiftEnd;
+static uint32_t Sim_RxFull;
+static uint8_t Sim_RxByte;
+static uint64_t Sim_SpiBytes;
+static uint32_t Sim_SpiOverruns;
+/* CPU byte or chip select while the bus is taken, FifoLock finding a burst running */
+static uint32_t Sim_Collisions;
+static uint32_t Sim_LockWaits;
+
+/* DMA2 Stream3 (RX) & Stream4 (TX): NDTR when enabled */
+static uint32_t Sim_DmaLength[2];
+
+/* L3GD20 */
+static uint8_t Sim_GyroReg[0x40];
+static L3GD20_SampleTypeDef Sim_GyroFifo[SIM_GYRO_FIFO];
+static L3GD20_SampleTypeDef Sim_GyroLast;
+static uint32_t Sim_GyroIn;
+static uint32_t Sim_GyroOut;
+static uint32_t Sim_GyroSeq;
+static uint32_t Sim_GyroOverruns;
+static uint32_t Sim_GyroSelected;
+static uint32_t Sim_GyroIndex;
+static uint8_t Sim_GyroCmd;
+static uint8_t Sim_GyroAddr;
+static uint32_t Sim_Int2;
+static uint64_t Sim_SampleBase;
+static uint64_t Sim_SampleNum;
+static uint64_t Sim_SampleAt;
+
+static uint32_t u32Failures;
+static uint32_t Test_Timeouts;
+
+#define CHECK(cond, ...)	do{ if(!(cond)){ u32Failures++; printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } }while(0)
+
+uint32_t L3GD20_TIMEOUT_UserCallback(void)
+{
+  Test_Timeouts++;
+  return 0;
+}
+
+/* 8 bits at the CR1 Baud Rate prescaler of PCLK2, in HCLK cycles */
+static uint64_t Sim_ByteCycles(void)
+{
+  uint32_t br = (Sim_Reg(SIM_SPI_CR1) & SPI_CR1_BR) >> 3;
+
+  return 8U * (2ULL << br) * (SIM_HCLK / SIM_PCLK2);
+}
+
+/* Output data rate of CTRL_REG1 DR[1:0] */
+static uint32_t Sim_GyroOdr(void)
+{
+  static const uint32_t Odr[4] = {95U, 190U, 380U, 760U};
+
+  return Odr[Sim_GyroReg[L3GD20_CTRL_REG1_ADDR] >> 6];
+}
+
+static uint32_t Sim_GyroFifoOn(void)
+{
+  return (((Sim_GyroReg[L3GD20_CTRL_REG5_ADDR] & L3GD20_FIFO_ENABLE) != 0)
+          && ((Sim_GyroReg[L3GD20_FIFO_CTRL_REG_ADDR] & 0xE0U) != L3GD20_FIFO_MODE_BYPASS)) ? 1U : 0U;
+}
+
+/* INT2 follows the watermark status, a rising edge pends EXTI2 */
+static void Sim_GyroInt2(void)
+{
+  uint32_t wtm = Sim_GyroReg[L3GD20_FIFO_CTRL_REG_ADDR] & L3GD20_FIFO_WTM_MASK, level = 0;
+
+  level = ((Sim_GyroFifoOn() != 0) && ((Sim_GyroReg[L3GD20_CTRL_REG3_ADDR] & L3GD20_INT2_WATERMARK) != 0)
+           && (wtm != 0) && ((Sim_GyroIn - Sim_GyroOut) >= wtm)) ? 1U : 0U;
+
+  if(level == Sim_Int2)
+  {
+    return;
+  }
+  Sim_Int2 = level;
+  Sim_SetReg(SIM_GPIOA_IDR, (level != 0) ? (Sim_Reg(SIM_GPIOA_IDR) | SIM_INT2) : (Sim_Reg(SIM_GPIOA_IDR) & ~SIM_INT2));
+
+  if((level != 0) && ((Sim_Reg(SIM_EXTI_IMR) & Sim_Reg(SIM_EXTI_RTSR) & SIM_INT2) != 0))
+  {
+    Sim_SetReg(SIM_EXTI_PR, Sim_Reg(SIM_EXTI_PR) | SIM_INT2);
+    Sim_IrqSet(L3GD20_SPI_INT2_EXTI_IRQn);
+  }
+}
+
+static void Sim_GyroSample(void)
+{
+  L3GD20_SampleTypeDef sample;
+
+  sample.X = (int16_t)Sim_GyroSeq;
+  sample.Y = (int16_t)(Sim_GyroSeq * 7U);
+  sample.Z = (int16_t)~Sim_GyroSeq;
+  Sim_GyroSeq++;
+
+  if(Sim_GyroFifoOn() == 0)
+  {
+    Sim_GyroLast = sample;
+    return;
+  }
+
+  /* Stream mode: the oldest sample is overwritten */
+  if((Sim_GyroIn - Sim_GyroOut) >= SIM_GYRO_FIFO)
+  {
+    Sim_GyroOut++;
+    Sim_GyroOverruns++;
+  }
+  Sim_GyroFifo[Sim_GyroIn % SIM_GYRO_FIFO] = sample;
+  Sim_GyroIn++;
+  Sim_GyroInt2();
+}
+
+static uint8_t Sim_GyroRead(uint8_t Address)
+{
+  const L3GD20_SampleTypeDef *sample = &Sim_GyroLast;
+  uint32_t level = Sim_GyroIn - Sim_GyroOut, wtm = Sim_GyroReg[L3GD20_FIFO_CTRL_REG_ADDR] & L3GD20_FIFO_WTM_MASK;
+  uint16_t field = 0;
+  uint8_t value = 0;
+
+  if((Address >= L3GD20_OUT_X_L_ADDR) && (Address <= L3GD20_OUT_Z_H_ADDR))
+  {
+    if((Sim_GyroFifoOn() != 0) && (level != 0))
+    {
+      sample = &Sim_GyroFifo[Sim_GyroOut % SIM_GYRO_FIFO];
+    }
+    field = (uint16_t)((Address < L3GD20_OUT_Y_L_ADDR) ? sample->X : (Address < L3GD20_OUT_Z_L_ADDR) ? sample->Y : sample->Z);
+    value = (uint8_t)(((Address & 1U) != 0) ? (field >> 8) : field);
+
+    /* Last byte of the sample: the FIFO moves to the next one */
+    if((Address == L3GD20_OUT_Z_H_ADDR) && (Sim_GyroFifoOn() != 0) && (level != 0))
+    {
+      Sim_GyroLast = *sample;
+      Sim_GyroOut++;
+      Sim_GyroInt2();
+    }
+    return value;
+  }
+
+  if(Address == L3GD20_FIFO_SRC_REG_ADDR)
+  {
+    return (uint8_t)((((wtm != 0) && (level >= wtm)) ? 0x80U : 0U) | ((level == 0) ? 0x20U : 0U) | (level & 0x1FU));
+  }
+
+  return Sim_GyroReg[Address];
+}
+
+/* One byte on the bus: command first, then data at the auto incremented address */
+static uint8_t Sim_GyroExchange(uint8_t Byte)
+{
+  uint8_t value = 0xFF;
+
+  if(Sim_GyroSelected == 0)
+  {
+    return value;
+  }
+
+  if(Sim_GyroIndex++ == 0)
+  {
+    Sim_GyroCmd = Byte;
+    Sim_GyroAddr = Byte & 0x3FU;
+    return value;
+  }
+
+  if((Sim_GyroCmd & READWRITE_CMD) != 0)
+  {
+    value = Sim_GyroRead(Sim_GyroAddr);
+  }
+  else if((Sim_GyroAddr != L3GD20_WHO_AM_I_ADDR) && (Sim_GyroAddr != L3GD20_FIFO_SRC_REG_ADDR))
+  {
+    Sim_GyroReg[Sim_GyroAddr] = Byte;
+    /* Bypass mode empties the FIFO */
+    if(Sim_GyroFifoOn() == 0)
+    {
+      Sim_GyroOut = Sim_GyroIn;
+    }
+    Sim_GyroInt2();
+  }
+
+  if((Sim_GyroCmd & MULTIPLEBYTE_CMD) != 0)
+  {
+    Sim_GyroAddr = ((Sim_GyroAddr == L3GD20_OUT_Z_H_ADDR) && (Sim_GyroFifoOn() != 0)) ? L3GD20_OUT_X_L_ADDR : ((Sim_GyroAddr + 1U) & 0x3FU);
+  }
+
+  return value;
+}
+
+/* Move the sensor, the shift register & the streams up to Sim_Cycles, in time order */
+static void Sim_Service(void)
+{
+  uint64_t now = Sim_Cycles, t = now;
+  uint32_t cr = 0, n = 0, sr = 0;
+  int moved = 1;
+
+  while(moved != 0)
+  {
+    moved = 0;
+
+    if((Sim_SampleAt <= now) && ((Sim_ShiftBusy == 0) || (Sim_SampleAt <= Sim_ShiftEnd)))
+    {
+      if((Sim_GyroReg[L3GD20_CTRL_REG1_ADDR] & L3GD20_MODE_ACTIVE) != 0)
+      {
+        Sim_GyroSample();
+      }
+      Sim_SampleNum++;
+      Sim_SampleAt = Sim_SampleBase + ((Sim_SampleNum * SIM_HCLK) / Sim_GyroOdr());
+      moved = 1;
+      continue;
+    }
+
+    if((Sim_ShiftBusy != 0) && (Sim_ShiftEnd <= now))
+    {
+      t = Sim_ShiftEnd;
+      Sim_ShiftBusy = 0;
+      Sim_SpiBytes++;
+      Sim_SpiOverruns += Sim_RxFull;
+      Sim_RxByte = Sim_GyroExchange(Sim_ShiftByte);
+      Sim_RxFull = 1;
+      moved = 1;
+    }
+
+    cr = Sim_Reg(SIM_S3CR);
+    if((Sim_RxFull != 0) && ((Sim_Reg(SIM_SPI_CR2) & SPI_CR2_RXDMAEN) != 0) && ((cr & DMA_SxCR_EN) != 0))
+    {
+      n = Sim_Reg(SIM_S3NDTR);
+      *(uint8_t *)(uintptr_t)(Sim_Reg(SIM_S3M0AR) + Sim_DmaLength[0] - n) = Sim_RxByte;
+      Sim_RxFull = 0;
+      Sim_SetReg(SIM_S3NDTR, --n);
+      if(n == 0)
+      {
+        Sim_SetReg(SIM_S3CR, cr & ~DMA_SxCR_EN);
+        Sim_SetReg(SIM_LISR, Sim_Reg(SIM_LISR) | DMA_LISR_TCIF3);
+        if((cr & DMA_SxCR_TCIE) != 0)
+        {
+          Sim_IrqSet(L3GD20_DMA_RX_IRQn);
+        }
+      }
+      moved = 1;
+    }
+
+    cr = Sim_Reg(SIM_S4CR);
+    if((Sim_TxFull == 0) && ((Sim_Reg(SIM_SPI_CR2) & SPI_CR2_TXDMAEN) != 0) && ((cr & DMA_SxCR_EN) != 0))
+    {
+      n = Sim_Reg(SIM_S4NDTR);
+      Sim_TxByte = *(const uint8_t *)(uintptr_t)(Sim_Reg(SIM_S4M0AR) + Sim_DmaLength[1] - n);
+      Sim_TxFull = 1;
+      Sim_SetReg(SIM_S4NDTR, --n);
+      if(n == 0)
+      {
+        Sim_SetReg(SIM_S4CR, cr & ~DMA_SxCR_EN);
+        Sim_SetReg(SIM_HISR, Sim_Reg(SIM_HISR) | DMA_HISR_TCIF4);
+      }
+      moved = 1;
+    }
+
+    if((Sim_TxFull != 0) && (Sim_ShiftBusy == 0) && ((Sim_Reg(SIM_SPI_CR1) & SPI_CR1_SPE) != 0))
+    {
+      Sim_ShiftByte = Sim_TxByte;
+      Sim_TxFull = 0;
+      Sim_ShiftBusy = 1;
+      Sim_ShiftEnd = t + Sim_ByteCycles();
+      moved = 1;
+    }
+  }
+
+  sr = (Sim_TxFull == 0) ? SPI_SR_TXE : 0U;
+  sr |= (Sim_RxFull != 0) ? SPI_SR_RXNE : 0U;
+  sr |= ((Sim_TxFull | Sim_ShiftBusy) != 0) ? SPI_SR_BSY : 0U;
+  Sim_SetReg(SIM_SPI_SR, sr);
+
+  Sim_NextEvent = ((Sim_ShiftBusy != 0) && (Sim_ShiftEnd < Sim_SampleAt)) ? Sim_ShiftEnd : Sim_SampleAt;
+}
+
+static void Sim_RegRead(uint32_t Address)
+{
+  Sim_Service();
+
+  /* Reading DR takes the received byte */
+  if((Address == SIM_SPI_DR) && (Sim_AccessWrite == 0))
+  {
+    Sim_SetReg(SIM_SPI_DR, Sim_RxByte);
+    Sim_RxFull = 0;
+    Sim_SetReg(SIM_SPI_SR, Sim_Reg(SIM_SPI_SR) & ~(uint32_t)SPI_SR_RXNE);
+  }
+}
+
+static void Sim_RegWrite(uint32_t Address, uint32_t Old)
+{
+  uint32_t value = Sim_Reg(Address), odr = 0, i = 0;
+
+  if(Address == SIM_SPI_DR)
+  {
+    if((Sim_Reg(SIM_SPI_CR2) & (SPI_CR2_RXDMAEN | SPI_CR2_TXDMAEN)) != 0)
+    {
+      Sim_Collisions++;
+    }
+    Sim_TxByte = (uint8_t)value;
+    Sim_TxFull = 1;
+  }
+  else if(Address == SIM_GPIOC_BSRR)
+  {
+    odr = Sim_Reg(SIM_GPIOC_ODR);
+    if(((value >> 16) & SIM_CS) != 0)
+    {
+      /* Chip select taken while already low: two transfers on the bus */
+      Sim_Collisions += Sim_GyroSelected;
+      Sim_GyroSelected = 1;
+      Sim_GyroIndex = 0;
+    }
+    if((value & SIM_CS) != 0)
+    {
+      Sim_GyroSelected = 0;
+    }
+    odr = (odr | (value & 0xFFFFU)) & ~(value >> 16);
+    Sim_SetReg(SIM_GPIOC_ODR, odr);
+    Sim_SetReg(SIM_GPIOC_BSRR, 0);
+  }
+  else if(Address == SIM_EXTI_PR)
+  {
+    Sim_SetReg(SIM_EXTI_PR, Old & ~value);
+  }
+  else if((Address == SIM_LIFCR) || (Address == SIM_HIFCR))
+  {
+    Sim_SetReg(Address - 8U, Sim_Reg(Address - 8U) & ~value);
+    Sim_SetReg(Address, 0);
+  }
+  else if((Address == SIM_S3CR) || (Address == SIM_S4CR))
+  {
+    if(((Old & DMA_SxCR_EN) == 0) && ((value & DMA_SxCR_EN) != 0))
+    {
+      Sim_DmaLength[(Address == SIM_S3CR) ? 0 : 1] = Sim_Reg(Address + 4U);
+    }
+  }
+  else if((Address >= SIM_ISER) && (Address < (SIM_ISER + 32U)))
+  {
+    for(i = 0; i < 32U; i++)
+    {
+      if((value & (1UL << i)) != 0)
+      {
+        Sim_IrqEnabled[((Address - SIM_ISER) * 8U) + i] = 1;
+      }
+    }
+    Sim_SetReg(Address, Old | value);
+    Sim_SetReg(Address + 0x80U, Old | value);
+  }
+  else if((Address >= SIM_ICER) && (Address < (SIM_ICER + 32U)))
+  {
+    for(i = 0; i < 32U; i++)
+    {
+      if((value & (1UL << i)) != 0)
+      {
+        Sim_IrqEnabled[((Address - SIM_ICER) * 8U) + i] = 0;
+      }
+    }
+    /* L3GD20_FifoLock masks INT2 first: is a burst running? */
+    if((Address == (SIM_ICER + ((L3GD20_SPI_INT2_EXTI_IRQn / 32U) * 4U)))
+       && ((value & (1UL << (L3GD20_SPI_INT2_EXTI_IRQn % 32U))) != 0) && ((Sim_Reg(SIM_S3CR) & DMA_SxCR_EN) != 0))
+    {
+      Sim_LockWaits++;
+    }
+    Sim_SetReg(Address, Old & ~value);
+    Sim_SetReg(Address - 0x80U, Old & ~value);
+  }
+  else if((Address >= SIM_IP) && (Address < (SIM_IP + 240U)))
+  {
+    /* 4 bits of priority per IRQ, as the NVIC implements them */
+    for(i = 0; i < 4U; i++)
+    {
+      Sim_IrqPriority[(Address - SIM_IP) + i] = (uint8_t)((value >> (8U * i)) >> 4);
+    }
+  }
+
+  Sim_Service();
+}
+
+static void Sim_Tick(void)
+{
+  Sim_Service();
+}
+
+static void Sim_Reset(void)
+{
+  memset(Sim_GyroReg, 0, sizeof(Sim_GyroReg));
+  Sim_GyroReg[L3GD20_WHO_AM_I_ADDR] = SIM_GYRO_ID;
+  Sim_GyroReg[L3GD20_CTRL_REG1_ADDR] = 0x07;
+  Sim_SampleBase = Sim_Cycles;
+  Sim_SampleNum = 0;
+  Sim_SampleAt = Sim_Cycles + (SIM_HCLK / Sim_GyroOdr());
+  Sim_NextEvent = Sim_SampleAt;
+
+  /* The application's NVIC_PriorityGroupConfig(NVIC_PriorityGroup_4) */
+  Sim_SetReg(SIM_AIRCR, 0xFA050300U);
+}
+
+/* Wait for at least Count samples from the ring, then take the ones pending; in order: X counts up by one */
+static uint32_t Test_Collect(uint32_t Count, int32_t *Last)
+{
+  L3GD20_SampleTypeDef samples[TEST_READ];
+  uint32_t got = 0, n = 0, i = 0, gaps = 0;
+
+  do
+  {
+    n = L3GD20_FifoRead(samples, TEST_READ);
+    for(i = 0; i < n; i++)
+    {
+      if(((*Last >= 0) && ((uint16_t)samples[i].X != (uint16_t)(*Last + 1)))
+         || (samples[i].Y != (int16_t)((uint32_t)(uint16_t)samples[i].X * 7U)) || (samples[i].Z != (int16_t)~samples[i].X))
+      {
+        gaps++;
+      }
+      *Last = (uint16_t)samples[i].X;
+    }
+    got += n;
+    if((n == 0) && (got < Count))
+    {
+      Sim_Wfi();
+    }
+  }
+  while((got < Count) || (n != 0));
+
+  return gaps;
+}
+
+static void Test_Init(void)
+{
+  L3GD20_InitTypeDef init;
+
+  init.Power_Mode = L3GD20_MODE_ACTIVE;
+  init.Output_DataRate = L3GD20_OUTPUT_DATARATE_4;
+  init.Axes_Enable = L3GD20_AXES_ENABLE;
+  init.Band_Width = L3GD20_BANDWIDTH_4;
+  init.BlockData_Update = L3GD20_BlockDataUpdate_Continous;
+  init.Endianness = L3GD20_BLE_LSB;
+  init.Full_Scale = L3GD20_FULLSCALE_500;
+
+  Sim_StepOn();
+  L3GD20_Init(&init);
+  Sim_StepOff();
+
+  CHECK((Sim_GyroReg[L3GD20_CTRL_REG1_ADDR] == 0xFF) && (Sim_GyroReg[L3GD20_CTRL_REG4_ADDR] == 0x10),
+        "CTRL_REG1 0x%02X, CTRL_REG4 0x%02X", Sim_GyroReg[L3GD20_CTRL_REG1_ADDR], Sim_GyroReg[L3GD20_CTRL_REG4_ADDR]);
+  CHECK(760U == Sim_GyroOdr(), "%lu Hz", (unsigned long)Sim_GyroOdr());
+}
+
+/* Samples at one watermark: all in order, bursts of the watermark; bursts/s, bytes/s, ISR cycles */
+static void Test_Watermark(uint8_t Watermark)
+{
+  L3GD20_FifoStatsTypeDef stats;
+  uint64_t cycles = 0, irq = 0, bytes = 0, overruns = Sim_GyroOverruns;
+  uint32_t gaps = 0, collisions = Sim_Collisions;
+  int32_t last = -1;
+  double seconds = 0;
+
+  Sim_StepOn();
+  L3GD20_FifoInit(Watermark);
+  cycles = Sim_Cycles;
+  irq = Sim_IrqCycles;
+  bytes = Sim_SpiBytes;
+  gaps = Test_Collect(TEST_SAMPLES, &last);
+  cycles = Sim_Cycles - cycles;
+  irq = Sim_IrqCycles - irq;
+  bytes = Sim_SpiBytes - bytes;
+  L3GD20_FifoGetStats(&stats);
+  L3GD20_FifoDeInit();
+  Sim_StepOff();
+
+  CHECK(0 == gaps, "watermark %u: %lu samples out of order", Watermark, (unsigned long)gaps);
+  CHECK(stats.Samples == (stats.Bursts * Watermark), "watermark %u: %lu samples in %lu bursts",
+        Watermark, (unsigned long)stats.Samples, (unsigned long)stats.Bursts);
+  CHECK(stats.Samples >= TEST_SAMPLES, "watermark %u: %lu samples", Watermark, (unsigned long)stats.Samples);
+  CHECK((0 == stats.Dropped) && (0 == stats.Errors), "watermark %u: %lu dropped, %lu errors",
+        Watermark, (unsigned long)stats.Dropped, (unsigned long)stats.Errors);
+  CHECK(overruns == Sim_GyroOverruns, "watermark %u: L3GD20 FIFO overrun", Watermark);
+  CHECK(collisions == Sim_Collisions, "watermark %u: bus collision", Watermark);
+  CHECK(0 == Sim_SpiOverruns, "watermark %u: SPI overrun", Watermark);
+
+  seconds = (double)cycles / SIM_HCLK;
+  printf("watermark %2u at %lu Hz: %6.1f bursts/s, %6.0f SPI bytes/s, ISR %4.0f cycles (%.2f us) per sample\n",
+         Watermark, (unsigned long)Sim_GyroOdr(), stats.Bursts / seconds, bytes / seconds,
+         (double)irq / stats.Samples, ((double)irq * 1e6) / ((double)SIM_HCLK * stats.Samples));
+}
+
+/* Burst ISRs held off past 2 watermarks: INT2 stays high, the DMA interrupt starts the next burst */
+static void Test_Restart(void)
+{
+  L3GD20_FifoStatsTypeDef stats;
+  uint32_t edges = 0, bursts = 0, gaps = 0;
+  uint64_t period = SIM_HCLK / Sim_GyroOdr();
+  int32_t last = -1;
+
+  Sim_StepOn();
+  L3GD20_FifoInit(TEST_HOLD_WATERMARK);
+  gaps = Test_Collect(TEST_HOLD_WATERMARK, &last);
+
+  /* A critical section of TEST_HOLD_SAMPLES sample periods */
+  L3GD20_FifoGetStats(&stats);
+  bursts = stats.Bursts;
+  edges = Sim_IrqTaken[L3GD20_SPI_INT2_EXTI_IRQn];
+  __disable_irq();
+  Sim_Cycles += period * TEST_HOLD_SAMPLES;
+  __enable_irq();
+  gaps += Test_Collect(2U * TEST_HOLD_WATERMARK, &last);
+  L3GD20_FifoGetStats(&stats);
+  edges = Sim_IrqTaken[L3GD20_SPI_INT2_EXTI_IRQn] - edges;
+  bursts = stats.Bursts - bursts;
+  L3GD20_FifoDeInit();
+  Sim_StepOff();
+
+  CHECK(0 == gaps, "held off: %lu samples out of order", (unsigned long)gaps);
+  CHECK((1U == edges) && (2U == bursts), "held off: %lu INT2 interrupts, %lu bursts (1 & 2 expected)",
+        (unsigned long)edges, (unsigned long)bursts);
+  CHECK(0 == stats.Dropped, "held off: %lu dropped", (unsigned long)stats.Dropped);
+  printf("held off %u sample periods: %lu INT2 interrupt, %lu bursts back to back\n",
+         TEST_HOLD_SAMPLES, (unsigned long)edges, (unsigned long)bursts);
+}
+
+/* Ring not read: the oldest L3GD20_RING_SIZE samples stay, the others are counted dropped */
+static void Test_RingFull(void)
+{
+  L3GD20_FifoStatsTypeDef stats;
+  L3GD20_SampleTypeDef sample;
+  uint32_t gaps = 0, dropped = 0;
+  int32_t last = -1, first = 0;
+
+  Sim_StepOn();
+  L3GD20_FifoInit(TEST_RING_WATERMARK);
+  do
+  {
+    Sim_Wfi();
+    L3GD20_FifoGetStats(&stats);
+  }
+  while(stats.Bursts < TEST_RING_BURSTS);
+  dropped = stats.Dropped;
+
+  CHECK(L3GD20_RING_SIZE == L3GD20_FifoPending(), "%u samples pending", L3GD20_FifoPending());
+  gaps = Test_Collect(L3GD20_RING_SIZE, &last);
+
+  /* The next sample read is the first one after the dropped ones */
+  first = last;
+  while(L3GD20_FifoRead(&sample, 1) == 0)
+  {
+    Sim_Wfi();
+  }
+  last = (uint16_t)sample.X;
+  L3GD20_FifoGetStats(&stats);
+  L3GD20_FifoDeInit();
+  Sim_StepOff();
+
+  CHECK(0 == gaps, "ring full: %lu samples out of order", (unsigned long)gaps);
+  CHECK(((TEST_RING_BURSTS * TEST_RING_WATERMARK) - L3GD20_RING_SIZE) == dropped, "ring full: %lu dropped, %u expected",
+        (unsigned long)dropped, (TEST_RING_BURSTS * TEST_RING_WATERMARK) - L3GD20_RING_SIZE);
+  CHECK((uint16_t)last == (uint16_t)(first + 1 + (int32_t)stats.Dropped), "ring full: sample %ld after %ld with %lu dropped",
+        (long)last, (long)first, (unsigned long)stats.Dropped);
+  CHECK((stats.Samples + stats.Dropped) == (stats.Bursts * TEST_RING_WATERMARK), "ring full: %lu published, %lu dropped in %lu bursts",
+        (unsigned long)stats.Samples, (unsigned long)stats.Dropped, (unsigned long)stats.Bursts);
+  printf("ring not read for %u bursts: %u kept, %lu dropped\n", TEST_RING_BURSTS, L3GD20_RING_SIZE, (unsigned long)dropped);
+}
+
+/* Register reads & writes while bursts run: the lock waits for the burst, nothing collides */
+static void Test_Interleave(void)
+{
+  L3GD20_FifoStatsTypeDef stats;
+  uint32_t i = 0, gaps = 0, bad = 0, waits = Sim_LockWaits, collisions = Sim_Collisions;
+  uint8_t value = 0;
+  int32_t last = -1;
+
+  Sim_StepOn();
+  L3GD20_FifoInit(TEST_RING_WATERMARK);
+  for(i = 0; i < (2U * TEST_LOCK_BURSTS); i++)
+  {
+    /* Woken by INT2 (a burst starts) or by the burst end */
+    Sim_Wfi();
+    L3GD20_Read(&value, L3GD20_CTRL_REG1_ADDR, 1);
+    bad += (value != 0xFF) ? 1U : 0U;
+    value = (uint8_t)(i & 0x2FU);
+    L3GD20_Write(&value, L3GD20_CTRL_REG2_ADDR, 1);
+    value = 0;
+    L3GD20_Read(&value, L3GD20_CTRL_REG2_ADDR, 1);
+    bad += (value != (uint8_t)(i & 0x2FU)) ? 1U : 0U;
+    gaps += Test_Collect(0, &last);
+  }
+  gaps += Test_Collect(L3GD20_FifoPending(), &last);
+  L3GD20_FifoGetStats(&stats);
+  L3GD20_FifoDeInit();
+  Sim_StepOff();
+
+  CHECK(0 == bad, "interleaved: %lu register values wrong", (unsigned long)bad);
+  CHECK(0 == gaps, "interleaved: %lu samples out of order", (unsigned long)gaps);
+  CHECK(Sim_LockWaits > waits, "interleaved: L3GD20_FifoLock never met a running burst");
+  CHECK(collisions == Sim_Collisions, "interleaved: %lu bus collisions", (unsigned long)(Sim_Collisions - collisions));
+  CHECK((0 == stats.Dropped) && (0 == stats.Errors) && (0 == Test_Timeouts), "interleaved: %lu dropped, %lu errors, %lu timeouts",
+        (unsigned long)stats.Dropped, (unsigned long)stats.Errors, (unsigned long)Test_Timeouts);
+  printf("%u register transfers between bursts: %lu waited for a running burst\n",
+         6U * TEST_LOCK_BURSTS, (unsigned long)(Sim_LockWaits - waits));
+}
+
+int main(void)
+{
+  if((Sim_MapBlock((uint32_t)(uintptr_t)SPI5, sizeof(SPI_TypeDef)) != 0)
+     || (Sim_MapBlock((uint32_t)(uintptr_t)SYSCFG, 0x800U) != 0)
+     || (Sim_MapBlock((uint32_t)(uintptr_t)GPIOA, 0x1800U) != 0)
+     || (Sim_MapBlock((uint32_t)(uintptr_t)RCC, sizeof(RCC_TypeDef)) != 0)
+     || (Sim_MapBlock((uint32_t)(uintptr_t)DMA2, 0x100U) != 0)
+     || (Sim_MapBlock(SCS_BASE, 0x1000U) != 0))
+  {
+    printf("SPI5 / SYSCFG / GPIO / RCC / DMA2 / SCS addresses not free, build with -no-pie\n");
+    return 1;
+  }
+
+  Sim_CpuStart();
+  Sim_IrqConnect(L3GD20_SPI_INT2_EXTI_IRQn, L3GD20_SPI_INT2_IRQHandler, 15);
+  Sim_IrqConnect(L3GD20_DMA_RX_IRQn, L3GD20_DMA_RX_IRQHandler, 15);
+  Sim_Reset();
+
+  Test_Init();
+  Test_Watermark(1);
+  Test_Watermark(16);
+  Test_Watermark(31);
+  Test_Restart();
+  Test_RingFull();
+  Test_Interleave();
+
+  CHECK(0 == Test_Timeouts, "%lu SPI timeouts", (unsigned long)Test_Timeouts);
+
+  printf("%s (%lu failures)\n", (0 == u32Failures) ? "PASS" : "FAIL", (unsigned long)u32Failures);
+
+  return (0 == u32Failures) ? 0 : 1;
+}
@@ -0,0 +1,133 @@
+/*
+ * lcd_sim.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ *
+ *  Host model of the LCD driver peripherals for the LCD harnesses
+ *  - DMA2D & SDRAM from dma2d_sim.h
+ *  - LTDC layer address: LTDC_LayerAddress writes the shadow register,
+ *    LTDC_ReloadConfig copies it at once (IMReload) or at the next
+ *    vertical blanking (VBReload)
+ *  - Sim_LtdcBlanking plays the end of a frame: the line interrupt, when
+ *    enabled, then the vertical blanking reload
+ *  - GPIO, SPI, RCC & SDRAM init calls do nothing
+ *
+ *  Include instead of the LCD headers, then the driver .c files:
+ *  #include "lcd_sim.h"
+ *  #include "../../Utilities/STM32F429I-Discovery/stm32f429i_discovery_dma2d.c"
+ *  #include "../../Utilities/STM32F429I-Discovery/stm32f429i_discovery_lcd.c"
+ */
+
+#ifndef LCD_SIM_H_
+#define LCD_SIM_H_
+
+#include "stm32f429i_discovery_lcd.h"
+#include "stm32f429i_discovery_dma2d.h"
+#include "dma2d_sim.h"
+
+static LTDC_TypeDef Sim_Ltdc;
+/* Layer address: written by the driver / scanned by LTDC */
+static uint32_t Sim_LayerShadow[2];
+static uint32_t Sim_LayerActive[2];
+static uint32_t Sim_Blankings;
+
+#undef LTDC
+#define LTDC					(&Sim_Ltdc)
+
+static uint32_t Sim_LayerIndex(LTDC_Layer_TypeDef* LTDC_Layerx)
+{
+  return (LTDC_Layerx == LTDC_Layer1) ? 0 : 1;
+}
+
+void LTDC_LayerAddress(LTDC_Layer_TypeDef* LTDC_Layerx, uint32_t Address)
+{
+  Sim_LayerShadow[Sim_LayerIndex(LTDC_Layerx)] = Address;
+}
+
+void LTDC_ReloadConfig(uint32_t LTDC_Reload)
+{
+  if(LTDC_Reload == LTDC_IMReload)
+  {
+    Sim_LayerActive[0] = Sim_LayerShadow[0];
+    Sim_LayerActive[1] = Sim_LayerShadow[1];
+  }
+  else
+  {
+    Sim_Ltdc.SRCR |= LTDC_SRCR_VBR;
+  }
+}
+
+void LTDC_ITConfig(uint32_t LTDC_IT, FunctionalState NewState)
+{
+  if(NewState != DISABLE)
+  {
+    Sim_Ltdc.IER |= LTDC_IT;
+  }
+  else
+  {
+    Sim_Ltdc.IER &= ~LTDC_IT;
+  }
+}
+
+void LTDC_LIPConfig(uint32_t LTDC_LIPositionConfig)
+{
+  Sim_Ltdc.LIPCR = LTDC_LIPositionConfig;
+}
+
+void LTDC_ClearITPendingBit(uint32_t LTDC_IT)
+{
+  Sim_Ltdc.ISR &= ~LTDC_IT;
+}
+
+void LTDC_LayerInit(LTDC_Layer_TypeDef* LTDC_Layerx, LTDC_Layer_InitTypeDef* LTDC_Layer_InitStruct)
+{
+  Sim_LayerShadow[Sim_LayerIndex(LTDC_Layerx)] = LTDC_Layer_InitStruct->LTDC_CFBStartAdress;
+}
+
+/* Line interrupt (LTDC IRQ masked by PRIMASK like DMA2D), then a pending VBReload copies the shadow registers */
+static inline void Sim_LtdcBlanking(void)
+{
+  Sim_Blankings++;
+
+  if(((Sim_Ltdc.IER & LTDC_IER_LIE) != 0) && (Sim_GetPrimask() == 0))
+  {
+    Sim_Ltdc.ISR |= LTDC_ISR_LIF;
+    LCD_LTDC_IRQHandler();
+  }
+
+  if((Sim_Ltdc.SRCR & LTDC_SRCR_VBR) != 0)
+  {
+    Sim_LayerActive[0] = Sim_LayerShadow[0];
+    Sim_LayerActive[1] = Sim_LayerShadow[1];
+    Sim_Ltdc.SRCR &= ~LTDC_SRCR_VBR;
+  }
+}
+
+/* Peripheral Library calls of the init paths, nothing to model */
+void LTDC_Init(LTDC_InitTypeDef* LTDC_InitStruct) { (void)LTDC_InitStruct; }
+void LTDC_DitherCmd(FunctionalState NewState) { (void)NewState; }
+void LTDC_LayerCmd(LTDC_Layer_TypeDef* LTDC_Layerx, FunctionalState NewState) { (void)LTDC_Layerx; (void)NewState; }
+void LTDC_LayerPosition(LTDC_Layer_TypeDef* LTDC_Layerx, uint16_t OffsetX, uint16_t OffsetY) { (void)LTDC_Layerx; (void)OffsetX; (void)OffsetY; }
+void LTDC_LayerAlpha(LTDC_Layer_TypeDef* LTDC_Layerx, uint8_t ConstantAlpha) { (void)LTDC_Layerx; (void)ConstantAlpha; }
+void LTDC_LayerSize(LTDC_Layer_TypeDef* LTDC_Layerx, uint32_t Width, uint32_t Height) { (void)LTDC_Layerx; (void)Width; (void)Height; }
+void LTDC_LayerPixelFormat(LTDC_Layer_TypeDef* LTDC_Layerx, uint32_t PixelFormat) { (void)LTDC_Layerx; (void)PixelFormat; }
+void LTDC_ColorKeyingConfig(LTDC_Layer_TypeDef* LTDC_Layerx, LTDC_ColorKeying_InitTypeDef* LTDC_colorkeying_InitStruct, FunctionalState NewState) { (void)LTDC_Layerx; (void)LTDC_colorkeying_InitStruct; (void)NewState; }
+void GPIO_Init(GPIO_TypeDef* GPIOx, GPIO_InitTypeDef* GPIO_InitStruct) { (void)GPIOx; (void)GPIO_InitStruct; }
+void GPIO_PinAFConfig(GPIO_TypeDef* GPIOx, uint16_t GPIO_PinSource, uint8_t GPIO_AF) { (void)GPIOx; (void)GPIO_PinSource; (void)GPIO_AF; }
+void GPIO_SetBits(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin) { (void)GPIOx; (void)GPIO_Pin; }
+void GPIO_ResetBits(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin) { (void)GPIOx; (void)GPIO_Pin; }
+void GPIO_WriteBit(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, BitAction BitVal) { (void)GPIOx; (void)GPIO_Pin; (void)BitVal; }
+void RCC_APB2PeriphClockCmd(uint32_t RCC_APB2Periph, FunctionalState NewState) { (void)RCC_APB2Periph; (void)NewState; }
+FlagStatus RCC_GetFlagStatus(uint8_t RCC_FLAG) { (void)RCC_FLAG; return SET; }
+void RCC_LTDCCLKDivConfig(uint32_t RCC_PLLSAIDivR) { (void)RCC_PLLSAIDivR; }
+void RCC_PLLSAICmd(FunctionalState NewState) { (void)NewState; }
+void RCC_PLLSAIConfig(uint32_t PLLSAIN, uint32_t PLLSAIQ, uint32_t PLLSAIR) { (void)PLLSAIN; (void)PLLSAIQ; (void)PLLSAIR; }
+void SPI_I2S_DeInit(SPI_TypeDef* SPIx) { (void)SPIx; }
+void SPI_Init(SPI_TypeDef* SPIx, SPI_InitTypeDef* SPI_InitStruct) { (void)SPIx; (void)SPI_InitStruct; }
+void SPI_Cmd(SPI_TypeDef* SPIx, FunctionalState NewState) { (void)SPIx; (void)NewState; }
+void SPI_I2S_SendData(SPI_TypeDef* SPIx, uint16_t Data) { (void)SPIx; (void)Data; }
+FlagStatus SPI_I2S_GetFlagStatus(SPI_TypeDef* SPIx, uint16_t SPI_I2S_FLAG) { (void)SPIx; return (SPI_I2S_FLAG == SPI_I2S_FLAG_BSY) ? RESET : SET; }
+void SDRAM_Init(void) { }
+
+#endif /* LCD_SIM_H_ */
@@ -0,0 +1,433 @@
+/*
+ * log_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ *
+ *  Host test & benchmark of the printf Log Ring (Drivers/LOG/LOG_Prog.c) over a model of
+ *  xUSART_SendSegments_DMA (cpu_sim.h): one byte leaves the ring every 10 bits at
+ *  115200 bits/s (HCLK 180 MHz), read by the "DMA" when it is sent, Done callback from
+ *  the DMA interrupt after the last one
+ *  - Lines through a 64 byte ring (waiting on the Pending count) reach the wire in
+ *    order across the ring wrap
+ *  - A full ring queues what fits, drops the rest (Dropped & HighWater)
+ *  - An ISR writing while a Thread Write copies: both records complete & in order,
+ *    the DMA never sends bytes before their Write commits
+ *  - USART busy with another DMA user: the Tx Idle callback starts the ring
+ *  - Benchmark: PRIMASK time & cycles per Write (Enqueue Latency), Thread writing
+ *    48 byte lines as fast as the USART drains them (bytes/s on the wire, CPU load)
+ *
+ *  Build & run from tools/host:
+ *  gcc -O2 -fno-tree-vectorize -fno-tree-loop-distribute-patterns -no-pie -Wall -Wno-pointer-to-int-cast \
+ *      -I../../Drivers/STD_and_MATH -I../../Drivers/LOG -I../../Drivers/USART -I../../Drivers/DMA \
+ *      -I../../Drivers/SYSTICK -I../../Drivers/DWT log_test.c -o log_test && ./log_test
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "std_types_sim.h"
+#include "cpu_sim.h"
+#include "DMA_Init.h"
+#include "USART_Init.h"
+#include "USART_Reg.h"
+#include "DWT_Reg.h"
+
+/* u32DWT_GetCycles is inline, its Cycle Counter is the model time */
+#undef DWT_CYCCNT
+#define DWT_CYCCNT				((u32)Sim_Cycles)
+
+#define SIM_HCLK				(180000000UL)
+#define SIM_BAUD				(115200UL)
+#define SIM_BYTE_CYCLES			((10UL * SIM_HCLK) / SIM_BAUD)
+#define SIM_WIRE_SIZE			(65536U)
+
+#define SIM_DMA_IRQ				(70U)
+#define SIM_WRITER_IRQ			(6U)
+
+#define TEST_LINE				(48U)
+#define TEST_BENCH_SECONDS		(0.5)
+
+/* USART + DMA: one Scatter-Gather segment at a time, sent byte by byte */
+static const USART_TxSegment* Sim_TxSegment;
+static USART_TxCallback Sim_TxDone;
+static USART_TxCallback Sim_TxIdle;
+static uint32_t Sim_TxIndex;
+static uint64_t Sim_TxNext = SIM_NEVER;
+static uint32_t Sim_OtherUser;
+static uint8_t Sim_Wire[SIM_WIRE_SIZE];
+static uint32_t Sim_WireCount;
+
+/* Writer ISR pended at Sim_WriterAt */
+static uint64_t Sim_WriterAt = SIM_NEVER;
+
+/* Time with PRIMASK set by the ring, longest & total */
+static uint64_t Sim_MaskStart;
+static uint64_t Sim_MaskMax;
+static uint64_t Sim_MaskTotal;
+
+u32 u32SYSTICK_EnterCritical(void)
+{
+  u32 state = Sim_GetPrimask();
+
+  Sim_DisableIrq();
+  if(state == 0)
+  {
+    Sim_MaskStart = Sim_Cycles;
+  }
+
+  return state;
+}
+
+void vidSYSTICK_ExitCritical(u32 u32State)
+{
+  uint64_t masked = 0;
+
+  if((u32State == 0) && (Sim_GetPrimask() != 0))
+  {
+    masked = Sim_Cycles - Sim_MaskStart;
+    Sim_MaskTotal += masked;
+    if(masked > Sim_MaskMax)
+    {
+      Sim_MaskMax = masked;
+    }
+  }
+  Sim_SetPrimask(u32State);
+}
+
+Return_status xUSART_SendSegments_DMA(USART_REG* USARTx, const USART_TxSegment* Segments, u8 u8Count, USART_TxCallback pfCallback)
+{
+  (void)USARTx;
+
+  if((Sim_TxSegment != 0) || (Sim_OtherUser != 0))
+  {
+    return NOK;
+  }
+  if((Segments == 0) || (u8Count != 1))
+  {
+    return NULLPOINTER;
+  }
+
+  Sim_TxSegment = Segments;
+  Sim_TxDone = pfCallback;
+  Sim_TxIndex = 0;
+  Sim_TxNext = Sim_Cycles + SIM_BYTE_CYCLES;
+  Sim_NextEvent = (Sim_TxNext < Sim_WriterAt) ? Sim_TxNext : Sim_WriterAt;
+
+  return OK;
+}
+
+Return_status xUSART_SetTxIdleCallback(USART_REG* USARTx, USART_TxCallback pfCallback)
+{
+  (void)USARTx;
+  Sim_TxIdle = pfCallback;
+  return OK;
+}
+
+#include "../../Drivers/LOG/LOG_Prog.c"
+
+static void Sim_RegRead(uint32_t Address)
+{
+  (void)Address;
+}
+
+static void Sim_RegWrite(uint32_t Address, uint32_t Old)
+{
+  (void)Address;
+  (void)Old;
+}
+
+/* Bytes leave at the time they are sent: the DMA reads the ring then, not at the start */
+static void Sim_Tick(void)
+{
+  while((Sim_TxSegment != 0) && (Sim_TxNext <= Sim_Cycles))
+  {
+    if(Sim_WireCount < SIM_WIRE_SIZE)
+    {
+      Sim_Wire[Sim_WireCount] = Sim_TxSegment->pData[Sim_TxIndex];
+    }
+    Sim_WireCount++;
+    Sim_TxIndex++;
+    Sim_TxNext += SIM_BYTE_CYCLES;
+    if(Sim_TxIndex >= Sim_TxSegment->Size)
+    {
+      Sim_TxNext = SIM_NEVER;
+      Sim_IrqSet(SIM_DMA_IRQ);
+    }
+  }
+
+  if(Sim_WriterAt <= Sim_Cycles)
+  {
+    Sim_WriterAt = SIM_NEVER;
+    Sim_IrqSet(SIM_WRITER_IRQ);
+  }
+
+  Sim_NextEvent = (Sim_TxNext < Sim_WriterAt) ? Sim_TxNext : Sim_WriterAt;
+}
+
+static void Sim_DmaIrq(void)
+{
+  USART_TxCallback done = Sim_TxDone;
+
+  Sim_TxSegment = 0;
+  Sim_TxDone = 0;
+  if(done != 0)
+  {
+    done(USART1);
+  }
+}
+
+#define CHECK(cond, ...)	do{ if(!(cond)){ u32Failures++; printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } }while(0)
+
+static uint32_t u32Failures;
+
+static uint8_t Test_Ring[1024];
+static uint8_t Test_Expected[SIM_WIRE_SIZE];
+static uint32_t Test_ExpectedCount;
+
+static const uint8_t Test_IsrRecord[] = "[isr]\n";
+static volatile uint32_t Test_IsrWriters;
+static volatile uint32_t Test_IsrWireCount;
+static volatile uint32_t Test_IsrQueued;
+
+static void Test_WriterIrq(void)
+{
+  Test_IsrWriters = LOG_Writers;
+  Test_IsrWireCount = Sim_WireCount;
+  Test_IsrQueued = u16LOG_Write(Test_IsrRecord, sizeof(Test_IsrRecord) - 1U);
+}
+
+static void Test_Start(uint16_t Size)
+{
+  Sim_WireCount = 0;
+  Test_ExpectedCount = 0;
+  Sim_MaskMax = 0;
+  Sim_MaskTotal = 0;
+  CHECK(OK == xLOG_Init(USART1, Test_Ring, Size), "init %u byte ring", Size);
+}
+
+static void Test_Expect(const uint8_t *pData, uint32_t Size)
+{
+  memcpy(Test_Expected + Test_ExpectedCount, pData, Size);
+  Test_ExpectedCount += Size;
+}
+
+/* Sleep till the ring & the DMA are empty, then compare the wire */
+static void Test_Drain(const char *Name)
+{
+  Sim_StepOn();
+  while((u16LOG_Pending() != 0) || (Sim_TxSegment != 0))
+  {
+    Sim_Wfi();
+  }
+  Sim_StepOff();
+
+  CHECK((Sim_WireCount == Test_ExpectedCount) && (0 == memcmp(Sim_Wire, Test_Expected, Test_ExpectedCount)),
+        "%s: %lu bytes on the wire, %lu expected", Name, (unsigned long)Sim_WireCount, (unsigned long)Test_ExpectedCount);
+}
+
+static uint32_t Test_MakeLine(uint8_t *pLine, uint32_t u32Line, uint32_t Size)
+{
+  uint32_t i = 0;
+
+  snprintf((char *)pLine, Size, "line %05lu ", (unsigned long)u32Line);
+  for(i = 11; i < (Size - 1U); i++)
+  {
+    pLine[i] = (uint8_t)('a' + ((u32Line + i) % 26U));
+  }
+  pLine[Size - 1U] = '\n';
+
+  return Size;
+}
+
+static void Test_Wrap(void)
+{
+  uint8_t line[20];
+  uint32_t i = 0, size = 0;
+  LOG_Stats stats;
+
+  Test_Start(64);
+  for(i = 0; i < 30U; i++)
+  {
+    size = Test_MakeLine(line, i, 13U + (i % 7U));
+
+    Sim_StepOn();
+    while(u16LOG_Pending() > (63U - size))
+    {
+      Sim_Wfi();
+    }
+    CHECK(size == u16LOG_Write(line, (u16)size), "line %lu", (unsigned long)i);
+    Sim_StepOff();
+
+    Test_Expect(line, size);
+  }
+  Test_Drain("64 byte ring");
+
+  CHECK(OK == xLOG_GetStats(&stats), "stats");
+  CHECK((stats.Writes == 30U) && (stats.Bytes == Test_ExpectedCount) && (stats.Dropped == 0) && (stats.HighWater <= 63U),
+        "%lu writes, %lu bytes, %lu dropped, high water %u", (unsigned long)stats.Writes, (unsigned long)stats.Bytes,
+        (unsigned long)stats.Dropped, stats.HighWater);
+}
+
+static void Test_Full(void)
+{
+  uint8_t data[100];
+  uint32_t i = 0;
+  u16 queued = 0;
+  LOG_Stats stats;
+
+  for(i = 0; i < sizeof(data); i++)
+  {
+    data[i] = (uint8_t)('0' + (i % 10U));
+  }
+
+  Test_Start(64);
+  Sim_StepOn();
+  queued = u16LOG_Write(data, sizeof(data));
+  Sim_StepOff();
+  Test_Expect(data, queued);
+  Test_Drain("full ring");
+
+  CHECK(OK == xLOG_GetStats(&stats), "stats");
+  CHECK((queued == 63U) && (stats.Dropped == 37U) && (stats.HighWater == 63U),
+        "%u queued, %lu dropped, high water %u", queued, (unsigned long)stats.Dropped, stats.HighWater);
+}
+
+static void Test_NestedWriter(void)
+{
+  uint8_t record[200];
+
+  memset(record, 'A', sizeof(record));
+  record[sizeof(record) - 1U] = '\n';
+
+  Test_Start(256);
+  Test_IsrWriters = 0;
+  Test_IsrQueued = 0;
+
+  /* Falls in the copy loop of the Thread Write */
+  Sim_WriterAt = Sim_Cycles + 600U;
+  Sim_NextEvent = Sim_WriterAt;
+  Sim_IrqEnabled[SIM_WRITER_IRQ] = 1;
+
+  Sim_StepOn();
+  CHECK(sizeof(record) == u16LOG_Write(record, sizeof(record)), "thread record");
+  Sim_StepOff();
+
+  Test_Expect(record, sizeof(record));
+  Test_Expect(Test_IsrRecord, sizeof(Test_IsrRecord) - 1U);
+  Test_Drain("ISR writing in a Thread Write");
+
+  CHECK(Sim_IrqTaken[SIM_WRITER_IRQ] == 1U, "writer ISR taken %lu times", (unsigned long)Sim_IrqTaken[SIM_WRITER_IRQ]);
+  CHECK((Test_IsrWriters == 1U) && (Test_IsrWireCount == 0) && (Test_IsrQueued == (sizeof(Test_IsrRecord) - 1U)),
+        "ISR ran with %lu writers, %lu bytes sent, %lu queued", (unsigned long)Test_IsrWriters,
+        (unsigned long)Test_IsrWireCount, (unsigned long)Test_IsrQueued);
+
+  Sim_IrqEnabled[SIM_WRITER_IRQ] = 0;
+}
+
+static void Test_OtherUser(void)
+{
+  static const uint8_t line[] = "queued behind another DMA user\n";
+
+  Test_Start(128);
+  Sim_OtherUser = 1;
+
+  Sim_StepOn();
+  CHECK((sizeof(line) - 1U) == u16LOG_Write(line, sizeof(line) - 1U), "write");
+  Sim_StepOff();
+  CHECK((Sim_TxSegment == 0) && (u16LOG_Pending() == (sizeof(line) - 1U)), "sent while the USART is busy");
+
+  /* The other user's Tx Complete */
+  Sim_OtherUser = 0;
+  Sim_StepOn();
+  Sim_TxIdle(USART1);
+  Sim_StepOff();
+
+  Test_Expect(line, sizeof(line) - 1U);
+  Test_Drain("Tx Idle callback");
+}
+
+static void Test_Bench(void)
+{
+  uint8_t line[TEST_LINE], data[256];
+  uint64_t start = 0, end = 0, idle = 0, irq = 0, cycles = 0, mask = 0;
+  uint32_t lines = 0;
+  LOG_Stats stats;
+
+  memset(data, 'x', sizeof(data));
+
+  /* Enqueue Latency of one Write, ring empty */
+  Test_Start(1024);
+  Sim_StepOn();
+  start = Sim_Cycles;
+  u16LOG_Write(data, sizeof(data));
+  cycles = Sim_Cycles - start;
+  Sim_StepOff();
+  mask = Sim_MaskMax;
+  Test_Expect(data, sizeof(data));
+  Test_Drain("256 byte write");
+
+  printf("256 byte write: %lu cycles (%.2f cycles/byte), longest PRIMASK %lu cycles\n",
+         (unsigned long)cycles, (double)cycles / (double)sizeof(data), (unsigned long)mask);
+  CHECK(mask < 200U, "Interrupts masked %lu cycles for a 256 byte write", (unsigned long)mask);
+  CHECK(mask < (cycles / 4U), "PRIMASK %lu of %lu cycles", (unsigned long)mask, (unsigned long)cycles);
+
+  /* Thread printing as fast as the USART drains, the ring stays nearly full */
+  Test_Start(1024);
+  Sim_StepOn();
+  start = Sim_Cycles;
+  idle = Sim_IdleCycles;
+  irq = Sim_IrqCycles;
+  end = start + (uint64_t)(TEST_BENCH_SECONDS * SIM_HCLK);
+  while(Sim_Cycles < end)
+  {
+    Test_MakeLine(line, lines, TEST_LINE);
+    while(u16LOG_Pending() > (1023U - TEST_LINE))
+    {
+      Sim_Wfi();
+    }
+    u16LOG_Write(line, TEST_LINE);
+    lines++;
+  }
+  cycles = Sim_Cycles - start;
+  idle = Sim_IdleCycles - idle;
+  irq = Sim_IrqCycles - irq;
+  Sim_StepOff();
+  xLOG_GetStats(&stats);
+
+  printf("%u byte lines at %lu bits/s: %.0f bytes/s on the wire (%.0f max), %lu lines, Write %.0f cycles avg %lu max,"
+         " %.0f cycles/line in interrupts, CPU busy %.2f%% (line formatting included), longest PRIMASK %lu cycles\n",
+         TEST_LINE, (unsigned long)SIM_BAUD, (double)Sim_WireCount * SIM_HCLK / (double)cycles, (double)SIM_BAUD / 10.0,
+         (unsigned long)lines, (double)stats.TotalWriteCycles / (double)stats.Writes, (unsigned long)stats.MaxWriteCycles,
+         (double)irq / (double)lines, 100.0 * (double)(cycles - idle) / (double)cycles, (unsigned long)Sim_MaskMax);
+
+  CHECK(stats.Dropped == 0, "%lu bytes dropped", (unsigned long)stats.Dropped);
+  CHECK(((double)Sim_WireCount * SIM_HCLK / (double)cycles) > (0.99 * SIM_BAUD / 10.0), "wire not kept busy");
+
+  /* Let the ring drain before the next test */
+  Sim_StepOn();
+  while((u16LOG_Pending() != 0) || (Sim_TxSegment != 0))
+  {
+    Sim_Wfi();
+  }
+  Sim_StepOff();
+}
+
+int main(void)
+{
+  Sim_CpuStart();
+  Sim_IrqConnect(SIM_DMA_IRQ, Sim_DmaIrq, 1);
+  Sim_IrqEnabled[SIM_DMA_IRQ] = 1;
+  Sim_IrqConnect(SIM_WRITER_IRQ, Test_WriterIrq, 0);
+
+  Test_Wrap();
+  Test_Full();
+  Test_NestedWriter();
+  Test_OtherUser();
+  Test_Bench();
+
+  printf("%s (%lu failures)\n", (u32Failures == 0) ? "PASS" : "FAIL", (unsigned long)u32Failures);
+  return (u32Failures == 0) ? 0 : 1;
+}
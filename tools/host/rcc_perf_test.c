@@ -0,0 +1,420 @@
+/*
+ * rcc_perf_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ *
+ *  Host test of the RCC Performance Levels & Staged init (Drivers/RCC) over simulated registers
+ *  - xRCC_checkPerfTable accepts the shipped Profiles table
+ *  - Every Level reaches its SYSCLK, Flash wait states & Voltage scale
+ *  - SYSCLK source only changes with interrupts masked, Subscribers run with them enabled
+ *  - A PLL that never locks leaves SYSCLK on HSI and reports NOK
+ *  - Staged init reaches the PLL, a SYSCLK switch that never happens leaves it on HSI
+ *  - Boot time model (HSE start up, PLL lock, HCLK cost of every RCC access): time to
+ *    the first GPIO write & to clocks ready, staged (main.c order) vs serial xRCC_init,
+ *    DWT boot Marks (Drivers/DWT) against the model time across the HSI -> PLL switch
+ *
+ *  RCC_Prog.c & DWT_Prog.c are included in this file so their register macros can point
+ *  to the simulated registers, every access to them steps the simulated hardware
+ *
+ *  Build & run from tools/host:
+ *  gcc -O2 -Wall -I../../Drivers/RCC -I../../Drivers/SYSTICK -I../../Drivers/DWT -I../../Drivers/STD_and_MATH \
+ *      rcc_perf_test.c -o rcc_perf_test && ./rcc_perf_test
+ */
+
+#include <stdio.h>
+#include <math.h>
+
+#include "RCC_Init.h"
+#include "SYSTICK_Init.h"
+#include "DWT_Init.h"
+#include "DWT_Reg.h"
+
+static u32 u32Failures;
+
+#define CHECK(cond, ...)	do{ if(!(cond)){ u32Failures++; printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } }while(0)
+
+/*
+ * Simulated hardware: ready flags follow their enable bits, SYSCLK status follows
+ * the SYSCLK switch, a broken PLL never reports lock
+ */
+static RCC_REG Sim_Rcc;
+static volatile u32 Sim_FlashAcr;
+static volatile u32 Sim_PwrCr;
+static volatile u32 Sim_PwrCsr;
+static u8  Sim_PllBroken;
+static u8  Sim_SwitchBroken;
+static u32 Sim_CriticalDepth;
+static u32 Sim_SwitchesUnmasked;
+
+/*
+ * Boot time model, off for the functional tests (ready flags follow at once):
+ * every RCC access (with the code around it) costs SIM_ACCESS_CYCLES of HCLK,
+ * HSE & PLL are ready a start up time after they are enabled
+ */
+#define SIM_ACCESS_CYCLES		(10U)
+#define SIM_HSE_STARTUP_US		(2000.0)		//tSU(HSE) typical, 8 MHz crystal
+#define SIM_PLL_LOCK_US			(100.0)
+#define SIM_PORT_INIT_CYCLES	(4000U)			//Port_Init of the main.c configuration
+#define SIM_HW_INIT_CYCLES		(2000U)			//SysTick & the rest of Hardware_Init after the switch
+
+static u8 Sim_Latency;
+static u64 Sim_Cycles;
+static double Sim_TimeUs;
+static double Sim_HseOnUs = -1.0;
+static double Sim_PllOnUs = -1.0;
+
+//DWT Cycle Counter follows the model Cycles from vidDWT_Init
+static volatile u32 Sim_Dwt;
+static volatile u32 Sim_CycCnt;
+static u64 Sim_CycBase;
+
+static void vidSimStep(void);
+static void vidSimCycCnt(void);
+
+#undef RCC
+#undef RCC_FLASH_ACR
+#undef RCC_PWR_CR
+#undef RCC_PWR_CSR
+#define RCC				(vidSimStep(), &Sim_Rcc)
+#define RCC_FLASH_ACR	(*(vidSimStep(), &Sim_FlashAcr))
+#define RCC_PWR_CR		(*(vidSimStep(), &Sim_PwrCr))
+#define RCC_PWR_CSR		(*(vidSimStep(), &Sim_PwrCsr))
+
+#include "../../Drivers/RCC/RCC_Prog.c"
+
+#undef DWT_DEMCR
+#undef DWT_CTRL
+#undef DWT_CYCCNT
+#undef DWT_LAR
+#define DWT_DEMCR		Sim_Dwt
+#define DWT_CTRL		Sim_Dwt
+#define DWT_CYCCNT		(*(vidSimCycCnt(), &Sim_CycCnt))
+#define DWT_LAR			Sim_Dwt
+
+#include "../../Drivers/DWT/DWT_Prog.c"
+
+//Core clock from the simulated SYSCLK status (AHB not divided)
+static u32 u32SimHclk(void)
+{
+	u32 u32Input = ((Sim_Rcc.PLLCFGR & (PLL_SOURCE_HSE << PLL_SOURCE_BIT)) != 0) ? HSE_CLOCK_VALUE : HSI_CLOCK_VALUE;
+
+	switch((Sim_Rcc.CFGR & SYSCLK_STATUS_MASKING) >> SYSCLK_STATUS_FIRST_BIT)
+	{
+		case SYSCLK_SOURCE_HSE:
+			return HSE_CLOCK_VALUE;
+
+		case SYSCLK_SOURCE_PLL:
+			return ((u32Input / (Sim_Rcc.PLLCFGR & PLLM_MASKING)) * ((Sim_Rcc.PLLCFGR & PLLN_MASKING) >> PLLN_FIRST_BIT)) /
+			       ((((Sim_Rcc.PLLCFGR & PLLP_MASKING) >> PLLP_FIRST_BIT) + 1U) * 2U);
+
+		default:
+			return HSI_CLOCK_VALUE;
+	}
+}
+
+//Run u32Cycles of HCLK
+static void vidSimWork(u32 u32Cycles)
+{
+	Sim_Cycles += u32Cycles;
+	Sim_TimeUs += ((double)u32Cycles * 1e6) / (double)u32SimHclk();
+}
+
+static void vidSimCycCnt(void)
+{
+	Sim_CycCnt = (u32)(Sim_Cycles - Sim_CycBase);
+}
+
+//An enabled Oscillator is ready once its start up time passed
+static u8 u8SimReady(u8 u8On, double* pf64OnUs, double f64StartupUs)
+{
+	if(u8On == 0)
+	{
+		*pf64OnUs = -1.0;
+		return 0;
+	}
+
+	if(*pf64OnUs < 0)
+	{
+		*pf64OnUs = Sim_TimeUs;
+	}
+
+	return (Sim_Latency == 0) || ((Sim_TimeUs - *pf64OnUs) >= f64StartupUs);
+}
+
+static void vidSimFollow(volatile u32* pReg, u8 u8Ready, u8 u8On)
+{
+	*pReg = (*pReg & ~(1UL << u8Ready)) | (u8On ? (1UL << u8Ready) : 0UL);
+}
+
+static void vidSimStep(void)
+{
+	u32 u32Sws = ((Sim_Rcc.CFGR & 0x3UL) << SYSCLK_STATUS_FIRST_BIT);
+	u8  u8PllOn = 0;
+
+	if(Sim_Latency != 0)
+	{
+		vidSimWork(SIM_ACCESS_CYCLES);
+	}
+
+	u8PllOn = u8SimReady((BIT_IS_SET(Sim_Rcc.CR, PLL_ENABLE_BIT) != 0) && (Sim_PllBroken == 0), &Sim_PllOnUs, SIM_PLL_LOCK_US);
+
+	vidSimFollow(&Sim_Rcc.CR, HSI_READY_BIT, BIT_IS_SET(Sim_Rcc.CR, HSI_FIRST_BIT) != 0);
+	vidSimFollow(&Sim_Rcc.CR, HSE_READY_BIT, u8SimReady(BIT_IS_SET(Sim_Rcc.CR, HSE_ENABLE_BIT) != 0, &Sim_HseOnUs, SIM_HSE_STARTUP_US));
+	vidSimFollow(&Sim_Rcc.CR, PLL_READY_BIT, u8PllOn);
+
+	//Switch to a PLL that is not ready is ignored by the hardware
+	if( ((Sim_Rcc.CFGR & SYSCLK_STATUS_MASKING) != u32Sws) &&
+		((u32Sws != (SYSCLK_SOURCE_PLL << SYSCLK_STATUS_FIRST_BIT)) || (u8PllOn && (Sim_SwitchBroken == 0))) ){
+
+		if(Sim_CriticalDepth == 0){
+			Sim_SwitchesUnmasked++;
+		}
+
+		Sim_Rcc.CFGR = (Sim_Rcc.CFGR & ~(u32)SYSCLK_STATUS_MASKING) | u32Sws;
+	}
+
+	vidSimFollow(&Sim_PwrCsr, PWR_VOSRDY_BIT, u8PllOn);
+	vidSimFollow(&Sim_PwrCsr, PWR_ODRDY_BIT, BIT_IS_SET(Sim_PwrCr, PWR_ODEN_BIT) != 0);
+	vidSimFollow(&Sim_PwrCsr, PWR_ODSWRDY_BIT, BIT_IS_SET(Sim_PwrCr, PWR_ODSWEN_BIT) != 0);
+}
+
+u32 u32SYSTICK_EnterCritical(void)
+{
+	return Sim_CriticalDepth++;
+}
+
+void vidSYSTICK_ExitCritical(u32 u32State)
+{
+	Sim_CriticalDepth = u32State;
+}
+
+//Subscriber: records the new SYSCLK & whether interrupts were masked
+static u32 u32NotifiedSysclk;
+static u32 u32Notifications;
+static u32 u32NotifiedMasked;
+
+static void vidOnClockChange(const RCC_clockValues * oldClocks, const RCC_clockValues * newClocks)
+{
+	(void)oldClocks;
+
+	u32Notifications++;
+	u32NotifiedSysclk = newClocks -> SYSCLKFrequency;
+
+	if(Sim_CriticalDepth != 0){
+		u32NotifiedMasked++;
+	}
+}
+
+static void vidTestLevels(void)
+{
+	const RCC_perfProfile * profile = 0;
+	RCC_PerfLevel level = 0;
+	u8 u8Pass = 0;
+
+	//HSI at reset
+	Sim_Rcc.CR = (1UL << HSI_FIRST_BIT);
+	xRCC_subscribe(vidOnClockChange);
+
+	//Up, down & up again so every Level is entered from another one
+	for(u8Pass = 0; u8Pass < 3U; u8Pass++){
+		for(level = 0; level < RCC_PERF_LEVELS_NUM; level++){
+
+			RCC_PerfLevel target = (u8Pass == 1U) ? (RCC_PerfLevel)(RCC_PERF_LEVELS_NUM - 1U - level) : level;
+			profile = &g_perfProfiles[target];
+			u32Notifications = 0;
+
+			CHECK(OK == xRCC_setPerfLevel(target), "level %u failed", target);
+			CHECK(target == xRCC_getPerfLevel(), "level %u not reported", target);
+			CHECK((Sim_FlashAcr & FLASH_LATENCY_MASKING) == profile -> FlashLatency, "level %u wait states", target);
+			CHECK(((Sim_PwrCr & PWR_VOS_MASKING) >> PWR_VOS_FIRST_BIT) == profile -> VoltageScale, "level %u voltage scale", target);
+			CHECK((BIT_IS_SET(Sim_PwrCr, PWR_ODEN_BIT) != 0) == (profile -> OverDrive != 0), "level %u over-drive", target);
+			CHECK((Sim_Rcc.CFGR & SYSCLK_STATUS_MASKING) == ((u32)(profile -> SYSCLKSource) << SYSCLK_STATUS_FIRST_BIT), "level %u source", target);
+			CHECK(u32RCC_getSYSCLK() == profile -> SYSCLKFrequency, "level %u decoded %lu Hz", target, (unsigned long)u32RCC_getSYSCLK());
+			CHECK((u32Notifications == 0) || (u32NotifiedSysclk == profile -> SYSCLKFrequency), "level %u notified %lu Hz", target, (unsigned long)u32NotifiedSysclk);
+			CHECK(0 == Sim_CriticalDepth, "level %u left interrupts masked", target);
+		}
+	}
+
+	CHECK(0 == Sim_SwitchesUnmasked, "%lu SYSCLK switches with interrupts enabled", (unsigned long)Sim_SwitchesUnmasked);
+	CHECK(0 == u32NotifiedMasked, "%lu subscribers called with interrupts masked", (unsigned long)u32NotifiedMasked);
+}
+
+static void vidTestPllTimeout(void)
+{
+	Sim_PllBroken = 1;
+
+	CHECK(NOK == xRCC_setPerfLevel(RCC_PERF_LEVELS_NUM - 1U), "broken PLL reported OK");
+	CHECK(RCC_PERF_LEVELS_NUM == xRCC_getPerfLevel(), "level kept after failed switch");
+	CHECK((Sim_Rcc.CFGR & SYSCLK_STATUS_MASKING) == (SYSCLK_SOURCE_HSI << SYSCLK_STATUS_FIRST_BIT), "not on HSI after failed switch");
+	CHECK(u32RCC_getSYSCLK() == HSI_CLOCK_VALUE, "decoded %lu Hz after failed switch", (unsigned long)u32RCC_getSYSCLK());
+	CHECK(0 == Sim_CriticalDepth, "failed switch left interrupts masked");
+
+	Sim_PllBroken = 0;
+}
+
+//Staged init with the main.c configuration: 8 MHz / 4 * 80 / 2 = 80 MHz
+static void vidTestBoot(void)
+{
+	static RCC_config config;
+
+	config.OscillatorType	= OSCILLATOR_TYPE_HSE;
+	config.SYSCLKSource		= SYSCLK_SOURCE_PLL;
+	config.AHBDivisor		= AHB_NOT_DIVIDED;
+	config.APB1Divisor		= APB_DIVIDED_BY_2;
+	config.APB2Divisor		= APB_NOT_DIVIDED;
+	config.PLL.PLLStateMain	= PLL_STATE_MAIN_ON;
+	config.PLL.PLLSource	= PLL_SOURCE_HSE;
+	config.PLL.PLLM			= 4;
+	config.PLL.PLLN			= 80;
+	config.PLL.PLLP			= PLLP_VALUE_2;
+	config.PLL.PLLQ			= 3;
+
+	Sim_Rcc.CR   = (1UL << HSI_FIRST_BIT);
+	Sim_Rcc.CFGR = 0;
+	Sim_FlashAcr = 0;
+
+	CHECK(OK == xRCC_initStart(&config), "boot start");
+	CHECK(OK == xRCC_initComplete(), "boot to PLL failed");
+	CHECK(u32RCC_getSYSCLK() == 80000000U, "boot decoded %lu Hz", (unsigned long)u32RCC_getSYSCLK());
+	CHECK((Sim_FlashAcr & FLASH_LATENCY_MASKING) == u8RCC_getFlashLatency(80000000U), "boot wait states");
+
+	//Back to HSI at reset, then a SYSCLK switch the hardware never takes
+	Sim_Rcc.CR   = (1UL << HSI_FIRST_BIT);
+	Sim_Rcc.CFGR = 0;
+	Sim_SwitchBroken = 1;
+
+	CHECK(OK == xRCC_initStart(&config), "boot start");
+	CHECK(NOK == xRCC_initComplete(), "failed SYSCLK switch reported OK");
+	CHECK(1 == u8RCC_initPoll(), "poll still waiting after failed switch");
+	CHECK((Sim_Rcc.CFGR & SYSCLK_CLEAR_CLOCK_SOURCE) == SYSCLK_SOURCE_HSI, "PLL still selected after failed switch");
+	CHECK(u32RCC_getSYSCLK() == HSI_CLOCK_VALUE, "decoded %lu Hz after failed switch", (unsigned long)u32RCC_getSYSCLK());
+	CHECK((Sim_FlashAcr & FLASH_LATENCY_MASKING) >= u8RCC_getFlashLatency(80000000U), "wait states lowered before a failed switch");
+
+	Sim_SwitchBroken = 0;
+}
+
+//Reset clocks & start the boot time model
+static void vidSimBootReset(void)
+{
+	Sim_Rcc.CR      = (1UL << HSI_FIRST_BIT);
+	Sim_Rcc.CFGR    = 0;
+	Sim_Rcc.PLLCFGR = 0x24003010UL;
+	Sim_FlashAcr    = 0;
+	Sim_PwrCr       = 0;
+	Sim_Cycles      = 0;
+	Sim_TimeUs      = 0;
+	Sim_HseOnUs     = -1.0;
+	Sim_PllOnUs     = -1.0;
+	Sim_Latency     = 1;
+}
+
+//GPIO Clocks & Port_Init, then the first GPIO write
+static void vidSimPortInit(u8 u8Staged)
+{
+	xRCC_EnableClock(RCC_GPIOA);
+	xRCC_EnableClock(RCC_GPIOC);
+	xRCC_EnableClock(RCC_GPIOG);
+	if(u8Staged != 0)
+	{
+		u8RCC_initPoll();
+	}
+
+	vidSimWork(SIM_PORT_INIT_CYCLES);
+	if(u8Staged != 0)
+	{
+		u8RCC_initPoll();
+	}
+}
+
+//Rest of Hardware_Init, from HCLK after the switch
+static void vidSimHardwareInit(void)
+{
+	RCC_clockValues clocks;
+
+	xRCC_getClocks(&clocks);
+	vidSimWork(SIM_HW_INIT_CYCLES);
+	xRCC_EnableClock(RCC_USART1);
+	xRCC_EnableClock(RCC_USART2);
+	xRCC_EnableClock(RCC_USART3);
+	xRCC_EnableClock(RCC_USART4);
+	xRCC_EnableClock(RCC_DMA2);
+	xRCC_EnableClock(RCC_DMA1);
+}
+
+//Boot of main.c (staged) vs xRCC_init then Port_Init (serial), with the same 80 MHz configuration
+static void vidTestBootTime(void)
+{
+	static RCC_config config;
+	double f64DwtUs = 0, f64HwUs = 0, f64StagedGpio = 0, f64StagedReady = 0, f64SerialGpio = 0, f64SerialReady = 0;
+	u32 u32MarkGpio = 0, u32MarkReady = 0;
+
+	config.OscillatorType	= OSCILLATOR_TYPE_HSE;
+	config.SYSCLKSource		= SYSCLK_SOURCE_PLL;
+	config.AHBDivisor		= AHB_NOT_DIVIDED;
+	config.APB1Divisor		= APB_DIVIDED_BY_2;
+	config.APB2Divisor		= APB_NOT_DIVIDED;
+	config.PLL.PLLStateMain	= PLL_STATE_MAIN_ON;
+	config.PLL.PLLSource	= PLL_SOURCE_HSE;
+	config.PLL.PLLM			= 4;
+	config.PLL.PLLN			= 80;
+	config.PLL.PLLP			= PLLP_VALUE_2;
+	config.PLL.PLLQ			= 3;
+
+	//Staged, main.c order: Clock_Start, vidDWT_Init, Port, Hardware_Init
+	vidSimBootReset();
+	CHECK(OK == xRCC_initStart(&config), "boot start");
+	Sim_CycBase = Sim_Cycles;
+	f64DwtUs = Sim_TimeUs;
+	vidDWT_Init();
+
+	vidSimPortInit(1);
+	f64StagedGpio = Sim_TimeUs;
+	vidDWT_Mark(0);
+
+	CHECK(OK == xRCC_initComplete(), "staged boot to PLL failed");
+	f64StagedReady = Sim_TimeUs;
+	vidSimHardwareInit();
+	f64HwUs = Sim_TimeUs;
+	vidDWT_Mark(1);
+
+	u32MarkGpio  = u32DWT_GetMark(0);
+	u32MarkReady = u32DWT_GetMark(1);
+
+	//Serial: every clock first, Port after
+	vidSimBootReset();
+	CHECK(OK == xRCC_init(&config), "serial boot failed");
+	f64SerialReady = Sim_TimeUs;
+	vidSimPortInit(0);
+	f64SerialGpio = Sim_TimeUs;
+	Sim_Latency = 0;
+
+	printf("Boot model: HSE start up %.0f us, PLL lock %.0f us, %u HCLK cycles per RCC access, Port_Init %u cycles\n",
+	       SIM_HSE_STARTUP_US, SIM_PLL_LOCK_US, SIM_ACCESS_CYCLES, SIM_PORT_INIT_CYCLES);
+	printf("%8s %16s %16s\n", "", "first GPIO us", "clocks ready us");
+	printf("%8s %16.1f %16.1f\n", "staged", f64StagedGpio, f64StagedReady);
+	printf("%8s %16.1f %16.1f\n", "serial", f64SerialGpio, f64SerialReady);
+	printf("DWT Marks (us from vidDWT_Init): first GPIO %lu (model %.1f), Hardware_Init done %lu (model %.1f)\n",
+	       (unsigned long)u32MarkGpio, f64StagedGpio - f64DwtUs, (unsigned long)u32MarkReady, f64HwUs - f64DwtUs);
+
+	CHECK(f64StagedGpio < (f64SerialGpio / 4.0), "staged first GPIO %.1f us vs serial %.1f us", f64StagedGpio, f64SerialGpio);
+	CHECK(f64StagedReady <= (f64SerialReady + 20.0), "staged clocks ready %.1f us vs serial %.1f us", f64StagedReady, f64SerialReady);
+	CHECK(fabs((double)u32MarkGpio - (f64StagedGpio - f64DwtUs)) <= 1.0, "first GPIO Mark %lu us", (unsigned long)u32MarkGpio);
+	//Only the RCC work between the switch & its Subscribers is counted with HSI
+	CHECK(fabs((double)u32MarkReady - (f64HwUs - f64DwtUs)) <= 10.0, "Hardware_Init Mark %lu us across the HCLK switch",
+	      (unsigned long)u32MarkReady);
+}
+
+int main(void)
+{
+	CHECK(OK == xRCC_checkPerfTable(), "profiles table rejected");
+
+	vidTestLevels();
+	vidTestPllTimeout();
+	vidTestBoot();
+	vidTestBootTime();
+
+	printf("%s (%lu failures)\n", (0 == u32Failures) ? "PASS" : "FAIL", (unsigned long)u32Failures);
+
+	return (0 == u32Failures) ? 0 : 1;
+}
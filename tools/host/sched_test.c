@@ -0,0 +1,174 @@
+/*
+ * sched_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ *
+ *  Host test & benchmark of the Scheduler (Drivers/SCHED)
+ *  - Ready Tasks run highest Priority first, Events posted meanwhile are merged
+ *  - A Task posting to a higher Priority Task is preempted at its return
+ *  - Post -> Dispatch latency (ns) of the lowest of 32 Priorities
+ *
+ *  Build & run from tools/host:
+ *  gcc -O2 -Wall -I../../Drivers/SCHED -I../../Drivers/SYSTICK -I../../Drivers/STD_and_MATH \
+ *      sched_test.c ../../Drivers/SCHED/SCHED_Prog.c -o sched_test && ./sched_test
+ */
+
+#include <stdio.h>
+#include <setjmp.h>
+#include <time.h>
+
+#include "STD_TYPES_OLD.h"
+#include "SYSTICK_Init.h"
+#include "SCHED_Init.h"
+
+#define TEST_BENCH_POSTS		(10000000UL)
+
+static u32 u32Failures;
+
+#define CHECK(cond, ...)	do{ if(!(cond)){ u32Failures++; printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } }while(0)
+
+//vidSCHED_Run never returns, Idle leaves it when the test has nothing left to post
+static jmp_buf Sim_Exit;
+static void (*Sim_OnIdle)(void);
+
+u32 u32SYSTICK_EnterCritical(void)
+{
+	return 0;
+}
+
+void vidSYSTICK_ExitCritical(u32 u32State)
+{
+	(void)u32State;
+}
+
+void vidSYSTICK_Idle(void)
+{
+	if(Sim_OnIdle != 0)
+	{
+		Sim_OnIdle();
+	}
+	else
+	{
+		longjmp(Sim_Exit, 1);
+	}
+}
+
+static void vidRunUntilIdle(void)
+{
+	if(setjmp(Sim_Exit) == 0)
+	{
+		vidSCHED_Run();
+	}
+}
+
+//Order test: every Task logs its Priority & Events
+static u8  Order[16];
+static u32 OrderEvents[16];
+static u32 u32OrderLen;
+
+#define LOG_TASK(PRIO)	static void vidTask##PRIO(u32 u32Events) { OrderEvents[u32OrderLen] = u32Events; Order[u32OrderLen++] = PRIO; }
+
+LOG_TASK(2)
+LOG_TASK(30)
+
+static void vidTask5(u32 u32Events)
+{
+	OrderEvents[u32OrderLen] = u32Events;
+	Order[u32OrderLen++] = 5;
+
+	//Higher Priority Task runs as soon as this one returns, before Priority 30
+	xSCHED_PostEvent(2, 0x40);
+}
+
+static void vidTestOrder(void)
+{
+	xSCHED_CreateTask(5, vidTask5);
+	xSCHED_CreateTask(2, vidTask2);
+	xSCHED_CreateTask(30, vidTask30);
+
+	CHECK(NOK == xSCHED_CreateTask(5, vidTask5), "priority created twice");
+	CHECK(OUTOFRANGE == xSCHED_CreateTask(SCHED_MAX_TASKS, vidTask5), "priority out of range");
+	CHECK(OUTOFRANGE == xSCHED_PostEvent(7, 1), "post to missing task");
+
+	xSCHED_PostEvent(30, 0x1);
+	xSCHED_PostEvent(5, 0x2);
+	xSCHED_PostEvent(5, 0x4);
+	xSCHED_PostEvent(2, 0x8);
+
+	u32OrderLen = 0;
+	vidRunUntilIdle();
+
+	CHECK(4 == u32OrderLen, "ran %lu tasks", (unsigned long)u32OrderLen);
+	CHECK((2 == Order[0]) && (0x8 == OrderEvents[0]), "first");
+	CHECK((5 == Order[1]) && (0x6 == OrderEvents[1]), "events of priority 5 not merged");
+	CHECK((2 == Order[2]) && (0x40 == OrderEvents[2]), "post from task not dispatched next");
+	CHECK((30 == Order[3]) && (0x1 == OrderEvents[3]), "lowest last");
+}
+
+static double f64Now(void)
+{
+	struct timespec Time;
+
+	clock_gettime(CLOCK_MONOTONIC, &Time);
+	return (double)Time.tv_sec + ((double)Time.tv_nsec * 1e-9);
+}
+
+//Benchmark: Idle posts the next Event (as an ISR would), the Task only counts
+static u32 u32Posts;
+static u32 u32Runs;
+static u8  u8BenchPrio;
+
+static void vidBenchTask(u32 u32Events)
+{
+	(void)u32Events;
+	u32Runs++;
+}
+
+static void vidBenchIdle(void)
+{
+	if(u32Posts == TEST_BENCH_POSTS)
+	{
+		longjmp(Sim_Exit, 1);
+	}
+
+	u32Posts++;
+	xSCHED_PostEvent(u8BenchPrio, 1);
+}
+
+static void vidBenchmark(void)
+{
+	double f64Start = 0;
+	u8 i = 0;
+
+	for(i = 0; i < SCHED_MAX_TASKS; i++)
+	{
+		xSCHED_CreateTask(i, vidBenchTask);
+	}
+
+	//Lowest Priority: CLZ has to skip 31 empty Priorities
+	u8BenchPrio = SCHED_MAX_TASKS - 1U;
+	u32Posts = 0;
+	u32Runs = 0;
+	Sim_OnIdle = vidBenchIdle;
+
+	f64Start = f64Now();
+	vidRunUntilIdle();
+
+	CHECK(u32Runs == TEST_BENCH_POSTS, "lost events %lu", (unsigned long)(TEST_BENCH_POSTS - u32Runs));
+
+	printf("post -> dispatch: %.1f ns per event (priority %u of %u)\n",
+			((f64Now() - f64Start) * 1e9) / (double)TEST_BENCH_POSTS, u8BenchPrio, SCHED_MAX_TASKS);
+
+	Sim_OnIdle = 0;
+}
+
+int main(void)
+{
+	vidTestOrder();
+	vidBenchmark();
+
+	printf("%s (%lu failures)\n", (0 == u32Failures) ? "PASS" : "FAIL", (unsigned long)u32Failures);
+
+	return (0 == u32Failures) ? 0 : 1;
+}
@@ -0,0 +1,188 @@
+/*
+ * scroll_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ *
+ *  Host test & benchmark of the lcd_log scroll (lcd_log.c, LCD_ScrollUp)
+ *  over the DMA2D model of dma2d_sim.h
+ *  - After every logged line the text zone is pixel for pixel the last
+ *    YWINDOW_SIZE lines redrawn from scratch (drawn on layer 2 as reference)
+ *  - Same after a scroll back / forward, a font change & a wrap of the cache
+ *  - Cost of one line appended to a full window: DMA2D transfers & CPU time,
+ *    scroll blit vs full redraw (DMA2D run time isn't modeled)
+ *
+ *  Build & run from tools/host:
+ *  gcc -O2 -Wall -no-pie -DSTM32F42_43xxx -DUSE_STDPERIPH_DRIVER -I../../Utilities/STM32F429I-Discovery \
+ *      -I../../Utilities/Common -I../../Libraries/CMSIS/Include -I../../Libraries/Device/ST/STM32F4xx/Include \
+ *      -I../../Libraries/STM32F4xx_StdPeriph_Driver/inc -I../../src scroll_test.c ../../Utilities/Common/fonts.c \
+ *      -o scroll_test && ./scroll_test
+ */
+
+#include <stdio.h>
+
+#include "lcd_sim.h"
+#include "../../Utilities/STM32F429I-Discovery/stm32f429i_discovery_dma2d.c"
+#include "../../Utilities/STM32F429I-Discovery/stm32f429i_discovery_lcd.c"
+#include "../../Utilities/Common/lcd_log.c"
+
+#define TEST_LINES				(150U)
+#define TEST_BENCH_LINES		(500U)
+#define TEST_REFERENCE			(LCD_FRAME_BUFFER + BUFFER_OFFSET)
+
+static uint32_t u32Failures;
+
+#define CHECK(cond, ...)	do{ if(!(cond)){ u32Failures++; printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } }while(0)
+
+/* Every line logged, as the reference draws it */
+static char Lines[TEST_LINES + TEST_BENCH_LINES][XWINDOW_MAX + 1];
+static uint16_t Colors[TEST_LINES + TEST_BENCH_LINES];
+static uint32_t u32Logged;
+/* First line logged since the text zone was cleared */
+static uint32_t u32Cleared;
+
+static void vidLog(const char *Text, uint16_t Color)
+{
+  sFONT *pFont = LCD_GetFont();
+  uint32_t i = 0;
+
+  LCD_LineColor = Color;
+
+  for(i = 0; Text[i] != 0; i++)
+  {
+    __io_putchar(Text[i]);
+  }
+  __io_putchar('\n');
+
+  /* The cache pads a line with spaces to the screen width */
+  snprintf(Lines[u32Logged], sizeof(Lines[0]), "%-*s", (int)(LCD_PIXEL_WIDTH / pFont->Width), Text);
+  Colors[u32Logged++] = Color;
+}
+
+/* Last lines logged drawn from scratch on layer 2, compared with the text zone of layer 1 */
+static uint32_t u32ZoneDiffs(uint32_t Last)
+{
+  sFONT *pFont = LCD_GetFont();
+  uint32_t first = (Last > (u32Cleared + YWINDOW_SIZE)) ? (Last - YWINDOW_SIZE) : u32Cleared, i = 0, diffs = 0;
+  uint32_t top = YWINDOW_MIN * pFont->Height, rows = YWINDOW_SIZE * pFont->Height;
+  const uint16_t *zone = 0, *reference = 0;
+
+  GFX_Wait();
+  LCD_SetLayer(LCD_FOREGROUND_LAYER);
+  GFX_Fill(LCD_SetCursor(0, top), LCD_PIXEL_WIDTH, LCD_PIXEL_WIDTH, rows, DMA2D_RGB565, LCD_COLOR_BLACK);
+
+  for(i = first; i < Last; i++)
+  {
+    LCD_SetTextColor(Colors[i]);
+    LCD_DisplayStringLine((YWINDOW_MIN + i - first) * pFont->Height, (uint8_t *)Lines[i]);
+  }
+
+  GFX_Wait();
+  LCD_SetLayer(LCD_BACKGROUND_LAYER);
+
+  zone = (const uint16_t *)(uintptr_t)(LCD_FRAME_BUFFER + (2 * top * LCD_PIXEL_WIDTH));
+  reference = (const uint16_t *)(uintptr_t)(TEST_REFERENCE + (2 * top * LCD_PIXEL_WIDTH));
+
+  for(i = 0; i < (rows * LCD_PIXEL_WIDTH); i++)
+  {
+    diffs += (zone[i] != reference[i]) ? 1U : 0U;
+  }
+
+  return diffs;
+}
+
+static void vidTestScroll(void)
+{
+  char text[XWINDOW_MAX + 1];
+  uint32_t i = 0, bad = 0, length = 0;
+
+  LCD_SetFont(&Font8x12);
+  LCD_SetBackColor(LCD_COLOR_BLACK);
+  LCD_SetLayer(LCD_BACKGROUND_LAYER);
+  LCD_LOG_Init();
+
+  for(i = 0; i < TEST_LINES; i++)
+  {
+    /* Lines of every length that fits Font12x12, short ones must clear what the one below left */
+    length = (i * 7U) % 16U;
+    snprintf(text, sizeof(text), "%03lu %.*s", (unsigned long)i, (int)length, "abcdefghijklmnopqrstuvwxyz0123456789");
+    vidLog(text, (uint16_t)(0x1000U + (i * 0x0421U)));
+
+    /* Scroll back 3 lines & forward again, then keep logging */
+    if(i == 60U)
+    {
+      CHECK(SUCCESS == LCD_LOG_ScrollBack(), "scroll back");
+      CHECK(SUCCESS == LCD_LOG_ScrollBack(), "scroll back");
+      CHECK(SUCCESS == LCD_LOG_ScrollBack(), "scroll back");
+      CHECK(SUCCESS == LCD_LOG_ScrollForward(), "scroll forward");
+    }
+
+    /* Font change: the zone & the cache are cleared, the next line can't be scrolled */
+    if(i == 100U)
+    {
+      LCD_SetFont(&Font12x12);
+      LCD_LOG_ClearTextZone();
+      u32Cleared = u32Logged;
+    }
+
+    if((i != 60U) && (i != 100U))
+    {
+      bad += (u32ZoneDiffs(u32Logged) != 0) ? 1U : 0U;
+    }
+  }
+
+  CHECK(0 == bad, "%lu of %u lines left a text zone unlike a full redraw", (unsigned long)bad, TEST_LINES);
+  CHECK(0 == GFX_GetErrors(), "%lu DMA2D errors", (unsigned long)GFX_GetErrors());
+}
+
+static void vidBenchmark(void)
+{
+  uint32_t i = 0, transfers[2] = {0, 0};
+  double start = 0, cpu[2] = {0, 0};
+  uint8_t redraw = 0;
+
+  LCD_SetFont(&Font8x12);
+  LCD_LOG_ClearTextZone();
+  u32Cleared = u32Logged;
+
+  for(i = 0; i < TEST_BENCH_LINES; i++)
+  {
+    /* Every other line is drawn the old way, by a full redraw */
+    redraw = (uint8_t)(i & 1U);
+    LCD_WindowSynced = (redraw != 0) ? DISABLE : LCD_WindowSynced;
+
+    GFX_Wait();
+    transfers[redraw] -= Sim_Transfers;
+    start = Sim_CpuNow();
+    vidLog("benchmark line 0123456789", LCD_COLOR_WHITE);
+    cpu[redraw] += Sim_CpuNow() - start;
+    GFX_Wait();
+    transfers[redraw] += Sim_Transfers;
+  }
+
+  CHECK(0 == u32ZoneDiffs(u32Logged), "text zone after the benchmark");
+
+  printf("line appended to a full window: scroll %.1f DMA2D transfers & %.1f us CPU, full redraw %.1f transfers & %.1f us CPU\n",
+         (double)transfers[0] / (TEST_BENCH_LINES / 2U), (cpu[0] * 1e6) / (TEST_BENCH_LINES / 2U),
+         (double)transfers[1] / (TEST_BENCH_LINES / 2U), (cpu[1] * 1e6) / (TEST_BENCH_LINES / 2U));
+}
+
+int main(void)
+{
+  if(Sim_Start() == 0)
+  {
+    printf("FAIL: SDRAM can't be mapped at 0x%08lX\n", (unsigned long)SIM_SDRAM_BASE);
+    return 1;
+  }
+
+  GFX_Init();
+
+  vidTestScroll();
+  vidBenchmark();
+
+  Sim_Stop();
+
+  printf("%s (%lu failures)\n", (0 == u32Failures) ? "PASS" : "FAIL", (unsigned long)u32Failures);
+
+  return (0 == u32Failures) ? 0 : 1;
+}
@@ -0,0 +1,34 @@
+/*
+ * std_types_sim.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ *
+ *  STD_TYPES_OLD.h with the target sizes for the Drivers harnesses:
+ *  u32/s32 are long (64 bit) on x86-64, the register structs would lose their layout.
+ *  Include first, it takes the _STD_TYPES_H guard of STD_TYPES_OLD.h
+ */
+
+#ifndef _STD_TYPES_H
+#define _STD_TYPES_H
+
+typedef unsigned char      u8;
+typedef unsigned short int u16;
+typedef unsigned int       u32;
+typedef unsigned long long u64;
+
+typedef signed char  s8;
+typedef signed short int   s16;
+typedef signed int   s32;
+
+typedef  float   f32;
+typedef  double   f64;
+
+typedef enum
+{
+    OK,
+    NOK,
+    OUTOFRANGE,
+    NULLPOINTER
+}Return_status;
+#endif
@@ -0,0 +1,196 @@
+/*
+ * swap_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ *
+ *  Host test of the LCD double buffering (stm32f429i_discovery_lcd.c)
+ *  over the LTDC & DMA2D models of lcd_sim.h
+ *  - LCD_SwapBuffers returns at once, the swap is pending until the line interrupt
+ *  - The line interrupt shows the back buffer only once DMA2D has finished the frame
+ *  - After the swap the new back buffer holds the shown frame (dirty regions copied)
+ *    and the line interrupt is off until the next swap
+ *  - CPU time of LCD_SwapBuffers & of the line interrupt
+ *  - SDRAM bytes copied per frame of a mostly static UI (one text line or one
+ *    widget changing) against the full frame copy of the old swap
+ *
+ *  Build & run from tools/host:
+ *  gcc -O2 -Wall -no-pie -DSTM32F42_43xxx -DUSE_STDPERIPH_DRIVER -I../../Utilities/STM32F429I-Discovery \
+ *      -I../../Libraries/CMSIS/Include -I../../Libraries/Device/ST/STM32F4xx/Include \
+ *      -I../../Libraries/STM32F4xx_StdPeriph_Driver/inc -I../../src swap_test.c ../../Utilities/Common/fonts.c \
+ *      -o swap_test && ./swap_test
+ */
+
+#include <stdio.h>
+
+#include "lcd_sim.h"
+#include "../../Utilities/STM32F429I-Discovery/stm32f429i_discovery_dma2d.c"
+#include "../../Utilities/STM32F429I-Discovery/stm32f429i_discovery_lcd.c"
+
+#define TEST_FRAMES				(1000U)
+#define TEST_UI_FRAMES			(200U)
+#define TEST_FRAME_BYTES		(2U * LCD_PIXEL_WIDTH * LCD_PIXEL_HEIGHT)
+
+static uint32_t u32Failures;
+
+#define CHECK(cond, ...)	do{ if(!(cond)){ u32Failures++; printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } }while(0)
+
+static int SameBuffers(uint32_t A, uint32_t B)
+{
+  return memcmp((const void *)(uintptr_t)A, (const void *)(uintptr_t)B, TEST_FRAME_BYTES) == 0;
+}
+
+/* One frame: a moving rectangle & a text line */
+static void vidDrawFrame(uint32_t Frame)
+{
+  uint8_t text[16];
+
+  LCD_SetTextColor((uint16_t)(Frame * 0x0841));
+  LCD_DrawFullRect((uint16_t)(Frame % 200U), 100, 40, 30);
+  snprintf((char *)text, sizeof(text), "frame %lu", (unsigned long)Frame);
+  LCD_DisplayStringLine(LINE(0), text);
+}
+
+static void vidTestSwap(void)
+{
+  uint32_t shown = 0, drawn = 0;
+
+  LCD_LayerInit();
+  LCD_SetLayer(LCD_BACKGROUND_LAYER);
+  LCD_Clear(LCD_COLOR_BLUE);
+  GFX_Wait();
+
+  LCD_DoubleBufferCmd(ENABLE);
+  GFX_Wait();
+  shown = Sim_LayerActive[0];
+  drawn = CurrentFrameBuffer;
+
+  CHECK(LCD_FRAME_BUFFER == shown, "layer 1 shows 0x%08lX", (unsigned long)shown);
+  CHECK((drawn != shown) && SameBuffers(drawn, shown), "back buffer not a copy of the screen");
+  CHECK(LCD_SWAP_LINE == Sim_Ltdc.LIPCR, "line interrupt on line %lu", (unsigned long)Sim_Ltdc.LIPCR);
+
+  /* Swap request: nothing changes until the line interrupt */
+  vidDrawFrame(1);
+  LCD_SwapBuffers();
+  CHECK(1 == LCD_IsSwapPending(), "swap not pending");
+  CHECK(shown == Sim_LayerActive[0], "address changed before the blanking");
+  CHECK(0 != (Sim_Ltdc.IER & LTDC_IER_LIE), "line interrupt not enabled");
+
+  /* DMA2D still drawing the frame: the swap waits for a later blanking */
+  Sim_Dma2dHold = 1;
+  GFX_Fill(CurrentFrameBuffer, LCD_PIXEL_WIDTH, 10, 10, DMA2D_RGB565, LCD_COLOR_RED);
+  Sim_LtdcBlanking();
+  CHECK(1 == LCD_IsSwapPending(), "swapped while DMA2D draws the frame");
+  CHECK(shown == Sim_LayerActive[0], "unfinished frame shown");
+  Sim_Dma2dHold = 0;
+  GFX_Wait();
+  LCD_MarkDirty(0, 0, 10, 10);
+
+  Sim_LtdcBlanking();
+  CHECK(0 == LCD_IsSwapPending(), "swap still pending");
+  CHECK(drawn == Sim_LayerActive[0], "back buffer not shown");
+  CHECK(shown == CurrentFrameBuffer, "drawing not moved to the old front");
+  CHECK(0 == (Sim_Ltdc.IER & LTDC_IER_LIE), "line interrupt left enabled");
+  CHECK((LCD_GetSwapBytes() != 0) && (LCD_GetSwapBytes() < TEST_FRAME_BYTES), "%lu bytes synced", (unsigned long)LCD_GetSwapBytes());
+
+  GFX_Wait();
+  CHECK(SameBuffers(CurrentFrameBuffer, Sim_LayerActive[0]), "new back buffer misses the shown frame");
+
+  /* No swap requested: the blanking changes nothing */
+  Sim_LtdcBlanking();
+  CHECK(drawn == Sim_LayerActive[0], "blanking without a swap moved the layer");
+}
+
+/* Frames drawn back to back: every swap is done at the next blanking, buffers stay in sync */
+static void vidTestFrames(void)
+{
+  uint32_t frame = 0, bad = 0, late = 0;
+  double start = 0, swap = 0, isr = 0;
+
+  for(frame = 2; frame < TEST_FRAMES; frame++)
+  {
+    vidDrawFrame(frame);
+
+    start = Sim_CpuNow();
+    LCD_SwapBuffers();
+    swap += Sim_CpuNow() - start;
+
+    /* A frame period is far longer than drawing: DMA2D is done at the blanking */
+    GFX_Wait();
+    start = Sim_CpuNow();
+    Sim_LtdcBlanking();
+    isr += Sim_CpuNow() - start;
+
+    late += LCD_IsSwapPending();
+    GFX_Wait();
+    bad += SameBuffers(CurrentFrameBuffer, Sim_LayerActive[0]) ? 0U : 1U;
+  }
+
+  CHECK(0 == late, "%lu swaps missed their blanking", (unsigned long)late);
+  CHECK(0 == bad, "%lu frames out of sync", (unsigned long)bad);
+  CHECK(0 == GFX_GetErrors(), "%lu DMA2D errors", (unsigned long)GFX_GetErrors());
+
+  printf("CPU busy per frame: %.3f us in LCD_SwapBuffers, %.3f us in the line interrupt (old swap spun up to a frame, 15.3 ms at 6 MHz pixel clock)\n",
+         (swap * 1e6) / (TEST_FRAMES - 2U), (isr * 1e6) / (TEST_FRAMES - 2U));
+}
+
+/* Mostly static UI: only a text line or a widget changes, the swap copies it alone */
+static void vidTestStaticUi(void)
+{
+  uint8_t text[16];
+  uint32_t frame = 0, bad = 0, bytes = 0, line = 0, widget = 0;
+
+  for(frame = 0; frame < TEST_UI_FRAMES; frame++)
+  {
+    /* Clock line */
+    snprintf((char *)text, sizeof(text), "%02lu:%02lu", (unsigned long)(frame / 60U), (unsigned long)(frame % 60U));
+    LCD_DisplayStringLine(LINE(5), text);
+    LCD_SwapBuffers();
+    GFX_Wait();
+    Sim_LtdcBlanking();
+    line += LCD_GetSwapBytes();
+    GFX_Wait();
+    bad += SameBuffers(CurrentFrameBuffer, Sim_LayerActive[0]) ? 0U : 1U;
+
+    /* Progress bar widget */
+    LCD_SetTextColor((uint16_t)(frame * 0x0841));
+    LCD_DrawFullRect(20, 200, (uint16_t)(1U + (frame % 200U)), 16);
+    LCD_SwapBuffers();
+    GFX_Wait();
+    Sim_LtdcBlanking();
+    bytes = LCD_GetSwapBytes();
+    widget += bytes;
+    GFX_Wait();
+    bad += SameBuffers(CurrentFrameBuffer, Sim_LayerActive[0]) ? 0U : 1U;
+  }
+  line /= TEST_UI_FRAMES;
+  widget /= TEST_UI_FRAMES;
+
+  CHECK(0 == bad, "%lu static UI frames out of sync", (unsigned long)bad);
+  CHECK(line <= (2U * LCD_PIXEL_WIDTH * LCD_Currentfonts->Height), "%lu bytes for one text line", (unsigned long)line);
+  CHECK(bytes <= (2U * 200U * 16U), "%lu bytes for the widget", (unsigned long)bytes);
+
+  printf("SDRAM bytes synced per frame, mostly static UI: %lu one text line, %lu one widget (old swap copied %lu, a full frame)\n",
+         (unsigned long)line, (unsigned long)widget, (unsigned long)TEST_FRAME_BYTES);
+}
+
+int main(void)
+{
+  if(Sim_Start() == 0)
+  {
+    printf("FAIL: SDRAM can't be mapped at 0x%08lX\n", (unsigned long)SIM_SDRAM_BASE);
+    return 1;
+  }
+
+  GFX_Init();
+
+  vidTestSwap();
+  vidTestFrames();
+  vidTestStaticUi();
+
+  Sim_Stop();
+
+  printf("%s (%lu failures)\n", (0 == u32Failures) ? "PASS" : "FAIL", (unsigned long)u32Failures);
+
+  return (0 == u32Failures) ? 0 : 1;
+}
@@ -0,0 +1,439 @@
+/*
+ * swtimer_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ *
+ *  Host test of the Timing Wheel (Drivers/SWTIMER) over a simulated SysTick
+ *  - Every Timer fires exactly at Start Tick + Delay (+ n * Period), on all Levels
+ *  - Restart from its own Callback (Delay 1 and longer), Stop of a Timer of the same Slot
+ *  - SysTick Driver wakeups per Tick (the Wheel must not need every Tick)
+ *  - Benchmark: Start and expire + restart throughput at 10 / 1k / 10k Active Timers,
+ *    Wheel vs the sorted List of SYSTICK_Prog.c (vidSYSTICK_TimerInsert, O(n) Start)
+ *
+ *  Build & run from tools/host:
+ *  gcc -O2 -Wall -DRAM_FUNC= -DCCM_BSS= -DCCM_DATA= -I../../Drivers/SWTIMER -I../../Drivers/SYSTICK -I../../Drivers/STD_and_MATH \
+ *      swtimer_test.c ../../Drivers/SWTIMER/SWTIMER_Prog.c -o swtimer_test && ./swtimer_test
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "STD_TYPES_OLD.h"
+#include "SYSTICK_Init.h"
+#include "SWTIMER_Init.h"
+
+#define TEST_TIMERS				(2000U)
+#define TEST_TICKS				(3000000UL)
+
+static u32 u32Failures;
+
+#define CHECK(cond, ...)	do{ if(!(cond)){ u32Failures++; printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } }while(0)
+
+/*
+ * Simulated SysTick: same contract as SYSTICK_Prog.c for the one Timer the Wheel uses
+ * Timer Deadline = Ticks + Delay, Callback runs from the Tick Handler when Ticks reach it
+ */
+static u64 Sim_Ticks;
+static SYSTICK_Timer* Sim_Timer;
+static u32 Sim_Wakeups;
+
+u64 u64SYSTICK_GetTicks(void)
+{
+	return Sim_Ticks;
+}
+
+Return_status xSYSTICK_TimerStart(SYSTICK_Timer* pTimer, u32 u32Delay, u32 u32Period, SYSTICK_TimerCallback pfCallback, void* pArg)
+{
+	pTimer->Deadline   = Sim_Ticks + u32Delay;
+	pTimer->Period     = u32Period;
+	pTimer->pfCallback = pfCallback;
+	pTimer->pArg       = pArg;
+	pTimer->Active     = 1;
+	Sim_Timer          = pTimer;
+
+	return OK;
+}
+
+void vidSYSTICK_TimerStop(SYSTICK_Timer* pTimer)
+{
+	pTimer->Active = 0;
+	Sim_Timer      = 0;
+}
+
+u32 u32SYSTICK_EnterCritical(void)
+{
+	return 0;
+}
+
+void vidSYSTICK_ExitCritical(u32 u32State)
+{
+	(void)u32State;
+}
+
+static void vidSimTick(void)
+{
+	SYSTICK_Timer* pTimer = Sim_Timer;
+
+	Sim_Ticks++;
+
+	if((pTimer != 0) && (pTimer->Active != 0) && (pTimer->Deadline <= Sim_Ticks))
+	{
+		pTimer->Active = 0;
+		Sim_Timer = 0;
+		Sim_Wakeups++;
+		pTimer->pfCallback(pTimer->pArg);
+	}
+}
+
+//Test Timer with the Tick it must fire at
+typedef struct{
+	SWTIMER_Timer	Timer;
+	u64				Due;
+	u32				Period;
+	u32				Fired;
+	u32				Late;
+	u32				Restart;	//Delay used to restart from the Callback (0 -> none)
+	u32				RestartsLeft;
+}TEST_Timer;
+
+static TEST_Timer Timers[TEST_TIMERS];
+
+static void vidOnTimer(void* pArg)
+{
+	TEST_Timer* pTest = (TEST_Timer*)pArg;
+
+	pTest->Fired++;
+
+	if(Sim_Ticks != pTest->Due)
+	{
+		pTest->Late++;
+	}
+
+	if(pTest->Period != 0)
+	{
+		pTest->Due += pTest->Period;
+	}
+	else if((pTest->Restart != 0) && (pTest->RestartsLeft != 0))
+	{
+		pTest->RestartsLeft--;
+		pTest->Due = Sim_Ticks + pTest->Restart;
+		xSWTIMER_Start(&pTest->Timer, pTest->Restart, 0, vidOnTimer, pTest);
+	}
+}
+
+static u32 u32RandDelay(void)
+{
+	//Spread Delays over all Levels (1..2^24)
+	return 1U + (u32)(((u64)rand() * rand()) % (1UL << (2U + (6U * (u32)(rand() % 4)))));
+}
+
+static void vidTestExact(void)
+{
+	u32 i = 0;
+	u64 u64Tick = 0;
+	u32 u32Late = 0;
+	u32 u32Missing = 0;
+	u32 u32Expected = 0;
+
+	vidSWTIMER_Init();
+
+	//Start Timers at random Ticks so they are placed against a moving Wheel
+	for(u64Tick = 0; u64Tick < TEST_TICKS; u64Tick++)
+	{
+		if((i < TEST_TIMERS) && ((rand() % 500) == 0))
+		{
+			Timers[i].Period  = ((i % 3) == 0) ? u32RandDelay() % 50000U + 1U : 0;
+			Timers[i].Restart = ((i % 3) == 1) ? (u32)(1U + (i % 7)) : 0;
+			Timers[i].RestartsLeft = 20;
+			Timers[i].Timer.Active = 0;
+			Timers[i].Due = Sim_Ticks + ((Timers[i].Restart != 0) ? Timers[i].Restart : u32RandDelay() % 400000U + 1U);
+			xSWTIMER_Start(&Timers[i].Timer, (u32)(Timers[i].Due - Sim_Ticks), Timers[i].Period, vidOnTimer, &Timers[i]);
+			i++;
+		}
+
+		vidSimTick();
+	}
+
+	for(i = 0; i < TEST_TIMERS; i++)
+	{
+		u32Late += Timers[i].Late;
+
+		if(Timers[i].Period == 0)
+		{
+			u32Expected = (Timers[i].Restart != 0) ? 21U : 1U;
+
+			if((Timers[i].Due <= TEST_TICKS) && (Timers[i].Fired != u32Expected))
+			{
+				u32Missing++;
+			}
+		}
+		else if(Timers[i].Fired == 0)
+		{
+			u32Missing++;
+		}
+
+		vidSWTIMER_Stop(&Timers[i].Timer);
+	}
+
+	CHECK(0 == u32Late, "%lu expiries on the wrong Tick", (unsigned long)u32Late);
+	CHECK(0 == u32Missing, "%lu timers with missing expiries", (unsigned long)u32Missing);
+	CHECK(0 == u32SWTIMER_GetCount(), "count %lu after stop", (unsigned long)u32SWTIMER_GetCount());
+	CHECK(0 == Sim_Timer, "driver still armed with no timers");
+}
+
+//A Timer restarting itself with Delay 1 must fire once per Tick, not loop inside one Tick
+static u32 u32SelfCount;
+static SWTIMER_Timer SelfTimer;
+
+static void vidOnSelf(void* pArg)
+{
+	(void)pArg;
+
+	if(++u32SelfCount < 100U)
+	{
+		xSWTIMER_Start(&SelfTimer, 1, 0, vidOnSelf, 0);
+	}
+}
+
+//Two Timers in the same Slot, the first one stops the second one
+static SWTIMER_Timer PairTimer[2];
+static u32 u32PairFired[2];
+
+static void vidOnPair(void* pArg)
+{
+	u32 u32Index = (u32)(size_t)pArg;
+
+	u32PairFired[u32Index]++;
+	vidSWTIMER_Stop(&PairTimer[u32Index ^ 1U]);
+}
+
+static void vidTestCallbacks(void)
+{
+	u32 i = 0;
+
+	vidSWTIMER_Init();
+
+	u32SelfCount = 0;
+	xSWTIMER_Start(&SelfTimer, 1, 0, vidOnSelf, 0);
+
+	for(i = 0; (i < 10U) && (u32SelfCount < 100U); i++)
+	{
+		vidSimTick();
+		CHECK(u32SelfCount == (i + 1U), "self restart fired %lu times after %lu ticks", (unsigned long)u32SelfCount, (unsigned long)(i + 1U));
+	}
+
+	for(i = 0; i < 200U; i++)
+	{
+		vidSimTick();
+	}
+
+	CHECK(100U == u32SelfCount, "self restart count %lu", (unsigned long)u32SelfCount);
+
+	xSWTIMER_Start(&PairTimer[0], 70, 0, vidOnPair, (void*)0);
+	xSWTIMER_Start(&PairTimer[1], 70, 0, vidOnPair, (void*)1);
+
+	for(i = 0; i < 100U; i++)
+	{
+		vidSimTick();
+	}
+
+	CHECK(1U == (u32PairFired[0] + u32PairFired[1]), "stopped timer of the same slot fired");
+	CHECK(0 == u32SWTIMER_GetCount(), "count %lu", (unsigned long)u32SWTIMER_GetCount());
+}
+
+//Driver wakeups for the main.c load: a 10 ms periodic Timer
+static void vidTestWakeups(void)
+{
+	SWTIMER_Timer Timer;
+	u64 u64Tick = 0;
+
+	vidSWTIMER_Init();
+	Sim_Wakeups = 0;
+	Timer.Active = 0;
+
+	xSWTIMER_Start(&Timer, 10, 10, 0, 0);
+
+	for(u64Tick = 0; u64Tick < 100000U; u64Tick++)
+	{
+		vidSimTick();
+	}
+
+	vidSWTIMER_Stop(&Timer);
+
+	printf("10 ms periodic timer: %lu driver wakeups in 100000 ticks\n", (unsigned long)Sim_Wakeups);
+	//One wakeup per expiry plus at most one per Level 0 wrap
+	CHECK(Sim_Wakeups <= (10000U + (100000U / SWTIMER_SLOTS) + 1U), "driver wakes up every tick");
+
+	//Single 60 s Timer: woken only on Level 0 wraps
+	Sim_Wakeups = 0;
+	xSWTIMER_Start(&Timer, 60000, 0, 0, 0);
+
+	for(u64Tick = 0; u64Tick < 60000U; u64Tick++)
+	{
+		vidSimTick();
+	}
+
+	printf("60 s one shot timer: %lu driver wakeups in 60000 ticks\n", (unsigned long)Sim_Wakeups);
+	CHECK(0 == u32SWTIMER_GetCount(), "one shot did not expire");
+}
+
+/*
+ * Sorted List Reference, same Insert as vidSYSTICK_TimerInsert (SYSTICK_Prog.c):
+ * walk to the first later Deadline, expire from the Head
+ */
+typedef struct BENCH_Node{
+	struct BENCH_Node*	pNext;
+	u64					Deadline;
+}BENCH_Node;
+
+static BENCH_Node* BenchList;
+
+static void vidListInsert(BENCH_Node* pNode)
+{
+	BENCH_Node** ppNode = &BenchList;
+
+	while((*ppNode != 0) && ((*ppNode)->Deadline <= pNode->Deadline))
+	{
+		ppNode = &((*ppNode)->pNext);
+	}
+
+	pNode->pNext = *ppNode;
+	*ppNode      = pNode;
+}
+
+#define BENCH_MAX_TIMERS		(10000U)
+#define BENCH_EXPIRIES			(200000U)	//Fewer at 10k Timers, the List takes ~50 us per restart
+#define BENCH_MAX_DELAY			(1000U)		//Restart Delays 1..1000 Ticks, 1 s at 1 ms
+
+static SWTIMER_Timer BenchTimers[BENCH_MAX_TIMERS];
+static BENCH_Node BenchNodes[BENCH_MAX_TIMERS];
+static u32 BenchSeed;
+static u32 BenchExpiries;
+
+static u32 u32BenchDelay(void)
+{
+	BenchSeed = (BenchSeed * 1103515245U) + 12345U;
+	return 1U + ((BenchSeed >> 8) % BENCH_MAX_DELAY);
+}
+
+static double f64BenchNow(void)
+{
+	struct timespec Now;
+
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+	return ((double)Now.tv_sec * 1e9) + (double)Now.tv_nsec;
+}
+
+static void vidOnBench(void* pArg)
+{
+	BenchExpiries++;
+	xSWTIMER_Start((SWTIMER_Timer*)pArg, u32BenchDelay(), 0, vidOnBench, pArg);
+}
+
+//ns per Start of u32Count Timers, then per expiry + restart in steady state
+static void vidBenchWheel(u32 u32Count, u32 u32Expiries, double* pf64Start, double* pf64Expire)
+{
+	double f64Time = 0;
+	u32 i = 0;
+
+	vidSWTIMER_Init();
+	BenchSeed = 1;
+
+	f64Time = f64BenchNow();
+	for(i = 0; i < u32Count; i++)
+	{
+		BenchTimers[i].Active = 0;
+		xSWTIMER_Start(&BenchTimers[i], u32BenchDelay(), 0, vidOnBench, &BenchTimers[i]);
+	}
+	*pf64Start = (f64BenchNow() - f64Time) / u32Count;
+
+	BenchExpiries = 0;
+	f64Time = f64BenchNow();
+	while(BenchExpiries < u32Expiries)
+	{
+		vidSimTick();
+	}
+	*pf64Expire = (f64BenchNow() - f64Time) / BenchExpiries;
+
+	for(i = 0; i < u32Count; i++)
+	{
+		vidSWTIMER_Stop(&BenchTimers[i]);
+	}
+}
+
+static void vidBenchList(u32 u32Count, u32 u32Expiries, double* pf64Start, double* pf64Expire)
+{
+	BENCH_Node* pNode = 0;
+	double f64Time = 0;
+	u64 u64Ticks = 0;
+	u32 i = 0;
+
+	BenchList = 0;
+	BenchSeed = 1;
+
+	f64Time = f64BenchNow();
+	for(i = 0; i < u32Count; i++)
+	{
+		BenchNodes[i].Deadline = u64Ticks + u32BenchDelay();
+		vidListInsert(&BenchNodes[i]);
+	}
+	*pf64Start = (f64BenchNow() - f64Time) / u32Count;
+
+	BenchExpiries = 0;
+	f64Time = f64BenchNow();
+	while(BenchExpiries < u32Expiries)
+	{
+		u64Ticks++;
+
+		while((BenchList != 0) && (BenchList->Deadline <= u64Ticks))
+		{
+			pNode     = BenchList;
+			BenchList = pNode->pNext;
+			BenchExpiries++;
+			pNode->Deadline = u64Ticks + u32BenchDelay();
+			vidListInsert(pNode);
+		}
+	}
+	*pf64Expire = (f64BenchNow() - f64Time) / BenchExpiries;
+}
+
+static void vidTestThroughput(void)
+{
+	static const u32 Counts[] = {10U, 1000U, BENCH_MAX_TIMERS};
+	double f64WheelStart = 0, f64WheelExpire = 0, f64ListStart = 0, f64ListExpire = 0;
+	u32 i = 0;
+
+	printf("\nHost ns per operation, random restart Delays of 1..%u Ticks\n", BENCH_MAX_DELAY);
+	printf("%8s %14s %14s %16s %16s\n", "timers", "wheel start", "list start", "wheel expire+", "list expire+");
+	printf("%8s %14s %14s %16s %16s\n", "", "ns", "ns", "restart ns", "restart ns");
+
+	for(i = 0; i < (sizeof(Counts) / sizeof(Counts[0])); i++)
+	{
+		vidBenchWheel(Counts[i], BENCH_EXPIRIES, &f64WheelStart, &f64WheelExpire);
+		vidBenchList(Counts[i], (Counts[i] < BENCH_MAX_TIMERS) ? BENCH_EXPIRIES : (BENCH_EXPIRIES / 10U), &f64ListStart, &f64ListExpire);
+
+		printf("%8lu %14.1f %14.1f %16.1f %16.1f\n", (unsigned long)Counts[i],
+		       f64WheelStart, f64ListStart, f64WheelExpire, f64ListExpire);
+	}
+
+	//O(1) vs O(n): the Wheel must win by far at 10k Timers
+	CHECK((f64WheelExpire * 10.0) < f64ListExpire, "wheel %.1f ns vs list %.1f ns per expiry at %lu timers",
+	      f64WheelExpire, f64ListExpire, (unsigned long)BENCH_MAX_TIMERS);
+	CHECK(0 == u32SWTIMER_GetCount(), "count %lu after the benchmark", (unsigned long)u32SWTIMER_GetCount());
+}
+
+int main(void)
+{
+	srand(1);
+
+	vidTestExact();
+	vidTestCallbacks();
+	vidTestWakeups();
+	vidTestThroughput();
+
+	printf("%s (%lu failures)\n", (0 == u32Failures) ? "PASS" : "FAIL", (unsigned long)u32Failures);
+
+	return (0 == u32Failures) ? 0 : 1;
+}
@@ -0,0 +1,378 @@
+/*
+ * systick_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ *
+ *  Host test & benchmark of the tickless idle of the SYSTICK Driver (vidSYSTICK_Idle,
+ *  Drivers/SYSTICK/SYSTICK_Prog.c) over a register model of SysTick (cpu_sim.h)
+ *  - STK_LOAD / STK_VAL / STK_CTRL: 24 bit down counter at HCLK, reload from LOAD after 0,
+ *    COUNTFLAG set at 0 & cleared by reading CTRL or writing VAL, writing VAL clears the
+ *    counter, a disabled counter keeps its value; ICSR PENDSTSET
+ *  - 1 ms Tick at 180 MHz, the Tick phase is kept from the first Tick: every 0 of the
+ *    counter must land on a whole Tick from it (phase drift, only a restart of the counter
+ *    by an early wakeup may move it, by at most TEST_RESTART_CYCLES) and the Tick counter
+ *    must match the Ticks that really passed (Tick drift), checked in every SysTick_Handler
+ *  - Periodic & random one shot Timers, alone, with another IRQ waking the core early
+ *    at random (100/s, 2000/s) & with no Timer at all (longest sleeps)
+ *  - Timers never expire early, nor more than one Tick late
+ *  - Benchmark: wakeups/s & idle percentage vs a periodic 1 ms Tick
+ *
+ *  Build & run from tools/host:
+ *  gcc -O2 -fno-tree-vectorize -fno-tree-loop-distribute-patterns -no-pie -Wall -Wno-pointer-to-int-cast -DRAM_FUNC= -DCCM_DATA= -DCCM_BSS= \
+ *      -I../../Drivers/STD_and_MATH -I../../Drivers/SYSTICK -I../../Drivers/RCC \
+ *      systick_test.c -o systick_test && ./systick_test
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "std_types_sim.h"
+#include "cpu_sim.h"
+#include "RCC_Init.h"
+
+#define STK_DISABLE_IRQ(u32State)	do{ (u32State) = Sim_GetPrimask(); Sim_DisableIrq(); }while(0)
+#define STK_RESTORE_IRQ(u32State)	Sim_SetPrimask(u32State)
+#define STK_WFI()					Sim_Wfi()
+
+#include "SYSTICK_Init.h"
+#include "SYSTICK_Reg.h"
+
+#define SIM_HCLK				(180000000ULL)
+#define SIM_TICK_LOAD			(179999U)			//1 ms
+#define SIM_PERIOD				((uint64_t)SIM_TICK_LOAD + 1U)
+
+#define SIM_CTRL				((uint32_t)(uintptr_t)&STK_CTRL)
+#define SIM_LOAD				((uint32_t)(uintptr_t)&STK_LOAD)
+#define SIM_VAL					((uint32_t)(uintptr_t)&STK_VAL)
+#define SIM_ICSR				((uint32_t)(uintptr_t)&SCB_ICSR)
+
+#define SIM_SYSTICK_IRQ			(127U)				//SysTick exception
+#define SIM_OTHER_IRQ			(6U)				//EXTI0
+#define SIM_OTHER_CYCLES		(300U)				//Work of its handler
+
+#define TEST_RUN_SECONDS		(2U)
+#define TEST_PERIODIC_TICKS		(10U)
+#define TEST_RESTART_CYCLES		(8U)				//Phase error allowed per Counter restart
+
+Return_status xRCC_subscribe(RCC_clockChangeCallback callback)
+{
+  (void)callback;
+  return OK;
+}
+
+#include "../../Drivers/SYSTICK/SYSTICK_Prog.c"
+
+/* SysTick counter: the cycle it reaches 0 while enabled, its value while disabled */
+static uint32_t Stk_Enabled;
+static uint64_t Stk_Zero;
+static uint32_t Stk_Frozen;
+static uint32_t Stk_CountFlag;
+
+/* Tick phase, set by the first 0 */
+static uint64_t Stk_Origin;
+static uint32_t Stk_Started;
+static int64_t Stk_Phase;
+static uint32_t Stk_Restarts;				//STK_VAL writes, the Counter loses its phase
+
+/* Other interrupt source, mean rate per second (0: off) */
+static uint32_t Sim_OtherRate;
+static uint64_t Sim_OtherNext = SIM_NEVER;
+static uint32_t Sim_OtherCount;
+static uint32_t Sim_Seed = 12345U;
+
+static uint32_t Sim_Random(void)
+{
+  Sim_Seed = (Sim_Seed * 1103515245U) + 12345U;
+  return (Sim_Seed >> 8) & 0xFFFFFFU;
+}
+
+static uint32_t Stk_Val(void)
+{
+  if(Stk_Enabled == 0)
+  {
+    return Stk_Frozen;
+  }
+
+  return (Stk_Zero > Sim_Cycles) ? (uint32_t)(Stk_Zero - Sim_Cycles) : 0U;
+}
+
+/* Every 0 the counter reached up to now */
+static void Stk_Update(void)
+{
+  uint64_t k = 0;
+
+  while((Stk_Enabled != 0) && (Stk_Zero <= Sim_Cycles))
+  {
+    Stk_CountFlag = 1;
+    if((Sim_Reg(SIM_CTRL) & STK_CTRL_TICKINT) != 0)
+    {
+      Sim_IrqSet(SIM_SYSTICK_IRQ);
+    }
+
+    k = (Stk_Zero - Stk_Origin + (SIM_PERIOD / 2U)) / SIM_PERIOD;
+    Stk_Phase = (int64_t)(Stk_Zero - Stk_Origin) - (int64_t)(k * SIM_PERIOD);
+
+    Stk_Zero += 1U + Sim_Reg(SIM_LOAD);
+  }
+}
+
+static void Sim_Schedule(void)
+{
+  uint64_t next = (Stk_Enabled != 0) ? Stk_Zero : SIM_NEVER;
+
+  Sim_NextEvent = (Sim_OtherNext < next) ? Sim_OtherNext : next;
+}
+
+static void Sim_RegRead(uint32_t Address)
+{
+  Stk_Update();
+
+  if(Address == SIM_CTRL)
+  {
+    Sim_SetReg(SIM_CTRL, (Sim_Reg(SIM_CTRL) & ~STK_CTRL_COUNTFLAG) | ((Stk_CountFlag != 0) ? STK_CTRL_COUNTFLAG : 0U));
+    Stk_CountFlag = 0;
+  }
+  else if(Address == SIM_VAL)
+  {
+    Sim_SetReg(SIM_VAL, Stk_Val());
+  }
+  else if(Address == SIM_ICSR)
+  {
+    Sim_SetReg(SIM_ICSR, (Sim_IrqPending[SIM_SYSTICK_IRQ] != 0) ? SCB_ICSR_PENDSTSET : 0U);
+  }
+
+  Sim_Schedule();
+}
+
+static void Sim_RegWrite(uint32_t Address, uint32_t Old)
+{
+  uint32_t value = Sim_Reg(Address);
+
+  (void)Old;
+  Stk_Update();
+
+  if(Address == SIM_CTRL)
+  {
+    if((Stk_Enabled == 0) && ((value & STK_CTRL_ENABLE) != 0))
+    {
+      Stk_Enabled = 1;
+      Stk_Zero = Sim_Cycles + ((Stk_Frozen == 0) ? (1U + (uint64_t)Sim_Reg(SIM_LOAD)) : Stk_Frozen);
+      if(Stk_Started == 0)
+      {
+        Stk_Started = 1;
+        Stk_Origin = Stk_Zero;
+      }
+    }
+    else if((Stk_Enabled != 0) && ((value & STK_CTRL_ENABLE) == 0))
+    {
+      Stk_Frozen = Stk_Val();
+      Stk_Enabled = 0;
+    }
+    Sim_SetReg(SIM_CTRL, value & ~STK_CTRL_COUNTFLAG);
+  }
+  else if(Address == SIM_VAL)
+  {
+    Stk_Restarts++;
+    Stk_Frozen = 0;
+    Stk_CountFlag = 0;
+    if(Stk_Enabled != 0)
+    {
+      Stk_Zero = Sim_Cycles + 1U + Sim_Reg(SIM_LOAD);
+    }
+    Sim_SetReg(SIM_VAL, 0);
+  }
+  else if(Address == SIM_LOAD)
+  {
+    Sim_SetReg(SIM_LOAD, value & STK_MAX_LOAD);
+  }
+  else if(Address == SIM_ICSR)
+  {
+    if((value & SCB_ICSR_PENDSTCLR) != 0)
+    {
+      Sim_IrqPending[SIM_SYSTICK_IRQ] = 0;
+    }
+    Sim_SetReg(SIM_ICSR, 0);
+  }
+
+  Sim_Schedule();
+}
+
+static void Sim_Tick(void)
+{
+  Stk_Update();
+
+  if(Sim_OtherNext <= Sim_Cycles)
+  {
+    Sim_IrqSet(SIM_OTHER_IRQ);
+    /* Uniform gaps in [0, 2 / rate), mean 1 / rate */
+    Sim_OtherNext = Sim_Cycles + 1U + (((2U * SIM_HCLK / Sim_OtherRate) * Sim_Random()) >> 24);
+  }
+
+  Sim_Schedule();
+}
+
+#define CHECK(cond, ...)	do{ if(!(cond)){ u32Failures++; printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } }while(0)
+
+static uint32_t u32Failures;
+
+/* Ticks since the first one, as the counter really counted them */
+static int64_t Test_TickDrift;
+static uint32_t Test_TickChecks;
+
+/* Timer expiry vs the time of its Tick, in cycles */
+static int64_t Test_Early;
+static int64_t Test_Late;
+static uint32_t Test_Expiries;
+
+static SYSTICK_Timer Test_Periodic;
+static SYSTICK_Timer Test_OneShot;
+static uint32_t Test_OneShots;
+
+static void Test_SysTick(void)
+{
+  int64_t truth = 0, drift = 0;
+
+  SysTick_Handler();
+
+  /* Tick n ends n Periods after the start (Tick 1 is the origin) */
+  truth = 1 + (int64_t)((Sim_Cycles - Stk_Origin) / SIM_PERIOD);
+  drift = (int64_t)SYSTICK_Ticks - truth;
+  if(llabs(drift) > llabs(Test_TickDrift))
+  {
+    Test_TickDrift = drift;
+  }
+  Test_TickChecks++;
+}
+
+static void Test_Other(void)
+{
+  Sim_Cycles += SIM_OTHER_CYCLES;
+  Sim_IrqCycles += SIM_OTHER_CYCLES;
+  Sim_OtherCount++;
+}
+
+/* Called at the Tick Deadline (the periodic Timer is re-armed already) */
+static void Test_Expired(uint64_t Deadline)
+{
+  int64_t due = (int64_t)Stk_Origin + ((int64_t)Deadline - 1) * (int64_t)SIM_PERIOD;
+  int64_t late = (int64_t)Sim_Cycles - due;
+
+  if(late < Test_Early)
+  {
+    Test_Early = late;
+  }
+  if(late > Test_Late)
+  {
+    Test_Late = late;
+  }
+  Test_Expiries++;
+}
+
+static void Test_PeriodicCallback(void* pArg)
+{
+  (void)pArg;
+  Test_Expired(Test_Periodic.Deadline - Test_Periodic.Period);
+}
+
+static void Test_OneShotCallback(void* pArg)
+{
+  (void)pArg;
+  Test_Expired(Test_OneShot.Deadline);
+  Test_OneShots++;
+  (void)xSYSTICK_TimerStart(&Test_OneShot, 1U + (Sim_Random() % 60U), 0, Test_OneShotCallback, 0);
+}
+
+static void Test_Run(const char *Name, uint32_t Timers, uint32_t OtherRate)
+{
+  SYSTICK_IdleStats stats;
+  uint64_t start = 0, idle = 0, end = 0, elapsed = 0;
+  uint32_t wakeups = 0, others = Sim_OtherCount, restarts = Stk_Restarts;
+  int64_t phase = Stk_Phase;
+  double seconds = 0;
+
+  Test_TickDrift = 0;
+  Test_Early = 0;
+  Test_Late = 0;
+  Test_Expiries = 0;
+
+  if(Timers != 0)
+  {
+    (void)xSYSTICK_TimerStart(&Test_Periodic, TEST_PERIODIC_TICKS, TEST_PERIODIC_TICKS, Test_PeriodicCallback, 0);
+    (void)xSYSTICK_TimerStart(&Test_OneShot, 7, 0, Test_OneShotCallback, 0);
+  }
+
+  Sim_OtherRate = OtherRate;
+  Sim_OtherNext = (OtherRate != 0) ? (Sim_Cycles + (SIM_HCLK / OtherRate)) : SIM_NEVER;
+  Sim_Schedule();
+
+  vidSYSTICK_GetIdleStats(&stats);
+  wakeups = stats.Wakeups;
+  start = Sim_Cycles;
+  idle = Sim_IdleCycles;
+  end = start + (TEST_RUN_SECONDS * SIM_HCLK);
+
+  Sim_StepOn();
+  while(Sim_Cycles < end)
+  {
+    vidSYSTICK_Idle();
+  }
+  Sim_StepOff();
+
+  vidSYSTICK_TimerStop(&Test_Periodic);
+  vidSYSTICK_TimerStop(&Test_OneShot);
+  Sim_OtherRate = 0;
+  Sim_OtherNext = SIM_NEVER;
+
+  vidSYSTICK_GetIdleStats(&stats);
+  elapsed = Sim_Cycles - start;
+  seconds = (double)elapsed / (double)SIM_HCLK;
+  restarts = Stk_Restarts - restarts;
+  phase = Stk_Phase - phase;
+
+  printf("%-26s %9.0f %9.0f %8.3f %6lld %9lu %8.2f %9lld..%lld\n", Name,
+         (double)(stats.Wakeups - wakeups) / seconds, (1000.0 + (double)(Sim_OtherCount - others) / seconds),
+         100.0 * (double)(Sim_IdleCycles - idle) / (double)elapsed, (long long)Test_TickDrift,
+         (unsigned long)restarts, (restarts != 0) ? ((double)phase / restarts) : (double)phase,
+         (long long)Test_Early, (long long)Test_Late);
+
+  CHECK(Test_TickDrift == 0, "%s: Tick counter off by %lld", Name, (long long)Test_TickDrift);
+  CHECK(llabs(phase) <= (int64_t)(restarts * TEST_RESTART_CYCLES), "%s: Tick phase drifted %lld cycles in %lu restarts",
+        Name, (long long)phase, (unsigned long)restarts);
+  CHECK(Test_Early >= 0, "%s: a Timer expired %lld cycles early", Name, (long long)-Test_Early);
+  CHECK(Test_Late < (int64_t)SIM_PERIOD, "%s: a Timer expired %lld cycles late", Name, (long long)Test_Late);
+  CHECK((Timers == 0) || (Test_Expiries > (TEST_RUN_SECONDS * 100U)), "%s: %lu Timer expiries", Name,
+        (unsigned long)Test_Expiries);
+  CHECK(Test_TickChecks != 0, "%s: no SysTick", Name);
+}
+
+int main(void)
+{
+  if(Sim_MapBlock(0xE000E000U, 0x1000U) != 0)
+  {
+    printf("SysTick / SCB addresses not free, build with -no-pie\n");
+    return 1;
+  }
+  Sim_CpuStart();
+  Sim_IrqConnect(SIM_SYSTICK_IRQ, Test_SysTick, 15);
+  Sim_IrqConnect(SIM_OTHER_IRQ, Test_Other, 5);
+  Sim_IrqEnabled[SIM_SYSTICK_IRQ] = 1;
+  Sim_IrqEnabled[SIM_OTHER_IRQ] = 1;
+
+  Sim_StepOn();
+  vidSYSTICK_Init(SIM_TICK_LOAD);
+  Sim_StepOff();
+
+  printf("%-26s %9s %9s %8s %6s %9s %8s %14s\n", "", "wakeup/s", "1ms tick", "idle %", "drift", "restarts",
+         "phase/r", "expiry cycles");
+  Test_Run("periodic + one shot", 1, 0);
+  Test_Run("timers, other IRQ 100/s", 1, 100);
+  Test_Run("timers, other IRQ 2000/s", 1, 2000);
+  Test_Run("no timer", 0, 0);
+  Test_Run("no timer, other IRQ 100/s", 0, 100);
+
+  printf("%s (%lu failures)\n", (u32Failures == 0) ? "PASS" : "FAIL", (unsigned long)u32Failures);
+  return (u32Failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,373 @@
+/*
+ * trace_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ *
+ *  Host test & benchmark of the binary Trace Log (Drivers/TRACE/TRACE_Prog.c), with the
+ *  FRAME encoder & a capturing model of xUSART_SendSegments_DMA (cpu_sim.h)
+ *  - TRACE0..TRACE3 Records: ID, Timestamp (the model Cycle Counter) & Args in the Ring,
+ *    one Drain Request for the first Record logged while the USART is idle
+ *  - vidTRACE_Drain: one Frame per call, whole Records only, nothing sent while the
+ *    USART is busy
+ *  - Full Ring: Records are dropped & counted, the Dropped word of the next Frame
+ *  - 4000 Records drained every 37 Records: the free running Indexes wrap the Ring
+ *  - Cycles per TRACE0 / TRACE3 call (target < 50)
+ *  The Frames, the .trace_fmt strings (base address + bytes) & the expected text are
+ *  written to <prefix>.bin / .fmt / .txt, trace_test.py decodes them with
+ *  tools/trace_decode.py (Decoder) and compares the text
+ *
+ *  Build & run from tools/host:
+ *  gcc -O2 -fno-tree-vectorize -fno-tree-loop-distribute-patterns -no-pie -Wall -Wno-pointer-to-int-cast \
+ *      -DRAM_FUNC= -DCCM_BSS= -DNO_INIT= -I../../Drivers/STD_and_MATH -I../../Drivers/TRACE -I../../Drivers/FRAME \
+ *      -I../../Drivers/USART -I../../Drivers/DMA -I../../Drivers/SYSTICK -I../../Drivers/DWT \
+ *      trace_test.c -o trace_test && ./trace_test /tmp/trace_test && python3 trace_test.py /tmp/trace_test
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "std_types_sim.h"
+#include "cpu_sim.h"
+#include "DWT_Reg.h"
+
+/* u32DWT_GetCycles is inline, its Cycle Counter is the model time */
+#undef DWT_CYCCNT
+#define DWT_CYCCNT				((u32)Sim_Cycles)
+
+#include "TRACE_Init.h"
+
+#define SIM_CAPTURE_SIZE		(1024U * 1024U)
+#define SIM_TEXT_SIZE			(1024U * 1024U)
+
+#define TEST_WRAP_RECORDS		(4000U)
+#define TEST_WRAP_DRAIN			(37U)
+
+/* USART: the Frame is captured when sent, Done when the test completes it */
+static USART_TxCallback Sim_TxDone;
+static USART_TxCallback Sim_TxIdle;
+static uint32_t Sim_TxBusy;
+static uint32_t Sim_OtherUser;
+static uint8_t Sim_Capture[SIM_CAPTURE_SIZE];
+static uint32_t Sim_CaptureCount;
+
+u32 u32SYSTICK_EnterCritical(void)
+{
+  u32 state = Sim_GetPrimask();
+
+  Sim_DisableIrq();
+
+  return state;
+}
+
+void vidSYSTICK_ExitCritical(u32 u32State)
+{
+  Sim_SetPrimask(u32State);
+}
+
+Return_status xUSART_SendSegments_DMA(USART_REG* USARTx, const USART_TxSegment* Segments, u8 u8Count, USART_TxCallback pfCallback)
+{
+  (void)USARTx;
+
+  if((Sim_TxBusy != 0) || (Sim_OtherUser != 0))
+  {
+    return NOK;
+  }
+  if((Segments == 0) || (u8Count != 1) || ((Sim_CaptureCount + Segments->Size) > SIM_CAPTURE_SIZE))
+  {
+    return NULLPOINTER;
+  }
+
+  memcpy(Sim_Capture + Sim_CaptureCount, Segments->pData, Segments->Size);
+  Sim_CaptureCount += Segments->Size;
+  Sim_TxDone = pfCallback;
+  Sim_TxBusy = 1;
+
+  return OK;
+}
+
+Return_status xUSART_SetTxIdleCallback(USART_REG* USARTx, USART_TxCallback pfCallback)
+{
+  (void)USARTx;
+  Sim_TxIdle = pfCallback;
+  return OK;
+}
+
+u8 u8USART_TxBusy(USART_REG* USARTx)
+{
+  (void)USARTx;
+  return (u8)((Sim_TxBusy | Sim_OtherUser) != 0);
+}
+
+/* vidFRAME_PollUSART isn't used here */
+u16 u16USART_RxRingGet(USART_REG* USARTx, const u8** ppData)
+{
+  (void)USARTx;
+  (void)ppData;
+  return 0;
+}
+
+void vidUSART_RxRingConsume(USART_REG* USARTx, u16 u16Count)
+{
+  (void)USARTx;
+  (void)u16Count;
+}
+
+#include "../../Drivers/FRAME/FRAME_Prog.c"
+#include "../../Drivers/TRACE/TRACE_Prog.c"
+
+static void Sim_RegRead(uint32_t Address)
+{
+  (void)Address;
+}
+
+static void Sim_RegWrite(uint32_t Address, uint32_t Old)
+{
+  (void)Address;
+  (void)Old;
+}
+
+static void Sim_Tick(void)
+{
+  Sim_NextEvent = SIM_NEVER;
+}
+
+#define CHECK(cond, ...)	do{ if(!(cond)){ u32Failures++; printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } }while(0)
+
+static uint32_t u32Failures;
+
+static uint32_t Test_Requests;
+
+/* Text trace_decode.py must print (without the Timestamps) & the span of the format strings */
+static char Test_Text[SIM_TEXT_SIZE];
+static uint32_t Test_TextCount;
+static uint32_t Test_FmtLow = ~0U;
+static uint32_t Test_FmtHigh;
+
+static void Test_Request(void)
+{
+  Test_Requests++;
+}
+
+static void Test_Printf(const char *Format, u32 Arg0, u32 Arg1, u32 Arg2)
+{
+  Test_TextCount += (uint32_t)snprintf(Test_Text + Test_TextCount, SIM_TEXT_SIZE - Test_TextCount, Format, Arg0, Arg1, Arg2);
+  Test_TextCount += (uint32_t)snprintf(Test_Text + Test_TextCount, SIM_TEXT_SIZE - Test_TextCount, "\n");
+}
+
+/* Record logged at Head: expected text from its format string & Args */
+static void Test_Logged(u32 u32Head)
+{
+  u32 header = 0, id = 0, args[TRACE_MAX_ARGS] = { 0 }, i = 0;
+  const char *format = 0;
+
+  if(TRACE_Head == u32Head)
+  {
+    return;
+  }
+
+  header = TRACE_Ring[u32Head & TRACE_RING_MASK];
+  id = header >> 2;
+  format = (const char *)(uintptr_t)id;
+  for(i = 0; i < (header & 0x3U); i++)
+  {
+    args[i] = TRACE_Ring[(u32Head + 2U + i) & TRACE_RING_MASK];
+  }
+
+  Test_Printf(format, args[0], args[1], args[2]);
+
+  if(id < Test_FmtLow)
+  {
+    Test_FmtLow = id;
+  }
+  if((id + strlen(format) + 1U) > Test_FmtHigh)
+  {
+    Test_FmtHigh = id + (uint32_t)strlen(format) + 1U;
+  }
+}
+
+#define TEST_TRACE(CALL)	do{ u32 u32Before = TRACE_Head; CALL; Test_Logged(u32Before); }while(0)
+
+/* Frame sent: its Tx Complete */
+static void Test_Complete(void)
+{
+  USART_TxCallback done = Sim_TxDone;
+
+  Sim_TxBusy = 0;
+  Sim_TxDone = 0;
+  if(done != 0)
+  {
+    done(USART1);
+  }
+}
+
+static void Test_DrainAll(void)
+{
+  while(TRACE_Head != TRACE_Tail)
+  {
+    vidTRACE_Drain();
+    Test_Complete();
+  }
+}
+
+static void Test_Records(void)
+{
+  static const char expected[] = "boot\nadc 1234\npos -5,7\nreg beef CAFE z\n";
+  u32 frames = 0, start = TRACE_Tail;
+  s32 x = -5;
+  TRACE_Stats stats;
+
+  vidTRACE_Init(USART1, Test_Request);
+  CHECK(Test_Requests == 0, "Drain requested with an empty Ring");
+
+  TEST_TRACE(TRACE0("boot"));
+  TEST_TRACE(TRACE1("adc %u", 1234));
+  TEST_TRACE(TRACE2("pos %d,%d", x, 7));
+  TEST_TRACE(TRACE3("reg %x %X %c", 0xBEEFU, 0xCAFEU, 'z'));
+
+  CHECK((Test_TextCount == (sizeof(expected) - 1U)) && (0 == memcmp(Test_Text, expected, Test_TextCount)),
+        "Records: %.*s", (int)Test_TextCount, Test_Text);
+  CHECK(TRACE_Head - start == (2U + 3U + 4U + 5U), "%lu words for 4 Records", (unsigned long)(TRACE_Head - start));
+  CHECK(Test_Requests == 1U, "%lu Drain Requests for 4 Records", (unsigned long)Test_Requests);
+
+  /* Another DMA user on the USART: nothing is taken from the Ring */
+  Sim_OtherUser = 1;
+  vidTRACE_Drain();
+  CHECK((Sim_CaptureCount == 0) && (TRACE_Tail == start), "Frame sent while the USART is busy");
+  Sim_OtherUser = 0;
+  Sim_TxIdle(USART1);
+  CHECK(Test_Requests == 2U, "Tx Idle didn't request a Drain");
+
+  xTRACE_GetStats(&stats);
+  frames = stats.Frames;
+  vidTRACE_Drain();
+  CHECK((TRACE_Tail == TRACE_Head) && (Sim_CaptureCount != 0) && (Sim_Capture[Sim_CaptureCount - 1U] == 0),
+        "4 Records in one Frame");
+  vidTRACE_Drain();
+  xTRACE_GetStats(&stats);
+  CHECK(stats.Frames == (frames + 1U), "%lu Frames sent, the USART was busy", (unsigned long)(stats.Frames - frames));
+  Test_Complete();
+  CHECK(Test_Requests == 2U, "Tx Done requested a Drain with an empty Ring");
+}
+
+static void Test_Dropped(void)
+{
+  static const char dropped[] = "-- 18 records dropped --\n";
+  u32 i = 0, kept = 0, text = Test_TextCount;
+  TRACE_Stats stats;
+
+  /* Ring of 512 words holds 102 Records of 5 words */
+  for(i = 0; i < 120U; i++)
+  {
+    u32 before = TRACE_Head;
+
+    TEST_TRACE(TRACE3("burst %u of %u, %x", i, 120, i * 0x1111U));
+    kept += (TRACE_Head != before) ? 1U : 0U;
+  }
+
+  xTRACE_GetStats(&stats);
+  CHECK((kept == 102U) && (stats.Dropped == 18U), "%lu kept, %lu dropped", (unsigned long)kept, (unsigned long)stats.Dropped);
+
+  /* trace_decode prints the new Dropped count before the Records of the Frame carrying it */
+  memmove(Test_Text + text + sizeof(dropped) - 1U, Test_Text + text, Test_TextCount - text);
+  memcpy(Test_Text + text, dropped, sizeof(dropped) - 1U);
+  Test_TextCount += sizeof(dropped) - 1U;
+
+  Test_DrainAll();
+}
+
+static void Test_Wrap(void)
+{
+  u32 i = 0, start = TRACE_Head;
+
+  for(i = 0; i < TEST_WRAP_RECORDS; i++)
+  {
+    switch(i % 4U)
+    {
+      case 0:  TEST_TRACE(TRACE0("tick")); break;
+      case 1:  TEST_TRACE(TRACE1("sample %d", (s32)(i * 7U) - 9000)); break;
+      case 2:  TEST_TRACE(TRACE2("rx %u bytes from %c", i % 251U, 'a' + (i % 26U))); break;
+      default: TEST_TRACE(TRACE3("sector %u state %X crc %x", i % 12U, i, ~i)); break;
+    }
+    Sim_Cycles += 3U;
+
+    if((i % TEST_WRAP_DRAIN) == (TEST_WRAP_DRAIN - 1U))
+    {
+      Test_DrainAll();
+    }
+  }
+  Test_DrainAll();
+
+  CHECK((TRACE_Head - start) > (4U * TRACE_RING_WORDS), "Ring wrapped %lu times", (unsigned long)((TRACE_Head - start) / TRACE_RING_WORDS));
+}
+
+/* Cycles of a Trace Point, the call included, less the cycles of reading Sim_Cycles */
+static void Test_Cycles(void)
+{
+  uint64_t start = 0, empty = 0, first = 0, cycles0 = 0, cycles3 = 0;
+  u32 before = TRACE_Head;
+
+  Sim_StepOn();
+  start = Sim_Cycles;
+  empty = Sim_Cycles - start;
+  start = Sim_Cycles + empty;
+  TRACE1("cycles %u", 1);
+  first = Sim_Cycles - start;
+  start = Sim_Cycles + empty;
+  TRACE0("cycles");
+  cycles0 = Sim_Cycles - start;
+  start = Sim_Cycles + empty;
+  TRACE3("cycles %u %u %u", 1, 2, 3);
+  cycles3 = Sim_Cycles - start;
+  Sim_StepOff();
+
+  Test_Logged(before);
+  Test_Logged(before + 3U);
+  Test_Logged(before + 5U);
+  Test_DrainAll();
+
+  printf("Trace Point: TRACE0 %lu cycles, TRACE3 %lu cycles, first Record after a Drain %lu cycles (Drain Request callback)\n",
+         (unsigned long)cycles0, (unsigned long)cycles3, (unsigned long)first);
+  CHECK((cycles0 < 50U) && (cycles3 < 50U), "TRACE0 %lu, TRACE3 %lu cycles", (unsigned long)cycles0, (unsigned long)cycles3);
+}
+
+static int Test_WriteFile(const char *Prefix, const char *Extension, const void *pHeader, size_t HeaderSize,
+                          const void *pData, size_t Size)
+{
+  char path[256];
+  FILE *file = 0;
+  int ok = 0;
+
+  snprintf(path, sizeof(path), "%s%s", Prefix, Extension);
+  file = fopen(path, "wb");
+  if(file == 0)
+  {
+    return 0;
+  }
+  ok = (fwrite(pHeader, 1, HeaderSize, file) == HeaderSize) && (fwrite(pData, 1, Size, file) == Size);
+  return (fclose(file) == 0) && ok;
+}
+
+int main(int argc, char **argv)
+{
+  const char *prefix = (argc > 1) ? argv[1] : "trace_test";
+  uint32_t base = 0;
+
+  Sim_CpuStart();
+
+  Test_Records();
+  Test_Dropped();
+  Test_Wrap();
+  Test_Cycles();
+
+  /* .trace_fmt: base address, then the bytes from the lowest to the end of the highest string */
+  base = Test_FmtLow;
+  CHECK(Test_WriteFile(prefix, ".fmt", &base, 4U, (const void *)(uintptr_t)Test_FmtLow, Test_FmtHigh - Test_FmtLow)
+        && Test_WriteFile(prefix, ".bin", "", 0U, Sim_Capture, Sim_CaptureCount)
+        && Test_WriteFile(prefix, ".txt", "", 0U, Test_Text, Test_TextCount), "writing %s.*", prefix);
+
+  printf("%s (%lu failures)\n", (u32Failures == 0) ? "PASS" : "FAIL", (unsigned long)u32Failures);
+  return (u32Failures == 0) ? 0 : 1;
+}
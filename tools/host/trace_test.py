@@ -0,0 +1,84 @@
+#!/usr/bin/env python3
+"""
+trace_test.py
+
+  Created on: Oct 19, 2026
+      Author: Islam Ehab
+
+Second half of trace_test.c: decodes the Frames it captured with
+tools/trace_decode.py (Decoder) against its .trace_fmt strings and compares
+the text, Timestamps must never go back.
+
+Usage:
+    trace_test.py /tmp/trace_test      (reads .fmt .bin .txt written by trace_test)
+"""
+
+import contextlib
+import io
+import os
+import struct
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+
+from trace_decode import Decoder  # noqa: E402
+
+# Decoder prints "%10u cyc  text" without --hz
+STAMP = 16
+
+
+def main():
+    prefix = sys.argv[1] if len(sys.argv) > 1 else "trace_test"
+    failures = 0
+
+    with open(prefix + ".fmt", "rb") as fmt:
+        blob = fmt.read()
+    with open(prefix + ".bin", "rb") as capture:
+        stream = capture.read()
+    with open(prefix + ".txt", "r") as text:
+        expected = text.read().splitlines()
+
+    base, = struct.unpack_from("<I", blob)
+    decoder = Decoder(base, blob[4:], 0)
+
+    out = io.StringIO()
+    err = io.StringIO()
+    frames = [frame for frame in stream.split(b"\0") if frame]
+    with contextlib.redirect_stdout(out), contextlib.redirect_stderr(err):
+        for frame in frames:
+            decoder.frame(frame)
+
+    if err.getvalue():
+        failures += 1
+        print("FAIL decoder: %s" % err.getvalue().strip())
+
+    lines = out.getvalue().splitlines()
+    decoded = []
+    last = 0
+    for line in lines:
+        if line.startswith("--"):
+            decoded.append(line)
+            continue
+        stamp = int(line[:10])
+        if stamp < last:
+            failures += 1
+            print("FAIL Timestamp %u after %u" % (stamp, last))
+        last = stamp
+        decoded.append(line[STAMP:])
+
+    if decoded != expected:
+        failures += 1
+        for index, (got, want) in enumerate(zip(decoded, expected)):
+            if got != want:
+                print("FAIL line %d: '%s', expected '%s'" % (index + 1, got, want))
+                break
+        else:
+            print("FAIL %d lines decoded, %d expected" % (len(decoded), len(expected)))
+
+    print("%d Frames, %d lines decoded" % (len(frames), len(decoded)))
+    print("%s (%d failures)" % ("PASS" if failures == 0 else "FAIL", failures))
+    return 0 if failures == 0 else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,576 @@
+/*
+ * ts_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ *
+ *  Host test & benchmark of the touch pipeline (stm32f429i_discovery_ts.c)
+ *  over the I2C queue model of i2cm_sim.h & an STMPE811 model
+ *  - The STMPE811 takes a sample every SIM_TS_SAMPLE_US while touched into its
+ *    128 sample FIFO, raises INT_STA FTH (level reaching FIFO_TH), TOUCH & FOV and
+ *    drives its interrupt line low while an enabled bit is set; the falling edge
+ *    calls the EXTI handler
+ *  - Tap: DOWN at the touched position, UP at the release, every sample read
+ *  - Noise & single sample spikes on a still finger: the filtered position stays
+ *    within 3 px, far fewer MOVE events than the raw samples would make
+ *  - Swipe: MOVE events in order, following the finger within a few pixels
+ *  - Failed transactions: counted, the chain restarts while the line is low
+ *  - Figures: position error & MOVE events filtered vs raw samples, swipe lag,
+ *    I2C transactions & bus time per sample, bursts vs polling IOE_TP_GetState
+ *
+ *  Build & run from tools/host:
+ *  gcc -O2 -Wall -DSTM32F42_43xxx -DUSE_STDPERIPH_DRIVER -I../../Utilities/STM32F429I-Discovery \
+ *      -I../../Libraries/CMSIS/Include -I../../Libraries/Device/ST/STM32F4xx/Include \
+ *      -I../../Libraries/STM32F4xx_StdPeriph_Driver/inc -I../../src ts_test.c \
+ *      -o ts_test && ./ts_test
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stm32f429i_discovery_ts.h"
+#include "i2cm_sim.h"
+
+/* STMPE811 model */
+#define SIM_TS_SAMPLE_US		(1000U)
+#define SIM_TS_FIFO				(128U)
+#define SIM_TS_SPIKE			(800)
+#define SIM_TS_ID				(0x0811U)
+
+#define TEST_TAP_MS				(50U)
+#define TEST_NOISE_MS			(400U)
+#define TEST_SWIPE_MS			(370U)
+#define TEST_POLL_SAMPLES		(200U)
+#define TEST_EVENTS				(512U)
+
+typedef struct
+{
+  int32_t X;
+  int32_t Y;
+  int32_t Z;
+} Sim_Sample;
+
+static uint8_t Sim_Reg[256];
+static Sim_Sample Sim_Fifo[SIM_TS_FIFO];
+static uint32_t Sim_FifoIn;
+static uint32_t Sim_FifoOut;
+static uint8_t Sim_IntSta;
+static uint8_t Sim_Line;
+static volatile uint8_t Sim_Exti;
+static uint32_t Sim_NextSample;
+static volatile uint32_t Sim_Produced;
+static volatile uint32_t Sim_Underruns;
+/* Set: the next transactions are not acknowledged */
+static volatile uint32_t Sim_NackNext;
+/* Bus time of the transactions, idle time not counted */
+static volatile uint32_t Sim_BusUs;
+
+/* Finger: raw position (X0, Y0) at T0 moving (VX, VY) raw units per ms, noise of +/-Noise,
+   every SpikeEvery th sample SIM_TS_SPIKE off on X */
+static volatile uint8_t Sim_Touching;
+static int32_t Sim_X0, Sim_Y0, Sim_VX, Sim_VY;
+static uint32_t Sim_T0;
+static int32_t Sim_Noise;
+static uint32_t Sim_SpikeEvery;
+static uint32_t Sim_Seed = 1;
+
+/* Bursts seen by the hook, with the screen error of the filter & of the last raw sample */
+static uint32_t Sim_Bursts;
+static Sim_Sample Sim_LastRaw;
+static uint32_t Sim_ErrFiltered, Sim_ErrRaw, Sim_MaxFiltered, Sim_MaxRaw;
+static uint32_t Sim_RawMoves;
+static uint16_t Sim_RawX, Sim_RawY;
+
+static int32_t Sim_Random(void)
+{
+  Sim_Seed = (Sim_Seed * 1103515245U) + 12345U;
+  return (int32_t)((Sim_Seed >> 16) & 0x7FFF);
+}
+
+static int32_t Sim_FingerX(uint32_t Now)
+{
+  return Sim_X0 + ((Sim_VX * (int32_t)(Now - Sim_T0)) / 1000);
+}
+
+static int32_t Sim_FingerY(uint32_t Now)
+{
+  return Sim_Y0 + ((Sim_VY * (int32_t)(Now - Sim_T0)) / 1000);
+}
+
+/* Interrupt line, low while an enabled status bit is set */
+static uint8_t Sim_LineNow(void)
+{
+  return (uint8_t)(((Sim_Reg[IOE_REG_INT_CTRL] & IOE_GIT_EN) != 0) && ((Sim_IntSta & Sim_Reg[IOE_REG_INT_EN]) != 0));
+}
+
+static void Sim_Push(void)
+{
+  Sim_Sample *sample = &Sim_Fifo[Sim_FifoIn % SIM_TS_FIFO];
+
+  Sim_Produced++;
+
+  if((Sim_FifoIn - Sim_FifoOut) >= SIM_TS_FIFO)
+  {
+    Sim_IntSta |= IOE_GIT_FOV;
+    return;
+  }
+
+  sample->X = Sim_FingerX(Sim_NextSample) + ((Sim_Noise != 0) ? ((Sim_Random() % ((2 * Sim_Noise) + 1)) - Sim_Noise) : 0);
+  sample->Y = Sim_FingerY(Sim_NextSample) + ((Sim_Noise != 0) ? ((Sim_Random() % ((2 * Sim_Noise) + 1)) - Sim_Noise) : 0);
+  sample->Z = 0x40;
+
+  if((Sim_SpikeEvery != 0) && ((Sim_Produced % Sim_SpikeEvery) == 0))
+  {
+    sample->X += SIM_TS_SPIKE;
+  }
+
+  sample->X = (sample->X < 0) ? 0 : ((sample->X > 0xFFF) ? 0xFFF : sample->X);
+  sample->Y = (sample->Y < 0) ? 0 : ((sample->Y > 0xFFF) ? 0xFFF : sample->Y);
+
+  Sim_FifoIn++;
+
+  /* Set when the level reaches the threshold, not again until it drops below */
+  if((Sim_FifoIn - Sim_FifoOut) == Sim_Reg[IOE_REG_FIFO_TH])
+  {
+    Sim_IntSta |= IOE_GIT_FTH;
+  }
+}
+
+static Sim_Sample Sim_Pop(void)
+{
+  Sim_Sample sample = Sim_LastRaw;
+
+  if(Sim_FifoIn == Sim_FifoOut)
+  {
+    Sim_Underruns++;
+    return sample;
+  }
+
+  sample = Sim_Fifo[Sim_FifoOut % SIM_TS_FIFO];
+  Sim_FifoOut++;
+  Sim_LastRaw = sample;
+
+  return sample;
+}
+
+static uint8_t Sim_ReadRegister(uint8_t Register)
+{
+  switch(Register)
+  {
+    case IOE_REG_INT_STA:   return Sim_IntSta;
+    case IOE_REG_FIFO_SIZE: return (uint8_t)(Sim_FifoIn - Sim_FifoOut);
+    case IOE_REG_TP_CTRL:   return (uint8_t)((Sim_Reg[IOE_REG_TP_CTRL] & 0x7F) | ((Sim_Touching != 0) ? 0x80 : 0x00));
+    default:                return Sim_Reg[Register];
+  }
+}
+
+static void Sim_WriteRegister(uint8_t Register, uint8_t Value)
+{
+  switch(Register)
+  {
+    case IOE_REG_INT_STA:
+      /* Write 1 to clear */
+      Sim_IntSta &= (uint8_t)~Value;
+      break;
+    case IOE_REG_FIFO_STA:
+      if((Value & 0x01) != 0)
+      {
+        Sim_FifoOut = Sim_FifoIn;
+      }
+      break;
+    default:
+      Sim_Reg[Register] = Value;
+      break;
+  }
+}
+
+/* The STMPE811 side of one transaction, returns its status */
+static uint8_t Sim_I2cSlave(const I2CM_Transfer *Xfer)
+{
+  Sim_Sample sample;
+  uint16_t n = 0;
+  uint32_t bytes = 1U + Xfer->RegSize + Xfer->Length + ((Xfer->Direction == I2CM_DIR_READ) ? 1U : 0U);
+  uint8_t reg = (uint8_t)Xfer->Register;
+
+  if((Xfer->Address != IOE_ADDR) || (Sim_NackNext != 0))
+  {
+    Sim_NackNext -= (Sim_NackNext != 0) ? 1U : 0U;
+    Sim_Now += SIM_BYTE_US;
+    Sim_BusUs += SIM_BYTE_US;
+    return I2CM_NACK;
+  }
+
+  Sim_Now += SIM_BYTE_US * bytes;
+  Sim_BusUs += SIM_BYTE_US * bytes;
+
+  if(Xfer->Direction == I2CM_DIR_WRITE)
+  {
+    for(n = 0; n < Xfer->Length; n++)
+    {
+      Sim_WriteRegister((uint8_t)(reg + n), Xfer->Buffer[n]);
+    }
+  }
+  else if(reg == IOE_REG_TP_DATA_NI)
+  {
+    /* Data port: X[11:0] Y[11:0] Z[7:0] per sample, address not incremented */
+    for(n = 0; (n + 3U) < Xfer->Length; n += 4U)
+    {
+      sample = Sim_Pop();
+      Xfer->Buffer[n] = (uint8_t)(sample.X >> 4);
+      Xfer->Buffer[n + 1U] = (uint8_t)(((sample.X & 0x0F) << 4) | (sample.Y >> 8));
+      Xfer->Buffer[n + 2U] = (uint8_t)sample.Y;
+      Xfer->Buffer[n + 3U] = (uint8_t)sample.Z;
+    }
+  }
+  else if((reg == IOE_REG_TP_DATA_X) || (reg == IOE_REG_TP_DATA_Y) || (reg == IOE_REG_TP_DATA_Z))
+  {
+    /* Polled position: the newest sample, MSB first */
+    sample = (Sim_FifoIn != Sim_FifoOut) ? Sim_Fifo[(Sim_FifoIn - 1U) % SIM_TS_FIFO] : Sim_LastRaw;
+    n = (uint16_t)((reg == IOE_REG_TP_DATA_X) ? sample.X : ((reg == IOE_REG_TP_DATA_Y) ? sample.Y : sample.Z));
+    Xfer->Buffer[0] = (uint8_t)(n >> 8);
+    Xfer->Buffer[1] = (uint8_t)n;
+  }
+  else
+  {
+    for(n = 0; n < Xfer->Length; n++)
+    {
+      Xfer->Buffer[n] = Sim_ReadRegister((uint8_t)(reg + n));
+    }
+  }
+
+  return I2CM_OK;
+}
+
+/* Peripheral Library calls of TS_Init & the EXTI handler */
+void RCC_AHB1PeriphClockCmd(uint32_t RCC_AHB1Periph, FunctionalState NewState) { (void)RCC_AHB1Periph; (void)NewState; }
+void RCC_APB2PeriphClockCmd(uint32_t RCC_APB2Periph, FunctionalState NewState) { (void)RCC_APB2Periph; (void)NewState; }
+void GPIO_Init(GPIO_TypeDef* GPIOx, GPIO_InitTypeDef* GPIO_InitStruct) { (void)GPIOx; (void)GPIO_InitStruct; }
+void SYSCFG_EXTILineConfig(uint8_t EXTI_PortSourceGPIOx, uint8_t EXTI_PinSourcex) { (void)EXTI_PortSourceGPIOx; (void)EXTI_PinSourcex; }
+void EXTI_Init(EXTI_InitTypeDef* EXTI_InitStruct) { (void)EXTI_InitStruct; }
+void NVIC_Init(NVIC_InitTypeDef* NVIC_InitStruct) { (void)NVIC_InitStruct; }
+
+uint8_t GPIO_ReadInputDataBit(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin)
+{
+  (void)GPIOx;
+  (void)GPIO_Pin;
+  return (Sim_LineNow() != 0) ? (uint8_t)Bit_RESET : (uint8_t)Bit_SET;
+}
+
+ITStatus EXTI_GetITStatus(uint32_t EXTI_Line)
+{
+  (void)EXTI_Line;
+  return (Sim_Exti != 0) ? SET : RESET;
+}
+
+void EXTI_ClearITPendingBit(uint32_t EXTI_Line)
+{
+  (void)EXTI_Line;
+  Sim_Exti = 0;
+}
+
+#include "../../Utilities/STM32F429I-Discovery/stm32f429i_discovery_ioe.c"
+#include "../../Utilities/STM32F429I-Discovery/stm32f429i_discovery_ts.c"
+
+static uint16_t u16Distance(uint16_t AX, uint16_t AY, uint16_t BX, uint16_t BY)
+{
+  return (uint16_t)(((AX > BX) ? (AX - BX) : (BX - AX)) + ((AY > BY) ? (AY - BY) : (BY - AY)));
+}
+
+/* After a burst: screen error of the filter & of the newest raw sample against the finger,
+   and the MOVE events the raw samples would have made */
+static void Sim_Measure(void)
+{
+  uint16_t tx = IOE_TP_ScaleX((uint16_t)Sim_FingerX(Sim_Now)), ty = IOE_TP_ScaleY((uint16_t)Sim_FingerY(Sim_Now));
+  uint16_t fx = IOE_TP_ScaleX((uint16_t)(TS_FilterX.Acc >> 4)), fy = IOE_TP_ScaleY((uint16_t)(TS_FilterY.Acc >> 4));
+  uint16_t rx = IOE_TP_ScaleX((uint16_t)Sim_LastRaw.X), ry = IOE_TP_ScaleY((uint16_t)Sim_LastRaw.Y);
+  uint16_t error = 0;
+
+  error = u16Distance(fx, fy, tx, ty);
+  Sim_ErrFiltered += error;
+  Sim_MaxFiltered = (error > Sim_MaxFiltered) ? error : Sim_MaxFiltered;
+
+  error = u16Distance(rx, ry, tx, ty);
+  Sim_ErrRaw += error;
+  Sim_MaxRaw = (error > Sim_MaxRaw) ? error : Sim_MaxRaw;
+
+  if((Sim_Bursts > 1U) && (u16Distance(rx, ry, Sim_RawX, Sim_RawY) >= TS_MOVE_THRESHOLD))
+  {
+    Sim_RawMoves++;
+  }
+  if((Sim_Bursts == 1U) || (u16Distance(rx, ry, Sim_RawX, Sim_RawY) >= TS_MOVE_THRESHOLD))
+  {
+    Sim_RawX = rx;
+    Sim_RawY = ry;
+  }
+}
+
+/* Other interrupts: STMPE811 sampling & its EXTI line */
+static void Sim_TickHook(void)
+{
+  uint8_t line = 0;
+
+  if((Sim_Touching == 0) || ((Sim_Reg[IOE_REG_TP_CTRL] & 0x01) == 0))
+  {
+    Sim_NextSample = Sim_Now + SIM_TS_SAMPLE_US;
+  }
+
+  while((int32_t)(Sim_Now - Sim_NextSample) >= 0)
+  {
+    Sim_Push();
+    Sim_NextSample += SIM_TS_SAMPLE_US;
+  }
+
+  if(TS_Stats.Bursts != Sim_Bursts)
+  {
+    Sim_Bursts = TS_Stats.Bursts;
+    Sim_Measure();
+  }
+
+  /* EXTI on the falling edge */
+  line = Sim_LineNow();
+  if((line != 0) && (Sim_Line == 0))
+  {
+    Sim_Exti = 1;
+  }
+  Sim_Line = line;
+
+  if(Sim_Exti != 0)
+  {
+    TS_IRQHandler();
+  }
+}
+
+static uint32_t u32Failures;
+
+#define CHECK(cond, ...)	do{ if(!(cond)){ u32Failures++; printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } }while(0)
+
+static TS_EventTypeDef Events[TEST_EVENTS];
+static uint32_t EventTimes[TEST_EVENTS];
+static uint32_t u32Events;
+
+/* Application loop: busy for a millisecond, then takes the events */
+static void vidRun(uint32_t Ms)
+{
+  TS_EventTypeDef event;
+
+  while(Ms-- != 0)
+  {
+    Sim_Elapse(1000);
+
+    while(TS_GetEvent(&event) != 0)
+    {
+      if(u32Events < TEST_EVENTS)
+      {
+        EventTimes[u32Events] = Sim_Now;
+        Events[u32Events++] = event;
+      }
+    }
+  }
+}
+
+/* Finger down at raw (X, Y) moving (VX, VY) per ms, events & figures from now on */
+static void vidTouch(int32_t X, int32_t Y, int32_t VX, int32_t VY, int32_t Noise, uint32_t SpikeEvery)
+{
+  Sim_SetPrimask(1);
+  Sim_X0 = X;
+  Sim_Y0 = Y;
+  Sim_VX = VX;
+  Sim_VY = VY;
+  Sim_T0 = Sim_Now;
+  Sim_Noise = Noise;
+  Sim_SpikeEvery = SpikeEvery;
+  Sim_ErrFiltered = Sim_ErrRaw = Sim_MaxFiltered = Sim_MaxRaw = Sim_RawMoves = 0;
+  Sim_Bursts = TS_Stats.Bursts = 0;
+  TS_Stats.Samples = 0;
+  Sim_Produced = 0;
+  u32Events = 0;
+  Sim_Touching = 1;
+  Sim_IntSta |= IOE_GIT_TOUCH;
+  Sim_SetPrimask(0);
+}
+
+/* Finger up, then time for the pipeline to read the rest */
+static void vidRelease(void)
+{
+  Sim_SetPrimask(1);
+  Sim_Touching = 0;
+  Sim_IntSta |= IOE_GIT_TOUCH;
+  Sim_SetPrimask(0);
+
+  vidRun(20);
+}
+
+static uint32_t u32Count(uint8_t Type)
+{
+  uint32_t i = 0, count = 0;
+
+  for(i = 0; i < u32Events; i++)
+  {
+    count += (Events[i].Type == Type) ? 1U : 0U;
+  }
+
+  return count;
+}
+
+static void vidCheckIdle(void)
+{
+  CHECK(0 == TS_Busy, "read chain still running");
+  CHECK(0 == Sim_LineNow(), "interrupt line left low (INT_STA 0x%02X)", Sim_IntSta);
+  CHECK(Sim_FifoIn == Sim_FifoOut, "%lu samples left in the FIFO", (unsigned long)(Sim_FifoIn - Sim_FifoOut));
+  CHECK(TS_Stats.Samples == Sim_Produced, "%lu samples read of %lu", (unsigned long)TS_Stats.Samples, (unsigned long)Sim_Produced);
+}
+
+static void vidTestTap(void)
+{
+  uint16_t x = IOE_TP_ScaleX(2000), y = IOE_TP_ScaleY(2000);
+
+  vidTouch(2000, 2000, 0, 0, 0, 0);
+  vidRun(TEST_TAP_MS);
+  vidRelease();
+
+  CHECK((u32Events >= 2U) && (TS_EVENT_DOWN == Events[0].Type), "no DOWN event first");
+  CHECK((u32Events >= 2U) && (TS_EVENT_UP == Events[u32Events - 1U].Type), "no UP event last");
+  CHECK(0 == u32Count(TS_EVENT_MOVE), "%lu MOVE events on a still finger", (unsigned long)u32Count(TS_EVENT_MOVE));
+  CHECK((Events[0].X == x) && (Events[0].Y == y), "DOWN at %u,%u, touched at %u,%u", Events[0].X, Events[0].Y, x, y);
+  CHECK(TS_Stats.Bursts >= (TEST_TAP_MS / TS_FIFO_THRESHOLD), "%lu bursts", (unsigned long)TS_Stats.Bursts);
+  vidCheckIdle();
+}
+
+static void vidTestNoise(void)
+{
+  uint32_t moves = 0;
+
+  /* About +/-2 px of noise & a 53 px spike every 10 samples */
+  vidTouch(2000, 2000, 0, 0, 30, 10);
+  vidRun(TEST_NOISE_MS);
+
+  moves = u32Count(TS_EVENT_MOVE);
+  CHECK(Sim_MaxFiltered <= 3U, "filtered position %lu px off", (unsigned long)Sim_MaxFiltered);
+  CHECK((2U * moves) <= Sim_RawMoves, "%lu MOVE events on a still finger, %lu from raw samples", (unsigned long)moves, (unsigned long)Sim_RawMoves);
+
+  printf("still finger, +/-30 raw noise & a spike every 10 samples over %u ms: filtered %.2f px mean / %lu px max error & %lu MOVE events, "
+         "raw samples %.2f px mean / %lu px max & %lu MOVE events\n", TEST_NOISE_MS,
+         (double)Sim_ErrFiltered / Sim_Bursts, (unsigned long)Sim_MaxFiltered, (unsigned long)moves,
+         (double)Sim_ErrRaw / Sim_Bursts, (unsigned long)Sim_MaxRaw, (unsigned long)Sim_RawMoves);
+
+  vidRelease();
+  vidCheckIdle();
+}
+
+static void vidTestSwipe(void)
+{
+  uint32_t i = 0, backwards = 0, lag = 0, maxLag = 0, moves = 0;
+  uint16_t truth = 0, last = 0;
+
+  /* Top to bottom in TEST_SWIPE_MS, 9 raw units per ms, about 0.8 px per ms */
+  vidTouch(2000, 400, 0, 9, 10, 0);
+  vidRun(TEST_SWIPE_MS);
+
+  for(i = 0; i < u32Events; i++)
+  {
+    if(Events[i].Type != TS_EVENT_MOVE)
+    {
+      continue;
+    }
+
+    moves++;
+    backwards += (Events[i].Y < last) ? 1U : 0U;
+    last = Events[i].Y;
+
+    truth = IOE_TP_ScaleY((uint16_t)Sim_FingerY(EventTimes[i]));
+    lag += (truth > Events[i].Y) ? (uint32_t)(truth - Events[i].Y) : 0U;
+    maxLag = ((truth > Events[i].Y) && ((uint32_t)(truth - Events[i].Y) > maxLag)) ? (uint32_t)(truth - Events[i].Y) : maxLag;
+  }
+
+  CHECK(moves >= (TEST_SWIPE_MS / (2U * TS_FIFO_THRESHOLD)), "%lu MOVE events on a swipe", (unsigned long)moves);
+  CHECK(0 == backwards, "%lu MOVE events going backwards", (unsigned long)backwards);
+  CHECK(maxLag <= 16U, "MOVE events up to %lu px behind the finger", (unsigned long)maxLag);
+  CHECK(0 == TS_Stats.Dropped, "%lu events dropped", (unsigned long)TS_Stats.Dropped);
+
+  printf("swipe at 0.8 px/ms: %lu MOVE events, %.1f px mean / %lu px max behind the finger when taken by the application\n",
+         (unsigned long)moves, (moves != 0) ? ((double)lag / moves) : 0.0, (unsigned long)maxLag);
+
+  vidRelease();
+  CHECK(TS_EVENT_UP == Events[u32Events - 1U].Type, "no UP event after the swipe");
+  vidCheckIdle();
+}
+
+static void vidTestNack(void)
+{
+  uint32_t errors = TS_Stats.Errors;
+
+  vidTouch(1500, 1500, 0, 0, 0, 0);
+  vidRun(10);
+
+  /* The next FTH chain fails twice */
+  Sim_NackNext = 2;
+  vidRun(30);
+  vidRelease();
+
+  CHECK(2U == (TS_Stats.Errors - errors), "%lu errors counted", (unsigned long)(TS_Stats.Errors - errors));
+  CHECK((u32Events >= 2U) && (TS_EVENT_UP == Events[u32Events - 1U].Type), "no UP event after the errors");
+  vidCheckIdle();
+}
+
+/* Bus cost per sample: FIFO bursts on a swipe, then IOE_TP_GetState once per sample (pipeline stopped) */
+static void vidBenchmark(void)
+{
+  uint32_t transactions[2] = {0, 0}, bus[2] = {0, 0}, samples = 0, bursts = 0, i = 0;
+
+  vidTouch(2000, 400, 0, 9, 10, 0);
+  transactions[0] = Sim_Transactions;
+  bus[0] = Sim_BusUs;
+  vidRun(TEST_SWIPE_MS);
+  vidRelease();
+  transactions[0] = Sim_Transactions - transactions[0];
+  bus[0] = Sim_BusUs - bus[0];
+  samples = TS_Stats.Samples;
+  bursts = TS_Stats.Bursts;
+
+  TS_DeInit();
+
+  vidTouch(2000, 2000, 0, 0, 0, 0);
+  transactions[1] = Sim_Transactions;
+  bus[1] = Sim_BusUs;
+  for(i = 0; i < TEST_POLL_SAMPLES; i++)
+  {
+    Sim_Elapse(SIM_TS_SAMPLE_US);
+    IOE_TP_GetState();
+  }
+  transactions[1] = Sim_Transactions - transactions[1];
+  bus[1] = Sim_BusUs - bus[1];
+  vidRelease();
+
+  printf("I2C cost per sample at 1 kHz: FIFO bursts %.2f transactions & %.0f us bus time (%lu samples in %lu bursts), "
+         "IOE_TP_GetState %.2f transactions & %.0f us\n",
+         (double)transactions[0] / samples, (double)bus[0] / samples, (unsigned long)samples, (unsigned long)bursts,
+         (double)transactions[1] / TEST_POLL_SAMPLES, (double)bus[1] / TEST_POLL_SAMPLES);
+}
+
+int main(void)
+{
+  Sim_Reg[IOE_REG_CHP_ID] = (uint8_t)(SIM_TS_ID >> 8);
+  Sim_Reg[IOE_REG_CHP_ID + 1] = (uint8_t)SIM_TS_ID;
+
+  Sim_Start();
+
+  CHECK(IOE_OK == TS_Init(), "TS_Init");
+  CHECK(TS_FIFO_THRESHOLD == Sim_Reg[IOE_REG_FIFO_TH], "FIFO threshold %u", Sim_Reg[IOE_REG_FIFO_TH]);
+
+  vidTestTap();
+  vidTestNoise();
+  vidTestSwipe();
+  vidTestNack();
+  vidBenchmark();
+
+  Sim_Stop();
+
+  CHECK(0 == Sim_Underruns, "%lu samples read from an empty FIFO", (unsigned long)Sim_Underruns);
+  CHECK(0 == TS_Stats.Overruns, "%lu FIFO overruns", (unsigned long)TS_Stats.Overruns);
+  CHECK(0 == Sim_Resets, "%lu bus resets", (unsigned long)Sim_Resets);
+
+  printf("%s (%lu failures)\n", (0 == u32Failures) ? "PASS" : "FAIL", (unsigned long)u32Failures);
+
+  return (0 == u32Failures) ? 0 : 1;
+}
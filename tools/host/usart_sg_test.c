@@ -0,0 +1,503 @@
+/*
+ * usart_sg_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Islam Ehab
+ *
+ *  Host test & benchmark of the USART Scatter-Gather Transmission
+ *  (xUSART_SendSegments_DMA, Drivers/USART/USART_Prog.c) over a register model of
+ *  USART1 & DMA2 Stream7 (cpu_sim.h), 115200 bits/s from PCLK2 = HCLK / 2
+ *  - USART: DR & shift register, TXE, TC set when the shift register empties with DR
+ *    empty, cleared only by writing 0 or by reading SR then writing DR
+ *  - DMA2 Stream7: a byte to DR every time TXE is set, TCIF & interrupt at NDTR 0
+ *  - Segments (empty & NULL ones skipped) land on the wire in order, the callback
+ *    runs once the last stop bit is sent, never before
+ *  - A Stream7 TC interrupt served late (a higher priority handler runs 1 to 4 byte times):
+ *    TC set in the gap between 2 segments must not end the chain early
+ *  - Busy transmission refuses a second one
+ *  - Benchmark per frame (8 bytes header, payload, 2 bytes CRC): CPU bytes copied &
+ *    CPU cycles, one segment after copying the frame vs 3 segments in place
+ *  - Interrupt entry to exit cycles of the Tx handlers (RAM_FUNC), run from SRAM vs
+ *    from Flash through the ART cache, warm & evicted by thread code
+ *
+ *  Build & run from tools/host:
+ *  gcc -O2 -fno-tree-vectorize -fno-tree-loop-distribute-patterns -no-pie -Wall -Wno-pointer-to-int-cast -DRAM_FUNC= -DCCM_DATA= -DCCM_BSS= \
+ *      -I../../Drivers/STD_and_MATH -I../../Drivers/USART -I../../Drivers/DMA -I../../Drivers/RCC \
+ *      usart_sg_test.c -o usart_sg_test && ./usart_sg_test
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "std_types_sim.h"
+#include "cpu_sim.h"
+#include "USART_Reg.h"
+#include "DMA_Init.h"
+#include "USART_Init.h"
+#include "RCC_Init.h"
+
+#define SIM_HCLK				(180000000UL)
+#define SIM_PCLK2				(90000000UL)
+
+#define SIM_SR					((uint32_t)(uintptr_t)&USART1->SR)
+#define SIM_DR					((uint32_t)(uintptr_t)&USART1->DR)
+#define SIM_BRR					((uint32_t)(uintptr_t)&USART1->BRR)
+#define SIM_CR1					((uint32_t)(uintptr_t)&USART1->CR1)
+#define SIM_CR3					((uint32_t)(uintptr_t)&USART1->CR3)
+#define SIM_HISR				((uint32_t)(uintptr_t)&DMA2->HISR)
+#define SIM_HIFCR				((uint32_t)(uintptr_t)&DMA2->HIFCR)
+#define SIM_S7CR				((uint32_t)(uintptr_t)&DMA2_STREAM7->CR)
+#define SIM_S7NDTR				((uint32_t)(uintptr_t)&DMA2_STREAM7->NDTR)
+#define SIM_S7M0AR				((uint32_t)(uintptr_t)&DMA2_STREAM7->M0AR)
+#define SIM_ISER				((uint32_t)(uintptr_t)&USART_NVIC_ISER[0])
+
+#define SIM_USART1_IRQ			(37U)
+#define SIM_DMA2_STREAM7_IRQ	(70U)
+#define SIM_HOG_IRQ				(0U)
+
+#define SIM_SR_RC_W0			(0x60U)			//TC & RXNE
+#define SIM_WIRE_SIZE			(4096U)
+
+#define TEST_HEADER				(8U)
+#define TEST_CRC				(2U)
+#define TEST_MAX_PAYLOAD		(1024U)
+
+Return_status xRCC_subscribe(RCC_clockChangeCallback callback)
+{
+  (void)callback;
+  return OK;
+}
+
+u32 u32RCC_getPCLK1(void)
+{
+  return SIM_PCLK2 / 2U;
+}
+
+u32 u32RCC_getPCLK2(void)
+{
+  return SIM_PCLK2;
+}
+
+/* Legacy single block DMA API, not used here */
+void vidDMA_Transfer(DMA_Stream* DMA_SNUM, u32 u32Source, u32 u32Destination, u32 u32Count)
+{
+  (void)DMA_SNUM;
+  (void)u32Source;
+  (void)u32Destination;
+  (void)u32Count;
+}
+
+#include "../../Drivers/USART/USART_Prog.c"
+
+/* USART transmitter */
+static uint32_t Sim_DrFull;
+static uint8_t Sim_DrByte;
+static uint32_t Sim_ShiftBusy;
+static uint8_t Sim_ShiftByte;
+static uint64_t Sim_ShiftEnd;
+static uint32_t Sim_SrRead;
+static uint8_t Sim_Wire[SIM_WIRE_SIZE];
+static uint32_t Sim_WireCount;
+
+/* DMA2 Stream7 */
+static uint32_t Sim_DmaIndex;
+
+/* A higher priority handler busy for Sim_HogCycles, pended by the next Stream7 TC */
+static uint32_t Sim_HogArmed;
+static uint64_t Sim_HogCycles;
+
+static void Sim_Hog(void)
+{
+  Sim_Cycles += Sim_HogCycles;
+  Sim_IrqCycles += Sim_HogCycles;
+}
+
+static void Sim_RegRead(uint32_t Address)
+{
+  Sim_SrRead = (Address == SIM_SR) ? 1U : 0U;
+}
+
+/* 10 bits at the BRR Bit Rate, in HCLK cycles */
+static uint64_t Sim_ByteCycles(void)
+{
+  uint64_t brr = Sim_Reg(SIM_BRR);
+
+  if((Sim_Reg(SIM_CR1) & OVER8) != 0)
+  {
+    brr = ((brr & ~0xFULL) >> 1) | (brr & 0x7U);
+  }
+
+  return 10U * brr * (SIM_HCLK / SIM_PCLK2);
+}
+
+/* Move the transmitter & the stream up to Sim_Cycles, in time order */
+static void Sim_Service(void)
+{
+  uint64_t now = Sim_Cycles, t = now;
+  uint32_t sr = 0, cr = 0, n = 0;
+  int moved = 1;
+
+  while(moved != 0)
+  {
+    moved = 0;
+    cr = Sim_Reg(SIM_S7CR);
+
+    if((Sim_ShiftBusy != 0) && (Sim_ShiftEnd <= now))
+    {
+      t = Sim_ShiftEnd;
+      Sim_ShiftBusy = 0;
+      if(Sim_WireCount < SIM_WIRE_SIZE)
+      {
+        Sim_Wire[Sim_WireCount] = Sim_ShiftByte;
+      }
+      Sim_WireCount++;
+      if(Sim_DrFull == 0)
+      {
+        Sim_SetReg(SIM_SR, Sim_Reg(SIM_SR) | TC);
+      }
+      moved = 1;
+    }
+
+    if((Sim_DrFull == 0) && ((cr & EN) != 0) && ((Sim_Reg(SIM_CR3) & DMAT) != 0))
+    {
+      n = Sim_Reg(SIM_S7NDTR);
+      Sim_DrByte = *(const uint8_t *)(uintptr_t)(Sim_Reg(SIM_S7M0AR) + Sim_DmaIndex);
+      Sim_DrFull = 1;
+      Sim_DmaIndex++;
+      Sim_SetReg(SIM_S7NDTR, --n);
+      if(n == 0)
+      {
+        Sim_SetReg(SIM_S7CR, cr & ~(uint32_t)EN);
+        Sim_SetReg(SIM_HISR, Sim_Reg(SIM_HISR) | (TCIF << STREAM7));
+        if((cr & TCIE) != 0)
+        {
+          Sim_IrqSet(SIM_DMA2_STREAM7_IRQ);
+        }
+        if(Sim_HogArmed != 0)
+        {
+          Sim_HogArmed = 0;
+          Sim_IrqSet(SIM_HOG_IRQ);
+        }
+      }
+      moved = 1;
+    }
+
+    if((Sim_DrFull != 0) && (Sim_ShiftBusy == 0) && ((Sim_Reg(SIM_CR1) & (UE | TE)) == (UE | TE)))
+    {
+      Sim_ShiftByte = Sim_DrByte;
+      Sim_DrFull = 0;
+      Sim_ShiftBusy = 1;
+      Sim_ShiftEnd = t + Sim_ByteCycles();
+      moved = 1;
+    }
+  }
+
+  sr = Sim_Reg(SIM_SR) & ~(uint32_t)TXE;
+  sr |= (Sim_DrFull == 0) ? TXE : 0U;
+  Sim_SetReg(SIM_SR, sr);
+
+  Sim_NextEvent = (Sim_ShiftBusy != 0) ? Sim_ShiftEnd : SIM_NEVER;
+
+  cr = Sim_Reg(SIM_CR1);
+  if((((sr & TC) != 0) && ((cr & UART_CR1_TCIE) != 0)) || (((sr & TXE) != 0) && ((cr & UART_CR1_TXEIE) != 0)))
+  {
+    Sim_IrqSet(SIM_USART1_IRQ);
+  }
+}
+
+static void Sim_RegWrite(uint32_t Address, uint32_t Old)
+{
+  uint32_t value = Sim_Reg(Address), bit = 0, sr_read = Sim_SrRead;
+
+  Sim_SrRead = 0;
+
+  if(Address == SIM_SR)
+  {
+    Sim_SetReg(SIM_SR, Old & ~(SIM_SR_RC_W0 & ~value));
+  }
+  else if(Address == SIM_DR)
+  {
+    Sim_DrByte = (uint8_t)value;
+    Sim_DrFull = 1;
+    if(sr_read != 0)
+    {
+      Sim_SetReg(SIM_SR, Sim_Reg(SIM_SR) & ~(uint32_t)TC);
+    }
+  }
+  else if(Address == SIM_HIFCR)
+  {
+    Sim_SetReg(SIM_HISR, Sim_Reg(SIM_HISR) & ~value);
+    Sim_SetReg(SIM_HIFCR, 0);
+  }
+  else if(Address == SIM_S7CR)
+  {
+    if(((Old & EN) == 0) && ((value & EN) != 0))
+    {
+      Sim_DmaIndex = 0;
+    }
+  }
+  else if((Address >= SIM_ISER) && (Address < (SIM_ISER + 12U)))
+  {
+    for(bit = 0; bit < 32U; bit++)
+    {
+      if((value & (1UL << bit)) != 0)
+      {
+        Sim_IrqEnabled[((Address - SIM_ISER) * 8U) + bit] = 1;
+      }
+    }
+    Sim_SetReg(Address, value | Old);
+  }
+
+  Sim_Service();
+}
+
+static void Sim_Tick(void)
+{
+  Sim_Service();
+}
+
+#define CHECK(cond, ...)	do{ if(!(cond)){ u32Failures++; printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } }while(0)
+
+static uint32_t u32Failures;
+
+static uint8_t Test_Header[TEST_HEADER];
+static uint8_t Test_Payload[TEST_MAX_PAYLOAD];
+static uint8_t Test_Crc[TEST_CRC];
+static uint8_t Test_Frame[TEST_HEADER + TEST_MAX_PAYLOAD + TEST_CRC];
+static uint8_t Test_Expected[SIM_WIRE_SIZE];
+
+static volatile uint32_t Test_Callbacks;
+static volatile uint32_t Test_WireAtCallback;
+static volatile uint32_t Test_ShiftAtCallback;
+
+static void Test_Done(USART_REG* USARTx)
+{
+  (void)USARTx;
+  Test_Callbacks++;
+  Test_WireAtCallback = Sim_WireCount;
+  Test_ShiftAtCallback = Sim_ShiftBusy | Sim_DrFull;
+}
+
+/* Word copy as the M4 memcpy does for aligned buffers */
+static void Test_Copy(uint8_t *Dest, const uint8_t *Src, uint32_t Size)
+{
+  while(Size >= 4U)
+  {
+    *(uint32_t *)(void *)Dest = *(const uint32_t *)(const void *)Src;
+    Dest += 4;
+    Src += 4;
+    Size -= 4U;
+  }
+  while(Size > 0U)
+  {
+    *Dest++ = *Src++;
+    Size--;
+  }
+}
+
+static void Test_Wait(void)
+{
+  while(u8USART_TxBusy(USART1) != 0)
+  {
+    Sim_Wfi();
+  }
+}
+
+/* Send, wait the end & check the wire; cycles the CPU spent (call & interrupts) */
+static uint64_t Test_Send(const USART_TxSegment *Segments, uint8_t Count)
+{
+  uint32_t i = 0, total = 0, callbacks = Test_Callbacks;
+  uint64_t start = 0, idle = 0;
+
+  for(i = 0; i < Count; i++)
+  {
+    if(Segments[i].pData != 0)
+    {
+      memcpy(Test_Expected + total, Segments[i].pData, Segments[i].Size);
+      total += Segments[i].Size;
+    }
+  }
+
+  Sim_WireCount = 0;
+  Sim_StepOn();
+  start = Sim_Cycles;
+  idle = Sim_IdleCycles;
+  CHECK(OK == xUSART_SendSegments_DMA(USART1, Segments, Count, Test_Done), "send %u segments", Count);
+  Test_Wait();
+  Sim_StepOff();
+
+  CHECK(callbacks + 1U == Test_Callbacks, "%lu callbacks", (unsigned long)(Test_Callbacks - callbacks));
+  CHECK((Test_WireAtCallback == total) && (Test_ShiftAtCallback == 0),
+        "callback with %lu of %lu bytes sent%s", (unsigned long)Test_WireAtCallback, (unsigned long)total,
+        (Test_ShiftAtCallback != 0) ? ", transmitter busy" : "");
+  CHECK((Sim_WireCount == total) && (0 == memcmp(Sim_Wire, Test_Expected, total)), "wire: %lu bytes, %lu expected",
+        (unsigned long)Sim_WireCount, (unsigned long)total);
+
+  return (Sim_Cycles - start) - (Sim_IdleCycles - idle);
+}
+
+static void Test_Segments(void)
+{
+  USART_TxSegment segments[5];
+  uint32_t size = 0;
+
+  for(size = 0; size < sizeof(Test_Payload); size++)
+  {
+    Test_Payload[size] = (uint8_t)((size * 7U) + 3U);
+  }
+  memset(Test_Header, 0xA5, sizeof(Test_Header));
+  memset(Test_Crc, 0x3C, sizeof(Test_Crc));
+
+  for(size = 1; size <= 40U; size += 13U)
+  {
+    segments[0].pData = Test_Header;  segments[0].Size = TEST_HEADER;
+    segments[1].pData = Test_Payload; segments[1].Size = 0;
+    segments[2].pData = Test_Payload; segments[2].Size = (u16)size;
+    segments[3].pData = 0;            segments[3].Size = 5;
+    segments[4].pData = Test_Crc;     segments[4].Size = TEST_CRC;
+    (void)Test_Send(segments, 5);
+  }
+
+  /* One byte segments: every DMA TC interrupt lands while the previous byte shifts */
+  segments[0].pData = Test_Header;  segments[0].Size = 1;
+  segments[1].pData = Test_Payload; segments[1].Size = 1;
+  segments[2].pData = Test_Crc;     segments[2].Size = 1;
+  (void)Test_Send(segments, 3);
+
+  /* Nothing to send: callback before return */
+  segments[0].Size = 0;
+  segments[1].pData = 0;
+  CHECK(OK == xUSART_SendSegments_DMA(USART1, segments, 2, Test_Done), "empty send");
+  CHECK(u8USART_TxBusy(USART1) == 0, "busy after an empty send");
+}
+
+static void Test_LateInterrupt(void)
+{
+  USART_TxSegment segments[2];
+  uint32_t pause = 0;
+
+  /* The first TC interrupt runs after TC is set (the line went idle), 1 byte left */
+  for(pause = 1; pause <= 4U; pause++)
+  {
+    segments[0].pData = Test_Header; segments[0].Size = TEST_HEADER;
+    segments[1].pData = Test_Crc;    segments[1].Size = 1;
+    Sim_HogArmed = 1;
+    Sim_HogCycles = pause * Sim_ByteCycles();
+    (void)Test_Send(segments, 2);
+    CHECK(Sim_HogArmed == 0, "the late interrupt never happened");
+  }
+}
+
+static void Test_Busy(void)
+{
+  USART_TxSegment segment = { Test_Payload, 16 };
+
+  CHECK(OK == xUSART_SendSegments_DMA(USART1, &segment, 1, Test_Done), "send");
+  CHECK(NOK == xUSART_SendSegments_DMA(USART1, &segment, 1, Test_Done), "second send accepted while busy");
+  Sim_StepOn();
+  Test_Wait();
+  Sim_StepOff();
+}
+
+static void Test_Bench(void)
+{
+  static const uint32_t sizes[] = { 16, 64, 256, 1024 };
+  USART_TxSegment segments[3];
+  uint64_t copy = 0, sg = 0, start = 0;
+  uint32_t i = 0, frame = 0;
+
+  printf("\nCPU cycles per frame (8 bytes header, payload, 2 bytes CRC) at 115200 bits/s\n");
+  printf("%8s %14s %14s %14s %10s\n", "payload", "copied bytes", "copy + 1 seg", "3 segments", "saved");
+  for(i = 0; i < (sizeof(sizes) / sizeof(sizes[0])); i++)
+  {
+    frame = TEST_HEADER + sizes[i] + TEST_CRC;
+
+    /* Build the frame in one buffer, then one DMA block */
+    Sim_StepOn();
+    start = Sim_Cycles;
+    Test_Copy(Test_Frame, Test_Header, TEST_HEADER);
+    Test_Copy(Test_Frame + TEST_HEADER, Test_Payload, sizes[i]);
+    Test_Copy(Test_Frame + TEST_HEADER + sizes[i], Test_Crc, TEST_CRC);
+    Sim_StepOff();
+    copy = Sim_Cycles - start;
+    segments[0].pData = Test_Frame; segments[0].Size = (u16)frame;
+    copy += Test_Send(segments, 1);
+
+    segments[0].pData = Test_Header;  segments[0].Size = TEST_HEADER;
+    segments[1].pData = Test_Payload; segments[1].Size = (u16)sizes[i];
+    segments[2].pData = Test_Crc;     segments[2].Size = TEST_CRC;
+    sg = Test_Send(segments, 3);
+
+    printf("%8lu %14lu %14lu %14lu %10ld\n", (unsigned long)sizes[i], (unsigned long)frame, (unsigned long)copy,
+           (unsigned long)sg, (long)copy - (long)sg);
+  }
+  printf("wire time of one byte: %lu cycles\n", (unsigned long)Sim_ByteCycles());
+}
+
+/* Same frame with the handlers fetched from SRAM, Flash (ART warm), Flash (ART cold) */
+static void Test_IsrFetch(void)
+{
+  static const char *const modes[] = { "SRAM (.ramfunc)", "Flash, ART warm", "Flash, ART cold" };
+  USART_TxSegment segments[3];
+  uint64_t cycles[3] = { 0 };
+  uint32_t mode = 0, irqs = 0;
+
+  segments[0].pData = Test_Header;  segments[0].Size = TEST_HEADER;
+  segments[1].pData = Test_Payload; segments[1].Size = 64;
+  segments[2].pData = Test_Crc;     segments[2].Size = TEST_CRC;
+
+  printf("\nTx interrupt entry to exit, 3 segments frame (%u wait states Flash)\n", SIM_FLASH_WS);
+  for(mode = SIM_FETCH_RAM; mode <= SIM_FETCH_FLASH_COLD; mode++)
+  {
+    Sim_FetchMode = mode;
+    Sim_ArtFlush();
+    (void)Test_Send(segments, 3);
+
+    cycles[mode] = Sim_IrqCycles;
+    irqs = Sim_IrqTaken[SIM_USART1_IRQ] + Sim_IrqTaken[SIM_DMA2_STREAM7_IRQ];
+    (void)Test_Send(segments, 3);
+    cycles[mode] = (Sim_IrqCycles - cycles[mode]) / ((Sim_IrqTaken[SIM_USART1_IRQ] + Sim_IrqTaken[SIM_DMA2_STREAM7_IRQ]) - irqs);
+
+    printf("%18s %6lu cycles per interrupt\n", modes[mode], (unsigned long)cycles[mode]);
+  }
+  Sim_FetchMode = SIM_FETCH_RAM;
+
+  CHECK(cycles[SIM_FETCH_RAM] < cycles[SIM_FETCH_FLASH_COLD], "SRAM handler %lu cycles, Flash %lu",
+        (unsigned long)cycles[SIM_FETCH_RAM], (unsigned long)cycles[SIM_FETCH_FLASH_COLD]);
+}
+
+int main(void)
+{
+  USART_Config config = { 0 };
+
+  if((Sim_MapBlock((uint32_t)(uintptr_t)USART1, sizeof(USART_REG)) != 0)
+     || (Sim_MapBlock((uint32_t)(uintptr_t)DMA2, sizeof(DMA_Main)) != 0)
+     || (Sim_MapBlock((uint32_t)(uintptr_t)USART_NVIC_ISER, 12U) != 0))
+  {
+    printf("USART1 / DMA2 / NVIC addresses not free, build with -no-pie\n");
+    return 1;
+  }
+  Sim_CpuStart();
+  Sim_SetReg(SIM_SR, TXE | TC);
+  Sim_IrqConnect(SIM_USART1_IRQ, USART1_IRQHandler, 1);
+  Sim_IrqConnect(SIM_DMA2_STREAM7_IRQ, DMA2_Stream7_IRQHandler, 1);
+  Sim_IrqConnect(SIM_HOG_IRQ, Sim_Hog, 0);
+  Sim_IrqEnabled[SIM_HOG_IRQ] = 1;
+
+  config.BaudRate = BR115200;
+  config.WordLength = Data_Bits_8;
+  config.StopBit = One_Bit;
+  config.Mode = (Mode_enum)(Receiver | Transmitter);
+  CHECK(OK == xUSART_Init(USART1, &config), "USART1 init");
+
+  Test_Segments();
+  Test_LateInterrupt();
+  Test_Busy();
+  Test_Bench();
+  Test_IsrFetch();
+
+  printf("%s (%lu failures)\n", (u32Failures == 0) ? "PASS" : "FAIL", (unsigned long)u32Failures);
+  return (u32Failures == 0) ? 0 : 1;
+}
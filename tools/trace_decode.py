@@ -0,0 +1,172 @@
+#!/usr/bin/env python3
+"""
+trace_decode.py
+
+  Created on: Oct 19, 2026
+      Author: Islam Ehab
+
+Host decoder for Drivers/TRACE binary logs.
+
+Reads the format strings from the .trace_fmt section of the firmware ELF,
+then decodes the FRAME stream captured from the trace USART:
+
+    Frame   = COBS( Payload | CRC16 CCITT-FALSE (MSB first) ) | 0x00
+    Payload = Dropped | Record...            (little endian 32 bit words)
+    Record  = Header | Timestamp | Args      Header = (Format ID << 2) | Args
+
+Usage:
+    trace_decode.py firmware.elf capture.bin [--hz 180000000]
+    stty -F /dev/ttyUSB0 115200 raw; trace_decode.py firmware.elf /dev/ttyUSB0
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+SECTION = ".trace_fmt"
+CONVERSION = re.compile(r"%([%cdiuxX])")
+
+
+def read_format_section(path):
+    """Return (address, bytes) of the format string section of an ELF32 file"""
+    with open(path, "rb") as elf:
+        data = elf.read()
+
+    if data[:4] != b"\x7fELF" or data[4] != 1:
+        raise ValueError("%s is not an ELF32 file" % path)
+
+    endian = "<" if data[5] == 1 else ">"
+    shoff, = struct.unpack_from(endian + "I", data, 0x20)
+    shentsize, shnum, shstrndx = struct.unpack_from(endian + "HHH", data, 0x2E)
+
+    def section(index):
+        return struct.unpack_from(endian + "IIIIIIIIII", data, shoff + index * shentsize)
+
+    names = section(shstrndx)
+    for index in range(shnum):
+        header = section(index)
+        start = names[4] + header[0]
+        name = data[start:data.index(b"\0", start)].decode()
+        if name == SECTION:
+            return header[3], data[header[4]:header[4] + header[5]]
+
+    raise ValueError("%s has no %s section (TRACE_ENABLE off?)" % (path, SECTION))
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if (crc & 0x8000) else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(frame):
+    out = bytearray()
+    index = 0
+    while index < len(frame):
+        code = frame[index]
+        if code == 0 or index + code > len(frame) + 1:
+            return None
+        out += frame[index + 1:index + code]
+        index += code
+        if code < 0xFF and index < len(frame):
+            out.append(0)
+    return bytes(out)
+
+
+def format_record(fmt, args):
+    values = iter(args)
+
+    def convert(match):
+        kind = match.group(1)
+        if kind == "%":
+            return "%"
+        value = next(values, 0)
+        if kind in "di":
+            return str(value - (1 << 32) if value & 0x80000000 else value)
+        if kind == "u":
+            return str(value)
+        if kind == "c":
+            return chr(value & 0xFF)
+        return ("%X" if kind == "X" else "%x") % value
+
+    return CONVERSION.sub(convert, fmt)
+
+
+class Decoder:
+    def __init__(self, base, strings, hz):
+        self.base = base
+        self.strings = strings
+        self.hz = hz
+        self.dropped = 0
+
+    def lookup(self, fmt_id):
+        offset = fmt_id - self.base
+        if offset < 0 or offset >= len(self.strings):
+            return "<unknown format 0x%X>" % fmt_id
+        end = self.strings.find(b"\0", offset)
+        return self.strings[offset:end].decode(errors="replace")
+
+    def payload(self, data):
+        words = struct.unpack("<%dI" % (len(data) // 4), data[:len(data) & ~3])
+        if not words:
+            return
+
+        if words[0] != self.dropped:
+            print("-- %u records dropped --" % (words[0] - self.dropped))
+            self.dropped = words[0]
+
+        index = 1
+        while index + 2 <= len(words):
+            header, stamp = words[index], words[index + 1]
+            count = header & 0x3
+            args = words[index + 2:index + 2 + count]
+            index += 2 + count
+
+            if self.hz:
+                stamp = "%12.3f us" % (stamp * 1e6 / self.hz)
+            else:
+                stamp = "%10u cyc" % stamp
+            print("%s  %s" % (stamp, format_record(self.lookup(header >> 2), args)))
+
+    def frame(self, frame):
+        data = cobs_decode(frame)
+        if data is None or len(data) < 2:
+            print("-- malformed frame --", file=sys.stderr)
+            return
+        if crc16(data[:-2]) != struct.unpack(">H", data[-2:])[0]:
+            print("-- CRC error --", file=sys.stderr)
+            return
+        self.payload(data[:-2])
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode Drivers/TRACE binary logs")
+    parser.add_argument("elf", help="firmware ELF with the .trace_fmt section")
+    parser.add_argument("capture", help="raw bytes from the trace USART (file or tty)")
+    parser.add_argument("--hz", type=int, default=0, help="CPU clock to print timestamps in us")
+    options = parser.parse_args()
+
+    base, strings = read_format_section(options.elf)
+    decoder = Decoder(base, strings, options.hz)
+
+    pending = bytearray()
+    with open(options.capture, "rb", buffering=0) as stream:
+        while True:
+            chunk = stream.read(256)
+            if not chunk:
+                break
+            pending += chunk
+            while 0 in pending:
+                end = pending.index(0)
+                if end:
+                    decoder.frame(bytes(pending[:end]))
+                del pending[:end + 1]
+
+
+if __name__ == "__main__":
+    main()